@@ -66,6 +66,20 @@ typedef struct {
 /** @brief Forward declaration for executor integration */
 typedef struct executor executor_t;
 
+/**
+ * @brief Candidate sources held in the suggestion index
+ *
+ * A name can come from several sources at once; suggestions are labelled
+ * with the first enabled source in this order.
+ */
+typedef enum {
+    AUTOCORRECT_SOURCE_BUILTIN = 1 << 0,  /**< Shell builtin */
+    AUTOCORRECT_SOURCE_FUNCTION = 1 << 1, /**< Shell function */
+    AUTOCORRECT_SOURCE_ALIAS = 1 << 2,    /**< Alias */
+    AUTOCORRECT_SOURCE_PATH = 1 << 3,     /**< Executable in a PATH directory */
+    AUTOCORRECT_SOURCE_HISTORY = 1 << 4   /**< Learned from accepted commands */
+} autocorrect_source_t;
+
 /**
  * @brief Initialize auto-correction system
  *
@@ -244,6 +258,37 @@ int autocorrect_suggest_from_history(const char *command,
                                      correction_t *suggestions,
                                      int max_suggestions, bool case_sensitive);
 
+/**
+ * @brief Add a name to the suggestion index
+ *
+ * Called when functions and aliases are defined. Names that are later
+ * removed are dropped lazily: every suggestion is checked against the
+ * live function and alias tables before it is offered.
+ *
+ * @param name Command name
+ * @param source Source the name comes from
+ */
+void autocorrect_index_add(const char *name, autocorrect_source_t source);
+
+/**
+ * @brief Forget the indexed PATH contents
+ *
+ * PATH directories are normally rescanned only when PATH or a directory's
+ * modification time changes. This forces a full rescan on the next lookup
+ * (used by hash -r).
+ */
+void autocorrect_index_invalidate(void);
+
+/**
+ * @brief Get suggestion index statistics
+ *
+ * @param names Output: names currently indexed (may be NULL)
+ * @param path_dirs Output: PATH directories tracked (may be NULL)
+ * @param dir_scans Output: directory scans performed so far (may be NULL)
+ */
+void autocorrect_index_stats(size_t *names, size_t *path_dirs,
+                             size_t *dir_scans);
+
 /**
  * @brief Get default auto-correction configuration
  *
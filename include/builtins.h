@@ -411,6 +411,54 @@ int bin_popd(int argc, char **argv);
  */
 int bin_dirs(int argc, char **argv);
 
+/**
+ * @brief Jump to a frecently visited directory
+ *
+ * Options:
+ *   z frag...        - Change to the best match for the fragments
+ *   z -l [frag...]   - List matches with their scores
+ *   z -e frag...     - Print the best match
+ *   z -c frag...     - Only match below the current directory
+ *   z -x [dir]       - Remove a directory from the index
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @return 0 on success, 1 if nothing matches, 2 on usage error
+ */
+int bin_z(int argc, char **argv);
+
+/**
+ * @brief Load, enable and disable loadable builtins
+ *
+ * Options:
+ *   enable                  - List loadable builtins
+ *   enable -a               - List all builtins
+ *   enable -m               - List modules that can be loaded
+ *   enable -f module [name...] - Load a module (optionally only some names)
+ *   enable -d module        - Unload a module
+ *   enable [-n] name...     - Enable (or with -n disable) loadable builtins
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @return 0 on success, 1 on error, 2 on usage error
+ */
+int bin_enable(int argc, char **argv);
+
+/**
+ * @brief Cache the output of a slow command
+ *
+ * Options:
+ *   memo [-a] [-t ttl] [-k var]... [-f file]... cmd [args...]
+ *   memo -l            - List cached commands
+ *   memo -s            - Show hit, miss and eviction counters
+ *   memo -c [cmd...]   - Drop all entries, or those for cmd
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @return Exit status of the (cached) command, 2 on usage error
+ */
+int bin_memo(int argc, char **argv);
+
 /* ============================================================================
  * Command Hash Table
  * ============================================================================ */
@@ -424,13 +472,72 @@ void free_command_hash(void);
 /**
  * @brief Check if a command is a builtin
  *
- * Searches the builtins table for a matching command name.
+ * Searches the builtins table and the enabled loadable builtins for a
+ * matching command name.
  *
  * @param name Command name to check
  * @return true if name is a builtin, false otherwise
  */
 bool is_builtin(const char *name);
 
+/* ============================================================================
+ * Loadable Builtins
+ * ============================================================================ */
+
+/**
+ * @brief Find a builtin by name
+ *
+ * Core builtins are searched first, then enabled loadable builtins.
+ *
+ * @param name Command name
+ * @return Builtin entry, or NULL if name is not an enabled builtin
+ */
+const builtin *builtin_lookup(const char *name);
+
+/**
+ * @brief Add a loadable builtin
+ *
+ * Loadable builtins are registered at runtime (by plugins) and shadow
+ * external commands of the same name while enabled. They start enabled.
+ *
+ * @param name Command name (copied)
+ * @param doc Help text (copied)
+ * @param func Handler function
+ * @return 0 on success, -1 if the name is already a builtin or allocation
+ *         failed
+ */
+int builtin_register(const char *name, const char *doc,
+                     int (*func)(int argc, char **argv));
+
+/**
+ * @brief Remove a loadable builtin
+ *
+ * @param name Command name
+ * @return 0 on success, -1 if name is not a loadable builtin
+ */
+int builtin_unregister(const char *name);
+
+/**
+ * @brief Enable or disable a loadable builtin
+ *
+ * A disabled builtin stays registered but is not found by lookups, so
+ * the external command of the same name runs instead.
+ *
+ * @param name Command name
+ * @param enabled New state
+ * @return 0 on success, -1 if name is not a loadable builtin
+ */
+int builtin_set_enabled(const char *name, bool enabled);
+
+/**
+ * @brief Get a loadable builtin by position
+ *
+ * @param index Position, starting at 0
+ * @param enabled Output: whether it is enabled (may be NULL)
+ * @return Builtin entry, or NULL past the end
+ */
+const builtin *builtin_loadable_at(size_t index, bool *enabled);
+
 /**
  * @brief Find a command in PATH
  *
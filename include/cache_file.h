@@ -0,0 +1,65 @@
+/**
+ * @file cache_file.h
+ * @brief Per-user cache directory lookup and atomic cache file writes
+ *
+ * Shared by the caches lush keeps between runs (startup file parse trees,
+ * the compatibility database image, batch analysis results). Cache
+ * directories live under $XDG_CACHE_HOME, or ~/.cache when it is unset,
+ * and are created private to the user (0700). Files are written to a
+ * temporary name in the same directory and renamed into place, so a
+ * concurrent reader sees either the old file or the complete new one.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#ifndef CACHE_FILE_H
+#define CACHE_FILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief One piece of the data written by cache_file_write()
+ */
+typedef struct {
+    const void *data; /**< Bytes to write */
+    size_t len;       /**< Number of bytes */
+} cache_file_part_t;
+
+/**
+ * @brief Resolve a path below the user's cache directory
+ *
+ * @param name Path relative to the cache directory (e.g. "lush/startup")
+ * @param buf Output buffer
+ * @param size Size of @p buf
+ * @return false if neither XDG_CACHE_HOME nor HOME is set, or the path
+ *         does not fit
+ */
+bool cache_file_path(const char *name, char *buf, size_t size);
+
+/**
+ * @brief Create a directory and its missing parents (mkdir -p)
+ *
+ * Directories created here are 0700; existing ones are left as they are.
+ *
+ * @param dir Directory path
+ * @return true if the directory exists afterwards
+ */
+bool cache_file_make_dirs(const char *dir);
+
+/**
+ * @brief Atomically replace a file with the concatenation of @p parts
+ *
+ * Creates the parent directories, writes a 0600 temporary file next to
+ * @p path and renames it over @p path.
+ *
+ * @param path Destination file
+ * @param parts Data to write, in order
+ * @param count Number of parts
+ * @return true if the file was replaced
+ */
+bool cache_file_write(const char *path, const cache_file_part_t *parts,
+                      size_t count);
+
+#endif /* CACHE_FILE_H */
@@ -19,6 +19,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include "shell_mode.h"
 
 /* ============================================================================
@@ -143,7 +144,11 @@ typedef struct {
  * @brief Initialize the compatibility database
  *
  * Loads all compatibility data from TOML files in the data directory.
- * Should be called early in shell initialization.
+ * The parsed data is kept as a read-only binary image with hashed id,
+ * category and feature indexes; the image is cached in
+ * $XDG_CACHE_HOME/lush/compat.cache and mapped directly by later shells
+ * as long as the TOML files are unchanged. Lint patterns are compiled on
+ * first use.
  *
  * @param data_dir Path to data directory (NULL for default)
  * @return 0 on success, -1 on error
@@ -167,6 +172,23 @@ void compat_cleanup(void);
  */
 int compat_reload(void);
 
+/**
+ * @brief Choose where the database image is cached
+ *
+ * Takes effect at the next compat_init().
+ *
+ * @param path Cache file path, NULL for the default location, or "" to
+ *             disable caching
+ */
+void compat_set_cache_path(const char *path);
+
+/**
+ * @brief Check whether the loaded database came from the cached image
+ *
+ * @return true if compat_init() mapped a current cached image
+ */
+bool compat_loaded_from_cache(void);
+
 /* ============================================================================
  * Entry Query Functions
  * ============================================================================ */
@@ -221,6 +243,16 @@ const compat_entry_t *compat_get_first_by_feature(const char *feature);
  */
 size_t compat_get_entry_count(void);
 
+/**
+ * @brief Get a hash of the loaded rule set
+ *
+ * Covers every entry field that influences lint and fix results, so it
+ * changes whenever the compat data files do. Used to key cached results.
+ *
+ * @return Rule set hash, 0 before compat_init()
+ */
+uint64_t compat_ruleset_hash(void);
+
 /**
  * @brief Iterate over all entries
  *
@@ -233,6 +265,27 @@ void compat_foreach_entry(void (*callback)(const compat_entry_t *entry,
                                            void *user_data),
                           void *user_data);
 
+/**
+ * @brief Visit every entry whose lint pattern matches a line
+ *
+ * Uses the rule set compiled by compat_init(): one pass over the line
+ * selects the entries whose required literal occurs, and only those run
+ * their precompiled regex. Entries are visited in database order with the
+ * byte range of the leftmost match. Entry pointers stay valid until
+ * compat_cleanup().
+ *
+ * @param line Line to scan
+ * @param callback Function to call for each matching entry
+ * @param user_data User data passed to callback
+ * @return Number of matching entries
+ */
+size_t compat_foreach_match(const char *line,
+                            void (*callback)(const compat_entry_t *entry,
+                                             size_t match_start,
+                                             size_t match_length,
+                                             void *user_data),
+                            void *user_data);
+
 /* ============================================================================
  * Portability Checking
  * ============================================================================ */
@@ -155,6 +155,7 @@ typedef struct {
     bool lle_preserve_multiline_structure;       /**< Preserve multiline structure */
     bool lle_enable_multiline_editing;           /**< Enable multiline editing */
     bool lle_show_multiline_indicators;          /**< Show multiline indicators */
+    bool lle_auto_indent;                        /**< Indent continuation lines */
     bool lle_enable_interactive_search;          /**< Enable interactive search */
     bool lle_search_fuzzy_matching;              /**< Enable fuzzy search matching */
     bool lle_search_case_sensitive;              /**< Case-sensitive search */
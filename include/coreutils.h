@@ -0,0 +1,35 @@
+/**
+ * @file coreutils.h
+ * @brief In-process implementations of frequently used utilities
+ *
+ * The coreutils module provides builtin versions of small utilities that
+ * scripts run in tight loops: basename, cat, date, dirname, head, mkdir,
+ * rm, seq, sleep, tail, tee and wc. Running them in the shell process
+ * saves a fork and exec per call.
+ *
+ * The module is a static plugin. It is not active by default; scripts
+ * turn it on with `enable -f coreutils` and individual commands off with
+ * `enable -n NAME`. Each command implements the POSIX options and hands
+ * anything else to the real utility in PATH, so behaviour never regresses
+ * for options the builtin does not know.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#ifndef COREUTILS_H
+#define COREUTILS_H
+
+#include "lush_plugin.h"
+
+/** Name the module is loaded under */
+#define COREUTILS_MODULE_NAME "coreutils"
+
+/**
+ * @brief Plugin definition of the coreutils module
+ *
+ * Load it with lush_plugin_manager_load_static().
+ */
+extern const lush_plugin_def_t lush_coreutils_plugin;
+
+#endif /* COREUTILS_H */
@@ -16,6 +16,7 @@
 #include "symtable.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <sys/types.h>
 #include <time.h>
@@ -53,6 +54,7 @@ typedef enum {
 typedef struct breakpoint {
     int id;                  /**< Unique breakpoint ID */
     char *file;              /**< Source file name */
+    int file_id;             /**< Interned source file id */
     int line;                /**< Line number */
     char *condition;         /**< Optional condition expression */
     int hit_count;           /**< Number of times hit */
@@ -60,6 +62,16 @@ typedef struct breakpoint {
     struct breakpoint *next; /**< Next breakpoint in list */
 } breakpoint_t;
 
+/**
+ * @brief Armed-line bitmap for one source file
+ *
+ * Bit N is set when at least one enabled breakpoint exists on line N.
+ */
+typedef struct breakpoint_lines {
+    uint64_t *words; /**< Line bitmap, 64 lines per word */
+    size_t nwords;   /**< Number of words allocated */
+} breakpoint_lines_t;
+
 /**
  * @brief Debug stack frame for tracking execution context
  */
@@ -131,6 +143,9 @@ typedef struct debug_context {
     /* Breakpoints */
     breakpoint_t *breakpoints;  /**< List of breakpoints */
     int next_breakpoint_id;     /**< Next breakpoint ID to assign */
+    breakpoint_lines_t *bp_index; /**< Armed lines indexed by file id */
+    int bp_index_size;            /**< Number of entries in bp_index */
+    int armed_breakpoints;        /**< Number of enabled breakpoints */
 
     /* Profiling */
     profile_data_t *profile_data; /**< Profiling data */
@@ -338,6 +353,33 @@ bool debug_enable_breakpoint(debug_context_t *ctx, int id, bool enable);
  */
 bool debug_check_breakpoint(debug_context_t *ctx, const char *file, int line);
 
+/**
+ * @brief Check for a breakpoint using an interned file id
+ *
+ * Fast path used by the executor: a single bitmap probe decides whether
+ * any enabled breakpoint exists at file_id:line before the breakpoint
+ * list is consulted.
+ *
+ * @param ctx Debug context
+ * @param file_id Interned source file id (see debug_intern_source_file)
+ * @param file Current file (for display)
+ * @param line Current line
+ * @return true if breakpoint hit, false otherwise
+ */
+bool debug_check_breakpoint_at(debug_context_t *ctx, int file_id,
+                               const char *file, int line);
+
+/**
+ * @brief Intern a source file name
+ *
+ * Returns a small, stable integer id for the given path. The same path
+ * always yields the same id for the lifetime of the shell.
+ *
+ * @param file Source file name
+ * @return File id (> 0), or 0 if file is NULL or interning failed
+ */
+int debug_intern_source_file(const char *file);
+
 /**
  * @brief List all breakpoints
  *
@@ -507,6 +549,71 @@ void debug_analyze_script(debug_context_t *ctx, const char *script_path);
 int debug_lint_script(debug_context_t *ctx, const char *script_path,
                       bool fix, bool unsafe_fixes, bool dry_run);
 
+/**
+ * @brief Options for analyzing many scripts in one run
+ */
+typedef struct {
+    analysis_mode_t mode;  /**< Full analysis (analyze) or lint */
+    bool fix;              /**< Apply safe fixes (lint only) */
+    bool unsafe_fixes;     /**< Also apply unsafe fixes */
+    bool dry_run;          /**< Preview fixes without applying */
+    int jobs;              /**< Worker processes, <= 0 for one per CPU */
+    bool use_cache;        /**< Reuse results of unchanged scripts */
+    const char *cache_dir; /**< Cache location, NULL for the XDG default */
+} debug_batch_options_t;
+
+/**
+ * @brief Summary of a multi-script run
+ */
+typedef struct {
+    size_t files;       /**< Scripts checked */
+    size_t cached;      /**< Results taken from the cache */
+    int exit_status;    /**< Worst per-script status (0-3, see lint) */
+} debug_batch_summary_t;
+
+/**
+ * @brief Expand script and directory arguments into a sorted script list
+ *
+ * Directories are searched recursively for shell scripts: files with a
+ * shell extension or a shell shebang. Hidden entries are skipped and
+ * duplicates are dropped. The caller frees the list with
+ * debug_batch_free_paths().
+ *
+ * @param args Files and directories
+ * @param arg_count Number of arguments
+ * @param paths Output array of script paths
+ * @param count Output number of scripts
+ * @return 0 on success, -1 if an argument does not exist or on allocation
+ *         failure
+ */
+int debug_batch_collect(char *const *args, size_t arg_count, char ***paths,
+                        size_t *count);
+
+/**
+ * @brief Free a list returned by debug_batch_collect()
+ *
+ * @param paths Script paths
+ * @param count Number of scripts
+ */
+void debug_batch_free_paths(char **paths, size_t count);
+
+/**
+ * @brief Analyze or lint many scripts on a pool of worker processes
+ *
+ * Scripts whose cached result is still valid are not analyzed again.
+ * Output of every script is replayed in list order, so it does not depend
+ * on scheduling.
+ *
+ * @param paths Script paths
+ * @param count Number of scripts
+ * @param opts Run options
+ * @param summary Output summary (may be NULL)
+ * @return Worst per-script exit status
+ */
+int debug_batch_run(char *const *paths, size_t count,
+                    const debug_batch_options_t *opts,
+                    debug_batch_summary_t *summary);
+
 /**
  * @brief Add an analysis issue
  *
@@ -693,10 +800,12 @@ void debug_set_analysis_output_file(debug_context_t *ctx, const char *filename);
         debug_profile_function_exit(g_debug_context, func);                    \
     }
 
-/** @brief Check breakpoint if debugging enabled */
-#define DEBUG_BREAKPOINT_CHECK(file, line)                                     \
-    if (g_debug_context && g_debug_context->enabled) {                         \
-        debug_check_breakpoint(g_debug_context, file, line);                   \
+/** @brief Check breakpoint if debugging enabled and anything is armed */
+#define DEBUG_BREAKPOINT_CHECK(file_id, file, line)                            \
+    if (g_debug_context && g_debug_context->enabled &&                         \
+        (g_debug_context->armed_breakpoints > 0 ||                             \
+         g_debug_context->step_mode)) {                                        \
+        debug_check_breakpoint_at(g_debug_context, file_id, file, line);       \
     }
 
 /* ============================================================================
@@ -0,0 +1,157 @@
+/**
+ * @file dirindex.h
+ * @brief Frecency-ranked index of visited directories
+ *
+ * Records every directory the shell changes into and ranks them by
+ * frecency (visit count weighted by how recently the directory was last
+ * visited). The z builtin jumps to the best match for a set of fragments,
+ * and LLE uses the ranking to order directory completions.
+ *
+ * The index is kept in memory with a hash for O(1) updates on cd, aged by
+ * scaling every rank once the total passes a limit, and capped in size.
+ * It is loaded lazily from ~/.lush_dirs (or $LUSH_DIRS_FILE) and merged
+ * back into the file at exit, so concurrent shells do not lose each
+ * other's visits.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#ifndef DIRINDEX_H
+#define DIRINDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+/** Default file name under $HOME */
+#define DIRINDEX_FILE_NAME ".lush_dirs"
+
+/** Default maximum number of directories kept */
+#define DIRINDEX_DEFAULT_MAX_ENTRIES 10000
+
+/** Default total rank above which all ranks are scaled down */
+#define DIRINDEX_DEFAULT_MAX_AGE 10000.0
+
+/** Entries whose rank ages below this are forgotten */
+#define DIRINDEX_MIN_RANK 1.0
+
+/**
+ * @brief A directory matching a query
+ */
+typedef struct {
+    const char *path; /**< Directory path (owned by the index) */
+    double score;     /**< Frecency score at query time */
+} dirindex_match_t;
+
+/**
+ * @brief Initialize the directory index
+ *
+ * Does not read the file; that happens on first use.
+ */
+void dirindex_init(void);
+
+/**
+ * @brief Save pending visits and free the index
+ *
+ * Registered with atexit. Only the process that loaded the index saves it,
+ * so subshells exiting do not count the parent's visits twice.
+ */
+void dirindex_cleanup(void);
+
+/**
+ * @brief Record a visit to a directory
+ *
+ * @param path Absolute directory path ($HOME and paths containing newlines
+ *             are ignored)
+ * @return 0 on success, -1 if the path was ignored or allocation failed
+ */
+int dirindex_add(const char *path);
+
+/**
+ * @brief Remove a directory from the index
+ *
+ * The removal is also applied to the file when the index is saved.
+ *
+ * @param path Directory path
+ * @return 0 if removed, -1 if not indexed
+ */
+int dirindex_remove(const char *path);
+
+/**
+ * @brief Frecency score of a directory
+ *
+ * @param path Absolute directory path
+ * @param now Current time
+ * @return Score, or 0 if the directory is not indexed
+ */
+double dirindex_score(const char *path, time_t now);
+
+/**
+ * @brief Find directories matching fragments, best first
+ *
+ * Fragments must appear in the path in order, and the last fragment must
+ * match within the final path component. Matching ignores case unless a
+ * fragment contains an upper-case letter. Directories that no longer
+ * exist are not checked here; see dirindex_best().
+ *
+ * @param fragments Fragments to match (count 0 matches everything)
+ * @param count Number of fragments
+ * @param within Only return subdirectories of this path (may be NULL)
+ * @param exclude Path never returned, usually the current directory
+ *                (may be NULL)
+ * @param matches Output: array of matches (caller frees the array only)
+ * @return Number of matches
+ */
+size_t dirindex_query(const char *const *fragments, size_t count,
+                      const char *within, const char *exclude,
+                      dirindex_match_t **matches);
+
+/**
+ * @brief Best existing directory for fragments
+ *
+ * Directories that no longer exist are dropped from the index as they are
+ * encountered.
+ *
+ * @param fragments Fragments to match
+ * @param count Number of fragments
+ * @param within Only consider subdirectories of this path (may be NULL)
+ * @param exclude Path never returned (may be NULL)
+ * @return Best path (caller must free), or NULL if nothing matches
+ */
+char *dirindex_best(const char *const *fragments, size_t count,
+                    const char *within, const char *exclude);
+
+/**
+ * @brief Set size and aging limits
+ *
+ * @param max_entries Maximum directories kept (0 for the default)
+ * @param max_age Total rank that triggers aging (0 for the default)
+ */
+void dirindex_set_limits(size_t max_entries, double max_age);
+
+/**
+ * @brief Override the file the index is stored in
+ *
+ * Drops the loaded index without saving it; the new file is loaded on
+ * next use.
+ *
+ * @param path File path, or NULL to return to the default
+ */
+void dirindex_set_file(const char *path);
+
+/**
+ * @brief Write pending changes to the file now
+ *
+ * @return 0 on success, -1 on error
+ */
+int dirindex_save(void);
+
+/**
+ * @brief Number of indexed directories
+ *
+ * @return Entry count
+ */
+size_t dirindex_count(void);
+
+#endif /* DIRINDEX_H */
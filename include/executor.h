@@ -17,6 +17,7 @@
 #include "symtable.h"
 
 #include <stdbool.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 
 /** Maximum depth of error context stack */
@@ -47,6 +48,7 @@ typedef struct process {
     pid_t pid;
     char *command;
     int status;
+    struct rusage rusage; // Resource usage collected when reaped
     struct process *next;
 } process_t;
 
@@ -59,6 +61,7 @@ typedef struct job {
     bool no_sighup;       /**< If true, job won't receive SIGHUP on shell exit */
     process_t *processes;
     char *command_line;
+    struct rusage rusage; /**< Resource usage of reaped job processes */
     struct job *next;
 } job_t;
 
@@ -85,8 +88,12 @@ typedef struct executor {
     int loop_depth;               // Current loop nesting depth
 
     // Script execution context for debugging
-    char *current_script_file; // Current script file being executed
+    const char *current_script_file; // Current script file (in script_files)
+    char **script_files;       // Script file names seen; live until destroy
+    size_t script_file_count;  // Number of entries in script_files
+    int current_script_file_id; // Interned id of current_script_file
     int current_script_line;   // Current line number in script
+    int script_line_base;      // First script line of the running construct
     bool in_script_execution;  // True if executing from script file
 
     // Sourced script tracking (Phase 6: return from sourced scripts)
@@ -107,6 +114,12 @@ typedef struct executor {
     pid_t procsub_pids[32];    // Child PIDs from process substitutions
     int procsub_fd_count;      // Number of tracked fds/pids
 
+    // Child resource accounting (collected from wait4)
+    struct rusage rusage_window; // Usage of children reaped in current window
+    int rusage_children;         // Number of children reaped in window
+    struct rusage last_rusage;   // Usage of children of last command line
+    int last_rusage_children;    // Children reaped by last command line
+
 } executor_t;
 
 /** Global executor instance */
@@ -160,6 +173,40 @@ int executor_execute(executor_t *executor, node_t *ast);
  */
 int executor_execute_command_line(executor_t *executor, const char *input);
 
+/**
+ * @brief Parse a command line without executing it
+ *
+ * Applies the same continuation handling as executor_execute_command_line()
+ * but reports nothing; callers that need the diagnostics re-run the text
+ * through executor_execute_command_line().
+ *
+ * @param executor Executor context
+ * @param input Command line to parse
+ * @return AST owned by the caller, or NULL if empty or not parseable
+ */
+node_t *executor_parse_command_line(executor_t *executor, const char *input);
+
+/**
+ * @brief Execute a command line that has already been parsed
+ *
+ * @param executor Executor context
+ * @param ast Parsed command line (not freed)
+ * @return Exit status of executed command
+ */
+int executor_execute_parsed(executor_t *executor, node_t *ast);
+
+/**
+ * @brief Parse and execute a command line, reusing cached parses
+ *
+ * Behaves like executor_execute_command_line() but takes the tree of a
+ * string seen before from the parse cache (see parse_cache.h).
+ *
+ * @param executor Executor context
+ * @param input Command line to parse and execute
+ * @return Exit status of executed command
+ */
+int executor_execute_cached(executor_t *executor, const char *input);
+
 /* ============================================================================
  * Configuration
  * ============================================================================ */
@@ -311,6 +358,33 @@ job_t *executor_add_job(executor_t *executor, pid_t pgid,
  */
 void executor_update_job_status(executor_t *executor);
 
+/**
+ * @brief Reap a child process and record its resource usage
+ *
+ * Drop-in replacement for waitpid() that uses wait4() so the child's
+ * struct rusage is not discarded. Usage of terminated children is added
+ * to the executor's accounting window and to the owning job, if any.
+ *
+ * @param executor Executor context (may be NULL to skip accounting)
+ * @param pid Process (or -pgid) to wait for, as for waitpid()
+ * @param status Where to store the wait status (may be NULL)
+ * @param options waitpid() options
+ * @return Reaped pid, 0 for WNOHANG with nothing to reap, -1 on error
+ */
+pid_t executor_reap_child(executor_t *executor, pid_t pid, int *status,
+                          int options);
+
+/**
+ * @brief Add one rusage record into an accumulator
+ *
+ * Times, faults, I/O blocks and context switches are summed; ru_maxrss
+ * keeps the maximum.
+ *
+ * @param acc Accumulator to update
+ * @param ru Usage to add
+ */
+void executor_rusage_add(struct rusage *acc, const struct rusage *ru);
+
 /**
  * @brief Find a job by ID
  *
@@ -398,6 +472,17 @@ void free_function_params(function_param_t *params);
 void executor_set_script_context(executor_t *executor, const char *script_file,
                                  int line_number);
 
+/**
+ * @brief Record the script line the next construct starts on
+ *
+ * Keeps the script file; trace records add the line to the construct
+ * relative lines of its nodes.
+ *
+ * @param executor Executor context
+ * @param line_number First line of the construct
+ */
+void executor_set_script_line(executor_t *executor, int line_number);
+
 /**
  * @brief Clear script execution context
  *
@@ -0,0 +1,74 @@
+/**
+ * @file extended_test.h
+ * @brief Compiled [[ ]] conditional expressions
+ *
+ * The text of a [[ ]] command is compiled once, when it is parsed, into a
+ * tree of typed tests: operators are resolved to codes, operands that need
+ * no expansion are kept as ready values (with their numeric value for the
+ * arithmetic comparisons), literal == / != patterns without glob
+ * characters become plain string comparisons and literal =~ regexes are
+ * compiled. Evaluating the command then only expands the operands that
+ * contain expansions and walks the tree.
+ *
+ * Operands are expanded individually, so a value containing "&&", "==" or
+ * parentheses is compared as a string rather than re-read as part of the
+ * expression.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#ifndef EXTENDED_TEST_H
+#define EXTENDED_TEST_H
+
+#include <stdbool.h>
+
+/* ============================================================================
+ * Types
+ * ============================================================================ */
+
+/** @brief A compiled [[ ]] expression */
+typedef struct extended_test extended_test_t;
+
+/**
+ * @brief Expand one operand
+ *
+ * @param ctx Context passed to extended_test_evaluate()
+ * @param word Operand text
+ * @return Newly allocated expansion, or NULL on failure
+ */
+typedef char *(*extended_test_expand_fn)(void *ctx, const char *word);
+
+/* ============================================================================
+ * Functions
+ * ============================================================================ */
+
+/**
+ * @brief Compile the text of a [[ ]] command
+ *
+ * @param expr Expression between [[ and ]], as stored by the parser
+ * @return Compiled expression, or NULL on allocation failure
+ */
+extended_test_t *extended_test_compile(const char *expr);
+
+/**
+ * @brief Evaluate a compiled expression
+ *
+ * A successful =~ match stores the match and its groups in BASH_REMATCH.
+ *
+ * @param test Compiled expression
+ * @param expand Operand expansion function
+ * @param ctx Context for @p expand
+ * @return true if the expression is true
+ */
+bool extended_test_evaluate(const extended_test_t *test,
+                            extended_test_expand_fn expand, void *ctx);
+
+/**
+ * @brief Free a compiled expression
+ *
+ * @param test Compiled expression (may be NULL)
+ */
+void extended_test_free(extended_test_t *test);
+
+#endif /* EXTENDED_TEST_H */
@@ -52,6 +52,9 @@ typedef struct {
     char *script_path;      /**< Path to script being fixed */
     char *content;          /**< Original content (owned) */
     size_t content_len;     /**< Content length */
+    char **strings;         /**< Generated fix text (owned) */
+    size_t string_count;    /**< Number of owned strings */
+    size_t string_capacity; /**< Allocated string capacity */
 } fixer_context_t;
 
 /**
@@ -136,6 +139,20 @@ fixer_result_t fixer_load_string(fixer_context_t *ctx, const char *content,
  */
 size_t fixer_collect_fixes(fixer_context_t *ctx, shell_mode_t target);
 
+/**
+ * @brief Collect rewrites of process-spawning idioms
+ *
+ * Parses the loaded script and adds a fix for each idiom found by the
+ * spawn cost analysis (spawn_cost.h) that has an in-shell equivalent,
+ * such as $(cat f) to $(<f) or $(expr $n + 1) to $(($n + 1)). Fixes are
+ * appended to those already collected; call after fixer_collect_fixes().
+ *
+ * @param ctx Fixer context with loaded script
+ * @param target Target shell mode
+ * @return Number of fixes added
+ */
+size_t fixer_collect_spawn_fixes(fixer_context_t *ctx, shell_mode_t target);
+
 /**
  * @brief Add a fix manually
  *
@@ -177,7 +194,9 @@ size_t fixer_count_manual(const fixer_context_t *ctx);
  * @brief Apply collected fixes to the script content
  *
  * Applies fixes in reverse order (end to start) to preserve positions.
- * Returns the fixed content without modifying the original file.
+ * A fix that overlaps one already applied is skipped; running the fixer
+ * again picks it up. Returns the fixed content without modifying the
+ * original file.
  *
  * @param ctx Fixer context
  * @param options Fix options
@@ -57,6 +57,17 @@ char *ln_gets(void);
  */
 char *get_input_complete(FILE *in);
 
+/**
+ * @brief Count the lines a complete input spans
+ *
+ * Lines joined by a backslash continuation are read back as one and
+ * count once.
+ *
+ * @param input Input returned by get_input_complete()
+ * @return Number of lines, at least 1
+ */
+int get_input_line_count(const char *input);
+
 /**
  * @brief Read unified input from file stream
  *
@@ -177,4 +177,83 @@ bool continuation_is_control_keyword(const char *word);
  */
 bool continuation_is_terminator(const char *line);
 
+/**
+ * @brief Resumable analysis point at the start of a line
+ *
+ * Holds the parser state as it was just before the line at @c offset was
+ * scanned, so analysis can restart there without re-reading earlier lines.
+ */
+typedef struct {
+    size_t offset;              /**< Byte offset of the line start */
+    continuation_state_t state; /**< State before the line (owns its strings) */
+    char *pending_word;         /**< Word carried across the line break, or NULL */
+} continuation_checkpoint_t;
+
+/**
+ * @brief Incremental analyzer for a whole editing buffer
+ *
+ * Caches the text of the last analysis and a checkpoint per line. Each
+ * update compares the new text with the cached copy and resumes from the
+ * last checkpoint inside the unchanged prefix, so typing or pasting at the
+ * end of a long buffer only scans the new lines.
+ *
+ * Results are identical to running continuation_analyze_line() over the
+ * whole buffer in one call.
+ */
+typedef struct {
+    char *text;                             /**< Copy of the analyzed text */
+    size_t text_len;                        /**< Length of text */
+    size_t text_capacity;                   /**< Allocated size of text */
+    continuation_checkpoint_t *checkpoints; /**< One per line start */
+    size_t checkpoint_count;                /**< Number of valid checkpoints */
+    size_t checkpoint_capacity;             /**< Allocated checkpoints */
+    continuation_state_t state;             /**< Result for the whole text */
+    size_t lines_scanned;                   /**< Lines scanned by last update */
+} continuation_analyzer_t;
+
+/**
+ * @brief Initialize an incremental analyzer
+ *
+ * @param analyzer Analyzer to initialize
+ */
+void continuation_analyzer_init(continuation_analyzer_t *analyzer);
+
+/**
+ * @brief Free all memory held by an incremental analyzer
+ *
+ * @param analyzer Analyzer to clean up (may be reused after init)
+ */
+void continuation_analyzer_cleanup(continuation_analyzer_t *analyzer);
+
+/**
+ * @brief Analyze a buffer, re-scanning only from the first changed line
+ *
+ * @param analyzer Analyzer holding the previous analysis
+ * @param text Complete buffer text (null-terminated)
+ * @return State for the whole buffer, owned by the analyzer and valid
+ *         until the next update or cleanup
+ */
+const continuation_state_t *
+continuation_analyzer_update(continuation_analyzer_t *analyzer,
+                             const char *text);
+
+/**
+ * @brief Indentation depth for a line break inserted at an offset
+ *
+ * Scans from the checkpoint of the line holding @p offset, so the cost
+ * depends on the edited line rather than on the size of the buffer. The
+ * depth counts the open if/loop/case/function/brace blocks.
+ *
+ * @param analyzer Analyzer updated with the current buffer text
+ * @param offset Byte offset of the line break
+ * @param line_depth Receives the depth of the line holding @p offset (one
+ *                   less when it starts with then, do, else, elif, fi,
+ *                   done, esac or }), or -1 inside quotes or a here
+ *                   document; may be NULL
+ * @return Depth of the new line, or -1 when leading whitespace would become
+ *         part of a quoted string or here document
+ */
+int continuation_analyzer_depth_at(const continuation_analyzer_t *analyzer,
+                                   size_t offset, int *line_depth);
+
 #endif /* INPUT_CONTINUATION_H */
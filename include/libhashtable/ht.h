@@ -15,6 +15,7 @@
 #define __HT_H__
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -136,6 +137,19 @@ uint64_t fnv1a_hash_str(const void *, uint64_t);
  */
 uint64_t fnv1a_hash_str_casecmp(const void *, uint64_t);
 
+/**
+ * @brief Compute FNV-1a hash of a byte range
+ *
+ * Passing a previous result as the seed continues that hash, so several
+ * fields can be mixed into one value.
+ *
+ * @param data Pointer to the bytes to hash
+ * @param len Number of bytes
+ * @param seed Seed value, FNV1A_OFFSET to start a new hash
+ * @return 64-bit hash value
+ */
+uint64_t fnv1a_hash_bytes(const void *, size_t, uint64_t);
+
 /**
  * @brief Compare two strings for equality
  * @param s1 Pointer to first null-terminated string
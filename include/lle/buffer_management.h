@@ -64,6 +64,8 @@
 #define LLE_BUFFER_MAX_UNDO_LEVELS 1000      /* Maximum undo history */
 #define LLE_BUFFER_MAX_REDO_LEVELS 1000      /* Maximum redo history */
 #define LLE_BUFFER_CHANGE_SEQUENCE_LIMIT 100 /* Max operations per sequence */
+#define LLE_BUFFER_UNDO_MEMORY_BUDGET (1024 * 1024) /* Undo history bytes */
+#define LLE_BUFFER_CHANGE_LOG_CHUNK 4096     /* Delta log chunk size */
 
 /* Cache Configuration */
 #define LLE_BUFFER_CACHE_SIZE 256      /* Cache entry count */
@@ -159,6 +161,7 @@ typedef struct lle_cursor_manager_t lle_cursor_manager_t;
 typedef struct lle_change_operation_t lle_change_operation_t;
 typedef struct lle_change_sequence_t lle_change_sequence_t;
 typedef struct lle_change_tracker_t lle_change_tracker_t;
+typedef struct lle_change_log_chunk_t lle_change_log_chunk_t;
 typedef struct lle_buffer_validator_t lle_buffer_validator_t;
 typedef struct lle_buffer_cache_t lle_buffer_cache_t;
 typedef struct lle_selection_range_t lle_selection_range_t;
@@ -414,19 +417,22 @@ struct lle_change_operation_t {
     size_t end_position;    /* End byte offset */
     size_t affected_length; /* Length of affected text */
 
-    /* Operation data for undo/redo */
+    /* Operation data for undo/redo (stored in the tracker's delta log) */
     char *inserted_text;    /* Text that was inserted */
     size_t inserted_length; /* Length of inserted text */
     char *deleted_text;     /* Text that was deleted */
     size_t deleted_length;  /* Length of deleted text */
+    lle_change_log_chunk_t *inserted_chunk; /* Log chunk holding insert */
+    lle_change_log_chunk_t *deleted_chunk;  /* Log chunk holding delete */
 
     /* Cursor state preservation */
     lle_cursor_position_t cursor_before; /* Cursor before operation */
     lle_cursor_position_t cursor_after;  /* Cursor after operation */
 
     /* Operation linking */
-    struct lle_change_operation_t *next; /* Next in sequence */
-    struct lle_change_operation_t *prev; /* Previous in sequence */
+    struct lle_change_sequence_t *sequence; /* Owning sequence */
+    struct lle_change_operation_t *next;    /* Next in sequence */
+    struct lle_change_operation_t *prev;    /* Previous in sequence */
 };
 
 /**
@@ -437,10 +443,11 @@ struct lle_change_operation_t {
  */
 struct lle_change_sequence_t {
     /* Sequence metadata */
-    uint32_t sequence_id; /* Unique sequence ID */
-    char description[64]; /* Human-readable description */
-    uint64_t start_time;  /* Sequence start time */
-    uint64_t end_time;    /* Sequence end time */
+    uint32_t sequence_id;    /* Unique sequence ID */
+    const char *description; /* Description (static string, not copied) */
+    uint64_t start_time;     /* Sequence start time */
+    uint64_t end_time;       /* Start time of the last edit merged in */
+    struct lle_change_tracker_t *tracker; /* Owning tracker */
 
     /* Operation chain */
     lle_change_operation_t *first_op; /* First operation */
@@ -489,6 +496,24 @@ struct lle_change_tracker_t {
     /* Memory management */
     lush_memory_pool_t *memory_pool; /* Memory pool */
     size_t memory_used;                /* Memory used */
+    size_t memory_budget;              /* Byte budget (0 = unlimited) */
+
+    /* Delta log: operation text is appended to chunks instead of being
+     * allocated per operation; a chunk is freed once nothing refers to it */
+    lle_change_log_chunk_t *log_head; /* Newest chunk (appends go here) */
+    lle_change_log_chunk_t *log_tail; /* Oldest chunk */
+
+    /* Recycled structures so steady-state editing does not allocate */
+    lle_change_sequence_t *free_sequences;   /* Spare sequences */
+    lle_change_operation_t *free_operations; /* Spare operations */
+    size_t free_sequence_count;              /* Length of free_sequences */
+    size_t free_operation_count;             /* Length of free_operations */
+
+    /* Coalescing of typing runs, delete runs and cursor moves */
+    bool coalescing_enabled; /* Merge adjacent edits of the same kind */
+    bool coalesce_break;     /* Next sequence must not merge backwards */
+    uint32_t coalesced_count; /* Sequences merged into their predecessor */
+    uint32_t compacted_count; /* Sequences dropped to honour the budget */
 };
 
 /**
@@ -677,7 +702,9 @@ lle_result_t lle_change_tracker_clear(lle_change_tracker_t *tracker);
  * @brief Begin a new change sequence
  *
  * @param tracker Change tracker
- * @param description Human-readable description
+ * @param description Human-readable description; the pointer is kept, so
+ *        it must outlive the sequence (normally a string literal). Equal
+ *        descriptions mark sequences that may be coalesced.
  * @param sequence Pointer to receive new sequence
  * @return LLE_SUCCESS or error code
  */
@@ -689,6 +716,10 @@ lle_change_tracker_begin_sequence(lle_change_tracker_t *tracker,
 /**
  * @brief Complete current change sequence
  *
+ * The sequence may be merged into its predecessor (see
+ * lle_change_tracker_set_coalescing()); callers must not use the sequence
+ * pointer after completing it.
+ *
  * @param tracker Change tracker
  * @return LLE_SUCCESS or error code
  */
@@ -805,6 +836,36 @@ size_t lle_change_tracker_redo_depth(const lle_change_tracker_t *tracker);
  */
 size_t lle_change_tracker_memory_usage(const lle_change_tracker_t *tracker);
 
+/**
+ * @brief Set the undo history memory budget
+ *
+ * When the history (structures plus delta log) grows past the budget the
+ * oldest sequences are dropped until it fits again. The sequence at the
+ * current position is always kept.
+ *
+ * @param tracker Change tracker
+ * @param bytes Budget in bytes (0 = unlimited)
+ * @return LLE_SUCCESS or error code
+ */
+lle_result_t lle_change_tracker_set_memory_budget(lle_change_tracker_t *tracker,
+                                                  size_t bytes);
+
+/**
+ * @brief Enable or disable coalescing of adjacent edits
+ *
+ * With coalescing on (the default), a completed sequence that repeats the
+ * previous sequence's description and continues its edit - typing at the
+ * end of an insert, backspacing or deleting next to a delete, or moving
+ * the cursor again - is merged into that sequence, so one undo reverts
+ * the whole run. Undo and redo always end a run.
+ *
+ * @param tracker Change tracker
+ * @param enabled Whether to coalesce
+ * @return LLE_SUCCESS or error code
+ */
+lle_result_t lle_change_tracker_set_coalescing(lle_change_tracker_t *tracker,
+                                               bool enabled);
+
 /* ============================================================================
  * FUNCTION DECLARATIONS - BUFFER OPERATIONS (ATOMIC)
  * ============================================================================
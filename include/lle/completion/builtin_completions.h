@@ -45,6 +45,7 @@ typedef enum {
     LLE_BUILTIN_ARG_JOB,       /**< Job IDs */
     LLE_BUILTIN_ARG_THEME,     /**< Theme names */
     LLE_BUILTIN_ARG_FEATURE,   /**< Shell features (for setopt/unsetopt) */
+    LLE_BUILTIN_ARG_FRECENT_DIRECTORY, /**< Visited directories, by frecency */
 } lle_builtin_arg_type_t;
 
 // ============================================================================
@@ -65,6 +65,29 @@ bool lle_shell_is_builtin(const char *text);
  */
 bool lle_shell_is_alias(const char *text);
 
+/**
+ * @brief Frecency score of a visited directory
+ *
+ * Provides strong symbol to override weak declaration in completion_types.c.
+ *
+ * @param path Absolute directory path
+ * @return Score (0 if the directory has not been visited)
+ */
+double lle_shell_directory_frecency(const char *path);
+
+/**
+ * @brief Most frecent visited directories matching a fragment
+ *
+ * Provides strong symbol to override weak declaration in completion_types.c.
+ *
+ * @param fragment Fragment to match (empty matches every directory)
+ * @param paths Output array of newly allocated paths (caller frees each)
+ * @param max Capacity of paths
+ * @return Number of paths stored, best first
+ */
+size_t lle_shell_frecent_directories(const char *fragment, char **paths,
+                                     size_t max);
+
 // ============================================================================
 // COMPLETION SOURCE FUNCTIONS
 // ============================================================================
@@ -131,6 +154,22 @@ lle_result_t lle_completion_source_directories(lle_memory_pool_t *memory_pool,
                                                const char *prefix,
                                                lle_completion_result_t *result);
 
+/**
+ * @brief Get frecently visited directory completions
+ *
+ * Offers the best directories from the shell's visit index whose path
+ * matches the prefix anywhere, for jump commands such as z.
+ *
+ * @param memory_pool Memory pool for allocations
+ * @param prefix Fragment to match
+ * @param result Completion result structure to populate
+ * @return LLE_SUCCESS on success, error code on failure
+ */
+lle_result_t
+lle_completion_source_frecent_directories(lle_memory_pool_t *memory_pool,
+                                          const char *prefix,
+                                          lle_completion_result_t *result);
+
 /**
  * @brief Get environment and shell variable completions
  *
@@ -51,6 +51,7 @@ typedef struct lle_history_stats lle_history_stats_t;
 /* Advanced types (Phase 2+) */
 typedef struct lle_history_search_engine lle_history_search_engine_t;
 typedef struct lle_history_dedup_engine lle_history_dedup_engine_t;
+typedef struct lle_history_query_index lle_history_query_index_t;
 /* Note: lle_history_system_t already defined in performance.h - no redefinition
  */
 
@@ -157,6 +158,7 @@ struct lle_history_entry {
     char *original_multiline; /* Original multiline format (Phase 4) */
     bool is_multiline;        /* Multiline flag (Phase 4) */
     uint32_t duration_ms;     /* Execution duration (Phase 4) */
+    bool outcome_known;       /* exit_code/duration_ms recorded after run */
     uint32_t edit_count;      /* Edit count (Phase 4) */
 
     /* Phase 4 Day 11: Forensic metadata */
@@ -250,6 +252,8 @@ struct lle_history_core {
 
     /* Indexing - Phase 2 */
     lle_hashtable_t *entry_lookup; /* ID -> entry hashtable (Phase 2) */
+    lle_history_query_index_t
+        *query_index; /* Directory/exit/duration/session postings */
 
     /* Advanced engines - Phase 4 */
     lle_history_dedup_engine_t
@@ -1047,6 +1051,157 @@ lle_history_search_results_t *
 lle_history_search_fuzzy(lle_history_core_t *history_core, const char *query,
                          size_t max_results);
 
+/**
+ * Search history with a structured query
+ *
+ * The query string uses the syntax of lle_history_query_parse(). Results
+ * are ordered most recent first.
+ *
+ * @param history_core History core engine
+ * @param query_string Query string
+ * @param max_results Maximum results (0 = default 100)
+ * @return Search results or NULL on failure or invalid query
+ */
+lle_history_search_results_t *
+lle_history_search_query(lle_history_core_t *history_core,
+                         const char *query_string, size_t max_results);
+
+/* ============================================================================
+ * STRUCTURED QUERY API
+ * ============================================================================
+ */
+
+/* Maximum length of the free-text part of a query */
+#define LLE_HISTORY_QUERY_TEXT_MAX 256
+
+/**
+ * Exit status filter
+ */
+typedef enum {
+    LLE_HISTORY_QUERY_EXIT_ANY = 0, /* No exit status filter */
+    LLE_HISTORY_QUERY_EXIT_SUCCESS, /* Exit status 0 */
+    LLE_HISTORY_QUERY_EXIT_FAILED,  /* Any non-zero exit status */
+    LLE_HISTORY_QUERY_EXIT_CODE     /* One specific exit status */
+} lle_history_query_exit_t;
+
+/**
+ * Structured history query
+ *
+ * All set filters must match. Entries that were never annotated with a
+ * duration have a duration of 0.
+ */
+typedef struct {
+    char text[LLE_HISTORY_QUERY_TEXT_MAX];      /* Substring, "" = any */
+    char directory[LLE_HISTORY_MAX_PATH_LENGTH]; /* Directory, "" = any */
+    bool subtree;                   /* Also match below directory */
+    lle_history_query_exit_t exit_filter; /* Exit status filter */
+    int exit_code;                  /* Code for LLE_HISTORY_QUERY_EXIT_CODE */
+    uint32_t min_duration_ms;       /* Minimum duration (inclusive) */
+    uint32_t max_duration_ms;       /* Maximum duration (inclusive) */
+    uint64_t since;                 /* Earliest timestamp, 0 = unbounded */
+    uint64_t until;                 /* Latest timestamp, 0 = unbounded */
+    bool session_set;               /* Filter by session */
+    pid_t session_id;               /* Session for session_set */
+} lle_history_query_t;
+
+/**
+ * Initialize a query that matches every entry
+ *
+ * @param query Query to initialize
+ */
+void lle_history_query_init(lle_history_query_t *query);
+
+/**
+ * Parse a query string
+ *
+ * Words are whitespace separated. Recognized filter words:
+ *   dir:PATH      run in PATH ("." = current directory)
+ *   under:PATH    run in PATH or below it
+ *   exit:N        exited with status N
+ *   exit:ok       exited with status 0
+ *   exit:fail     exited with non-zero status (also exit:!0)
+ *   dur:>10s      duration bound (>, >=, <, <=; units ms, s, m, h)
+ *   since:WHEN    at or after WHEN (30m, 2h, 7d, 1w, today, YYYY-MM-DD)
+ *   until:WHEN    at or before WHEN
+ *   session:N     run in session N ("current" = this shell)
+ * All other words form the text, matched as a case-insensitive substring.
+ *
+ * @param input Query string
+ * @param query Output query
+ * @param error Buffer for an error message (may be NULL)
+ * @param error_size Size of error buffer
+ * @return LLE_SUCCESS or LLE_ERROR_INVALID_PARAMETER on a malformed filter
+ */
+lle_result_t lle_history_query_parse(const char *input,
+                                     lle_history_query_t *query, char *error,
+                                     size_t error_size);
+
+/**
+ * Check whether a query has any filter besides text
+ *
+ * @param query Query
+ * @return true if a directory, exit, duration, time or session filter is set
+ */
+bool lle_history_query_has_filters(const lle_history_query_t *query);
+
+/**
+ * Check whether an entry matches a query
+ *
+ * Deleted entries never match.
+ *
+ * @param query Query
+ * @param entry History entry
+ * @return true if the entry matches
+ */
+bool lle_history_query_matches(const lle_history_query_t *query,
+                               const lle_history_entry_t *entry);
+
+/**
+ * Run a query against the history
+ *
+ * Uses the secondary indexes (per-directory, exit status, duration and
+ * session posting lists, and timestamp order) to visit only candidate
+ * entries. The indexes are brought up to date lazily.
+ *
+ * @param core History core
+ * @param query Query
+ * @param max_results Maximum matches to return
+ * @param positions Output array of entry indexes, most recent first
+ *                  (at least max_results long)
+ * @param count Output number of matches
+ * @return LLE_SUCCESS or error code
+ */
+lle_result_t lle_history_query_run(lle_history_core_t *core,
+                                   const lle_history_query_t *query,
+                                   size_t max_results, size_t *positions,
+                                   size_t *count);
+
+/**
+ * Record the outcome of an executed command
+ *
+ * Updates the exit status and duration of the most recent entry for
+ * command and keeps the query indexes in step.
+ *
+ * @param core History core
+ * @param command Command that ran
+ * @param exit_code Exit status
+ * @param duration_ms Wall-clock duration in milliseconds
+ * @return LLE_SUCCESS, or LLE_ERROR_NOT_FOUND if no recent entry matches
+ */
+lle_result_t lle_history_record_result(lle_history_core_t *core,
+                                       const char *command, int exit_code,
+                                       uint32_t duration_ms);
+
+/**
+ * Free the query indexes of a history core
+ *
+ * Called when entries are destroyed; the indexes are rebuilt on the next
+ * query.
+ *
+ * @param core History core
+ */
+void lle_history_query_index_reset(lle_history_core_t *core);
+
 /* ============================================================================
  * INTERACTIVE SEARCH API (Phase 3 Day 9) - Ctrl+R Reverse Incremental Search
  * ============================================================================
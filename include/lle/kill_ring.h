@@ -59,6 +59,14 @@
  */
 #define LLE_KILL_RING_MAX_SIZE 256
 
+/**
+ * @brief Default limit on text storage held by the ring (1 MiB)
+ *
+ * When killed text exceeds this, the oldest entries are dropped. The most
+ * recent entry is always kept, whatever its size.
+ */
+#define LLE_KILL_RING_DEFAULT_BYTE_BUDGET (1024 * 1024)
+
 /* ============================================================================
  * FORWARD DECLARATIONS
  * ============================================================================
@@ -123,6 +131,22 @@ lle_result_t lle_kill_ring_destroy(lle_kill_ring_t *ring);
 lle_result_t lle_kill_ring_add(lle_kill_ring_t *ring, const char *text,
                                bool append);
 
+/**
+ * @brief Add killed text of a given length to the ring
+ * @param ring Kill ring
+ * @param text Text to add (need not be NUL-terminated)
+ * @param length Length of text in bytes (must be non-zero)
+ * @param append If true, append to last entry; if false, create new entry
+ * @return LLE_SUCCESS or error code
+ *
+ * Same as lle_kill_ring_add(), but copies directly from a range of the
+ * edit buffer. Appending copies only the new bytes; entries keep spare
+ * room so a run of successive kills costs time proportional to the text
+ * killed.
+ */
+lle_result_t lle_kill_ring_add_text(lle_kill_ring_t *ring, const char *text,
+                                    size_t length, bool append);
+
 /**
  * @brief Add killed text to front of last entry (prepend mode)
  * @param ring Kill ring
@@ -137,6 +161,19 @@ lle_result_t lle_kill_ring_add(lle_kill_ring_t *ring, const char *text,
  */
 lle_result_t lle_kill_ring_prepend(lle_kill_ring_t *ring, const char *text);
 
+/**
+ * @brief Prepend text of a given length to the last entry
+ * @param ring Kill ring
+ * @param text Text to prepend (need not be NUL-terminated)
+ * @param length Length of text in bytes (must be non-zero)
+ * @return LLE_SUCCESS or error code
+ *
+ * @note If ring is empty, creates new entry
+ * @note Only the new bytes are copied (see lle_kill_ring_add_text())
+ */
+lle_result_t lle_kill_ring_prepend_text(lle_kill_ring_t *ring,
+                                        const char *text, size_t length);
+
 /* ============================================================================
  * YANK OPERATIONS (Retrieving text from ring)
  * ============================================================================
@@ -160,6 +197,20 @@ lle_result_t lle_kill_ring_prepend(lle_kill_ring_t *ring, const char *text);
 lle_result_t lle_kill_ring_get_current(lle_kill_ring_t *ring,
                                        const char **text_out);
 
+/**
+ * @brief Get the current yank text and its length
+ * @param ring Kill ring
+ * @param text_out Output pointer for text (do not free)
+ * @param length_out Output pointer for length in bytes (may be NULL)
+ * @return LLE_SUCCESS, LLE_ERROR_QUEUE_EMPTY, or other error code
+ *
+ * @note The text stays valid until the next kill or clear, so it can be
+ *       inserted into the buffer directly
+ */
+lle_result_t lle_kill_ring_get_current_text(lle_kill_ring_t *ring,
+                                            const char **text_out,
+                                            size_t *length_out);
+
 /**
  * @brief Cycle to previous kill in ring (yank-pop operation)
  * @param ring Kill ring
@@ -179,6 +230,17 @@ lle_result_t lle_kill_ring_get_current(lle_kill_ring_t *ring,
 lle_result_t lle_kill_ring_yank_pop(lle_kill_ring_t *ring,
                                     const char **text_out);
 
+/**
+ * @brief Cycle to previous kill and get its length (yank-pop operation)
+ * @param ring Kill ring
+ * @param text_out Output pointer for text (do not free)
+ * @param length_out Output pointer for length in bytes (may be NULL)
+ * @return LLE_SUCCESS, LLE_ERROR_INVALID_STATE, or other error code
+ */
+lle_result_t lle_kill_ring_yank_pop_text(lle_kill_ring_t *ring,
+                                         const char **text_out,
+                                         size_t *length_out);
+
 /* ============================================================================
  * STATE MANAGEMENT
  * ============================================================================
@@ -269,6 +331,26 @@ lle_result_t lle_kill_ring_was_last_yank(lle_kill_ring_t *ring,
 lle_result_t lle_kill_ring_get_capacity(lle_kill_ring_t *ring,
                                         size_t *capacity_out);
 
+/**
+ * @brief Set the limit on text storage held by the ring
+ * @param ring Kill ring
+ * @param bytes Byte budget (must be non-zero)
+ * @return LLE_SUCCESS or error code
+ *
+ * @note Oldest entries are dropped immediately if over the new budget
+ */
+lle_result_t lle_kill_ring_set_byte_budget(lle_kill_ring_t *ring,
+                                           size_t bytes);
+
+/**
+ * @brief Get the bytes of text storage held by the ring
+ * @param ring Kill ring
+ * @param bytes_out Output pointer for byte count
+ * @return LLE_SUCCESS or error code
+ */
+lle_result_t lle_kill_ring_get_memory_usage(lle_kill_ring_t *ring,
+                                            size_t *bytes_out);
+
 /* ============================================================================
  * DEBUGGING/INTROSPECTION (Development only)
  * ============================================================================
@@ -87,6 +87,18 @@ typedef struct lle_editor {
     lle_buffer_t *buffer;                 /* Text buffer */
     lle_cursor_manager_t *cursor_manager; /* Cursor position management */
     lle_kill_ring_t *kill_ring;           /* Kill/yank ring */
+
+    /* Kill and yank chaining. A kill continues the previous ring entry only
+     * if nothing changed the buffer or moved the cursor since; yank-pop
+     * replaces the span the last yank inserted. modification_count values
+     * are the buffer's count right after the kill or yank. */
+    bool kill_chain_valid;           /* Last kill can be extended */
+    uint32_t kill_modification_count; /* Buffer count after last kill */
+    size_t kill_cursor;              /* Cursor byte offset after last kill */
+    bool yank_valid;                 /* Last yank can be replaced */
+    uint32_t yank_modification_count; /* Buffer count after last yank */
+    size_t yank_start;               /* Byte offset of yanked text */
+    size_t yank_length;              /* Byte length of yanked text */
     lle_keybinding_manager_t *keybinding_manager; /* Key bindings */
     lle_change_tracker_t *change_tracker; /* Undo/redo change tracking */
 
@@ -90,6 +90,9 @@ typedef struct lle_post_command_event {
     const char *command;  /**< Command that was executed */
     int exit_code;        /**< Command exit code (0 = success) */
     uint64_t duration_us; /**< Execution duration in microseconds */
+    uint64_t cpu_user_us; /**< User CPU time of child processes */
+    uint64_t cpu_sys_us;  /**< System CPU time of child processes */
+    long max_rss_kb;      /**< Peak resident set size of children (KB) */
 } lle_post_command_event_t;
 
 /* ============================================================================
@@ -280,6 +283,24 @@ void lle_fire_pre_command(const char *command, bool is_background);
 void lle_fire_post_command(const char *command, int exit_code,
                            uint64_t duration_us);
 
+/**
+ * @brief Fire a post-command event with child resource usage
+ *
+ * Like lle_fire_post_command(), additionally reporting the CPU time and
+ * peak memory of the child processes the command ran, so prompt segments
+ * can show resource use alongside duration.
+ *
+ * @param command     Command that was executed
+ * @param exit_code   Command exit code
+ * @param duration_us Execution duration in microseconds (0 to auto-calculate)
+ * @param cpu_user_us User CPU time of children in microseconds
+ * @param cpu_sys_us  System CPU time of children in microseconds
+ * @param max_rss_kb  Peak resident set size of children in KB
+ */
+void lle_fire_post_command_usage(const char *command, int exit_code,
+                                 uint64_t duration_us, uint64_t cpu_user_us,
+                                 uint64_t cpu_sys_us, long max_rss_kb);
+
 /* ============================================================================
  * UTILITY FUNCTIONS
  * ============================================================================
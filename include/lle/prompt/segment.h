@@ -95,6 +95,8 @@ typedef struct lle_prompt_context {
     /* Shell state */
     int last_exit_code;            /**< Exit code of last command */
     uint64_t last_cmd_duration_ms; /**< Duration of last command */
+    uint64_t last_cmd_cpu_ms;      /**< Child CPU time of last command */
+    long last_cmd_max_rss_kb;      /**< Child peak RSS of last command (KB) */
     int background_job_count;      /**< Number of background jobs */
 
     /* User information */
@@ -339,6 +341,16 @@ lle_result_t lle_prompt_context_init(lle_prompt_context_t *ctx);
 void lle_prompt_context_update(lle_prompt_context_t *ctx, int exit_code,
                                uint64_t duration_ms);
 
+/**
+ * @brief Record child resource usage of the last command in context
+ *
+ * @param ctx         Context to update
+ * @param cpu_ms      User + system CPU time of children in milliseconds
+ * @param max_rss_kb  Peak resident set size of children in KB
+ */
+void lle_prompt_context_update_usage(lle_prompt_context_t *ctx,
+                                     uint64_t cpu_ms, long max_rss_kb);
+
 /**
  * @brief Refresh directory information in context
  *
@@ -137,6 +137,38 @@ typedef struct string_builder {
  */
 int parse_and_execute(const char *command);
 
+/**
+ * @brief Parse and execute a command string, reusing cached parses
+ *
+ * Used by eval, source, traps and prompt hooks, which tend to run the
+ * same strings repeatedly.
+ *
+ * @param command Command string to parse and execute
+ * @return Exit status of the executed command
+ */
+int parse_and_execute_cached(const char *command);
+
+/** @brief Forward declaration for AST nodes */
+struct node;
+
+/**
+ * @brief Execute an already parsed command string
+ *
+ * Runs the tree the way parse_and_execute() runs the tree it parses.
+ *
+ * @param ast Parsed command string (not freed)
+ * @return Exit status of the executed command
+ */
+int execute_parsed(struct node *ast);
+
+/**
+ * @brief Parse a command string without executing it
+ *
+ * @param command Command string to parse
+ * @return AST owned by the caller, or NULL if empty or not parseable
+ */
+struct node *parse_command_silently(const char *command);
+
 /* ============================================================================
  * Executor Access Functions
  * ============================================================================ */
@@ -344,11 +376,11 @@ bool should_auto_export(void);
 bool is_noclobber_enabled(void);
 
 /**
- * @brief Print command trace output
+ * @brief Check if strict POSIX mode is enabled (set -o posix)
  *
- * @param command Command being traced
+ * @return true if POSIX mode enabled
  */
-void print_command_trace(const char *command);
+bool is_posix_mode_enabled(void);
 
 /**
  * @brief Implement the set builtin command
@@ -443,6 +443,17 @@ lush_plugin_manager_create(lush_plugin_manager_t **manager,
  */
 void lush_plugin_manager_destroy(lush_plugin_manager_t *manager);
 
+/**
+ * @brief Get the shell's plugin manager
+ *
+ * Created with the default configuration on first use. Plugins loaded
+ * through it (for example by the enable builtin) stay loaded for the
+ * life of the shell unless unloaded explicitly.
+ *
+ * @return Shell plugin manager, or NULL if it could not be created
+ */
+lush_plugin_manager_t *lush_plugin_shell_manager(void);
+
 /**
  * @brief Set executor reference
  *
@@ -474,6 +485,22 @@ lush_plugin_manager_load(lush_plugin_manager_t *manager,
                            const char *path,
                            lush_plugin_t **plugin);
 
+/**
+ * @brief Load a plugin compiled into the shell
+ *
+ * Static plugins ship with lush, so they are granted the permissions
+ * they require instead of the manager's defaults.
+ *
+ * @param manager Plugin manager
+ * @param def Plugin definition
+ * @param plugin Output pointer for loaded plugin (optional)
+ * @return LUSH_PLUGIN_OK on success
+ */
+lush_plugin_result_t
+lush_plugin_manager_load_static(lush_plugin_manager_t *manager,
+                                  const lush_plugin_def_t *def,
+                                  lush_plugin_t **plugin);
+
 /**
  * @brief Load a plugin by name
  *
@@ -544,10 +571,15 @@ lush_plugin_manager_reload(lush_plugin_manager_t *manager,
 /**
  * @brief Register a builtin command
  *
+ * The builtin is added to the shell and removed again when the plugin is
+ * unloaded. It takes precedence over external commands of the same name
+ * but cannot replace a core builtin.
+ *
  * @param ctx Plugin context
  * @param name Command name
  * @param fn Command function
- * @return LUSH_PLUGIN_OK on success
+ * @return LUSH_PLUGIN_OK on success, LUSH_PLUGIN_ERROR if the name is
+ *         already a builtin
  */
 lush_plugin_result_t
 lush_plugin_register_builtin(lush_plugin_context_t *ctx,
@@ -0,0 +1,135 @@
+/**
+ * @file memo.h
+ * @brief In-memory cache of command output for the memo builtin
+ *
+ * Prompt hooks tend to run the same slow commands over and over
+ * (kubectl config current-context, git describe, ...). The memo cache
+ * runs such a command once, keeps its standard output and exit status in
+ * memory, and replays them on later calls until the entry expires or one
+ * of its dependencies changes.
+ *
+ * An entry is identified by the command's argv together with the names of
+ * the variables and files it depends on. The current values of those
+ * variables and the files' modification times form the entry's
+ * dependency stamp; a call whose stamp differs from the cached one
+ * invalidates the entry and runs the command again.
+ *
+ * Expired entries can be refreshed in the background: the stale output is
+ * returned at once and a child process recomputes it, to be picked up by
+ * a later call.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#ifndef MEMO_H
+#define MEMO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** Default maximum number of cached commands */
+#define MEMO_DEFAULT_MAX_ENTRIES 256
+
+/** Default limit on the total size of cached output in bytes */
+#define MEMO_DEFAULT_MAX_BYTES (4 * 1024 * 1024)
+
+/**
+ * @brief How a memoized command should be looked up and cached
+ */
+typedef struct {
+    double ttl;               /**< Seconds an entry stays fresh (<= 0: forever) */
+    const char *const *vars;  /**< Variables whose values key the entry */
+    size_t var_count;         /**< Number of variables */
+    const char *const *files; /**< Files whose mtimes key the entry */
+    size_t file_count;        /**< Number of files */
+    bool async;               /**< Serve stale output while refreshing */
+} memo_options_t;
+
+/**
+ * @brief Cache counters
+ */
+typedef struct {
+    uint64_t hits;          /**< Calls answered from a fresh entry */
+    uint64_t misses;        /**< Calls that ran the command */
+    uint64_t stale_hits;    /**< Expired output served during a refresh */
+    uint64_t refreshes;     /**< Background refreshes started */
+    uint64_t invalidations; /**< Entries dropped because a dependency changed */
+    uint64_t evictions;     /**< Entries dropped to stay within the limits */
+    size_t entries;         /**< Entries currently cached */
+    size_t bytes;           /**< Output bytes currently cached */
+} memo_stats_t;
+
+/**
+ * @brief Run a command through the cache
+ *
+ * Writes the command's output (cached or fresh) to @p out. Standard error
+ * is never cached: it passes through when the command runs in the
+ * foreground and is discarded for background refreshes.
+ *
+ * @param argc Number of arguments
+ * @param argv Command and arguments
+ * @param opts Lookup options (NULL for defaults)
+ * @param out Stream the output is written to
+ * @return Exit status of the command (cached or fresh), 126 if it could
+ *         not be started
+ */
+int memo_run(int argc, char *const *argv, const memo_options_t *opts,
+             FILE *out);
+
+/**
+ * @brief Collect finished background refreshes
+ *
+ * Called by memo_run() and by the main loop before each command is read,
+ * so finished refresh processes do not stay zombies.
+ */
+void memo_poll(void);
+
+/**
+ * @brief Drop cached entries
+ *
+ * @param argc Number of arguments (0 drops everything)
+ * @param argv Only drop entries for this command line
+ * @return Number of entries dropped
+ */
+size_t memo_clear(int argc, char *const *argv);
+
+/**
+ * @brief Print one line per cached entry
+ *
+ * @param out Output stream
+ */
+void memo_list(FILE *out);
+
+/**
+ * @brief Get cache counters
+ *
+ * @param stats Output counters
+ */
+void memo_get_stats(memo_stats_t *stats);
+
+/**
+ * @brief Reset the hit/miss counters without dropping entries
+ */
+void memo_reset_stats(void);
+
+/**
+ * @brief Set the cache limits
+ *
+ * Entries beyond the new limits are evicted, least recently used first.
+ *
+ * @param max_entries Maximum entries (0 for the default)
+ * @param max_bytes Maximum cached output bytes (0 for the default)
+ */
+void memo_set_limits(size_t max_entries, size_t max_bytes);
+
+/**
+ * @brief Free the cache
+ *
+ * Background refreshes still running are stopped.
+ */
+void memo_cleanup(void);
+
+#endif /* MEMO_H */
@@ -124,6 +124,9 @@ typedef struct node {
 
     /* Source location tracking for error reporting */
     source_location_t loc;
+
+    /* Compiled expression of a NODE_EXTENDED_TEST (NULL until compiled) */
+    struct extended_test *compiled;
 } node_t;
 
 /**
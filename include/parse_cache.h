@@ -0,0 +1,140 @@
+/**
+ * @file parse_cache.h
+ * @brief Cache of parsed command strings
+ *
+ * Frameworks and prompt code hand the shell the same strings over and
+ * over: eval of generated setters and tool init output, trap bodies set
+ * in functions, PROMPT_COMMAND, and files that are sourced again. The
+ * parse cache keeps the syntax tree of each such string, keyed by its
+ * content, so an identical string is tokenized and parsed once per
+ * session.
+ *
+ * An entry is identified by the text, the source name the parser records
+ * in node locations, and the parser features in effect (the tokenizer and
+ * parser consult the shell mode), so a string parsed under one mode is
+ * never replayed under another.
+ *
+ * Cached trees are shared and must not be modified. A caller holds an
+ * entry from parse_cache_acquire() until parse_cache_release(); entries
+ * evicted or cleared meanwhile stay valid until their last holder
+ * releases them. The total size of cached trees is capped and the least
+ * recently used entries are evicted to stay within it.
+ *
+ * @code
+ *     parse_cache_entry_t *entry = parse_cache_acquire(text, "<stdin>");
+ *     if (entry) {
+ *         executor_execute_parsed(executor, parse_cache_tree(entry));
+ *         parse_cache_release(entry);
+ *     }
+ * @endcode
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#ifndef PARSE_CACHE_H
+#define PARSE_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Default limit on the total size of cached trees in bytes */
+#define PARSE_CACHE_DEFAULT_MAX_BYTES (2 * 1024 * 1024)
+
+/* ============================================================================
+ * Types
+ * ============================================================================ */
+
+/** @brief Forward declaration for AST nodes */
+struct node;
+
+/** @brief A parsed string held by a caller */
+typedef struct parse_cache_entry parse_cache_entry_t;
+
+/**
+ * @brief Cache counters
+ */
+typedef struct {
+    uint64_t hits;      /**< Strings answered from the cache */
+    uint64_t misses;    /**< Strings parsed */
+    uint64_t failures;  /**< Strings that did not parse */
+    uint64_t evictions; /**< Entries dropped to stay within the limit */
+    size_t entries;     /**< Entries currently cached */
+    size_t bytes;       /**< Approximate size of the cached entries */
+} parse_cache_stats_t;
+
+/* ============================================================================
+ * Functions
+ * ============================================================================ */
+
+/**
+ * @brief Get the parsed form of a string
+ *
+ * Parses @p text unless an identical string was parsed before under the
+ * same source name and parser features. Nothing is reported for text
+ * that does not parse; callers run it through the usual path for the
+ * diagnostics.
+ *
+ * @param text Command string
+ * @param source_name Source name recorded in node locations (NULL for
+ *        "<stdin>")
+ * @return Entry holding the tree, or NULL if @p text is empty or does not
+ *         parse
+ */
+parse_cache_entry_t *parse_cache_acquire(const char *text,
+                                         const char *source_name);
+
+/**
+ * @brief Get the tree of an entry
+ *
+ * @param entry Entry from parse_cache_acquire()
+ * @return Shared tree, valid until the entry is released
+ */
+struct node *parse_cache_tree(const parse_cache_entry_t *entry);
+
+/**
+ * @brief Release an entry
+ *
+ * @param entry Entry from parse_cache_acquire() (may be NULL)
+ */
+void parse_cache_release(parse_cache_entry_t *entry);
+
+/**
+ * @brief Drop all cached entries
+ *
+ * Entries still held are freed when released.
+ *
+ * @return Number of entries dropped
+ */
+size_t parse_cache_clear(void);
+
+/**
+ * @brief Get cache counters
+ *
+ * @param stats Output counters
+ */
+void parse_cache_get_stats(parse_cache_stats_t *stats);
+
+/**
+ * @brief Reset the hit/miss counters without dropping entries
+ */
+void parse_cache_reset_stats(void);
+
+/**
+ * @brief Set the limit on the total size of cached trees
+ *
+ * Entries beyond the new limit are evicted, least recently used first.
+ * With a limit of 0 nothing is kept: every string is parsed afresh.
+ *
+ * @param max_bytes Maximum size in bytes
+ */
+void parse_cache_set_limit(size_t max_bytes);
+
+/**
+ * @brief Get the limit on the total size of cached trees
+ *
+ * @return Maximum size in bytes
+ */
+size_t parse_cache_get_limit(void);
+
+#endif /* PARSE_CACHE_H */
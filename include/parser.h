@@ -123,6 +123,17 @@ node_t *parser_parse_command_line(parser_t *parser);
  */
 bool parser_has_error(parser_t *parser);
 
+/**
+ * @brief Get the parser features currently in effect
+ *
+ * The tokenizer and parser consult shell_mode_allows() and POSIX mode, so
+ * text parsed under one mask may parse differently under another. Caches
+ * of parsed text key on this mask.
+ *
+ * @return One bit per shell_feature_t allowed, plus bit 63 for POSIX mode
+ */
+uint64_t parser_feature_mask(void);
+
 /**
  * @brief Get the parser error message
  *
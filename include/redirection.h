@@ -47,43 +47,59 @@ bool is_redirection_node(node_t *node);
  */
 int count_redirections(node_t *command);
 
+/** Number of descriptors a redirection can name (0-9) */
+#define REDIRECTION_MAX_FDS 10
+
+/** Saved copies are placed at or above this descriptor */
+#define REDIRECTION_SAVE_FD_MIN 10
+
 /**
  * @brief Redirection state for save/restore operations
  *
- * Stores original file descriptor values so they can be
- * restored after command execution.
+ * Records the descriptors a command's redirections will change, in the
+ * order they are first changed, with a copy of each taken beforehand.
  */
 typedef struct redirection_state {
-    int saved_stdin;   /**< Saved stdin file descriptor */
-    int saved_stdout;  /**< Saved stdout file descriptor */
-    int saved_stderr;  /**< Saved stderr file descriptor */
-    bool stdin_saved;  /**< Whether stdin was saved */
-    bool stdout_saved; /**< Whether stdout was saved */
-    bool stderr_saved; /**< Whether stderr was saved */
+    int count;                      /**< Descriptors saved */
+    int fds[REDIRECTION_MAX_FDS];   /**< Descriptors changed */
+    int saved[REDIRECTION_MAX_FDS]; /**< Copy of each, -1 if it was closed */
 } redirection_state_t;
 
 /**
- * @brief Save current file descriptors
+ * @brief Save the descriptors a command's redirections will change
  *
- * Duplicates stdin, stdout, and stderr so they can be
- * restored after redirections are applied.
+ * Only the descriptors the redirections name are copied, so "echo x >&2"
+ * saves stderr alone. Copies are close-on-exec and placed at or above
+ * REDIRECTION_SAVE_FD_MIN, clear of the descriptors redirections can
+ * name and invisible to commands the shell starts. Descriptors allocated
+ * with {varname} are not saved; they outlive the command.
  *
  * @param state State structure to store saved descriptors
- * @return 0 on success, -1 on error
+ * @param command Command node with redirection children
+ * @return 0 on success, 1 if a descriptor could not be saved
  */
-int save_file_descriptors(redirection_state_t *state);
+int save_file_descriptors(redirection_state_t *state, node_t *command);
 
 /**
  * @brief Restore saved file descriptors
  *
- * Restores stdin, stdout, and stderr from the saved state
- * and closes any redirected file descriptors.
+ * Restores the saved descriptors in reverse order, closes the copies,
+ * and closes descriptors that were not open before the redirections.
  *
  * @param state State structure with saved descriptors
- * @return 0 on success, -1 on error
+ * @return 0 on success, 1 if a descriptor could not be restored
  */
 int restore_file_descriptors(redirection_state_t *state);
 
+/**
+ * @brief Keep the current descriptors and drop the saved copies
+ *
+ * Used by exec, whose redirections are permanent.
+ *
+ * @param state State structure with saved descriptors
+ */
+void discard_saved_file_descriptors(redirection_state_t *state);
+
 /**
  * @brief Report a redirection error
  *
@@ -102,6 +102,7 @@ typedef enum {
     FEATURE_AUTO_CD,            /**< Auto-cd to directories without cd command */
     FEATURE_AUTO_PUSHD,         /**< Auto-push directories to stack on cd */
     FEATURE_CDABLE_VARS,        /**< Treat unset vars as directory names for cd */
+    FEATURE_DIR_FRECENCY,       /**< Record visited directories for z and completion */
 
     /* History Behavior */
     FEATURE_HISTAPPEND,         /**< Append to history file instead of overwrite */
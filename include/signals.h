@@ -15,15 +15,22 @@
 #include <stdbool.h>
 #include <sys/types.h>
 
+struct parse_cache_entry;
+
 /**
  * @brief Trap entry for signal handling
  *
  * Links a signal number to a command string that should be
- * executed when the signal is received.
+ * executed when the signal is received. The command is parsed when the
+ * trap is set, through the parse cache so traps set over and over with
+ * the same command share one tree; an empty command ignores the signal.
  */
 typedef struct trap_entry {
     int signal;              /**< Signal number */
     char *command;           /**< Command to execute on signal */
+    struct parse_cache_entry *parsed; /**< Parsed command, or NULL */
+    bool running;            /**< Command is executing */
+    bool removed;            /**< Removed while running, freed afterwards */
     struct trap_entry *next; /**< Next trap in linked list */
 } trap_entry_t;
 
@@ -104,11 +111,12 @@ int check_and_clear_sigint_flag(void);
  * @brief Set a trap for a signal
  *
  * Associates a command with a signal number. When the signal
- * is received, the command will be executed.
+ * is received, the command will be executed in the current shell.
  *
  * @param signal Signal number
- * @param command Command string to execute (NULL to reset to default)
- * @return 0 on success, -1 on error
+ * @param command Command string to execute (NULL to reset to default,
+ *                empty to ignore the signal)
+ * @return 0 on success, -1 on error (e.g. the signal cannot be caught)
  */
 int set_trap(int signal, const char *command);
 
@@ -134,7 +142,8 @@ void list_traps(void);
  * @brief Convert a signal name to its number
  *
  * Converts signal names like "INT", "TERM", "HUP" to their
- * corresponding numeric values.
+ * corresponding numeric values. Real-time signals are named RTMIN,
+ * RTMIN+n, RTMAX-n and RTMAX.
  *
  * @param signame Signal name (with or without "SIG" prefix)
  * @return Signal number, or -1 if not found
@@ -144,12 +153,21 @@ int get_signal_number(const char *signame);
 /**
  * @brief Execute pending trap commands deferred from signal handlers
  *
- * Signal handlers set a bitmask instead of calling system() directly.
- * This function runs the deferred trap commands safely from main loop
- * context. Should be called at the top of each REPL iteration.
+ * Signal handlers only flag the signal. This function runs the deferred
+ * trap commands through the shell's executor, preserving $?. Called at
+ * the top of each REPL iteration and after each simple command.
  */
 void execute_pending_traps(void);
 
+/**
+ * @brief Check whether a trapped signal is waiting to be handled
+ *
+ * Cheap enough to call after every command.
+ *
+ * @return true if execute_pending_traps() has work to do
+ */
+bool traps_pending(void);
+
 /**
  * @brief Execute all EXIT traps
  *
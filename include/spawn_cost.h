@@ -0,0 +1,164 @@
+/**
+ * @file spawn_cost.h
+ * @brief Process spawn cost analysis for shell scripts
+ *
+ * Walks a parsed script and estimates how many processes each construct
+ * starts: external commands, command substitutions, pipeline stages,
+ * subshells and background jobs. Occurrences inside loops are weighted by
+ * their nesting depth, and the estimates are totalled per function so the
+ * analyzer can report a per-function spawn budget.
+ *
+ * Well-known idioms that fork only to compute something the shell can do
+ * itself ($(cat f), $(basename "$p"), expr arithmetic, echo | grep -q, ...)
+ * are recorded as sites, with an in-shell rewrite when one is equivalent.
+ * The fixer turns those rewrites into fixes.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#ifndef SPAWN_COST_H
+#define SPAWN_COST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "compat.h"
+#include "node.h"
+
+/* ============================================================================
+ * Constants
+ * ============================================================================ */
+
+/** Default per-function spawn budget (estimated processes per call) */
+#define SPAWN_DEFAULT_BUDGET 32
+
+/** Assumed iterations per loop level when weighting loop bodies */
+#define SPAWN_LOOP_WEIGHT 10
+
+/** Deepest loop level that still increases the weight */
+#define SPAWN_MAX_WEIGHTED_DEPTH 3
+
+/* ============================================================================
+ * Types
+ * ============================================================================ */
+
+/**
+ * @brief Process-spawning idioms recognized by the analysis
+ */
+typedef enum {
+    SPAWN_IDIOM_CAT_SUBST,   /**< $(cat file) */
+    SPAWN_IDIOM_ECHO_SUBST,  /**< $(echo word) */
+    SPAWN_IDIOM_BASENAME,    /**< $(basename "$path") */
+    SPAWN_IDIOM_DIRNAME,     /**< $(dirname "$path") */
+    SPAWN_IDIOM_EXPR,        /**< $(expr a + b) */
+    SPAWN_IDIOM_ECHO_GREP,   /**< echo "$x" | grep -q pattern */
+    SPAWN_IDIOM_WC_LINES,    /**< $(wc -l < file) */
+    SPAWN_IDIOM_COUNT        /**< Number of idioms */
+} spawn_idiom_t;
+
+/**
+ * @brief One occurrence of a process-spawning idiom
+ */
+typedef struct {
+    spawn_idiom_t idiom;   /**< Which idiom was found */
+    int line;              /**< Line number (1-based, 0 if not located) */
+    int column;            /**< Column number (1-based, 0 if not located) */
+    size_t offset;         /**< Byte offset of the construct in the source */
+    size_t length;         /**< Length of the construct (0 if not located) */
+    unsigned spawns;       /**< Processes started per execution */
+    unsigned loop_depth;   /**< Number of enclosing loops */
+    unsigned long weight;  /**< spawns scaled by loop nesting */
+    int function;          /**< Index into functions, -1 at top level */
+    char *original;        /**< Source text of the construct (owned) */
+    char *replacement;     /**< In-shell rewrite, NULL if none (owned) */
+    fix_type_t fix_type;   /**< Safety of the rewrite for the target */
+} spawn_site_t;
+
+/**
+ * @brief Estimated spawn cost of one function
+ */
+typedef struct {
+    char *name;                    /**< Function name (owned) */
+    int line;                      /**< Line of the definition (0 if unknown) */
+    unsigned long weighted_spawns; /**< Estimated processes per call */
+    size_t site_count;             /**< Idiom sites inside the function */
+} spawn_function_t;
+
+/**
+ * @brief Result of a spawn cost analysis
+ */
+typedef struct {
+    spawn_site_t *sites;          /**< Idiom sites in source order */
+    size_t site_count;            /**< Number of sites */
+    size_t site_capacity;         /**< Allocated site capacity */
+    spawn_function_t *functions;  /**< Functions in definition order */
+    size_t function_count;        /**< Number of functions */
+    size_t function_capacity;     /**< Allocated function capacity */
+    unsigned long toplevel_spawns; /**< Weighted spawns outside functions */
+} spawn_report_t;
+
+/* ============================================================================
+ * Analysis
+ * ============================================================================ */
+
+/**
+ * @brief Estimate the process spawns of a parsed script
+ *
+ * Calls to functions defined in the script are not followed; each function
+ * is totalled on its own. Rewrites that need syntax beyond POSIX sh
+ * ($(<file), [[ =~ ]]) are only offered as fixes for non-POSIX targets.
+ *
+ * @param content Script source the AST was parsed from
+ * @param ast Parsed script (may be NULL, in which case nothing is found)
+ * @param target Target shell for the rewrites
+ * @param report Report to fill (initialized by this call)
+ * @return true on success, false on allocation failure
+ */
+bool spawn_analyze(const char *content, node_t *ast, shell_mode_t target,
+                   spawn_report_t *report);
+
+/**
+ * @brief Free everything owned by a spawn report
+ *
+ * @param report Report to clear (may be NULL)
+ */
+void spawn_report_free(spawn_report_t *report);
+
+/**
+ * @brief Describe an idiom for diagnostics
+ *
+ * @param idiom Idiom
+ * @return Static description string
+ */
+const char *spawn_idiom_message(spawn_idiom_t idiom);
+
+/**
+ * @brief Suggest an in-shell alternative for an idiom
+ *
+ * @param idiom Idiom
+ * @return Static suggestion string
+ */
+const char *spawn_idiom_suggestion(spawn_idiom_t idiom);
+
+/* ============================================================================
+ * Budget
+ * ============================================================================ */
+
+/**
+ * @brief Set the per-function spawn budget
+ *
+ * Functions whose estimated spawns per call exceed the budget are reported
+ * as warnings. A budget of 0 restores the default.
+ *
+ * @param budget Estimated processes allowed per call
+ */
+void spawn_set_budget(unsigned long budget);
+
+/**
+ * @brief Get the per-function spawn budget
+ *
+ * @return Current budget
+ */
+unsigned long spawn_get_budget(void);
+
+#endif /* SPAWN_COST_H */
@@ -0,0 +1,156 @@
+/**
+ * @file startup_cache.h
+ * @brief Cache of parsed startup files
+ *
+ * /etc/profile, the profile.d scripts and the user rc files are read and
+ * parsed on every shell start. The startup cache keeps the parsed form of
+ * each such file in a per-user cache directory
+ * ($XDG_CACHE_HOME/lush/startup, or ~/.cache/lush/startup), so an
+ * unchanged file is executed from ready-made syntax trees without lexing
+ * or parsing it.
+ *
+ * A cache entry is tied to the file's path, device, inode, size and
+ * modification time and to the lush version; any change rebuilds it. Each
+ * construct also records the parser features that were in effect when it
+ * was parsed, and is parsed afresh if they differ when it is replayed (a
+ * script can switch shell modes part way through). Constructs that do not
+ * parse are stored as text and re-run through the parser, so diagnostics
+ * are unchanged.
+ *
+ * Files are read through a startup_script_t, which replaces the
+ * get_input_complete() / parse_and_execute() loop:
+ *
+ * @code
+ *     startup_script_t *script = startup_script_open(path, file);
+ *     char *construct;
+ *     while ((construct = startup_script_read(script)) != NULL) {
+ *         int status = startup_script_execute(script, construct);
+ *         free(construct);
+ *     }
+ *     startup_script_close(script);
+ * @endcode
+ *
+ * With the cache disabled (`lush --no-startup-cache`) the script reads and
+ * parses the file exactly as before.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#ifndef STARTUP_CACHE_H
+#define STARTUP_CACHE_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/* ============================================================================
+ * Constants
+ * ============================================================================ */
+
+/** Cache directory, relative to the user cache directory */
+#define STARTUP_CACHE_DIR "lush/startup"
+
+/** Largest cache file that is loaded */
+#define STARTUP_CACHE_MAX_SIZE (16u * 1024u * 1024u)
+
+/* ============================================================================
+ * Types
+ * ============================================================================ */
+
+/** @brief A startup file being executed, from the cache or from source */
+typedef struct startup_script startup_script_t;
+
+/**
+ * @brief Startup cache counters
+ */
+typedef struct {
+    unsigned hits;        /**< Files executed from the cache */
+    unsigned misses;      /**< Files parsed from source */
+    unsigned stores;      /**< Cache entries written */
+    unsigned reparsed;    /**< Cached constructs parsed again from text */
+} startup_cache_stats_t;
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+/**
+ * @brief Turn the startup cache on or off (on by default)
+ * @param enabled false to read and parse every startup file
+ */
+void startup_cache_set_enabled(bool enabled);
+
+/**
+ * @brief Check whether the startup cache is on
+ */
+bool startup_cache_enabled(void);
+
+/**
+ * @brief Override the cache directory
+ *
+ * @param dir Directory for cache entries, or NULL for the default
+ */
+void startup_cache_set_dir(const char *dir);
+
+/**
+ * @brief Get the cache counters
+ */
+startup_cache_stats_t startup_cache_stats(void);
+
+/**
+ * @brief Reset the cache counters
+ */
+void startup_cache_reset_stats(void);
+
+/* ============================================================================
+ * Startup Scripts
+ * ============================================================================ */
+
+/**
+ * @brief Start executing a startup file
+ *
+ * Loads the cache entry for the file if it is current; otherwise the file
+ * is read from @p file and its parsed constructs are recorded.
+ *
+ * @param path Path of the file, or NULL to read it without the cache
+ * @param file The file, opened for reading (not closed)
+ * @return Script handle, or NULL on allocation failure
+ */
+startup_script_t *startup_script_open(const char *path, FILE *file);
+
+/**
+ * @brief Read the next complete construct
+ *
+ * Same contract as get_input_complete(): empty constructs are returned
+ * too, so construct numbering is unchanged.
+ *
+ * @param script Script handle
+ * @return Newly allocated construct text, or NULL at end of file
+ */
+char *startup_script_read(startup_script_t *script);
+
+/**
+ * @brief Execute the construct last returned by startup_script_read()
+ *
+ * @param script Script handle
+ * @param construct Text returned by startup_script_read()
+ * @return Exit status, as from parse_and_execute()
+ */
+int startup_script_execute(startup_script_t *script, const char *construct);
+
+/**
+ * @brief Check whether a script is being replayed from the cache
+ */
+bool startup_script_from_cache(const startup_script_t *script);
+
+/**
+ * @brief Finish a script and write its cache entry if one was recorded
+ *
+ * Constructs not read (after a `return`) are read and stored unparsed, so
+ * files that return early are cached too.
+ *
+ * @param script Script handle (may be NULL)
+ */
+void startup_script_close(startup_script_t *script);
+
+#endif /* STARTUP_CACHE_H */
@@ -0,0 +1,159 @@
+/**
+ * @file startup_profile.h
+ * @brief Startup critical-path tracer and deferred initialization
+ *
+ * The tracer records the wall time of each phase of init() and of every
+ * file sourced while the shell starts, up to the moment the first prompt
+ * is drawn (or, for non-interactive shells, the end of init()). With
+ * `lush --startup-profile[=MS]` the timings are printed to stderr at that
+ * point, together with the total against a cold-start budget. When
+ * profiling is off every hook is a single flag test.
+ *
+ * Work that the first prompt does not need is registered with
+ * startup_defer() instead of running inline. Deferred tasks run the first
+ * time the line editor goes idle after drawing the prompt.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#ifndef STARTUP_PROFILE_H
+#define STARTUP_PROFILE_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/* ============================================================================
+ * Constants
+ * ============================================================================ */
+
+/** Default cold-start-to-prompt budget in milliseconds */
+#define STARTUP_DEFAULT_BUDGET_MS 50.0
+
+/** Most phases and files recorded; later ones are counted but not listed */
+#define STARTUP_MAX_EVENTS 256
+
+/** Most tasks that can be deferred */
+#define STARTUP_MAX_DEFERRED 16
+
+/* ============================================================================
+ * Profiling
+ * ============================================================================ */
+
+/**
+ * @brief Turn on startup profiling
+ *
+ * Must be called as early as possible; the clock of the total starts at
+ * the first call.
+ *
+ * @param budget_ms Budget for the total, or 0 for the default
+ *                  (LUSH_STARTUP_BUDGET_MS overrides the default)
+ */
+void startup_profile_enable(double budget_ms);
+
+/**
+ * @brief Check whether startup profiling is on
+ * @return true if phases are being recorded
+ */
+bool startup_profile_enabled(void);
+
+/**
+ * @brief Start timing a phase of initialization
+ *
+ * Ends the previous phase, if any. Phases are not nested.
+ *
+ * @param name Static name of the phase
+ */
+void startup_phase(const char *name);
+
+/**
+ * @brief Start timing a sourced file
+ *
+ * Files nest (a profile that sources profile.d scripts shows them
+ * indented below it) and are attributed to the current phase.
+ *
+ * @param path Path of the file (copied)
+ */
+void startup_file_begin(const char *path);
+
+/**
+ * @brief Stop timing the innermost sourced file
+ */
+void startup_file_end(void);
+
+/**
+ * @brief Mark the end of startup
+ *
+ * Called once the first prompt is drawn, or at the end of init() for
+ * non-interactive shells. The first call ends the current phase and stops
+ * the clock; later calls do nothing.
+ *
+ * @param report_to If profiling is on, print the report here (NULL lets
+ *                  the caller print it with startup_profile_report())
+ */
+void startup_profile_finish(FILE *report_to);
+
+/**
+ * @brief Check whether startup has finished
+ * @return true once startup_profile_finish() has been called
+ */
+bool startup_profile_finished(void);
+
+/**
+ * @brief Print the timings recorded so far
+ *
+ * @param out Stream to print to
+ * @return true if the total is within the budget
+ */
+bool startup_profile_report(FILE *out);
+
+/**
+ * @brief Total startup time in milliseconds
+ *
+ * Measured from startup_profile_enable() to startup_profile_finish(), or
+ * to now if startup has not finished. 0 when profiling is off.
+ */
+double startup_profile_total_ms(void);
+
+/**
+ * @brief Forget all recorded timings and deferred tasks
+ *
+ * Profiling is turned off. Intended for tests.
+ */
+void startup_profile_reset(void);
+
+/* ============================================================================
+ * Deferred Initialization
+ * ============================================================================ */
+
+/** Initialization task run after the first prompt */
+typedef void (*startup_task_fn)(void);
+
+/**
+ * @brief Defer an initialization task until after the first prompt
+ *
+ * Tasks run in registration order. If the table is full the task runs
+ * immediately.
+ *
+ * @param name Static name shown in the profile
+ * @param fn Task to run
+ */
+void startup_defer(const char *name, startup_task_fn fn);
+
+/**
+ * @brief Run every pending deferred task
+ *
+ * Safe to call repeatedly; tasks run once.
+ *
+ * @param report_to If profiling is on, print each task's time here
+ *                  (may be NULL)
+ * @return Number of tasks run by this call
+ */
+int startup_run_deferred(FILE *report_to);
+
+/**
+ * @brief Count deferred tasks that have not run yet
+ */
+int startup_deferred_pending(void);
+
+#endif /* STARTUP_PROFILE_H */
@@ -99,6 +99,10 @@ struct symtable_scope_enhanced {
 // Symbol table manager (forward declaration for implementation)
 typedef struct symtable_manager symtable_manager_t;
 
+// Called with a variable name after its visible value may have changed
+// (NULL when every variable may have changed)
+typedef void (*symtable_change_hook_t)(const char *name);
+
 // Legacy compatibility structures (for string management system)
 typedef enum {
     SYM_STR,
@@ -238,6 +242,17 @@ int symtable_set_local_var(symtable_manager_t *manager, const char *name,
 int symtable_set_global_var(symtable_manager_t *manager, const char *name,
                             const char *value);
 
+/**
+ * @brief Install the variable change hook
+ *
+ * The hook runs after a variable is set or unset and for each local
+ * variable dropped when a scope is popped, so callers can cache values
+ * derived from variables instead of looking them up every time.
+ *
+ * @param hook Hook to call, or NULL to remove it
+ */
+void symtable_set_change_hook(symtable_change_hook_t hook);
+
 /**
  * @brief Get a variable value with scope lookup
  *
@@ -113,14 +113,20 @@ typedef enum {
 // Token structure for parser
 typedef struct token {
     token_type_t type;
-    char *text;         // Token text (null-terminated)
-    size_t length;      // Token length
-    size_t line;        // Line number (1-based)
-    size_t column;      // Column number (1-based)
-    size_t position;    // Absolute position in input
-    struct token *next; // For token stream
+    char *text;             // Token text (null-terminated)
+    size_t length;          // Token length
+    size_t line;            // Line number (1-based)
+    size_t column;          // Column number (1-based)
+    size_t position;        // Absolute position in input
+    size_t capacity;        // Size of the text buffer (reused across tokens)
+    bool keyword_candidate; // Plain word: type follows enable_keywords
+    struct token *next;     // For token stream
 } token_t;
 
+// Token slots owned by a tokenizer: current, lookahead and two that stay
+// valid for one advance after they are released
+#define TOKENIZER_SLOTS 4
+
 // Tokenizer state for parser
 typedef struct tokenizer {
     const char *input;    // Input string
@@ -132,6 +138,8 @@ typedef struct tokenizer {
     token_t *lookahead;   // Next token (for lookahead)
     bool enable_keywords; // Whether to recognize keywords (context-sensitive)
     int arith_cmd_depth;  // Nesting depth of (( )) arithmetic commands
+    token_t slots[TOKENIZER_SLOTS]; // Storage for current and lookahead
+    size_t next_slot;               // Slot the next token is produced in
 } tokenizer_t;
 
 /* ============================================================================
@@ -249,8 +257,9 @@ void tokenizer_enable_keywords(tokenizer_t *tokenizer, bool enable);
 /**
  * @brief Refresh the lookahead token with current settings
  *
- * Re-tokenizes the lookahead token using current tokenizer settings.
- * Use when keyword recognition context changes before advancing.
+ * Re-classifies the lookahead token using current tokenizer settings.
+ * Use when keyword recognition context changes before advancing. Plain
+ * words are re-classified from their text without re-lexing.
  *
  * @param tokenizer Tokenizer context
  */
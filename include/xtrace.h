@@ -0,0 +1,83 @@
+/**
+ * @file xtrace.h
+ * @brief Execution trace (set -x) output
+ *
+ * Formats and writes execution trace records for the xtrace (-x) option.
+ * Records are built in a reusable buffer in a single pass and written to
+ * the trace descriptor with one write(2) each.
+ *
+ * Output is controlled by shell variables, cached until one of them is
+ * assigned or unset:
+ * - LUSH_XTRACEFD (or BASH_XTRACEFD): descriptor to write to (default 2)
+ * - LUSH_XTRACE_FORMAT: "classic" ("+ cmd args", default) or "json"
+ *   (one JSON object per line with timestamp, pid, source location,
+ *   exit status and duration)
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#ifndef XTRACE_H
+#define XTRACE_H
+
+#include <stdbool.h>
+#include <time.h>
+
+/**
+ * @brief Trace output formats
+ */
+typedef enum {
+    XTRACE_FORMAT_CLASSIC, /**< "+ cmd args" lines (POSIX set -x) */
+    XTRACE_FORMAT_JSON     /**< JSON-lines records */
+} xtrace_format_t;
+
+/**
+ * @brief In-flight trace record for one command
+ *
+ * Lives on the caller's stack between xtrace_begin() and xtrace_end().
+ */
+typedef struct xtrace_record {
+    bool active;              /**< Record was started (tracing enabled) */
+    xtrace_format_t format;   /**< Format chosen when the record started */
+    int fd;                   /**< Descriptor chosen when the record started */
+    const char *kind;         /**< "external", "builtin", "function", ... */
+    char *const *argv;        /**< Command words (borrowed) */
+    const char *file;         /**< Source file (borrowed, may be NULL) */
+    int line;                 /**< Source line (0 = unknown) */
+    struct timespec wall;     /**< Wall clock start (CLOCK_REALTIME) */
+    struct timespec start;    /**< Monotonic start (CLOCK_MONOTONIC) */
+} xtrace_record_t;
+
+/**
+ * @brief Start a trace record for a command
+ *
+ * Does nothing unless xtrace (-x) is enabled. In classic format the
+ * "+ cmd args" line is written immediately; in JSON format the record is
+ * written by xtrace_end() once the exit status and duration are known.
+ *
+ * @param rec Record to initialize
+ * @param kind Command kind ("external", "builtin", "function")
+ * @param argv NULL-terminated command words (must outlive the record)
+ * @param file Source file name, or NULL (must outlive the record)
+ * @param line Source line number, or 0
+ */
+void xtrace_begin(xtrace_record_t *rec, const char *kind, char *const *argv,
+                  const char *file, int line);
+
+/**
+ * @brief Finish a trace record
+ *
+ * Writes the JSON record (if JSON format is active). Safe to call on a
+ * record for which tracing was disabled.
+ *
+ * @param rec Record started with xtrace_begin()
+ * @param status Command exit status
+ */
+void xtrace_end(xtrace_record_t *rec, int status);
+
+/**
+ * @brief Release the trace buffer
+ */
+void xtrace_cleanup(void);
+
+#endif /* XTRACE_H */
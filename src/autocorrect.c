@@ -13,17 +13,20 @@
 #include "autocorrect.h"
 #include "fuzzy_match.h"
 
+#include "alias.h"
 #include "builtins.h"
 #include "executor.h"
 
 #include <ctype.h>
 #include <dirent.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
 #include <sys/stat.h>
 #include <termios.h>
+#include <time.h>
 #include <unistd.h>
 
 // Global auto-correction configuration
@@ -39,14 +42,95 @@ static struct {
 // Debug flag
 static bool debug_enabled = false;
 
-// Learned commands cache (simple array for now)
+// Maximum number of commands learned from history
 #define MAX_LEARNED_COMMANDS 1000
-static char *learned_commands[MAX_LEARNED_COMMANDS];
-static int learned_commands_count = 0;
+
+/* ============================================================================
+ * Suggestion Index
+ *
+ * Every candidate name (builtins, functions, aliases, PATH executables and
+ * learned commands) lives in one index, bucketed by length and tagged with a
+ * 64-bit character-set signature. A lookup only visits the buckets within
+ * the search radius and runs the bounded edit distance on names whose
+ * signature could be that close, so a miss costs microseconds even with
+ * thousands of executables. PATH directories are tracked individually and
+ * rescanned only when PATH itself or a directory's modification time
+ * changes.
+ * ============================================================================ */
+
+/** Longest name that is indexed (longer names are never suggested) */
+#define AC_MAX_NAME 64
+
+/** Node count below which dead nodes are never compacted away */
+#define AC_COMPACT_MIN 256
+
+/** Nearest live candidates that get the full similarity score */
+#define AC_MAX_SCORED 16
+
+/** Index entry: one candidate name and the sources that provide it */
+typedef struct {
+    char *name;         /**< Candidate name (owned) */
+    unsigned sources;   /**< autocorrect_source_t bits, 0 if dead */
+    unsigned path_refs; /**< Tracked PATH directories containing the name */
+    int path_dir;       /**< Directory that last provided it (hint) */
+    uint64_t signature; /**< Set of case-folded characters in the name */
+} ac_node_t;
+
+/** Node indices of one name length */
+typedef struct {
+    int *nodes;      /**< Node indices */
+    size_t count;    /**< Number of nodes */
+    size_t capacity; /**< Allocated capacity */
+} ac_bucket_t;
+
+/** A PATH directory and the index entries it contributed */
+typedef struct {
+    char *path;            /**< Directory path (owned) */
+    bool present;          /**< Scanned and still current */
+    bool racy;             /**< Modified in the second it was scanned */
+    dev_t dev;             /**< Device at scan time */
+    ino_t ino;             /**< Inode at scan time */
+    time_t mtime;          /**< Modification time at scan time */
+    int *entries;          /**< Node indices contributed by this directory */
+    size_t entry_count;    /**< Number of entries */
+    size_t entry_capacity; /**< Allocated entry capacity */
+} ac_dir_t;
+
+static struct {
+    ac_node_t *nodes;     /**< Node storage */
+    size_t count;         /**< Nodes in use, live or dead */
+    size_t capacity;      /**< Allocated node capacity */
+    size_t live;          /**< Nodes with at least one source */
+    int *slots;           /**< Open-addressed name hash of node indices */
+    size_t slot_count;    /**< Hash size (power of two, 0 if none) */
+    ac_bucket_t buckets[AC_MAX_NAME + 1]; /**< Nodes by name length */
+    ac_dir_t *dirs;       /**< Tracked PATH directories in PATH order */
+    size_t dir_count;     /**< Number of tracked directories */
+    char *path_value;     /**< PATH value the directories came from */
+    bool builtins_loaded; /**< Builtin names have been added */
+    size_t learned;       /**< Names learned from history */
+    size_t dir_scans;     /**< Directory scans performed */
+} ac_index = {0};
+
+/** A name found within the search radius */
+typedef struct {
+    int node;     /**< Node index */
+    int distance; /**< Case-folded edit distance to the query */
+} ac_match_t;
 
 /* Forward declarations for internal helper functions */
-static void sort_corrections_by_score(correction_t *corrections, int count);
 static bool is_executable_file(const char *path);
+static int index_add_name(const char *name, unsigned source);
+static int index_lookup(const char *name);
+static void index_load_builtins(void);
+static void index_sync_path(void);
+static bool index_path_executable(int node);
+static void index_free(void);
+static bool function_defined(executor_t *executor, const char *name);
+static int suggest_from_index(executor_t *executor, const char *command,
+                              unsigned mask, int min_score,
+                              correction_t *suggestions, int max_suggestions,
+                              bool case_sensitive);
 
 /**
  * Initialize auto-correction system
@@ -55,11 +139,17 @@ int autocorrect_init(void) {
     // Set default configuration
     autocorrect_get_default_config(&autocorrect_config);
 
-    // Initialize learned commands array
-    for (int i = 0; i < MAX_LEARNED_COMMANDS; i++) {
-        learned_commands[i] = NULL;
+    // Forget learned commands; other indexed names stay valid
+    for (size_t i = 0; i < ac_index.count; i++) {
+        ac_node_t *node = &ac_index.nodes[i];
+        if (node->sources & AUTOCORRECT_SOURCE_HISTORY) {
+            node->sources &= ~(unsigned)AUTOCORRECT_SOURCE_HISTORY;
+            if (node->sources == 0) {
+                ac_index.live--;
+            }
+        }
     }
-    learned_commands_count = 0;
+    ac_index.learned = 0;
 
     // Reset statistics
     autocorrect_reset_stats();
@@ -75,14 +165,8 @@ int autocorrect_init(void) {
  * Cleanup auto-correction system
  */
 void autocorrect_cleanup(void) {
-    // Free learned commands
-    for (int i = 0; i < learned_commands_count; i++) {
-        if (learned_commands[i]) {
-            free(learned_commands[i]);
-            learned_commands[i] = NULL;
-        }
-    }
-    learned_commands_count = 0;
+    // Free the suggestion index, including learned commands
+    index_free();
 
     if (debug_enabled) {
         printf("DEBUG: Auto-correction system cleaned up\n");
@@ -131,100 +215,30 @@ int autocorrect_find_suggestions(executor_t *executor, const char *command,
     memset(results, 0, sizeof(correction_results_t));
     results->original_command = strdup(command);
 
-    // Temporary array to collect all suggestions from all sources
-    // Each source can contribute up to MAX_CORRECTIONS, then we sort and take best
-    correction_t
-        temp_suggestions[MAX_CORRECTIONS * 4]; // Space for all sources
-    int temp_count = 0;
-    int max_per_source = MAX_CORRECTIONS;
-
-    // Find builtin suggestions
-    if (autocorrect_config.correct_builtins && temp_count < MAX_CORRECTIONS * 4) {
-        int builtin_count = autocorrect_suggest_builtins(
-            command, &temp_suggestions[temp_count],
-            max_per_source, autocorrect_config.case_sensitive);
-        temp_count += builtin_count;
-
-        if (debug_enabled && builtin_count > 0) {
-            printf("DEBUG: Found %d builtin suggestions for '%s'\n",
-                   builtin_count, command);
-        }
+    // One index lookup covers every enabled source; names are unique in
+    // the index, so no cross-source deduplication is needed
+    unsigned mask = AUTOCORRECT_SOURCE_FUNCTION | AUTOCORRECT_SOURCE_ALIAS;
+    if (autocorrect_config.correct_builtins) {
+        mask |= AUTOCORRECT_SOURCE_BUILTIN;
     }
-
-    // Find function suggestions
-    if (executor && temp_count < MAX_CORRECTIONS * 4) {
-        int function_count = autocorrect_suggest_functions(
-            executor, command, &temp_suggestions[temp_count],
-            max_per_source, autocorrect_config.case_sensitive);
-        temp_count += function_count;
-
-        if (debug_enabled && function_count > 0) {
-            printf("DEBUG: Found %d function suggestions for '%s'\n",
-                   function_count, command);
-        }
+    if (autocorrect_config.correct_external) {
+        mask |= AUTOCORRECT_SOURCE_PATH;
     }
-
-    // Find PATH command suggestions
-    if (autocorrect_config.correct_external && temp_count < MAX_CORRECTIONS * 4) {
-        int path_count = autocorrect_suggest_path_commands(
-            command, &temp_suggestions[temp_count],
-            max_per_source, autocorrect_config.case_sensitive);
-        temp_count += path_count;
-
-        if (debug_enabled && path_count > 0) {
-            printf("DEBUG: Found %d PATH suggestions for '%s'\n", path_count,
-                   command);
-        }
+    if (autocorrect_config.learn_from_history) {
+        mask |= AUTOCORRECT_SOURCE_HISTORY;
     }
 
-    // Find history suggestions
-    if (autocorrect_config.learn_from_history && temp_count < MAX_CORRECTIONS * 4) {
-        int history_count = autocorrect_suggest_from_history(
-            command, &temp_suggestions[temp_count],
-            max_per_source, autocorrect_config.case_sensitive);
-        temp_count += history_count;
-
-        if (debug_enabled && history_count > 0) {
-            printf("DEBUG: Found %d history suggestions for '%s'\n",
-                   history_count, command);
-        }
-    }
-
-    // Sort suggestions by score (highest first)
-    sort_corrections_by_score(temp_suggestions, temp_count);
-
-    // Copy top suggestions to results, filtering by threshold, max count, and duplicates
     int max_to_copy = (autocorrect_config.max_suggestions < MAX_CORRECTIONS)
                           ? autocorrect_config.max_suggestions
                           : MAX_CORRECTIONS;
-
-    for (int i = 0; i < temp_count && results->count < max_to_copy; i++) {
-        if (temp_suggestions[i].score >=
-            autocorrect_config.similarity_threshold) {
-            // Check for duplicates (same command from different sources)
-            bool is_duplicate = false;
-            for (int j = 0; j < results->count; j++) {
-                if (strcmp(results->suggestions[j].command, 
-                          temp_suggestions[i].command) == 0) {
-                    is_duplicate = true;
-                    break;
-                }
-            }
-            if (!is_duplicate) {
-                results->suggestions[results->count] = temp_suggestions[i];
-                temp_suggestions[i].command = NULL; // Transferred ownership
-                results->count++;
-            }
-        }
+    int min_score = autocorrect_config.similarity_threshold;
+    if (min_score < MIN_SIMILARITY_SCORE) {
+        min_score = MIN_SIMILARITY_SCORE;
     }
 
-    // Free any temp_suggestions that were not copied to results
-    for (int i = 0; i < temp_count; i++) {
-        if (temp_suggestions[i].command) {
-            free(temp_suggestions[i].command);
-            temp_suggestions[i].command = NULL;
-        }
-    }
+    results->count = suggest_from_index(
+        executor, command, mask, min_score, results->suggestions, max_to_copy,
+        autocorrect_config.case_sensitive);
 
     // Update statistics
     if (results->count > 0) {
@@ -369,22 +383,20 @@ void autocorrect_learn_command(const char *command) {
     }
 
     // Check if command already exists
-    for (int i = 0; i < learned_commands_count; i++) {
-        if (learned_commands[i] && strcmp(learned_commands[i], command) == 0) {
-            return; // Already learned
-        }
+    int existing = index_lookup(command);
+    if (existing >= 0 &&
+        (ac_index.nodes[existing].sources & AUTOCORRECT_SOURCE_HISTORY)) {
+        return; // Already learned
     }
 
     // Add new command if there's space
-    if (learned_commands_count < MAX_LEARNED_COMMANDS) {
-        learned_commands[learned_commands_count] = strdup(command);
-        if (learned_commands[learned_commands_count]) {
-            learned_commands_count++;
-            autocorrect_stats.commands_learned++;
-
-            if (debug_enabled) {
-                printf("DEBUG: Learned command: '%s'\n", command);
-            }
+    if (ac_index.learned < MAX_LEARNED_COMMANDS &&
+        index_add_name(command, AUTOCORRECT_SOURCE_HISTORY) >= 0) {
+        ac_index.learned++;
+        autocorrect_stats.commands_learned++;
+
+        if (debug_enabled) {
+            printf("DEBUG: Learned command: '%s'\n", command);
         }
     }
 }
@@ -404,37 +416,31 @@ bool autocorrect_command_exists(executor_t *executor, const char *command) {
     }
 #endif
 
-    // Check if it's a function (requires executor context)
-    if (executor) {
-        // This would need to be implemented with access to executor's function
-        // table For now, we'll skip function checking
-    }
-
-    // Check PATH
-    char *path = getenv("PATH");
-    if (!path) {
-        return false;
+    // Check if it's a function
+    if (function_defined(executor, command)) {
+        return true;
     }
 
-    char *path_copy = strdup(path);
-    if (!path_copy) {
-        return false;
+    // Check PATH through the index; directories are rescanned only when
+    // they change
+    index_sync_path();
+    if (!strchr(command, '/') && strlen(command) <= AC_MAX_NAME) {
+        int node = index_lookup(command);
+        return node >= 0 &&
+               (ac_index.nodes[node].sources & AUTOCORRECT_SOURCE_PATH) &&
+               index_path_executable(node);
     }
 
-    char *dir = strtok(path_copy, ":");
-    while (dir) {
+    for (size_t i = 0; i < ac_index.dir_count; i++) {
         char full_path[1024];
-        snprintf(full_path, sizeof(full_path), "%s/%s", dir, command);
+        snprintf(full_path, sizeof(full_path), "%s/%s", ac_index.dirs[i].path,
+                 command);
 
         if (is_executable_file(full_path)) {
-            free(path_copy);
             return true;
         }
-
-        dir = strtok(NULL, ":");
     }
 
-    free(path_copy);
     return false;
 }
 
@@ -495,204 +501,33 @@ int autocorrect_suggest_builtins(const char *command, correction_t *suggestions,
     (void)case_sensitive;
     return 0;
 #else
-    int count = 0;
-
-    // Get list of builtin commands
-    const char *builtins[] = {
-        "cd",     "pwd",   "echo",   "printf",  "test",     "[",
-        "true",   "false", ":",      ".",       "break",    "continue",
-        "return", "exit",  "export", "set",     "unset",    "shift",
-        "eval",   "exec",  "hash",   "type",    "ulimit",   "umask",
-        "times",  "trap",  "wait",   "getopts", "readonly", "config"};
-
-    int builtin_count = sizeof(builtins) / sizeof(builtins[0]);
-
-    for (int i = 0; i < builtin_count && count < max_suggestions; i++) {
-        int score =
-            autocorrect_similarity_score(command, builtins[i], case_sensitive);
-        if (score >= MIN_SIMILARITY_SCORE) {
-            suggestions[count].command = strdup(builtins[i]);
-            suggestions[count].score = score;
-            suggestions[count].source = "builtin";
-            count++;
-        }
-    }
-
-    return count;
+    return suggest_from_index(NULL, command, AUTOCORRECT_SOURCE_BUILTIN,
+                              MIN_SIMILARITY_SCORE, suggestions,
+                              max_suggestions, case_sensitive);
 #endif
 }
 
 /**
- * Find function suggestions (stub for now)
+ * Find function suggestions
  */
 int autocorrect_suggest_functions(executor_t *executor, const char *command,
                                   correction_t *suggestions,
                                   int max_suggestions, bool case_sensitive) {
-    // This would require access to executor's function table
-    // Currently focusing on builtins and PATH commands
-    (void)executor;
-    (void)command;
-    (void)suggestions;
-    (void)max_suggestions;
-    (void)case_sensitive;
-    return 0;
+    return suggest_from_index(executor, command, AUTOCORRECT_SOURCE_FUNCTION,
+                              MIN_SIMILARITY_SCORE, suggestions,
+                              max_suggestions, case_sensitive);
 }
 
 /**
  * Find PATH command suggestions
  */
-/**
- * @brief Fast pre-filter using Damerau-Levenshtein distance
- *
- * Quickly eliminates candidates that are too different before
- * doing expensive Unicode-aware fuzzy matching. Uses Damerau-Levenshtein
- * which counts transpositions (like gti->git) as 1 edit, not 2.
- *
- * @param s1 First string
- * @param s2 Second string  
- * @param max_dist Maximum distance to consider (returns max_dist+1 if exceeded)
- * @return Edit distance, or max_dist+1 if too different
- */
-static int fast_edit_distance(const char *s1, const char *s2, int max_dist) {
-    size_t len1 = strlen(s1);
-    size_t len2 = strlen(s2);
-
-    /* Quick length check */
-    if (len1 > 32 || len2 > 32) return max_dist + 1;
-    int len_diff = (int)len1 - (int)len2;
-    if (len_diff < 0) len_diff = -len_diff;
-    if (len_diff > max_dist) return max_dist + 1;
-
-    /* Full matrix for Damerau-Levenshtein (need prev-prev row for transpositions) */
-    int matrix[34][34];
-    
-    for (size_t i = 0; i <= len1; i++) matrix[i][0] = (int)i;
-    for (size_t j = 0; j <= len2; j++) matrix[0][j] = (int)j;
-
-    for (size_t i = 1; i <= len1; i++) {
-        int row_min = (int)i;
-
-        for (size_t j = 1; j <= len2; j++) {
-            /* Case-insensitive comparison */
-            char c1 = s1[i-1];
-            char c2 = s2[j-1];
-            if (c1 >= 'A' && c1 <= 'Z') c1 += 32;
-            if (c2 >= 'A' && c2 <= 'Z') c2 += 32;
-
-            int cost = (c1 == c2) ? 0 : 1;
-            int del = matrix[i-1][j] + 1;
-            int ins = matrix[i][j-1] + 1;
-            int sub = matrix[i-1][j-1] + cost;
-
-            int min_val = del < ins ? (del < sub ? del : sub) : (ins < sub ? ins : sub);
-
-            /* Check for transposition (Damerau extension) */
-            if (i > 1 && j > 1) {
-                char prev_c1 = s1[i-2];
-                char prev_c2 = s2[j-2];
-                if (prev_c1 >= 'A' && prev_c1 <= 'Z') prev_c1 += 32;
-                if (prev_c2 >= 'A' && prev_c2 <= 'Z') prev_c2 += 32;
-
-                if (c1 == prev_c2 && c2 == prev_c1) {
-                    int trans = matrix[i-2][j-2] + 1;
-                    if (trans < min_val) min_val = trans;
-                }
-            }
-
-            matrix[i][j] = min_val;
-            if (min_val < row_min) row_min = min_val;
-        }
-
-        /* Early termination if entire row exceeds threshold */
-        if (row_min > max_dist) return max_dist + 1;
-    }
-
-    return matrix[len1][len2];
-}
-
 int autocorrect_suggest_path_commands(const char *command,
                                       correction_t *suggestions,
                                       int max_suggestions,
                                       bool case_sensitive) {
-    char *path = getenv("PATH");
-
-    if (!path || max_suggestions <= 0) {
-        return 0;
-    }
-
-    char *path_copy = strdup(path);
-    if (!path_copy) {
-        return 0;
-    }
-
-    /* Pre-filter threshold: commands within 3 edits are candidates */
-    const int prefilter_max_dist = 3;
-    
-    /* Collect more candidates than requested, then sort and take best.
-     * Use local array to avoid overflowing caller's buffer. */
-    const int max_candidates = 50;
-    correction_t candidates[50];
-    int candidate_count = 0;
-
-    char *dir = strtok(path_copy, ":");
-    while (dir && candidate_count < max_candidates) {
-        DIR *dp = opendir(dir);
-        if (!dp) {
-            dir = strtok(NULL, ":");
-            continue;
-        }
-
-        struct dirent *entry;
-        while ((entry = readdir(dp)) && candidate_count < max_candidates) {
-            if (entry->d_name[0] == '.') {
-                continue; /* Skip hidden files */
-            }
-
-            /* Fast pre-filter: skip if edit distance > threshold */
-            int edit_dist = fast_edit_distance(command, entry->d_name, 
-                                               prefilter_max_dist);
-            if (edit_dist > prefilter_max_dist) {
-                continue;
-            }
-
-            char full_path[1024];
-            snprintf(full_path, sizeof(full_path), "%s/%s", dir, entry->d_name);
-
-            if (is_executable_file(full_path)) {
-                /* Full Unicode-aware scoring for candidates that passed pre-filter */
-                int score = autocorrect_similarity_score(command, entry->d_name,
-                                                         case_sensitive);
-
-                if (score >= MIN_SIMILARITY_SCORE) {
-                    candidates[candidate_count].command = strdup(entry->d_name);
-                    candidates[candidate_count].score = score;
-                    candidates[candidate_count].source = "path";
-                    candidate_count++;
-                }
-            }
-        }
-
-        closedir(dp);
-        dir = strtok(NULL, ":");
-    }
-
-    free(path_copy);
-
-    /* Sort candidates by score (descending) */
-    sort_corrections_by_score(candidates, candidate_count);
-
-    /* Copy top results to caller's buffer */
-    int result_count = candidate_count < max_suggestions ? candidate_count : max_suggestions;
-    for (int i = 0; i < result_count; i++) {
-        suggestions[i] = candidates[i];
-    }
-
-    /* Free unused candidates */
-    for (int i = result_count; i < candidate_count; i++) {
-        free(candidates[i].command);
-    }
-
-    return result_count;
+    return suggest_from_index(NULL, command, AUTOCORRECT_SOURCE_PATH,
+                              MIN_SIMILARITY_SCORE, suggestions,
+                              max_suggestions, case_sensitive);
 }
 
 /**
@@ -701,24 +536,44 @@ int autocorrect_suggest_path_commands(const char *command,
 int autocorrect_suggest_from_history(const char *command,
                                      correction_t *suggestions,
                                      int max_suggestions, bool case_sensitive) {
-    int count = 0;
+    return suggest_from_index(NULL, command, AUTOCORRECT_SOURCE_HISTORY,
+                              MIN_SIMILARITY_SCORE, suggestions,
+                              max_suggestions, case_sensitive);
+}
 
-    // Check learned commands
-    for (int i = 0; i < learned_commands_count && count < max_suggestions;
-         i++) {
-        if (learned_commands[i]) {
-            int score = autocorrect_similarity_score(
-                command, learned_commands[i], case_sensitive);
-            if (score >= MIN_SIMILARITY_SCORE) {
-                suggestions[count].command = strdup(learned_commands[i]);
-                suggestions[count].score = score;
-                suggestions[count].source = "history";
-                count++;
-            }
-        }
+/**
+ * Add a function or alias name to the suggestion index
+ */
+void autocorrect_index_add(const char *name, autocorrect_source_t source) {
+    if (!name) {
+        return;
     }
+    index_add_name(name, (unsigned)source);
+}
 
-    return count;
+/**
+ * Force a rescan of every PATH directory on the next lookup
+ */
+void autocorrect_index_invalidate(void) {
+    for (size_t i = 0; i < ac_index.dir_count; i++) {
+        ac_index.dirs[i].present = false;
+    }
+}
+
+/**
+ * Get suggestion index statistics
+ */
+void autocorrect_index_stats(size_t *names, size_t *path_dirs,
+                             size_t *dir_scans) {
+    if (names) {
+        *names = ac_index.live;
+    }
+    if (path_dirs) {
+        *path_dirs = ac_index.dir_count;
+    }
+    if (dir_scans) {
+        *dir_scans = ac_index.dir_scans;
+    }
 }
 
 /**
@@ -803,25 +658,808 @@ void autocorrect_set_debug(bool enabled) { debug_enabled = enabled; }
  * ============================================================================ */
 
 /**
- * @brief Sort correction suggestions by score in descending order.
+ * @brief Fold an ASCII letter to lower case.
+ *
+ * @param c Character to fold.
+ * @return Lower-case letter, or c unchanged.
+ */
+static inline char fold_ascii(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c + 32) : c;
+}
+
+/**
+ * @brief Case-folded character-set signature of a name.
+ *
+ * Letters and digits get their own bit; other bytes share the remaining
+ * bits. Every edit changes at most one character in each direction, so two
+ * names within distance d differ by at most d bits each way.
+ *
+ * @param name Name to sign.
+ * @return Signature bits.
+ */
+static uint64_t index_signature(const char *name) {
+    uint64_t signature = 0;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++) {
+        unsigned char c = (unsigned char)fold_ascii((char)*p);
+        unsigned bit;
+        if (c >= 'a' && c <= 'z') {
+            bit = c - 'a';
+        } else if (c >= '0' && c <= '9') {
+            bit = 26 + (c - '0');
+        } else {
+            bit = 36 + c % 28;
+        }
+        signature |= (uint64_t)1 << bit;
+    }
+    return signature;
+}
+
+/**
+ * @brief Count the bits set in a signature.
+ *
+ * @param bits Signature bits.
+ * @return Number of bits set.
+ */
+static int signature_bits(uint64_t bits) {
+    int count = 0;
+    while (bits) {
+        bits &= bits - 1;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Bounded case-folded Damerau-Levenshtein distance.
+ *
+ * Uses the optimal string alignment variant so a transposition such as
+ * gti -> git counts as one edit.
+ *
+ * @param a First name (at most AC_MAX_NAME bytes).
+ * @param la Length of a.
+ * @param b Second name (at most AC_MAX_NAME bytes).
+ * @param lb Length of b.
+ * @param max_dist Largest distance of interest.
+ * @return Edit distance, or max_dist + 1 if it is larger.
+ */
+static int index_distance(const char *a, size_t la, const char *b, size_t lb,
+                          int max_dist) {
+    int rows[3][AC_MAX_NAME + 1];
+    int *prev2 = rows[0];
+    int *prev = rows[1];
+    int *cur = rows[2];
+
+    for (size_t j = 0; j <= lb; j++) {
+        prev[j] = (int)j;
+    }
+    for (size_t i = 1; i <= la; i++) {
+        char ca = fold_ascii(a[i - 1]);
+        int row_min = (int)i;
+        cur[0] = (int)i;
+        for (size_t j = 1; j <= lb; j++) {
+            char cb = fold_ascii(b[j - 1]);
+            int best = prev[j - 1] + (ca == cb ? 0 : 1);
+            if (prev[j] + 1 < best) {
+                best = prev[j] + 1;
+            }
+            if (cur[j - 1] + 1 < best) {
+                best = cur[j - 1] + 1;
+            }
+            if (i > 1 && j > 1 && ca == fold_ascii(b[j - 2]) &&
+                fold_ascii(a[i - 2]) == cb && prev2[j - 2] + 1 < best) {
+                best = prev2[j - 2] + 1;
+            }
+            cur[j] = best;
+            if (best < row_min) {
+                row_min = best;
+            }
+        }
+        if (row_min > max_dist) {
+            return max_dist + 1;
+        }
+        int *spare = prev2;
+        prev2 = prev;
+        prev = cur;
+        cur = spare;
+    }
+    return prev[lb] <= max_dist ? prev[lb] : max_dist + 1;
+}
+
+/**
+ * @brief Hash a name for the index lookup table (FNV-1a).
+ *
+ * @param name Name to hash.
+ * @return Hash value.
+ */
+static size_t index_hash(const char *name) {
+    size_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Find the node holding an exact name.
+ *
+ * @param name Name to look up.
+ * @return Node index, or -1 if the name is not indexed.
+ */
+static int index_lookup(const char *name) {
+    if (!name || ac_index.slot_count == 0) {
+        return -1;
+    }
+    size_t mask = ac_index.slot_count - 1;
+    for (size_t i = index_hash(name) & mask;; i = (i + 1) & mask) {
+        int node = ac_index.slots[i];
+        if (node < 0) {
+            return -1;
+        }
+        if (strcmp(ac_index.nodes[node].name, name) == 0) {
+            return node;
+        }
+    }
+}
+
+/**
+ * @brief Record a node in the lookup table, growing it as needed.
+ *
+ * @param node Index of a node not yet in the table.
+ * @return true on success, false on allocation failure.
+ */
+static bool index_slot_insert(int node) {
+    if ((ac_index.count + 1) * 2 > ac_index.slot_count) {
+        size_t slot_count = ac_index.slot_count ? ac_index.slot_count * 2 : 256;
+        int *slots = malloc(slot_count * sizeof(int));
+        if (!slots) {
+            return false;
+        }
+        for (size_t i = 0; i < slot_count; i++) {
+            slots[i] = -1;
+        }
+        free(ac_index.slots);
+        ac_index.slots = slots;
+        ac_index.slot_count = slot_count;
+        for (int i = 0; i < node; i++) {
+            index_slot_insert(i);
+        }
+    }
+
+    size_t mask = ac_index.slot_count - 1;
+    size_t i = index_hash(ac_index.nodes[node].name) & mask;
+    while (ac_index.slots[i] >= 0) {
+        i = (i + 1) & mask;
+    }
+    ac_index.slots[i] = node;
+    return true;
+}
+
+/**
+ * @brief Create a node for a name that is not indexed yet.
+ *
+ * The node starts dead (no sources) and is added to its length bucket.
+ *
+ * @param name Name to store (ownership is taken, freed on failure).
+ * @return Node index, or -1 on allocation failure.
+ */
+static int index_create(char *name) {
+    if (ac_index.count == ac_index.capacity) {
+        size_t capacity = ac_index.capacity ? ac_index.capacity * 2 : 256;
+        ac_node_t *nodes = realloc(ac_index.nodes, capacity * sizeof(*nodes));
+        if (!nodes) {
+            free(name);
+            return -1;
+        }
+        ac_index.nodes = nodes;
+        ac_index.capacity = capacity;
+    }
+
+    int index = (int)ac_index.count;
+    ac_node_t *node = &ac_index.nodes[index];
+    node->name = name;
+    node->sources = 0;
+    node->path_refs = 0;
+    node->path_dir = -1;
+    node->signature = index_signature(name);
+    ac_index.count++;
+
+    if (!index_slot_insert(index)) {
+        ac_index.count--;
+        free(name);
+        return -1;
+    }
+
+    ac_bucket_t *bucket = &ac_index.buckets[strlen(name)];
+    if (bucket->count == bucket->capacity) {
+        size_t capacity = bucket->capacity ? bucket->capacity * 2 : 16;
+        int *nodes = realloc(bucket->nodes, capacity * sizeof(int));
+        if (!nodes) {
+            /* Reachable by name lookup, just never suggested */
+            return index;
+        }
+        bucket->nodes = nodes;
+        bucket->capacity = capacity;
+    }
+    bucket->nodes[bucket->count++] = index;
+
+    return index;
+}
+
+/**
+ * @brief Mark a node as provided by a source.
+ *
+ * @param node Node index.
+ * @param source Source bit to set.
+ */
+static void index_set_source(int node, unsigned source) {
+    if (ac_index.nodes[node].sources == 0) {
+        ac_index.live++;
+    }
+    ac_index.nodes[node].sources |= source;
+}
+
+/**
+ * @brief Add a name from a source, creating its node if needed.
+ *
+ * @param name Name to add.
+ * @param source Source bit.
+ * @return Node index, or -1 if the name cannot be indexed.
+ */
+static int index_add_name(const char *name, unsigned source) {
+    size_t len = strlen(name);
+    if (len == 0 || len > AC_MAX_NAME) {
+        return -1;
+    }
+
+    int node = index_lookup(name);
+    if (node < 0) {
+        char *copy = strdup(name);
+        if (!copy) {
+            return -1;
+        }
+        node = index_create(copy);
+        if (node < 0) {
+            return -1;
+        }
+    }
+    index_set_source(node, source);
+    return node;
+}
+
+/**
+ * @brief Add the builtin table to the index once.
+ */
+static void index_load_builtins(void) {
+#ifndef AUTOCORRECT_STANDALONE_TEST
+    if (ac_index.builtins_loaded) {
+        return;
+    }
+    for (size_t i = 0; i < builtins_count; i++) {
+        index_add_name(builtins[i].name, AUTOCORRECT_SOURCE_BUILTIN);
+    }
+    ac_index.builtins_loaded = true;
+#endif
+}
+
+/**
+ * @brief Drop the names a PATH directory contributed.
+ *
+ * @param dir Directory to release.
+ */
+static void index_release_dir(ac_dir_t *dir) {
+    for (size_t i = 0; i < dir->entry_count; i++) {
+        int index = dir->entries[i];
+        if (index < 0) {
+            continue;
+        }
+        ac_node_t *node = &ac_index.nodes[index];
+        if (node->path_refs > 0 && --node->path_refs == 0) {
+            node->sources &= ~(unsigned)AUTOCORRECT_SOURCE_PATH;
+            if (node->sources == 0) {
+                ac_index.live--;
+            }
+        }
+    }
+    dir->entry_count = 0;
+    dir->present = false;
+}
+
+/**
+ * @brief Read a PATH directory into the index.
  *
- * Uses bubble sort to order corrections from highest to lowest score,
- * ensuring the best matches appear first in the results.
+ * Entries are indexed without checking the execute bit; that check is
+ * made only for the few names a lookup returns.
+ *
+ * @param dir_index Index of the directory in ac_index.dirs.
+ * @param st Result of stat() on the directory.
+ */
+static void index_scan_dir(size_t dir_index, const struct stat *st) {
+    ac_dir_t *dir = &ac_index.dirs[dir_index];
+
+    index_release_dir(dir);
+    dir->present = true;
+    dir->dev = st->st_dev;
+    dir->ino = st->st_ino;
+    dir->mtime = st->st_mtime;
+    /* A change later in the same second would not move the timestamp */
+    dir->racy = st->st_mtime >= time(NULL);
+    ac_index.dir_scans++;
+
+    DIR *dp = opendir(dir->path);
+    if (!dp) {
+        return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dp))) {
+        if (entry->d_name[0] == '.') {
+            continue; /* Skip hidden files */
+        }
+#ifdef DT_DIR
+        if (entry->d_type == DT_DIR) {
+            continue;
+        }
+#endif
+        if (dir->entry_count == dir->entry_capacity) {
+            size_t capacity = dir->entry_capacity ? dir->entry_capacity * 2 : 64;
+            int *entries = realloc(dir->entries, capacity * sizeof(int));
+            if (!entries) {
+                break;
+            }
+            dir->entries = entries;
+            dir->entry_capacity = capacity;
+        }
+
+        int node = index_add_name(entry->d_name, AUTOCORRECT_SOURCE_PATH);
+        if (node < 0) {
+            continue;
+        }
+        ac_index.nodes[node].path_refs++;
+        ac_index.nodes[node].path_dir = (int)dir_index;
+        dir->entries[dir->entry_count++] = node;
+    }
+
+    closedir(dp);
+}
+
+/**
+ * @brief Rebuild the directory list for a new PATH value.
+ *
+ * Directories that stay in PATH keep their scanned contents.
+ *
+ * @param path New PATH value.
+ */
+static void index_set_path(const char *path) {
+    char *path_copy = strdup(path);
+    if (!path_copy) {
+        return;
+    }
+
+    size_t max_dirs = 1;
+    for (const char *p = path; *p; p++) {
+        if (*p == ':') {
+            max_dirs++;
+        }
+    }
+    ac_dir_t *dirs = calloc(max_dirs, sizeof(ac_dir_t));
+    if (!dirs) {
+        free(path_copy);
+        return;
+    }
+
+    size_t dir_count = 0;
+    char *saveptr = NULL;
+    for (char *dir = strtok_r(path_copy, ":", &saveptr); dir;
+         dir = strtok_r(NULL, ":", &saveptr)) {
+        bool duplicate = false;
+        for (size_t i = 0; i < dir_count; i++) {
+            if (strcmp(dirs[i].path, dir) == 0) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) {
+            continue;
+        }
+
+        /* Reuse the old entry for a directory that stays in PATH */
+        bool reused = false;
+        for (size_t i = 0; i < ac_index.dir_count; i++) {
+            if (ac_index.dirs[i].path &&
+                strcmp(ac_index.dirs[i].path, dir) == 0) {
+                dirs[dir_count] = ac_index.dirs[i];
+                ac_index.dirs[i].path = NULL;
+                ac_index.dirs[i].entries = NULL;
+                reused = true;
+                break;
+            }
+        }
+        if (!reused) {
+            dirs[dir_count].path = strdup(dir);
+            if (!dirs[dir_count].path) {
+                continue;
+            }
+        }
+        dir_count++;
+    }
+    free(path_copy);
+
+    for (size_t i = 0; i < ac_index.dir_count; i++) {
+        ac_dir_t *old = &ac_index.dirs[i];
+        if (old->path) {
+            index_release_dir(old);
+            free(old->path);
+        }
+        free(old->entries);
+    }
+    free(ac_index.dirs);
+    ac_index.dirs = dirs;
+    ac_index.dir_count = dir_count;
+
+    free(ac_index.path_value);
+    ac_index.path_value = strdup(path);
+}
+
+/**
+ * @brief Rebuild the index without dead nodes once they outnumber live ones.
  *
- * @param corrections Array of correction suggestions to sort.
- * @param count Number of corrections in the array.
- */
-static void sort_corrections_by_score(correction_t *corrections, int count) {
-    // Simple bubble sort by score (descending)
-    for (int i = 0; i < count - 1; i++) {
-        for (int j = 0; j < count - i - 1; j++) {
-            if (corrections[j].score < corrections[j + 1].score) {
-                correction_t temp = corrections[j];
-                corrections[j] = corrections[j + 1];
-                corrections[j + 1] = temp;
+ * Node indices change, so directory entry lists are remapped.
+ */
+static void index_maybe_compact(void) {
+    if (ac_index.count < AC_COMPACT_MIN ||
+        ac_index.count - ac_index.live <= ac_index.live) {
+        return;
+    }
+
+    ac_node_t *old = ac_index.nodes;
+    size_t old_count = ac_index.count;
+    int *remap = malloc(old_count * sizeof(int));
+    if (!remap) {
+        return;
+    }
+
+    ac_index.nodes = NULL;
+    ac_index.count = 0;
+    ac_index.capacity = 0;
+    ac_index.live = 0;
+    free(ac_index.slots);
+    ac_index.slots = NULL;
+    ac_index.slot_count = 0;
+    for (size_t i = 0; i <= AC_MAX_NAME; i++) {
+        ac_index.buckets[i].count = 0;
+    }
+
+    for (size_t i = 0; i < old_count; i++) {
+        remap[i] = -1;
+        if (old[i].sources == 0) {
+            free(old[i].name);
+            continue;
+        }
+        int node = index_create(old[i].name);
+        if (node < 0) {
+            continue;
+        }
+        index_set_source(node, old[i].sources);
+        ac_index.nodes[node].path_refs = old[i].path_refs;
+        ac_index.nodes[node].path_dir = old[i].path_dir;
+        remap[i] = node;
+    }
+
+    for (size_t i = 0; i < ac_index.dir_count; i++) {
+        ac_dir_t *dir = &ac_index.dirs[i];
+        for (size_t j = 0; j < dir->entry_count; j++) {
+            if (dir->entries[j] >= 0) {
+                dir->entries[j] = remap[dir->entries[j]];
             }
         }
     }
+
+    free(remap);
+    free(old);
+}
+
+/**
+ * @brief Bring the PATH part of the index up to date.
+ *
+ * Costs one stat() per PATH directory when nothing has changed.
+ */
+static void index_sync_path(void) {
+    const char *path = getenv("PATH");
+    if (!path) {
+        path = "";
+    }
+    if (!ac_index.path_value || strcmp(path, ac_index.path_value) != 0) {
+        index_set_path(path);
+    }
+
+    for (size_t i = 0; i < ac_index.dir_count; i++) {
+        ac_dir_t *dir = &ac_index.dirs[i];
+        struct stat st;
+        if (stat(dir->path, &st) != 0 || !S_ISDIR(st.st_mode)) {
+            if (dir->present || dir->entry_count > 0) {
+                index_release_dir(dir);
+            }
+            continue;
+        }
+        if (!dir->present || dir->racy || st.st_mtime != dir->mtime ||
+            st.st_ino != dir->ino || st.st_dev != dir->dev) {
+            index_scan_dir(i, &st);
+        }
+    }
+
+    index_maybe_compact();
+}
+
+/**
+ * @brief Check that a PATH name is still an executable file.
+ *
+ * Tries the directory that last provided the name first, then the rest of
+ * PATH.
+ *
+ * @param node Node index.
+ * @return true if an executable with this name is found.
+ */
+static bool index_path_executable(int node) {
+    const char *name = ac_index.nodes[node].name;
+    int hint = ac_index.nodes[node].path_dir;
+    char full_path[1024];
+
+    if (hint >= 0 && (size_t)hint < ac_index.dir_count) {
+        snprintf(full_path, sizeof(full_path), "%s/%s",
+                 ac_index.dirs[hint].path, name);
+        if (is_executable_file(full_path)) {
+            return true;
+        }
+    }
+    for (size_t i = 0; i < ac_index.dir_count; i++) {
+        if ((int)i == hint || !ac_index.dirs[i].present) {
+            continue;
+        }
+        snprintf(full_path, sizeof(full_path), "%s/%s", ac_index.dirs[i].path,
+                 name);
+        if (is_executable_file(full_path)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Check whether a shell function is defined.
+ *
+ * @param executor Executor whose function table is searched (may be NULL).
+ * @param name Function name.
+ * @return true if the function is defined.
+ */
+static bool function_defined(executor_t *executor, const char *name) {
+    if (!executor) {
+        return false;
+    }
+    for (function_def_t *func = executor->functions; func; func = func->next) {
+        if (strcmp(func->name, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Order matches by distance, then name.
+ */
+static int compare_matches(const void *a, const void *b) {
+    const ac_match_t *ma = a;
+    const ac_match_t *mb = b;
+    if (ma->distance != mb->distance) {
+        return ma->distance - mb->distance;
+    }
+    return strcmp(ac_index.nodes[ma->node].name,
+                  ac_index.nodes[mb->node].name);
+}
+
+/**
+ * @brief Collect every live name within a radius of the query.
+ *
+ * @param query Query name (at most AC_MAX_NAME bytes).
+ * @param radius Maximum case-folded edit distance.
+ * @param count Output: number of matches.
+ * @return Matches sorted by distance (caller frees), or NULL if none.
+ */
+static ac_match_t *index_search(const char *query, int radius, size_t *count) {
+    *count = 0;
+
+    size_t len = strlen(query);
+    uint64_t signature = index_signature(query);
+    size_t min_len = len > (size_t)radius ? len - (size_t)radius : 1;
+    size_t max_len = len + (size_t)radius;
+    if (max_len > AC_MAX_NAME) {
+        max_len = AC_MAX_NAME;
+    }
+
+    ac_match_t *matches = NULL;
+    size_t capacity = 0;
+    for (size_t l = min_len; l <= max_len; l++) {
+        const ac_bucket_t *bucket = &ac_index.buckets[l];
+        for (size_t i = 0; i < bucket->count; i++) {
+            const ac_node_t *node = &ac_index.nodes[bucket->nodes[i]];
+            if (node->sources == 0 ||
+                signature_bits(signature & ~node->signature) > radius ||
+                signature_bits(node->signature & ~signature) > radius) {
+                continue;
+            }
+            int distance = index_distance(query, len, node->name, l, radius);
+            if (distance > radius) {
+                continue;
+            }
+
+            if (*count == capacity) {
+                capacity = capacity ? capacity * 2 : 32;
+                ac_match_t *grown = realloc(matches, capacity * sizeof(*grown));
+                if (!grown) {
+                    goto done;
+                }
+                matches = grown;
+            }
+            matches[*count].node = bucket->nodes[i];
+            matches[*count].distance = distance;
+            (*count)++;
+        }
+    }
+
+done:
+    if (*count > 1) {
+        qsort(matches, *count, sizeof(*matches), compare_matches);
+    }
+    return matches;
+}
+
+/**
+ * @brief Look up suggestions from the index.
+ *
+ * Names within a length-dependent edit radius are checked against their
+ * live sources (function table, aliases, execute bit) nearest first, and
+ * the nearest AC_MAX_SCORED are scored; the best max_suggestions are kept
+ * in descending score order.
+ *
+ * @param executor Executor for the function table (may be NULL).
+ * @param command Misspelled command.
+ * @param mask Sources to consider.
+ * @param min_score Minimum similarity score.
+ * @param suggestions Output array.
+ * @param max_suggestions Capacity of the output array.
+ * @param case_sensitive Case-sensitive scoring.
+ * @return Number of suggestions stored.
+ */
+static int suggest_from_index(executor_t *executor, const char *command,
+                              unsigned mask, int min_score,
+                              correction_t *suggestions, int max_suggestions,
+                              bool case_sensitive) {
+    if (!command || !suggestions || max_suggestions <= 0) {
+        return 0;
+    }
+    size_t len = strlen(command);
+    if (len == 0 || len > AC_MAX_NAME) {
+        return 0;
+    }
+
+    if (mask & AUTOCORRECT_SOURCE_BUILTIN) {
+        index_load_builtins();
+    }
+    if (mask & AUTOCORRECT_SOURCE_PATH) {
+        index_sync_path();
+    }
+
+    /* Short names get a tighter radius so "l" does not match everything;
+     * widen one edit at a time until there are enough candidates to score */
+    int max_radius = len <= 1 ? 1 : (len <= 3 ? 2 : 3);
+    size_t match_count = 0;
+    ac_match_t *matches = NULL;
+    for (int radius = 1; radius <= max_radius; radius++) {
+        free(matches);
+        matches = index_search(command, radius, &match_count);
+        if (match_count >= AC_MAX_SCORED) {
+            break;
+        }
+    }
+
+    static const struct {
+        unsigned source;
+        const char *label;
+    } labels[] = {
+        {AUTOCORRECT_SOURCE_BUILTIN, "builtin"},
+        {AUTOCORRECT_SOURCE_FUNCTION, "function"},
+        {AUTOCORRECT_SOURCE_ALIAS, "alias"},
+        {AUTOCORRECT_SOURCE_PATH, "path"},
+        {AUTOCORRECT_SOURCE_HISTORY, "history"},
+    };
+
+    int count = 0;
+    int scored = 0;
+    for (size_t i = 0; i < match_count && scored < AC_MAX_SCORED; i++) {
+        const char *name = ac_index.nodes[matches[i].node].name;
+        unsigned sources = ac_index.nodes[matches[i].node].sources & mask;
+        if (sources == 0 || strcmp(name, command) == 0) {
+            continue;
+        }
+
+        /* Functions and aliases may have been removed since indexing */
+        if ((sources & AUTOCORRECT_SOURCE_FUNCTION) &&
+            !function_defined(executor, name)) {
+            sources &= ~(unsigned)AUTOCORRECT_SOURCE_FUNCTION;
+        }
+        if ((sources & AUTOCORRECT_SOURCE_ALIAS) && !lookup_alias(name)) {
+            sources &= ~(unsigned)AUTOCORRECT_SOURCE_ALIAS;
+        }
+        if ((sources & AUTOCORRECT_SOURCE_PATH) &&
+            !index_path_executable(matches[i].node)) {
+            sources &= ~(unsigned)AUTOCORRECT_SOURCE_PATH;
+        }
+        if (sources == 0) {
+            continue;
+        }
+
+        int score = autocorrect_similarity_score(command, name, case_sensitive);
+        scored++;
+        if (score < min_score) {
+            continue;
+        }
+        if (count == max_suggestions && score <= suggestions[count - 1].score) {
+            continue;
+        }
+
+        /* Insert after equal scores so closer matches keep precedence */
+        int pos = count < max_suggestions ? count : max_suggestions - 1;
+        if (count == max_suggestions) {
+            free(suggestions[pos].command);
+        } else {
+            count++;
+        }
+        while (pos > 0 && suggestions[pos - 1].score < score) {
+            suggestions[pos] = suggestions[pos - 1];
+            pos--;
+        }
+
+        const char *label = "path";
+        for (size_t j = 0; j < sizeof(labels) / sizeof(labels[0]); j++) {
+            if (sources & labels[j].source) {
+                label = labels[j].label;
+                break;
+            }
+        }
+        suggestions[pos].command = strdup(name);
+        suggestions[pos].score = score;
+        suggestions[pos].source = label;
+        if (!suggestions[pos].command) {
+            /* Drop the slot rather than return a NULL command */
+            for (int j = pos; j < count - 1; j++) {
+                suggestions[j] = suggestions[j + 1];
+            }
+            count--;
+        }
+    }
+
+    free(matches);
+    return count;
+}
+
+/**
+ * @brief Free the whole suggestion index.
+ */
+static void index_free(void) {
+    for (size_t i = 0; i < ac_index.count; i++) {
+        free(ac_index.nodes[i].name);
+    }
+    for (size_t i = 0; i < ac_index.dir_count; i++) {
+        free(ac_index.dirs[i].path);
+        free(ac_index.dirs[i].entries);
+    }
+    free(ac_index.nodes);
+    free(ac_index.slots);
+    free(ac_index.dirs);
+    for (size_t i = 0; i <= AC_MAX_NAME; i++) {
+        free(ac_index.buckets[i].nodes);
+    }
+    free(ac_index.path_value);
+    memset(&ac_index, 0, sizeof(ac_index));
 }
 
 /**
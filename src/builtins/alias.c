@@ -11,6 +11,7 @@
 
 #include "alias.h"
 
+#include "autocorrect.h"
 #include "builtins.h"
 #include "errors.h"
 #include "ht.h"
@@ -106,6 +107,7 @@ bool set_alias(const char *key, const char *val) {
     }
 
     ht_strstr_insert(aliases, key, val);
+    autocorrect_index_add(key, AUTOCORRECT_SOURCE_ALIAS);
     char *alias = lookup_alias(key);
     return (alias != NULL);
 }
@@ -14,10 +14,13 @@
 
 #include "alias.h"
 #include "arithmetic.h"
+#include "autocorrect.h"
 #include "compat.h"
+#include "dirindex.h"
 #include "dirstack.h"
 #include "config.h"
 #include "config_registry.h"
+#include "coreutils.h"
 #include "debug.h"
 #include "shell_error.h"
 #include "shell_mode.h"
@@ -28,6 +31,7 @@
 #include "executor.h"
 #include "fixer.h"
 #include "ht.h"
+#include "init.h"
 #include "input.h"
 #include "lle/adaptive_terminal_integration.h"
 #include "lle/completion/custom_source.h"
@@ -45,8 +49,14 @@
 #include "lle/prompt/theme_loader.h"
 #include "lush.h"
 #include "lush_memory_pool.h"
+#include "lush_plugin.h"
+#include "memo.h"
+#include "parse_cache.h"
 #include "posix_history.h"
 #include "signals.h"
+#include "spawn_cost.h"
+#include "startup_cache.h"
+#include "startup_profile.h"
 #include "symtable.h"
 
 #include <dirent.h>
@@ -195,6 +205,9 @@ builtin builtins[] = {
     {"pushd", "push directory onto stack", bin_pushd},
     {"popd", "pop directory from stack", bin_popd},
     {"dirs", "display directory stack", bin_dirs},
+    {"z", "jump to a frecently visited directory", bin_z},
+    {"enable", "enable/disable loadable builtins", bin_enable},
+    {"memo", "cache the output of a slow command", bin_memo},
     {"mapfile", "read lines from stdin into array", bin_mapfile},
     {"readarray", "read lines from stdin into array", bin_mapfile},
     {"env", "run command with modified environment", bin_env},
@@ -267,6 +280,14 @@ int bin_help(int argc __attribute__((unused)),
         fprintf(stderr, "\t%-10s%-40s\n", builtins[i].name, builtins[i].doc);
     }
 
+    bool enabled;
+    const builtin *lb;
+    for (size_t i = 0; (lb = builtin_loadable_at(i, &enabled)) != NULL; i++) {
+        if (enabled) {
+            fprintf(stderr, "\t%-10s%-40s\n", lb->name, lb->doc);
+        }
+    }
+
     return 0;
 }
 
@@ -339,6 +360,21 @@ static char *canonicalize_logical_path(const char *path) {
     return result;
 }
 
+/**
+ * @brief Record a directory change in the frecency index
+ *
+ * Only interactive shells record visits, so scripts that cd around do not
+ * skew the ranking used by z and directory completion.
+ *
+ * @param dir New working directory (may be NULL)
+ */
+static void record_directory_visit(const char *dir) {
+    if (dir && shell_mode_allows(FEATURE_DIR_FRECENCY) &&
+        is_interactive_shell()) {
+        dirindex_add(dir);
+    }
+}
+
 /**
  * @brief Change the current working directory
  *
@@ -542,6 +578,8 @@ cd_success:
      * etc.) that the working directory has changed. previous_dir holds the old
      * dir.
      */
+    record_directory_visit(symtable_get_global("PWD"));
+
     lle_fire_directory_changed(previous_dir, NULL);
 
     return 0;
@@ -622,7 +660,7 @@ int bin_history(int argc, char **argv) {
 
     if (output) {
         printf("%s", output);
-        free(output);
+        lle_pool_free(output);
     }
 
     return (result == LLE_SUCCESS) ? 0 : 1;
@@ -1546,15 +1584,27 @@ int bin_source(int argc, char **argv) {
     executor->source_depth++;
     executor->source_return = false;
 
+    // Save the caller's script context to restore afterwards
+    const char *caller_file = executor_get_current_script_file(executor);
+    char *saved_script_file = caller_file ? strdup(caller_file) : NULL;
+    int saved_script_line = executor->script_line_base;
+
     // Set script execution context for debugging
     executor_set_script_context(executor, argv[1], 1);
+    startup_file_begin(argv[1]);
 
     char *complete_input;
     int result = 0;
-    int construct_number = 1;
+    int line_number = 1;
+
+    // Files sourced while the shell starts (profile.d scripts) go through
+    // the startup cache; later sources reuse the parse of any construct
+    // seen before from the parse cache
+    startup_script_t *script = startup_script_open(
+        startup_profile_finished() ? NULL : argv[1], file);
 
     // Read complete multi-line constructs instead of line by line
-    while ((complete_input = get_input_complete(file)) != NULL) {
+    while ((complete_input = startup_script_read(script)) != NULL) {
         // Check if return was called in sourced script
         if (executor->source_return) {
             free(complete_input);
@@ -1566,16 +1616,16 @@ int bin_source(int argc, char **argv) {
         while (*trimmed == ' ' || *trimmed == '\t' || *trimmed == '\n')
             trimmed++;
         if (*trimmed == '\0') {
+            line_number += get_input_line_count(complete_input);
             free(complete_input);
-            construct_number++;
             continue;
         }
 
         // Update script context for debugging
-        executor_set_script_context(executor, argv[1], construct_number);
+        executor_set_script_context(executor, argv[1], line_number);
 
         // Parse and execute the complete construct
-        int construct_result = parse_and_execute(complete_input);
+        int construct_result = startup_script_execute(script, complete_input);
         
         // Check for return from sourced script (exit code 200+)
         if (construct_result >= 200 && construct_result <= 455) {
@@ -1589,18 +1639,21 @@ int bin_source(int argc, char **argv) {
             result = construct_result;
         }
 
+        line_number += get_input_line_count(complete_input);
         free(complete_input);
-        construct_number++;
     }
+    startup_script_close(script);
 
     // Clear source tracking and restore parent's source_return state
     executor->source_depth--;
     executor->source_return = saved_source_return;
 
-    // Clear script execution context
-    executor_clear_script_context(executor);
+    // Restore the caller's script execution context
+    executor_set_script_context(executor, saved_script_file, saved_script_line);
+    free(saved_script_file);
 
     fclose(file);
+    startup_file_end();
     return result;
 }
 
@@ -2331,8 +2384,8 @@ int bin_eval(int argc, char **argv) {
         strcat(command, argv[i]);
     }
 
-    // Execute the command string
-    int result = parse_and_execute(command);
+    // Execute the command string; repeated strings reuse their parse
+    int result = parse_and_execute_cached(command);
 
     free(command);
     return result;
@@ -2346,14 +2399,119 @@ int bin_eval(int argc, char **argv) {
  * @param name The command name to check
  * @return true if name is a builtin, false otherwise
  */
-bool is_builtin(const char *name) {
+bool is_builtin(const char *name) { return builtin_lookup(name) != NULL; }
+
+/* ============================================================================
+ * Loadable Builtins
+ * ============================================================================ */
+
+/**
+ * @brief A builtin registered at runtime
+ */
+typedef struct {
+    builtin entry; /**< Name and doc are owned copies */
+    bool enabled;  /**< Whether lookups find it */
+} loadable_builtin_t;
+
+/** Registered loadable builtins, in registration order */
+static loadable_builtin_t *loadables = NULL;
+static size_t loadable_count = 0;
+static size_t loadable_capacity = 0;
+
+static loadable_builtin_t *find_loadable(const char *name) {
+    for (size_t i = 0; i < loadable_count; i++) {
+        if (strcmp(name, loadables[i].entry.name) == 0) {
+            return &loadables[i];
+        }
+    }
+    return NULL;
+}
+
+static const builtin *find_core_builtin(const char *name) {
     for (size_t i = 0; i < builtins_count; i++) {
         if (strcmp(name, builtins[i].name) == 0) {
-            return true;
+            return &builtins[i];
+        }
+    }
+    return NULL;
+}
+
+const builtin *builtin_lookup(const char *name) {
+    if (!name) {
+        return NULL;
+    }
+    const builtin *core = find_core_builtin(name);
+    if (core) {
+        return core;
+    }
+    loadable_builtin_t *lb = find_loadable(name);
+    return lb && lb->enabled ? &lb->entry : NULL;
+}
+
+int builtin_register(const char *name, const char *doc,
+                     int (*func)(int argc, char **argv)) {
+    if (!name || !*name || !func || find_core_builtin(name) ||
+        find_loadable(name)) {
+        return -1;
+    }
+
+    if (loadable_count == loadable_capacity) {
+        size_t capacity = loadable_capacity ? loadable_capacity * 2 : 16;
+        loadable_builtin_t *grown =
+            realloc(loadables, capacity * sizeof(*grown));
+        if (!grown) {
+            return -1;
         }
+        loadables = grown;
+        loadable_capacity = capacity;
+    }
+
+    char *name_copy = strdup(name);
+    char *doc_copy = strdup(doc ? doc : "");
+    if (!name_copy || !doc_copy) {
+        free(name_copy);
+        free(doc_copy);
+        return -1;
+    }
+
+    loadable_builtin_t *lb = &loadables[loadable_count++];
+    lb->entry.name = name_copy;
+    lb->entry.doc = doc_copy;
+    lb->entry.func = func;
+    lb->enabled = true;
+    return 0;
+}
+
+int builtin_unregister(const char *name) {
+    loadable_builtin_t *lb = name ? find_loadable(name) : NULL;
+    if (!lb) {
+        return -1;
+    }
+    free((char *)lb->entry.name);
+    free((char *)lb->entry.doc);
+    size_t index = (size_t)(lb - loadables);
+    memmove(lb, lb + 1, (loadable_count - index - 1) * sizeof(*lb));
+    loadable_count--;
+    return 0;
+}
+
+int builtin_set_enabled(const char *name, bool enabled) {
+    loadable_builtin_t *lb = name ? find_loadable(name) : NULL;
+    if (!lb) {
+        return -1;
     }
+    lb->enabled = enabled;
+    return 0;
+}
 
-    return false;
+const builtin *builtin_loadable_at(size_t index, bool *enabled) {
+    if (index >= loadable_count) {
+        return NULL;
+    }
+    if (enabled) {
+        *enabled = loadables[index].enabled;
+    }
+    return &loadables[index].entry;
 }
 
 /**
@@ -3229,7 +3387,8 @@ int bin_wait(int argc, char **argv) {
         while (job) {
             if (job->state == JOB_RUNNING) {
                 int status;
-                pid_t result = waitpid(-job->pgid, &status, 0);
+                pid_t result = executor_reap_child(current_executor,
+                                                   -job->pgid, &status, 0);
 
                 if (result > 0) {
                     if (WIFEXITED(status)) {
@@ -3291,7 +3450,8 @@ int bin_wait(int argc, char **argv) {
 
             if (job->state == JOB_RUNNING) {
                 int status;
-                pid_t result = waitpid(-job->pgid, &status, 0);
+                pid_t result = executor_reap_child(current_executor,
+                                                   -job->pgid, &status, 0);
 
                 if (result > 0) {
                     if (WIFEXITED(status)) {
@@ -3311,7 +3471,8 @@ int bin_wait(int argc, char **argv) {
         } else {
             // Wait for specific PID
             int status;
-            pid_t result = waitpid(job_or_pid, &status, 0);
+            pid_t result =
+                executor_reap_child(current_executor, job_or_pid, &status, 0);
 
             if (result == -1) {
                 if (errno == ECHILD) {
@@ -5101,6 +5262,7 @@ int bin_hash(int argc, char **argv) {
             ht_strstr_destroy(command_hash);
             command_hash = ht_strstr_create(HT_STR_CASECMP | HT_SEED_RANDOM);
         }
+        autocorrect_index_invalidate();
         return 0;
     }
 
@@ -5516,6 +5678,36 @@ int bin_debug(int argc __attribute__((unused)), char **argv) {
         return 0;
     }
 
+    if (strcmp(subcmd, "parse-cache") == 0) {
+        if (argc_real >= 3 && strcmp(argv[2], "clear") == 0) {
+            size_t dropped = parse_cache_clear();
+            parse_cache_reset_stats();
+            printf("Parse cache cleared (%zu entries dropped)\n", dropped);
+            return 0;
+        }
+        if (argc_real >= 3) {
+            fprintf(stderr, "debug: Invalid parse-cache option '%s'\n",
+                    argv[2]);
+            return 1;
+        }
+
+        parse_cache_stats_t stats;
+        parse_cache_get_stats(&stats);
+        uint64_t lookups = stats.hits + stats.misses;
+        printf("Parse cache:\n");
+        printf("  Hits: %llu\n", (unsigned long long)stats.hits);
+        printf("  Misses: %llu\n", (unsigned long long)stats.misses);
+        printf("  Hit rate: %.1f%%\n",
+               lookups ? 100.0 * (double)stats.hits / (double)lookups : 0.0);
+        printf("  Parse failures: %llu\n",
+               (unsigned long long)stats.failures);
+        printf("  Evictions: %llu\n", (unsigned long long)stats.evictions);
+        printf("  Entries: %zu\n", stats.entries);
+        printf("  Memory: %zu of %zu bytes\n", stats.bytes,
+               parse_cache_get_limit());
+        return 0;
+    }
+
     if (strcmp(subcmd, "help") == 0) {
         printf("Debug command usage:\n");
         printf("  debug                    - Show debug status\n");
@@ -5540,6 +5732,8 @@ int bin_debug(int argc __attribute__((unused)), char **argv) {
         printf("  debug analyze <script>   - Analyze script for issues\n");
         printf("  debug functions          - List all defined functions\n");
         printf("  debug function <name>    - Show function definition\n");
+        printf("  debug parse-cache [clear] - Show or clear parse cache "
+               "statistics\n");
         printf("  debug help               - Show this help\n");
         printf("\nDebug levels:\n");
         printf("  0 - None (disabled)\n");
@@ -7601,6 +7795,7 @@ int bin_pushd(int argc, char **argv) {
         symtable_set_global("OLDPWD", cwd);
         char *new_cwd = getcwd(NULL, 0);
         if (new_cwd) {
+            record_directory_visit(new_cwd);
             symtable_set_global("PWD", new_cwd);
             free(new_cwd);
         }
@@ -7655,6 +7850,7 @@ int bin_pushd(int argc, char **argv) {
             symtable_set_global("OLDPWD", cwd);
             char *new_cwd = getcwd(NULL, 0);
             if (new_cwd) {
+                record_directory_visit(new_cwd);
                 symtable_set_global("PWD", new_cwd);
                 free(new_cwd);
             }
@@ -7677,6 +7873,7 @@ int bin_pushd(int argc, char **argv) {
     symtable_set_global("OLDPWD", cwd);
     char *new_cwd = getcwd(NULL, 0);
     if (new_cwd) {
+        record_directory_visit(new_cwd);
         symtable_set_global("PWD", new_cwd);
         free(new_cwd);
     }
@@ -7730,6 +7927,7 @@ int bin_popd(int argc, char **argv) {
         
         char *new_cwd = getcwd(NULL, 0);
         if (new_cwd) {
+            record_directory_visit(new_cwd);
             symtable_set_global("PWD", new_cwd);
             free(new_cwd);
         }
@@ -7820,6 +8018,562 @@ int bin_dirs(int argc, char **argv) {
     return 0;
 }
 
+/**
+ * @brief Jump to a frecently visited directory
+ *
+ * Usage:
+ *   z                - Change to HOME
+ *   z dir            - Change to dir if it exists (or - for OLDPWD)
+ *   z frag...        - Change to the best match for the fragments
+ *   z -l [frag...]   - List matches with their scores, best last
+ *   z -e frag...     - Print the best match instead of changing to it
+ *   z -c frag...     - Only match subdirectories of the current directory
+ *   z -x [dir]       - Remove dir (default: current directory) from the index
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @return 0 on success, 1 if nothing matches, 2 on usage error
+ */
+int bin_z(int argc, char **argv) {
+    bool list = false;
+    bool echo_only = false;
+    bool within_cwd = false;
+    bool remove_dir = false;
+
+    int i = 1;
+    for (; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--") == 0) {
+            i++;
+            break;
+        }
+        if (arg[0] != '-' || arg[1] == '\0') {
+            break;
+        }
+        for (const char *p = arg + 1; *p; p++) {
+            switch (*p) {
+            case 'l':
+                list = true;
+                break;
+            case 'e':
+                echo_only = true;
+                break;
+            case 'c':
+                within_cwd = true;
+                break;
+            case 'x':
+                remove_dir = true;
+                break;
+            default:
+                fprintf(stderr, "z: -%c: invalid option\n", *p);
+                fprintf(stderr, "usage: z [-lecx] [fragment ...]\n");
+                return 2;
+            }
+        }
+    }
+
+    const char *const *fragments = (const char *const *)&argv[i];
+    size_t count = (size_t)(argc - i);
+    char *cwd = getcwd(NULL, 0);
+    const char *within = within_cwd ? cwd : NULL;
+
+    if (remove_dir) {
+        char *target = count > 0 ? realpath(fragments[0], NULL) : NULL;
+        const char *path = target ? target : (count > 0 ? fragments[0] : cwd);
+        int result = 0;
+        if (!path || dirindex_remove(path) < 0) {
+            fprintf(stderr, "z: %s: not in the directory index\n",
+                    path ? path : ".");
+            result = 1;
+        }
+        free(target);
+        free(cwd);
+        return result;
+    }
+
+    if (list) {
+        dirindex_match_t *matches;
+        size_t n = dirindex_query(fragments, count, within, NULL, &matches);
+        for (size_t k = n; k-- > 0;) {
+            printf("%-10.1f %s\n", matches[k].score, matches[k].path);
+        }
+        free(matches);
+        free(cwd);
+        return n > 0 ? 0 : 1;
+    }
+
+    if (!echo_only && !within_cwd) {
+        struct stat st;
+        if (count == 0) {
+            free(cwd);
+            char *cd_argv[] = {"cd", NULL};
+            return bin_cd(1, cd_argv);
+        }
+        if (count == 1 && (strcmp(fragments[0], "-") == 0 ||
+                           (stat(fragments[0], &st) == 0 &&
+                            S_ISDIR(st.st_mode)))) {
+            free(cwd);
+            char *cd_argv[] = {"cd", (char *)fragments[0], NULL};
+            return bin_cd(2, cd_argv);
+        }
+    }
+
+    char *best = dirindex_best(fragments, count, within, cwd);
+    free(cwd);
+    if (!best) {
+        fprintf(stderr, "z: no match for '");
+        for (size_t k = 0; k < count; k++) {
+            fprintf(stderr, "%s%s", k > 0 ? " " : "", fragments[k]);
+        }
+        fprintf(stderr, "'\n");
+        return 1;
+    }
+
+    int result = 0;
+    if (echo_only) {
+        printf("%s\n", best);
+    } else {
+        char *cd_argv[] = {"cd", "--", best, NULL};
+        result = bin_cd(3, cd_argv);
+    }
+    free(best);
+    return result;
+}
+
+/* ============================================================================
+ * Memo Builtin
+ * ============================================================================ */
+
+/**
+ * @brief Parse a memo TTL such as 30, 1.5s, 10m, 2h or 1d
+ *
+ * @param text TTL text
+ * @param seconds Output: TTL in seconds
+ * @return true if the text is a valid non-negative duration
+ */
+static bool parse_memo_ttl(const char *text, double *seconds) {
+    char *end;
+    errno = 0;
+    double value = strtod(text, &end);
+    if (end == text || errno != 0 || value < 0) {
+        return false;
+    }
+    double scale = 1.0;
+    if (*end) {
+        switch (*end) {
+        case 's':
+            break;
+        case 'm':
+            scale = 60.0;
+            break;
+        case 'h':
+            scale = 3600.0;
+            break;
+        case 'd':
+            scale = 86400.0;
+            break;
+        default:
+            return false;
+        }
+        if (end[1] != '\0') {
+            return false;
+        }
+    }
+    *seconds = value * scale;
+    return true;
+}
+
+/* Modules that ship with the shell and load without a shared object */
+static const lush_plugin_def_t *const shipped_modules[] = {
+    &lush_coreutils_plugin,
+};
+
+static const lush_plugin_def_t *find_shipped_module(const char *name) {
+    for (size_t i = 0; i < sizeof(shipped_modules) / sizeof(*shipped_modules);
+         i++) {
+        if (strcmp(shipped_modules[i]->name, name) == 0) {
+            return shipped_modules[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Load a module of loadable builtins
+ *
+ * Shipped modules are loaded by name, anything containing a slash as a
+ * shared object path, and other names are searched for in the plugin
+ * path. If names are given, the module's other builtins start disabled.
+ */
+static int enable_load_module(const char *module, char **names, int count) {
+    lush_plugin_manager_t *manager = lush_plugin_shell_manager();
+    if (!manager) {
+        fprintf(stderr, "enable: plugin support is unavailable\n");
+        return 1;
+    }
+
+    lush_plugin_t *plugin = NULL;
+    lush_plugin_result_t result;
+    const lush_plugin_def_t *shipped = find_shipped_module(module);
+    if (shipped) {
+        result = lush_plugin_manager_load_static(manager, shipped, &plugin);
+    } else if (strchr(module, '/')) {
+        result = lush_plugin_manager_load(manager, module, &plugin);
+    } else {
+        result = lush_plugin_manager_load_by_name(manager, module, &plugin);
+    }
+    if (result == LUSH_PLUGIN_ERROR_ALREADY_LOADED) {
+        plugin = lush_plugin_manager_find(manager, shipped ? shipped->name
+                                                           : module);
+    } else if (result != LUSH_PLUGIN_OK) {
+        fprintf(stderr, "enable: %s: %s\n", module,
+                lush_plugin_result_string(result));
+        return 1;
+    }
+    if (!plugin || count == 0) {
+        return 0;
+    }
+
+    int status = 0;
+    for (size_t i = 0; i < plugin->registered_builtin_count; i++) {
+        const char *provided = plugin->registered_builtins[i];
+        bool wanted = false;
+        for (int k = 0; k < count && !wanted; k++) {
+            wanted = strcmp(names[k], provided) == 0;
+        }
+        builtin_set_enabled(provided, wanted);
+    }
+    for (int k = 0; k < count; k++) {
+        bool provided = false;
+        for (size_t i = 0; i < plugin->registered_builtin_count; i++) {
+            provided = provided ||
+                       strcmp(names[k], plugin->registered_builtins[i]) == 0;
+        }
+        if (!provided) {
+            fprintf(stderr, "enable: %s: not provided by %s\n", names[k],
+                    module);
+            status = 1;
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief Print the shipped and loaded modules
+ */
+static void enable_list_modules(void) {
+    lush_plugin_manager_t *manager = lush_plugin_shell_manager();
+    for (size_t i = 0; i < sizeof(shipped_modules) / sizeof(*shipped_modules);
+         i++) {
+        const lush_plugin_def_t *def = shipped_modules[i];
+        bool loaded = manager && lush_plugin_manager_find(manager, def->name);
+        printf("%-12s %-9s %s\n", def->name, loaded ? "loaded" : "available",
+               def->description ? def->description : "");
+    }
+    if (!manager) {
+        return;
+    }
+
+    size_t count = 0;
+    lush_plugin_manager_list(manager, NULL, &count);
+    if (count == 0) {
+        return;
+    }
+    lush_plugin_t **plugins = calloc(count, sizeof(*plugins));
+    if (!plugins) {
+        return;
+    }
+    lush_plugin_manager_list(manager, plugins, &count);
+    for (size_t i = 0; i < count; i++) {
+        if (find_shipped_module(plugins[i]->def->name)) {
+            continue;
+        }
+        printf("%-12s %-9s %s\n", plugins[i]->def->name, "loaded",
+               plugins[i]->path ? plugins[i]->path : "");
+    }
+    free(plugins);
+}
+
+/**
+ * @brief Enable or disable loadable builtins
+ *
+ * Usage:
+ *   enable                     - List loadable builtins and their state
+ *   enable -a                  - List all builtins
+ *   enable -m                  - List modules
+ *   enable -f module [name...] - Load a module (only the named builtins)
+ *   enable -d module           - Unload a module
+ *   enable [-n] name...        - Enable (or with -n disable) builtins
+ *
+ * Only loadable builtins can be disabled; a disabled builtin leaves the
+ * external command of the same name in effect.
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @return 0 on success, 1 on failure, 2 on usage error
+ */
+int bin_enable(int argc, char **argv) {
+    bool disable = false;
+    bool list_all = false;
+    bool list_modules = false;
+    const char *load = NULL;
+    const char *unload = NULL;
+
+    int i = 1;
+    for (; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--") == 0) {
+            i++;
+            break;
+        }
+        if (arg[0] != '-' || arg[1] == '\0') {
+            break;
+        }
+        for (const char *p = arg + 1; *p; p++) {
+            const char *value = NULL;
+            if (*p == 'f' || *p == 'd') {
+                if (p[1]) {
+                    value = p + 1;
+                } else if (i + 1 < argc) {
+                    value = argv[++i];
+                } else {
+                    fprintf(stderr,
+                            "enable: -%c: option requires an argument\n", *p);
+                    return 2;
+                }
+            }
+            switch (*p) {
+            case 'n':
+                disable = true;
+                break;
+            case 'a':
+                list_all = true;
+                break;
+            case 'm':
+                list_modules = true;
+                break;
+            case 'f':
+                load = value;
+                break;
+            case 'd':
+                unload = value;
+                break;
+            default:
+                fprintf(stderr, "enable: -%c: invalid option\n", *p);
+                fprintf(stderr, "usage: enable [-a] [-m] [-n] [-f module] "
+                                "[-d module] [name ...]\n");
+                return 2;
+            }
+            if (value) {
+                break;
+            }
+        }
+    }
+
+    if (load) {
+        return enable_load_module(load, &argv[i], argc - i);
+    }
+    if (unload) {
+        lush_plugin_manager_t *manager = lush_plugin_shell_manager();
+        lush_plugin_result_t result =
+            manager ? lush_plugin_manager_unload(manager, unload)
+                    : LUSH_PLUGIN_ERROR_NOT_FOUND;
+        if (result != LUSH_PLUGIN_OK) {
+            fprintf(stderr, "enable: %s: %s\n", unload,
+                    lush_plugin_result_string(result));
+            return 1;
+        }
+        return 0;
+    }
+    if (list_modules) {
+        enable_list_modules();
+        return 0;
+    }
+
+    if (i >= argc) {
+        if (list_all) {
+            for (size_t k = 0; k < builtins_count; k++) {
+                printf("enable %s\n", builtins[k].name);
+            }
+        }
+        bool enabled;
+        const builtin *entry;
+        for (size_t k = 0; (entry = builtin_loadable_at(k, &enabled)); k++) {
+            if (enabled != disable || list_all) {
+                printf("enable %s%s\n", enabled ? "" : "-n ", entry->name);
+            }
+        }
+        return 0;
+    }
+
+    int status = 0;
+    for (; i < argc; i++) {
+        if (builtin_set_enabled(argv[i], !disable) == 0) {
+            continue;
+        }
+        if (is_builtin(argv[i])) {
+            fprintf(stderr, "enable: %s: shell builtin cannot be %s\n",
+                    argv[i], disable ? "disabled" : "changed");
+        } else {
+            fprintf(stderr, "enable: %s: not a loadable builtin\n", argv[i]);
+        }
+        status = 1;
+    }
+    return status;
+}
+
+/**
+ * @brief Cache the output of a slow command
+ *
+ * Usage:
+ *   memo [-a] [-t ttl] [-k var]... [-f file]... [--] cmd [args...]
+ *   memo -l              - List cached commands, most recently used first
+ *   memo -s [-r]         - Show counters (-r resets them afterwards)
+ *   memo -c [cmd...]     - Drop every entry, or the entries for cmd
+ *
+ * Options for running a command:
+ *   -t ttl   Seconds (or Ns, Nm, Nh, Nd) the output stays fresh; without
+ *            it the output is kept until a dependency changes
+ *   -k var   Re-run when the value of var changes (repeatable)
+ *   -f file  Re-run when file is modified, created or removed (repeatable)
+ *   -a       Once expired, print the stale output and refresh it in the
+ *            background for the next call
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @return Exit status of the (cached) command, 2 on usage error
+ */
+int bin_memo(int argc, char **argv) {
+    memo_options_t opts = {0};
+    bool list = false;
+    bool show_stats = false;
+    bool reset_stats = false;
+    bool clear = false;
+    const char **vars = NULL;
+    const char **files = NULL;
+    int result = 0;
+
+    vars = calloc((size_t)argc, sizeof(*vars));
+    files = calloc((size_t)argc, sizeof(*files));
+    if (!vars || !files) {
+        free(vars);
+        free(files);
+        fprintf(stderr, "memo: out of memory\n");
+        return 1;
+    }
+    opts.vars = vars;
+    opts.files = files;
+
+    int i = 1;
+    for (; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--") == 0) {
+            i++;
+            break;
+        }
+        if (arg[0] != '-' || arg[1] == '\0') {
+            break;
+        }
+        for (const char *p = arg + 1; *p; p++) {
+            const char *value = NULL;
+            if (*p == 't' || *p == 'k' || *p == 'f') {
+                /* Value is the rest of this word or the next argument */
+                if (p[1]) {
+                    value = p + 1;
+                } else if (i + 1 < argc) {
+                    value = argv[++i];
+                } else {
+                    fprintf(stderr, "memo: -%c: option requires an argument\n",
+                            *p);
+                    result = 2;
+                    goto done;
+                }
+            }
+            switch (*p) {
+            case 't':
+                if (!parse_memo_ttl(value, &opts.ttl)) {
+                    fprintf(stderr, "memo: %s: invalid time to live\n", value);
+                    result = 2;
+                    goto done;
+                }
+                break;
+            case 'k':
+                vars[opts.var_count++] = value;
+                break;
+            case 'f':
+                files[opts.file_count++] = value;
+                break;
+            case 'a':
+                opts.async = true;
+                break;
+            case 'l':
+                list = true;
+                break;
+            case 's':
+                show_stats = true;
+                break;
+            case 'r':
+                reset_stats = true;
+                break;
+            case 'c':
+                clear = true;
+                break;
+            default:
+                fprintf(stderr, "memo: -%c: invalid option\n", *p);
+                fprintf(stderr, "usage: memo [-a] [-t ttl] [-k var] [-f file] "
+                                "command [args ...]\n"
+                                "       memo -l | -s [-r] | -c [command ...]\n");
+                result = 2;
+                goto done;
+            }
+            if (value) {
+                break;
+            }
+        }
+    }
+
+    if (clear) {
+        memo_clear(argc - i, &argv[i]);
+    } else if (list || show_stats || reset_stats) {
+        memo_poll();
+        if (list) {
+            memo_list(stdout);
+        }
+        if (show_stats) {
+            memo_stats_t st;
+            memo_get_stats(&st);
+            uint64_t lookups = st.hits + st.stale_hits + st.misses;
+            printf("entries:       %zu\n", st.entries);
+            printf("bytes:         %zu\n", st.bytes);
+            printf("hits:          %llu\n", (unsigned long long)st.hits);
+            printf("stale hits:    %llu\n", (unsigned long long)st.stale_hits);
+            printf("misses:        %llu\n", (unsigned long long)st.misses);
+            printf("refreshes:     %llu\n", (unsigned long long)st.refreshes);
+            printf("invalidations: %llu\n",
+                   (unsigned long long)st.invalidations);
+            printf("evictions:     %llu\n", (unsigned long long)st.evictions);
+            printf("hit rate:      %.1f%%\n",
+                   lookups ? 100.0 * (double)(st.hits + st.stale_hits) /
+                                 (double)lookups
+                           : 0.0);
+        }
+        if (reset_stats) {
+            memo_reset_stats();
+        }
+    } else if (i >= argc) {
+        fprintf(stderr, "memo: command required\n");
+        result = 2;
+    } else {
+        fflush(stdout);
+        result = memo_run(argc - i, &argv[i], &opts, stdout);
+    }
+
+done:
+    free(vars);
+    free(files);
+    return result;
+}
+
 /* ============================================================================
  * Environment Builtin
  * ============================================================================ */
@@ -8070,18 +8824,116 @@ int bin_env(int argc, char **argv) {
     return 126;
 }
 
+/**
+ * @brief Parse the options shared by analyze and lint for many scripts
+ *
+ * Handles -j N, --jobs=N, --no-cache and --cache-dir=DIR.
+ *
+ * @return 1 if argv[*i] was consumed, 0 if it is not a batch option,
+ *         -1 on a malformed value
+ */
+static int parse_batch_option(int argc, char **argv, int *i,
+                              debug_batch_options_t *batch) {
+    const char *jobs = NULL;
+    if (strcmp(argv[*i], "-j") == 0) {
+        if (*i + 1 >= argc) {
+            fprintf(stderr, "%s: -j requires an argument\n", argv[0]);
+            return -1;
+        }
+        jobs = argv[++*i];
+    } else if (strncmp(argv[*i], "--jobs=", 7) == 0) {
+        jobs = argv[*i] + 7;
+    } else if (strcmp(argv[*i], "--no-cache") == 0) {
+        batch->use_cache = false;
+        return 1;
+    } else if (strncmp(argv[*i], "--cache-dir=", 12) == 0) {
+        batch->cache_dir = argv[*i] + 12;
+        return 1;
+    } else {
+        return 0;
+    }
+
+    char *end = NULL;
+    long value = strtol(jobs, &end, 10);
+    if (!*jobs || *end || value < 0 || value > 1024) {
+        fprintf(stderr, "%s: invalid job count: %s\n", argv[0], jobs);
+        return -1;
+    }
+    batch->jobs = (int)value;
+    return 1;
+}
+
+/**
+ * @brief Parse the value of --spawn-budget=N for analyze and lint
+ * @return true on success, false (after printing an error) otherwise
+ */
+static bool parse_spawn_budget(const char *name, const char *value,
+                               unsigned long *budget) {
+    char *end = NULL;
+    unsigned long parsed = strtoul(value, &end, 10);
+    if (!*value || *end || *value == '-' || parsed == 0) {
+        fprintf(stderr, "%s: invalid spawn budget: %s\n", name, value);
+        return false;
+    }
+    *budget = parsed;
+    return true;
+}
+
+/**
+ * @brief Check whether analyze/lint arguments need the multi-script path
+ *
+ * A single regular file keeps the direct, uncached path; several scripts,
+ * a directory or an explicit job count go through debug_batch_run().
+ */
+static bool wants_batch(char **scripts, int script_count, bool jobs_given) {
+    if (script_count > 1 || jobs_given) {
+        return true;
+    }
+    struct stat st;
+    return script_count == 1 && stat(scripts[0], &st) == 0 &&
+           S_ISDIR(st.st_mode);
+}
+
+/**
+ * @brief Run analyze or lint over many scripts and print a summary
+ * @return Worst per-script exit status
+ */
+static int run_batch(const char *name, char **scripts, int script_count,
+                     const debug_batch_options_t *batch) {
+    char **paths = NULL;
+    size_t count = 0;
+    if (debug_batch_collect(scripts, (size_t)script_count, &paths, &count) !=
+        0) {
+        return 2;
+    }
+    if (count == 0) {
+        fprintf(stderr, "%s: no shell scripts found\n", name);
+        debug_batch_free_paths(paths, count);
+        return 0;
+    }
+
+    debug_batch_summary_t summary;
+    int status = debug_batch_run(paths, count, batch, &summary);
+    fprintf(stderr, "%s: checked %zu script(s), %zu from cache\n", name,
+            summary.files, summary.cached);
+    debug_batch_free_paths(paths, count);
+    return status;
+}
+
 /**
  * @brief Analyze scripts for issues and portability (builtin command)
  *
  * Analyzes shell scripts for syntax errors, style issues, security
  * vulnerabilities, performance problems, and portability concerns.
  *
- * Usage: analyze [OPTIONS] <script>
- *        lint [OPTIONS] <script>
+ * Usage: analyze [OPTIONS] <script|dir>...
  *
  * Options:
  *   -t, --target=SHELL  Target shell for compatibility (posix, bash, zsh)
  *   -s, --strict        Treat warnings as errors
+ *   --spawn-budget=N    Estimated processes a function may spawn per call
+ *   -j, --jobs=N        Worker processes for many scripts
+ *   --no-cache          Do not reuse cached results
  *   -h, --help          Show help message
  *
  * @param argc Argument count
@@ -8091,17 +8943,37 @@ int bin_env(int argc, char **argv) {
 int bin_analyze(int argc, char **argv) {
     bool strict_mode = false;
     const char *target_shell = NULL;
-    const char *script_file = NULL;
+    char **scripts = calloc((size_t)argc, sizeof(char *));
+    int script_count = 0;
+    unsigned long spawn_budget = 0;
+    debug_batch_options_t batch = {
+        .mode = ANALYSIS_MODE_FULL,
+        .jobs = -1,
+        .use_cache = true,
+    };
+    
+    if (!scripts) {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
     
     /* Parse arguments */
     for (int i = 1; i < argc; i++) {
+        int batch_opt;
         if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
-            printf("Usage: %s [OPTIONS] <script>\n", argv[0]);
+            printf("Usage: %s [OPTIONS] <script|dir>...\n", argv[0]);
             printf("\nAnalyze shell scripts for issues and portability.\n");
             printf("\nOptions:\n");
             printf("  -t, --target=SHELL  Target shell (posix, bash, zsh)\n");
             printf("  -s, --strict        Treat warnings as errors\n");
+            printf("  --spawn-budget=N    Processes a function may spawn per call\n");
+            printf("  -j, --jobs=N        Worker processes (default: CPUs)\n");
+            printf("  --no-cache          Do not reuse cached results\n");
+            printf("  --cache-dir=DIR     Result cache location\n");
             printf("  -h, --help          Show this help message\n");
+            printf("\nDirectories are searched recursively for scripts.\n");
+            printf("Several scripts are analyzed in parallel and results of\n");
+            printf("unchanged scripts are reused from the cache.\n");
             printf("\nCategories checked:\n");
             printf("  syntax       - Syntax errors and parsing issues\n");
             printf("  style        - Code style and formatting\n");
@@ -8112,6 +8984,7 @@ int bin_analyze(int argc, char **argv) {
             printf("  0  No issues found\n");
             printf("  1  Warnings found\n");
             printf("  2  Errors found\n");
+            free(scripts);
             return 0;
         } else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--strict") == 0) {
             strict_mode = true;
@@ -8120,23 +8993,37 @@ int bin_analyze(int argc, char **argv) {
                 target_shell = argv[++i];
             } else {
                 fprintf(stderr, "%s: -t requires an argument\n", argv[0]);
+                free(scripts);
                 return 1;
             }
         } else if (strncmp(argv[i], "--target=", 9) == 0) {
             target_shell = argv[i] + 9;
+        } else if (strncmp(argv[i], "--spawn-budget=", 15) == 0) {
+            if (!parse_spawn_budget(argv[0], argv[i] + 15, &spawn_budget)) {
+                free(scripts);
+                return 1;
+            }
+        } else if ((batch_opt = parse_batch_option(argc, argv, &i, &batch))) {
+            if (batch_opt < 0) {
+                free(scripts);
+                return 1;
+            }
         } else if (argv[i][0] == '-') {
             fprintf(stderr, "%s: unknown option: %s\n", argv[0], argv[i]);
+            free(scripts);
             return 1;
         } else {
-            script_file = argv[i];
+            scripts[script_count++] = argv[i];
         }
     }
     
-    if (!script_file) {
+    if (script_count == 0) {
         fprintf(stderr, "%s: missing script file argument\n", argv[0]);
-        fprintf(stderr, "Usage: %s [OPTIONS] <script>\n", argv[0]);
+        fprintf(stderr, "Usage: %s [OPTIONS] <script|dir>...\n", argv[0]);
+        free(scripts);
         return 1;
     }
+    const char *script_file = scripts[0];
     
     /* Set target shell if specified (stored as string for flexibility) */
     if (target_shell) {
@@ -8147,6 +9034,22 @@ int bin_analyze(int argc, char **argv) {
     if (strict_mode) {
         compat_set_strict(true);
     }
+
+    /* A budget of 0 restores the default left by an earlier run */
+    spawn_set_budget(spawn_budget);
+    
+    if (wants_batch(scripts, script_count, batch.jobs >= 0)) {
+        int exit_status = run_batch(argv[0], scripts, script_count, &batch);
+        if (strict_mode && exit_status == 1) {
+            exit_status = 2;
+        }
+        if (strict_mode) {
+            compat_set_strict(false);
+        }
+        free(scripts);
+        return exit_status;
+    }
+    free(scripts);
     
     /* Initialize debug context for analysis */
     debug_context_t *ctx = debug_init();
@@ -8211,12 +9114,25 @@ int bin_lint(int argc, char **argv) {
     bool show_diff = false;
     bool create_backup = true;
     const char *target_shell = NULL;
-    const char *script_file = NULL;
+    char **scripts = calloc((size_t)argc, sizeof(char *));
+    int script_count = 0;
+    unsigned long spawn_budget = 0;
+    debug_batch_options_t batch = {
+        .mode = ANALYSIS_MODE_LINT,
+        .jobs = -1,
+        .use_cache = true,
+    };
+    
+    if (!scripts) {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
     
     /* Parse arguments */
     for (int i = 1; i < argc; i++) {
+        int batch_opt;
         if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
-            printf("Usage: %s [OPTIONS] <script>\n", argv[0]);
+            printf("Usage: %s [OPTIONS] <script|dir>...\n", argv[0]);
             printf("\nLint shell scripts for actionable issues.\n");
             printf("\nOptions:\n");
             printf("  -t, --target=SHELL  Target shell (posix, bash, zsh)\n");
@@ -8227,7 +9143,14 @@ int bin_lint(int argc, char **argv) {
             printf("  --dry-run           Preview fixes without applying\n");
             printf("  --diff              Show unified diff of changes\n");
             printf("  --no-backup         Don't create .bak backup when fixing\n");
+            printf("  --spawn-budget=N    Processes a function may spawn per call\n");
+            printf("  -j, --jobs=N        Worker processes (default: CPUs)\n");
+            printf("  --no-cache          Do not reuse cached results\n");
+            printf("  --cache-dir=DIR     Result cache location\n");
             printf("  -h, --help          Show this help message\n");
+            printf("\nDirectories are searched recursively for scripts.\n");
+            printf("Several scripts are linted in parallel and results of\n");
+            printf("unchanged scripts are reused from the cache.\n");
             printf("\nFix safety levels:\n");
             printf("  safe   - Applied with --fix (e.g., source -> .)\n");
             printf("  unsafe - Requires --unsafe-fixes (e.g., [[ ]] -> [ ])\n");
@@ -8237,6 +9160,7 @@ int bin_lint(int argc, char **argv) {
             printf("  1  Unfixed warnings remain\n");
             printf("  2  Unfixed errors remain\n");
             printf("  3  Fix application failed\n");
+            free(scripts);
             return 0;
         } else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--strict") == 0) {
             strict_mode = true;
@@ -8260,21 +9184,43 @@ int bin_lint(int argc, char **argv) {
                 target_shell = argv[++i];
             } else {
                 fprintf(stderr, "%s: -t requires an argument\n", argv[0]);
+                free(scripts);
                 return 1;
             }
         } else if (strncmp(argv[i], "--target=", 9) == 0) {
             target_shell = argv[i] + 9;
+        } else if (strncmp(argv[i], "--spawn-budget=", 15) == 0) {
+            if (!parse_spawn_budget(argv[0], argv[i] + 15, &spawn_budget)) {
+                free(scripts);
+                return 1;
+            }
+        } else if ((batch_opt = parse_batch_option(argc, argv, &i, &batch))) {
+            if (batch_opt < 0) {
+                free(scripts);
+                return 1;
+            }
         } else if (argv[i][0] == '-') {
             fprintf(stderr, "%s: unknown option: %s\n", argv[0], argv[i]);
+            free(scripts);
             return 1;
         } else {
-            script_file = argv[i];
+            scripts[script_count++] = argv[i];
         }
     }
     
-    if (!script_file) {
+    if (script_count == 0) {
         fprintf(stderr, "%s: missing script file argument\n", argv[0]);
-        fprintf(stderr, "Usage: %s [OPTIONS] <script>\n", argv[0]);
+        fprintf(stderr, "Usage: %s [OPTIONS] <script|dir>...\n", argv[0]);
+        free(scripts);
+        return 1;
+    }
+    const char *script_file = scripts[0];
+    bool batch_mode = wants_batch(scripts, script_count, batch.jobs >= 0);
+    
+    if (batch_mode && fix_interactive) {
+        fprintf(stderr, "%s: --fix-interactive takes a single script\n",
+                argv[0]);
+        free(scripts);
         return 1;
     }
     
@@ -8287,6 +9233,25 @@ int bin_lint(int argc, char **argv) {
     if (strict_mode) {
         compat_set_strict(true);
     }
+
+    /* A budget of 0 restores the default left by an earlier run */
+    spawn_set_budget(spawn_budget);
+    
+    if (batch_mode) {
+        batch.fix = fix_mode;
+        batch.unsafe_fixes = unsafe_fixes;
+        batch.dry_run = dry_run;
+        int exit_status = run_batch(argv[0], scripts, script_count, &batch);
+        if (strict_mode && exit_status == 1) {
+            exit_status = 2;
+        }
+        if (strict_mode) {
+            compat_set_strict(false);
+        }
+        free(scripts);
+        return exit_status;
+    }
+    free(scripts);
     
     /* Initialize debug context for analysis */
     debug_context_t *ctx = debug_init();
@@ -8321,6 +9286,8 @@ int bin_lint(int argc, char **argv) {
 
                     /* Collect fixes */
                     size_t fixes_found = fixer_collect_fixes(&fixer_ctx, target);
+                    fixes_found +=
+                        fixer_collect_spawn_fixes(&fixer_ctx, target);
 
                     if (fixes_found > 0) {
                         fixer_options_t opts = {
@@ -0,0 +1,1660 @@
+/**
+ * @file coreutils.c
+ * @brief In-process implementations of frequently used utilities
+ *
+ * Each command parses the options POSIX specifies for it (plus a few
+ * near-universal extensions such as head -c) and runs the real utility
+ * from PATH for anything else, so unknown options keep working exactly as
+ * before. Output goes straight to file descriptor 1 and input comes from
+ * descriptor 0, which the executor has already redirected, so the builtins
+ * behave like the external commands in redirections and pipelines.
+ *
+ * Diagnostics follow the wording of the GNU utilities that most users
+ * already know.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "coreutils.h"
+
+#include "executor.h"
+#include "lush.h"
+#include "signals.h"
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/** Size of the copy buffer used by cat, head, tail and tee */
+#define CU_BUFSIZE 65536
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+/**
+ * @brief Run the real utility for options the builtin does not handle
+ *
+ * The child inherits the descriptors the executor set up, so redirections
+ * apply to it as they would have to the builtin.
+ *
+ * @param argv Command and arguments, as passed to the builtin
+ * @return Exit status of the utility
+ */
+static int run_external(char **argv) {
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        fprintf(stderr, "%s: fork: %s\n", argv[0], strerror(errno));
+        return 126;
+    }
+    if (pid == 0) {
+        signal(SIGINT, SIG_DFL);
+        signal(SIGQUIT, SIG_DFL);
+        signal(SIGTSTP, SIG_DFL);
+        signal(SIGTTIN, SIG_DFL);
+        signal(SIGTTOU, SIG_DFL);
+        execvp(argv[0], argv);
+        fprintf(stderr, "lush: %s: %s\n", argv[0], strerror(errno));
+        _exit(errno == ENOENT ? 127 : 126);
+    }
+
+    set_current_child_pid(pid);
+    int status = 0;
+    while (executor_reap_child(get_global_executor(), pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+            clear_current_child_pid();
+            return 1;
+        }
+    }
+    clear_current_child_pid();
+
+    if (WIFEXITED(status)) {
+        return WEXITSTATUS(status);
+    }
+    if (WIFSIGNALED(status)) {
+        return 128 + WTERMSIG(status);
+    }
+    return 1;
+}
+
+/**
+ * @brief Whether ^C was pressed while a builtin was blocked
+ *
+ * The interactive shell catches SIGINT instead of dying, so builtins that
+ * block check for it whenever a system call is interrupted.
+ */
+static bool interrupted(void) { return check_and_clear_sigint_flag() != 0; }
+
+/**
+ * @brief Write a whole buffer, retrying short writes
+ *
+ * @return 0 on success, -1 on error (errno set)
+ */
+static int write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR && !interrupted()) {
+                continue;
+            }
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Read into a buffer, retrying when interrupted by other signals
+ *
+ * @return Bytes read, 0 at end of input, -1 on error or ^C
+ */
+static ssize_t read_some(int fd, char *buf, size_t len) {
+    for (;;) {
+        ssize_t n = read(fd, buf, len);
+        if (n >= 0 || errno != EINTR) {
+            return n;
+        }
+        if (interrupted()) {
+            return -1;
+        }
+    }
+}
+
+/**
+ * @brief Report a write error unless it is a closed pipe
+ */
+static void report_write_error(const char *cmd) {
+    if (errno != EPIPE) {
+        fprintf(stderr, "%s: write error: %s\n", cmd, strerror(errno));
+    }
+}
+
+/**
+ * @brief Open an operand for reading ("-" is standard input)
+ *
+ * @return Descriptor, or -1 with a diagnostic printed
+ */
+static int open_input(const char *cmd, const char *path) {
+    if (strcmp(path, "-") == 0) {
+        return STDIN_FILENO;
+    }
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "%s: %s: %s\n", cmd, path, strerror(errno));
+    }
+    return fd;
+}
+
+static void close_input(int fd) {
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+}
+
+/**
+ * @brief Parse a non-negative decimal count
+ *
+ * @return true if text is entirely a number that fits
+ */
+static bool parse_count(const char *text, unsigned long long *out) {
+    if (!text || !isdigit((unsigned char)*text)) {
+        return false;
+    }
+    char *end;
+    errno = 0;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (*end != '\0' || errno != 0) {
+        return false;
+    }
+    *out = value;
+    return true;
+}
+
+/**
+ * @brief Whether an argument looks like an option
+ */
+static bool is_option(const char *arg) { return arg[0] == '-' && arg[1]; }
+
+/* ============================================================================
+ * cat
+ * ============================================================================ */
+
+/**
+ * @brief Copy a descriptor to standard output
+ *
+ * @return 0 on success, 1 on read error, 2 on write error
+ */
+static int copy_to_stdout(int fd, char *buf) {
+    for (;;) {
+        ssize_t n = read_some(fd, buf, CU_BUFSIZE);
+        if (n == 0) {
+            return 0;
+        }
+        if (n < 0) {
+            return 1;
+        }
+        if (write_all(STDOUT_FILENO, buf, (size_t)n) < 0) {
+            return 2;
+        }
+    }
+}
+
+/**
+ * @brief cat [-u] [file...]
+ */
+static int cu_cat(int argc, char **argv) {
+    int i = 1;
+    for (; i < argc && is_option(argv[i]); i++) {
+        if (strcmp(argv[i], "--") == 0) {
+            i++;
+            break;
+        }
+        for (const char *p = argv[i] + 1; *p; p++) {
+            if (*p != 'u') {
+                return run_external(argv);
+            }
+        }
+    }
+
+    char *buf = malloc(CU_BUFSIZE);
+    if (!buf) {
+        return run_external(argv);
+    }
+    fflush(stdout);
+
+    static char *stdin_only[] = {"-", NULL};
+    char **files = i < argc ? &argv[i] : stdin_only;
+    int status = 0;
+    for (; *files; files++) {
+        int fd = open_input("cat", *files);
+        if (fd < 0) {
+            status = 1;
+            continue;
+        }
+        int r = copy_to_stdout(fd, buf);
+        close_input(fd);
+        if (r == 1) {
+            if (errno != EINTR) {
+                fprintf(stderr, "cat: %s: %s\n", *files, strerror(errno));
+            }
+            status = 1;
+            if (errno == EINTR) {
+                status = 130;
+                break;
+            }
+        } else if (r == 2) {
+            report_write_error("cat");
+            status = 1;
+            break;
+        }
+    }
+    free(buf);
+    return status;
+}
+
+/* ============================================================================
+ * head
+ * ============================================================================ */
+
+/**
+ * @brief Copy the first count lines (or bytes) of a descriptor
+ *
+ * When the input is seekable, the offset is left just after the data
+ * that was output, as the real head does, so `{ head -n 1; cat; } < file`
+ * works.
+ */
+static int head_fd(int fd, unsigned long long count, bool bytes, char *buf) {
+    while (count > 0) {
+        ssize_t n = read_some(fd, buf, CU_BUFSIZE);
+        if (n == 0) {
+            return 0;
+        }
+        if (n < 0) {
+            return 1;
+        }
+        size_t take = (size_t)n;
+        if (bytes) {
+            if ((unsigned long long)take > count) {
+                take = (size_t)count;
+            }
+            count -= take;
+        } else {
+            for (size_t k = 0; k < (size_t)n; k++) {
+                if (buf[k] == '\n' && --count == 0) {
+                    take = k + 1;
+                    break;
+                }
+            }
+        }
+        if (write_all(STDOUT_FILENO, buf, take) < 0) {
+            return 2;
+        }
+        if (take < (size_t)n) {
+            lseek(fd, -(off_t)((size_t)n - take), SEEK_CUR);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief head [-n number | -c number | -number] [file...]
+ */
+static int cu_head(int argc, char **argv) {
+    unsigned long long count = 10;
+    bool bytes = false;
+    int i = 1;
+    for (; i < argc && is_option(argv[i]); i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--") == 0) {
+            i++;
+            break;
+        }
+        if (isdigit((unsigned char)arg[1])) {
+            /* Obsolescent -number form */
+            if (!parse_count(arg + 1, &count)) {
+                return run_external(argv);
+            }
+            bytes = false;
+            continue;
+        }
+        if (arg[1] == 'n' || arg[1] == 'c') {
+            const char *value = arg[2] ? arg + 2 : (i + 1 < argc ? argv[++i]
+                                                                 : NULL);
+            /* Negative (all but the last N) and suffixed counts: real head */
+            if (!parse_count(value, &count)) {
+                return run_external(argv);
+            }
+            bytes = arg[1] == 'c';
+            continue;
+        }
+        return run_external(argv);
+    }
+
+    char *buf = malloc(CU_BUFSIZE);
+    if (!buf) {
+        return run_external(argv);
+    }
+    fflush(stdout);
+
+    int nfiles = argc - i;
+    static char *stdin_only[] = {"-", NULL};
+    char **files = nfiles > 0 ? &argv[i] : stdin_only;
+    int status = 0;
+    for (int k = 0; files[k]; k++) {
+        int fd = open_input("head", files[k]);
+        if (fd < 0) {
+            status = 1;
+            continue;
+        }
+        if (nfiles > 1) {
+            char header[PATH_MAX + 16];
+            int len = snprintf(header, sizeof(header), "%s==> %s <==\n",
+                               k > 0 ? "\n" : "",
+                               strcmp(files[k], "-") == 0 ? "standard input"
+                                                          : files[k]);
+            if (write_all(STDOUT_FILENO, header, (size_t)len) < 0) {
+                close_input(fd);
+                report_write_error("head");
+                status = 1;
+                break;
+            }
+        }
+        int r = head_fd(fd, count, bytes, buf);
+        close_input(fd);
+        if (r == 1) {
+            if (errno == EINTR) {
+                status = 130;
+                break;
+            }
+            fprintf(stderr, "head: error reading '%s': %s\n", files[k],
+                    strerror(errno));
+            status = 1;
+        } else if (r == 2) {
+            report_write_error("head");
+            status = 1;
+            break;
+        }
+    }
+    free(buf);
+    return status;
+}
+
+/* ============================================================================
+ * tail
+ * ============================================================================ */
+
+/**
+ * @brief Offset of the last count lines in a buffer
+ *
+ * A final newline ends the last line rather than starting a new one.
+ */
+static size_t tail_lines_start(const char *data, size_t len,
+                               unsigned long long count) {
+    if (count == 0) {
+        return len;
+    }
+    size_t end = len;
+    if (end > 0 && data[end - 1] == '\n') {
+        end--;
+    }
+    for (size_t k = end; k > 0; k--) {
+        if (data[k - 1] == '\n' && --count == 0) {
+            return k;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Offset of the last count lines of a regular file
+ *
+ * Scans backwards block by block, so only the tail of a large file is
+ * read.
+ */
+static off_t tail_lines_offset(int fd, off_t size, unsigned long long count,
+                               char *buf) {
+    if (count == 0) {
+        return size;
+    }
+    off_t pos = size;
+    bool skip_final_newline = true;
+    while (pos > 0) {
+        size_t chunk = pos > CU_BUFSIZE ? CU_BUFSIZE : (size_t)pos;
+        pos -= (off_t)chunk;
+        if (pread(fd, buf, chunk, pos) != (ssize_t)chunk) {
+            return -1;
+        }
+        size_t k = chunk;
+        if (skip_final_newline) {
+            skip_final_newline = false;
+            if (k > 0 && buf[k - 1] == '\n') {
+                k--;
+            }
+        }
+        for (; k > 0; k--) {
+            if (buf[k - 1] == '\n' && --count == 0) {
+                return pos + (off_t)k;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Output everything from the current offset on
+ */
+static int tail_copy_rest(int fd, char *buf) { return copy_to_stdout(fd, buf); }
+
+/**
+ * @brief Skip the first count - 1 lines (or bytes), then copy the rest
+ */
+static int tail_from_start(int fd, unsigned long long count, bool bytes,
+                           char *buf) {
+    unsigned long long skip = count > 0 ? count - 1 : 0;
+    while (skip > 0) {
+        ssize_t n = read_some(fd, buf, CU_BUFSIZE);
+        if (n == 0) {
+            return 0;
+        }
+        if (n < 0) {
+            return 1;
+        }
+        size_t start = (size_t)n;
+        if (bytes) {
+            if ((unsigned long long)n > skip) {
+                start = (size_t)skip;
+            }
+            skip -= start;
+        } else {
+            for (size_t k = 0; k < (size_t)n; k++) {
+                if (buf[k] == '\n' && --skip == 0) {
+                    start = k + 1;
+                    break;
+                }
+            }
+        }
+        if (start < (size_t)n &&
+            write_all(STDOUT_FILENO, buf + start, (size_t)n - start) < 0) {
+            return 2;
+        }
+    }
+    return tail_copy_rest(fd, buf);
+}
+
+/**
+ * @brief Output the last count lines (or bytes) of a descriptor
+ */
+static int tail_from_end(int fd, unsigned long long count, bool bytes,
+                         char *buf) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        off_t start;
+        if (bytes) {
+            start = (unsigned long long)st.st_size > count
+                        ? st.st_size - (off_t)count
+                        : 0;
+        } else {
+            start = tail_lines_offset(fd, st.st_size, count, buf);
+            if (start < 0) {
+                return 1;
+            }
+        }
+        if (lseek(fd, start, SEEK_SET) < 0) {
+            return 1;
+        }
+        return tail_copy_rest(fd, buf);
+    }
+
+    /* Pipes and terminals: keep everything, then print the tail */
+    char *data = NULL;
+    size_t len = 0;
+    size_t cap = 0;
+    for (;;) {
+        if (cap - len < CU_BUFSIZE) {
+            size_t grown_cap = cap ? cap * 2 : 4 * CU_BUFSIZE;
+            char *grown = realloc(data, grown_cap);
+            if (!grown) {
+                free(data);
+                errno = ENOMEM;
+                return 1;
+            }
+            data = grown;
+            cap = grown_cap;
+        }
+        ssize_t n = read_some(fd, data + len, CU_BUFSIZE);
+        if (n == 0) {
+            break;
+        }
+        if (n < 0) {
+            free(data);
+            return 1;
+        }
+        len += (size_t)n;
+    }
+
+    size_t start;
+    if (bytes) {
+        start = (unsigned long long)len > count ? len - (size_t)count : 0;
+    } else {
+        start = tail_lines_start(data, len, count);
+    }
+    int r = write_all(STDOUT_FILENO, data + start, len - start) < 0 ? 2 : 0;
+    free(data);
+    return r;
+}
+
+/**
+ * @brief Parse a tail count: number, +number or -number
+ *
+ * @param from_start Output: true for +number
+ */
+static bool parse_tail_count(const char *text, unsigned long long *count,
+                             bool *from_start) {
+    if (!text) {
+        return false;
+    }
+    *from_start = false;
+    if (*text == '+') {
+        *from_start = true;
+        text++;
+    } else if (*text == '-') {
+        text++;
+    }
+    return parse_count(text, count);
+}
+
+/**
+ * @brief tail [-n [+-]number | -c [+-]number | -number | +number] [file...]
+ *
+ * -f and other options run the real tail.
+ */
+static int cu_tail(int argc, char **argv) {
+    unsigned long long count = 10;
+    bool bytes = false;
+    bool from_start = false;
+    int i = 1;
+    for (; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--") == 0) {
+            i++;
+            break;
+        }
+        if (arg[0] == '+' && isdigit((unsigned char)arg[1]) && i == 1) {
+            /* Obsolescent +number form */
+            if (!parse_tail_count(arg, &count, &from_start)) {
+                return run_external(argv);
+            }
+            continue;
+        }
+        if (!is_option(arg)) {
+            break;
+        }
+        if (isdigit((unsigned char)arg[1])) {
+            if (!parse_tail_count(arg, &count, &from_start)) {
+                return run_external(argv);
+            }
+            bytes = false;
+            continue;
+        }
+        if (arg[1] == 'n' || arg[1] == 'c') {
+            const char *value = arg[2] ? arg + 2 : (i + 1 < argc ? argv[++i]
+                                                                 : NULL);
+            if (!parse_tail_count(value, &count, &from_start)) {
+                return run_external(argv);
+            }
+            bytes = arg[1] == 'c';
+            continue;
+        }
+        return run_external(argv);
+    }
+
+    char *buf = malloc(CU_BUFSIZE);
+    if (!buf) {
+        return run_external(argv);
+    }
+    fflush(stdout);
+
+    int nfiles = argc - i;
+    static char *stdin_only[] = {"-", NULL};
+    char **files = nfiles > 0 ? &argv[i] : stdin_only;
+    int status = 0;
+    for (int k = 0; files[k]; k++) {
+        int fd = open_input("tail", files[k]);
+        if (fd < 0) {
+            status = 1;
+            continue;
+        }
+        if (nfiles > 1) {
+            char header[PATH_MAX + 16];
+            int len = snprintf(header, sizeof(header), "%s==> %s <==\n",
+                               k > 0 ? "\n" : "",
+                               strcmp(files[k], "-") == 0 ? "standard input"
+                                                          : files[k]);
+            if (write_all(STDOUT_FILENO, header, (size_t)len) < 0) {
+                close_input(fd);
+                report_write_error("tail");
+                status = 1;
+                break;
+            }
+        }
+        int r = from_start ? tail_from_start(fd, count, bytes, buf)
+                           : tail_from_end(fd, count, bytes, buf);
+        close_input(fd);
+        if (r == 1) {
+            if (errno == EINTR) {
+                status = 130;
+                break;
+            }
+            fprintf(stderr, "tail: error reading '%s': %s\n", files[k],
+                    strerror(errno));
+            status = 1;
+        } else if (r == 2) {
+            report_write_error("tail");
+            status = 1;
+            break;
+        }
+    }
+    free(buf);
+    return status;
+}
+
+/* ============================================================================
+ * basename, dirname
+ * ============================================================================ */
+
+/**
+ * @brief basename string [suffix]
+ *
+ * Follows the POSIX algorithm; -a, -s and -z run the real basename.
+ */
+static int cu_basename(int argc, char **argv) {
+    int i = 1;
+    if (i < argc && strcmp(argv[i], "--") == 0) {
+        i++;
+    } else if (i < argc && is_option(argv[i])) {
+        return run_external(argv);
+    }
+    int operands = argc - i;
+    if (operands < 1 || operands > 2) {
+        return run_external(argv);
+    }
+
+    const char *string = argv[i];
+    size_t len = strlen(string);
+    size_t end = len;
+    while (end > 0 && string[end - 1] == '/') {
+        end--;
+    }
+
+    if (len == 0) {
+        puts("");
+        fflush(stdout);
+        return 0;
+    }
+    if (end == 0) {
+        puts("/");
+        fflush(stdout);
+        return 0;
+    }
+
+    size_t start = end;
+    while (start > 0 && string[start - 1] != '/') {
+        start--;
+    }
+
+    size_t base_len = end - start;
+    if (operands == 2) {
+        const char *suffix = argv[i + 1];
+        size_t suffix_len = strlen(suffix);
+        if (suffix_len > 0 && suffix_len < base_len &&
+            memcmp(string + end - suffix_len, suffix, suffix_len) == 0) {
+            base_len -= suffix_len;
+        }
+    }
+
+    printf("%.*s\n", (int)base_len, string + start);
+    fflush(stdout);
+    return 0;
+}
+
+/**
+ * @brief dirname string...
+ */
+static int cu_dirname(int argc, char **argv) {
+    int i = 1;
+    if (i < argc && strcmp(argv[i], "--") == 0) {
+        i++;
+    } else if (i < argc && is_option(argv[i])) {
+        return run_external(argv);
+    }
+    if (i >= argc) {
+        return run_external(argv);
+    }
+
+    for (; i < argc; i++) {
+        const char *string = argv[i];
+        size_t end = strlen(string);
+
+        /* Trailing slashes, then the last component, then its slashes */
+        while (end > 1 && string[end - 1] == '/') {
+            end--;
+        }
+        while (end > 0 && string[end - 1] != '/') {
+            end--;
+        }
+        if (end == 0) {
+            puts(".");
+            continue;
+        }
+        while (end > 1 && string[end - 1] == '/') {
+            end--;
+        }
+        printf("%.*s\n", (int)end, string);
+    }
+    fflush(stdout);
+    return 0;
+}
+
+/* ============================================================================
+ * mkdir
+ * ============================================================================ */
+
+/**
+ * @brief Create a directory and any missing parents
+ *
+ * Intermediate directories get the default mode plus u+wx, as POSIX
+ * specifies for mkdir -p.
+ */
+static int make_parents(char *path, mode_t final_mode) {
+    mode_t mask = umask(0);
+    umask(mask);
+    mode_t parent_mode = ((S_IRWXU | S_IRWXG | S_IRWXO) & ~mask) |
+                         S_IWUSR | S_IXUSR;
+
+    for (char *p = path + 1; *p; p++) {
+        if (*p != '/' || p[-1] == '/') {
+            continue;
+        }
+        *p = '\0';
+        if (mkdir(path, parent_mode) < 0 && errno != EEXIST) {
+            int saved = errno;
+            *p = '/';
+            errno = saved;
+            return -1;
+        }
+        *p = '/';
+    }
+
+    if (mkdir(path, final_mode) < 0) {
+        struct stat st;
+        int saved = errno;
+        if (saved == EEXIST && stat(path, &st) == 0 && S_ISDIR(st.st_mode)) {
+            return 0;
+        }
+        errno = saved;
+        return -1;
+    }
+    return 1;
+}
+
+/**
+ * @brief mkdir [-p] [-m mode] dir...
+ *
+ * Only octal modes are handled here; symbolic modes run the real mkdir.
+ */
+static int cu_mkdir(int argc, char **argv) {
+    bool parents = false;
+    bool have_mode = false;
+    mode_t mode = 0;
+    int i = 1;
+    for (; i < argc && is_option(argv[i]); i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--") == 0) {
+            i++;
+            break;
+        }
+        for (const char *p = arg + 1; *p; p++) {
+            if (*p == 'p') {
+                parents = true;
+            } else if (*p == 'm') {
+                const char *value = p[1] ? p + 1 : (i + 1 < argc ? argv[++i]
+                                                                 : NULL);
+                char *end;
+                unsigned long m = value ? strtoul(value, &end, 8) : 0;
+                if (!value || !*value || *end || m > 07777) {
+                    return run_external(argv);
+                }
+                mode = (mode_t)m;
+                have_mode = true;
+                break;
+            } else {
+                return run_external(argv);
+            }
+        }
+    }
+    if (i >= argc) {
+        return run_external(argv);
+    }
+
+    mode_t create_mode = have_mode ? mode : (S_IRWXU | S_IRWXG | S_IRWXO);
+    int status = 0;
+    for (; i < argc; i++) {
+        int r;
+        if (parents) {
+            char *path = strdup(argv[i]);
+            if (!path) {
+                return run_external(argv);
+            }
+            r = make_parents(path, create_mode);
+            free(path);
+        } else {
+            r = mkdir(argv[i], create_mode) < 0 ? -1 : 1;
+        }
+        if (r < 0) {
+            fprintf(stderr, "mkdir: cannot create directory '%s': %s\n",
+                    argv[i], strerror(errno));
+            status = 1;
+            continue;
+        }
+        /* The umask applies to mkdir(); -m sets the mode exactly */
+        if (r > 0 && have_mode && chmod(argv[i], mode) < 0) {
+            fprintf(stderr, "mkdir: cannot set permissions of '%s': %s\n",
+                    argv[i], strerror(errno));
+            status = 1;
+        }
+    }
+    return status;
+}
+
+/* ============================================================================
+ * rm
+ * ============================================================================ */
+
+/**
+ * @brief Remove a directory tree
+ *
+ * Symbolic links are removed, never followed.
+ *
+ * @return 0 on success, 1 if anything could not be removed
+ */
+static int remove_tree(const char *path, bool force) {
+    DIR *dir = opendir(path);
+    if (!dir) {
+        if (force && errno == ENOENT) {
+            return 0;
+        }
+        fprintf(stderr, "rm: cannot remove '%s': %s\n", path,
+                strerror(errno));
+        return 1;
+    }
+
+    int status = 0;
+    size_t path_len = strlen(path);
+    struct dirent *de;
+    while ((de = readdir(dir)) != NULL) {
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) {
+            continue;
+        }
+        size_t child_len = path_len + 1 + strlen(de->d_name) + 1;
+        char *child = malloc(child_len);
+        if (!child) {
+            status = 1;
+            break;
+        }
+        snprintf(child, child_len, "%s%s%s", path,
+                 path_len > 0 && path[path_len - 1] == '/' ? "" : "/",
+                 de->d_name);
+
+        struct stat st;
+        if (lstat(child, &st) == 0 && S_ISDIR(st.st_mode)) {
+            status |= remove_tree(child, force);
+        } else if (unlink(child) < 0 && !(force && errno == ENOENT)) {
+            fprintf(stderr, "rm: cannot remove '%s': %s\n", child,
+                    strerror(errno));
+            status = 1;
+        }
+        free(child);
+    }
+    closedir(dir);
+
+    if (rmdir(path) < 0 && !(force && errno == ENOENT)) {
+        fprintf(stderr, "rm: cannot remove '%s': %s\n", path,
+                strerror(errno));
+        status = 1;
+    }
+    return status;
+}
+
+/**
+ * @brief Whether the last component of a path is . or ..
+ */
+static bool is_dot_or_dotdot(const char *path) {
+    size_t end = strlen(path);
+    while (end > 1 && path[end - 1] == '/') {
+        end--;
+    }
+    size_t start = end;
+    while (start > 0 && path[start - 1] != '/') {
+        start--;
+    }
+    size_t len = end - start;
+    return (len == 1 && path[start] == '.') ||
+           (len == 2 && path[start] == '.' && path[start + 1] == '.');
+}
+
+/**
+ * @brief rm [-fRr] file...
+ *
+ * Without -f on a terminal rm may have to prompt, so that case (and -i,
+ * -I, -d, -v and long options) runs the real rm.
+ */
+static int cu_rm(int argc, char **argv) {
+    bool force = false;
+    bool recursive = false;
+    int i = 1;
+    for (; i < argc && is_option(argv[i]); i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--") == 0) {
+            i++;
+            break;
+        }
+        for (const char *p = arg + 1; *p; p++) {
+            if (*p == 'f') {
+                force = true;
+            } else if (*p == 'r' || *p == 'R') {
+                recursive = true;
+            } else {
+                return run_external(argv);
+            }
+        }
+    }
+    if (i >= argc) {
+        return force ? 0 : run_external(argv);
+    }
+    if (!force && isatty(STDIN_FILENO)) {
+        return run_external(argv);
+    }
+
+    int status = 0;
+    for (; i < argc; i++) {
+        const char *path = argv[i];
+        if (is_dot_or_dotdot(path)) {
+            fprintf(stderr,
+                    "rm: refusing to remove '.' or '..' directory: "
+                    "skipping '%s'\n",
+                    path);
+            status = 1;
+            continue;
+        }
+
+        struct stat st;
+        if (lstat(path, &st) < 0) {
+            if (!(force && errno == ENOENT)) {
+                fprintf(stderr, "rm: cannot remove '%s': %s\n", path,
+                        strerror(errno));
+                status = 1;
+            }
+            continue;
+        }
+
+        if (S_ISDIR(st.st_mode)) {
+            if (!recursive) {
+                fprintf(stderr, "rm: cannot remove '%s': Is a directory\n",
+                        path);
+                status = 1;
+                continue;
+            }
+            struct stat root;
+            if (stat("/", &root) == 0 && root.st_dev == st.st_dev &&
+                root.st_ino == st.st_ino) {
+                /* Let the real rm apply its root protection */
+                char *rm_argv[] = {"rm", "-rf", "--", (char *)path, NULL};
+                status |= run_external(rm_argv) != 0;
+                continue;
+            }
+            status |= remove_tree(path, force);
+        } else if (unlink(path) < 0) {
+            fprintf(stderr, "rm: cannot remove '%s': %s\n", path,
+                    strerror(errno));
+            status = 1;
+        }
+    }
+    return status;
+}
+
+/* ============================================================================
+ * sleep
+ * ============================================================================ */
+
+/**
+ * @brief sleep time...
+ *
+ * Accepts decimal fractions and s/m/h/d suffixes like the GNU sleep; the
+ * times are added up.
+ */
+static int cu_sleep(int argc, char **argv) {
+    int i = 1;
+    if (i < argc && strcmp(argv[i], "--") == 0) {
+        i++;
+    }
+    if (i >= argc) {
+        return run_external(argv);
+    }
+
+    double total = 0;
+    for (; i < argc; i++) {
+        const char *arg = argv[i];
+        char *end;
+        if (!isdigit((unsigned char)*arg) && *arg != '.') {
+            return run_external(argv);
+        }
+        errno = 0;
+        double value = strtod(arg, &end);
+        if (end == arg || errno != 0) {
+            return run_external(argv);
+        }
+        switch (*end) {
+        case '\0':
+        case 's':
+            break;
+        case 'm':
+            value *= 60;
+            break;
+        case 'h':
+            value *= 3600;
+            break;
+        case 'd':
+            value *= 86400;
+            break;
+        default:
+            return run_external(argv);
+        }
+        if (*end && end[1]) {
+            return run_external(argv);
+        }
+        total += value;
+    }
+
+    struct timespec req;
+    req.tv_sec = (time_t)total;
+    req.tv_nsec = (long)((total - (double)req.tv_sec) * 1e9);
+    if (req.tv_nsec >= 1000000000L) {
+        req.tv_nsec = 999999999L;
+    }
+    struct timespec rem;
+    while (nanosleep(&req, &rem) < 0) {
+        if (errno != EINTR) {
+            return 1;
+        }
+        if (interrupted()) {
+            return 130;
+        }
+        req = rem;
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * tee
+ * ============================================================================ */
+
+/**
+ * @brief tee [-ai] [file...]
+ */
+static int cu_tee(int argc, char **argv) {
+    bool append = false;
+    bool ignore_interrupts = false;
+    int i = 1;
+    for (; i < argc && is_option(argv[i]); i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--") == 0) {
+            i++;
+            break;
+        }
+        for (const char *p = arg + 1; *p; p++) {
+            if (*p == 'a') {
+                append = true;
+            } else if (*p == 'i') {
+                ignore_interrupts = true;
+            } else {
+                return run_external(argv);
+            }
+        }
+    }
+
+    int nfiles = argc - i;
+    int *fds = calloc((size_t)nfiles + 1, sizeof(*fds));
+    char *buf = malloc(CU_BUFSIZE);
+    if (!fds || !buf) {
+        free(fds);
+        free(buf);
+        return run_external(argv);
+    }
+
+    int status = 0;
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC);
+    for (int k = 0; k < nfiles; k++) {
+        fds[k] = open(argv[i + k], flags, 0666);
+        if (fds[k] < 0) {
+            fprintf(stderr, "tee: %s: %s\n", argv[i + k], strerror(errno));
+            status = 1;
+        }
+    }
+
+    struct sigaction ignore;
+    struct sigaction saved_int;
+    if (ignore_interrupts) {
+        memset(&ignore, 0, sizeof(ignore));
+        ignore.sa_handler = SIG_IGN;
+        sigemptyset(&ignore.sa_mask);
+        sigaction(SIGINT, &ignore, &saved_int);
+    }
+
+    fflush(stdout);
+    bool stdout_ok = true;
+    for (;;) {
+        ssize_t n = read_some(STDIN_FILENO, buf, CU_BUFSIZE);
+        if (n == 0) {
+            break;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                status = 130;
+            } else {
+                fprintf(stderr, "tee: read error: %s\n", strerror(errno));
+                status = 1;
+            }
+            break;
+        }
+        if (stdout_ok && write_all(STDOUT_FILENO, buf, (size_t)n) < 0) {
+            report_write_error("tee");
+            stdout_ok = false;
+            status = 1;
+        }
+        for (int k = 0; k < nfiles; k++) {
+            if (fds[k] >= 0 && write_all(fds[k], buf, (size_t)n) < 0) {
+                fprintf(stderr, "tee: %s: %s\n", argv[i + k],
+                        strerror(errno));
+                close(fds[k]);
+                fds[k] = -1;
+                status = 1;
+            }
+        }
+    }
+
+    if (ignore_interrupts) {
+        sigaction(SIGINT, &saved_int, NULL);
+    }
+    for (int k = 0; k < nfiles; k++) {
+        if (fds[k] >= 0 && close(fds[k]) < 0) {
+            fprintf(stderr, "tee: %s: %s\n", argv[i + k], strerror(errno));
+            status = 1;
+        }
+    }
+    free(fds);
+    free(buf);
+    return status;
+}
+
+/* ============================================================================
+ * wc
+ * ============================================================================ */
+
+typedef struct {
+    unsigned long long lines;
+    unsigned long long words;
+    unsigned long long chars;
+    unsigned long long bytes;
+} wc_counts_t;
+
+static int wc_fd(int fd, wc_counts_t *c, char *buf) {
+    bool in_word = false;
+    for (;;) {
+        ssize_t n = read_some(fd, buf, CU_BUFSIZE);
+        if (n == 0) {
+            return 0;
+        }
+        if (n < 0) {
+            return 1;
+        }
+        c->bytes += (unsigned long long)n;
+        for (ssize_t k = 0; k < n; k++) {
+            unsigned char ch = (unsigned char)buf[k];
+            if (ch == '\n') {
+                c->lines++;
+            }
+            /* UTF-8 continuation bytes do not start a character */
+            if ((ch & 0xC0) != 0x80) {
+                c->chars++;
+            }
+            if (isspace(ch)) {
+                in_word = false;
+            } else if (!in_word) {
+                in_word = true;
+                c->words++;
+            }
+        }
+    }
+}
+
+static void wc_print(const wc_counts_t *c, bool lines, bool words, bool chars,
+                     bool bytes, int width, const char *name) {
+    const char *sep = "";
+    if (lines) {
+        printf("%s%*llu", sep, width, c->lines);
+        sep = " ";
+    }
+    if (words) {
+        printf("%s%*llu", sep, width, c->words);
+        sep = " ";
+    }
+    if (chars) {
+        printf("%s%*llu", sep, width, c->chars);
+        sep = " ";
+    }
+    if (bytes) {
+        printf("%s%*llu", sep, width, c->bytes);
+    }
+    if (name) {
+        printf(" %s", name);
+    }
+    putchar('\n');
+}
+
+/**
+ * @brief wc [-c|-m] [-lw] [file...]
+ *
+ * Column widths follow GNU wc: a single count for a single input is not
+ * padded, otherwise columns are as wide as the total size of the regular
+ * files (at least 7 when reading a pipe or terminal).
+ */
+static int cu_wc(int argc, char **argv) {
+    bool lines = false;
+    bool words = false;
+    bool chars = false;
+    bool bytes = false;
+    int i = 1;
+    for (; i < argc && is_option(argv[i]); i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--") == 0) {
+            i++;
+            break;
+        }
+        for (const char *p = arg + 1; *p; p++) {
+            switch (*p) {
+            case 'l':
+                lines = true;
+                break;
+            case 'w':
+                words = true;
+                break;
+            case 'm':
+                chars = true;
+                bytes = false;
+                break;
+            case 'c':
+                bytes = true;
+                chars = false;
+                break;
+            default:
+                return run_external(argv);
+            }
+        }
+    }
+    if (!lines && !words && !chars && !bytes) {
+        lines = words = bytes = true;
+    }
+
+    int nfiles = argc - i;
+    static char *stdin_only[] = {"-", NULL};
+    char **files = nfiles > 0 ? &argv[i] : stdin_only;
+    int ninputs = nfiles > 0 ? nfiles : 1;
+
+    int width = 1;
+    int ncounts = lines + words + chars + bytes;
+    if (!(ncounts == 1 && ninputs == 1)) {
+        unsigned long long regular_total = 0;
+        int minimum = 1;
+        for (int k = 0; k < ninputs; k++) {
+            struct stat st;
+            int r = strcmp(files[k], "-") == 0 ? fstat(STDIN_FILENO, &st)
+                                               : stat(files[k], &st);
+            if (r == 0 && S_ISREG(st.st_mode)) {
+                regular_total += (unsigned long long)st.st_size;
+            } else if (r == 0) {
+                minimum = 7;
+            }
+        }
+        for (; regular_total >= 10; regular_total /= 10) {
+            width++;
+        }
+        if (width < minimum) {
+            width = minimum;
+        }
+    }
+
+    char *buf = malloc(CU_BUFSIZE);
+    if (!buf) {
+        return run_external(argv);
+    }
+
+    wc_counts_t total = {0, 0, 0, 0};
+    int status = 0;
+    for (int k = 0; k < ninputs; k++) {
+        int fd = open_input("wc", files[k]);
+        if (fd < 0) {
+            status = 1;
+            continue;
+        }
+        wc_counts_t c = {0, 0, 0, 0};
+        int r = wc_fd(fd, &c, buf);
+        close_input(fd);
+        if (r != 0) {
+            if (errno == EINTR) {
+                status = 130;
+                break;
+            }
+            fprintf(stderr, "wc: %s: %s\n", files[k], strerror(errno));
+            status = 1;
+            continue;
+        }
+        total.lines += c.lines;
+        total.words += c.words;
+        total.chars += c.chars;
+        total.bytes += c.bytes;
+        wc_print(&c, lines, words, chars, bytes, width,
+                 nfiles > 0 ? files[k] : NULL);
+    }
+    if (nfiles > 1) {
+        wc_print(&total, lines, words, chars, bytes, width, "total");
+    }
+    free(buf);
+    if (fflush(stdout) != 0) {
+        report_write_error("wc");
+        status = 1;
+    }
+    return status;
+}
+
+/* ============================================================================
+ * seq
+ * ============================================================================ */
+
+/**
+ * @brief Parse a seq operand; only integers are handled in process
+ */
+static bool parse_seq_number(const char *text, long long *out) {
+    if (!text || !*text) {
+        return false;
+    }
+    char *end;
+    errno = 0;
+    long long value = strtoll(text, &end, 10);
+    if (*end || errno != 0) {
+        return false;
+    }
+    *out = value;
+    return true;
+}
+
+/**
+ * @brief seq [-s sep] [-w] [first [incr]] last
+ *
+ * Fractional operands, -f and other options run the real seq.
+ */
+static int cu_seq(int argc, char **argv) {
+    const char *sep = "\n";
+    bool equal_width = false;
+    int i = 1;
+    for (; i < argc; i++) {
+        const char *arg = argv[i];
+        /* Negative numbers are operands, not options */
+        if (!is_option(arg) || isdigit((unsigned char)arg[1])) {
+            break;
+        }
+        if (strcmp(arg, "--") == 0) {
+            i++;
+            break;
+        }
+        if (strcmp(arg, "-w") == 0) {
+            equal_width = true;
+        } else if (arg[1] == 's') {
+            sep = arg[2] ? arg + 2 : (i + 1 < argc ? argv[++i] : NULL);
+            if (!sep) {
+                return run_external(argv);
+            }
+        } else {
+            return run_external(argv);
+        }
+    }
+
+    int operands = argc - i;
+    long long first = 1;
+    long long incr = 1;
+    long long last;
+    if (operands < 1 || operands > 3 ||
+        !parse_seq_number(argv[argc - 1], &last) ||
+        (operands >= 2 && !parse_seq_number(argv[i], &first)) ||
+        (operands == 3 && !parse_seq_number(argv[i + 1], &incr)) ||
+        incr == 0) {
+        return run_external(argv);
+    }
+
+    int width = 0;
+    if (equal_width) {
+        char a[32];
+        char b[32];
+        int wa = snprintf(a, sizeof(a), "%lld", first);
+        int wb = snprintf(b, sizeof(b), "%lld", last);
+        width = wa > wb ? wa : wb;
+    }
+
+    fflush(stdout);
+    size_t sep_len = strlen(sep);
+    char out[CU_BUFSIZE];
+    size_t used = 0;
+    bool any = false;
+    for (long long v = first; incr > 0 ? v <= last : v >= last;) {
+        if (used + 32 + sep_len > sizeof(out)) {
+            if (write_all(STDOUT_FILENO, out, used) < 0) {
+                report_write_error("seq");
+                return 1;
+            }
+            used = 0;
+        }
+        if (any) {
+            memcpy(out + used, sep, sep_len);
+            used += sep_len;
+        }
+        if (equal_width && v < 0) {
+            used += (size_t)snprintf(out + used, 32, "-%0*lld", width - 1, -v);
+        } else {
+            used += (size_t)snprintf(out + used, 32, "%0*lld", width, v);
+        }
+        any = true;
+        /* Stop before the increment overflows */
+        if ((incr > 0 && v > LLONG_MAX - incr) ||
+            (incr < 0 && v < LLONG_MIN - incr)) {
+            break;
+        }
+        v += incr;
+    }
+    if (any) {
+        out[used++] = '\n';
+    }
+    if (write_all(STDOUT_FILENO, out, used) < 0) {
+        report_write_error("seq");
+        return 1;
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * date
+ * ============================================================================ */
+
+/**
+ * @brief Whether strftime can expand a format as GNU date would
+ *
+ * %N (nanoseconds) and %: (numeric zone with colons) are GNU extensions
+ * glibc's strftime does not provide.
+ */
+static bool strftime_supports(const char *format) {
+    for (const char *p = format; *p; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        p++;
+        while (*p == '-' || *p == '_' || *p == '0' || *p == '^' ||
+               *p == '#' || isdigit((unsigned char)*p)) {
+            p++;
+        }
+        if (*p == 'N' || *p == ':' || *p == '\0') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief date [-u] [+format]
+ *
+ * Setting the clock, -d, -r and other options run the real date.
+ */
+static int cu_date(int argc, char **argv) {
+    bool utc = false;
+    int i = 1;
+    for (; i < argc && is_option(argv[i]); i++) {
+        if (strcmp(argv[i], "--") == 0) {
+            i++;
+            break;
+        }
+        if (strcmp(argv[i], "-u") != 0) {
+            return run_external(argv);
+        }
+        utc = true;
+    }
+
+    const char *format = "%a %b %e %H:%M:%S %Z %Y";
+    if (i < argc) {
+        if (argv[i][0] != '+' || i + 1 < argc) {
+            return run_external(argv);
+        }
+        format = argv[i] + 1;
+    }
+    if (!strftime_supports(format)) {
+        return run_external(argv);
+    }
+
+    time_t now = time(NULL);
+    struct tm tm;
+    char *saved_tz = NULL;
+    if (utc) {
+        const char *tz = getenv("TZ");
+        saved_tz = tz ? strdup(tz) : NULL;
+        setenv("TZ", "UTC0", 1);
+        tzset();
+    }
+    localtime_r(&now, &tm);
+
+    /* A leading character tells an empty expansion from an error */
+    size_t fmt_len = strlen(format);
+    char *marked = malloc(fmt_len + 2);
+    size_t out_size = fmt_len * 8 + 256;
+    char *out = malloc(out_size);
+    size_t n = 0;
+    if (marked && out) {
+        marked[0] = 'x';
+        memcpy(marked + 1, format, fmt_len + 1);
+        n = strftime(out, out_size, marked, &tm);
+    }
+
+    if (utc) {
+        if (saved_tz) {
+            setenv("TZ", saved_tz, 1);
+        } else {
+            unsetenv("TZ");
+        }
+        tzset();
+        free(saved_tz);
+    }
+
+    int status = 0;
+    if (n == 0) {
+        free(marked);
+        free(out);
+        return run_external(argv);
+    }
+    if (utc) {
+        /* UTC0 has no name; GNU date calls it UTC */
+        char *zone = NULL;
+        while ((zone = strstr(out, "UTC0")) != NULL) {
+            memmove(zone + 3, zone + 4, strlen(zone + 4) + 1);
+        }
+    }
+    printf("%s\n", out + 1);
+    if (fflush(stdout) != 0) {
+        report_write_error("date");
+        status = 1;
+    }
+    free(marked);
+    free(out);
+    return status;
+}
+
+/* ============================================================================
+ * Module
+ * ============================================================================ */
+
+static const struct {
+    const char *name;
+    lush_plugin_builtin_fn fn;
+} coreutils_commands[] = {
+    {"basename", cu_basename}, {"cat", cu_cat},   {"date", cu_date},
+    {"dirname", cu_dirname},   {"head", cu_head}, {"mkdir", cu_mkdir},
+    {"rm", cu_rm},             {"seq", cu_seq},   {"sleep", cu_sleep},
+    {"tail", cu_tail},         {"tee", cu_tee},   {"wc", cu_wc},
+};
+
+static int coreutils_init(lush_plugin_context_t *ctx) {
+    for (size_t i = 0;
+         i < sizeof(coreutils_commands) / sizeof(coreutils_commands[0]); i++) {
+        if (lush_plugin_register_builtin(ctx, coreutils_commands[i].name,
+                                         coreutils_commands[i].fn) !=
+            LUSH_PLUGIN_OK) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+const lush_plugin_def_t lush_coreutils_plugin = {
+    .api_version = LUSH_PLUGIN_API_VERSION,
+    .name = COREUTILS_MODULE_NAME,
+    .version = "1.0.0",
+    .description = "in-process coreutils (enable -f coreutils)",
+    .author = "Michael Berry <trismegustis@gmail.com>",
+    .license = "MIT",
+    .required_permissions = LUSH_PLUGIN_PERM_REGISTER_BUILTIN |
+                            LUSH_PLUGIN_PERM_FILE_READ |
+                            LUSH_PLUGIN_PERM_FILE_WRITE |
+                            LUSH_PLUGIN_PERM_EXEC,
+    .init = coreutils_init,
+};
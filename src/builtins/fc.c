@@ -11,6 +11,9 @@
  * - fc -l [-nr] [first [last]]            # List commands
  * - fc -s [old=new] [first]               # Substitute and re-execute
  *
+ * Lush extension: -q QUERY restricts any mode to entries matching a
+ * structured history query (dir:, exit:, dur:, since:, ...).
+ *
  * @author Michael Berry
  * @version 2.0 (LLE-based implementation)
  */
@@ -44,6 +47,8 @@ typedef struct fc_options {
     int first;
     int last;
     bool range_valid;
+    bool query_set;
+    lle_history_query_t query;
 } fc_options_t;
 
 /* ============================================================================
@@ -331,7 +336,23 @@ static bool parse_range(lle_history_core_t *history, const char *first_str,
 
     size_t first_idx, last_idx;
 
-    if (!first_str) {
+    if (!first_str && opts->query_set) {
+        /* Query default: whole history for list, newest match otherwise */
+        if (opts->list_mode) {
+            first_idx = 0;
+            last_idx = count - 1;
+        } else {
+            size_t match = 0;
+            size_t found = 0;
+            if (lle_history_query_run(history, &opts->query, 1, &match,
+                                      &found) != LLE_SUCCESS ||
+                found == 0) {
+                fprintf(stderr, "fc: no command matches query\n");
+                return false;
+            }
+            first_idx = last_idx = match;
+        }
+    } else if (!first_str) {
         /* Default: last command for edit, last 16 for list */
         if (opts->list_mode) {
             first_idx = (count > 16) ? count - 16 : 0;
@@ -381,6 +402,67 @@ static bool parse_range(lle_history_core_t *history, const char *first_str,
  * ============================================================================
  */
 
+/**
+ * @brief Print one fc list line
+ *
+ * @param entry History entry
+ * @param index 0-based history index
+ * @param opts Options with display preferences
+ */
+static void fc_print_entry(const lle_history_entry_t *entry, size_t index,
+                           const fc_options_t *opts) {
+    if (opts->suppress_numbers) {
+        printf("%s\n", entry->command);
+    } else {
+        printf("%5zu  %s\n", index + 1, entry->command);
+    }
+}
+
+/**
+ * @brief List the entries in range that match the -q query
+ *
+ * Uses the history query indexes rather than testing every entry in the
+ * range.
+ *
+ * @param history The history core to query
+ * @param opts Options containing range, query and display preferences
+ * @return 0 on success, 1 on error
+ */
+static int fc_list_query(lle_history_core_t *history, fc_options_t *opts) {
+    size_t count = get_history_count(history);
+    size_t *positions = malloc(sizeof(size_t) * (count ? count : 1));
+    if (!positions) {
+        fprintf(stderr, "fc: memory allocation failed\n");
+        return 1;
+    }
+
+    size_t found = 0;
+    if (lle_history_query_run(history, &opts->query, count, positions,
+                              &found) != LLE_SUCCESS) {
+        free(positions);
+        fprintf(stderr, "fc: history query failed\n");
+        return 1;
+    }
+
+    /* Matches come newest first */
+    for (size_t n = 0; n < found; n++) {
+        size_t i = opts->reverse_order ? positions[n]
+                                       : positions[found - 1 - n];
+        if (i < (size_t)opts->first || i > (size_t)opts->last) {
+            continue;
+        }
+        lle_history_entry_t *entry = NULL;
+        if (lle_history_get_entry_by_index(history, i, &entry) ==
+                LLE_SUCCESS &&
+            entry && entry->command) {
+            fc_print_entry(entry, i, opts);
+        }
+    }
+
+    free(positions);
+    return 0;
+}
+
 /**
  * @brief List history entries with fc formatting
  *
@@ -397,17 +479,17 @@ static int fc_list(lle_history_core_t *history, fc_options_t *opts) {
         return 1;
     }
 
+    if (opts->query_set) {
+        return fc_list_query(history, opts);
+    }
+
     if (opts->reverse_order) {
         for (int i = opts->last; i >= opts->first; i--) {
             lle_history_entry_t *entry = NULL;
             if (lle_history_get_entry_by_index(history, (size_t)i, &entry) ==
                     LLE_SUCCESS &&
                 entry && entry->command) {
-                if (opts->suppress_numbers) {
-                    printf("%s\n", entry->command);
-                } else {
-                    printf("%5d  %s\n", i + 1, entry->command);
-                }
+                fc_print_entry(entry, (size_t)i, opts);
             }
         }
     } else {
@@ -416,11 +498,7 @@ static int fc_list(lle_history_core_t *history, fc_options_t *opts) {
             if (lle_history_get_entry_by_index(history, (size_t)i, &entry) ==
                     LLE_SUCCESS &&
                 entry && entry->command) {
-                if (opts->suppress_numbers) {
-                    printf("%s\n", entry->command);
-                } else {
-                    printf("%5d  %s\n", i + 1, entry->command);
-                }
+                fc_print_entry(entry, (size_t)i, opts);
             }
         }
     }
@@ -459,7 +537,9 @@ static int fc_edit(lle_history_core_t *history, fc_options_t *opts) {
         lle_history_entry_t *entry = NULL;
         if (lle_history_get_entry_by_index(history, (size_t)i, &entry) ==
                 LLE_SUCCESS &&
-            entry && entry->command) {
+            entry && entry->command &&
+            (!opts->query_set ||
+             lle_history_query_matches(&opts->query, entry))) {
             size_t cmd_len = strlen(entry->command);
 
             /* Ensure buffer capacity */
@@ -653,14 +733,16 @@ static int fc_substitute(lle_history_core_t *history, fc_options_t *opts) {
  * all options, modes, and range specifier formats.
  */
 static void fc_usage(void) {
-    fprintf(stderr, "usage: fc [-e editor] [-r] [first [last]]\n");
-    fprintf(stderr, "       fc -l [-nr] [first [last]]\n");
-    fprintf(stderr, "       fc -s [old=new] [first]\n");
+    fprintf(stderr, "usage: fc [-e editor] [-r] [-q query] [first [last]]\n");
+    fprintf(stderr, "       fc -l [-nr] [-q query] [first [last]]\n");
+    fprintf(stderr, "       fc -s [-q query] [old=new] [first]\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "options:\n");
     fprintf(stderr, "  -e editor  Use specified editor\n");
     fprintf(stderr, "  -l         List commands instead of editing\n");
     fprintf(stderr, "  -n         Suppress line numbers in list mode\n");
+    fprintf(stderr, "  -q query   Only commands matching query, e.g.\n");
+    fprintf(stderr, "             'exit:fail dir:. since:1w' or 'dur:>10s'\n");
     fprintf(stderr, "  -r         Reverse order (newest first)\n");
     fprintf(stderr, "  -s         Substitute old with new and re-execute\n");
     fprintf(stderr, "\n");
@@ -696,11 +778,23 @@ int bin_fc(int argc, char **argv) {
     /* Parse command line options */
     int opt;
     optind = 1; /* Reset getopt */
-    while ((opt = getopt(argc, argv, "e:lnrs")) != -1) {
+    while ((opt = getopt(argc, argv, "e:lnq:rs")) != -1) {
         switch (opt) {
         case 'e':
+            free(opts.editor);
             opts.editor = strdup(optarg);
             break;
+        case 'q': {
+            char error[256];
+            if (lle_history_query_parse(optarg, &opts.query, error,
+                                        sizeof(error)) != LLE_SUCCESS) {
+                fprintf(stderr, "fc: %s\n", error);
+                free(opts.editor);
+                return 1;
+            }
+            opts.query_set = true;
+            break;
+        }
         case 'l':
             opts.list_mode = true;
             break;
@@ -715,6 +809,7 @@ int bin_fc(int argc, char **argv) {
             break;
         default:
             fc_usage();
+            free(opts.editor);
             return 1;
         }
     }
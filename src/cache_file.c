@@ -0,0 +1,112 @@
+/**
+ * @file cache_file.c
+ * @brief Per-user cache directory lookup and atomic cache file writes
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "cache_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool cache_file_path(const char *name, char *buf, size_t size) {
+    if (!name || !buf || size == 0) {
+        return false;
+    }
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    int n;
+    if (xdg && xdg[0]) {
+        n = snprintf(buf, size, "%s/%s", xdg, name);
+    } else if (home && home[0]) {
+        n = snprintf(buf, size, "%s/.cache/%s", home, name);
+    } else {
+        return false;
+    }
+    return n > 0 && (size_t)n < size;
+}
+
+bool cache_file_make_dirs(const char *dir) {
+    char path[PATH_MAX];
+    int n = snprintf(path, sizeof(path), "%s", dir ? dir : "");
+    if (n <= 0 || (size_t)n >= sizeof(path)) {
+        return false;
+    }
+    for (char *p = path + 1; *p; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            if (mkdir(path, 0700) != 0 && errno != EEXIST) {
+                return false;
+            }
+            *p = '/';
+        }
+    }
+    return mkdir(path, 0700) == 0 || errno == EEXIST;
+}
+
+/**
+ * @brief Write all of a buffer, retrying short and interrupted writes
+ */
+static bool write_all(int fd, const void *data, size_t len) {
+    const unsigned char *p = data;
+    size_t written = 0;
+    while (written < len) {
+        ssize_t n = write(fd, p + written, len - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        written += (size_t)n;
+    }
+    return true;
+}
+
+bool cache_file_write(const char *path, const cache_file_part_t *parts,
+                      size_t count) {
+    char tmp[PATH_MAX];
+    int n = snprintf(tmp, sizeof(tmp), "%s", path ? path : "");
+    if (n <= 0 || (size_t)n >= sizeof(tmp)) {
+        return false;
+    }
+
+    char *slash = strrchr(tmp, '/');
+    if (slash && slash != tmp) {
+        *slash = '\0';
+        bool made = cache_file_make_dirs(tmp);
+        *slash = '/';
+        if (!made) {
+            return false;
+        }
+    }
+
+    /* mkstemp creates the file 0600 under a name no other writer uses */
+    n = snprintf(tmp, sizeof(tmp), "%s.XXXXXX", path);
+    if (n <= 0 || (size_t)n >= sizeof(tmp)) {
+        return false;
+    }
+    int fd = mkstemp(tmp);
+    if (fd < 0) {
+        return false;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    bool ok = true;
+    for (size_t i = 0; i < count && ok; i++) {
+        ok = write_all(fd, parts[i].data, parts[i].len);
+    }
+    if (close(fd) != 0 || !ok || rename(tmp, path) != 0) {
+        unlink(tmp);
+        return false;
+    }
+    return true;
+}
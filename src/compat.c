@@ -11,15 +11,20 @@
  */
 
 #include "compat.h"
+#include "cache_file.h"
+#include "ht.h"
 #include "toml_parser.h"
 #include "lle/unicode_compare.h"
 
 #include <dirent.h>
+#include <fcntl.h>
 #include <regex.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -49,12 +54,32 @@ int strcasecmp(const char *s1, const char *s2);
 /** @brief Local/alternate system data directory */
 #define COMPAT_LOCAL_SYSTEM_DIR "/usr/local/share/lush/compat"
 
+/** @brief Most data directories searched by compat_init() */
+#define COMPAT_MAX_SEARCH_DIRS 32
+
+/** @brief Cached database image, relative to the user cache directory */
+#define COMPAT_CACHE_FILE "lush/compat.cache"
+
+/** @brief Magic bytes at the start of a database image */
+#define COMPAT_IMAGE_MAGIC "LUSHCDB1"
+
+/** @brief Image layout version, bumped whenever the layout changes */
+#define COMPAT_IMAGE_VERSION 1
+
+/** @brief String offset standing for a missing field */
+#define COMPAT_NO_STRING UINT32_MAX
+
+/** @brief Displacement seeds tried per bucket before the table grows */
+#define COMPAT_HASH_SEED_TRIES 65536
+
 /* ============================================================================
  * Internal Structures
  * ============================================================================ */
 
 /**
- * @brief Internal entry storage with owned strings
+ * @brief Entry assembled while the TOML files are parsed
+ *
+ * Only lives until the binary image has been built from it.
  */
 typedef struct {
     char *id;
@@ -71,29 +96,158 @@ typedef struct {
     char *lint_pattern;
     compat_fix_class_t fix_class;  /**< Per-shell fix classification */
     char *fix_replacement;
-    regex_t *compiled_regex;
-    bool regex_valid;
 } internal_entry_t;
 
+/**
+ * @brief Entries collected from the TOML files
+ */
+typedef struct {
+    internal_entry_t *entries;
+    size_t count;
+    size_t capacity;
+    size_t last;  /**< Entry the previous key belonged to */
+} compat_build_t;
+
+/**
+ * @brief Header of the binary database image
+ *
+ * The image is one block: header, entry records, id hash seeds and slots,
+ * category member list, feature table, feature member list and string
+ * pool. Sections are addressed by offsets from the start of the image, so
+ * the image can be mapped read-only straight from the cache file.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t total_size;
+    uint64_t source_stamp;         /**< Stamp of the TOML files read */
+    uint32_t entry_count;
+    uint32_t entries_off;
+    uint32_t hash_buckets;         /**< Number of displacement seeds */
+    uint32_t hash_slots;           /**< Size of the slot table */
+    uint32_t seeds_off;
+    uint32_t slots_off;
+    uint32_t category_members_off; /**< Entry indices grouped by category */
+    uint32_t category_first[COMPAT_CATEGORY_COUNT];
+    uint32_t category_count[COMPAT_CATEGORY_COUNT];
+    uint32_t feature_count;
+    uint32_t features_off;         /**< Feature table sorted by name */
+    uint32_t feature_member_count;
+    uint32_t feature_members_off;  /**< Entry indices grouped by feature */
+    uint32_t strings_off;
+    uint32_t strings_size;
+} compat_image_header_t;
+
+/**
+ * @brief Entry record in the image; strings are string pool offsets
+ */
+typedef struct {
+    uint32_t id;
+    uint32_t feature;
+    uint32_t description;
+    uint32_t behavior[4];  /**< posix, bash, zsh, lush */
+    uint32_t message;
+    uint32_t suggestion;
+    uint32_t pattern;
+    uint32_t replacement;
+    uint8_t category;
+    uint8_t severity;
+    uint8_t fix[4];        /**< posix, bash, zsh, lush */
+    uint8_t reserved[2];
+} compat_image_entry_t;
+
+/**
+ * @brief Feature table row: a name and its run of feature members
+ */
+typedef struct {
+    uint32_t name;
+    uint32_t first;
+    uint32_t count;
+} compat_image_feature_t;
+
+/** @brief States of a lazily compiled pattern */
+enum { REGEX_UNTRIED, REGEX_READY, REGEX_INVALID };
+
+/**
+ * @brief Lint pattern of one entry, compiled on first use
+ */
+typedef struct {
+    regex_t regex;
+    unsigned char state;
+} compat_regex_t;
+
 /**
  * @brief Maximum length for target shell name
  */
 #define COMPAT_TARGET_MAX 32
 
+/** @brief Words in an entry bitmap */
+#define COMPAT_BITMAP_WORDS (COMPAT_MAX_ENTRIES / 64)
+
+/** @brief Longest required literal extracted from a pattern */
+#define COMPAT_LITERAL_MAX 64
+
+/**
+ * @brief Aho-Corasick trie node
+ *
+ * Children are kept as a sibling list; the root additionally has a direct
+ * 256-entry table since most transitions fall back to it.
+ */
+typedef struct {
+    int first_child;      /**< First child node, -1 if none */
+    int next_sibling;     /**< Next sibling node, -1 if none */
+    int fail;             /**< Failure link */
+    int dict;             /**< Nearest failure ancestor with output, -1 */
+    int output;           /**< First output link, -1 if none */
+    unsigned char byte;   /**< Edge label from parent */
+} ac_node_t;
+
+/**
+ * @brief Rule set compiled at load time
+ *
+ * Every entry with a pattern either has a required literal in the
+ * automaton, or is listed in always_check. Scanning a line once through
+ * the automaton yields the candidate entries; only those run their regex.
+ */
+typedef struct {
+    ac_node_t *nodes;
+    int node_count;
+    int root_next[256];          /**< Direct transitions from the root */
+    int *out_entry;              /**< Output link: entry index */
+    int *out_next;               /**< Output link: next link, -1 if none */
+    uint64_t always_check[COMPAT_BITMAP_WORDS]; /**< Entries without literal */
+    bool built;
+} compat_matcher_t;
+
 /**
  * @brief Database state
  */
 typedef struct {
     bool initialized;
-    internal_entry_t entries[COMPAT_MAX_ENTRIES];
+    const unsigned char *image;  /**< Read-only database image */
+    size_t image_size;
+    bool image_mapped;           /**< Image is mapped from the cache file */
+    bool from_cache;             /**< Cached image was current */
     size_t entry_count;
+    compat_regex_t *regexes;     /**< Per-entry patterns, compiled lazily */
+    size_t regexes_compiled;
     bool strict_mode;
     char target_shell[COMPAT_TARGET_MAX];  /**< Target shell name (string) */
     char data_dir[COMPAT_PATH_MAX];
+    compat_matcher_t matcher;  /**< Compiled lint rule set */
+    compat_entry_t public_entries[COMPAT_MAX_ENTRIES]; /**< Stable views */
+    uint64_t ruleset_hash;     /**< Hash of all loaded entries */
 } compat_state_t;
 
 static compat_state_t g_compat = {0};
 
+/** @brief Entries being parsed, empty outside compat_init() */
+static compat_build_t g_build = {0};
+
+/** @brief Cache file chosen with compat_set_cache_path() */
+static char g_cache_override[COMPAT_PATH_MAX];
+static bool g_cache_override_set = false;
+
 /* ============================================================================
  * String Tables
  * ============================================================================ */
@@ -148,58 +302,458 @@ static void free_internal_entry(internal_entry_t *entry) {
     free(entry->lint_pattern);
     free(entry->fix_replacement);
     
-    if (entry->compiled_regex && entry->regex_valid) {
-        regfree(entry->compiled_regex);
-        free(entry->compiled_regex);
-    }
-    
     memset(entry, 0, sizeof(*entry));
 }
 
 /**
- * @brief Convert internal entry to public entry
+ * @brief Get the image header
  */
-static void internal_to_public(const internal_entry_t *internal,
-                               compat_entry_t *public) {
-    public->id = internal->id;
-    public->category = internal->category;
-    public->feature = internal->feature;
-    public->description = internal->description;
-    public->behavior.posix = internal->behavior_posix;
-    public->behavior.bash = internal->behavior_bash;
-    public->behavior.zsh = internal->behavior_zsh;
-    public->behavior.lush = internal->behavior_lush;
-    public->lint.severity = internal->severity;
-    public->lint.message = internal->lint_message;
-    public->lint.suggestion = internal->lint_suggestion;
-    public->lint.pattern = internal->lint_pattern;
-    public->lint.fix = internal->fix_class;
-    public->lint.replacement = internal->fix_replacement;
+static const compat_image_header_t *image_header(void) {
+    return (const compat_image_header_t *)g_compat.image;
 }
 
 /**
- * @brief Compile regex pattern for an entry
+ * @brief Resolve a string pool offset
+ * @return The string, or NULL for COMPAT_NO_STRING
  */
-static void compile_entry_regex(internal_entry_t *entry) {
-    if (!entry->lint_pattern || entry->lint_pattern[0] == '\0') {
-        entry->regex_valid = false;
-        return;
+static const char *image_string(uint32_t offset) {
+    if (offset == COMPAT_NO_STRING) {
+        return NULL;
     }
-    
-    entry->compiled_regex = malloc(sizeof(regex_t));
-    if (!entry->compiled_regex) {
-        entry->regex_valid = false;
+    return (const char *)g_compat.image + image_header()->strings_off + offset;
+}
+
+/**
+ * @brief Get a section of the image as an array of 32-bit words
+ */
+static const uint32_t *image_words(uint32_t offset) {
+    return (const uint32_t *)(g_compat.image + offset);
+}
+
+/**
+ * @brief Fill the public view of an entry record
+ */
+static void image_to_public(const compat_image_entry_t *rec,
+                            compat_entry_t *public) {
+    public->id = image_string(rec->id);
+    public->category = (compat_category_t)rec->category;
+    public->feature = image_string(rec->feature);
+    public->description = image_string(rec->description);
+    public->behavior.posix = image_string(rec->behavior[0]);
+    public->behavior.bash = image_string(rec->behavior[1]);
+    public->behavior.zsh = image_string(rec->behavior[2]);
+    public->behavior.lush = image_string(rec->behavior[3]);
+    public->lint.severity = (compat_severity_t)rec->severity;
+    public->lint.message = image_string(rec->message);
+    public->lint.suggestion = image_string(rec->suggestion);
+    public->lint.pattern = image_string(rec->pattern);
+    public->lint.fix.posix = (fix_type_t)rec->fix[0];
+    public->lint.fix.bash = (fix_type_t)rec->fix[1];
+    public->lint.fix.zsh = (fix_type_t)rec->fix[2];
+    public->lint.fix.lush = (fix_type_t)rec->fix[3];
+    public->lint.replacement = image_string(rec->replacement);
+}
+
+/**
+ * @brief Check whether an entry has a lint pattern
+ */
+static bool entry_has_pattern(size_t index) {
+    const char *pattern = g_compat.public_entries[index].lint.pattern;
+    return pattern && pattern[0] != '\0';
+}
+
+/**
+ * @brief Get the compiled lint pattern of an entry
+ *
+ * Patterns are compiled the first time a line reaches them, so rules that
+ * never come into play cost nothing.
+ *
+ * @return Compiled pattern, or NULL if the entry has none or it is invalid
+ */
+static const regex_t *entry_regex(size_t index) {
+    if (!g_compat.regexes) {
+        return NULL;
+    }
+    compat_regex_t *r = &g_compat.regexes[index];
+    if (r->state == REGEX_UNTRIED) {
+        r->state = REGEX_INVALID;
+        /* Compiled with submatch support so fixes can use the match position */
+        if (entry_has_pattern(index) &&
+            regcomp(&r->regex, g_compat.public_entries[index].lint.pattern,
+                    REG_EXTENDED) == 0) {
+            r->state = REGEX_READY;
+            g_compat.regexes_compiled++;
+        }
+    }
+    return r->state == REGEX_READY ? &r->regex : NULL;
+}
+
+/* ============================================================================
+ * Compiled Rule Set
+ * ============================================================================ */
+
+/**
+ * @brief Check whether an escaped character stands for itself
+ *
+ * Punctuation escapes are literal; escaped letters, digits and the GNU
+ * anchors are classes, word boundaries or back-references (\s, \<, \1).
+ */
+static bool escape_is_literal(char c) {
+    return c != '\0' && strchr(".[]()|{}*+?^$\\/-\"&;!#%=,:@~", c);
+}
+
+/**
+ * @brief Append a run to the best literal if it is the longest so far
+ */
+static void commit_literal_run(const char *run, size_t run_len, char *best,
+                               size_t *best_len) {
+    if (run_len > *best_len) {
+        memcpy(best, run, run_len);
+        *best_len = run_len;
+    }
+}
+
+/**
+ * @brief Extract the longest literal that every match of a pattern contains
+ *
+ * Only literals outside groups and bracket expressions count, and a
+ * top-level alternation disables extraction. When in doubt no literal is
+ * returned and the entry is checked on every line.
+ *
+ * @param pattern POSIX extended regular expression
+ * @param out Buffer of COMPAT_LITERAL_MAX bytes for the literal
+ * @return Length of the literal, 0 if none
+ */
+static size_t extract_required_literal(const char *pattern, char *out) {
+    char run[COMPAT_LITERAL_MAX];
+    size_t run_len = 0;
+    size_t best_len = 0;
+    int depth = 0;
+    const char *p = pattern;
+
+    while (*p) {
+        int literal = -1;
+        const char *next = p + 1;
+
+        if (*p == '\\') {
+            if (p[1] == '\0') {
+                return 0;
+            }
+            if (escape_is_literal(p[1])) {
+                literal = (unsigned char)p[1];
+            }
+            next = p + 2;
+        } else if (*p == '[') {
+            const char *q = p + 1;
+            if (*q == '^') {
+                q++;
+            }
+            if (*q == ']') {
+                q++;
+            }
+            while (*q && *q != ']') {
+                if (*q == '[' && (q[1] == ':' || q[1] == '=' || q[1] == '.')) {
+                    const char *close = strchr(q + 2, ']');
+                    if (!close) {
+                        return 0;
+                    }
+                    q = close;
+                }
+                q++;
+            }
+            if (*q != ']') {
+                return 0;
+            }
+            next = q + 1;
+        } else if (*p == '(') {
+            depth++;
+        } else if (*p == ')') {
+            if (--depth < 0) {
+                return 0;
+            }
+        } else if (*p == '|') {
+            if (depth == 0) {
+                return 0;
+            }
+        } else if (*p == '{') {
+            const char *close = strchr(p, '}');
+            next = close ? close + 1 : p + 1;
+        } else if (!strchr(".^$*+?", *p)) {
+            literal = (unsigned char)*p;
+        }
+
+        /* A following quantifier makes the atom optional or repeated */
+        bool optional = (*next == '*' || *next == '?' || *next == '{');
+        bool repeated = (*next == '+');
+
+        if (literal < 0 || depth > 0 || optional) {
+            commit_literal_run(run, run_len, out, &best_len);
+            run_len = 0;
+        } else {
+            if (run_len == sizeof(run)) {
+                commit_literal_run(run, run_len, out, &best_len);
+                run_len = 0;
+            }
+            run[run_len++] = (char)literal;
+            if (repeated) {
+                commit_literal_run(run, run_len, out, &best_len);
+                run_len = 0;
+            }
+        }
+        p = next;
+    }
+
+    if (depth != 0) {
+        return 0;
+    }
+    commit_literal_run(run, run_len, out, &best_len);
+    return best_len;
+}
+
+/**
+ * @brief Free the compiled rule set
+ */
+static void matcher_free(compat_matcher_t *m) {
+    free(m->nodes);
+    free(m->out_entry);
+    free(m->out_next);
+    memset(m, 0, sizeof(*m));
+}
+
+/**
+ * @brief Find the child of a trie node labelled with a byte
+ * @return Child node index, or -1 if none
+ */
+static int matcher_child(const compat_matcher_t *m, int node,
+                         unsigned char byte) {
+    for (int c = m->nodes[node].first_child; c >= 0;
+         c = m->nodes[c].next_sibling) {
+        if (m->nodes[c].byte == byte) {
+            return c;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Follow the automaton from a state on one input byte
+ */
+static int matcher_step(const compat_matcher_t *m, int state,
+                        unsigned char byte) {
+    while (state != 0) {
+        int child = matcher_child(m, state, byte);
+        if (child >= 0) {
+            return child;
+        }
+        state = m->nodes[state].fail;
+    }
+    return m->root_next[byte];
+}
+
+/**
+ * @brief Mark an entry in a candidate bitmap
+ */
+static void bitmap_set(uint64_t *bitmap, size_t index) {
+    bitmap[index / 64] |= (uint64_t)1 << (index % 64);
+}
+
+/**
+ * @brief Test an entry in a candidate bitmap
+ */
+static bool bitmap_test(const uint64_t *bitmap, size_t index) {
+    return (bitmap[index / 64] >> (index % 64)) & 1;
+}
+
+/**
+ * @brief Insert a literal into the trie, growing the node array as needed
+ * @return Node at the end of the literal, or -1 on allocation failure
+ */
+static int matcher_insert(compat_matcher_t *m, int *capacity,
+                          const char *literal, size_t len) {
+    int state = 0;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char byte = (unsigned char)literal[i];
+        int child = matcher_child(m, state, byte);
+        if (child < 0) {
+            if (m->node_count == *capacity) {
+                int new_cap = *capacity * 2;
+                ac_node_t *grown =
+                    realloc(m->nodes, (size_t)new_cap * sizeof(ac_node_t));
+                if (!grown) {
+                    return -1;
+                }
+                m->nodes = grown;
+                *capacity = new_cap;
+            }
+            child = m->node_count++;
+            m->nodes[child] = (ac_node_t){
+                .first_child = -1,
+                .next_sibling = m->nodes[state].first_child,
+                .fail = 0,
+                .dict = -1,
+                .output = -1,
+                .byte = byte,
+            };
+            m->nodes[state].first_child = child;
+        }
+        state = child;
+    }
+    return state;
+}
+
+/**
+ * @brief Compute failure and dictionary links breadth-first
+ * @return true on success
+ */
+static bool matcher_link(compat_matcher_t *m) {
+    int *queue = malloc((size_t)m->node_count * sizeof(int));
+    if (!queue) {
+        return false;
+    }
+    int head = 0;
+    int tail = 0;
+
+    for (int c = m->nodes[0].first_child; c >= 0;
+         c = m->nodes[c].next_sibling) {
+        m->root_next[m->nodes[c].byte] = c;
+        queue[tail++] = c;
+    }
+
+    while (head < tail) {
+        int u = queue[head++];
+        for (int v = m->nodes[u].first_child; v >= 0;
+             v = m->nodes[v].next_sibling) {
+            int w = matcher_step(m, m->nodes[u].fail, m->nodes[v].byte);
+            m->nodes[v].fail = w;
+            m->nodes[v].dict =
+                m->nodes[w].output >= 0 ? w : m->nodes[w].dict;
+            queue[tail++] = v;
+        }
+    }
+
+    free(queue);
+    return true;
+}
+
+/**
+ * @brief Compile the lint rule set of all loaded entries
+ *
+ * Each entry's required literal goes into one Aho-Corasick automaton;
+ * entries without a usable literal are checked on every line. Patterns
+ * that fail to compile are only found out, and skipped, at scan time. If memory
+ * runs out, all entries fall back to being checked on every line.
+ */
+static void matcher_build(compat_matcher_t *m) {
+    matcher_free(m);
+
+    int capacity = 256;
+    m->nodes = malloc((size_t)capacity * sizeof(ac_node_t));
+    m->out_entry = malloc(COMPAT_MAX_ENTRIES * sizeof(int));
+    m->out_next = malloc(COMPAT_MAX_ENTRIES * sizeof(int));
+    if (!m->nodes || !m->out_entry || !m->out_next) {
+        goto fallback;
+    }
+    m->nodes[0] = (ac_node_t){-1, -1, 0, -1, -1, 0};
+    m->node_count = 1;
+
+    int out_count = 0;
+    for (size_t i = 0; i < g_compat.entry_count; i++) {
+        if (!entry_has_pattern(i)) {
+            continue;
+        }
+
+        char literal[COMPAT_LITERAL_MAX];
+        size_t len = extract_required_literal(
+            g_compat.public_entries[i].lint.pattern, literal);
+        if (len == 0) {
+            bitmap_set(m->always_check, i);
+            continue;
+        }
+
+        int node = matcher_insert(m, &capacity, literal, len);
+        if (node < 0) {
+            goto fallback;
+        }
+        m->out_entry[out_count] = (int)i;
+        m->out_next[out_count] = m->nodes[node].output;
+        m->nodes[node].output = out_count++;
+    }
+
+    if (!matcher_link(m)) {
+        goto fallback;
+    }
+    m->built = true;
+    return;
+
+fallback:
+    matcher_free(m);
+    for (size_t i = 0; i < g_compat.entry_count; i++) {
+        if (entry_has_pattern(i)) {
+            bitmap_set(m->always_check, i);
+        }
+    }
+}
+
+/**
+ * @brief Mix a string into a 64-bit FNV-1a hash
+ *
+ * The terminating NUL is hashed too so adjacent fields cannot run together.
+ */
+static uint64_t hash_field(uint64_t h, const char *s) {
+    s = s ? s : "";
+    return fnv1a_hash_bytes(s, strlen(s) + 1, h);
+}
+
+/**
+ * @brief Hash every field that influences lint and fix results
+ */
+static uint64_t compute_ruleset_hash(void) {
+    uint64_t h = FNV1A_OFFSET;
+    for (size_t i = 0; i < g_compat.entry_count; i++) {
+        const compat_entry_t *e = &g_compat.public_entries[i];
+        char numbers[64];
+        snprintf(numbers, sizeof(numbers), "%d %d %d %d %d %d %d",
+                 (int)e->category, (int)e->lint.severity,
+                 (int)e->lint.fix.posix, (int)e->lint.fix.bash,
+                 (int)e->lint.fix.zsh, (int)e->lint.fix.lush,
+                 entry_has_pattern(i));
+        h = hash_field(h, e->id);
+        h = hash_field(h, e->feature);
+        h = hash_field(h, e->behavior.posix);
+        h = hash_field(h, e->behavior.bash);
+        h = hash_field(h, e->behavior.zsh);
+        h = hash_field(h, e->behavior.lush);
+        h = hash_field(h, e->lint.message);
+        h = hash_field(h, e->lint.suggestion);
+        h = hash_field(h, e->lint.pattern);
+        h = hash_field(h, e->lint.replacement);
+        h = hash_field(h, numbers);
+    }
+    return h;
+}
+
+/**
+ * @brief Select the entries whose required literal occurs in a line
+ *
+ * @param line Line to scan
+ * @param candidates Output bitmap of COMPAT_BITMAP_WORDS words
+ */
+static void matcher_scan(const compat_matcher_t *m, const char *line,
+                         uint64_t *candidates) {
+    memcpy(candidates, m->always_check, sizeof(m->always_check));
+    if (!m->built) {
         return;
     }
-    
-    int ret = regcomp(entry->compiled_regex, entry->lint_pattern,
-                      REG_EXTENDED | REG_NOSUB);
-    if (ret != 0) {
-        free(entry->compiled_regex);
-        entry->compiled_regex = NULL;
-        entry->regex_valid = false;
-    } else {
-        entry->regex_valid = true;
+
+    int state = 0;
+    for (const unsigned char *p = (const unsigned char *)line; *p; p++) {
+        state = matcher_step(m, state, *p);
+        int node = m->nodes[state].output >= 0 ? state : m->nodes[state].dict;
+        for (; node >= 0; node = m->nodes[node].dict) {
+            for (int k = m->nodes[node].output; k >= 0; k = m->out_next[k]) {
+                bitmap_set(candidates, (size_t)m->out_entry[k]);
+            }
+        }
     }
 }
 
@@ -222,19 +776,37 @@ typedef struct {
  * @brief Find or create entry by ID
  */
 static internal_entry_t *find_or_create_entry(const char *id) {
+    /* Keys of one table arrive together: try the previous entry first */
+    if (g_build.last < g_build.count && g_build.entries[g_build.last].id &&
+        strcmp(g_build.entries[g_build.last].id, id) == 0) {
+        return &g_build.entries[g_build.last];
+    }
+
     /* Search existing */
-    for (size_t i = 0; i < g_compat.entry_count; i++) {
-        if (g_compat.entries[i].id && strcmp(g_compat.entries[i].id, id) == 0) {
-            return &g_compat.entries[i];
+    for (size_t i = 0; i < g_build.count; i++) {
+        if (g_build.entries[i].id && strcmp(g_build.entries[i].id, id) == 0) {
+            g_build.last = i;
+            return &g_build.entries[i];
         }
     }
     
     /* Create new */
-    if (g_compat.entry_count >= COMPAT_MAX_ENTRIES) {
+    if (g_build.count >= COMPAT_MAX_ENTRIES) {
         return NULL;
     }
+    if (g_build.count == g_build.capacity) {
+        size_t new_cap = g_build.capacity ? g_build.capacity * 2 : 256;
+        internal_entry_t *grown =
+            realloc(g_build.entries, new_cap * sizeof(internal_entry_t));
+        if (!grown) {
+            return NULL;
+        }
+        g_build.entries = grown;
+        g_build.capacity = new_cap;
+    }
     
-    internal_entry_t *entry = &g_compat.entries[g_compat.entry_count++];
+    g_build.last = g_build.count;
+    internal_entry_t *entry = &g_build.entries[g_build.count++];
     memset(entry, 0, sizeof(*entry));
     entry->id = safe_strdup(id);
     return entry;
@@ -412,15 +984,28 @@ static int load_toml_file(const char *path) {
 }
 
 /**
- * @brief Load all TOML files from a directory recursively
+ * @brief Mix a number into a 64-bit FNV-1a hash
+ */
+static uint64_t hash_number(uint64_t h, uint64_t value) {
+    return fnv1a_hash_bytes(&value, sizeof(value), h);
+}
+
+/**
+ * @brief Walk a directory tree for TOML files
+ *
+ * Every file's path, size, mtime and inode are mixed into @p stamp, so the
+ * stamp of all search directories changes whenever a data file does. With
+ * @p load set the files are also parsed.
+ *
+ * @return Number of TOML files seen (loaded, with @p load set)
  */
-static int load_directory(const char *dir_path) {
+static int scan_directory(const char *dir_path, uint64_t *stamp, bool load) {
     DIR *dir = opendir(dir_path);
     if (!dir) {
-        return -1;
+        return 0;
     }
     
-    int files_loaded = 0;
+    int files_seen = 0;
     struct dirent *entry;
     
     while ((entry = readdir(dir)) != NULL) {
@@ -438,20 +1023,651 @@ static int load_directory(const char *dir_path) {
         
         if (S_ISDIR(st.st_mode)) {
             /* Recurse into subdirectory */
-            files_loaded += load_directory(path);
+            files_seen += scan_directory(path, stamp, load);
         } else if (S_ISREG(st.st_mode)) {
             /* Check for .toml extension */
             size_t len = strlen(entry->d_name);
             if (len > 5 && strcmp(entry->d_name + len - 5, ".toml") == 0) {
-                if (load_toml_file(path) == 0) {
-                    files_loaded++;
+                *stamp = hash_field(*stamp, path);
+                *stamp = hash_number(*stamp, (uint64_t)st.st_size);
+                *stamp = hash_number(*stamp, (uint64_t)st.st_mtime);
+                *stamp = hash_number(*stamp, (uint64_t)st.st_ino);
+                if (!load || load_toml_file(path) == 0) {
+                    files_seen++;
                 }
             }
         }
     }
     
     closedir(dir);
-    return files_loaded;
+    return files_seen;
+}
+
+/* ============================================================================
+ * Binary Image
+ * ============================================================================ */
+
+/**
+ * @brief Growable buffer an image or its string pool is assembled in
+ */
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+    bool failed;
+} image_buf_t;
+
+/**
+ * @brief Append zeroed bytes at an 8-byte aligned offset
+ * @return Offset of the bytes (unusable once the buffer has failed)
+ */
+static uint32_t image_buf_reserve(image_buf_t *b, size_t len, size_t align) {
+    size_t offset = (b->size + align - 1) & ~(align - 1);
+    if (offset + len > b->capacity) {
+        size_t new_cap = b->capacity ? b->capacity : 4096;
+        while (offset + len > new_cap) {
+            new_cap *= 2;
+        }
+        unsigned char *grown = realloc(b->data, new_cap);
+        if (!grown || new_cap > UINT32_MAX) {
+            free(grown);
+            b->data = NULL;
+            b->failed = true;
+            b->size = b->capacity = 0;
+            return 0;
+        }
+        b->data = grown;
+        b->capacity = new_cap;
+    }
+    memset(b->data + b->size, 0, offset + len - b->size);
+    b->size = offset + len;
+    return (uint32_t)offset;
+}
+
+/**
+ * @brief Add a string to the string pool
+ * @return Pool offset, or COMPAT_NO_STRING for NULL
+ */
+static uint32_t image_buf_string(image_buf_t *pool, const char *s) {
+    if (!s) {
+        return COMPAT_NO_STRING;
+    }
+    size_t len = strlen(s) + 1;
+    uint32_t offset = image_buf_reserve(pool, len, 1);
+    if (pool->failed) {
+        return COMPAT_NO_STRING;
+    }
+    memcpy(pool->data + offset, s, len);
+    return offset;
+}
+
+/**
+ * @brief Hash an entry id with a seed
+ */
+static uint32_t id_hash(const char *id, uint32_t seed) {
+    uint64_t h = fnv1a_hash_str(
+        id, FNV1A_OFFSET ^ ((uint64_t)seed * 0x9e3779b97f4a7c15ULL));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return (uint32_t)h;
+}
+
+/**
+ * @brief Build a perfect hash of the entry ids
+ *
+ * Hash-and-displace: ids are split into buckets by one hash, then each
+ * bucket, largest first, gets the first seed that sends all its ids to
+ * free slots. A lookup costs two hashes and one string compare. If some
+ * bucket cannot be placed the slot table grows and placement restarts.
+ *
+ * @param buckets Output number of seeds
+ * @param slots Output size of the slot table
+ * @param seeds_out Output seed array (caller frees)
+ * @param table_out Output slot table of entry indices (caller frees)
+ * @return true on success
+ */
+static bool build_id_hash(const internal_entry_t *entries, size_t n,
+                          uint32_t *buckets, uint32_t *slots,
+                          uint32_t **seeds_out, uint32_t **table_out) {
+    uint32_t r = (uint32_t)(n / 4 + 1);
+    uint32_t m = (uint32_t)(n + n / 4 + 1);
+    uint32_t *bucket_of = malloc((n + 1) * sizeof(uint32_t));
+    uint32_t *bucket_size = calloc(r, sizeof(uint32_t));
+    uint32_t *bucket_start = calloc(r + 1, sizeof(uint32_t));
+    uint32_t *members = malloc((n + 1) * sizeof(uint32_t));
+    uint32_t *order = malloc(r * sizeof(uint32_t));
+    uint32_t *positions = malloc((n + 1) * sizeof(uint32_t));
+    uint32_t *seeds = calloc(r, sizeof(uint32_t));
+    uint32_t *table = NULL;
+    bool ok = false;
+
+    if (!bucket_of || !bucket_size || !bucket_start || !members || !order ||
+        !positions || !seeds) {
+        goto done;
+    }
+
+    /* Group entry indices by bucket */
+    for (size_t i = 0; i < n; i++) {
+        if (entries[i].id) {
+            bucket_of[i] = id_hash(entries[i].id, 0) % r;
+            bucket_size[bucket_of[i]]++;
+        }
+    }
+    for (uint32_t b = 0; b < r; b++) {
+        bucket_start[b + 1] = bucket_start[b] + bucket_size[b];
+    }
+    uint32_t *fill = positions; /* scratch cursor per bucket */
+    memcpy(fill, bucket_start, r * sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++) {
+        if (entries[i].id) {
+            members[fill[bucket_of[i]]++] = (uint32_t)i;
+        }
+    }
+
+    /* Largest buckets first: they are the hardest to place */
+    uint32_t placed = 0;
+    for (uint32_t size = (uint32_t)n; placed < r; size--) {
+        for (uint32_t b = 0; b < r; b++) {
+            if (bucket_size[b] == size) {
+                order[placed++] = b;
+            }
+        }
+        if (size == 0) {
+            break;
+        }
+    }
+
+    for (int attempt = 0; attempt < 16 && !ok; attempt++) {
+        free(table);
+        table = malloc(m * sizeof(uint32_t));
+        if (!table) {
+            goto done;
+        }
+        for (uint32_t s = 0; s < m; s++) {
+            table[s] = COMPAT_NO_STRING;
+        }
+
+        ok = true;
+        for (uint32_t k = 0; k < r && ok; k++) {
+            uint32_t b = order[k];
+            uint32_t size = bucket_size[b];
+            if (size == 0) {
+                seeds[b] = 0;
+                continue;
+            }
+            ok = false;
+            for (uint32_t seed = 1; seed < COMPAT_HASH_SEED_TRIES && !ok;
+                 seed++) {
+                ok = true;
+                for (uint32_t j = 0; j < size && ok; j++) {
+                    const char *id = entries[members[bucket_start[b] + j]].id;
+                    uint32_t pos = id_hash(id, seed) % m;
+                    ok = table[pos] == COMPAT_NO_STRING;
+                    for (uint32_t q = 0; q < j && ok; q++) {
+                        ok = positions[q] != pos;
+                    }
+                    positions[j] = pos;
+                }
+                if (ok) {
+                    seeds[b] = seed;
+                    for (uint32_t j = 0; j < size; j++) {
+                        table[positions[j]] = members[bucket_start[b] + j];
+                    }
+                }
+            }
+        }
+        if (!ok) {
+            m += m / 4 + 1;
+        }
+    }
+
+done:
+    free(bucket_of);
+    free(bucket_size);
+    free(bucket_start);
+    free(members);
+    free(order);
+    free(positions);
+    if (!ok) {
+        free(seeds);
+        free(table);
+        return false;
+    }
+    *buckets = r;
+    *slots = m;
+    *seeds_out = seeds;
+    *table_out = table;
+    return true;
+}
+
+/**
+ * @brief Feature name of an entry, for sorting
+ */
+typedef struct {
+    const char *name;
+    uint32_t index;
+} feature_key_t;
+
+/**
+ * @brief Order feature keys by name, then by entry index
+ */
+static int feature_key_compare(const void *a, const void *b) {
+    const feature_key_t *ka = a;
+    const feature_key_t *kb = b;
+    int cmp = strcmp(ka->name, kb->name);
+    if (cmp != 0) {
+        return cmp;
+    }
+    return ka->index < kb->index ? -1 : ka->index > kb->index;
+}
+
+/**
+ * @brief Serialise the parsed entries into a database image
+ *
+ * @param stamp Source stamp recorded in the header
+ * @param size Output image size
+ * @return Image (caller frees), or NULL on allocation failure
+ */
+static unsigned char *image_build(uint64_t stamp, size_t *size) {
+    const internal_entry_t *entries = g_build.entries;
+    size_t n = g_build.count;
+    image_buf_t img = {0};
+    image_buf_t pool = {0};
+    uint32_t *seeds = NULL;
+    uint32_t *table = NULL;
+    uint32_t buckets = 0;
+    uint32_t slots = 0;
+    feature_key_t *keys = malloc((n + 1) * sizeof(feature_key_t));
+
+    if (!keys || !build_id_hash(entries, n, &buckets, &slots, &seeds, &table)) {
+        goto fail;
+    }
+
+    /* Offset 0 of the pool is the empty string, so the pool is never empty */
+    image_buf_string(&pool, "");
+
+    uint32_t header_off = image_buf_reserve(&img, sizeof(compat_image_header_t), 8);
+    uint32_t entries_off =
+        image_buf_reserve(&img, n * sizeof(compat_image_entry_t), 8);
+    uint32_t seeds_off = image_buf_reserve(&img, buckets * sizeof(uint32_t), 8);
+    uint32_t slots_off = image_buf_reserve(&img, slots * sizeof(uint32_t), 8);
+    uint32_t category_off = image_buf_reserve(&img, n * sizeof(uint32_t), 8);
+    if (img.failed) {
+        goto fail;
+    }
+
+    compat_image_header_t hdr = {0};
+    memcpy(hdr.magic, COMPAT_IMAGE_MAGIC, sizeof(hdr.magic));
+    hdr.version = COMPAT_IMAGE_VERSION;
+    hdr.source_stamp = stamp;
+    hdr.entry_count = (uint32_t)n;
+    hdr.entries_off = entries_off;
+    hdr.hash_buckets = buckets;
+    hdr.hash_slots = slots;
+    hdr.seeds_off = seeds_off;
+    hdr.slots_off = slots_off;
+    hdr.category_members_off = category_off;
+
+    memcpy(img.data + seeds_off, seeds, buckets * sizeof(uint32_t));
+    memcpy(img.data + slots_off, table, slots * sizeof(uint32_t));
+
+    /* Entry records */
+    size_t key_count = 0;
+    for (size_t i = 0; i < n; i++) {
+        const internal_entry_t *e = &entries[i];
+        compat_image_entry_t rec = {0};
+        rec.id = image_buf_string(&pool, e->id);
+        rec.feature = image_buf_string(&pool, e->feature);
+        rec.description = image_buf_string(&pool, e->description);
+        rec.behavior[0] = image_buf_string(&pool, e->behavior_posix);
+        rec.behavior[1] = image_buf_string(&pool, e->behavior_bash);
+        rec.behavior[2] = image_buf_string(&pool, e->behavior_zsh);
+        rec.behavior[3] = image_buf_string(&pool, e->behavior_lush);
+        rec.message = image_buf_string(&pool, e->lint_message);
+        rec.suggestion = image_buf_string(&pool, e->lint_suggestion);
+        rec.pattern = image_buf_string(&pool, e->lint_pattern);
+        rec.replacement = image_buf_string(&pool, e->fix_replacement);
+        rec.category = (uint8_t)e->category;
+        rec.severity = (uint8_t)e->severity;
+        rec.fix[0] = (uint8_t)e->fix_class.posix;
+        rec.fix[1] = (uint8_t)e->fix_class.bash;
+        rec.fix[2] = (uint8_t)e->fix_class.zsh;
+        rec.fix[3] = (uint8_t)e->fix_class.lush;
+        memcpy(img.data + entries_off + i * sizeof(rec), &rec, sizeof(rec));
+
+        hdr.category_count[e->category]++;
+        if (e->feature) {
+            keys[key_count++] = (feature_key_t){e->feature, (uint32_t)i};
+        }
+    }
+
+    /* Category members: entry order within each category */
+    uint32_t *category_members = (uint32_t *)(img.data + category_off);
+    uint32_t cursor[COMPAT_CATEGORY_COUNT];
+    for (int c = 0, first = 0; c < COMPAT_CATEGORY_COUNT; c++) {
+        hdr.category_first[c] = (uint32_t)first;
+        cursor[c] = (uint32_t)first;
+        first += (int)hdr.category_count[c];
+    }
+    for (size_t i = 0; i < n; i++) {
+        category_members[cursor[entries[i].category]++] = (uint32_t)i;
+    }
+
+    /* Feature table sorted by name, members in entry order */
+    qsort(keys, key_count, sizeof(*keys), feature_key_compare);
+    size_t feature_count = 0;
+    for (size_t i = 0; i < key_count; i++) {
+        if (i == 0 || strcmp(keys[i].name, keys[i - 1].name) != 0) {
+            feature_count++;
+        }
+    }
+    uint32_t features_off =
+        image_buf_reserve(&img, feature_count * sizeof(compat_image_feature_t), 8);
+    uint32_t feature_members_off =
+        image_buf_reserve(&img, key_count * sizeof(uint32_t), 8);
+    if (img.failed) {
+        goto fail;
+    }
+    compat_image_feature_t *features =
+        (compat_image_feature_t *)(img.data + features_off);
+    uint32_t *feature_members = (uint32_t *)(img.data + feature_members_off);
+    size_t f = 0;
+    for (size_t i = 0; i < key_count; i++) {
+        if (i == 0 || strcmp(keys[i].name, keys[i - 1].name) != 0) {
+            features[f].name = image_buf_string(&pool, keys[i].name);
+            features[f].first = (uint32_t)i;
+            f++;
+        }
+        features[f - 1].count++;
+        feature_members[i] = keys[i].index;
+    }
+    hdr.feature_count = (uint32_t)feature_count;
+    hdr.features_off = features_off;
+    hdr.feature_member_count = (uint32_t)key_count;
+    hdr.feature_members_off = feature_members_off;
+
+    /* String pool last */
+    uint32_t strings_off = image_buf_reserve(&img, pool.size, 8);
+    if (img.failed || pool.failed) {
+        goto fail;
+    }
+    memcpy(img.data + strings_off, pool.data, pool.size);
+    hdr.strings_off = strings_off;
+    hdr.strings_size = (uint32_t)pool.size;
+    hdr.total_size = (uint32_t)img.size;
+    memcpy(img.data + header_off, &hdr, sizeof(hdr));
+
+    free(keys);
+    free(seeds);
+    free(table);
+    free(pool.data);
+    *size = img.size;
+    return img.data;
+
+fail:
+    free(keys);
+    free(seeds);
+    free(table);
+    free(pool.data);
+    free(img.data);
+    return NULL;
+}
+
+/**
+ * @brief Check that a section lies inside the image
+ */
+static bool section_ok(size_t image_size, uint32_t offset, size_t count,
+                       size_t elem_size) {
+    return offset % 4 == 0 && offset <= image_size &&
+           count <= (image_size - offset) / elem_size;
+}
+
+/**
+ * @brief Check that a string offset lies inside the pool
+ */
+static bool string_ok(const compat_image_header_t *hdr, uint32_t offset) {
+    return offset == COMPAT_NO_STRING || offset < hdr->strings_size;
+}
+
+/**
+ * @brief Validate an image before it is used
+ *
+ * A cache file may be truncated or left over from another version; every
+ * offset and index is checked so a bad file is rebuilt, never trusted.
+ */
+static bool image_validate(const unsigned char *image, size_t size) {
+    if (size < sizeof(compat_image_header_t)) {
+        return false;
+    }
+    const compat_image_header_t *hdr = (const compat_image_header_t *)image;
+    if (memcmp(hdr->magic, COMPAT_IMAGE_MAGIC, sizeof(hdr->magic)) != 0 ||
+        hdr->version != COMPAT_IMAGE_VERSION || hdr->total_size != size ||
+        hdr->entry_count > COMPAT_MAX_ENTRIES || hdr->hash_buckets == 0 ||
+        hdr->hash_slots == 0 || hdr->strings_size == 0) {
+        return false;
+    }
+    if (!section_ok(size, hdr->entries_off, hdr->entry_count,
+                    sizeof(compat_image_entry_t)) ||
+        !section_ok(size, hdr->seeds_off, hdr->hash_buckets, 4) ||
+        !section_ok(size, hdr->slots_off, hdr->hash_slots, 4) ||
+        !section_ok(size, hdr->category_members_off, hdr->entry_count, 4) ||
+        !section_ok(size, hdr->features_off, hdr->feature_count,
+                    sizeof(compat_image_feature_t)) ||
+        !section_ok(size, hdr->feature_members_off, hdr->feature_member_count,
+                    4) ||
+        !section_ok(size, hdr->strings_off, hdr->strings_size, 1) ||
+        image[hdr->strings_off + hdr->strings_size - 1] != '\0') {
+        return false;
+    }
+
+    const compat_image_entry_t *recs =
+        (const compat_image_entry_t *)(image + hdr->entries_off);
+    for (uint32_t i = 0; i < hdr->entry_count; i++) {
+        const compat_image_entry_t *r = &recs[i];
+        const uint32_t strings[] = {r->id, r->feature, r->description,
+                                    r->behavior[0], r->behavior[1],
+                                    r->behavior[2], r->behavior[3], r->message,
+                                    r->suggestion, r->pattern, r->replacement};
+        for (size_t k = 0; k < sizeof(strings) / sizeof(strings[0]); k++) {
+            if (!string_ok(hdr, strings[k])) {
+                return false;
+            }
+        }
+        if (r->category >= COMPAT_CATEGORY_COUNT ||
+            r->severity > COMPAT_SEVERITY_ERROR) {
+            return false;
+        }
+        for (int k = 0; k < 4; k++) {
+            if (r->fix[k] > FIX_TYPE_MANUAL) {
+                return false;
+            }
+        }
+    }
+
+    const uint32_t *slots = (const uint32_t *)(image + hdr->slots_off);
+    for (uint32_t i = 0; i < hdr->hash_slots; i++) {
+        if (slots[i] != COMPAT_NO_STRING && slots[i] >= hdr->entry_count) {
+            return false;
+        }
+    }
+    const uint32_t *members =
+        (const uint32_t *)(image + hdr->category_members_off);
+    uint32_t category_total = 0;
+    for (int c = 0; c < COMPAT_CATEGORY_COUNT; c++) {
+        if (hdr->category_first[c] > hdr->entry_count ||
+            hdr->category_count[c] >
+                hdr->entry_count - hdr->category_first[c]) {
+            return false;
+        }
+        category_total += hdr->category_count[c];
+    }
+    if (category_total != hdr->entry_count) {
+        return false;
+    }
+    for (uint32_t i = 0; i < hdr->entry_count; i++) {
+        if (members[i] >= hdr->entry_count) {
+            return false;
+        }
+    }
+    const compat_image_feature_t *features =
+        (const compat_image_feature_t *)(image + hdr->features_off);
+    for (uint32_t i = 0; i < hdr->feature_count; i++) {
+        if (features[i].name == COMPAT_NO_STRING ||
+            !string_ok(hdr, features[i].name) ||
+            features[i].first > hdr->feature_member_count ||
+            features[i].count > hdr->feature_member_count - features[i].first) {
+            return false;
+        }
+    }
+    members = (const uint32_t *)(image + hdr->feature_members_off);
+    for (uint32_t i = 0; i < hdr->feature_member_count; i++) {
+        if (members[i] >= hdr->entry_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Make an image the active database
+ *
+ * Takes ownership of the image: it is unmapped or freed by compat_cleanup().
+ */
+static bool image_attach(const unsigned char *image, size_t size,
+                         bool mapped) {
+    g_compat.image = image;
+    g_compat.image_size = size;
+    g_compat.image_mapped = mapped;
+
+    const compat_image_header_t *hdr = image_header();
+    const compat_image_entry_t *recs =
+        (const compat_image_entry_t *)(image + hdr->entries_off);
+    g_compat.entry_count = hdr->entry_count;
+    for (size_t i = 0; i < g_compat.entry_count; i++) {
+        image_to_public(&recs[i], &g_compat.public_entries[i]);
+    }
+    g_compat.regexes =
+        calloc(g_compat.entry_count ? g_compat.entry_count : 1,
+               sizeof(compat_regex_t));
+    return g_compat.regexes != NULL;
+}
+
+/**
+ * @brief Release the active image
+ */
+static void image_detach(void) {
+    if (g_compat.image_mapped) {
+        munmap((void *)g_compat.image, g_compat.image_size);
+    } else {
+        free((void *)g_compat.image);
+    }
+    g_compat.image = NULL;
+    g_compat.image_size = 0;
+}
+
+/**
+ * @brief Look up an entry by id through the perfect hash
+ * @return Entry index, or -1 if no entry has that id
+ */
+static long image_find_id(const char *id) {
+    const compat_image_header_t *hdr = image_header();
+    if (!hdr || hdr->entry_count == 0) {
+        return -1;
+    }
+    const uint32_t *seeds = image_words(hdr->seeds_off);
+    const uint32_t *slots = image_words(hdr->slots_off);
+    uint32_t seed = seeds[id_hash(id, 0) % hdr->hash_buckets];
+    uint32_t index = slots[id_hash(id, seed) % hdr->hash_slots];
+    if (index == COMPAT_NO_STRING) {
+        return -1;
+    }
+    const char *found = g_compat.public_entries[index].id;
+    return found && strcmp(found, id) == 0 ? (long)index : -1;
+}
+
+/**
+ * @brief Find a feature in the sorted feature table
+ * @return Table row, or NULL if no entry has that feature
+ */
+static const compat_image_feature_t *image_find_feature(const char *feature) {
+    const compat_image_header_t *hdr = image_header();
+    if (!hdr) {
+        return NULL;
+    }
+    const compat_image_feature_t *features =
+        (const compat_image_feature_t *)(g_compat.image + hdr->features_off);
+    size_t lo = 0;
+    size_t hi = hdr->feature_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp = strcmp(image_string(features[mid].name), feature);
+        if (cmp == 0) {
+            return &features[mid];
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ * Image Cache
+ * ============================================================================ */
+
+/**
+ * @brief Resolve the cache file path
+ * @return false if caching is disabled or no cache directory is known
+ */
+static bool cache_path(char *buf, size_t size) {
+    if (g_cache_override_set) {
+        snprintf(buf, size, "%s", g_cache_override);
+        return buf[0] != '\0';
+    }
+    return cache_file_path(COMPAT_CACHE_FILE, buf, size);
+}
+
+/**
+ * @brief Map a cached image if it was built from the current data files
+ * @return true if the image was attached
+ */
+static bool cache_load(const char *path, uint64_t stamp) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(compat_image_header_t)) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    const compat_image_header_t *hdr = map;
+    if (hdr->source_stamp != stamp || !image_validate(map, size)) {
+        munmap(map, size);
+        return false;
+    }
+    return image_attach(map, size, true);
+}
+
+/**
+ * @brief Write an image to the cache file
+ *
+ * Replaced atomically, so concurrent shells never map a partial image.
+ */
+static void cache_store(const char *path, const unsigned char *image,
+                        size_t size) {
+    const cache_file_part_t part = {image, size};
+    cache_file_write(path, &part, 1);
 }
 
 /* ============================================================================
@@ -459,19 +1675,18 @@ static int load_directory(const char *dir_path) {
  * ============================================================================ */
 
 /**
- * @brief Try to load compat data from a directory
- * @return Number of files loaded, or 0 if directory doesn't exist
+ * @brief Add a search directory if it exists
+ *
+ * Paths too long for a search slot are skipped rather than truncated.
  */
-static int try_load_from_dir(const char *dir) {
+static void add_search_dir(char dirs[][COMPAT_PATH_MAX], size_t *count,
+                           const char *dir) {
     struct stat st;
-    if (stat(dir, &st) == 0 && S_ISDIR(st.st_mode)) {
-        int loaded = load_directory(dir);
-        if (loaded > 0) {
-            snprintf(g_compat.data_dir, sizeof(g_compat.data_dir), "%s", dir);
-            return loaded;
-        }
+    size_t len = strlen(dir);
+    if (*count < COMPAT_MAX_SEARCH_DIRS && len < COMPAT_PATH_MAX &&
+        stat(dir, &st) == 0 && S_ISDIR(st.st_mode)) {
+        memcpy(dirs[(*count)++], dir, len + 1);
     }
-    return 0;
 }
 
 /**
@@ -498,33 +1713,19 @@ static bool get_exe_dir(char *buf, size_t size) {
     return false;
 }
 
-int compat_init(const char *data_dir) {
-    if (g_compat.initialized) {
-        return 0;
-    }
-    
-    /* Preserve target if it was set before init */
-    char saved_target[COMPAT_TARGET_MAX] = {0};
-    if (g_compat.target_shell[0] != '\0') {
-        snprintf(saved_target, sizeof(saved_target), "%s", g_compat.target_shell);
-    }
-    
-    memset(&g_compat, 0, sizeof(g_compat));
-    
-    /* Restore target or use default */
-    if (saved_target[0] != '\0') {
-        snprintf(g_compat.target_shell, sizeof(g_compat.target_shell), "%s", saved_target);
-    } else {
-        snprintf(g_compat.target_shell, sizeof(g_compat.target_shell), "%s", "posix");
-    }
-    
-    int total_loaded = 0;
+/**
+ * @brief Collect the data directories to load, in precedence order
+ * @return Number of existing directories found
+ */
+static size_t collect_search_dirs(const char *data_dir,
+                                  char dirs[][COMPAT_PATH_MAX]) {
+    size_t count = 0;
     char path_buf[COMPAT_PATH_MAX];
     
     /* If explicit path provided, use only that */
     if (data_dir && data_dir[0]) {
-        total_loaded = try_load_from_dir(data_dir);
-        goto finalize;
+        add_search_dir(dirs, &count, data_dir);
+        return count;
     }
     
     /*
@@ -541,14 +1742,14 @@ int compat_init(const char *data_dir) {
     const char *xdg_data_home = getenv("XDG_DATA_HOME");
     if (xdg_data_home && xdg_data_home[0]) {
         snprintf(path_buf, sizeof(path_buf), "%s/%s", xdg_data_home, COMPAT_SUBDIR);
-        total_loaded += try_load_from_dir(path_buf);
+        add_search_dir(dirs, &count, path_buf);
     } else {
         /* Default: ~/.local/share/lush/compat */
         const char *home = getenv("HOME");
         if (home && home[0]) {
             snprintf(path_buf, sizeof(path_buf), "%s/%s/%s", 
                      home, XDG_DATA_HOME_DEFAULT, COMPAT_SUBDIR);
-            total_loaded += try_load_from_dir(path_buf);
+            add_search_dir(dirs, &count, path_buf);
         }
     }
     
@@ -561,7 +1762,7 @@ int compat_init(const char *data_dir) {
             char *dir = strtok_r(dirs_copy, ":", &saveptr);
             while (dir) {
                 snprintf(path_buf, sizeof(path_buf), "%s/%s", dir, COMPAT_SUBDIR);
-                total_loaded += try_load_from_dir(path_buf);
+                add_search_dir(dirs, &count, path_buf);
                 dir = strtok_r(NULL, ":", &saveptr);
             }
             free(dirs_copy);
@@ -569,10 +1770,10 @@ int compat_init(const char *data_dir) {
     }
     
     /* 3. /usr/local/share/lush/compat */
-    total_loaded += try_load_from_dir(COMPAT_LOCAL_SYSTEM_DIR);
+    add_search_dir(dirs, &count, COMPAT_LOCAL_SYSTEM_DIR);
     
     /* 4. /usr/share/lush/compat */
-    total_loaded += try_load_from_dir(COMPAT_SYSTEM_DATA_DIR);
+    add_search_dir(dirs, &count, COMPAT_SYSTEM_DATA_DIR);
     
     /* 5. Relative to executable: ../share/lush/compat or ../data/compat */
     if (get_exe_dir(path_buf, sizeof(path_buf))) {
@@ -584,29 +1785,113 @@ int compat_init(const char *data_dir) {
         ret = snprintf(exe_relative, sizeof(exe_relative), "%s/../share/%s",
                        path_buf, COMPAT_SUBDIR);
         if (ret > 0 && (size_t)ret < sizeof(exe_relative))
-            total_loaded += try_load_from_dir(exe_relative);
+            add_search_dir(dirs, &count, exe_relative);
 
         /* Try ../data/compat (development layout) */
         ret = snprintf(exe_relative, sizeof(exe_relative), "%s/../data/compat",
                        path_buf);
         if (ret > 0 && (size_t)ret < sizeof(exe_relative))
-            total_loaded += try_load_from_dir(exe_relative);
+            add_search_dir(dirs, &count, exe_relative);
     }
     
     /* 6. CWD fallback: ./data/compat */
-    total_loaded += try_load_from_dir("./data/compat");
+    add_search_dir(dirs, &count, "./data/compat");
+    return count;
+}
 
-finalize:
-    /* Compile regex patterns for all loaded entries */
-    for (size_t i = 0; i < g_compat.entry_count; i++) {
-        compile_entry_regex(&g_compat.entries[i]);
+/**
+ * @brief Parse the data files and build a fresh image
+ * @return true if an image was attached
+ */
+static bool build_from_sources(char dirs[][COMPAT_PATH_MAX], size_t dir_count,
+                               uint64_t stamp, const char *cache_file) {
+    uint64_t ignored = 0;
+    for (size_t i = 0; i < dir_count; i++) {
+        scan_directory(dirs[i], &ignored, true);
+    }
+
+    size_t size = 0;
+    unsigned char *image = image_build(stamp, &size);
+    for (size_t i = 0; i < g_build.count; i++) {
+        free_internal_entry(&g_build.entries[i]);
+    }
+    free(g_build.entries);
+    memset(&g_build, 0, sizeof(g_build));
+
+    if (!image) {
+        return false;
+    }
+    if (cache_file) {
+        cache_store(cache_file, image, size);
+    }
+    return image_attach(image, size, false);
+}
+
+int compat_init(const char *data_dir) {
+    if (g_compat.initialized) {
+        return 0;
+    }
+    
+    /* Preserve target if it was set before init */
+    char saved_target[COMPAT_TARGET_MAX] = {0};
+    if (g_compat.target_shell[0] != '\0') {
+        snprintf(saved_target, sizeof(saved_target), "%s", g_compat.target_shell);
     }
     
+    memset(&g_compat, 0, sizeof(g_compat));
+    
+    /* Restore target or use default */
+    if (saved_target[0] != '\0') {
+        snprintf(g_compat.target_shell, sizeof(g_compat.target_shell), "%s", saved_target);
+    } else {
+        snprintf(g_compat.target_shell, sizeof(g_compat.target_shell), "%s", "posix");
+    }
+    
+    /* Stamp the data files; the last directory with any is the data dir.
+     * Without memory for the directory list no data files are loaded */
+    char (*dirs)[COMPAT_PATH_MAX] =
+        calloc(COMPAT_MAX_SEARCH_DIRS, sizeof(*dirs));
+    size_t dir_count = dirs ? collect_search_dirs(data_dir, dirs) : 0;
+    uint64_t stamp = hash_number(FNV1A_OFFSET, COMPAT_IMAGE_VERSION);
+    for (size_t i = 0; i < dir_count; i++) {
+        stamp = hash_field(stamp, dirs[i]);
+        if (scan_directory(dirs[i], &stamp, false) > 0) {
+            /* Both buffers are COMPAT_PATH_MAX bytes */
+            memcpy(g_compat.data_dir, dirs[i], strlen(dirs[i]) + 1);
+        }
+    }
+    
+    /* Map the cached image, or parse the TOML files and cache the result */
+    char cache_file[COMPAT_PATH_MAX];
+    bool cacheable = g_compat.data_dir[0] != '\0' &&
+                     cache_path(cache_file, sizeof(cache_file));
+    if (cacheable && cache_load(cache_file, stamp)) {
+        g_compat.from_cache = true;
+    } else {
+        if (g_compat.image) {
+            image_detach();
+        }
+        free(g_compat.regexes);
+        g_compat.regexes = NULL;
+        if (!build_from_sources(dirs, dir_count, stamp,
+                                cacheable ? cache_file : NULL)) {
+            /* Out of memory: operate with an empty database */
+            if (g_compat.image) {
+                image_detach();
+            }
+            g_compat.entry_count = 0;
+        }
+    }
+    
+    free(dirs);
+
+    matcher_build(&g_compat.matcher);
+    g_compat.ruleset_hash = compute_ruleset_hash();
+    
     g_compat.initialized = true;
     
     /* Always succeed on init, even if no data files are loaded.
      * The module can operate with defaults when no compat data exists. */
-    (void)total_loaded;
     return 0;
 }
 
@@ -615,9 +1900,18 @@ void compat_cleanup(void) {
         return;
     }
     
-    for (size_t i = 0; i < g_compat.entry_count; i++) {
-        free_internal_entry(&g_compat.entries[i]);
+    if (g_compat.regexes) {
+        for (size_t i = 0; i < g_compat.entry_count; i++) {
+            if (g_compat.regexes[i].state == REGEX_READY) {
+                regfree(&g_compat.regexes[i].regex);
+            }
+        }
+        free(g_compat.regexes);
     }
+    if (g_compat.image) {
+        image_detach();
+    }
+    matcher_free(&g_compat.matcher);
     
     memset(&g_compat, 0, sizeof(g_compat));
 }
@@ -630,6 +1924,16 @@ int compat_reload(void) {
     return compat_init(data_dir);
 }
 
+void compat_set_cache_path(const char *path) {
+    g_cache_override_set = path != NULL;
+    snprintf(g_cache_override, sizeof(g_cache_override), "%s",
+             path ? path : "");
+}
+
+bool compat_loaded_from_cache(void) {
+    return g_compat.from_cache;
+}
+
 /* ============================================================================
  * Public API - Entry Queries
  * ============================================================================ */
@@ -639,35 +1943,28 @@ const compat_entry_t *compat_get_entry(const char *id) {
         return NULL;
     }
     
-    static compat_entry_t result;
-    
-    for (size_t i = 0; i < g_compat.entry_count; i++) {
-        if (g_compat.entries[i].id &&
-            strcmp(g_compat.entries[i].id, id) == 0) {
-            internal_to_public(&g_compat.entries[i], &result);
-            return &result;
-        }
-    }
-    
-    return NULL;
+    long index = image_find_id(id);
+    return index >= 0 ? &g_compat.public_entries[index] : NULL;
 }
 
 size_t compat_get_by_category(compat_category_t category,
                               const compat_entry_t **entries,
                               size_t max_entries) {
-    if (!g_compat.initialized || !entries || max_entries == 0) {
+    if (!g_compat.initialized || !entries || max_entries == 0 ||
+        !g_compat.image || (int)category < 0 ||
+        category >= COMPAT_CATEGORY_COUNT) {
         return 0;
     }
     
-    static compat_entry_t results[COMPAT_MAX_ENTRIES];
-    size_t count = 0;
-    
-    for (size_t i = 0; i < g_compat.entry_count && count < max_entries; i++) {
-        if (g_compat.entries[i].category == category) {
-            internal_to_public(&g_compat.entries[i], &results[count]);
-            entries[count] = &results[count];
-            count++;
-        }
+    const compat_image_header_t *hdr = image_header();
+    const uint32_t *members =
+        image_words(hdr->category_members_off) + hdr->category_first[category];
+    size_t count = hdr->category_count[category];
+    if (count > max_entries) {
+        count = max_entries;
+    }
+    for (size_t i = 0; i < count; i++) {
+        entries[i] = &g_compat.public_entries[members[i]];
     }
     
     return count;
@@ -680,16 +1977,15 @@ size_t compat_get_by_feature(const char *feature,
         return 0;
     }
     
-    static compat_entry_t results[COMPAT_MAX_ENTRIES];
-    size_t count = 0;
-    
-    for (size_t i = 0; i < g_compat.entry_count && count < max_entries; i++) {
-        if (g_compat.entries[i].feature &&
-            strcmp(g_compat.entries[i].feature, feature) == 0) {
-            internal_to_public(&g_compat.entries[i], &results[count]);
-            entries[count] = &results[count];
-            count++;
-        }
+    const compat_image_feature_t *row = image_find_feature(feature);
+    if (!row) {
+        return 0;
+    }
+    const uint32_t *members =
+        image_words(image_header()->feature_members_off) + row->first;
+    size_t count = row->count < max_entries ? row->count : max_entries;
+    for (size_t i = 0; i < count; i++) {
+        entries[i] = &g_compat.public_entries[members[i]];
     }
     
     return count;
@@ -698,23 +1994,27 @@ size_t compat_get_by_feature(const char *feature,
 /**
  * @brief Get first entry matching a feature (for single lookups)
  *
- * Returns a pointer to a static entry that is valid until the next call.
- * Use this for single lookups to avoid the static array reuse issue in
- * compat_get_by_feature.
+ * An exact name is found in the feature table; otherwise names are
+ * compared after Unicode normalization.
  */
 const compat_entry_t *compat_get_first_by_feature(const char *feature) {
     if (!g_compat.initialized || !feature) {
         return NULL;
     }
     
-    static compat_entry_t result;
+    const compat_image_feature_t *row = image_find_feature(feature);
+    if (row) {
+        const uint32_t *members =
+            image_words(image_header()->feature_members_off);
+        return &g_compat.public_entries[members[row->first]];
+    }
     
     for (size_t i = 0; i < g_compat.entry_count; i++) {
-        if (g_compat.entries[i].feature &&
-            lle_unicode_strings_equal(g_compat.entries[i].feature, feature,
+        const compat_entry_t *entry = &g_compat.public_entries[i];
+        if (entry->feature &&
+            lle_unicode_strings_equal(entry->feature, feature,
                                       &LLE_UNICODE_COMPARE_DEFAULT)) {
-            internal_to_public(&g_compat.entries[i], &result);
-            return &result;
+            return entry;
         }
     }
     
@@ -725,6 +2025,10 @@ size_t compat_get_entry_count(void) {
     return g_compat.entry_count;
 }
 
+uint64_t compat_ruleset_hash(void) {
+    return g_compat.ruleset_hash;
+}
+
 void compat_foreach_entry(void (*callback)(const compat_entry_t *entry,
                                            void *user_data),
                           void *user_data) {
@@ -732,14 +2036,43 @@ void compat_foreach_entry(void (*callback)(const compat_entry_t *entry,
         return;
     }
     
-    compat_entry_t public_entry;
-    
     for (size_t i = 0; i < g_compat.entry_count; i++) {
-        internal_to_public(&g_compat.entries[i], &public_entry);
-        callback(&public_entry, user_data);
+        callback(&g_compat.public_entries[i], user_data);
     }
 }
 
+size_t compat_foreach_match(const char *line,
+                            void (*callback)(const compat_entry_t *entry,
+                                             size_t match_start,
+                                             size_t match_length,
+                                             void *user_data),
+                            void *user_data) {
+    if (!g_compat.initialized || !line || !callback) {
+        return 0;
+    }
+
+    uint64_t candidates[COMPAT_BITMAP_WORDS];
+    matcher_scan(&g_compat.matcher, line, candidates);
+
+    size_t matched = 0;
+
+    for (size_t i = 0; i < g_compat.entry_count; i++) {
+        if (!bitmap_test(candidates, i)) {
+            continue;
+        }
+        const regex_t *regex = entry_regex(i);
+        regmatch_t match;
+        if (!regex || regexec(regex, line, 1, &match, 0) != 0) {
+            continue;
+        }
+        callback(&g_compat.public_entries[i], (size_t)match.rm_so,
+                 (size_t)(match.rm_eo - match.rm_so), user_data);
+        matched++;
+    }
+
+    return matched;
+}
+
 /* ============================================================================
  * Public API - Portability Checking
  * ============================================================================ */
@@ -750,42 +2083,43 @@ bool compat_is_portable(const char *construct, shell_mode_t target,
         return true;
     }
     
-    /* Check against all entries with patterns */
+    /* Only entries whose required literal occurs need their regex run */
+    uint64_t candidates[COMPAT_BITMAP_WORDS];
+    matcher_scan(&g_compat.matcher, construct, candidates);
+    
     for (size_t i = 0; i < g_compat.entry_count; i++) {
-        internal_entry_t *entry = &g_compat.entries[i];
-        
-        if (!entry->regex_valid || !entry->compiled_regex) {
+        if (!bitmap_test(candidates, i)) {
             continue;
         }
+        const compat_entry_t *entry = &g_compat.public_entries[i];
+        const regex_t *regex = entry_regex(i);
         
-        if (regexec(entry->compiled_regex, construct, 0, NULL, 0) == 0) {
+        if (regex && regexec(regex, construct, 0, NULL, 0) == 0) {
             /* Pattern matched - check if it's an issue for target */
             const char *target_behavior = NULL;
             switch (target) {
             case SHELL_MODE_POSIX:
-                target_behavior = entry->behavior_posix;
+                target_behavior = entry->behavior.posix;
                 break;
             case SHELL_MODE_BASH:
-                target_behavior = entry->behavior_bash;
+                target_behavior = entry->behavior.bash;
                 break;
             case SHELL_MODE_ZSH:
-                target_behavior = entry->behavior_zsh;
+                target_behavior = entry->behavior.zsh;
                 break;
             case SHELL_MODE_LUSH:
-                target_behavior = entry->behavior_lush;
+                target_behavior = entry->behavior.lush;
                 break;
             default:
                 break;
             }
             
             /* If behavior differs from lush default, it's a portability issue */
-            if (target_behavior && entry->behavior_lush &&
-                strcmp(target_behavior, entry->behavior_lush) != 0) {
+            if (target_behavior && entry->behavior.lush &&
+                strcmp(target_behavior, entry->behavior.lush) != 0) {
                 if (result) {
                     result->is_portable = false;
-                    static compat_entry_t public_entry;
-                    internal_to_public(entry, &public_entry);
-                    result->entry = &public_entry;
+                    result->entry = entry;
                     result->target = target;
                     result->line = 0;
                     result->column = 0;
@@ -833,19 +2167,19 @@ static bool behavior_indicates_unavailable(const char *behavior) {
  *
  * Maps target shell name to the corresponding behavior field.
  */
-static const char *get_behavior_for_target(const internal_entry_t *entry,
+static const char *get_behavior_for_target(const compat_entry_t *entry,
                                             const char *target) {
     if (!target || strcasecmp(target, "posix") == 0 || strcasecmp(target, "sh") == 0) {
-        return entry->behavior_posix;
+        return entry->behavior.posix;
     } else if (strcasecmp(target, "bash") == 0) {
-        return entry->behavior_bash;
+        return entry->behavior.bash;
     } else if (strcasecmp(target, "zsh") == 0) {
-        return entry->behavior_zsh;
+        return entry->behavior.zsh;
     } else if (strcasecmp(target, "lush") == 0) {
-        return entry->behavior_lush;
+        return entry->behavior.lush;
     }
     /* Unknown target, default to POSIX (most conservative) */
-    return entry->behavior_posix;
+    return entry->behavior.posix;
 }
 
 /**
@@ -854,7 +2188,7 @@ static const char *get_behavior_for_target(const internal_entry_t *entry,
  * Returns true if the entry describes a portability issue for the target.
  * If the feature works in the target shell, it's not a problem.
  */
-static bool is_issue_for_target(const internal_entry_t *entry,
+static bool is_issue_for_target(const compat_entry_t *entry,
                                  const char *target) {
     const char *target_behavior = get_behavior_for_target(entry, target);
     
@@ -873,24 +2207,24 @@ size_t compat_check_line(const char *line, shell_mode_t target,
     
     size_t found = 0;
     
+    uint64_t candidates[COMPAT_BITMAP_WORDS];
+    matcher_scan(&g_compat.matcher, line, candidates);
+    
     for (size_t i = 0; i < g_compat.entry_count && found < max_results; i++) {
-        internal_entry_t *entry = &g_compat.entries[i];
-        
-        if (!entry->regex_valid || !entry->compiled_regex) {
+        if (!bitmap_test(candidates, i)) {
             continue;
         }
+        const compat_entry_t *entry = &g_compat.public_entries[i];
         
         /* Skip if this isn't an issue for the target shell */
         if (!is_issue_for_target(entry, target_name)) {
             continue;
         }
         
-        if (regexec(entry->compiled_regex, line, 0, NULL, 0) == 0) {
-            static compat_entry_t public_entries[COMPAT_MAX_ENTRIES];
-            internal_to_public(entry, &public_entries[found]);
-            
+        const regex_t *regex = entry_regex(i);
+        if (regex && regexec(regex, line, 0, NULL, 0) == 0) {
             results[found].is_portable = false;
-            results[found].entry = &public_entries[found];
+            results[found].entry = entry;
             results[found].target = target;
             results[found].line = 0;
             results[found].column = 0;
@@ -913,6 +2247,10 @@ size_t compat_check_script(const char *script, shell_mode_t target,
     const char *line_start = script;
     const char *line_end;
     
+    /* One buffer reused for every line, grown only for longer lines */
+    char *line = NULL;
+    size_t line_cap = 0;
+    
     while (*line_start && found < max_results) {
         line_end = strchr(line_start, '\n');
         if (!line_end) {
@@ -921,9 +2259,13 @@ size_t compat_check_script(const char *script, shell_mode_t target,
         
         /* Extract line */
         size_t line_len = (size_t)(line_end - line_start);
-        char *line = malloc(line_len + 1);
-        if (!line) {
-            break;
+        if (line_len + 1 > line_cap) {
+            char *grown = realloc(line, line_len + 1);
+            if (!grown) {
+                break;
+            }
+            line = grown;
+            line_cap = line_len + 1;
         }
         memcpy(line, line_start, line_len);
         line[line_len] = '\0';
@@ -939,12 +2281,12 @@ size_t compat_check_script(const char *script, shell_mode_t target,
         }
         
         found += line_found;
-        free(line);
         
         line_num++;
         line_start = (*line_end) ? line_end + 1 : line_end;
     }
     
+    free(line);
     return found;
 }
 
@@ -1126,24 +2468,20 @@ static size_t compat_collect_ast_issues(node_t *node, shell_mode_t target,
                 issue->column = (int)node->loc.column;
                 issue->feature = ast_feature_map[i].feature;
                 
-                /* Find the entry in the internal database (stable pointers) */
+                /* Find the entry in the database (stable pointers) */
                 issue->severity = "warning";
                 issue->message = "Non-portable construct";
                 issue->suggestion = NULL;
                 
-                for (size_t j = 0; j < g_compat.entry_count; j++) {
-                    if (g_compat.entries[j].feature &&
-                        lle_unicode_strings_equal(g_compat.entries[j].feature, 
-                                                  ast_feature_map[i].feature,
-                                                  &LLE_UNICODE_COMPARE_DEFAULT)) {
-                        issue->severity = compat_severity_name(
-                            g_compat.entries[j].severity);
-                        if (g_compat.entries[j].lint_message) {
-                            issue->message = g_compat.entries[j].lint_message;
-                        }
-                        issue->suggestion = g_compat.entries[j].lint_suggestion;
-                        break;
+                const compat_entry_t *entry =
+                    compat_get_first_by_feature(ast_feature_map[i].feature);
+                if (entry) {
+                    issue->severity =
+                        compat_severity_name(entry->lint.severity);
+                    if (entry->lint.message) {
+                        issue->message = entry->lint.message;
                     }
+                    issue->suggestion = entry->lint.suggestion;
                 }
                 
                 found++;
@@ -1365,13 +2703,17 @@ void compat_debug_print_stats(void) {
     size_t with_pattern = 0;
     
     for (size_t i = 0; i < g_compat.entry_count; i++) {
-        by_category[g_compat.entries[i].category]++;
-        if (g_compat.entries[i].regex_valid) {
+        by_category[g_compat.public_entries[i].category]++;
+        if (entry_has_pattern(i)) {
             with_pattern++;
         }
     }
     
-    fprintf(stderr, "  Entries with valid patterns: %zu\n", with_pattern);
+    fprintf(stderr, "  Loaded from: %s\n",
+            g_compat.from_cache ? "cached image" : "TOML files");
+    fprintf(stderr, "  Image size: %zu bytes\n", g_compat.image_size);
+    fprintf(stderr, "  Entries with patterns: %zu (%zu compiled)\n",
+            with_pattern, g_compat.regexes_compiled);
     fprintf(stderr, "  By category:\n");
     for (int i = 0; i < COMPAT_CATEGORY_COUNT; i++) {
         fprintf(stderr, "    %s: %zu\n", category_names[i], by_category[i]);
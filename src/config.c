@@ -21,6 +21,8 @@
 #include "lle/unicode_compare.h"
 #include "lush.h"
 #include "shell_mode.h"
+#include "startup_cache.h"
+#include "startup_profile.h"
 #include "symtable.h"
 
 #include <ctype.h>
@@ -190,6 +192,9 @@ static config_option_t config_options[] = {
     {"lle.show_multiline_indicators", CONFIG_TYPE_BOOL, CONFIG_SECTION_HISTORY,
      &config.lle_show_multiline_indicators,
      "Show visual indicators for multiline", config_validate_bool, NULL},
+    {"lle.auto_indent", CONFIG_TYPE_BOOL, CONFIG_SECTION_HISTORY,
+     &config.lle_auto_indent, "Indent continuation lines by block depth",
+     config_validate_bool, NULL},
     {"lle.enable_interactive_search", CONFIG_TYPE_BOOL, CONFIG_SECTION_HISTORY,
      &config.lle_enable_interactive_search, "Enable Ctrl-R interactive search",
      config_validate_bool, NULL},
@@ -1308,13 +1313,16 @@ int config_execute_script_file(const char *path) {
     if (!file) {
         return -1;
     }
+    startup_file_begin(path);
 
     // Track source depth so 'return' builtin works correctly in sourced scripts
     // Use get_global_executor() since parse_and_execute uses global_executor
     executor_t *executor = get_global_executor();
     bool saved_source_return = false;
     const char *saved_script_file = NULL;
+    int saved_script_line = 1;
     if (executor) {
+        saved_script_line = executor->script_line_base;
         saved_source_return = executor->source_return;
         saved_script_file = executor_get_current_script_file(executor);
         if (saved_script_file) {
@@ -1328,27 +1336,28 @@ int config_execute_script_file(const char *path) {
 
     char *complete_input;
     int result = 0;
-    int construct_number = 1;
+    int line_number = 1;
 
     // Read complete multi-line constructs (same as bin_source)
-    while ((complete_input = get_input_complete(file)) != NULL) {
+    startup_script_t *script = startup_script_open(path, file);
+    while ((complete_input = startup_script_read(script)) != NULL) {
         // Skip empty constructs
         char *trimmed = complete_input;
         while (*trimmed == ' ' || *trimmed == '\t' || *trimmed == '\n')
             trimmed++;
         if (*trimmed == '\0') {
+            line_number += get_input_line_count(complete_input);
             free(complete_input);
-            construct_number++;
             continue;
         }
 
         // Update script context line number for debugging
         if (executor) {
-            executor_set_script_context(executor, path, construct_number);
+            executor_set_script_context(executor, path, line_number);
         }
 
-        // Parse and execute the complete construct
-        int construct_result = parse_and_execute(complete_input);
+        // Parse and execute the complete construct (or run its cached tree)
+        int construct_result = startup_script_execute(script, complete_input);
 
         // Check for return from sourced script (exit code 200+)
         // This matches how bin_source handles the special return code
@@ -1365,24 +1374,27 @@ int config_execute_script_file(const char *path) {
             result = construct_result;
         }
 
+        line_number += get_input_line_count(complete_input);
         free(complete_input);
-        construct_number++;
 
         // Check if 'return' was called in the sourced script
         if (executor && executor->source_return) {
             break;
         }
     }
+    startup_script_close(script);
 
     // Restore source depth, source_return state, and script context
     if (executor) {
         executor->source_depth--;
         executor->source_return = saved_source_return;
-        executor_set_script_context(executor, saved_script_file, 1);
+        executor_set_script_context(executor, saved_script_file,
+                                    saved_script_line);
         free((char *)saved_script_file);
     }
 
     fclose(file);
+    startup_file_end();
     return result;
 }
 
@@ -1596,6 +1608,9 @@ const char *CONFIG_FILE_TEMPLATE =
     "# Show visual indicators for multiline input\n"
     "lle.show_multiline_indicators = true\n"
     "\n"
+    "# Indent continuation lines by block depth\n"
+    "lle.auto_indent = false\n"
+    "\n"
     "# Enable Ctrl-R interactive history search\n"
     "lle.enable_interactive_search = true\n"
     "\n"
@@ -2024,6 +2039,7 @@ void config_set_defaults(void) {
     config.lle_preserve_multiline_structure = true;
     config.lle_enable_multiline_editing = true;
     config.lle_show_multiline_indicators = true;
+    config.lle_auto_indent = false;
     config.lle_enable_interactive_search = true;
     config.lle_search_fuzzy_matching = false;
     config.lle_search_case_sensitive = false;
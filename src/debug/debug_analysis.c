@@ -16,6 +16,7 @@
 #include "fixer.h"
 #include "node.h"
 #include "parser.h"
+#include "spawn_cost.h"
 #include "tokenizer.h"
 #include "lle/unicode_compare.h"
 
@@ -33,6 +34,8 @@ static void debug_analyze_style(debug_context_t *ctx, const char *file,
                                 const char *content);
 static void debug_analyze_performance(debug_context_t *ctx, const char *file,
                                       const char *content);
+static void debug_analyze_spawns(debug_context_t *ctx, const char *file,
+                                 const char *content, node_t *ast);
 static void debug_analyze_security(debug_context_t *ctx, const char *file,
                                    const char *content);
 static void debug_analyze_portability(debug_context_t *ctx, const char *file,
@@ -88,6 +91,7 @@ void debug_analyze_script(debug_context_t *ctx, const char *script_path) {
     node_t *ast = debug_analyze_syntax(ctx, script_path, script_content);
     debug_analyze_style(ctx, script_path, script_content);
     debug_analyze_performance(ctx, script_path, script_content);
+    debug_analyze_spawns(ctx, script_path, script_content, ast);
     debug_analyze_security(ctx, script_path, script_content);
     debug_analyze_portability(ctx, script_path, script_content, ast);
 
@@ -293,6 +297,84 @@ static void debug_analyze_performance(debug_context_t *ctx, const char *file,
     }
 }
 
+/**
+ * @brief Analyze script for process-spawning idioms
+ * @param ctx Debug context
+ * @param file File path being analyzed
+ * @param content Script content to analyze
+ * @param ast Parsed AST (may be NULL if parsing failed)
+ *
+ * Reports each idiom that forks to do something the shell can do itself,
+ * as a warning inside loops and as info elsewhere, and each function's
+ * estimated spawns per call against the spawn budget.
+ */
+static void debug_analyze_spawns(debug_context_t *ctx, const char *file,
+                                 const char *content, node_t *ast) {
+    if (!ctx || !file || !content || !ast) {
+        return;
+    }
+
+    shell_mode_t target = SHELL_MODE_POSIX;
+    const char *target_str = compat_get_target();
+    if (target_str) {
+        shell_mode_parse(target_str, &target);
+    }
+
+    spawn_report_t report;
+    if (!spawn_analyze(content, ast, target, &report)) {
+        return;
+    }
+
+    char message[256];
+    char suggestion[256];
+
+    for (size_t i = 0; i < report.site_count; i++) {
+        const spawn_site_t *site = &report.sites[i];
+        if (site->loop_depth > 0) {
+            snprintf(message, sizeof(message),
+                     "%s (%u process%s per iteration, loop depth %u)",
+                     spawn_idiom_message(site->idiom), site->spawns,
+                     site->spawns == 1 ? "" : "es", site->loop_depth);
+        } else {
+            snprintf(message, sizeof(message), "%s (%u process%s)",
+                     spawn_idiom_message(site->idiom), site->spawns,
+                     site->spawns == 1 ? "" : "es");
+        }
+        if (site->replacement) {
+            snprintf(suggestion, sizeof(suggestion), "Use %s",
+                     site->replacement);
+        } else {
+            snprintf(suggestion, sizeof(suggestion), "%s",
+                     spawn_idiom_suggestion(site->idiom));
+        }
+        debug_add_analysis_issue(ctx, file, site->line > 0 ? site->line : 1,
+                                 site->loop_depth > 0 ? "warning" : "info",
+                                 "performance", message, suggestion);
+    }
+
+    unsigned long budget = spawn_get_budget();
+    for (size_t i = 0; i < report.function_count; i++) {
+        const spawn_function_t *fn = &report.functions[i];
+        if (fn->weighted_spawns == 0) {
+            continue;
+        }
+        bool over = fn->weighted_spawns > budget;
+        snprintf(message, sizeof(message),
+                 "Function '%s' spawns about %lu process%s per call "
+                 "(budget %lu)",
+                 fn->name, fn->weighted_spawns,
+                 fn->weighted_spawns == 1 ? "" : "es", budget);
+        debug_add_analysis_issue(
+            ctx, file, fn->line > 0 ? fn->line : 1, over ? "warning" : "info",
+            "performance", message,
+            over ? "Move external commands out of loops or use builtins "
+                   "and expansions"
+                 : NULL);
+    }
+
+    spawn_report_free(&report);
+}
+
 /**
  * @brief Analyze script for security issues
  * @param ctx Debug context
@@ -807,6 +889,7 @@ int debug_lint_script(debug_context_t *ctx, const char *script_path,
     node_t *ast = debug_analyze_syntax(ctx, script_path, script_content);
     debug_analyze_style(ctx, script_path, script_content);
     debug_analyze_performance(ctx, script_path, script_content);
+    debug_analyze_spawns(ctx, script_path, script_content, ast);
     debug_analyze_security(ctx, script_path, script_content);
     debug_analyze_portability(ctx, script_path, script_content, ast);
 
@@ -836,6 +919,7 @@ int debug_lint_script(debug_context_t *ctx, const char *script_path,
                     shell_mode_parse(target_str, &target);
                 }
                 size_t fixes_found = fixer_collect_fixes(&fixer_ctx, target);
+                fixes_found += fixer_collect_spawn_fixes(&fixer_ctx, target);
 
                 if (fixes_found > 0) {
                     fixer_options_t opts = {
@@ -0,0 +1,682 @@
+/**
+ * @file debug_batch.c
+ * @brief Multi-script analysis with a worker pool and result cache
+ *
+ * Expands file and directory arguments into a sorted script list, analyzes
+ * the scripts without a valid cached result on a bounded pool of worker
+ * processes, and replays each script's output in list order. Workers are
+ * processes rather than threads because the parser and analyzers keep
+ * global state.
+ *
+ * A result is cached under a key derived from the script path and content,
+ * the lush version, the compat rule set hash and the analysis options, so
+ * re-checking an unchanged tree only hashes the files.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "cache_file.h"
+#include "compat.h"
+#include "debug.h"
+#include "ht.h"
+#include "spawn_cost.h"
+#include "version.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/** @brief Upper bound on worker processes */
+#define BATCH_MAX_JOBS 64
+
+/** @brief Maximum path length for cache and work files */
+#define BATCH_PATH_MAX 4096
+
+/** @brief Maximum length of the cache and work directory names */
+#define BATCH_DIR_MAX 2048
+
+/** @brief Largest script that is hashed and cached */
+#define BATCH_MAX_SCRIPT_SIZE (16 * 1024 * 1024)
+
+/** @brief First line of a result record */
+#define BATCH_RECORD_MAGIC "LUSHLINT1\n"
+
+/** @brief Cache subdirectory under the XDG cache home */
+#define BATCH_CACHE_SUBDIR "lush/lint"
+
+/**
+ * @brief Growable list of script paths
+ */
+typedef struct {
+    char **paths;
+    size_t count;
+    size_t capacity;
+} path_list_t;
+
+/**
+ * @brief Output and exit status of one script
+ */
+typedef struct {
+    int status;     /**< Per-script exit status (0-3) */
+    char *out;      /**< Captured standard output */
+    size_t out_len;
+    char *err;      /**< Captured standard error */
+    size_t err_len;
+} batch_record_t;
+
+/**
+ * @brief Per-script scheduling state
+ */
+typedef struct {
+    char key[33];     /**< Cache key, empty if the script is not cacheable */
+    bool cached;      /**< Result was found in the cache */
+    batch_record_t record;
+} batch_item_t;
+
+/* ============================================================================
+ * Script Collection
+ * ============================================================================ */
+
+/**
+ * @brief Append a copy of a path unless it is already listed
+ * @return 0 on success, -1 on allocation failure
+ */
+static int path_list_add(path_list_t *list, const char *path) {
+    for (size_t i = 0; i < list->count; i++) {
+        if (strcmp(list->paths[i], path) == 0) {
+            return 0;
+        }
+    }
+    if (list->count == list->capacity) {
+        size_t new_cap = list->capacity ? list->capacity * 2 : 32;
+        char **grown = realloc(list->paths, new_cap * sizeof(char *));
+        if (!grown) {
+            return -1;
+        }
+        list->paths = grown;
+        list->capacity = new_cap;
+    }
+    list->paths[list->count] = strdup(path);
+    if (!list->paths[list->count]) {
+        return -1;
+    }
+    list->count++;
+    return 0;
+}
+
+/**
+ * @brief Check whether a file found in a directory is a shell script
+ *
+ * Accepts common shell extensions, or a #! line naming a shell.
+ */
+static bool is_shell_script(const char *path, const char *name) {
+    static const char *extensions[] = {".sh", ".bash", ".zsh", ".ksh",
+                                       ".lush"};
+    const char *dot = strrchr(name, '.');
+    if (dot) {
+        for (size_t i = 0; i < sizeof(extensions) / sizeof(extensions[0]);
+             i++) {
+            if (strcmp(dot, extensions[i]) == 0) {
+                return true;
+            }
+        }
+    }
+
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        return false;
+    }
+    char line[128];
+    bool script = false;
+    if (fgets(line, sizeof(line), fp) && line[0] == '#' && line[1] == '!') {
+        line[strcspn(line, "\n")] = '\0';
+        script = strstr(line, "sh") != NULL;
+    }
+    fclose(fp);
+    return script;
+}
+
+/**
+ * @brief Recursively add the scripts below a directory in sorted order
+ * @return 0 on success, -1 on allocation failure
+ */
+static int collect_directory(path_list_t *list, const char *dir) {
+    struct dirent **entries = NULL;
+    int n = scandir(dir, &entries, NULL, alphasort);
+    if (n < 0) {
+        return 0;
+    }
+
+    int rc = 0;
+    for (int i = 0; i < n; i++) {
+        const char *name = entries[i]->d_name;
+        char path[BATCH_PATH_MAX];
+        struct stat st;
+
+        if (rc == 0 && name[0] != '.' &&
+            snprintf(path, sizeof(path), "%s/%s", dir, name) <
+                (int)sizeof(path) &&
+            stat(path, &st) == 0) {
+            if (S_ISDIR(st.st_mode)) {
+                rc = collect_directory(list, path);
+            } else if (S_ISREG(st.st_mode) && is_shell_script(path, name)) {
+                rc = path_list_add(list, path);
+            }
+        }
+        free(entries[i]);
+    }
+    free(entries);
+    return rc;
+}
+
+int debug_batch_collect(char *const *args, size_t arg_count, char ***paths,
+                        size_t *count) {
+    if (!paths || !count) {
+        return -1;
+    }
+
+    path_list_t list = {0};
+    for (size_t i = 0; i < arg_count; i++) {
+        struct stat st;
+        if (stat(args[i], &st) != 0) {
+            fprintf(stderr, "lush: %s: %s\n", args[i], strerror(errno));
+            debug_batch_free_paths(list.paths, list.count);
+            return -1;
+        }
+
+        int rc;
+        if (S_ISDIR(st.st_mode)) {
+            /* Strip trailing slashes so reported paths stay tidy */
+            char dir[BATCH_PATH_MAX];
+            snprintf(dir, sizeof(dir), "%s", args[i]);
+            size_t len = strlen(dir);
+            while (len > 1 && dir[len - 1] == '/') {
+                dir[--len] = '\0';
+            }
+            rc = collect_directory(&list, dir);
+        } else {
+            rc = path_list_add(&list, args[i]);
+        }
+        if (rc != 0) {
+            debug_batch_free_paths(list.paths, list.count);
+            return -1;
+        }
+    }
+
+    *paths = list.paths;
+    *count = list.count;
+    return 0;
+}
+
+void debug_batch_free_paths(char **paths, size_t count) {
+    if (!paths) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        free(paths[i]);
+    }
+    free(paths);
+}
+
+/* ============================================================================
+ * Cache Keys and Records
+ * ============================================================================ */
+
+/**
+ * @brief Compute the cache key of a script
+ *
+ * Two independently seeded FNV-1a passes give a 128-bit key over the
+ * script path and content, the lush version, the rule set and every
+ * option that changes the output.
+ *
+ * @param path Script path
+ * @param opts Run options
+ * @param key Output: 32 hex digits, empty if the script cannot be read
+ */
+static void compute_key(const char *path, const debug_batch_options_t *opts,
+                        char key[33]) {
+    key[0] = '\0';
+
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        return;
+    }
+
+    char header[512];
+    const char *target = compat_get_target();
+    int header_len = snprintf(
+        header, sizeof(header), "%s|%llx|%s|%d|%lu|%d|%d|%d|%d|%s",
+        LUSH_VERSION_STRING, (unsigned long long)compat_ruleset_hash(),
+        target ? target : "", compat_is_strict(), spawn_get_budget(),
+        (int)opts->mode, opts->fix, opts->unsafe_fixes, opts->dry_run, path);
+    if (header_len < 0 || (size_t)header_len >= sizeof(header)) {
+        fclose(fp);
+        return;
+    }
+
+    size_t len = (size_t)header_len + 1;
+    uint64_t a = fnv1a_hash_bytes(header, len, FNV1A_OFFSET);
+    uint64_t b = fnv1a_hash_bytes(header, len, 0x84222325cbf29ce4ULL);
+
+    char buf[65536];
+    size_t total = 0;
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        a = fnv1a_hash_bytes(buf, n, a);
+        b = fnv1a_hash_bytes(buf, n, b);
+        total += n;
+        if (total > BATCH_MAX_SCRIPT_SIZE) {
+            fclose(fp);
+            return;
+        }
+    }
+    bool failed = ferror(fp);
+    fclose(fp);
+    if (failed) {
+        return;
+    }
+
+    snprintf(key, 33, "%016llx%016llx", (unsigned long long)a,
+             (unsigned long long)b);
+}
+
+/**
+ * @brief Resolve and create the cache directory
+ * @return true if the directory exists
+ */
+static bool resolve_cache_dir(const debug_batch_options_t *opts, char *buf,
+                              size_t size) {
+    if (opts->cache_dir && opts->cache_dir[0]) {
+        snprintf(buf, size, "%s", opts->cache_dir);
+    } else if (!cache_file_path(BATCH_CACHE_SUBDIR, buf, size)) {
+        return false;
+    }
+    return cache_file_make_dirs(buf);
+}
+
+/**
+ * @brief Release the buffers of a record
+ */
+static void record_free(batch_record_t *record) {
+    free(record->out);
+    free(record->err);
+    memset(record, 0, sizeof(*record));
+}
+
+/**
+ * @brief Read a result record from a file
+ * @return true if a complete record was read
+ */
+static bool record_read(const char *path, batch_record_t *record) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        return false;
+    }
+
+    char magic[sizeof(BATCH_RECORD_MAGIC)];
+    int status;
+    size_t out_len;
+    size_t err_len;
+    bool ok = fgets(magic, sizeof(magic), fp) &&
+              strcmp(magic, BATCH_RECORD_MAGIC) == 0 &&
+              fscanf(fp, "%d %zu %zu", &status, &out_len, &err_len) == 3 &&
+              fgetc(fp) == '\n' && out_len <= BATCH_MAX_SCRIPT_SIZE &&
+              err_len <= BATCH_MAX_SCRIPT_SIZE;
+
+    char *out = ok ? malloc(out_len + 1) : NULL;
+    char *err = ok ? malloc(err_len + 1) : NULL;
+    ok = ok && out && err && fread(out, 1, out_len, fp) == out_len &&
+         fread(err, 1, err_len, fp) == err_len;
+    fclose(fp);
+
+    if (!ok) {
+        free(out);
+        free(err);
+        return false;
+    }
+    out[out_len] = '\0';
+    err[err_len] = '\0';
+    record->status = status;
+    record->out = out;
+    record->out_len = out_len;
+    record->err = err;
+    record->err_len = err_len;
+    return true;
+}
+
+/**
+ * @brief Write a result record atomically (temporary file and rename)
+ */
+static void record_write(const char *path, const batch_record_t *record) {
+    char header[64];
+    int len = snprintf(header, sizeof(header), "%s%d %zu %zu\n",
+                       BATCH_RECORD_MAGIC, record->status, record->out_len,
+                       record->err_len);
+    if (len < 0 || (size_t)len >= sizeof(header)) {
+        return;
+    }
+    const cache_file_part_t parts[] = {
+        {header, (size_t)len},
+        {record->out, record->out_len},
+        {record->err, record->err_len},
+    };
+    cache_file_write(path, parts, sizeof(parts) / sizeof(parts[0]));
+}
+
+/* ============================================================================
+ * Analysis
+ * ============================================================================ */
+
+/**
+ * @brief Exit status implied by the issues in a context
+ * @return 2 if any error, 1 if any warning, else 0
+ */
+static int issues_status(const debug_context_t *ctx) {
+    int status = 0;
+    for (analysis_issue_t *issue = ctx->analysis_issues; issue;
+         issue = issue->next) {
+        if (strcmp(issue->severity, "error") == 0) {
+            return 2;
+        }
+        if (strcmp(issue->severity, "warning") == 0) {
+            status = 1;
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief Analyze or lint one script, writing to the current stdout/stderr
+ * @return Per-script exit status (0-3)
+ */
+static int run_script(const char *path, const debug_batch_options_t *opts) {
+    debug_context_t *ctx = debug_init();
+    if (!ctx) {
+        fprintf(stderr, "lush: failed to initialize analysis context\n");
+        return 2;
+    }
+    debug_enable(ctx, true);
+
+    int status;
+    if (opts->mode == ANALYSIS_MODE_LINT) {
+        int remaining = debug_lint_script(ctx, path, opts->fix,
+                                          opts->unsafe_fixes, opts->dry_run);
+        status = remaining < 0 ? 3 : (remaining > 0 ? issues_status(ctx) : 0);
+    } else {
+        debug_analyze_script(ctx, path);
+        status = issues_status(ctx);
+    }
+
+    debug_cleanup(ctx);
+    return status;
+}
+
+/**
+ * @brief Read the whole content of a temporary file
+ */
+static char *slurp_file(FILE *fp, size_t *len) {
+    fflush(fp);
+    long size = ftell(fp);
+    char *data = malloc(size > 0 ? (size_t)size + 1 : 1);
+    *len = 0;
+    if (!data) {
+        return NULL;
+    }
+    if (size > 0) {
+        rewind(fp);
+        *len = fread(data, 1, (size_t)size, fp);
+    }
+    data[*len] = '\0';
+    return data;
+}
+
+/**
+ * @brief Run one script with stdout and stderr captured into a record
+ */
+static bool run_captured(const char *path, const debug_batch_options_t *opts,
+                         batch_record_t *record) {
+    FILE *out = tmpfile();
+    FILE *err = tmpfile();
+    if (!out || !err) {
+        if (out) {
+            fclose(out);
+        }
+        if (err) {
+            fclose(err);
+        }
+        return false;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    dup2(fileno(out), STDOUT_FILENO);
+    dup2(fileno(err), STDERR_FILENO);
+
+    record->status = run_script(path, opts);
+
+    fflush(stdout);
+    fflush(stderr);
+    record->out = slurp_file(out, &record->out_len);
+    record->err = slurp_file(err, &record->err_len);
+    fclose(out);
+    fclose(err);
+    return record->out && record->err;
+}
+
+/**
+ * @brief Worker process body: analyze every index read from the queue
+ *
+ * Results go to workdir/<index>, and to the cache when the script has a
+ * key. Never returns.
+ */
+static void worker_main(int queue_fd, char *const *paths, batch_item_t *items,
+                        const debug_batch_options_t *opts, const char *workdir,
+                        const char *cache_dir) {
+    signal(SIGINT, SIG_DFL);
+    signal(SIGQUIT, SIG_DFL);
+    signal(SIGPIPE, SIG_DFL);
+
+    uint32_t index;
+
+    while (read(queue_fd, &index, sizeof(index)) == sizeof(index)) {
+        batch_record_t record = {0};
+        if (!run_captured(paths[index], opts, &record)) {
+            record_free(&record);
+            continue;
+        }
+
+        char path[BATCH_PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%u", workdir, index);
+        record_write(path, &record);
+        if (cache_dir && items[index].key[0]) {
+            snprintf(path, sizeof(path), "%s/%s", cache_dir,
+                     items[index].key);
+            record_write(path, &record);
+        }
+        record_free(&record);
+    }
+
+    _exit(0);
+}
+
+/**
+ * @brief Number of workers to start for a number of pending scripts
+ */
+static int worker_count(const debug_batch_options_t *opts, size_t pending) {
+    long jobs = opts->jobs;
+    if (jobs <= 0) {
+        jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (jobs < 1) {
+        jobs = 1;
+    }
+    if (jobs > BATCH_MAX_JOBS) {
+        jobs = BATCH_MAX_JOBS;
+    }
+    if ((size_t)jobs > pending) {
+        jobs = (long)pending;
+    }
+    return (int)jobs;
+}
+
+/**
+ * @brief Remove the work directory and its result files
+ */
+static void remove_workdir(const char *workdir, size_t count) {
+    char path[BATCH_PATH_MAX];
+    for (size_t i = 0; i < count; i++) {
+        snprintf(path, sizeof(path), "%s/%zu", workdir, i);
+        unlink(path);
+    }
+    rmdir(workdir);
+}
+
+/**
+ * @brief Analyze the pending scripts on a pool of worker processes
+ *
+ * Indices are handed out through a pipe; each read of a 4-byte index is
+ * atomic, so idle workers pick up the next script as they finish.
+ */
+static void run_pool(char *const *paths, batch_item_t *items, size_t count,
+                     const debug_batch_options_t *opts, const char *workdir,
+                     const char *cache_dir) {
+    size_t pending = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!items[i].cached) {
+            pending++;
+        }
+    }
+    if (pending == 0) {
+        return;
+    }
+
+    int queue[2];
+    if (pipe(queue) != 0) {
+        return;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+
+    int jobs = worker_count(opts, pending);
+    pid_t workers[BATCH_MAX_JOBS];
+    int started = 0;
+    for (int w = 0; w < jobs; w++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(queue[1]);
+            worker_main(queue[0], paths, items, opts, workdir, cache_dir);
+        }
+        if (pid < 0) {
+            break;
+        }
+        workers[started++] = pid;
+    }
+    close(queue[0]);
+
+    /* A write to a queue whose workers all died must not kill the shell */
+    void (*old_pipe)(int) = signal(SIGPIPE, SIG_IGN);
+    for (size_t i = 0; i < count && started > 0; i++) {
+        if (items[i].cached) {
+            continue;
+        }
+        uint32_t index = (uint32_t)i;
+        if (write(queue[1], &index, sizeof(index)) != sizeof(index)) {
+            break;
+        }
+    }
+    close(queue[1]);
+    signal(SIGPIPE, old_pipe);
+
+    for (int w = 0; w < started; w++) {
+        while (waitpid(workers[w], NULL, 0) < 0 && errno == EINTR) {
+        }
+    }
+}
+
+int debug_batch_run(char *const *paths, size_t count,
+                    const debug_batch_options_t *opts,
+                    debug_batch_summary_t *summary) {
+    debug_batch_summary_t local = {0};
+    if (!summary) {
+        summary = &local;
+    }
+    memset(summary, 0, sizeof(*summary));
+    if (!paths || count == 0 || !opts) {
+        return 0;
+    }
+
+    batch_item_t *items = calloc(count, sizeof(batch_item_t));
+    if (!items) {
+        fprintf(stderr, "lush: out of memory\n");
+        return 2;
+    }
+
+    /* Fixes rewrite the scripts, so their results are never reused */
+    bool cacheable = opts->use_cache && !(opts->fix && !opts->dry_run);
+    char cache_dir[BATCH_DIR_MAX];
+    if (cacheable && !resolve_cache_dir(opts, cache_dir, sizeof(cache_dir))) {
+        cacheable = false;
+    }
+
+    for (size_t i = 0; i < count && cacheable; i++) {
+        compute_key(paths[i], opts, items[i].key);
+        if (items[i].key[0]) {
+            char path[BATCH_PATH_MAX];
+            snprintf(path, sizeof(path), "%s/%s", cache_dir, items[i].key);
+            items[i].cached = record_read(path, &items[i].record);
+            if (items[i].cached) {
+                summary->cached++;
+            }
+        }
+    }
+
+    const char *tmp = getenv("TMPDIR");
+    char workdir[BATCH_DIR_MAX];
+    snprintf(workdir, sizeof(workdir), "%s/lush-lint-XXXXXX",
+             tmp && tmp[0] ? tmp : "/tmp");
+    bool have_workdir = mkdtemp(workdir) != NULL;
+    if (have_workdir) {
+        run_pool(paths, items, count, opts, workdir,
+                 cacheable ? cache_dir : NULL);
+    }
+
+    /* Replay in list order, independent of which worker finished first */
+    int exit_status = 0;
+    for (size_t i = 0; i < count; i++) {
+        batch_record_t *record = &items[i].record;
+        if (!items[i].cached) {
+            char path[BATCH_PATH_MAX];
+            snprintf(path, sizeof(path), "%s/%zu", workdir, i);
+            if (!have_workdir || !record_read(path, record)) {
+                fprintf(stderr, "lush: %s: analysis failed\n", paths[i]);
+                exit_status = exit_status < 2 ? 2 : exit_status;
+                continue;
+            }
+        }
+        fflush(stderr);
+        fwrite(record->out, 1, record->out_len, stdout);
+        fflush(stdout);
+        fwrite(record->err, 1, record->err_len, stderr);
+        if (record->status > exit_status) {
+            exit_status = record->status;
+        }
+        record_free(record);
+    }
+
+    if (have_workdir) {
+        remove_workdir(workdir, count);
+    }
+    free(items);
+
+    summary->files = count;
+    summary->exit_status = exit_status;
+    return exit_status;
+}
@@ -13,6 +13,7 @@
 #include "debug.h"
 #include "errors.h"
 #include "executor.h"
+#include "ht.h"
 #include "node.h"
 #include "shell_mode.h"
 #include "symtable.h"
@@ -24,6 +25,147 @@
 #include <termios.h>
 #include <unistd.h>
 
+/* ============================================================================
+ * Source File Interning and Breakpoint Index
+ * ============================================================================ */
+
+/** @brief Source file name -> id table (shared by all debug contexts) */
+static ht_strint_t *source_file_ids = NULL;
+
+/** @brief Next source file id to hand out (0 is reserved for "unknown") */
+static int next_source_file_id = 1;
+
+/**
+ * @brief Intern a source file name
+ * @param file Source file name
+ * @return File id (> 0), or 0 if file is NULL or interning failed
+ */
+int debug_intern_source_file(const char *file) {
+    if (!file) {
+        return 0;
+    }
+
+    if (!source_file_ids) {
+        source_file_ids = ht_strint_create(HT_STR_NONE);
+        if (!source_file_ids) {
+            return 0;
+        }
+    }
+
+    const int *existing = ht_strint_get(source_file_ids, file);
+    if (existing) {
+        return *existing;
+    }
+
+    int id = next_source_file_id++;
+    ht_strint_insert(source_file_ids, file, &id);
+    return id;
+}
+
+/**
+ * @brief Mark a line as armed in the breakpoint index
+ * @param ctx Debug context
+ * @param file_id Interned source file id
+ * @param line Line number
+ * @return true on success, false on allocation failure
+ */
+static bool bp_index_set(debug_context_t *ctx, int file_id, int line) {
+    if (file_id >= ctx->bp_index_size) {
+        int new_size = ctx->bp_index_size ? ctx->bp_index_size : 8;
+        while (new_size <= file_id) {
+            new_size *= 2;
+        }
+        breakpoint_lines_t *grown =
+            realloc(ctx->bp_index, (size_t)new_size * sizeof(*grown));
+        if (!grown) {
+            return false;
+        }
+        memset(grown + ctx->bp_index_size, 0,
+               (size_t)(new_size - ctx->bp_index_size) * sizeof(*grown));
+        ctx->bp_index = grown;
+        ctx->bp_index_size = new_size;
+    }
+
+    breakpoint_lines_t *lines = &ctx->bp_index[file_id];
+    size_t word = (size_t)line / 64;
+    if (word >= lines->nwords) {
+        size_t new_words = lines->nwords ? lines->nwords : 4;
+        while (new_words <= word) {
+            new_words *= 2;
+        }
+        uint64_t *grown = realloc(lines->words, new_words * sizeof(*grown));
+        if (!grown) {
+            return false;
+        }
+        memset(grown + lines->nwords, 0,
+               (new_words - lines->nwords) * sizeof(*grown));
+        lines->words = grown;
+        lines->nwords = new_words;
+    }
+
+    lines->words[word] |= UINT64_C(1) << ((size_t)line % 64);
+    return true;
+}
+
+/**
+ * @brief Test whether a line is armed in the breakpoint index
+ * @param ctx Debug context
+ * @param file_id Interned source file id
+ * @param line Line number
+ * @return true if an enabled breakpoint may exist at file_id:line
+ */
+static inline bool bp_index_test(const debug_context_t *ctx, int file_id,
+                                 int line) {
+    if (file_id <= 0 || file_id >= ctx->bp_index_size) {
+        return false;
+    }
+    const breakpoint_lines_t *lines = &ctx->bp_index[file_id];
+    size_t word = (size_t)line / 64;
+    if (word >= lines->nwords) {
+        return false;
+    }
+    return (lines->words[word] >> ((size_t)line % 64)) & 1;
+}
+
+/**
+ * @brief Rebuild the breakpoint index from the breakpoint list
+ *
+ * Called whenever a breakpoint is added, removed, enabled or disabled.
+ * These are rare interactive operations, so a full rebuild keeps the
+ * index trivially consistent with the list.
+ *
+ * @param ctx Debug context
+ */
+static void bp_index_rebuild(debug_context_t *ctx) {
+    for (int i = 0; i < ctx->bp_index_size; i++) {
+        if (ctx->bp_index[i].words) {
+            memset(ctx->bp_index[i].words, 0,
+                   ctx->bp_index[i].nwords * sizeof(uint64_t));
+        }
+    }
+
+    ctx->armed_breakpoints = 0;
+    for (breakpoint_t *bp = ctx->breakpoints; bp; bp = bp->next) {
+        if (bp->enabled && bp_index_set(ctx, bp->file_id, bp->line)) {
+            ctx->armed_breakpoints++;
+        }
+    }
+}
+
+/**
+ * @brief Free the breakpoint index
+ * @param ctx Debug context
+ */
+static void bp_index_free(debug_context_t *ctx) {
+    for (int i = 0; i < ctx->bp_index_size; i++) {
+        free(ctx->bp_index[i].words);
+    }
+    free(ctx->bp_index);
+    ctx->bp_index = NULL;
+    ctx->bp_index_size = 0;
+    ctx->armed_breakpoints = 0;
+}
+
 /**
  * @brief Add a new breakpoint
  * @param ctx Debug context
@@ -47,6 +189,7 @@ int debug_add_breakpoint(debug_context_t *ctx, const char *file, int line,
     // Initialize breakpoint
     bp->id = ctx->next_breakpoint_id++;
     bp->file = strdup(file);
+    bp->file_id = debug_intern_source_file(file);
     bp->line = line;
     bp->condition = condition ? strdup(condition) : NULL;
     bp->hit_count = 0;
@@ -55,6 +198,7 @@ int debug_add_breakpoint(debug_context_t *ctx, const char *file, int line,
 
     // Add to list
     ctx->breakpoints = bp;
+    bp_index_rebuild(ctx);
 
     debug_printf(ctx, "Breakpoint %d set at %s:%d\n", bp->id, file, line);
     if (condition) {
@@ -87,6 +231,7 @@ bool debug_remove_breakpoint(debug_context_t *ctx, int id) {
             free(bp->file);
             free(bp->condition);
             free(bp);
+            bp_index_rebuild(ctx);
             return true;
         }
         current = &(*current)->next;
@@ -112,6 +257,7 @@ bool debug_enable_breakpoint(debug_context_t *ctx, int id, bool enable) {
     while (bp) {
         if (bp->id == id) {
             bp->enabled = enable;
+            bp_index_rebuild(ctx);
             debug_printf(ctx, "Breakpoint %d %s\n", id,
                          enable ? "enabled" : "disabled");
             return true;
@@ -135,11 +281,34 @@ bool debug_check_breakpoint(debug_context_t *ctx, const char *file, int line) {
         return false;
     }
 
-    debug_printf(ctx, "[DEBUG] Checking breakpoint at %s:%d\n", file, line);
+    return debug_check_breakpoint_at(ctx, debug_intern_source_file(file), file,
+                                     line);
+}
+
+/**
+ * @brief Check if execution should stop at a breakpoint (interned file id)
+ * @param ctx Debug context
+ * @param file_id Interned source file id
+ * @param file Current source file
+ * @param line Current line number
+ * @return true if breakpoint hit, false otherwise
+ */
+bool debug_check_breakpoint_at(debug_context_t *ctx, int file_id,
+                               const char *file, int line) {
+    if (!ctx || !ctx->enabled || !file || line <= 0) {
+        return false;
+    }
+
+    // Single bitmap probe; only walk the list when the line is armed
+    breakpoint_t *bp =
+        bp_index_test(ctx, file_id, line) ? ctx->breakpoints : NULL;
+
+    if (bp && ctx->level >= DEBUG_TRACE) {
+        debug_printf(ctx, "[DEBUG] Checking breakpoint at %s:%d\n", file, line);
+    }
 
-    breakpoint_t *bp = ctx->breakpoints;
     while (bp) {
-        if (bp->enabled && bp->line == line && strcmp(bp->file, file) == 0) {
+        if (bp->enabled && bp->line == line && bp->file_id == file_id) {
             bp->hit_count++;
 
             debug_printf(ctx,
@@ -238,6 +407,7 @@ void debug_clear_breakpoints(debug_context_t *ctx) {
 
     ctx->breakpoints = NULL;
     ctx->next_breakpoint_id = 1;
+    bp_index_free(ctx);
 
     debug_printf(ctx, "All breakpoints cleared\n");
 }
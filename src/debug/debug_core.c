@@ -30,7 +30,7 @@ debug_context_t *g_debug_context = NULL;
  * @return Pointer to the newly created debug context, or NULL on failure
  */
 debug_context_t *debug_init(void) {
-    debug_context_t *ctx = malloc(sizeof(debug_context_t));
+    debug_context_t *ctx = calloc(1, sizeof(debug_context_t));
     if (!ctx) {
         return NULL;
     }
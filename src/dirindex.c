@@ -0,0 +1,802 @@
+/**
+ * @file dirindex.c
+ * @brief Frecency-ranked index of visited directories
+ *
+ * Each visit adds one to a directory's rank and stamps it with the current
+ * time. Scores weight the rank by recency, the same way z and zoxide do.
+ * When the ranks add up to more than the aging limit, all of them are
+ * scaled down and directories that fall below DIRINDEX_MIN_RANK are
+ * forgotten, so old habits fade instead of accumulating forever.
+ *
+ * Visits are also counted as pending. Saving re-reads the file, adds the
+ * pending visits and removals on top of whatever other shells wrote in the
+ * meantime, and replaces the file atomically.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "dirindex.h"
+
+#include "ht.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/** First line of the index file */
+#define DIRINDEX_HEADER "# lush dirindex v1"
+
+/** Fraction of the limits kept after aging or capping */
+#define DIRINDEX_KEEP_RATIO 0.9
+
+/**
+ * @brief One indexed directory
+ */
+typedef struct {
+    char *path;     /**< Absolute path (owned) */
+    double rank;    /**< Accumulated visits, aged */
+    time_t last;    /**< Time of the last visit */
+    double pending; /**< Visits not yet written to the file */
+} dir_entry_t;
+
+/**
+ * @brief Hash-indexed set of directories
+ */
+typedef struct {
+    dir_entry_t *entries; /**< Entries in no particular order */
+    size_t count;         /**< Number of entries */
+    size_t capacity;      /**< Allocated entries */
+    size_t *slots;        /**< Open-addressed hash of entry index + 1 */
+    size_t slot_count;    /**< Number of slots (power of two) */
+    double total;         /**< Sum of all ranks */
+} dir_table_t;
+
+/** The in-memory index */
+static dir_table_t table;
+
+/** Paths removed since the last save, applied to the file on save */
+static char **removed;
+static size_t removed_count;
+static size_t removed_capacity;
+
+/** Whether the file has been read into the table */
+static bool loaded = false;
+
+/** Whether the table has changes not yet saved */
+static bool dirty = false;
+
+/** Process that loaded the index and may save it */
+static pid_t owner = 0;
+
+/** File override from dirindex_set_file (NULL for the default) */
+static char *file_override = NULL;
+
+/** Size and aging limits */
+static size_t max_entries = DIRINDEX_DEFAULT_MAX_ENTRIES;
+static double max_age = DIRINDEX_DEFAULT_MAX_AGE;
+
+/* ============================================================================
+ * Table
+ * ============================================================================ */
+
+static size_t hash_path(const char *path) {
+    return (size_t)fnv1a_hash_str(path, FNV1A_OFFSET);
+}
+
+static void table_free(dir_table_t *t) {
+    for (size_t i = 0; i < t->count; i++) {
+        free(t->entries[i].path);
+    }
+    free(t->entries);
+    free(t->slots);
+    memset(t, 0, sizeof(*t));
+}
+
+static bool table_rehash(dir_table_t *t, size_t min_slots) {
+    size_t slot_count = 64;
+    while (slot_count < min_slots * 2) {
+        slot_count *= 2;
+    }
+
+    size_t *slots = calloc(slot_count, sizeof(*slots));
+    if (!slots) {
+        return false;
+    }
+
+    for (size_t i = 0; i < t->count; i++) {
+        size_t s = hash_path(t->entries[i].path) & (slot_count - 1);
+        while (slots[s]) {
+            s = (s + 1) & (slot_count - 1);
+        }
+        slots[s] = i + 1;
+    }
+
+    free(t->slots);
+    t->slots = slots;
+    t->slot_count = slot_count;
+    return true;
+}
+
+static dir_entry_t *table_find(const dir_table_t *t, const char *path) {
+    if (!t->slots) {
+        return NULL;
+    }
+
+    size_t s = hash_path(path) & (t->slot_count - 1);
+    while (t->slots[s]) {
+        dir_entry_t *e = &t->entries[t->slots[s] - 1];
+        if (strcmp(e->path, path) == 0) {
+            return e;
+        }
+        s = (s + 1) & (t->slot_count - 1);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Find or create the entry for a path
+ *
+ * New entries start with rank 0 and no visit time.
+ */
+static dir_entry_t *table_get(dir_table_t *t, const char *path) {
+    dir_entry_t *e = table_find(t, path);
+    if (e) {
+        return e;
+    }
+
+    if (t->count == t->capacity) {
+        size_t capacity = t->capacity ? t->capacity * 2 : 64;
+        dir_entry_t *entries = realloc(t->entries, capacity * sizeof(*entries));
+        if (!entries) {
+            return NULL;
+        }
+        t->entries = entries;
+        t->capacity = capacity;
+    }
+
+    char *copy = strdup(path);
+    if (!copy) {
+        return NULL;
+    }
+
+    e = &t->entries[t->count++];
+    e->path = copy;
+    e->rank = 0.0;
+    e->last = 0;
+    e->pending = 0.0;
+
+    if ((t->count + 1) * 2 > t->slot_count) {
+        if (!table_rehash(t, t->count)) {
+            free(copy);
+            t->count--;
+            return NULL;
+        }
+    } else {
+        size_t s = hash_path(path) & (t->slot_count - 1);
+        while (t->slots[s]) {
+            s = (s + 1) & (t->slot_count - 1);
+        }
+        t->slots[s] = t->count;
+    }
+    return e;
+}
+
+/**
+ * @brief Drop entries for which keep() is false and rebuild the hash
+ */
+static void table_filter(dir_table_t *t, bool (*keep)(const dir_entry_t *e,
+                                                       const void *arg),
+                         const void *arg) {
+    size_t out = 0;
+    t->total = 0.0;
+    for (size_t i = 0; i < t->count; i++) {
+        if (keep(&t->entries[i], arg)) {
+            t->entries[out++] = t->entries[i];
+            t->total += t->entries[i].rank;
+        } else {
+            free(t->entries[i].path);
+        }
+    }
+    if (out != t->count) {
+        t->count = out;
+        table_rehash(t, t->count);
+    }
+}
+
+static bool keep_other_path(const dir_entry_t *e, const void *arg) {
+    return strcmp(e->path, (const char *)arg) != 0;
+}
+
+static bool keep_ranked(const dir_entry_t *e, const void *arg) {
+    (void)arg;
+    return e->rank >= DIRINDEX_MIN_RANK;
+}
+
+/** Highest rank first, most recent first among equal ranks */
+static int compare_rank(const void *a, const void *b) {
+    const dir_entry_t *ea = a;
+    const dir_entry_t *eb = b;
+    if (ea->rank != eb->rank) {
+        return ea->rank < eb->rank ? 1 : -1;
+    }
+    return (ea->last < eb->last) - (ea->last > eb->last);
+}
+
+/**
+ * @brief Age ranks past the limit and cap the number of entries
+ *
+ * Pending visits are scaled with the ranks so a later merge adds the
+ * visits at the same weight.
+ */
+static void table_age(dir_table_t *t) {
+    if (t->total > max_age) {
+        double factor = DIRINDEX_KEEP_RATIO * max_age / t->total;
+        for (size_t i = 0; i < t->count; i++) {
+            t->entries[i].rank *= factor;
+            t->entries[i].pending *= factor;
+        }
+        table_filter(t, keep_ranked, NULL);
+    }
+
+    if (t->count > max_entries) {
+        size_t keep = (size_t)(max_entries * DIRINDEX_KEEP_RATIO);
+        if (keep == 0) {
+            keep = 1;
+        }
+        qsort(t->entries, t->count, sizeof(*t->entries), compare_rank);
+        for (size_t i = keep; i < t->count; i++) {
+            free(t->entries[i].path);
+        }
+        t->count = keep;
+        t->total = 0.0;
+        for (size_t i = 0; i < t->count; i++) {
+            t->total += t->entries[i].rank;
+        }
+        table_rehash(t, t->count);
+    }
+}
+
+/* ============================================================================
+ * File
+ * ============================================================================ */
+
+/**
+ * @brief Path of the index file
+ *
+ * @return Newly allocated path, or NULL if there is nowhere to store it
+ */
+static char *index_file_path(void) {
+    if (file_override) {
+        return strdup(file_override);
+    }
+
+    const char *env = getenv("LUSH_DIRS_FILE");
+    if (env && *env) {
+        return strdup(env);
+    }
+
+    const char *home = getenv("HOME");
+    if (!home || !*home) {
+        return NULL;
+    }
+
+    size_t len = strlen(home) + 1 + strlen(DIRINDEX_FILE_NAME) + 1;
+    char *path = malloc(len);
+    if (path) {
+        snprintf(path, len, "%s/%s", home, DIRINDEX_FILE_NAME);
+    }
+    return path;
+}
+
+/**
+ * @brief Read an index file into a table
+ *
+ * Lines are "rank<TAB>last<TAB>path". Malformed lines are skipped, so a
+ * damaged file only loses the damaged entries.
+ */
+static void table_load(dir_table_t *t, const char *file) {
+    FILE *fp = fopen(file, "r");
+    if (!fp) {
+        return;
+    }
+
+    char *line = NULL;
+    size_t line_cap = 0;
+    ssize_t len;
+    while ((len = getline(&line, &line_cap, fp)) > 0) {
+        if (line[len - 1] == '\n') {
+            line[--len] = '\0';
+        }
+        if (line[0] == '#' || line[0] == '\0') {
+            continue;
+        }
+
+        char *end;
+        double rank = strtod(line, &end);
+        if (*end != '\t' || !(rank > 0.0)) {
+            continue;
+        }
+        long long last = strtoll(end + 1, &end, 10);
+        if (*end != '\t' || end[1] != '/') {
+            continue;
+        }
+
+        dir_entry_t *e = table_get(t, end + 1);
+        if (e) {
+            e->rank += rank;
+            t->total += rank;
+            if ((time_t)last > e->last) {
+                e->last = (time_t)last;
+            }
+        }
+    }
+
+    free(line);
+    fclose(fp);
+}
+
+/**
+ * @brief Write a table to a file atomically
+ */
+static int table_write(const dir_table_t *t, const char *file) {
+    size_t len = strlen(file) + 32;
+    char *tmp = malloc(len);
+    if (!tmp) {
+        return -1;
+    }
+    snprintf(tmp, len, "%s.%ld.tmp", file, (long)getpid());
+
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        free(tmp);
+        return -1;
+    }
+    FILE *fp = fdopen(fd, "w");
+    if (!fp) {
+        close(fd);
+        unlink(tmp);
+        free(tmp);
+        return -1;
+    }
+
+    fprintf(fp, "%s\n", DIRINDEX_HEADER);
+    for (size_t i = 0; i < t->count; i++) {
+        const dir_entry_t *e = &t->entries[i];
+        fprintf(fp, "%.6g\t%lld\t%s\n", e->rank, (long long)e->last, e->path);
+    }
+
+    bool ok = !ferror(fp);
+    if (fclose(fp) != 0) {
+        ok = false;
+    }
+    if (!ok || rename(tmp, file) < 0) {
+        unlink(tmp);
+        free(tmp);
+        return -1;
+    }
+
+    free(tmp);
+    return 0;
+}
+
+/**
+ * @brief Load the index file on first use
+ */
+static void ensure_loaded(void) {
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+    owner = getpid();
+
+    char *file = index_file_path();
+    if (file) {
+        table_load(&table, file);
+        free(file);
+    }
+}
+
+static void clear_removed(void) {
+    for (size_t i = 0; i < removed_count; i++) {
+        free(removed[i]);
+    }
+    free(removed);
+    removed = NULL;
+    removed_count = 0;
+    removed_capacity = 0;
+}
+
+static void forget_removed(const char *path) {
+    for (size_t i = 0; i < removed_count; i++) {
+        if (strcmp(removed[i], path) == 0) {
+            free(removed[i]);
+            removed[i] = removed[--removed_count];
+            return;
+        }
+    }
+}
+
+/* ============================================================================
+ * Matching
+ * ============================================================================ */
+
+/**
+ * @brief Find a fragment in a string, optionally ignoring case
+ */
+static const char *find_fragment(const char *haystack, const char *fragment,
+                                 bool icase) {
+    if (!icase) {
+        return strstr(haystack, fragment);
+    }
+
+    for (const char *p = haystack; *p; p++) {
+        const char *h = p;
+        const char *f = fragment;
+        while (*f && tolower((unsigned char)*h) == tolower((unsigned char)*f)) {
+            h++;
+            f++;
+        }
+        if (!*f) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static bool has_upper(const char *s) {
+    for (; *s; s++) {
+        if (isupper((unsigned char)*s)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Whether a path matches fragments in order
+ *
+ * The last fragment has to match within the final component unless it
+ * contains a slash itself, so "z foo" prefers .../foo over .../foo/bar/baz.
+ */
+static bool path_matches(const char *path, const char *const *fragments,
+                         size_t count, bool icase) {
+    const char *pos = path;
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+
+    for (size_t i = 0; i < count; i++) {
+        const char *frag = fragments[i];
+        if (!frag || !*frag) {
+            continue;
+        }
+        const char *from = pos;
+        if (i == count - 1 && !strchr(frag, '/') && from < base) {
+            from = base;
+        }
+        const char *hit = find_fragment(from, frag, icase);
+        if (!hit) {
+            return false;
+        }
+        pos = hit + strlen(frag);
+    }
+    return true;
+}
+
+/**
+ * @brief Whether path is a strict subdirectory of parent
+ */
+static bool is_subdirectory(const char *path, const char *parent) {
+    size_t len = strlen(parent);
+    while (len > 1 && parent[len - 1] == '/') {
+        len--;
+    }
+    if (strncmp(path, parent, len) != 0) {
+        return false;
+    }
+    if (len == 1 && parent[0] == '/') {
+        return path[1] != '\0';
+    }
+    return path[len] == '/' && path[len + 1] != '\0';
+}
+
+static double frecency(const dir_entry_t *e, time_t now) {
+    double age = difftime(now, e->last);
+    if (age < 3600) {
+        return e->rank * 4.0;
+    }
+    if (age < 86400) {
+        return e->rank * 2.0;
+    }
+    if (age < 604800) {
+        return e->rank * 0.5;
+    }
+    return e->rank * 0.25;
+}
+
+static int compare_match(const void *a, const void *b) {
+    const dirindex_match_t *ma = a;
+    const dirindex_match_t *mb = b;
+    if (ma->score != mb->score) {
+        return ma->score < mb->score ? 1 : -1;
+    }
+    return strcmp(ma->path, mb->path);
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void dirindex_init(void) {
+    /* Loading is deferred until the index is used */
+}
+
+int dirindex_save(void) {
+    if (!loaded || !dirty || getpid() != owner) {
+        return 0;
+    }
+
+    char *file = index_file_path();
+    if (!file) {
+        return -1;
+    }
+
+    /* Merge into what is on disk now: other shells may have saved since
+     * this one loaded */
+    dir_table_t merged = {0};
+    table_load(&merged, file);
+    for (size_t i = 0; i < removed_count; i++) {
+        table_filter(&merged, keep_other_path, removed[i]);
+    }
+    for (size_t i = 0; i < table.count; i++) {
+        const dir_entry_t *e = &table.entries[i];
+        if (e->pending <= 0.0) {
+            continue;
+        }
+        dir_entry_t *m = table_get(&merged, e->path);
+        if (!m) {
+            continue;
+        }
+        m->rank += e->pending;
+        merged.total += e->pending;
+        if (e->last > m->last) {
+            m->last = e->last;
+        }
+    }
+    table_age(&merged);
+
+    int result = table_write(&merged, file);
+    free(file);
+    if (result < 0) {
+        table_free(&merged);
+        return -1;
+    }
+
+    table_free(&table);
+    table = merged;
+    clear_removed();
+    dirty = false;
+    return 0;
+}
+
+void dirindex_cleanup(void) {
+    dirindex_save();
+    table_free(&table);
+    clear_removed();
+    loaded = false;
+    dirty = false;
+}
+
+int dirindex_add(const char *path) {
+    if (!path || path[0] != '/' || strchr(path, '\n')) {
+        return -1;
+    }
+    const char *home = getenv("HOME");
+    if (home && strcmp(path, home) == 0) {
+        return -1;
+    }
+
+    ensure_loaded();
+    dir_entry_t *e = table_get(&table, path);
+    if (!e) {
+        return -1;
+    }
+    e->rank += 1.0;
+    e->pending += 1.0;
+    e->last = time(NULL);
+    table.total += 1.0;
+    dirty = true;
+    forget_removed(path);
+
+    if (table.total > max_age || table.count > max_entries) {
+        table_age(&table);
+    }
+    return 0;
+}
+
+int dirindex_remove(const char *path) {
+    if (!path) {
+        return -1;
+    }
+    ensure_loaded();
+    if (!table_find(&table, path)) {
+        return -1;
+    }
+
+    if (removed_count == removed_capacity) {
+        size_t capacity = removed_capacity ? removed_capacity * 2 : 8;
+        char **grown = realloc(removed, capacity * sizeof(*grown));
+        if (!grown) {
+            return -1;
+        }
+        removed = grown;
+        removed_capacity = capacity;
+    }
+    char *copy = strdup(path);
+    if (!copy) {
+        return -1;
+    }
+    removed[removed_count++] = copy;
+
+    table_filter(&table, keep_other_path, path);
+    dirty = true;
+    return 0;
+}
+
+double dirindex_score(const char *path, time_t now) {
+    if (!path) {
+        return 0.0;
+    }
+    ensure_loaded();
+    const dir_entry_t *e = table_find(&table, path);
+    return e ? frecency(e, now) : 0.0;
+}
+
+size_t dirindex_query(const char *const *fragments, size_t count,
+                      const char *within, const char *exclude,
+                      dirindex_match_t **matches) {
+    *matches = NULL;
+    ensure_loaded();
+    if (table.count == 0) {
+        return 0;
+    }
+
+    bool icase = true;
+    for (size_t i = 0; i < count; i++) {
+        if (fragments[i] && has_upper(fragments[i])) {
+            icase = false;
+            break;
+        }
+    }
+
+    dirindex_match_t *out = malloc(table.count * sizeof(*out));
+    if (!out) {
+        return 0;
+    }
+
+    time_t now = time(NULL);
+    size_t n = 0;
+    for (size_t i = 0; i < table.count; i++) {
+        const dir_entry_t *e = &table.entries[i];
+        if (exclude && strcmp(e->path, exclude) == 0) {
+            continue;
+        }
+        if (within && !is_subdirectory(e->path, within)) {
+            continue;
+        }
+        if (!path_matches(e->path, fragments, count, icase)) {
+            continue;
+        }
+        out[n].path = e->path;
+        out[n].score = frecency(e, now);
+        n++;
+    }
+
+    if (n == 0) {
+        free(out);
+        return 0;
+    }
+    qsort(out, n, sizeof(*out), compare_match);
+    *matches = out;
+    return n;
+}
+
+char *dirindex_best(const char *const *fragments, size_t count,
+                    const char *within, const char *exclude) {
+    for (;;) {
+        dirindex_match_t *matches;
+        size_t n = dirindex_query(fragments, count, within, exclude, &matches);
+        if (n == 0) {
+            return NULL;
+        }
+
+        /* Drop stale entries ahead of the first one that still exists,
+         * then query again since removal invalidates the match paths */
+        char *stale = NULL;
+        char *best = NULL;
+        for (size_t i = 0; i < n; i++) {
+            struct stat st;
+            if (stat(matches[i].path, &st) == 0) {
+                if (S_ISDIR(st.st_mode)) {
+                    best = strdup(matches[i].path);
+                } else {
+                    stale = strdup(matches[i].path);
+                }
+                break;
+            }
+            if (errno == ENOENT || errno == ENOTDIR) {
+                stale = strdup(matches[i].path);
+                break;
+            }
+        }
+        free(matches);
+
+        if (!stale) {
+            return best;
+        }
+        dirindex_remove(stale);
+        free(stale);
+    }
+}
+
+void dirindex_set_limits(size_t entries, double age) {
+    max_entries = entries > 0 ? entries : DIRINDEX_DEFAULT_MAX_ENTRIES;
+    max_age = age > 0.0 ? age : DIRINDEX_DEFAULT_MAX_AGE;
+}
+
+void dirindex_set_file(const char *path) {
+    table_free(&table);
+    clear_removed();
+    loaded = false;
+    dirty = false;
+
+    free(file_override);
+    file_override = path ? strdup(path) : NULL;
+}
+
+size_t dirindex_count(void) {
+    ensure_loaded();
+    return table.count;
+}
+
+/* ============================================================================
+ * LLE Integration
+ * ============================================================================ */
+
+/**
+ * @brief Frecency of a directory for completion ranking
+ *
+ * Overrides the weak default in the LLE completion sources.
+ */
+double lle_shell_directory_frecency(const char *path) {
+    return dirindex_score(path, time(NULL));
+}
+
+/**
+ * @brief Best indexed directories for a completion fragment
+ *
+ * Overrides the weak default in the LLE completion sources.
+ */
+size_t lle_shell_frecent_directories(const char *fragment, char **paths,
+                                     size_t max) {
+    const char *fragments[1] = {fragment};
+    dirindex_match_t *matches;
+    size_t n = dirindex_query(fragments, fragment && *fragment ? 1 : 0, NULL,
+                              NULL, &matches);
+    size_t out = 0;
+    for (size_t i = 0; i < n && out < max; i++) {
+        paths[out] = strdup(matches[i].path);
+        if (paths[out]) {
+            out++;
+        }
+    }
+    free(matches);
+    return out;
+}
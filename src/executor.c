@@ -19,6 +19,7 @@
 #include "builtins.h"
 #include "config.h"
 #include "debug.h"
+#include "extended_test.h"
 #include "ht.h"
 #include "init.h"
 #include "lle/lle_shell_event_hub.h"
@@ -26,11 +27,13 @@
 #include "lle/unicode_case.h"
 #include "lush.h"
 #include "node.h"
+#include "parse_cache.h"
 #include "parser.h"
 #include "redirection.h"
 #include "signals.h"
 #include "strings.h"
 #include "symtable.h"
+#include "xtrace.h"
 
 #include <ctype.h>
 #include <dirent.h>
@@ -74,6 +77,7 @@ static int validate_function_parameters(function_def_t *func, char **argv,
                                         int argc);
 static node_t *copy_ast_node(node_t *node);
 static node_t *copy_ast_chain(node_t *node);
+static void rebase_node_lines(node_t *node, int offset);
 static int execute_if(executor_t *executor, node_t *if_node);
 static int execute_while(executor_t *executor, node_t *while_node);
 static int execute_until(executor_t *executor, node_t *until_node);
@@ -111,7 +115,8 @@ static int execute_external_command_with_setup(executor_t *executor,
                                                char **argv,
                                                bool redirect_stderr,
                                                node_t *command);
-static int execute_builtin_command(executor_t *executor, char **argv);
+static int execute_builtin_command(executor_t *executor, char **argv,
+                                   node_t *command);
 static int execute_brace_group(executor_t *executor, node_t *group);
 static int execute_subshell(executor_t *executor, node_t *subshell);
 static int execute_negate(executor_t *executor, node_t *negate_node);
@@ -272,7 +277,11 @@ executor_t *executor_new(void) {
     executor->has_error = false;
     executor->functions = NULL;
     executor->current_script_file = NULL;
+    executor->script_files = NULL;
+    executor->script_file_count = 0;
+    executor->current_script_file_id = 0;
     executor->current_script_line = 0;
+    executor->script_line_base = 0;
     executor->in_script_execution = false;
     executor->expansion_error = false;
     executor->expansion_exit_status = 0;
@@ -292,6 +301,12 @@ executor_t *executor_new(void) {
     memset(executor->procsub_fds, -1, sizeof(executor->procsub_fds));
     memset(executor->procsub_pids, 0, sizeof(executor->procsub_pids));
 
+    /* Initialize child resource accounting */
+    memset(&executor->rusage_window, 0, sizeof(executor->rusage_window));
+    executor->rusage_children = 0;
+    memset(&executor->last_rusage, 0, sizeof(executor->last_rusage));
+    executor->last_rusage_children = 0;
+
     initialize_job_control(executor);
 
     return executor;
@@ -319,7 +334,11 @@ executor_t *executor_new_with_symtable(symtable_manager_t *symtable) {
     executor->has_error = false;
     executor->functions = NULL;
     executor->current_script_file = NULL;
+    executor->script_files = NULL;
+    executor->script_file_count = 0;
+    executor->current_script_file_id = 0;
     executor->current_script_line = 0;
+    executor->script_line_base = 0;
     executor->in_script_execution = false;
     executor->expansion_error = false;
     executor->expansion_exit_status = 0;
@@ -339,6 +358,12 @@ executor_t *executor_new_with_symtable(symtable_manager_t *symtable) {
     memset(executor->procsub_fds, -1, sizeof(executor->procsub_fds));
     memset(executor->procsub_pids, 0, sizeof(executor->procsub_pids));
 
+    /* Initialize child resource accounting */
+    memset(&executor->rusage_window, 0, sizeof(executor->rusage_window));
+    executor->rusage_children = 0;
+    memset(&executor->last_rusage, 0, sizeof(executor->last_rusage));
+    executor->last_rusage_children = 0;
+
     initialize_job_control(executor);
 
     return executor;
@@ -368,7 +393,10 @@ void executor_free(executor_t *executor) {
         }
 
         // Free script context
-        free(executor->current_script_file);
+        for (size_t i = 0; i < executor->script_file_count; i++) {
+            free(executor->script_files[i]);
+        }
+        free(executor->script_files);
 
         /* Free error context stack (Phase 3) */
         executor_clear_context(executor);
@@ -417,6 +445,46 @@ void executor_set_symtable(executor_t *executor, symtable_manager_t *symtable) {
     }
 }
 
+/**
+ * @brief Return the executor's stable copy of a script file name
+ *
+ * Names are kept until the executor is destroyed, so trace records and
+ * other borrowers stay valid while "source" switches the script context.
+ *
+ * @param executor Executor context
+ * @param script_file Script file path, or NULL
+ * @return Interned name, or NULL if script_file is NULL or copying failed
+ */
+static const char *intern_script_file(executor_t *executor,
+                                      const char *script_file) {
+    if (!script_file) {
+        return NULL;
+    }
+    if (executor->current_script_file &&
+        strcmp(executor->current_script_file, script_file) == 0) {
+        return executor->current_script_file;
+    }
+    for (size_t i = 0; i < executor->script_file_count; i++) {
+        if (strcmp(executor->script_files[i], script_file) == 0) {
+            return executor->script_files[i];
+        }
+    }
+
+    char *copy = strdup(script_file);
+    if (!copy) {
+        return NULL;
+    }
+    char **grown = realloc(executor->script_files,
+                           (executor->script_file_count + 1) * sizeof(*grown));
+    if (!grown) {
+        free(copy);
+        return NULL;
+    }
+    executor->script_files = grown;
+    executor->script_files[executor->script_file_count++] = copy;
+    return copy;
+}
+
 /**
  * @brief Set script execution context for debugging
  *
@@ -430,15 +498,28 @@ void executor_set_script_context(executor_t *executor, const char *script_file,
         return;
     }
 
-    // Free existing script file name
-    free(executor->current_script_file);
-
     // Set new script context
-    executor->current_script_file = script_file ? strdup(script_file) : NULL;
+    executor->current_script_file = intern_script_file(executor, script_file);
+    executor->current_script_file_id = debug_intern_source_file(script_file);
     executor->current_script_line = line_number;
+    executor->script_line_base = line_number;
     executor->in_script_execution = (script_file != NULL);
 }
 
+/**
+ * @brief Record the script line the next construct starts on
+ *
+ * @param executor Executor context
+ * @param line_number First line of the construct
+ */
+void executor_set_script_line(executor_t *executor, int line_number) {
+    if (!executor) {
+        return;
+    }
+    executor->current_script_line = line_number;
+    executor->script_line_base = line_number;
+}
+
 /**
  * @brief Clear script execution context
  *
@@ -449,9 +530,10 @@ void executor_clear_script_context(executor_t *executor) {
         return;
     }
 
-    free(executor->current_script_file);
     executor->current_script_file = NULL;
+    executor->current_script_file_id = 0;
     executor->current_script_line = 0;
+    executor->script_line_base = 0;
     executor->in_script_execution = false;
 }
 
@@ -475,6 +557,27 @@ int executor_get_current_script_line(executor_t *executor) {
     return executor ? executor->current_script_line : 0;
 }
 
+/**
+ * @brief Script line a command node starts on, for trace records
+ *
+ * Node locations count from the start of the construct they were parsed
+ * with; the script readers record the construct's first line in
+ * script_line_base.
+ *
+ * @param executor Executor context
+ * @param command Command node (may be NULL)
+ * @return Line number, or 0 if unknown
+ */
+static int trace_line(executor_t *executor, node_t *command) {
+    if (!command || command->loc.line == 0) {
+        return 0;
+    }
+    if (executor->script_line_base > 0) {
+        return executor->script_line_base + (int)command->loc.line - 1;
+    }
+    return (int)command->loc.line;
+}
+
 /**
  * @brief Check if executor has an error
  *
@@ -759,6 +862,150 @@ int executor_execute(executor_t *executor, node_t *ast) {
     }
 }
 
+/**
+ * @brief Publish child resource usage as $LUSH_LAST_RUSAGE
+ *
+ * Stores the usage of the children reaped by the last command line in an
+ * associative array keyed by user_us, sys_us, maxrss_kb, minflt, majflt,
+ * nvcsw, nivcsw, inblock, oublock and children.
+ *
+ * @param usage Accumulated usage
+ * @param children Number of children reaped
+ */
+static void publish_last_rusage(const struct rusage *usage, int children) {
+    array_value_t *array = symtable_array_create(true);
+    if (!array) {
+        return;
+    }
+
+    struct {
+        const char *key;
+        long long value;
+    } fields[] = {
+        {"user_us", (long long)usage->ru_utime.tv_sec * 1000000LL +
+                        usage->ru_utime.tv_usec},
+        {"sys_us", (long long)usage->ru_stime.tv_sec * 1000000LL +
+                       usage->ru_stime.tv_usec},
+        {"maxrss_kb", usage->ru_maxrss},
+        {"minflt", usage->ru_minflt},
+        {"majflt", usage->ru_majflt},
+        {"nvcsw", usage->ru_nvcsw},
+        {"nivcsw", usage->ru_nivcsw},
+        {"inblock", usage->ru_inblock},
+        {"oublock", usage->ru_oublock},
+        {"children", children},
+    };
+
+    char buf[32];
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        snprintf(buf, sizeof(buf), "%lld", fields[i].value);
+        symtable_array_set_assoc(array, fields[i].key, buf);
+    }
+
+    if (symtable_set_array("LUSH_LAST_RUSAGE", array) != 0) {
+        symtable_array_free(array);
+    }
+}
+
+/**
+ * @brief Join backslash-newline continuations
+ *
+ * Needed for -c strings, which do not go through get_input_complete()
+ * where continuations are normally handled.
+ *
+ * @param input Command line
+ * @return Newly allocated joined copy, or NULL if input needs no change
+ */
+static char *join_line_continuations(const char *input) {
+    if (strchr(input, '\\') == NULL) {
+        return NULL;
+    }
+
+    size_t len = strlen(input);
+    char *processed = malloc(len + 1);
+    if (!processed) {
+        return NULL;
+    }
+    size_t j = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (input[i] == '\\' && i + 1 < len && input[i + 1] == '\n') {
+            i++; // Skip the newline too (loop will increment past backslash)
+        } else {
+            processed[j++] = input[i];
+        }
+    }
+    processed[j] = '\0';
+    return processed;
+}
+
+/**
+ * @brief Parse a command line without executing or reporting it
+ *
+ * @param executor Executor context
+ * @param input Shell command string to parse
+ * @return AST owned by the caller, or NULL if empty or not parseable
+ */
+node_t *executor_parse_command_line(executor_t *executor, const char *input) {
+    if (!executor || !input) {
+        return NULL;
+    }
+
+    char *processed_input = join_line_continuations(input);
+    const char *source_name = executor->current_script_file
+                              ? executor->current_script_file
+                              : "<stdin>";
+    parser_t *parser = parser_new_with_source(
+        processed_input ? processed_input : input, source_name);
+    if (!parser) {
+        free(processed_input);
+        return NULL;
+    }
+
+    node_t *ast = parser_parse(parser);
+    if (parser_has_error(parser)) {
+        free_node_tree(ast);
+        ast = NULL;
+    }
+    parser_free(parser);
+    free(processed_input);
+    return ast;
+}
+
+/**
+ * @brief Execute a parsed command line
+ *
+ * Children reaped by the command line are accounted separately from any
+ * enclosing one (eval, source) and then folded back in.
+ *
+ * @param executor Executor context
+ * @param ast Parsed command line (not freed)
+ * @return Exit status of executed command
+ */
+int executor_execute_parsed(executor_t *executor, node_t *ast) {
+    if (!executor || !ast) {
+        return 1;
+    }
+
+    struct rusage outer_window = executor->rusage_window;
+    int outer_children = executor->rusage_children;
+    memset(&executor->rusage_window, 0, sizeof(executor->rusage_window));
+    executor->rusage_children = 0;
+
+    int result = executor_execute(executor, ast);
+
+    executor->last_rusage = executor->rusage_window;
+    executor->last_rusage_children = executor->rusage_children;
+    if (executor->rusage_children > 0) {
+        publish_last_rusage(&executor->last_rusage,
+                            executor->last_rusage_children);
+    }
+    executor_rusage_add(&outer_window, &executor->rusage_window);
+    executor->rusage_window = outer_window;
+    executor->rusage_children += outer_children;
+
+    return result;
+}
+
 /**
  * @brief Parse and execute a command line string
  *
@@ -774,30 +1021,8 @@ int executor_execute_command_line(executor_t *executor, const char *input) {
         return 1;
     }
 
-    // Preprocess input to handle line continuation (backslash-newline)
-    // This is needed for -c option where the string comes directly without
-    // going through get_input_complete() which normally handles this
-    char *processed_input = NULL;
-    const char *parse_input = input;
-    
-    if (strchr(input, '\\') != NULL) {
-        // May contain line continuations - preprocess
-        size_t len = strlen(input);
-        processed_input = malloc(len + 1);
-        if (processed_input) {
-            size_t j = 0;
-            for (size_t i = 0; i < len; i++) {
-                if (input[i] == '\\' && i + 1 < len && input[i + 1] == '\n') {
-                    // Skip backslash-newline (line continuation)
-                    i++; // Skip the newline too (loop will increment past backslash)
-                } else {
-                    processed_input[j++] = input[i];
-                }
-            }
-            processed_input[j] = '\0';
-            parse_input = processed_input;
-        }
-    }
+    char *processed_input = join_line_continuations(input);
+    const char *parse_input = processed_input ? processed_input : input;
 
     // Parse the input, using script filename if executing a script
     const char *source_name = executor->current_script_file 
@@ -850,7 +1075,7 @@ int executor_execute_command_line(executor_t *executor, const char *input) {
         return 0; // Empty command
     }
 
-    int result = executor_execute(executor, ast);
+    int result = executor_execute_parsed(executor, ast);
 
     free_node_tree(ast);
     parser_free(parser);
@@ -859,6 +1084,43 @@ int executor_execute_command_line(executor_t *executor, const char *input) {
     return result;
 }
 
+/**
+ * @brief Parse and execute a command line through the parse cache
+ *
+ * Used for strings the shell tends to see repeatedly (eval, source, trap
+ * and PROMPT_COMMAND): an identical string is parsed once and its tree
+ * reused. Empty strings, text that does not parse and syntax check mode
+ * go through executor_execute_command_line() so they behave, and are
+ * reported, exactly as before.
+ *
+ * @param executor Executor context
+ * @param input Shell command string to parse and execute
+ * @return Exit status of executed command, or error code
+ */
+int executor_execute_cached(executor_t *executor, const char *input) {
+    if (!executor || !input) {
+        return 1;
+    }
+    if (shell_opts.syntax_check) {
+        return executor_execute_command_line(executor, input);
+    }
+
+    char *processed_input = join_line_continuations(input);
+    const char *source_name = executor->current_script_file
+                              ? executor->current_script_file
+                              : "<stdin>";
+    parse_cache_entry_t *entry = parse_cache_acquire(
+        processed_input ? processed_input : input, source_name);
+    free(processed_input);
+    if (!entry) {
+        return executor_execute_command_line(executor, input);
+    }
+
+    int result = executor_execute_parsed(executor, parse_cache_tree(entry));
+    parse_cache_release(entry);
+    return result;
+}
+
 /**
  * @brief Core node execution dispatcher
  *
@@ -904,7 +1166,8 @@ static int execute_node(executor_t *executor, node_t *node) {
             }
         }
 
-        DEBUG_BREAKPOINT_CHECK(executor->current_script_file,
+        DEBUG_BREAKPOINT_CHECK(executor->current_script_file_id,
+                               executor->current_script_file,
                                executor->current_script_line);
 
         // Only increment line number for simple sequential commands, not
@@ -919,6 +1182,10 @@ static int execute_node(executor_t *executor, node_t *node) {
         int result = execute_command(executor, node);
         // Clean up any process substitution fds after command execution
         cleanup_procsub_fds(executor);
+        // Run traps for signals that arrived while the command ran
+        if (traps_pending()) {
+            execute_pending_traps();
+        }
         return result;
     }
     case NODE_PIPE:
@@ -1292,8 +1559,13 @@ static int execute_command(executor_t *executor, node_t *command) {
     }
 
     if (is_function_defined(executor, filtered_argv[0])) {
+        xtrace_record_t trace;
+        xtrace_begin(&trace, "function", filtered_argv,
+                     executor->current_script_file,
+                     trace_line(executor, command));
         result = execute_function_call(executor, filtered_argv[0],
                                        filtered_argv, filtered_argc);
+        xtrace_end(&trace, result);
     } else if (is_builtin_command(filtered_argv[0])) {
         // For builtin commands with stdout redirections, check if stdout is
         // captured. Only fork for "pure" builtins that don't modify shell state.
@@ -1308,7 +1580,7 @@ static int execute_command(executor_t *executor, node_t *command) {
             // Normal case: handle redirections in parent process
             redirection_state_t redir_state;
             if (has_redirections) {
-                save_file_descriptors(&redir_state);
+                save_file_descriptors(&redir_state, command);
                 int redir_result = setup_redirections(executor, command);
                 if (redir_result != 0) {
                     restore_file_descriptors(&redir_state);
@@ -1328,7 +1600,7 @@ static int execute_command(executor_t *executor, node_t *command) {
                 }
             }
 
-            result = execute_builtin_command(executor, filtered_argv);
+            result = execute_builtin_command(executor, filtered_argv, command);
 
             // Flush output streams after builtin execution
             // This ensures output appears immediately, especially under valgrind/piping
@@ -1340,6 +1612,8 @@ static int execute_command(executor_t *executor, node_t *command) {
             if (has_redirections &&
                 !(filtered_argv[0] && strcmp(filtered_argv[0], "exec") == 0)) {
                 restore_file_descriptors(&redir_state);
+            } else if (has_redirections) {
+                discard_saved_file_descriptors(&redir_state);
             }
         }
     } else {
@@ -1428,15 +1702,20 @@ static int execute_command(executor_t *executor, node_t *command) {
                             // Re-check if it's a builtin or function after
                             // correction
                             if (is_builtin_command(filtered_argv[0])) {
-                                result = execute_builtin_command(executor,
-                                                                 filtered_argv);
+                                result = execute_builtin_command(
+                                    executor, filtered_argv, command);
                                 fflush(stdout);
                                 fflush(stderr);
                             } else if (is_function_defined(executor,
                                                            filtered_argv[0])) {
+                                xtrace_record_t trace;
+                                xtrace_begin(&trace, "function", filtered_argv,
+                                             executor->current_script_file,
+                                             trace_line(executor, command));
                                 result = execute_function_call(
                                     executor, filtered_argv[0], filtered_argv,
                                     filtered_argc);
+                                xtrace_end(&trace, result);
                             } else {
                                 // Execute the corrected external command
                                 result = execute_external_command_with_setup(
@@ -1572,7 +1851,8 @@ static int execute_pipeline(executor_t *executor, node_t *pipeline) {
                            pipeline->loc, "failed to fork for pipeline: %s", strerror(errno));
         close(pipe_fd[0]);
         close(pipe_fd[1]);
-        while (waitpid(left_pid, NULL, 0) == -1 && errno == EINTR)
+        while (executor_reap_child(executor, left_pid, NULL, 0) == -1 &&
+               errno == EINTR)
             ;
         executor_pop_context(executor);
         return 1;
@@ -1597,9 +1877,11 @@ static int execute_pipeline(executor_t *executor, node_t *pipeline) {
 
     int left_status, right_status;
     // Wait for children, retrying on EINTR (signal interruption)
-    while (waitpid(left_pid, &left_status, 0) == -1 && errno == EINTR)
+    while (executor_reap_child(executor, left_pid, &left_status, 0) == -1 &&
+           errno == EINTR)
         ;
-    while (waitpid(right_pid, &right_status, 0) == -1 && errno == EINTR)
+    while (executor_reap_child(executor, right_pid, &right_status, 0) == -1 &&
+           errno == EINTR)
         ;
 
     // Extract exit codes - handle signal termination
@@ -1694,7 +1976,7 @@ static int execute_if(executor_t *executor, node_t *if_node) {
     redirection_state_t redir_state;
     
     if (has_redirections) {
-        save_file_descriptors(&redir_state);
+        save_file_descriptors(&redir_state, if_node);
         int redir_result = setup_redirections(executor, if_node);
         if (redir_result != 0) {
             restore_file_descriptors(&redir_state);
@@ -1832,7 +2114,7 @@ static int execute_while(executor_t *executor, node_t *while_node) {
     redirection_state_t redir_state;
     
     if (has_redirections) {
-        save_file_descriptors(&redir_state);
+        save_file_descriptors(&redir_state, while_node);
         int redir_result = setup_redirections(executor, while_node);
         if (redir_result != 0) {
             restore_file_descriptors(&redir_state);
@@ -1927,7 +2209,7 @@ static int execute_until(executor_t *executor, node_t *until_node) {
     redirection_state_t redir_state;
     
     if (has_redirections) {
-        save_file_descriptors(&redir_state);
+        save_file_descriptors(&redir_state, until_node);
         int redir_result = setup_redirections(executor, until_node);
         if (redir_result != 0) {
             restore_file_descriptors(&redir_state);
@@ -2025,7 +2307,7 @@ static int execute_for(executor_t *executor, node_t *for_node) {
     redirection_state_t redir_state;
     
     if (has_redirections) {
-        save_file_descriptors(&redir_state);
+        save_file_descriptors(&redir_state, for_node);
         int redir_result = setup_redirections(executor, for_node);
         if (redir_result != 0) {
             restore_file_descriptors(&redir_state);
@@ -2327,7 +2609,7 @@ static int execute_for_arith(executor_t *executor, node_t *for_arith_node) {
     redirection_state_t redir_state;
     
     if (has_redirections) {
-        save_file_descriptors(&redir_state);
+        save_file_descriptors(&redir_state, for_arith_node);
         int redir_result = setup_redirections(executor, for_arith_node);
         if (redir_result != 0) {
             restore_file_descriptors(&redir_state);
@@ -2488,7 +2770,7 @@ static int execute_select(executor_t *executor, node_t *select_node) {
     redirection_state_t redir_state;
     
     if (has_redirections) {
-        save_file_descriptors(&redir_state);
+        save_file_descriptors(&redir_state, select_node);
         int redir_result = setup_redirections(executor, select_node);
         if (redir_result != 0) {
             restore_file_descriptors(&redir_state);
@@ -2662,11 +2944,139 @@ static int execute_select(executor_t *executor, node_t *select_node) {
     return last_result;
 }
 
+/**
+ * @brief Convert a timeval to seconds
+ *
+ * @param tv Time value
+ * @return Seconds as a double
+ */
+static double timeval_seconds(const struct timeval *tv) {
+    return (double)tv->tv_sec + (double)tv->tv_usec / 1000000.0;
+}
+
+/**
+ * @brief Append a time value in TIMEFORMAT style
+ *
+ * @param out Output stream
+ * @param seconds Time in seconds
+ * @param precision Digits after the decimal point (0-3)
+ * @param long_form Use MmS.FFs form (the 'l' modifier)
+ */
+static void print_time_value(FILE *out, double seconds, int precision,
+                             bool long_form) {
+    if (long_form) {
+        int minutes = (int)(seconds / 60);
+        fprintf(out, "%dm%.*fs", minutes, precision, fmod(seconds, 60.0));
+    } else {
+        fprintf(out, "%.*f", precision, seconds);
+    }
+}
+
+/**
+ * @brief Print a time report according to a TIMEFORMAT string
+ *
+ * Supports the Bash escapes %[p][l]R, %[p][l]U, %[p][l]S, %P and %%, plus
+ * resource usage extensions taken from the children reaped while timing:
+ * %M (max resident set size, KB), %F (major page faults), %m (minor page
+ * faults), %w (voluntary context switches), %c (involuntary context
+ * switches), %I and %O (filesystem input/output blocks).
+ *
+ * @param out Output stream
+ * @param format TIMEFORMAT string
+ * @param real_time Elapsed wall clock seconds
+ * @param usage Resource usage of the timed pipeline
+ */
+static void print_time_report(FILE *out, const char *format, double real_time,
+                              const struct rusage *usage) {
+    double user_time = timeval_seconds(&usage->ru_utime);
+    double sys_time = timeval_seconds(&usage->ru_stime);
+
+    for (const char *p = format; *p; p++) {
+        if (*p != '%') {
+            fputc(*p, out);
+            continue;
+        }
+
+        p++;
+        if (*p == '\0') {
+            fputc('%', out);
+            break;
+        }
+        if (*p == '%') {
+            fputc('%', out);
+            continue;
+        }
+
+        int precision = 3;
+        bool long_form = false;
+        if (*p >= '0' && *p <= '9') {
+            precision = *p - '0';
+            if (precision > 3) {
+                precision = 3;
+            }
+            p++;
+        }
+        if (*p == 'l') {
+            long_form = true;
+            p++;
+        }
+
+        switch (*p) {
+        case 'R':
+            print_time_value(out, real_time, precision, long_form);
+            break;
+        case 'U':
+            print_time_value(out, user_time, precision, long_form);
+            break;
+        case 'S':
+            print_time_value(out, sys_time, precision, long_form);
+            break;
+        case 'P':
+            fprintf(out, "%.*f", precision > 2 ? 2 : precision,
+                    real_time > 0 ? (user_time + sys_time) * 100.0 / real_time
+                                  : 0.0);
+            break;
+        case 'M':
+            fprintf(out, "%ld", (long)usage->ru_maxrss);
+            break;
+        case 'F':
+            fprintf(out, "%ld", (long)usage->ru_majflt);
+            break;
+        case 'm':
+            fprintf(out, "%ld", (long)usage->ru_minflt);
+            break;
+        case 'w':
+            fprintf(out, "%ld", (long)usage->ru_nvcsw);
+            break;
+        case 'c':
+            fprintf(out, "%ld", (long)usage->ru_nivcsw);
+            break;
+        case 'I':
+            fprintf(out, "%ld", (long)usage->ru_inblock);
+            break;
+        case 'O':
+            fprintf(out, "%ld", (long)usage->ru_oublock);
+            break;
+        case '\0':
+            fputc('%', out);
+            p--;
+            break;
+        default:
+            // Unknown escape: print it literally
+            fputc('%', out);
+            fputc(*p, out);
+            break;
+        }
+    }
+    fputc('\n', out);
+}
+
 /**
  * @brief Execute time command
  *
  * Times the execution of a pipeline and reports real, user, and sys time.
- * With -p option, uses POSIX format.
+ * With -p option, uses POSIX format. Otherwise TIMEFORMAT is honoured,
+ * including the resource usage escapes understood by print_time_report().
  *
  * @param executor Executor context
  * @param time_node Time command node
@@ -2684,48 +3094,62 @@ static int execute_time(executor_t *executor, node_t *time_node) {
         return 0; // Nothing to time
     }
 
+    // Open a fresh accounting window so only this pipeline's children count
+    struct rusage outer_window = executor->rusage_window;
+    int outer_children = executor->rusage_children;
+    memset(&executor->rusage_window, 0, sizeof(executor->rusage_window));
+    executor->rusage_children = 0;
+
     // Get start time
     struct timeval start_time, end_time;
-    struct rusage start_usage, end_usage;
+    struct rusage start_self, end_self;
 
     gettimeofday(&start_time, NULL);
-    getrusage(RUSAGE_CHILDREN, &start_usage);
+    getrusage(RUSAGE_SELF, &start_self);
 
     // Execute the pipeline
     int result = execute_node(executor, pipeline);
 
     // Get end time
     gettimeofday(&end_time, NULL);
-    getrusage(RUSAGE_CHILDREN, &end_usage);
+    getrusage(RUSAGE_SELF, &end_self);
+
+    // Children reaped while timing, plus CPU spent in the shell itself
+    struct rusage usage = executor->rusage_window;
+    struct timeval self_user, self_sys;
+    timersub(&end_self.ru_utime, &start_self.ru_utime, &self_user);
+    timersub(&end_self.ru_stime, &start_self.ru_stime, &self_sys);
+    timeradd(&usage.ru_utime, &self_user, &usage.ru_utime);
+    timeradd(&usage.ru_stime, &self_sys, &usage.ru_stime);
+
+    // Close the window, folding this pipeline into any enclosing one
+    executor_rusage_add(&outer_window, &executor->rusage_window);
+    executor->rusage_window = outer_window;
+    executor->rusage_children += outer_children;
 
     // Calculate elapsed times
     double real_time = (end_time.tv_sec - start_time.tv_sec) +
                        (end_time.tv_usec - start_time.tv_usec) / 1000000.0;
 
-    double user_time = (end_usage.ru_utime.tv_sec - start_usage.ru_utime.tv_sec) +
-                       (end_usage.ru_utime.tv_usec - start_usage.ru_utime.tv_usec) / 1000000.0;
-
-    double sys_time = (end_usage.ru_stime.tv_sec - start_usage.ru_stime.tv_sec) +
-                      (end_usage.ru_stime.tv_usec - start_usage.ru_stime.tv_usec) / 1000000.0;
-
     // Check for TIMEFORMAT variable (Bash extension)
-    const char *timeformat = symtable_get(executor->symtable, "TIMEFORMAT");
+    char *timeformat = symtable_get(executor->symtable, "TIMEFORMAT");
 
     if (posix_format) {
         // POSIX format: real, user, sys in seconds
-        fprintf(stderr, "real %.2f\nuser %.2f\nsys %.2f\n",
-                real_time, user_time, sys_time);
-    } else if (timeformat && *timeformat) {
-        // Custom format (simplified - just show the times)
-        fprintf(stderr, "\nreal\t%.3fs\nuser\t%.3fs\nsys\t%.3fs\n",
-                real_time, user_time, sys_time);
+        fprintf(stderr, "real %.2f\nuser %.2f\nsys %.2f\n", real_time,
+                timeval_seconds(&usage.ru_utime),
+                timeval_seconds(&usage.ru_stime));
+    } else if (timeformat) {
+        // Custom format; an empty TIMEFORMAT suppresses the report
+        if (*timeformat) {
+            print_time_report(stderr, timeformat, real_time, &usage);
+        }
     } else {
         // Default Bash-like format
-        fprintf(stderr, "\nreal\t%dm%.3fs\nuser\t%dm%.3fs\nsys\t%dm%.3fs\n",
-                (int)(real_time / 60), fmod(real_time, 60.0),
-                (int)(user_time / 60), fmod(user_time, 60.0),
-                (int)(sys_time / 60), fmod(sys_time, 60.0));
+        print_time_report(stderr, "\nreal\t%3lR\nuser\t%3lU\nsys\t%3lS",
+                          real_time, &usage);
     }
+    free(timeformat);
 
     return result;
 }
@@ -3878,8 +4302,14 @@ static int execute_external_command_with_redirection(executor_t *executor,
         fflush(stderr);
     }
 
+    // Trace external command if -x is enabled; timing covers fork and exec
+    xtrace_record_t trace;
+    xtrace_begin(&trace, "external", argv, executor->current_script_file,
+                 0);
+
     pid_t pid = fork();
     if (pid == -1) {
+        xtrace_end(&trace, 1);
         set_executor_error(executor, "Failed to fork");
         return 1;
     }
@@ -3911,36 +4341,17 @@ static int execute_external_command_with_redirection(executor_t *executor,
         // Parent process
         set_current_child_pid(pid);
 
-        // Print trace for external command if -x is enabled
-        if (should_trace_execution()) {
-            // Build command string from argv for tracing
-            size_t cmd_len = 1; // for null terminator
-            for (int j = 0; argv[j]; j++) {
-                cmd_len += strlen(argv[j]) + (j > 0 ? 1 : 0); // +1 for space
-            }
-
-            char *cmd_str = malloc(cmd_len);
-            if (cmd_str) {
-                strcpy(cmd_str, argv[0]);
-                for (int j = 1; argv[j]; j++) {
-                    strcat(cmd_str, " ");
-                    strcat(cmd_str, argv[j]);
-                }
-                print_command_trace(cmd_str);
-                free(cmd_str);
-            }
-        }
-
         // Enhanced debug tracing for external commands
         DEBUG_TRACE_COMMAND(argv[0], argv, 0);
         DEBUG_PROFILE_ENTER(argv[0]);
 
         int status;
         // Wait for child, retrying on EINTR (signal interruption)
-        while (waitpid(pid, &status, 0) == -1) {
+        while (executor_reap_child(executor, pid, &status, 0) == -1) {
             if (errno != EINTR) {
                 // Real error - child may have already been reaped
                 clear_current_child_pid();
+                xtrace_end(&trace, 1);
                 return 1;
             }
             // EINTR - signal interrupted wait, continue waiting
@@ -3950,14 +4361,16 @@ static int execute_external_command_with_redirection(executor_t *executor,
         DEBUG_PROFILE_EXIT(argv[0]);
 
         // Handle exit status properly - child may have exited or been signaled
+        int exit_status = 1;
         if (WIFEXITED(status)) {
-            return WEXITSTATUS(status);
+            exit_status = WEXITSTATUS(status);
         } else if (WIFSIGNALED(status)) {
             // Child was killed by signal - return 128 + signal number (bash
             // convention)
-            return 128 + WTERMSIG(status);
+            exit_status = 128 + WTERMSIG(status);
         }
-        return 1;
+        xtrace_end(&trace, exit_status);
+        return exit_status;
     }
 }
 
@@ -4014,7 +4427,7 @@ static int execute_brace_group(executor_t *executor, node_t *group) {
     redirection_state_t redir_state;
     
     if (has_redirections) {
-        save_file_descriptors(&redir_state);
+        save_file_descriptors(&redir_state, group);
         int redir_result = setup_redirections(executor, group);
         if (redir_result != 0) {
             restore_file_descriptors(&redir_state);
@@ -4124,7 +4537,8 @@ static int execute_subshell(executor_t *executor, node_t *subshell) {
         // Parent process - wait for subshell to complete
         int status;
         // Wait for child, retrying on EINTR (signal interruption)
-        while (waitpid(pid, &status, 0) == -1 && errno == EINTR)
+        while (executor_reap_child(executor, pid, &status, 0) == -1 &&
+               errno == EINTR)
             ;
 
         int result;
@@ -6010,8 +6424,14 @@ static int execute_external_command_with_setup(executor_t *executor,
         fflush(stderr);
     }
 
+    // Trace external command if -x is enabled; timing covers fork and exec
+    xtrace_record_t trace;
+    xtrace_begin(&trace, "external", argv, executor->current_script_file,
+                 trace_line(executor, command));
+
     pid_t pid = fork();
     if (pid == -1) {
+        xtrace_end(&trace, 1);
         set_executor_error(executor, "Failed to fork");
         return 1;
     }
@@ -6048,36 +6468,17 @@ static int execute_external_command_with_setup(executor_t *executor,
         // Parent process
         set_current_child_pid(pid);
 
-        // Print trace for external command if -x is enabled
-        if (should_trace_execution()) {
-            // Build command string from argv for tracing
-            size_t cmd_len = 1; // for null terminator
-            for (int j = 0; argv[j]; j++) {
-                cmd_len += strlen(argv[j]) + (j > 0 ? 1 : 0); // +1 for space
-            }
-
-            char *cmd_str = malloc(cmd_len);
-            if (cmd_str) {
-                strcpy(cmd_str, argv[0]);
-                for (int j = 1; argv[j]; j++) {
-                    strcat(cmd_str, " ");
-                    strcat(cmd_str, argv[j]);
-                }
-                print_command_trace(cmd_str);
-                free(cmd_str);
-            }
-        }
-
         // Enhanced debug tracing for external commands with setup
         DEBUG_TRACE_COMMAND(argv[0], argv, 0);
         DEBUG_PROFILE_ENTER(argv[0]);
 
         int status;
         // Wait for child, retrying on EINTR (signal interruption)
-        while (waitpid(pid, &status, 0) == -1) {
+        while (executor_reap_child(executor, pid, &status, 0) == -1) {
             if (errno != EINTR) {
                 // Real error - child may have already been reaped
                 clear_current_child_pid();
+                xtrace_end(&trace, 1);
                 return 1;
             }
             // EINTR - signal interrupted wait, continue waiting
@@ -6087,14 +6488,16 @@ static int execute_external_command_with_setup(executor_t *executor,
         DEBUG_PROFILE_EXIT(argv[0]);
 
         // Handle exit status properly - child may have exited or been signaled
+        int exit_status = 1;
         if (WIFEXITED(status)) {
-            return WEXITSTATUS(status);
+            exit_status = WEXITSTATUS(status);
         } else if (WIFSIGNALED(status)) {
             // Child was killed by signal - return 128 + signal number (bash
             // convention)
-            return 128 + WTERMSIG(status);
+            exit_status = 128 + WTERMSIG(status);
         }
-        return 1;
+        xtrace_end(&trace, exit_status);
+        return exit_status;
     }
 }
 
@@ -6109,9 +6512,11 @@ static int execute_test_builtin(executor_t *executor, char **argv);
  *
  * @param executor Executor context
  * @param argv NULL-terminated argument vector
+ * @param command Command node, for the trace location (may be NULL)
  * @return Exit status of builtin command
  */
-static int execute_builtin_command(executor_t *executor, char **argv) {
+static int execute_builtin_command(executor_t *executor, char **argv,
+                                   node_t *command) {
     if (!argv || !argv[0]) {
         return 1;
     }
@@ -6119,43 +6524,27 @@ static int execute_builtin_command(executor_t *executor, char **argv) {
     // Set global executor for job control builtins
     current_executor = executor;
 
-    // Find the builtin function in the builtin table
-    for (size_t i = 0; i < builtins_count; i++) {
-        if (strcmp(argv[0], builtins[i].name) == 0) {
-            // Print trace for builtin command if -x is enabled
-            if (should_trace_execution()) {
-                // Build command string from argv for tracing
-                size_t cmd_len = 1; // for null terminator
-                for (int j = 0; argv[j]; j++) {
-                    cmd_len +=
-                        strlen(argv[j]) + (j > 0 ? 1 : 0); // +1 for space
-                }
-
-                char *cmd_str = malloc(cmd_len);
-                if (cmd_str) {
-                    strcpy(cmd_str, argv[0]);
-                    for (int j = 1; argv[j]; j++) {
-                        strcat(cmd_str, " ");
-                        strcat(cmd_str, argv[j]);
-                    }
-                    print_command_trace(cmd_str);
-                    free(cmd_str);
-                }
-            }
+    // Find the builtin function (core table, then loadable builtins)
+    const builtin *entry = builtin_lookup(argv[0]);
+    if (entry) {
+        // Trace builtin command if -x is enabled
+        xtrace_record_t trace;
+        xtrace_begin(&trace, "builtin", argv, executor->current_script_file,
+                     trace_line(executor, command));
 
-            // Count arguments
-            int argc = 0;
-            while (argv[argc]) {
-                argc++;
-            }
+        // Count arguments
+        int argc = 0;
+        while (argv[argc]) {
+            argc++;
+        }
 
-            int result = builtins[i].func(argc, argv);
+        int result = entry->func(argc, argv);
+        xtrace_end(&trace, result);
 
-            // Clear global executor
-            current_executor = NULL;
+        // Clear global executor
+        current_executor = NULL;
 
-            return result;
-        }
+        return result;
     }
 
     // Clear global executor
@@ -6503,7 +6892,7 @@ static int execute_case(executor_t *executor, node_t *node) {
     redirection_state_t redir_state;
 
     if (has_redirections) {
-        save_file_descriptors(&redir_state);
+        save_file_descriptors(&redir_state, node);
         int redir_result = setup_redirections(executor, node);
         if (redir_result != 0) {
             restore_file_descriptors(&redir_state);
@@ -6823,6 +7212,10 @@ static int execute_function_call(executor_t *executor,
     source_location_t func_loc = func->body ? func->body->loc : SOURCE_LOC_UNKNOWN;
     executor_push_context(executor, func_loc, "in function '%s'", function_name);
 
+    // Body lines are already script lines (see store_function)
+    int saved_line_base = executor->script_line_base;
+    executor->script_line_base = 0;
+
     // Execute function body (handle multiple commands)
     int result = 0;
     node_t *command = func->body;
@@ -6834,6 +7227,8 @@ static int execute_function_call(executor_t *executor,
             // Extract the actual return value from the special code
             int actual_return = result - 200;
 
+            executor->script_line_base = saved_line_base;
+
             /* Pop function context before returning */
             executor_pop_context(executor);
 
@@ -6849,6 +7244,8 @@ static int execute_function_call(executor_t *executor,
         command = command->next_sibling;
     }
 
+    executor->script_line_base = saved_line_base;
+
     /* Pop function context */
     executor_pop_context(executor);
 
@@ -7053,6 +7450,12 @@ static int store_function(executor_t *executor, const char *function_name,
         return 1;
     }
 
+    // The body outlives the construct it was parsed with; make its lines
+    // script lines (execute_function_call runs it with no line base)
+    if (executor->script_line_base > 1) {
+        rebase_node_lines(new_func->body, executor->script_line_base - 1);
+    }
+
     // Store parameter information
     new_func->params = params;
     new_func->param_count = param_count;
@@ -7061,9 +7464,57 @@ static int store_function(executor_t *executor, const char *function_name,
     new_func->next = executor->functions;
     executor->functions = new_func;
 
+    autocorrect_index_add(function_name, AUTOCORRECT_SOURCE_FUNCTION);
+
     return 0;
 }
 
+/** Source names referenced by stored function bodies */
+static ht_strstr_t *function_source_names = NULL;
+
+/**
+ * @brief Get a copy of a source name that lives as long as the shell
+ *
+ * Node locations point at the source name of the parser that built
+ * them, which belongs to the script context of the moment. Function
+ * bodies outlive that context, so their copies point here instead.
+ *
+ * @param name Source name (may be NULL)
+ * @return Shared copy, or NULL
+ */
+static const char *stable_source_name(const char *name) {
+    if (!name) {
+        return NULL;
+    }
+    if (!function_source_names) {
+        function_source_names = ht_strstr_create(HT_STR_NONE);
+        if (!function_source_names) {
+            return NULL;
+        }
+    }
+    const char *kept = ht_strstr_get(function_source_names, name);
+    if (!kept) {
+        ht_strstr_insert(function_source_names, name, name);
+        kept = ht_strstr_get(function_source_names, name);
+    }
+    return kept;
+}
+
+/**
+ * @brief Shift the known line numbers of a node chain and its children
+ *
+ * @param node First node in chain
+ * @param offset Lines to add
+ */
+static void rebase_node_lines(node_t *node, int offset) {
+    for (; node; node = node->next_sibling) {
+        if (node->loc.line > 0) {
+            node->loc.line += (size_t)offset;
+        }
+        rebase_node_lines(node->first_child, offset);
+    }
+}
+
 /**
  * @brief Copy an AST node recursively
  *
@@ -7083,6 +7534,10 @@ static node_t *copy_ast_node(node_t *node) {
         return NULL;
     }
 
+    // Copy location, with a source name that outlives the original tree
+    copy->loc = node->loc;
+    copy->loc.filename = stable_source_name(node->loc.filename);
+
     // Copy value
     copy->val_type = node->val_type;
     if (node->val.str) {
@@ -10101,10 +10556,227 @@ static char *expand_arithmetic(executor_t *executor, const char *arith_text) {
 }
 
 /**
- * @brief Expand command substitution $(...) or `...`
+ * @brief Append text to a growing file substitution word
  *
- * Forks a child process to execute the command and captures its stdout.
- * Trailing newlines are stripped from the output. Uses the shell's own
+ * @param buf Buffer to grow (freed on failure)
+ * @param len Current length, updated
+ * @param text Text to append
+ * @param escape_glob Backslash-escape glob characters (quoted text)
+ * @return false on allocation failure
+ */
+static bool append_file_word(char **buf, size_t *len, const char *text,
+                             bool escape_glob) {
+    size_t extra = strlen(text);
+    if (escape_glob) {
+        extra *= 2;
+    }
+    char *grown = realloc(*buf, *len + extra + 1);
+    if (!grown) {
+        free(*buf);
+        *buf = NULL;
+        return false;
+    }
+    *buf = grown;
+    for (const char *p = text; *p; p++) {
+        if (escape_glob && strchr("*?[]\\", *p)) {
+            grown[(*len)++] = '\\';
+        }
+        grown[(*len)++] = *p;
+    }
+    grown[*len] = '\0';
+    return true;
+}
+
+/**
+ * @brief Expand the target word of $(<word)
+ *
+ * The word is every token adjacent to the first one, as for a redirection
+ * target. Each token is expanded by its quoting, then the whole word is
+ * globbed unless set -f is on; a pattern matching several files is an
+ * ambiguous redirect.
+ *
+ * @param executor Executor context
+ * @param tokenizer Tokenizer positioned on the first token of the word
+ * @return Path to read (caller must free), or NULL if the command is not a
+ *         lone redirection
+ */
+static char *expand_file_substitution_target(executor_t *executor,
+                                             tokenizer_t *tokenizer) {
+    char *path = NULL;
+    char *pattern = NULL;
+    size_t path_len = 0;
+    size_t pattern_len = 0;
+    bool has_glob = false;
+    bool first = true;
+
+    token_t *word = tokenizer_current(tokenizer);
+    while (word && (word->type == TOK_WORD || word->type == TOK_STRING ||
+                    word->type == TOK_EXPANDABLE_STRING ||
+                    word->type == TOK_VARIABLE ||
+                    word->type == TOK_COMMAND_SUB ||
+                    word->type == TOK_BACKQUOTE ||
+                    word->type == TOK_ARITH_EXP)) {
+        if (!first && word->position > 0 &&
+            isspace((unsigned char)tokenizer->input[word->position - 1])) {
+            break;
+        }
+
+        bool quoted = word->type == TOK_STRING ||
+                      word->type == TOK_EXPANDABLE_STRING;
+        char *part;
+        if (word->type == TOK_STRING) {
+            part = strdup(word->text);
+        } else if (word->type == TOK_EXPANDABLE_STRING) {
+            part = expand_quoted_string(executor, word->text);
+        } else if (first && word->text[0] == '~') {
+            part = expand_tilde(word->text);
+        } else {
+            part = expand_if_needed(executor, word->text);
+        }
+        if (!part) {
+            part = strdup("");
+        }
+        if (!quoted && strpbrk(part, "*?[")) {
+            has_glob = true;
+        }
+        bool ok = part && append_file_word(&path, &path_len, part, false) &&
+                  append_file_word(&pattern, &pattern_len, part, quoted);
+        free(part);
+        if (!ok) {
+            free(path);
+            free(pattern);
+            return strdup("");
+        }
+
+        first = false;
+        tokenizer_advance(tokenizer);
+        word = tokenizer_current(tokenizer);
+    }
+
+    while (word && word->type == TOK_NEWLINE) {
+        tokenizer_advance(tokenizer);
+        word = tokenizer_current(tokenizer);
+    }
+    if (first || !word || word->type != TOK_EOF) {
+        free(path);
+        free(pattern);
+        return NULL;
+    }
+
+    if (path_len == 0) {
+        fprintf(stderr, "lush: ambiguous redirect\n");
+    } else if (has_glob && !shell_opts.no_globbing) {
+        glob_t globbuf;
+        int rc = glob(pattern, 0, NULL, &globbuf);
+        if (rc == 0 && globbuf.gl_pathc == 1) {
+            free(path);
+            path = strdup(globbuf.gl_pathv[0]);
+        } else if (rc == 0) {
+            fprintf(stderr, "lush: %s: ambiguous redirect\n", path);
+            free(path);
+            path = NULL;
+        }
+        if (rc == 0) {
+            globfree(&globbuf);
+        }
+    }
+    free(pattern);
+    return path ? path : strdup("");
+}
+
+/**
+ * @brief Expand $(<file) by reading the file in the shell
+ *
+ * $(<file) has the output of $(cat file) without starting a process. Only
+ * a lone input redirection is handled here; anything else returns NULL and
+ * runs in a subshell as usual.
+ *
+ * @param executor Executor context
+ * @param command Command text inside the substitution
+ * @return File contents without trailing newlines (caller must free), or
+ *         NULL if the command is not of this form
+ */
+static char *read_file_substitution(executor_t *executor,
+                                    const char *command) {
+    const char *p = command;
+    while (*p == ' ' || *p == '\t' || *p == '\n') {
+        p++;
+    }
+    if (*p != '<') {
+        return NULL;
+    }
+
+    tokenizer_t *tokenizer = tokenizer_new(command);
+    if (!tokenizer) {
+        return NULL;
+    }
+
+    char *path = NULL;
+    token_t *redir = tokenizer_current(tokenizer);
+    if (redir && redir->type == TOK_REDIRECT_IN) {
+        tokenizer_advance(tokenizer);
+        path = expand_file_substitution_target(executor, tokenizer);
+    }
+    tokenizer_free(tokenizer);
+
+    if (!path) {
+        return NULL;
+    }
+    if (!*path) {
+        free(path);
+        executor->exit_status = 1;
+        return strdup("");
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        fprintf(stderr, "lush: %s: %s\n", path, strerror(errno));
+        free(path);
+        executor->exit_status = 1;
+        return strdup("");
+    }
+    free(path);
+
+    size_t capacity = 4096;
+    size_t length = 0;
+    char *output = malloc(capacity);
+    ssize_t n = 0;
+    while (output) {
+        if (length + 1 >= capacity) {
+            char *grown = realloc(output, capacity * 2);
+            if (!grown) {
+                free(output);
+                output = NULL;
+                break;
+            }
+            output = grown;
+            capacity *= 2;
+        }
+        n = read(fd, output + length, capacity - length - 1);
+        if (n > 0) {
+            length += (size_t)n;
+        } else if (n == 0 || errno != EINTR) {
+            break;
+        }
+    }
+    close(fd);
+
+    if (!output) {
+        return strdup("");
+    }
+    while (length > 0 && output[length - 1] == '\n') {
+        length--;
+    }
+    output[length] = '\0';
+    executor->exit_status = n < 0 ? 1 : 0;
+    return output;
+}
+
+/**
+ * @brief Expand command substitution $(...) or `...`
+ *
+ * Forks a child process to execute the command and captures its stdout.
+ * Trailing newlines are stripped from the output. Uses the shell's own
  * parser/executor to preserve function definitions.
  *
  * @param executor Executor context
@@ -10146,6 +10818,13 @@ static char *expand_command_substitution(executor_t *executor,
         }
     }
 
+    // $(<file) reads the file without forking
+    char *file_contents = read_file_substitution(executor, command);
+    if (file_contents) {
+        free(command);
+        return file_contents;
+    }
+
     // Expand variables in the command before executing it
     char *expanded_command = expand_variables_in_string(executor, command);
     free(command);
@@ -10210,7 +10889,8 @@ static char *expand_command_substitution(executor_t *executor,
 
         if (!output) {
             close(pipefd[0]);
-            while (waitpid(pid, NULL, 0) == -1 && errno == EINTR)
+            while (executor_reap_child(executor, pid, NULL, 0) == -1 &&
+                   errno == EINTR)
                 ;
             return strdup("");
         }
@@ -10220,7 +10900,8 @@ static char *expand_command_substitution(executor_t *executor,
 
         // Wait for child process to complete first, retrying on EINTR
         int status;
-        while (waitpid(pid, &status, 0) == -1 && errno == EINTR)
+        while (executor_reap_child(executor, pid, &status, 0) == -1 &&
+               errno == EINTR)
             ;
 
         // Propagate child's exit status to executor for $? access
@@ -11103,6 +11784,7 @@ static process_t *create_process(pid_t pid, const char *command) {
     proc->pid = pid;
     proc->command = command ? strdup(command) : NULL;
     proc->status = 0;
+    memset(&proc->rusage, 0, sizeof(proc->rusage));
     proc->next = NULL;
 
     return proc;
@@ -11150,6 +11832,7 @@ job_t *executor_add_job(executor_t *executor, pid_t pgid,
     job->foreground = false;
     job->processes = NULL;
     job->command_line = command_line ? strdup(command_line) : NULL;
+    memset(&job->rusage, 0, sizeof(job->rusage));
     job->next = executor->jobs;
 
     executor->jobs = job;
@@ -11231,7 +11914,8 @@ void executor_update_job_status(executor_t *executor) {
 
         if (job->state == JOB_RUNNING) {
             int status;
-            pid_t result = waitpid(-job->pgid, &status, WNOHANG | WUNTRACED);
+            pid_t result = executor_reap_child(executor, -job->pgid, &status,
+                                               WNOHANG | WUNTRACED);
 
             if (result > 0) {
                 if (WIFEXITED(status) || WIFSIGNALED(status)) {
@@ -11251,6 +11935,87 @@ void executor_update_job_status(executor_t *executor) {
     }
 }
 
+/**
+ * @brief Add one rusage record into an accumulator
+ *
+ * @param acc Accumulator to update
+ * @param ru Usage to add
+ */
+void executor_rusage_add(struct rusage *acc, const struct rusage *ru) {
+    if (!acc || !ru) {
+        return;
+    }
+
+    timeradd(&acc->ru_utime, &ru->ru_utime, &acc->ru_utime);
+    timeradd(&acc->ru_stime, &ru->ru_stime, &acc->ru_stime);
+    if (ru->ru_maxrss > acc->ru_maxrss) {
+        acc->ru_maxrss = ru->ru_maxrss;
+    }
+    acc->ru_minflt += ru->ru_minflt;
+    acc->ru_majflt += ru->ru_majflt;
+    acc->ru_inblock += ru->ru_inblock;
+    acc->ru_oublock += ru->ru_oublock;
+    acc->ru_nvcsw += ru->ru_nvcsw;
+    acc->ru_nivcsw += ru->ru_nivcsw;
+}
+
+/**
+ * @brief Record the resource usage of a terminated child
+ *
+ * Adds the usage to the executor's accounting window and to the job
+ * (and process record) that owns the pid, if any.
+ *
+ * @param executor Executor context
+ * @param pid Reaped process ID
+ * @param ru Usage returned by wait4()
+ */
+static void record_child_rusage(executor_t *executor, pid_t pid,
+                                const struct rusage *ru) {
+    executor_rusage_add(&executor->rusage_window, ru);
+    executor->rusage_children++;
+
+    for (job_t *job = executor->jobs; job; job = job->next) {
+        bool owned = (job->pgid == pid);
+        for (process_t *proc = job->processes; proc; proc = proc->next) {
+            if (proc->pid == pid) {
+                proc->rusage = *ru;
+                owned = true;
+            }
+        }
+        if (owned) {
+            executor_rusage_add(&job->rusage, ru);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Reap a child process and record its resource usage
+ *
+ * @param executor Executor context (may be NULL to skip accounting)
+ * @param pid Process (or -pgid) to wait for, as for waitpid()
+ * @param status Where to store the wait status (may be NULL)
+ * @param options waitpid() options
+ * @return Reaped pid, 0 for WNOHANG with nothing to reap, -1 on error
+ */
+pid_t executor_reap_child(executor_t *executor, pid_t pid, int *status,
+                          int options) {
+    int local_status = 0;
+    struct rusage ru;
+
+    pid_t reaped = wait4(pid, &local_status, options, &ru);
+    if (reaped > 0) {
+        if (status) {
+            *status = local_status;
+        }
+        if (executor &&
+            (WIFEXITED(local_status) || WIFSIGNALED(local_status))) {
+            record_child_rusage(executor, reaped, &ru);
+        }
+    }
+    return reaped;
+}
+
 /**
  * @brief Count active jobs
  *
@@ -11451,7 +12216,7 @@ int executor_builtin_fg(executor_t *executor, char **argv) {
 
     // Wait for the job to complete or stop
     int status;
-    waitpid(-job->pgid, &status, WUNTRACED);
+    executor_reap_child(executor, -job->pgid, &status, WUNTRACED);
 
     // Reclaim terminal control for the shell
     if (isatty(STDIN_FILENO)) {
@@ -11625,7 +12390,7 @@ static int execute_builtin_with_captured_stdout(executor_t *executor,
         }
 
         // Execute the builtin command
-        int result = execute_builtin_command(executor, argv);
+        int result = execute_builtin_command(executor, argv, command);
         
         // Flush stdio buffers before _exit() - critical for file redirections
         // Without this, output redirected to files would be lost because
@@ -11637,7 +12402,7 @@ static int execute_builtin_with_captured_stdout(executor_t *executor,
     } else {
         // Parent process - wait for child, retrying on EINTR
         int status;
-        while (waitpid(pid, &status, 0) == -1) {
+        while (executor_reap_child(executor, pid, &status, 0) == -1) {
             if (errno != EINTR) {
                 set_executor_error(executor,
                                    "Failed to wait for builtin child process");
@@ -11758,513 +12523,47 @@ static int execute_arithmetic_command(executor_t *executor,
 }
 
 /**
- * @brief Match a string against a glob pattern
+ * @brief Expand one [[ ]] operand
  *
- * Uses fnmatch for shell-style pattern matching.
- *
- * @param str String to match
- * @param pattern Glob pattern
- * @return true if matches, false otherwise
+ * @param ctx Executor context
+ * @param word Operand text
+ * @return Newly allocated expansion
  */
-static bool extended_test_pattern_match(const char *str, const char *pattern) {
-    if (!str || !pattern) {
-        return false;
-    }
-    // FNM_EXTMATCH would enable extended patterns, but isn't portable
-    return fnmatch(pattern, str, 0) == 0;
-}
-
-/**
- * @brief Match a string against a regex and populate BASH_REMATCH
- *
- * Uses POSIX extended regular expressions. Capture groups are stored
- * in the BASH_REMATCH array variable.
- *
- * @param executor Executor context (for setting BASH_REMATCH)
- * @param str String to match
- * @param pattern Regex pattern
- * @return true if matches, false otherwise
- */
-static bool extended_test_regex_match(executor_t *executor, const char *str,
-                                      const char *pattern) {
-    if (!str || !pattern) {
-        return false;
-    }
-
-    regex_t regex;
-    int ret = regcomp(&regex, pattern, REG_EXTENDED);
-    if (ret != 0) {
-        // Regex compilation failed
-        if (executor->debug) {
-            char errbuf[256];
-            regerror(ret, &regex, errbuf, sizeof(errbuf));
-            printf("DEBUG: Regex compilation failed: %s\n", errbuf);
-        }
-        return false;
-    }
-
-    // Match with capture groups (up to 10 groups)
-    regmatch_t matches[10];
-    ret = regexec(&regex, str, 10, matches, 0);
-
-    if (ret == 0) {
-        // Match successful - populate BASH_REMATCH array
-        // Use symtable_set_array_element which handles array creation
-        for (int i = 0; i < 10 && matches[i].rm_so != -1; i++) {
-            size_t match_len = matches[i].rm_eo - matches[i].rm_so;
-            char *match_str = malloc(match_len + 1);
-            if (match_str) {
-                strncpy(match_str, str + matches[i].rm_so, match_len);
-                match_str[match_len] = '\0';
-                
-                // Convert index to string for subscript
-                char subscript[16];
-                snprintf(subscript, sizeof(subscript), "%d", i);
-                symtable_set_array_element("BASH_REMATCH", subscript, match_str);
-                free(match_str);
-            }
-        }
-        regfree(&regex);
-        return true;
-    }
-
-    regfree(&regex);
-    return false;
-}
-
-/**
- * @brief Evaluate a file test operator
- *
- * Handles file test operators like -f, -d, -e, -r, -w, -x, etc.
- *
- * @param op The operator (e.g., "-f", "-d")
- * @param path The file path to test
- * @return true if test passes, false otherwise
- */
-static bool extended_test_file_test(const char *op, const char *path) {
-    if (!op || !path) {
-        return false;
-    }
-
-    struct stat st;
-    bool exists = (stat(path, &st) == 0);
-
-    if (strcmp(op, "-e") == 0) {
-        return exists;
-    } else if (strcmp(op, "-f") == 0) {
-        return exists && S_ISREG(st.st_mode);
-    } else if (strcmp(op, "-d") == 0) {
-        return exists && S_ISDIR(st.st_mode);
-    } else if (strcmp(op, "-r") == 0) {
-        return access(path, R_OK) == 0;
-    } else if (strcmp(op, "-w") == 0) {
-        return access(path, W_OK) == 0;
-    } else if (strcmp(op, "-x") == 0) {
-        return access(path, X_OK) == 0;
-    } else if (strcmp(op, "-s") == 0) {
-        return exists && st.st_size > 0;
-    } else if (strcmp(op, "-L") == 0 || strcmp(op, "-h") == 0) {
-        struct stat lst;
-        return (lstat(path, &lst) == 0) && S_ISLNK(lst.st_mode);
-    } else if (strcmp(op, "-b") == 0) {
-        return exists && S_ISBLK(st.st_mode);
-    } else if (strcmp(op, "-c") == 0) {
-        return exists && S_ISCHR(st.st_mode);
-    } else if (strcmp(op, "-p") == 0) {
-        return exists && S_ISFIFO(st.st_mode);
-    } else if (strcmp(op, "-S") == 0) {
-        return exists && S_ISSOCK(st.st_mode);
-    } else if (strcmp(op, "-g") == 0) {
-        return exists && (st.st_mode & S_ISGID);
-    } else if (strcmp(op, "-u") == 0) {
-        return exists && (st.st_mode & S_ISUID);
-    } else if (strcmp(op, "-k") == 0) {
-        return exists && (st.st_mode & S_ISVTX);
-    } else if (strcmp(op, "-O") == 0) {
-        return exists && (st.st_uid == getuid());
-    } else if (strcmp(op, "-G") == 0) {
-        return exists && (st.st_gid == getgid());
-    }
-
-    return false;
+static char *extended_test_expand(void *ctx, const char *word) {
+    return expand_if_needed((executor_t *)ctx, word);
 }
 
 /**
  * @brief Execute an extended test command [[ expression ]]
  *
- * Evaluates the conditional expression within [[ ]].
- * Supports string comparisons, pattern matching, regex matching,
- * file tests, and logical operators.
+ * Evaluates the expression compiled by the parser, compiling it here for
+ * nodes that were not built by the parser (copied function bodies, trees
+ * loaded from the startup cache). Supports string comparisons, pattern
+ * matching, regex matching, file tests, and logical operators.
  *
  * @param executor Executor context
  * @param test_node Extended test node with expression in val.str
  * @return 0 if test passes (true), 1 if fails (false)
  */
-
-// Forward declaration for recursive evaluation
-static bool evaluate_simple_test(executor_t *executor, const char *expr);
-
-/**
- * @brief Find a logical operator (&& or ||) at the top level
- *
- * Scans for && or || that is not inside parentheses.
- * Returns pointer to the operator or NULL if not found.
- * Also sets op_len to 2 if found.
- */
-static char *find_logical_operator(char *expr, int *op_len, char *op_type) {
-    int paren_depth = 0;
-    char *p = expr;
-    
-    while (*p) {
-        if (*p == '(') {
-            paren_depth++;
-        } else if (*p == ')') {
-            paren_depth--;
-        } else if (paren_depth == 0) {
-            // Check for || first (lower precedence, so we want to split on it first)
-            if (p[0] == '|' && p[1] == '|') {
-                *op_len = 2;
-                *op_type = '|';
-                return p;
-            }
-            // Check for &&
-            if (p[0] == '&' && p[1] == '&') {
-                *op_len = 2;
-                *op_type = '&';
-                return p;
-            }
-        }
-        p++;
-    }
-    return NULL;
-}
-
-/**
- * @brief Evaluate an extended test expression with && and ||
- *
- * Recursively evaluates expressions, handling:
- * - || (OR) with lowest precedence
- * - && (AND) with higher precedence
- * - Parentheses for grouping
- * - Simple test expressions
- */
-static bool evaluate_extended_expr(executor_t *executor, char *expr) {
-    // Trim whitespace
-    while (*expr && isspace(*expr)) expr++;
-    char *end = expr + strlen(expr) - 1;
-    while (end > expr && isspace(*end)) *end-- = '\0';
-    
-    if (*expr == '\0') {
-        return false;
-    }
-    
-    // Check if entire expression is wrapped in parentheses
-    if (*expr == '(' && *(expr + strlen(expr) - 1) == ')') {
-        // Check if they match (not just opening and closing from different groups)
-        int depth = 0;
-        bool matched = true;
-        for (char *p = expr; *p; p++) {
-            if (*p == '(') depth++;
-            else if (*p == ')') depth--;
-            if (depth == 0 && *(p+1) != '\0') {
-                matched = false;
-                break;
-            }
-        }
-        if (matched) {
-            // Strip outer parentheses
-            char *inner = expr + 1;
-            expr[strlen(expr) - 1] = '\0';
-            return evaluate_extended_expr(executor, inner);
-        }
-    }
-    
-    // Look for || first (lowest precedence)
-    int op_len = 0;
-    char op_type = 0;
-    char *op_pos = find_logical_operator(expr, &op_len, &op_type);
-    
-    if (op_pos && op_type == '|') {
-        // Split on ||
-        *op_pos = '\0';
-        char *left = expr;
-        char *right = op_pos + 2;
-        
-        // Short-circuit: if left is true, don't evaluate right
-        if (evaluate_extended_expr(executor, left)) {
-            return true;
-        }
-        return evaluate_extended_expr(executor, right);
-    }
-    
-    // Look for && (higher precedence than ||)
-    op_pos = NULL;
-    op_len = 0;
-    op_type = 0;
-    
-    // Re-scan for && only
-    int paren_depth = 0;
-    for (char *p = expr; *p; p++) {
-        if (*p == '(') paren_depth++;
-        else if (*p == ')') paren_depth--;
-        else if (paren_depth == 0 && p[0] == '&' && p[1] == '&') {
-            op_pos = p;
-            op_len = 2;
-            op_type = '&';
-            break;
-        }
-    }
-    
-    if (op_pos && op_type == '&') {
-        // Split on &&
-        *op_pos = '\0';
-        char *left = expr;
-        char *right = op_pos + 2;
-        
-        // Short-circuit: if left is false, don't evaluate right
-        if (!evaluate_extended_expr(executor, left)) {
-            return false;
-        }
-        return evaluate_extended_expr(executor, right);
-    }
-    
-    // No logical operators at this level - evaluate as simple test
-    return evaluate_simple_test(executor, expr);
-}
-
-/**
- * @brief Evaluate a simple test expression (no && or ||)
- */
-static bool evaluate_simple_test(executor_t *executor, const char *expr) {
-    char *p = (char *)expr;
-    
-    // Skip leading whitespace
-    while (*p && isspace(*p)) p++;
-    
-    // Check for negation
-    bool negate = false;
-    if (*p == '!') {
-        negate = true;
-        p++;
-        while (*p && isspace(*p)) p++;
-    }
-    
-    bool result = false;
-    
-    // Check for unary file/string tests
-    if (*p == '-' && p[1] && isalpha(p[1])) {
-        // Extract operator
-        char op[4] = {0};
-        int op_len = 0;
-        while (*p && !isspace(*p) && op_len < 3) {
-            op[op_len++] = *p++;
-        }
-        op[op_len] = '\0';
-        
-        // Skip whitespace
-        while (*p && isspace(*p)) p++;
-        
-        // String tests
-        if (strcmp(op, "-z") == 0) {
-            result = (*p == '\0');
-        } else if (strcmp(op, "-n") == 0) {
-            result = (*p != '\0');
-        } else {
-            // File tests - get the path (rest of line, trimmed)
-            char *path = strdup(p);
-            if (path) {
-                char *end = path + strlen(path) - 1;
-                while (end > path && isspace(*end)) *end-- = '\0';
-                result = extended_test_file_test(op, path);
-                free(path);
-            }
-        }
-    } else {
-        // Binary expression: lhs op rhs
-        char *lhs_start = p;
-        char *op_start = NULL;
-        char op_type[4] = {0};
-        
-        // Scan for binary operator
-        char *scan = p;
-        int paren_depth = 0;
-        
-        while (*scan) {
-            if (*scan == '(') paren_depth++;
-            else if (*scan == ')') paren_depth--;
-            else if (paren_depth == 0) {
-                if (scan[0] == '=' && scan[1] == '=') {
-                    op_start = scan;
-                    strcpy(op_type, "==");
-                    break;
-                } else if (scan[0] == '!' && scan[1] == '=') {
-                    op_start = scan;
-                    strcpy(op_type, "!=");
-                    break;
-                } else if (scan[0] == '=' && scan[1] == '~') {
-                    op_start = scan;
-                    strcpy(op_type, "=~");
-                    break;
-                } else if (scan[0] == '<' && scan[1] != '<') {
-                    op_start = scan;
-                    strcpy(op_type, "<");
-                    break;
-                } else if (scan[0] == '>' && scan[1] != '>') {
-                    op_start = scan;
-                    strcpy(op_type, ">");
-                    break;
-                } else if (scan[0] == '-' && isalpha(scan[1])) {
-                    if (strncmp(scan, "-eq", 3) == 0 && (isspace(scan[3]) || scan[3] == '\0')) {
-                        op_start = scan;
-                        strcpy(op_type, "-eq");
-                        break;
-                    } else if (strncmp(scan, "-ne", 3) == 0 && (isspace(scan[3]) || scan[3] == '\0')) {
-                        op_start = scan;
-                        strcpy(op_type, "-ne");
-                        break;
-                    } else if (strncmp(scan, "-lt", 3) == 0 && (isspace(scan[3]) || scan[3] == '\0')) {
-                        op_start = scan;
-                        strcpy(op_type, "-lt");
-                        break;
-                    } else if (strncmp(scan, "-le", 3) == 0 && (isspace(scan[3]) || scan[3] == '\0')) {
-                        op_start = scan;
-                        strcpy(op_type, "-le");
-                        break;
-                    } else if (strncmp(scan, "-gt", 3) == 0 && (isspace(scan[3]) || scan[3] == '\0')) {
-                        op_start = scan;
-                        strcpy(op_type, "-gt");
-                        break;
-                    } else if (strncmp(scan, "-ge", 3) == 0 && (isspace(scan[3]) || scan[3] == '\0')) {
-                        op_start = scan;
-                        strcpy(op_type, "-ge");
-                        break;
-                    } else if (strncmp(scan, "-nt", 3) == 0 && (isspace(scan[3]) || scan[3] == '\0')) {
-                        op_start = scan;
-                        strcpy(op_type, "-nt");
-                        break;
-                    } else if (strncmp(scan, "-ot", 3) == 0 && (isspace(scan[3]) || scan[3] == '\0')) {
-                        op_start = scan;
-                        strcpy(op_type, "-ot");
-                        break;
-                    } else if (strncmp(scan, "-ef", 3) == 0 && (isspace(scan[3]) || scan[3] == '\0')) {
-                        op_start = scan;
-                        strcpy(op_type, "-ef");
-                        break;
-                    }
-                }
-            }
-            scan++;
-        }
-        
-        if (op_start && op_type[0]) {
-            // Extract LHS
-            size_t lhs_len = op_start - lhs_start;
-            char *lhs = malloc(lhs_len + 1);
-            if (lhs) {
-                strncpy(lhs, lhs_start, lhs_len);
-                lhs[lhs_len] = '\0';
-                char *end = lhs + strlen(lhs) - 1;
-                while (end >= lhs && isspace(*end)) *end-- = '\0';
-            }
-            
-            // Extract RHS
-            char *rhs_start = op_start + strlen(op_type);
-            while (*rhs_start && isspace(*rhs_start)) rhs_start++;
-            char *rhs = strdup(rhs_start);
-            if (rhs) {
-                char *end = rhs + strlen(rhs) - 1;
-                while (end >= rhs && isspace(*end)) *end-- = '\0';
-            }
-            
-            // Evaluate based on operator
-            if (strcmp(op_type, "==") == 0) {
-                result = extended_test_pattern_match(lhs, rhs);
-            } else if (strcmp(op_type, "!=") == 0) {
-                result = !extended_test_pattern_match(lhs, rhs);
-            } else if (strcmp(op_type, "=~") == 0) {
-                result = extended_test_regex_match(executor, lhs, rhs);
-            } else if (strcmp(op_type, "<") == 0) {
-                result = (strcmp(lhs ? lhs : "", rhs ? rhs : "") < 0);
-            } else if (strcmp(op_type, ">") == 0) {
-                result = (strcmp(lhs ? lhs : "", rhs ? rhs : "") > 0);
-            } else if (strcmp(op_type, "-eq") == 0) {
-                result = (atoll(lhs ? lhs : "0") == atoll(rhs ? rhs : "0"));
-            } else if (strcmp(op_type, "-ne") == 0) {
-                result = (atoll(lhs ? lhs : "0") != atoll(rhs ? rhs : "0"));
-            } else if (strcmp(op_type, "-lt") == 0) {
-                result = (atoll(lhs ? lhs : "0") < atoll(rhs ? rhs : "0"));
-            } else if (strcmp(op_type, "-le") == 0) {
-                result = (atoll(lhs ? lhs : "0") <= atoll(rhs ? rhs : "0"));
-            } else if (strcmp(op_type, "-gt") == 0) {
-                result = (atoll(lhs ? lhs : "0") > atoll(rhs ? rhs : "0"));
-            } else if (strcmp(op_type, "-ge") == 0) {
-                result = (atoll(lhs ? lhs : "0") >= atoll(rhs ? rhs : "0"));
-            } else if (strcmp(op_type, "-nt") == 0) {
-                // File1 newer than file2
-                struct stat st1, st2;
-                if (lhs && rhs && stat(lhs, &st1) == 0 && stat(rhs, &st2) == 0) {
-                    result = (st1.st_mtime > st2.st_mtime);
-                } else {
-                    result = false;
-                }
-            } else if (strcmp(op_type, "-ot") == 0) {
-                // File1 older than file2
-                struct stat st1, st2;
-                if (lhs && rhs && stat(lhs, &st1) == 0 && stat(rhs, &st2) == 0) {
-                    result = (st1.st_mtime < st2.st_mtime);
-                } else {
-                    result = false;
-                }
-            } else if (strcmp(op_type, "-ef") == 0) {
-                // File1 and file2 are same file (same device and inode)
-                struct stat st1, st2;
-                if (lhs && rhs && stat(lhs, &st1) == 0 && stat(rhs, &st2) == 0) {
-                    result = (st1.st_dev == st2.st_dev && st1.st_ino == st2.st_ino);
-                } else {
-                    result = false;
-                }
-            }
-            
-            free(lhs);
-            free(rhs);
-        } else {
-            // No operator - non-empty string is true
-            result = (*p != '\0');
-        }
-    }
-    
-    return negate ? !result : result;
-}
-
 static int execute_extended_test(executor_t *executor, node_t *test_node) {
     if (!test_node || !test_node->val.str) {
         return 1;
     }
 
-    const char *expr = test_node->val.str;
-
     if (executor->debug) {
-        printf("DEBUG: Executing extended test: [[ %s ]]\n", expr);
+        printf("DEBUG: Executing extended test: [[ %s ]]\n",
+               test_node->val.str);
     }
 
-    // First, expand variables in the expression
-    char *expanded = expand_if_needed(executor, expr);
-    if (!expanded) {
-        expanded = strdup(expr);
-    }
-    if (!expanded) {
-        return 1;
-    }
-
-    if (executor->debug) {
-        printf("DEBUG: Expanded extended test: [[ %s ]]\n", expanded);
+    if (!test_node->compiled) {
+        test_node->compiled = extended_test_compile(test_node->val.str);
+        if (!test_node->compiled) {
+            return 1;
+        }
     }
 
-    // Evaluate the expression using recursive evaluator
-    // This handles &&, ||, parentheses, and simple tests
-    bool result = evaluate_extended_expr(executor, expanded);
-
-    free(expanded);
+    bool result = extended_test_evaluate(test_node->compiled,
+                                         extended_test_expand, executor);
 
     // Update exit status
     executor->exit_status = result ? 0 : 1;
@@ -12703,7 +13002,8 @@ static void cleanup_procsub_fds(executor_t *executor) {
     for (int i = 0; i < executor->procsub_fd_count; i++) {
         if (executor->procsub_pids[i] > 0) {
             int status;
-            waitpid(executor->procsub_pids[i], &status, 0);
+            executor_reap_child(executor, executor->procsub_pids[i], &status,
+                                0);
         }
     }
     executor->procsub_fd_count = 0;
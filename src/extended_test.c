@@ -0,0 +1,694 @@
+/**
+ * @file extended_test.c
+ * @brief Compiled [[ ]] conditional expressions
+ *
+ * The expression text is split the same way the executor used to split it
+ * at run time - top-level || and && (|| binding loosest), parentheses,
+ * leading !, then either a unary -X test, a binary operator found by
+ * scanning, or a bare word - but only once, before any expansion. Each
+ * operand is kept as text to expand when the test runs, unless it needs
+ * no expansion, in which case its value (and numeric value) is used as is.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "extended_test.h"
+
+#include "symtable.h"
+
+#include <ctype.h>
+#include <fnmatch.h>
+#include <regex.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Capture groups stored in BASH_REMATCH */
+#define REMATCH_GROUPS 10
+
+/* ============================================================================
+ * Types
+ * ============================================================================ */
+
+typedef enum {
+    XT_WORD,   /**< Non-empty string test */
+    XT_NOT,    /**< ! expr */
+    XT_AND,    /**< expr && expr */
+    XT_OR,     /**< expr || expr */
+    XT_UNARY,  /**< -X operand */
+    XT_BINARY, /**< operand OP operand */
+} xt_kind_t;
+
+typedef enum {
+    XT_OP_NONE,
+
+    /* Unary operators */
+    XT_OP_EMPTY,      /**< -z */
+    XT_OP_NONEMPTY,   /**< -n */
+    XT_OP_EXISTS,     /**< -e */
+    XT_OP_REGULAR,    /**< -f */
+    XT_OP_DIRECTORY,  /**< -d */
+    XT_OP_READABLE,   /**< -r */
+    XT_OP_WRITABLE,   /**< -w */
+    XT_OP_EXECUTABLE, /**< -x */
+    XT_OP_HAS_DATA,   /**< -s */
+    XT_OP_SYMLINK,    /**< -L, -h */
+    XT_OP_BLOCK,      /**< -b */
+    XT_OP_CHAR,       /**< -c */
+    XT_OP_FIFO,       /**< -p */
+    XT_OP_SOCKET,     /**< -S */
+    XT_OP_SETGID,     /**< -g */
+    XT_OP_SETUID,     /**< -u */
+    XT_OP_STICKY,     /**< -k */
+    XT_OP_OWNED,      /**< -O */
+    XT_OP_GROUP,      /**< -G */
+    XT_OP_UNKNOWN,    /**< Unrecognized -X (always false) */
+
+    /* Binary operators */
+    XT_OP_MATCH,     /**< == */
+    XT_OP_NOT_MATCH, /**< != */
+    XT_OP_REGEX,     /**< =~ */
+    XT_OP_STR_LT,    /**< < */
+    XT_OP_STR_GT,    /**< > */
+    XT_OP_EQ,        /**< -eq */
+    XT_OP_NE,        /**< -ne */
+    XT_OP_LT,        /**< -lt */
+    XT_OP_LE,        /**< -le */
+    XT_OP_GT,        /**< -gt */
+    XT_OP_GE,        /**< -ge */
+    XT_OP_NEWER,     /**< -nt */
+    XT_OP_OLDER,     /**< -ot */
+    XT_OP_SAME_FILE, /**< -ef */
+} xt_op_t;
+
+/**
+ * @brief An operand and, if it needs no expansion, its ready value
+ */
+typedef struct {
+    char *text;       /**< Operand text */
+    bool literal;     /**< text is the value; no expansion needed */
+    long long number; /**< Numeric value of a literal operand */
+} xt_operand_t;
+
+struct extended_test {
+    xt_kind_t kind;
+    xt_op_t op;
+    extended_test_t *left;  /**< Operand of !, left side of && and || */
+    extended_test_t *right; /**< Right side of && and || */
+    xt_operand_t lhs;       /**< Word, unary operand or left operand */
+    xt_operand_t rhs;       /**< Right operand */
+    bool plain_pattern;     /**< Literal pattern with no glob characters */
+    bool regex_compiled;    /**< Literal regex compiled into regex */
+    bool regex_invalid;     /**< Literal regex failed to compile */
+    regex_t regex;
+};
+
+static const struct {
+    const char *name;
+    xt_op_t op;
+} unary_ops[] = {
+    {"-z", XT_OP_EMPTY},      {"-n", XT_OP_NONEMPTY},
+    {"-e", XT_OP_EXISTS},     {"-f", XT_OP_REGULAR},
+    {"-d", XT_OP_DIRECTORY},  {"-r", XT_OP_READABLE},
+    {"-w", XT_OP_WRITABLE},   {"-x", XT_OP_EXECUTABLE},
+    {"-s", XT_OP_HAS_DATA},   {"-L", XT_OP_SYMLINK},
+    {"-h", XT_OP_SYMLINK},    {"-b", XT_OP_BLOCK},
+    {"-c", XT_OP_CHAR},       {"-p", XT_OP_FIFO},
+    {"-S", XT_OP_SOCKET},     {"-g", XT_OP_SETGID},
+    {"-u", XT_OP_SETUID},     {"-k", XT_OP_STICKY},
+    {"-O", XT_OP_OWNED},      {"-G", XT_OP_GROUP},
+    {NULL, XT_OP_NONE},
+};
+
+static const struct {
+    const char *name;
+    xt_op_t op;
+} numeric_ops[] = {
+    {"-eq", XT_OP_EQ},    {"-ne", XT_OP_NE},    {"-lt", XT_OP_LT},
+    {"-le", XT_OP_LE},    {"-gt", XT_OP_GT},    {"-ge", XT_OP_GE},
+    {"-nt", XT_OP_NEWER}, {"-ot", XT_OP_OLDER}, {"-ef", XT_OP_SAME_FILE},
+    {NULL, XT_OP_NONE},
+};
+
+/* ============================================================================
+ * Compilation
+ * ============================================================================ */
+
+static extended_test_t *compile_range(const char *s, size_t len);
+
+static void trim(const char **s, size_t *len) {
+    while (*len > 0 && isspace((unsigned char)**s)) {
+        (*s)++;
+        (*len)--;
+    }
+    while (*len > 0 && isspace((unsigned char)(*s)[*len - 1])) {
+        (*len)--;
+    }
+}
+
+static extended_test_t *new_test(xt_kind_t kind) {
+    extended_test_t *test = calloc(1, sizeof(*test));
+    if (test) {
+        test->kind = kind;
+    }
+    return test;
+}
+
+/**
+ * @brief Check whether operand text expands to itself
+ *
+ * Mirrors expand_if_needed(): quotes, backquotes, a leading ~ or a $
+ * that starts an expansion make the operand non-literal. A $ that is
+ * last or is followed by anything else (the anchor in "^a.c$") is copied
+ * as is when it is not the first character.
+ */
+static bool is_literal(const char *s, size_t len) {
+    if (len > 0 && (s[0] == '~' || s[0] == '$')) {
+        return false;
+    }
+    bool has_dollar = false;
+    for (size_t i = 0; i < len; i++) {
+        char c = s[i];
+        if (c == '\'' || c == '`' || c == '"') {
+            return false;
+        }
+        if (c == '$') {
+            has_dollar = true;
+            char next = i + 1 < len ? s[i + 1] : '\0';
+            if (isalnum((unsigned char)next) ||
+                (next && strchr("_{('\"?$#*@!-", next))) {
+                return false;
+            }
+        }
+    }
+    /* Text with a $ goes through quoted-string expansion, which treats
+     * backslashes specially */
+    return !(has_dollar && memchr(s, '\\', len));
+}
+
+/**
+ * @brief Set up an operand from a range of the expression
+ * @return false on allocation failure
+ */
+static bool make_operand(xt_operand_t *operand, const char *s, size_t len) {
+    trim(&s, &len);
+    operand->text = strndup(s, len);
+    if (!operand->text) {
+        return false;
+    }
+
+    operand->literal = is_literal(s, len);
+    if (operand->literal) {
+        operand->number = atoll(operand->text);
+    }
+    return true;
+}
+
+/**
+ * @brief Track nesting of ( ) and ${ } while scanning
+ */
+static void track_depth(const char *s, size_t i, int *parens, int *braces) {
+    if (s[i] == '(') {
+        (*parens)++;
+    } else if (s[i] == ')') {
+        (*parens)--;
+    } else if (s[i] == '$' && s[i + 1] == '{') {
+        (*braces)++;
+    } else if (s[i] == '}' && *braces > 0) {
+        (*braces)--;
+    }
+}
+
+/**
+ * @brief Find the first top-level occurrence of a two-character operator
+ * @return Offset of the operator, or len if not found
+ */
+static size_t find_logical(const char *s, size_t len, char c) {
+    int parens = 0;
+    int braces = 0;
+    for (size_t i = 0; i + 1 < len; i++) {
+        if (parens == 0 && braces == 0 && s[i] == c && s[i + 1] == c) {
+            return i;
+        }
+        track_depth(s, i, &parens, &braces);
+    }
+    return len;
+}
+
+/**
+ * @brief Check whether the range is one parenthesized group
+ */
+static bool is_group(const char *s, size_t len) {
+    if (len < 2 || s[0] != '(' || s[len - 1] != ')') {
+        return false;
+    }
+    int depth = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] == '(') {
+            depth++;
+        } else if (s[i] == ')') {
+            depth--;
+        }
+        if (depth == 0 && i + 1 < len) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Recognize a binary operator at a position
+ * @param length Output operator length
+ */
+static xt_op_t binary_op_at(const char *p, size_t *length) {
+    *length = 2;
+    if (p[0] == '=' && p[1] == '=') {
+        return XT_OP_MATCH;
+    }
+    if (p[0] == '!' && p[1] == '=') {
+        return XT_OP_NOT_MATCH;
+    }
+    if (p[0] == '=' && p[1] == '~') {
+        return XT_OP_REGEX;
+    }
+
+    *length = 1;
+    if (p[0] == '<' && p[1] != '<') {
+        return XT_OP_STR_LT;
+    }
+    if (p[0] == '>' && p[1] != '>') {
+        return XT_OP_STR_GT;
+    }
+
+    *length = 3;
+    if (p[0] == '-' && isalpha((unsigned char)p[1])) {
+        for (size_t i = 0; numeric_ops[i].name; i++) {
+            if (strncmp(p, numeric_ops[i].name, 3) == 0 &&
+                (isspace((unsigned char)p[3]) || p[3] == '\0')) {
+                return numeric_ops[i].op;
+            }
+        }
+    }
+    return XT_OP_NONE;
+}
+
+/**
+ * @brief Prepare a literal right-hand side for the operator
+ */
+static void precompile_rhs(extended_test_t *test) {
+    if (!test->rhs.literal) {
+        return;
+    }
+
+    if (test->op == XT_OP_MATCH || test->op == XT_OP_NOT_MATCH) {
+        test->plain_pattern = strpbrk(test->rhs.text, "*?[\\") == NULL;
+    } else if (test->op == XT_OP_REGEX) {
+        if (regcomp(&test->regex, test->rhs.text, REG_EXTENDED) == 0) {
+            test->regex_compiled = true;
+        } else {
+            test->regex_invalid = true;
+        }
+    }
+}
+
+/**
+ * @brief Compile a test with no top-level && or ||
+ */
+static extended_test_t *compile_simple(const char *s, size_t len) {
+    extended_test_t *test = NULL;
+
+    if (s[0] == '!') {
+        test = new_test(XT_NOT);
+        if (test) {
+            test->left = compile_range(s + 1, len - 1);
+            if (!test->left) {
+                extended_test_free(test);
+                return NULL;
+            }
+        }
+        return test;
+    }
+
+    if (s[0] == '-' && len > 1 && isalpha((unsigned char)s[1])) {
+        size_t op_len = 0;
+        while (op_len < len && op_len < 3 &&
+               !isspace((unsigned char)s[op_len])) {
+            op_len++;
+        }
+
+        test = new_test(XT_UNARY);
+        if (!test) {
+            return NULL;
+        }
+        test->op = XT_OP_UNKNOWN;
+        for (size_t i = 0; unary_ops[i].name; i++) {
+            if (strlen(unary_ops[i].name) == op_len &&
+                strncmp(s, unary_ops[i].name, op_len) == 0) {
+                test->op = unary_ops[i].op;
+                break;
+            }
+        }
+        if (!make_operand(&test->lhs, s + op_len, len - op_len)) {
+            extended_test_free(test);
+            return NULL;
+        }
+        return test;
+    }
+
+    int parens = 0;
+    int braces = 0;
+    for (size_t i = 0; i < len; i++) {
+        size_t op_len = 0;
+        xt_op_t op = parens == 0 && braces == 0 ? binary_op_at(s + i, &op_len)
+                                                : XT_OP_NONE;
+        if (op != XT_OP_NONE && i + op_len <= len) {
+            test = new_test(XT_BINARY);
+            if (!test) {
+                return NULL;
+            }
+            test->op = op;
+            if (!make_operand(&test->lhs, s, i) ||
+                !make_operand(&test->rhs, s + i + op_len, len - i - op_len)) {
+                extended_test_free(test);
+                return NULL;
+            }
+            precompile_rhs(test);
+            return test;
+        }
+        track_depth(s, i, &parens, &braces);
+    }
+
+    test = new_test(XT_WORD);
+    if (test && !make_operand(&test->lhs, s, len)) {
+        extended_test_free(test);
+        return NULL;
+    }
+    return test;
+}
+
+static extended_test_t *compile_logical(xt_kind_t kind, const char *s,
+                                        size_t len, size_t at) {
+    extended_test_t *test = new_test(kind);
+    if (!test) {
+        return NULL;
+    }
+    test->left = compile_range(s, at);
+    test->right = compile_range(s + at + 2, len - at - 2);
+    if (!test->left || !test->right) {
+        extended_test_free(test);
+        return NULL;
+    }
+    return test;
+}
+
+static extended_test_t *compile_range(const char *s, size_t len) {
+    trim(&s, &len);
+
+    while (is_group(s, len)) {
+        s++;
+        len -= 2;
+        trim(&s, &len);
+    }
+
+    /* || binds loosest, so split on it first */
+    size_t at = find_logical(s, len, '|');
+    if (at < len) {
+        return compile_logical(XT_OR, s, len, at);
+    }
+    at = find_logical(s, len, '&');
+    if (at < len) {
+        return compile_logical(XT_AND, s, len, at);
+    }
+
+    if (len == 0) {
+        /* Empty expression: an empty word, which is false */
+        extended_test_t *test = new_test(XT_WORD);
+        if (test && !make_operand(&test->lhs, s, 0)) {
+            extended_test_free(test);
+            return NULL;
+        }
+        return test;
+    }
+    return compile_simple(s, len);
+}
+
+/**
+ * @brief Compile the text of a [[ ]] command
+ *
+ * @param expr Expression between [[ and ]], as stored by the parser
+ * @return Compiled expression, or NULL on allocation failure
+ */
+extended_test_t *extended_test_compile(const char *expr) {
+    if (!expr) {
+        return NULL;
+    }
+    return compile_range(expr, strlen(expr));
+}
+
+/**
+ * @brief Free a compiled expression
+ *
+ * @param test Compiled expression (may be NULL)
+ */
+void extended_test_free(extended_test_t *test) {
+    if (!test) {
+        return;
+    }
+    extended_test_free(test->left);
+    extended_test_free(test->right);
+    free(test->lhs.text);
+    free(test->rhs.text);
+    if (test->regex_compiled) {
+        regfree(&test->regex);
+    }
+    free(test);
+}
+
+/* ============================================================================
+ * Evaluation
+ * ============================================================================ */
+
+/**
+ * @brief Get an operand's value
+ * @param owned Set to the expansion to free, if one was made
+ */
+static const char *operand_value(const xt_operand_t *operand,
+                                 extended_test_expand_fn expand, void *ctx,
+                                 char **owned) {
+    *owned = NULL;
+    if (operand->literal) {
+        return operand->text;
+    }
+    *owned = expand(ctx, operand->text);
+    return *owned ? *owned : "";
+}
+
+/**
+ * @brief Evaluate a unary file test
+ */
+static bool file_test(xt_op_t op, const char *path) {
+    struct stat st;
+    bool exists = (stat(path, &st) == 0);
+
+    switch (op) {
+    case XT_OP_EXISTS:
+        return exists;
+    case XT_OP_REGULAR:
+        return exists && S_ISREG(st.st_mode);
+    case XT_OP_DIRECTORY:
+        return exists && S_ISDIR(st.st_mode);
+    case XT_OP_READABLE:
+        return access(path, R_OK) == 0;
+    case XT_OP_WRITABLE:
+        return access(path, W_OK) == 0;
+    case XT_OP_EXECUTABLE:
+        return access(path, X_OK) == 0;
+    case XT_OP_HAS_DATA:
+        return exists && st.st_size > 0;
+    case XT_OP_SYMLINK: {
+        struct stat lst;
+        return (lstat(path, &lst) == 0) && S_ISLNK(lst.st_mode);
+    }
+    case XT_OP_BLOCK:
+        return exists && S_ISBLK(st.st_mode);
+    case XT_OP_CHAR:
+        return exists && S_ISCHR(st.st_mode);
+    case XT_OP_FIFO:
+        return exists && S_ISFIFO(st.st_mode);
+    case XT_OP_SOCKET:
+        return exists && S_ISSOCK(st.st_mode);
+    case XT_OP_SETGID:
+        return exists && (st.st_mode & S_ISGID);
+    case XT_OP_SETUID:
+        return exists && (st.st_mode & S_ISUID);
+    case XT_OP_STICKY:
+        return exists && (st.st_mode & S_ISVTX);
+    case XT_OP_OWNED:
+        return exists && (st.st_uid == getuid());
+    case XT_OP_GROUP:
+        return exists && (st.st_gid == getgid());
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Compare two files by modification time or identity
+ */
+static bool file_compare(xt_op_t op, const char *lhs, const char *rhs) {
+    struct stat st1, st2;
+    if (stat(lhs, &st1) != 0 || stat(rhs, &st2) != 0) {
+        return false;
+    }
+
+    switch (op) {
+    case XT_OP_NEWER:
+        return st1.st_mtime > st2.st_mtime;
+    case XT_OP_OLDER:
+        return st1.st_mtime < st2.st_mtime;
+    default:
+        return st1.st_dev == st2.st_dev && st1.st_ino == st2.st_ino;
+    }
+}
+
+/**
+ * @brief Match a string against a regex and populate BASH_REMATCH
+ */
+static bool regex_match(const regex_t *regex, const char *str) {
+    regmatch_t matches[REMATCH_GROUPS];
+    if (regexec(regex, str, REMATCH_GROUPS, matches, 0) != 0) {
+        return false;
+    }
+
+    for (int i = 0; i < REMATCH_GROUPS && matches[i].rm_so != -1; i++) {
+        size_t match_len = matches[i].rm_eo - matches[i].rm_so;
+        char *match_str = strndup(str + matches[i].rm_so, match_len);
+        if (match_str) {
+            char subscript[16];
+            snprintf(subscript, sizeof(subscript), "%d", i);
+            symtable_set_array_element("BASH_REMATCH", subscript, match_str);
+            free(match_str);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Evaluate a binary test
+ */
+static bool evaluate_binary(const extended_test_t *test,
+                            extended_test_expand_fn expand, void *ctx) {
+    char *lhs_owned;
+    char *rhs_owned;
+    const char *lhs = operand_value(&test->lhs, expand, ctx, &lhs_owned);
+    const char *rhs = operand_value(&test->rhs, expand, ctx, &rhs_owned);
+    long long a = test->lhs.literal ? test->lhs.number : atoll(lhs);
+    long long b = test->rhs.literal ? test->rhs.number : atoll(rhs);
+    bool result = false;
+
+    switch (test->op) {
+    case XT_OP_MATCH:
+    case XT_OP_NOT_MATCH:
+        result = test->plain_pattern ? strcmp(lhs, rhs) == 0
+                                     : fnmatch(rhs, lhs, 0) == 0;
+        if (test->op == XT_OP_NOT_MATCH) {
+            result = !result;
+        }
+        break;
+    case XT_OP_REGEX:
+        if (test->regex_compiled) {
+            result = regex_match(&test->regex, lhs);
+        } else if (!test->regex_invalid) {
+            regex_t regex;
+            if (regcomp(&regex, rhs, REG_EXTENDED) == 0) {
+                result = regex_match(&regex, lhs);
+                regfree(&regex);
+            }
+        }
+        break;
+    case XT_OP_STR_LT:
+        result = strcmp(lhs, rhs) < 0;
+        break;
+    case XT_OP_STR_GT:
+        result = strcmp(lhs, rhs) > 0;
+        break;
+    case XT_OP_EQ:
+        result = a == b;
+        break;
+    case XT_OP_NE:
+        result = a != b;
+        break;
+    case XT_OP_LT:
+        result = a < b;
+        break;
+    case XT_OP_LE:
+        result = a <= b;
+        break;
+    case XT_OP_GT:
+        result = a > b;
+        break;
+    case XT_OP_GE:
+        result = a >= b;
+        break;
+    case XT_OP_NEWER:
+    case XT_OP_OLDER:
+    case XT_OP_SAME_FILE:
+        result = file_compare(test->op, lhs, rhs);
+        break;
+    default:
+        break;
+    }
+
+    free(lhs_owned);
+    free(rhs_owned);
+    return result;
+}
+
+/**
+ * @brief Evaluate a compiled expression
+ *
+ * A successful =~ match stores the match and its groups in BASH_REMATCH.
+ *
+ * @param test Compiled expression
+ * @param expand Operand expansion function
+ * @param ctx Context for @p expand
+ * @return true if the expression is true
+ */
+bool extended_test_evaluate(const extended_test_t *test,
+                            extended_test_expand_fn expand, void *ctx) {
+    if (!test || !expand) {
+        return false;
+    }
+
+    switch (test->kind) {
+    case XT_NOT:
+        return !extended_test_evaluate(test->left, expand, ctx);
+    case XT_AND:
+        return extended_test_evaluate(test->left, expand, ctx) &&
+               extended_test_evaluate(test->right, expand, ctx);
+    case XT_OR:
+        return extended_test_evaluate(test->left, expand, ctx) ||
+               extended_test_evaluate(test->right, expand, ctx);
+    case XT_BINARY:
+        return evaluate_binary(test, expand, ctx);
+    case XT_WORD:
+    case XT_UNARY:
+        break;
+    }
+
+    char *owned;
+    const char *value = operand_value(&test->lhs, expand, ctx, &owned);
+    bool result;
+    if (test->kind == XT_WORD || test->op == XT_OP_NONEMPTY) {
+        result = value[0] != '\0';
+    } else if (test->op == XT_OP_EMPTY) {
+        result = value[0] == '\0';
+    } else {
+        result = file_test(test->op, value);
+    }
+    free(owned);
+    return result;
+}
@@ -11,11 +11,12 @@
 #include "fixer.h"
 #include "node.h"
 #include "parser.h"
+#include "spawn_cost.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <regex.h>
 
 /* Cross-platform forward declarations */
 int strncasecmp(const char *s1, const char *s2, size_t n);
@@ -82,12 +83,14 @@ typedef struct {
 } collect_ctx_t;
 
 /**
- * @brief Callback to check each compat entry for fixes
+ * @brief Callback for each compat entry whose pattern matched the line
  */
-static void collect_fix_callback(const compat_entry_t *entry, void *user_data) {
+static void collect_fix_callback(const compat_entry_t *entry,
+                                 size_t match_start, size_t match_length,
+                                 void *user_data) {
     collect_ctx_t *ctx = (collect_ctx_t *)user_data;
     
-    if (!entry || !ctx || !entry->lint.replacement || !entry->lint.pattern) {
+    if (!entry || !ctx || !entry->lint.replacement) {
         return;
     }
     
@@ -100,31 +103,43 @@ static void collect_fix_callback(const compat_entry_t *entry, void *user_data) {
         return;
     }
     
-    /* Check if pattern matches this line */
-    regex_t regex;
-    if (regcomp(&regex, entry->lint.pattern, REG_EXTENDED) != 0) {
-        return;
-    }
+    fixer_fix_t fix = {
+        .line = ctx->line_num,
+        .column = (int)(match_start + 1),
+        .match_start = ctx->line_offset + match_start,
+        .match_length = match_length,
+        .original = ctx->line + match_start,
+        .replacement = entry->lint.replacement,
+        .type = fix_type,
+        .message = entry->lint.message,
+        .entry = entry,
+    };
     
-    regmatch_t match;
-    if (regexec(&regex, ctx->line, 1, &match, 0) == 0) {
-        /* Pattern matched - create fix */
-        fixer_fix_t fix = {
-            .line = ctx->line_num,
-            .column = (int)(match.rm_so + 1),
-            .match_start = ctx->line_offset + (size_t)match.rm_so,
-            .match_length = (size_t)(match.rm_eo - match.rm_so),
-            .original = ctx->line + match.rm_so,
-            .replacement = entry->lint.replacement,
-            .type = fix_type,
-            .message = entry->lint.message,
-            .entry = entry,
-        };
-        
-        fixer_add_fix(ctx->fixer_ctx, &fix);
+    fixer_add_fix(ctx->fixer_ctx, &fix);
+}
+
+/**
+ * @brief Keep a generated string alive for the lifetime of the context
+ *
+ * @return The string, or NULL (after freeing it) on allocation failure
+ */
+static const char *own_string(fixer_context_t *ctx, char *str) {
+    if (!str) {
+        return NULL;
     }
-    
-    regfree(&regex);
+    if (ctx->string_count >= ctx->string_capacity) {
+        size_t new_cap = ctx->string_capacity ? ctx->string_capacity * 2
+                                              : FIXER_INITIAL_CAPACITY;
+        char **strings = realloc(ctx->strings, new_cap * sizeof(char *));
+        if (!strings) {
+            free(str);
+            return NULL;
+        }
+        ctx->strings = strings;
+        ctx->string_capacity = new_cap;
+    }
+    ctx->strings[ctx->string_count++] = str;
+    return str;
 }
 
 /* ============================================================================
@@ -154,6 +169,10 @@ void fixer_cleanup(fixer_context_t *ctx) {
         return;
     }
     
+    for (size_t i = 0; i < ctx->string_count; i++) {
+        free(ctx->strings[i]);
+    }
+    free(ctx->strings);
     free(ctx->fixes);
     free(ctx->script_path);
     free(ctx->content);
@@ -275,8 +294,8 @@ size_t fixer_collect_fixes(fixer_context_t *ctx, shell_mode_t target) {
             .line_offset = line_offset,
         };
         
-        /* Check all compat entries against this line */
-        compat_foreach_entry(collect_fix_callback, &collect_ctx);
+        /* Single pass over the precompiled rule set for this line */
+        compat_foreach_match(line, collect_fix_callback, &collect_ctx);
         
         /* Move to next line */
         line_num++;
@@ -287,6 +306,63 @@ size_t fixer_collect_fixes(fixer_context_t *ctx, shell_mode_t target) {
     return ctx->count;
 }
 
+size_t fixer_collect_spawn_fixes(fixer_context_t *ctx, shell_mode_t target) {
+    if (!ctx || !ctx->content) {
+        return 0;
+    }
+
+    parser_t *parser = parser_new(ctx->content);
+    if (!parser) {
+        return 0;
+    }
+    node_t *ast = parser_parse(parser);
+
+    spawn_report_t report;
+    size_t added = 0;
+    if (ast && spawn_analyze(ctx->content, ast, target, &report)) {
+        for (size_t i = 0; i < report.site_count; i++) {
+            spawn_site_t *site = &report.sites[i];
+
+            /* Only located single-line rewrites can be applied in place */
+            if (!site->replacement || site->length == 0 ||
+                site->fix_type == FIX_TYPE_MANUAL ||
+                memchr(site->original, '\n', site->length)) {
+                continue;
+            }
+
+            const char *original = own_string(ctx, site->original);
+            site->original = NULL;
+            const char *replacement = own_string(ctx, site->replacement);
+            site->replacement = NULL;
+            if (!original || !replacement) {
+                break;
+            }
+
+            fixer_fix_t fix = {
+                .line = site->line,
+                .column = site->column,
+                .match_start = site->offset,
+                .match_length = site->length,
+                .original = original,
+                .replacement = replacement,
+                .type = site->fix_type,
+                .message = spawn_idiom_message(site->idiom),
+                .entry = NULL,
+            };
+            if (fixer_add_fix(ctx, &fix) == FIXER_OK) {
+                added++;
+            }
+        }
+        spawn_report_free(&report);
+    }
+
+    if (ast) {
+        free_node_tree(ast);
+    }
+    parser_free(parser);
+    return added;
+}
+
 fixer_result_t fixer_add_fix(fixer_context_t *ctx, const fixer_fix_t *fix) {
     if (!ctx || !fix) {
         return FIXER_ERR_NOMEM;
@@ -378,6 +454,7 @@ fixer_result_t fixer_apply_fixes(fixer_context_t *ctx,
     size_t working_len = ctx->content_len;
     
     size_t applied = 0;
+    size_t limit = SIZE_MAX; /* Start of the last applied fix */
     
     for (size_t i = 0; i < ctx->count; i++) {
         fixer_fix_t *fix = &ctx->fixes[i];
@@ -397,6 +474,12 @@ fixer_result_t fixer_apply_fixes(fixer_context_t *ctx,
             continue;
         }
         
+        /* Skip fixes overlapping one already applied */
+        if (fix->match_start + fix->match_length > limit) {
+            continue;
+        }
+        limit = fix->match_start;
+        
         /* Apply replacement */
         size_t repl_len = strlen(fix->replacement);
         size_t new_len = working_len - fix->match_length + repl_len;
@@ -886,6 +969,7 @@ fixer_result_t fixer_interactive_apply(fixer_interactive_t *session,
     size_t working_len = session->ctx->content_len;
     
     size_t applied = 0;
+    size_t limit = SIZE_MAX; /* Start of the last applied fix */
     
     for (size_t i = 0; i < session->ctx->count; i++) {
         if (!session->accepted[i]) {
@@ -898,6 +982,12 @@ fixer_result_t fixer_interactive_apply(fixer_interactive_t *session,
             continue;
         }
         
+        /* Skip fixes overlapping one already applied */
+        if (fix->match_start + fix->match_length > limit) {
+            continue;
+        }
+        limit = fix->match_start;
+        
         /* Apply replacement */
         size_t repl_len = strlen(fix->replacement);
         size_t new_len = working_len - fix->match_length + repl_len;
@@ -21,6 +21,7 @@
 #include "builtins.h"
 #include "compat.h"
 #include "config.h"
+#include "dirindex.h"
 #include "dirstack.h"
 #include "errors.h"
 #include "history.h"
@@ -31,7 +32,10 @@
 #include "lle/completion/ssh_hosts.h"
 #include "lush.h"
 #include "signals.h"
+#include "startup_cache.h"
+#include "startup_profile.h"
 #include "symtable.h"
+#include "xtrace.h"
 
 #include "display_integration.h"
 #include "lle/adaptive_terminal_integration.h"
@@ -43,9 +47,11 @@
 #include <mach-o/dyld.h>
 #endif
 
+#include <ctype.h>
 #include <errno.h>
 #include <getopt.h>
 #include <locale.h>
+#include <math.h>
 #include <pwd.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -292,6 +298,85 @@ static void posix_history_cleanup(void) {
     }
 }
 
+/**
+ * @brief Create the global POSIX history manager and load ~/.lush_history
+ *
+ * Deferred until after the first prompt: the line editor loads its own
+ * history during startup and nothing else reads this manager before then.
+ */
+static void posix_history_load_global(void) {
+    if (global_posix_history) {
+        return;
+    }
+
+    global_posix_history = posix_history_create(0);
+    if (!global_posix_history) {
+        return;
+    }
+
+    // Set default filename and load existing history
+    char *home = symtable_get_global_default("HOME", "");
+    if (home && *home) {
+        char histfile[1024];
+        snprintf(histfile, sizeof(histfile), "%s/.lush_history", home);
+        posix_history_set_filename(global_posix_history, histfile);
+        posix_history_load(global_posix_history, histfile, false);
+    }
+    free(home); /* symtable_get_global_default returns strdup'd value */
+
+    // Enable duplicate detection by default
+    posix_history_set_no_duplicates(global_posix_history, true);
+}
+
+/**
+ * @brief Load the SSH host cache used by completion
+ *
+ * Deferred until after the first prompt; completion and the ssh builtin
+ * load the cache themselves if they need it earlier.
+ */
+static void ssh_hosts_prewarm(void) {
+    if (ssh_hosts_init() != 0 && IS_INTERACTIVE_SHELL) {
+        fprintf(stderr, "Warning: Failed to initialize SSH host cache\n");
+    }
+}
+
+/**
+ * @brief Turn on the startup profiler if --startup-profile was given
+ *
+ * Runs before anything else in init() so every phase is measured. The
+ * option itself is accepted and skipped by parse_opts(). A budget that
+ * is not a positive number of milliseconds is a usage error.
+ */
+static void startup_profile_from_args(int argc, char **argv) {
+    for (int i = 1; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "--") == 0) {
+            break;
+        }
+        if (strncmp(argv[i], "--startup-profile", 17) == 0 &&
+            (argv[i][17] == '\0' || argv[i][17] == '=')) {
+            double budget = 0.0;
+            if (argv[i][17] == '=') {
+                const char *value = argv[i] + 18;
+                char *end = NULL;
+                // Leading digit check rules out signs, blanks, inf and nan
+                errno = 0;
+                if (isdigit((unsigned char)value[0]) || value[0] == '.') {
+                    budget = strtod(value, &end);
+                }
+                if (!end || end == value || *end != '\0' || errno != 0 ||
+                    !(budget > 0.0) || !isfinite(budget)) {
+                    fprintf(stderr,
+                            "%s: --startup-profile: invalid budget '%s' "
+                            "(expected milliseconds > 0)\n",
+                            argv[0], value);
+                    usage(EXIT_FAILURE);
+                }
+            }
+            startup_profile_enable(budget);
+        }
+    }
+}
+
 /**
  * @brief Initialize the shell
  *
@@ -316,6 +401,9 @@ int init(int argc, char **argv, FILE **in) {
         exit(EXIT_FAILURE);
     }
 
+    startup_profile_from_args(argc, argv);
+    startup_phase("environment");
+
     // Set all locales according to environment
     setlocale(LC_ALL, "");
 
@@ -375,6 +463,7 @@ int init(int argc, char **argv, FILE **in) {
                                    (isatty(STDIN_FILENO) && isatty(STDOUT_FILENO));
 
     // Initialize configuration system
+    startup_phase("config");
     config_init();
 
     // Initialize critical environment variables for login shells
@@ -386,28 +475,29 @@ int init(int argc, char **argv, FILE **in) {
     // Execute login scripts for login shells
     if (IS_LOGIN_SHELL) {
         // First source system-wide profiles (/etc/profile, /etc/profile.d/*.sh)
+        startup_phase("system profile");
         config_execute_system_profile();
         // Then source user profiles (~/.profile, ~/.lush_login)
+        startup_phase("login scripts");
         config_execute_login_scripts();
     }
 
     // Execute startup scripts for interactive shells (preliminary check)
     // Note: This uses a preliminary check; full interactive detection happens below
     if (preliminary_interactive && !shell_opts.command_mode) {
+        startup_phase("rc scripts");
         config_execute_startup_scripts();
     }
 
     // Initialize auto-correction system
+    startup_phase("autocorrect");
     autocorrect_init();
 
-    // Initialize SSH host cache for completion
-    if (ssh_hosts_init() != 0) {
-        if (IS_INTERACTIVE_SHELL) {
-            fprintf(stderr, "Warning: Failed to initialize SSH host cache\n");
-        }
-    }
+    // SSH host cache for completion is loaded after the first prompt
+    startup_defer("ssh hosts", ssh_hosts_prewarm);
 
     // Initialize terminal capabilities via LLE adaptive detection
+    startup_phase("terminal detection");
     lle_terminal_detection_result_t *detection = NULL;
     if (lle_detect_terminal_capabilities_optimized(&detection) != LLE_SUCCESS) {
         if (IS_INTERACTIVE_SHELL) {
@@ -596,6 +686,7 @@ int init(int argc, char **argv, FILE **in) {
         }
 
         // Initialize memory pool system FIRST - required by LLE and display
+        startup_phase("memory pool");
         lush_pool_config_t pool_config =
             lush_pool_get_display_optimized_config();
         pool_config.enable_debugging = (getenv("LUSH_MEMORY_DEBUG") != NULL);
@@ -628,6 +719,7 @@ int init(int argc, char **argv, FILE **in) {
          * LLE is the sole line editor - no GNU readline fallback.
          * Requires: global_memory_pool (initialized above)
          */
+        startup_phase("line editor");
         lle_result_t lle_result = lle_shell_integration_init();
         if (lle_result != LLE_SUCCESS) {
             fprintf(stderr, "Warning: Failed to initialize LLE: %d\n",
@@ -635,6 +727,7 @@ int init(int argc, char **argv, FILE **in) {
         }
 
         // Initialize display integration ONLY in interactive mode
+        startup_phase("display");
         if (IS_INTERACTIVE_SHELL) {
             // Configure display options based on environment and command line
             // v1.3.0: Layered display is now exclusive - always enabled
@@ -666,6 +759,7 @@ int init(int argc, char **argv, FILE **in) {
         }
 
         /* Generate initial prompt */
+        startup_phase("prompt");
         lle_shell_update_prompt();
     }
 
@@ -708,28 +802,12 @@ int init(int argc, char **argv, FILE **in) {
     // Initialize history for interactive shells
     if (IS_INTERACTIVE_SHELL) {
         // LLE history is initialized via lle_shell_integration_init()
-        // Initialize enhanced POSIX history system
-        if (!global_posix_history) {
-            global_posix_history = posix_history_create(0);
-            if (global_posix_history) {
-                // Set default filename and load existing history
-                char *home = symtable_get_global_default("HOME", "");
-                if (home && *home) {
-                    char histfile[1024];
-                    snprintf(histfile, sizeof(histfile), "%s/.lush_history",
-                             home);
-                    posix_history_set_filename(global_posix_history, histfile);
-                    posix_history_load(global_posix_history, histfile, false);
-                }
-                free(home);  /* symtable_get_global_default returns strdup'd value */
-
-                // Enable duplicate detection by default
-                posix_history_set_no_duplicates(global_posix_history, true);
-            }
-        }
+        // The enhanced POSIX history system is loaded after the first prompt
+        startup_defer("posix history", posix_history_load_global);
     }
 
     // Initialize aliases
+    startup_phase("shell tables");
     init_aliases();
 
     // Initialize command hash table
@@ -738,6 +816,9 @@ int init(int argc, char **argv, FILE **in) {
     // Initialize directory stack for pushd/popd
     dirstack_init();
 
+    // Initialize frecency directory index for z (loaded on first use)
+    dirindex_init();
+
     // Completion is handled automatically by readline integration
     // No need to set callbacks - they're integrated in lush_readline_init()
 
@@ -751,12 +832,14 @@ int init(int argc, char **argv, FILE **in) {
     atexit(free_aliases);
     atexit(free_command_hash);
     atexit(dirstack_cleanup);
+    atexit(dirindex_cleanup);
     atexit(autocorrect_cleanup);
     atexit(ssh_hosts_cleanup);
     atexit(config_cleanup);
     atexit(posix_history_cleanup);
     atexit(lle_terminal_detection_cache_cleanup);
     atexit(free_input_buffers);
+    atexit(xtrace_cleanup);
 
     // Process shebang if the shell is invoked with a script
     if (!IS_INTERACTIVE_SHELL && *in && has_script_file) {
@@ -772,6 +855,13 @@ int init(int argc, char **argv, FILE **in) {
      * (before LLE init) so it runs LAST in atexit order (LIFO).
      * This ensures LLE can safely use pool memory during shutdown. */
 
+    // Interactive startup ends when the line editor draws the first prompt
+    if (IS_INTERACTIVE_SHELL) {
+        startup_phase("first prompt");
+    } else {
+        startup_profile_finish(stderr);
+    }
+
     return 0;
 }
 
@@ -839,6 +929,13 @@ static int parse_opts(int argc, char **argv) {
                             argv[0]);
                     usage(EXIT_FAILURE);
                 }
+            } else if (strncmp(arg, "--startup-profile", 17) == 0 &&
+                       (arg[17] == '\0' || arg[17] == '=')) {
+                // Handled by startup_profile_from_args() before parsing
+            } else if (strcmp(arg, "--no-startup-cache") == 0) {
+                // Read and parse every startup file instead of using the
+                // cached parse trees
+                startup_cache_set_enabled(false);
             } else if (strcmp(arg, "--analyze") == 0) {
                 // Enable full analyze mode
                 shell_opts.analyze_mode = true;
@@ -1005,6 +1102,12 @@ static void usage(int err) {
     printf("      --dry-run           Preview fixes without applying\n");
     printf("      --format=FMT        Output format: text (default), json, gcc\n");
     printf("      --strict            Treat compatibility warnings as errors\n");
+    printf("      --startup-profile[=MS]\n"
+           "                          Report startup time per phase and "
+           "sourced file\n"
+           "                          against a budget in milliseconds\n");
+    printf("      --no-startup-cache  Parse startup files instead of using "
+           "the cache\n");
     printf("      --target=<shell>    Check compatibility against shell "
            "(posix, bash, zsh)\n");
     printf("  -c command       Execute command string and exit\n");
@@ -911,16 +911,12 @@ char *ln_gets(void) {
             accumulated_capacity = new_capacity;
         }
 
-        if (accumulated_size == 0) {
-            // First line
-            strcpy(accumulated_input, line);
-            accumulated_size = line_len;
-        } else {
-            // Append with newline
-            strcat(accumulated_input, "\n");
-            strcat(accumulated_input, line);
-            accumulated_size += line_len + 1;
+        if (accumulated_size > 0) {
+            // Append with newline at the known end of the buffer
+            accumulated_input[accumulated_size++] = '\n';
         }
+        memcpy(accumulated_input + accumulated_size, line, line_len + 1);
+        accumulated_size += line_len;
 
         // Free individual line (readline allocates it)
         free(line);
@@ -962,12 +958,16 @@ char *get_input_complete(FILE *in) {
 
     char *accumulated = NULL;
     size_t accumulated_len = 0;
+    size_t accumulated_capacity = 0;
     input_state_t state = {0};
 
     char *line = NULL;
     size_t len = 0;
     ssize_t read;
 
+    // Each line is analyzed once and appended at the known end of the
+    // buffer, which grows geometrically, so reading a long construct such
+    // as a function body or here document stays linear in its size
     while ((read = getline(&line, &len, in)) != -1) {
         // Remove trailing newline for analysis
         if (read > 0 && line[read - 1] == '\n') {
@@ -994,35 +994,34 @@ char *get_input_complete(FILE *in) {
             had_backslash_continuation = true;
         }
 
-        // Accumulate the line
-        if (accumulated == NULL) {
-            accumulated =
-                malloc(read + 2); // +2 for newline and null terminator
-            if (!accumulated) {
-                free(line);
-                return NULL;
+        bool first_line = (accumulated == NULL);
+
+        // Make room for a separating newline, the line and the terminator
+        size_t needed = accumulated_len + (size_t)read + 2;
+        if (needed > accumulated_capacity) {
+            size_t new_capacity = accumulated_capacity ? accumulated_capacity : 256;
+            while (new_capacity < needed) {
+                new_capacity *= 2;
             }
-            strcpy(accumulated, line);
-            accumulated_len = read;
-        } else {
-            size_t new_len = accumulated_len + read +
-                             2; // +2 for newline and null terminator
-            char *new_accumulated = realloc(accumulated, new_len);
+            char *new_accumulated = realloc(accumulated, new_capacity);
             if (!new_accumulated) {
                 free(accumulated);
                 free(line);
+                cleanup_input_state(&state);
                 return NULL;
             }
             accumulated = new_accumulated;
-            // Only add newline if previous line didn't have backslash continuation
-            if (!had_backslash_continuation) {
-                strcat(accumulated, "\n");
-                accumulated_len++;
-            }
-            strcat(accumulated, line);
-            accumulated_len += read;
+            accumulated_capacity = new_capacity;
         }
 
+        // Accumulate the line; only add a newline if the previous line
+        // didn't have backslash continuation
+        if (!first_line && !had_backslash_continuation) {
+            accumulated[accumulated_len++] = '\n';
+        }
+        memcpy(accumulated + accumulated_len, line, (size_t)read + 1);
+        accumulated_len += (size_t)read;
+
         // Check if we have a complete construct
         if (!needs_continuation(&state)) {
             break;
@@ -1040,11 +1039,13 @@ char *get_input_complete(FILE *in) {
             // errors Don't wait indefinitely - return to parser for error
             // handling
             free(line);
+            cleanup_input_state(&state);
             return accumulated;
         } else if (!state.in_here_doc) {
             // Other non-here-document continuations should also be handled as
             // syntax errors on EOF
             free(line);
+            cleanup_input_state(&state);
             return accumulated;
         }
         // For here documents, continue normal processing (this is expected
@@ -1052,9 +1053,26 @@ char *get_input_complete(FILE *in) {
     }
 
     free(line);
+    cleanup_input_state(&state);
     return accumulated;
 }
 
+/**
+ * @brief Count the lines a complete input spans
+ *
+ * @param input Input returned by get_input_complete()
+ * @return Number of lines, at least 1
+ */
+int get_input_line_count(const char *input) {
+    int lines = 1;
+    for (const char *p = input; p && *p; p++) {
+        if (*p == '\n') {
+            lines++;
+        }
+    }
+    return lines;
+}
+
 /**
  * @brief Unified input function for both interactive and non-interactive modes
  *
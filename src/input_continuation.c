@@ -264,25 +264,36 @@ bool continuation_is_terminator(const char *line) {
 // ============================================================================
 
 /**
- * @brief Analyze a line of input to update continuation parsing state
+ * @brief Word being collected when a scan stops
  *
- * Processes a line character by character to track quotes, parentheses,
+ * A quoted or escaped newline does not end the current word, so the word
+ * buffer is part of the state needed to resume a scan at a line start.
+ */
+typedef struct {
+    char word[256]; /**< Characters collected so far */
+    int word_pos;   /**< Length of word */
+} continuation_scan_t;
+
+/**
+ * @brief Scan characters and update continuation parsing state
+ *
+ * Processes text character by character to track quotes, parentheses,
  * braces, brackets, here documents, escape sequences, and control keywords.
- * Updates the continuation state structure to reflect what constructs are
- * currently open and whether continuation input is needed.
+ * Lookahead never crosses a newline, so a scan may stop at any line start
+ * and resume later from the same state and word buffer.
  *
- * @param line The line of input to analyze
+ * @param line Start of the analyzed text (used for here document matching)
+ * @param p First character to scan
+ * @param end One past the last character to scan
  * @param state The continuation state structure to update
+ * @param scan Word collection state carried between scans
  */
-void continuation_analyze_line(const char *line, continuation_state_t *state) {
-    if (!line || !state)
-        return;
+static void scan_text(const char *line, const char *p, const char *end,
+                      continuation_state_t *state, continuation_scan_t *scan) {
+    char *word = scan->word;
+    int word_pos = scan->word_pos;
 
-    const char *p = line;
-    char word[256] = {0};
-    int word_pos = 0;
-
-    while (*p) {
+    while (p < end) {
         unsigned char uc = (unsigned char)*p;
         char c = *p;
 
@@ -300,7 +311,7 @@ void continuation_analyze_line(const char *line, continuation_state_t *state) {
                 word[word_pos] = '\0';
                 // Keywords are ASCII-only, so no need to check here
                 word_pos = 0;
-                memset(word, 0, sizeof(word));
+                memset(word, 0, sizeof(scan->word));
             }
 
             // Skip the entire UTF-8 sequence
@@ -444,7 +455,7 @@ void continuation_analyze_line(const char *line, continuation_state_t *state) {
 
         // Collect words for keyword analysis
         if (isalnum(c) || c == '_') {
-            if (word_pos < (int)sizeof(word) - 1) {
+            if (word_pos < (int)sizeof(scan->word) - 1) {
                 word[word_pos++] = c;
             }
         } else if (c == '{' || c == '}') {
@@ -507,7 +518,7 @@ void continuation_analyze_line(const char *line, continuation_state_t *state) {
                 }
 
                 word_pos = 0;
-                memset(word, 0, sizeof(word));
+                memset(word, 0, sizeof(scan->word));
             }
 
             // Now handle the { or } character as a single-character keyword
@@ -611,13 +622,35 @@ void continuation_analyze_line(const char *line, continuation_state_t *state) {
                 }
 
                 word_pos = 0;
-                memset(word, 0, sizeof(word));
+                memset(word, 0, sizeof(scan->word));
             }
         }
 
         p++;
     }
 
+    scan->word_pos = word_pos;
+}
+
+/**
+ * @brief Apply end-of-text rules after the last character was scanned
+ *
+ * Handles a trailing backslash or pipe and a control keyword that ends the
+ * text. These depend on what comes last, so incremental analysis applies
+ * them to a copy of the resumable state.
+ *
+ * @param line The analyzed text
+ * @param len Length of line
+ * @param state The continuation state structure to update
+ * @param scan Word collected when the scan stopped
+ */
+static void finish_text(const char *line, size_t len,
+                        continuation_state_t *state,
+                        const continuation_scan_t *scan) {
+    char word[sizeof(scan->word)];
+    int word_pos = scan->word_pos;
+    memcpy(word, scan->word, sizeof(word));
+
     // Check if line ends with unescaped backslash (line continuation)
     // Must check after loop completes to handle escaped flag correctly
     if (state->escaped) {
@@ -627,7 +660,7 @@ void continuation_analyze_line(const char *line, continuation_state_t *state) {
 
     // Check if line ends with pipe character (requires continuation)
     // Need to check backwards from end, skipping whitespace
-    const char *end = line + strlen(line);
+    const char *end = line + len;
     while (end > line && isspace(*(end - 1))) {
         end--;
     }
@@ -680,6 +713,334 @@ void continuation_analyze_line(const char *line, continuation_state_t *state) {
     }
 }
 
+/**
+ * @brief Analyze a line of input to update continuation parsing state
+ *
+ * Processes a line character by character to track quotes, parentheses,
+ * braces, brackets, here documents, escape sequences, and control keywords.
+ * Updates the continuation state structure to reflect what constructs are
+ * currently open and whether continuation input is needed.
+ *
+ * @param line The line of input to analyze
+ * @param state The continuation state structure to update
+ */
+void continuation_analyze_line(const char *line, continuation_state_t *state) {
+    if (!line || !state)
+        return;
+
+    continuation_scan_t scan = {{0}, 0};
+    size_t len = strlen(line);
+    scan_text(line, line, line + len, state, &scan);
+    finish_text(line, len, state, &scan);
+}
+
+// ============================================================================
+// INCREMENTAL ANALYSIS
+// ============================================================================
+
+/**
+ * @brief Deep copy a continuation state
+ *
+ * @param dst Destination (must not own any memory)
+ * @param src Source state
+ */
+static void state_copy(continuation_state_t *dst,
+                       const continuation_state_t *src) {
+    *dst = *src;
+    if (src->here_doc_delimiter) {
+        dst->here_doc_delimiter = strdup(src->here_doc_delimiter);
+    }
+}
+
+/**
+ * @brief Drop checkpoints from index keep onwards
+ *
+ * @param analyzer Analyzer owning the checkpoints
+ * @param keep Number of checkpoints to keep
+ */
+static void truncate_checkpoints(continuation_analyzer_t *analyzer,
+                                 size_t keep) {
+    for (size_t i = keep; i < analyzer->checkpoint_count; i++) {
+        continuation_checkpoint_t *cp = &analyzer->checkpoints[i];
+        continuation_state_cleanup(&cp->state);
+        free(cp->pending_word);
+        cp->pending_word = NULL;
+    }
+    if (keep < analyzer->checkpoint_count) {
+        analyzer->checkpoint_count = keep;
+    }
+}
+
+/**
+ * @brief Record the state at a line start
+ *
+ * A checkpoint that cannot be allocated is skipped; later updates then
+ * resume from an earlier line, which is slower but still correct.
+ *
+ * @param analyzer Analyzer to record into
+ * @param offset Byte offset of the line start
+ * @param state State before the line
+ * @param scan Word carried into the line
+ */
+static void push_checkpoint(continuation_analyzer_t *analyzer, size_t offset,
+                            const continuation_state_t *state,
+                            const continuation_scan_t *scan) {
+    if (analyzer->checkpoint_count == analyzer->checkpoint_capacity) {
+        size_t capacity = analyzer->checkpoint_capacity
+                              ? analyzer->checkpoint_capacity * 2
+                              : 64;
+        continuation_checkpoint_t *grown = realloc(
+            analyzer->checkpoints, capacity * sizeof(*analyzer->checkpoints));
+        if (!grown) {
+            return;
+        }
+        analyzer->checkpoints = grown;
+        analyzer->checkpoint_capacity = capacity;
+    }
+
+    continuation_checkpoint_t *cp =
+        &analyzer->checkpoints[analyzer->checkpoint_count];
+    cp->pending_word = NULL;
+    if (scan->word_pos > 0) {
+        cp->pending_word = malloc((size_t)scan->word_pos + 1);
+        if (!cp->pending_word) {
+            return;
+        }
+        memcpy(cp->pending_word, scan->word, (size_t)scan->word_pos);
+        cp->pending_word[scan->word_pos] = '\0';
+    }
+    cp->offset = offset;
+    state_copy(&cp->state, state);
+    analyzer->checkpoint_count++;
+}
+
+/**
+ * @brief Initialize an incremental analyzer
+ *
+ * @param analyzer Analyzer to initialize
+ */
+void continuation_analyzer_init(continuation_analyzer_t *analyzer) {
+    if (!analyzer)
+        return;
+    memset(analyzer, 0, sizeof(*analyzer));
+    continuation_state_init(&analyzer->state);
+}
+
+/**
+ * @brief Free all memory held by an incremental analyzer
+ *
+ * @param analyzer Analyzer to clean up
+ */
+void continuation_analyzer_cleanup(continuation_analyzer_t *analyzer) {
+    if (!analyzer)
+        return;
+    truncate_checkpoints(analyzer, 0);
+    free(analyzer->checkpoints);
+    free(analyzer->text);
+    continuation_state_cleanup(&analyzer->state);
+    memset(analyzer, 0, sizeof(*analyzer));
+}
+
+/**
+ * @brief Analyze a buffer, re-scanning only from the first changed line
+ *
+ * Finds the longest prefix shared with the previously analyzed text,
+ * restores the last checkpoint inside it and scans forward line by line,
+ * recording a checkpoint at every line start. End-of-text rules are then
+ * applied to the result without touching the checkpoints.
+ *
+ * @param analyzer Analyzer holding the previous analysis
+ * @param text Complete buffer text
+ * @return State for the whole buffer, or NULL on invalid arguments
+ */
+const continuation_state_t *
+continuation_analyzer_update(continuation_analyzer_t *analyzer,
+                             const char *text) {
+    if (!analyzer || !text)
+        return NULL;
+
+    size_t len = strlen(text);
+    size_t common = 0;
+    if (analyzer->checkpoint_count > 0) {
+        size_t limit = len < analyzer->text_len ? len : analyzer->text_len;
+        while (common < limit && analyzer->text[common] == text[common]) {
+            common++;
+        }
+        if (common == len && len == analyzer->text_len) {
+            analyzer->lines_scanned = 0;
+            return &analyzer->state;
+        }
+    }
+
+    if (len + 1 > analyzer->text_capacity) {
+        size_t capacity = analyzer->text_capacity ? analyzer->text_capacity : 256;
+        while (capacity < len + 1) {
+            capacity *= 2;
+        }
+        char *grown = realloc(analyzer->text, capacity);
+        if (!grown) {
+            /* Analyze without caching */
+            truncate_checkpoints(analyzer, 0);
+            analyzer->text_len = 0;
+            continuation_state_cleanup(&analyzer->state);
+            continuation_state_init(&analyzer->state);
+            continuation_analyze_line(text, &analyzer->state);
+            analyzer->lines_scanned = 0;
+            return &analyzer->state;
+        }
+        analyzer->text = grown;
+        analyzer->text_capacity = capacity;
+    }
+    memcpy(analyzer->text + common, text + common, len - common + 1);
+    analyzer->text_len = len;
+
+    /* A checkpoint is reusable if everything before its line is unchanged.
+     * The first line also decides here document termination, so a change
+     * there invalidates every later checkpoint as well. */
+    size_t keep = 0;
+    while (keep < analyzer->checkpoint_count &&
+           analyzer->checkpoints[keep].offset <= common) {
+        keep++;
+    }
+    truncate_checkpoints(analyzer, keep);
+
+    continuation_state_t state;
+    continuation_scan_t scan = {{0}, 0};
+    size_t offset = 0;
+    if (analyzer->checkpoint_count > 0) {
+        const continuation_checkpoint_t *cp =
+            &analyzer->checkpoints[analyzer->checkpoint_count - 1];
+        offset = cp->offset;
+        state_copy(&state, &cp->state);
+        if (cp->pending_word) {
+            scan.word_pos = (int)strlen(cp->pending_word);
+            memcpy(scan.word, cp->pending_word, (size_t)scan.word_pos);
+        }
+    } else {
+        continuation_state_init(&state);
+        push_checkpoint(analyzer, 0, &state, &scan);
+    }
+
+    const char *base = analyzer->text;
+    const char *p = base + offset;
+    const char *end = base + len;
+    size_t lines = 0;
+    while (p < end) {
+        const char *nl = memchr(p, '\n', (size_t)(end - p));
+        const char *stop = nl ? nl + 1 : end;
+        scan_text(base, p, stop, &state, &scan);
+        lines++;
+        p = stop;
+        if (nl) {
+            push_checkpoint(analyzer, (size_t)(p - base), &state, &scan);
+        }
+    }
+    analyzer->lines_scanned = lines;
+
+    continuation_state_cleanup(&analyzer->state);
+    analyzer->state = state;
+    finish_text(base, len, &analyzer->state, &scan);
+    return &analyzer->state;
+}
+
+/**
+ * @brief Check whether a line starts with a word that closes or continues
+ *        the enclosing block (then, do, else, elif, fi, done, esac, })
+ *
+ * @param p Start of the line
+ * @param end End of the line
+ */
+static bool line_outdents(const char *p, const char *end) {
+    static const char *const words[] = {"then", "do",   "else", "elif",
+                                        "fi",   "done", "esac", "}"};
+
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+        size_t n = strlen(words[i]);
+        if ((size_t)(end - p) >= n && strncmp(p, words[i], n) == 0 &&
+            (p + n == end || !(isalnum((unsigned char)p[n]) || p[n] == '_'))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Indentation depth for a line break inserted at an offset
+ *
+ * Looks up the checkpoint of the line holding @p offset and scans only
+ * from there to @p offset, so the cost depends on the edited line rather
+ * than on the size of the buffer.
+ *
+ * @param analyzer Analyzer updated with the current buffer text
+ * @param offset Byte offset of the line break
+ * @param line_depth Receives the depth of the line holding @p offset, one
+ *                   less when it starts with then, do, else, elif, fi,
+ *                   done, esac or }, and -1 when it starts inside a
+ *                   quoted string or here document; may be NULL
+ * @return Depth of the new line, or -1 when leading whitespace would become
+ *         part of a quoted string or here document
+ */
+int continuation_analyzer_depth_at(const continuation_analyzer_t *analyzer,
+                                   size_t offset, int *line_depth) {
+    if (!analyzer || !analyzer->text || analyzer->checkpoint_count == 0 ||
+        offset > analyzer->text_len)
+        return -1;
+
+    const char *base = analyzer->text;
+    size_t line_start = offset;
+    while (line_start > 0 && base[line_start - 1] != '\n') {
+        line_start--;
+    }
+    const char *eol = memchr(base + offset, '\n', analyzer->text_len - offset);
+    const char *line_end = eol ? eol : base + analyzer->text_len;
+
+    /* Last checkpoint at or before the line start */
+    size_t lo = 0;
+    size_t hi = analyzer->checkpoint_count;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (analyzer->checkpoints[mid].offset <= line_start) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    const continuation_checkpoint_t *cp = &analyzer->checkpoints[lo];
+
+    continuation_state_t state;
+    continuation_scan_t scan = {{0}, 0};
+    state_copy(&state, &cp->state);
+    if (cp->pending_word) {
+        scan.word_pos = (int)strlen(cp->pending_word);
+        memcpy(scan.word, cp->pending_word, (size_t)scan.word_pos);
+    }
+    scan_text(base, base + cp->offset, base + line_start, &state, &scan);
+
+    if (line_depth) {
+        int depth = state.context_stack_depth;
+        if (state.in_single_quote || state.in_double_quote ||
+            state.in_backtick || state.in_here_doc) {
+            depth = -1;
+        } else if (depth > 0 && line_outdents(base + line_start, line_end)) {
+            depth--;
+        }
+        *line_depth = depth;
+    }
+
+    scan_text(base, base + line_start, base + offset, &state, &scan);
+    finish_text(base, offset, &state, &scan);
+    int depth = state.context_stack_depth;
+    if (state.in_single_quote || state.in_double_quote || state.in_backtick ||
+        state.in_here_doc) {
+        depth = -1;
+    }
+    continuation_state_cleanup(&state);
+    return depth;
+}
+
 // ============================================================================
 // COMPLETION CHECKING
 // ============================================================================
@@ -69,6 +69,25 @@ uint64_t fnv1a_hash_str_casecmp(const void *key, uint64_t seed) {
     return __fnv1a_hash(key, seed, true);
 }
 
+/**
+ * @brief Hash a byte range using the FNV1A algorithm
+ * @param data Pointer to the bytes to hash
+ * @param len Number of bytes
+ * @param seed Initial seed value, or a previous hash to continue
+ * @return 64-bit hash value
+ */
+uint64_t fnv1a_hash_bytes(const void *data, size_t len, uint64_t seed) {
+    const unsigned char *p = data;
+    uint64_t h = seed;
+
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint64_t)p[i];
+        h *= FNV1A_PRIME;
+    }
+
+    return h;
+}
+
 /**
  * @brief Case sensitive string comparison function
  * @param a Pointer to the first string
@@ -13,7 +13,11 @@
  * - Atomic operation tracking
  * - Complete undo/redo with cursor restoration
  * - Operation sequences for grouping
- * - Memory-efficient storage
+ * - Coalescing of typing runs, delete runs and cursor moves, so undoing a
+ *   run costs one buffer edit no matter how many keystrokes built it
+ * - Operation text kept in a chunked delta log rather than one allocation
+ *   per operation, with sequences and operations recycled
+ * - Byte-based memory budget enforced by dropping the oldest history
  * - Branching timeline support (redo cleared on new edits)
  */
 
@@ -83,21 +87,220 @@ find_last_redoable_sequence(lle_change_tracker_t *tracker) {
     return NULL;
 }
 
+/* Spare structures kept for reuse; more than this are returned to the pool */
+#define CHANGE_TRACKER_MAX_SPARES 32
+
+/**
+ * @brief Chunk of the delta log
+ *
+ * Operation text is appended to the newest chunk. Each chunk counts the
+ * bytes still referenced by operations and is freed when that reaches
+ * zero, which happens oldest-first as history is dropped.
+ */
+struct lle_change_log_chunk_t {
+    struct lle_change_log_chunk_t *newer; /* Next newer chunk */
+    struct lle_change_log_chunk_t *older; /* Next older chunk */
+    size_t capacity;                      /* Usable bytes in data */
+    size_t used;                          /* Bytes handed out */
+    size_t live;                          /* Bytes still referenced */
+    char data[];                          /* Log bytes */
+};
+
+/**
+ * @brief Reserve space for text in the delta log
+ *
+ * @param tracker Change tracker owning the log
+ * @param size Bytes needed (including the terminator)
+ * @param chunk_out Receives the chunk the space belongs to
+ * @return Start of the reserved space, or NULL on allocation failure
+ */
+static char *log_reserve(lle_change_tracker_t *tracker, size_t size,
+                         lle_change_log_chunk_t **chunk_out) {
+    lle_change_log_chunk_t *chunk = tracker->log_head;
+    if (!chunk || chunk->capacity - chunk->used < size) {
+        size_t capacity = size > LLE_BUFFER_CHANGE_LOG_CHUNK
+                              ? size
+                              : LLE_BUFFER_CHANGE_LOG_CHUNK;
+        chunk = (lle_change_log_chunk_t *)lle_pool_alloc(
+            sizeof(lle_change_log_chunk_t) + capacity);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->newer = NULL;
+        chunk->older = tracker->log_head;
+        chunk->capacity = capacity;
+        chunk->used = 0;
+        chunk->live = 0;
+        if (tracker->log_head) {
+            tracker->log_head->newer = chunk;
+        } else {
+            tracker->log_tail = chunk;
+        }
+        tracker->log_head = chunk;
+        tracker->memory_used += sizeof(lle_change_log_chunk_t) + capacity;
+    }
+
+    char *space = chunk->data + chunk->used;
+    chunk->used += size;
+    chunk->live += size;
+    *chunk_out = chunk;
+    return space;
+}
+
+/**
+ * @brief Release text stored in the delta log
+ *
+ * Frees the chunk once nothing refers to it. The newest chunk is instead
+ * rewound so the next append reuses it.
+ */
+static void log_release(lle_change_tracker_t *tracker,
+                        lle_change_log_chunk_t *chunk, size_t size) {
+    if (!chunk) {
+        return;
+    }
+
+    chunk->live -= size;
+    if (chunk->live > 0) {
+        return;
+    }
+
+    if (chunk == tracker->log_head) {
+        chunk->used = 0;
+        return;
+    }
+
+    /* Unlink (chunk is not the head, so it has a newer neighbour) */
+    chunk->newer->older = chunk->older;
+    if (chunk->older) {
+        chunk->older->newer = chunk->newer;
+    } else {
+        tracker->log_tail = chunk->newer;
+    }
+    tracker->memory_used -= sizeof(lle_change_log_chunk_t) + chunk->capacity;
+    lle_pool_free(chunk);
+}
+
+/**
+ * @brief Copy text into the delta log
+ *
+ * Operations created outside a tracker (no owning sequence) fall back to a
+ * private pool allocation.
+ */
+static lle_result_t store_text(lle_change_operation_t *op, const char *text,
+                               size_t length, char **text_out,
+                               lle_change_log_chunk_t **chunk_out) {
+    lle_change_tracker_t *tracker = op->sequence ? op->sequence->tracker : NULL;
+    char *copy;
+
+    if (tracker) {
+        copy = log_reserve(tracker, length + 1, chunk_out);
+    } else {
+        copy = (char *)lle_pool_alloc(length + 1);
+        *chunk_out = NULL;
+    }
+    if (!copy) {
+        return LLE_ERROR_OUT_OF_MEMORY;
+    }
+
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    *text_out = copy;
+    return LLE_SUCCESS;
+}
+
+/**
+ * @brief Drop one stored text of an operation
+ */
+static void release_text(lle_change_tracker_t *tracker, char **text,
+                         size_t length, lle_change_log_chunk_t **chunk) {
+    if (!*text) {
+        return;
+    }
+    if (*chunk && tracker) {
+        log_release(tracker, *chunk, length + 1);
+    } else {
+        lle_pool_free(*text);
+    }
+    *text = NULL;
+    *chunk = NULL;
+}
+
+/**
+ * @brief Grow an operation's text by adding bytes at the front or back
+ *
+ * Text at the end of the newest chunk is extended in place, so a typing
+ * run appends each keystroke without copying. Otherwise the combined text
+ * is written to fresh log space and the old copy released.
+ *
+ * @return true on success, false if no memory was available
+ */
+static bool extend_text(lle_change_tracker_t *tracker, char **text,
+                        size_t *length, lle_change_log_chunk_t **chunk,
+                        const char *add, size_t add_length, bool prepend) {
+    lle_change_log_chunk_t *head = tracker->log_head;
+    if (*chunk && *chunk == head &&
+        *text + *length + 1 == head->data + head->used &&
+        head->capacity - head->used >= add_length) {
+        if (prepend) {
+            memmove(*text + add_length, *text, *length);
+            memcpy(*text, add, add_length);
+        } else {
+            memcpy(*text + *length, add, add_length);
+        }
+        *length += add_length;
+        (*text)[*length] = '\0';
+        head->used += add_length;
+        head->live += add_length;
+        return true;
+    }
+
+    lle_change_log_chunk_t *new_chunk = NULL;
+    char *combined =
+        log_reserve(tracker, *length + add_length + 1, &new_chunk);
+    if (!combined) {
+        return false;
+    }
+    if (prepend) {
+        memcpy(combined, add, add_length);
+        memcpy(combined + add_length, *text, *length);
+    } else {
+        memcpy(combined, *text, *length);
+        memcpy(combined + *length, add, add_length);
+    }
+    size_t new_length = *length + add_length;
+    combined[new_length] = '\0';
+
+    release_text(tracker, text, *length, chunk);
+    *text = combined;
+    *length = new_length;
+    *chunk = new_chunk;
+    return true;
+}
+
 /**
  * @brief Free operation and its associated data
+ *
+ * The structure goes back to the tracker's spare list when there is room.
  */
 static void free_operation(lle_change_operation_t *op,
-                           lush_memory_pool_t *pool) {
-    (void)pool; /* Reserved for future pool-based deallocation */
+                           lle_change_tracker_t *tracker) {
     if (!op) {
         return;
     }
 
-    if (op->inserted_text) {
-        lle_pool_free(op->inserted_text);
-    }
-    if (op->deleted_text) {
-        lle_pool_free(op->deleted_text);
+    release_text(tracker, &op->inserted_text, op->inserted_length,
+                 &op->inserted_chunk);
+    release_text(tracker, &op->deleted_text, op->deleted_length,
+                 &op->deleted_chunk);
+
+    if (tracker && op->sequence && op->sequence->tracker == tracker) {
+        tracker->memory_used -= sizeof(lle_change_operation_t);
+        if (tracker->free_operation_count < CHANGE_TRACKER_MAX_SPARES) {
+            op->next = tracker->free_operations;
+            tracker->free_operations = op;
+            tracker->free_operation_count++;
+            return;
+        }
     }
 
     lle_pool_free(op);
@@ -107,7 +310,7 @@ static void free_operation(lle_change_operation_t *op,
  * @brief Free sequence and all its operations
  */
 static void free_sequence(lle_change_sequence_t *seq,
-                          lush_memory_pool_t *pool) {
+                          lle_change_tracker_t *tracker) {
     if (!seq) {
         return;
     }
@@ -116,13 +319,177 @@ static void free_sequence(lle_change_sequence_t *seq,
     lle_change_operation_t *op = seq->first_op;
     while (op) {
         lle_change_operation_t *next = op->next;
-        free_operation(op, pool);
+        free_operation(op, tracker);
         op = next;
     }
 
+    tracker->memory_used -= sizeof(lle_change_sequence_t);
+    if (tracker->free_sequence_count < CHANGE_TRACKER_MAX_SPARES) {
+        seq->next = tracker->free_sequences;
+        tracker->free_sequences = seq;
+        tracker->free_sequence_count++;
+        return;
+    }
+
     lle_pool_free(seq);
 }
 
+/**
+ * @brief Free every sequence, log chunk and spare structure
+ */
+static void release_all(lle_change_tracker_t *tracker) {
+    lle_change_sequence_t *seq = tracker->first_sequence;
+    while (seq) {
+        lle_change_sequence_t *next = seq->next;
+        free_sequence(seq, tracker);
+        seq = next;
+    }
+    tracker->first_sequence = NULL;
+    tracker->last_sequence = NULL;
+    tracker->current_position = NULL;
+
+    lle_change_log_chunk_t *chunk = tracker->log_head;
+    while (chunk) {
+        lle_change_log_chunk_t *older = chunk->older;
+        lle_pool_free(chunk);
+        chunk = older;
+    }
+    tracker->log_head = NULL;
+    tracker->log_tail = NULL;
+
+    while (tracker->free_sequences) {
+        lle_change_sequence_t *next = tracker->free_sequences->next;
+        lle_pool_free(tracker->free_sequences);
+        tracker->free_sequences = next;
+    }
+    while (tracker->free_operations) {
+        lle_change_operation_t *next = tracker->free_operations->next;
+        lle_pool_free(tracker->free_operations);
+        tracker->free_operations = next;
+    }
+    tracker->free_sequence_count = 0;
+    tracker->free_operation_count = 0;
+}
+
+/**
+ * @brief Drop the oldest sequence in history
+ *
+ * @return true if a sequence was dropped, false if the oldest sequence is
+ *         the current position and must be kept
+ */
+static bool drop_oldest_sequence(lle_change_tracker_t *tracker) {
+    lle_change_sequence_t *old = tracker->first_sequence;
+    if (!old || old == tracker->current_position ||
+        old == tracker->active_sequence) {
+        return false;
+    }
+
+    tracker->first_sequence = old->next;
+    if (tracker->first_sequence) {
+        tracker->first_sequence->prev = NULL;
+    } else {
+        tracker->last_sequence = NULL;
+    }
+
+    free_sequence(old, tracker);
+    tracker->sequence_count--;
+    return true;
+}
+
+/**
+ * @brief Drop oldest history until the memory budget is met
+ */
+static void enforce_memory_budget(lle_change_tracker_t *tracker) {
+    if (tracker->memory_budget == 0) {
+        return;
+    }
+    while (tracker->memory_used > tracker->memory_budget &&
+           drop_oldest_sequence(tracker)) {
+        tracker->compacted_count++;
+    }
+}
+
+/**
+ * @brief Merge a just-completed sequence into its predecessor
+ *
+ * Applies when both sequences have the same description, the new sequence
+ * holds a single operation and that operation continues the predecessor's
+ * last one: typing right after an insert, deleting next to a delete, or
+ * another cursor move.
+ *
+ * @return true if the sequence was merged (and freed)
+ */
+static bool coalesce_sequence(lle_change_tracker_t *tracker,
+                              lle_change_sequence_t *seq) {
+    lle_change_sequence_t *prev = seq->prev;
+    if (!tracker->coalescing_enabled || tracker->coalesce_break || !prev ||
+        !prev->sequence_complete || !prev->can_undo || !prev->last_op ||
+        seq->operation_count != 1 || !seq->description ||
+        !prev->description || strcmp(seq->description, prev->description)) {
+        return false;
+    }
+
+    lle_change_operation_t *last = prev->last_op;
+    lle_change_operation_t *op = seq->first_op;
+    if (last->type != op->type) {
+        return false;
+    }
+
+    switch (op->type) {
+    case LLE_CHANGE_TYPE_INSERT:
+        if (op->start_position != last->start_position + last->inserted_length ||
+            !extend_text(tracker, &last->inserted_text, &last->inserted_length,
+                         &last->inserted_chunk, op->inserted_text,
+                         op->inserted_length, false)) {
+            return false;
+        }
+        last->affected_length = last->inserted_length;
+        last->end_position = last->start_position + last->inserted_length;
+        break;
+
+    case LLE_CHANGE_TYPE_DELETE:
+        if (op->start_position + op->deleted_length == last->start_position) {
+            /* Backspace run: the new text precedes the old */
+            if (!extend_text(tracker, &last->deleted_text,
+                             &last->deleted_length, &last->deleted_chunk,
+                             op->deleted_text, op->deleted_length, true)) {
+                return false;
+            }
+            last->start_position = op->start_position;
+        } else if (op->start_position == last->start_position) {
+            /* Forward delete run: the new text follows the old */
+            if (!extend_text(tracker, &last->deleted_text,
+                             &last->deleted_length, &last->deleted_chunk,
+                             op->deleted_text, op->deleted_length, false)) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+        last->affected_length = last->deleted_length;
+        last->end_position = last->start_position + last->deleted_length;
+        break;
+
+    case LLE_CHANGE_TYPE_CURSOR_MOVE:
+        break;
+
+    default:
+        return false;
+    }
+
+    last->cursor_after = op->cursor_after;
+    prev->end_time = seq->start_time;
+
+    /* Unlink the merged sequence; it is the newest in history */
+    prev->next = NULL;
+    tracker->last_sequence = prev;
+    tracker->current_position = prev;
+    tracker->sequence_count--;
+    tracker->coalesced_count++;
+    free_sequence(seq, tracker);
+    return true;
+}
+
 /* ============================================================================
  * CHANGE TRACKER LIFECYCLE
  * ============================================================================
@@ -152,6 +519,8 @@ lle_result_t lle_change_tracker_init(lle_change_tracker_t **tracker,
     t->next_sequence_id = 1;
     t->next_operation_id = 1;
     t->memory_used = sizeof(lle_change_tracker_t);
+    t->memory_budget = LLE_BUFFER_UNDO_MEMORY_BUDGET;
+    t->coalescing_enabled = true;
 
     *tracker = t;
     return LLE_SUCCESS;
@@ -162,13 +531,8 @@ lle_result_t lle_change_tracker_destroy(lle_change_tracker_t *tracker) {
         return LLE_ERROR_INVALID_PARAMETER;
     }
 
-    /* Free all sequences */
-    lle_change_sequence_t *seq = tracker->first_sequence;
-    while (seq) {
-        lle_change_sequence_t *next = seq->next;
-        free_sequence(seq, tracker->memory_pool);
-        seq = next;
-    }
+    /* Free all sequences, log chunks and spares */
+    release_all(tracker);
 
     /* Free tracker itself */
     lle_pool_free(tracker);
@@ -181,29 +545,43 @@ lle_result_t lle_change_tracker_clear(lle_change_tracker_t *tracker) {
         return LLE_ERROR_INVALID_PARAMETER;
     }
 
-    /* Free all sequences */
-    lle_change_sequence_t *seq = tracker->first_sequence;
-    while (seq) {
-        lle_change_sequence_t *next = seq->next;
-        free_sequence(seq, tracker->memory_pool);
-        seq = next;
-    }
+    /* Free all sequences, log chunks and spares */
+    release_all(tracker);
 
     /* Reset tracker state */
-    tracker->first_sequence = NULL;
-    tracker->last_sequence = NULL;
-    tracker->current_position = NULL;
     tracker->active_sequence = NULL;
     tracker->sequence_in_progress = false;
     tracker->sequence_count = 0;
     tracker->undo_count = 0;
     tracker->redo_count = 0;
     tracker->operation_count = 0;
+    tracker->coalesce_break = false;
     tracker->memory_used = sizeof(lle_change_tracker_t);
 
     return LLE_SUCCESS;
 }
 
+lle_result_t lle_change_tracker_set_memory_budget(lle_change_tracker_t *tracker,
+                                                  size_t bytes) {
+    if (!tracker) {
+        return LLE_ERROR_INVALID_PARAMETER;
+    }
+
+    tracker->memory_budget = bytes;
+    enforce_memory_budget(tracker);
+    return LLE_SUCCESS;
+}
+
+lle_result_t lle_change_tracker_set_coalescing(lle_change_tracker_t *tracker,
+                                               bool enabled) {
+    if (!tracker) {
+        return LLE_ERROR_INVALID_PARAMETER;
+    }
+
+    tracker->coalescing_enabled = enabled;
+    return LLE_SUCCESS;
+}
+
 /* ============================================================================
  * OPERATION TRACKING
  * ============================================================================
@@ -222,11 +600,17 @@ lle_change_tracker_begin_sequence(lle_change_tracker_t *tracker,
         return LLE_ERROR_OPERATION_IN_PROGRESS;
     }
 
-    /* Allocate new sequence */
-    lle_change_sequence_t *seq =
-        (lle_change_sequence_t *)lle_pool_alloc(sizeof(lle_change_sequence_t));
-    if (!seq) {
-        return LLE_ERROR_OUT_OF_MEMORY;
+    /* Take a spare sequence or allocate a new one */
+    lle_change_sequence_t *seq = tracker->free_sequences;
+    if (seq) {
+        tracker->free_sequences = seq->next;
+        tracker->free_sequence_count--;
+    } else {
+        seq = (lle_change_sequence_t *)lle_pool_alloc(
+            sizeof(lle_change_sequence_t));
+        if (!seq) {
+            return LLE_ERROR_OUT_OF_MEMORY;
+        }
     }
 
     /* Initialize sequence */
@@ -234,27 +618,35 @@ lle_change_tracker_begin_sequence(lle_change_tracker_t *tracker,
 
     seq->sequence_id = tracker->next_sequence_id++;
     seq->start_time = get_timestamp_us();
+    seq->end_time = seq->start_time;
+    seq->tracker = tracker;
     seq->can_undo = true;
     seq->can_redo = false;
     seq->sequence_complete = false;
-
-    if (description) {
-        strncpy(seq->description, description, sizeof(seq->description) - 1);
-        seq->description[sizeof(seq->description) - 1] = '\0';
-    } else {
-        strcpy(seq->description, "Untitled operation");
-    }
+    seq->description = description ? description : "Untitled operation";
 
     /* Clear any redo history (branching timeline) */
     if (tracker->current_position && tracker->current_position->next) {
         lle_change_sequence_t *redo_seq = tracker->current_position->next;
         while (redo_seq) {
             lle_change_sequence_t *next = redo_seq->next;
-            free_sequence(redo_seq, tracker->memory_pool);
+            free_sequence(redo_seq, tracker);
+            tracker->sequence_count--;
             redo_seq = next;
         }
         tracker->current_position->next = NULL;
         tracker->last_sequence = tracker->current_position;
+    } else if (!tracker->current_position && tracker->first_sequence) {
+        /* Everything was undone: the whole history is redo history */
+        lle_change_sequence_t *redo_seq = tracker->first_sequence;
+        while (redo_seq) {
+            lle_change_sequence_t *next = redo_seq->next;
+            free_sequence(redo_seq, tracker);
+            tracker->sequence_count--;
+            redo_seq = next;
+        }
+        tracker->first_sequence = NULL;
+        tracker->last_sequence = NULL;
     }
 
     /* Add to sequence chain */
@@ -275,20 +667,8 @@ lle_change_tracker_begin_sequence(lle_change_tracker_t *tracker,
     tracker->memory_used += sizeof(lle_change_sequence_t);
 
     /* Enforce undo limit */
-    while (tracker->sequence_count > tracker->max_undo_levels) {
-        lle_change_sequence_t *old = tracker->first_sequence;
-        if (old == tracker->current_position) {
-            break; /* Don't remove current position */
-        }
-
-        tracker->first_sequence = old->next;
-        if (tracker->first_sequence) {
-            tracker->first_sequence->prev = NULL;
-        }
-
-        free_sequence(old, tracker->memory_pool);
-        tracker->sequence_count--;
-        tracker->memory_used -= sizeof(lle_change_sequence_t);
+    while (tracker->sequence_count > tracker->max_undo_levels &&
+           drop_oldest_sequence(tracker)) {
     }
 
     *sequence = seq;
@@ -306,13 +686,20 @@ lle_change_tracker_complete_sequence(lle_change_tracker_t *tracker) {
     }
 
     /* Finalize sequence */
-    tracker->active_sequence->end_time = get_timestamp_us();
-    tracker->active_sequence->sequence_complete = true;
+    lle_change_sequence_t *seq = tracker->active_sequence;
+    seq->sequence_complete = true;
 
     /* Clear tracking state */
     tracker->active_sequence = NULL;
     tracker->sequence_in_progress = false;
 
+    /* Fold continuing edits into the previous undo unit */
+    if (seq == tracker->last_sequence) {
+        coalesce_sequence(tracker, seq);
+    }
+    tracker->coalesce_break = false;
+
+    enforce_memory_budget(tracker);
     return LLE_SUCCESS;
 }
 
@@ -323,11 +710,19 @@ lle_result_t lle_change_tracker_begin_operation(
         return LLE_ERROR_INVALID_PARAMETER;
     }
 
-    /* Allocate new operation */
-    lle_change_operation_t *op = (lle_change_operation_t *)lle_pool_alloc(
-        sizeof(lle_change_operation_t));
-    if (!op) {
-        return LLE_ERROR_OUT_OF_MEMORY;
+    /* Take a spare operation or allocate a new one */
+    lle_change_tracker_t *tracker = sequence->tracker;
+    lle_change_operation_t *op = NULL;
+    if (tracker && tracker->free_operations) {
+        op = tracker->free_operations;
+        tracker->free_operations = op->next;
+        tracker->free_operation_count--;
+    } else {
+        op = (lle_change_operation_t *)lle_pool_alloc(
+            sizeof(lle_change_operation_t));
+        if (!op) {
+            return LLE_ERROR_OUT_OF_MEMORY;
+        }
     }
 
     /* Initialize operation */
@@ -337,7 +732,14 @@ lle_result_t lle_change_tracker_begin_operation(
     op->start_position = start_position;
     op->end_position = start_position + length;
     op->affected_length = length;
-    op->timestamp = get_timestamp_us();
+    op->timestamp = sequence->start_time;
+    op->sequence = sequence;
+
+    if (tracker) {
+        op->operation_id = tracker->next_operation_id++;
+        tracker->operation_count++;
+        tracker->memory_used += sizeof(lle_change_operation_t);
+    }
 
     /* Add to sequence */
     if (!sequence->first_op) {
@@ -373,16 +775,15 @@ lle_change_tracker_save_deleted_text(lle_change_operation_t *operation,
         return LLE_ERROR_INVALID_PARAMETER;
     }
 
-    /* Allocate and copy deleted text */
-    operation->deleted_text = (char *)lle_pool_alloc(deleted_length + 1);
-    if (!operation->deleted_text) {
-        return LLE_ERROR_OUT_OF_MEMORY;
+    /* Copy deleted text into the delta log */
+    lle_result_t result =
+        store_text(operation, deleted_text, deleted_length,
+                   &operation->deleted_text, &operation->deleted_chunk);
+    if (result != LLE_SUCCESS) {
+        return result;
     }
 
-    memcpy(operation->deleted_text, deleted_text, deleted_length);
-    operation->deleted_text[deleted_length] = '\0';
     operation->deleted_length = deleted_length;
-
     return LLE_SUCCESS;
 }
 
@@ -394,16 +795,15 @@ lle_change_tracker_save_inserted_text(lle_change_operation_t *operation,
         return LLE_ERROR_INVALID_PARAMETER;
     }
 
-    /* Allocate and copy inserted text */
-    operation->inserted_text = (char *)lle_pool_alloc(inserted_length + 1);
-    if (!operation->inserted_text) {
-        return LLE_ERROR_OUT_OF_MEMORY;
+    /* Copy inserted text into the delta log */
+    lle_result_t result =
+        store_text(operation, inserted_text, inserted_length,
+                   &operation->inserted_text, &operation->inserted_chunk);
+    if (result != LLE_SUCCESS) {
+        return result;
     }
 
-    memcpy(operation->inserted_text, inserted_text, inserted_length);
-    operation->inserted_text[inserted_length] = '\0';
     operation->inserted_length = inserted_length;
-
     return LLE_SUCCESS;
 }
 
@@ -481,6 +881,9 @@ lle_result_t lle_change_tracker_undo(lle_change_tracker_t *tracker,
         sequence->can_redo = true;
         tracker->undo_count++;
 
+        /* The next edit starts a new undo unit */
+        tracker->coalesce_break = true;
+
         /* Move current position back */
         if (tracker->current_position == sequence) {
             tracker->current_position =
@@ -562,6 +965,7 @@ lle_result_t lle_change_tracker_redo(lle_change_tracker_t *tracker,
         sequence->can_undo = true;
         sequence->can_redo = false;
         tracker->redo_count++;
+        tracker->coalesce_break = true;
 
         /* Move current position forward */
         tracker->current_position = sequence;
@@ -618,8 +1022,9 @@ size_t lle_change_tracker_redo_depth(const lle_change_tracker_t *tracker) {
     }
 
     size_t depth = 0;
-    lle_change_sequence_t *seq =
-        tracker->current_position ? tracker->current_position->next : NULL;
+    lle_change_sequence_t *seq = tracker->current_position
+                                     ? tracker->current_position->next
+                                     : tracker->first_sequence;
 
     while (seq) {
         if (seq->can_redo && seq->sequence_complete) {
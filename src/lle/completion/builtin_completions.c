@@ -137,6 +137,14 @@ static const lle_builtin_option_t jobs_options[] = {
     {"-p", "Show only process IDs"},
 };
 
+/* z options */
+static const lle_builtin_option_t z_options[] = {
+    {"-l", "List matches with scores"},
+    {"-e", "Print the best match"},
+    {"-c", "Only match below the current directory"},
+    {"-x", "Remove a directory from the index"},
+};
+
 /* setopt options */
 static const lle_builtin_option_t setopt_options[] = {
     {"-p", "Print in re-usable format"},
@@ -441,6 +449,8 @@ static const lle_builtin_completion_spec_t builtin_specs[] = {
     {"pushd", NULL, 0, NULL, 0, LLE_BUILTIN_ARG_DIRECTORY},
     {"popd", NULL, 0, NULL, 0, LLE_BUILTIN_ARG_NONE},
     {"dirs", NULL, 0, NULL, 0, LLE_BUILTIN_ARG_NONE},
+    {"z", z_options, sizeof(z_options) / sizeof(z_options[0]), NULL, 0,
+     LLE_BUILTIN_ARG_FRECENT_DIRECTORY},
 
     /* Simple builtins (no special completions, but registered for lookup) */
     {"exit", NULL, 0, NULL, 0, LLE_BUILTIN_ARG_NONE},
@@ -732,6 +742,7 @@ static const char *shell_feature_names[] = {
     "auto_cd",
     "auto_pushd",
     "cdable_vars",
+    "dir_frecency",
     /* Advanced */
     "nameref",
     "anonymous_functions",
@@ -808,6 +819,13 @@ generate_dynamic_completions(lle_memory_pool_t *pool,
 
     case LLE_BUILTIN_ARG_FEATURE:
         return generate_feature_completions(pool, prefix, result);
+
+    case LLE_BUILTIN_ARG_FRECENT_DIRECTORY:
+        /* Something that looks like a path is completed as one */
+        if (strchr(prefix, '/') || prefix[0] == '.' || prefix[0] == '~') {
+            return lle_completion_source_directories(pool, prefix, result);
+        }
+        return lle_completion_source_frecent_directories(pool, prefix, result);
     }
 
     return LLE_SUCCESS;
@@ -430,6 +430,32 @@ static char *lle_completion_expand_path(const char *path,
  * ============================================================================
  */
 
+/**
+ * @brief Completion score bonus for a frecently visited directory
+ *
+ * Saturates at 250 so a visited directory always sorts ahead of unvisited
+ * ones without leaving the directory score band.
+ *
+ * @param dir Resolved parent directory
+ * @param name Directory entry name
+ * @return Bonus between 0 and 249
+ */
+static int32_t frecency_boost(const char *dir, const char *name) {
+    size_t size = strlen(dir) + strlen(name) + 2;
+    char *path = malloc(size);
+    if (!path) {
+        return 0;
+    }
+    snprintf(path, size, "%s/%s", strcmp(dir, "/") == 0 ? "" : dir, name);
+    double frecency = lle_shell_directory_frecency(path);
+    free(path);
+
+    if (frecency <= 0.0) {
+        return 0;
+    }
+    return (int32_t)(250.0 * frecency / (frecency + 10.0));
+}
+
 /**
  * @brief Internal file/directory completion implementation
  *
@@ -497,6 +523,10 @@ static lle_result_t lle_completion_source_files_internal(
         return LLE_SUCCESS; // Directory doesn't exist, not an error
     }
 
+    // Resolved directory, used to rank subdirectories by how often and how
+    // recently they were visited
+    char *abs_dir = directories_only ? realpath(dir_path, NULL) : NULL;
+
     lle_result_t final_result = LLE_SUCCESS;
     struct dirent *entry;
 
@@ -538,6 +568,9 @@ static lle_result_t lle_completion_source_files_internal(
             type = LLE_COMPLETION_TYPE_DIRECTORY;
             suffix = "/";
             score = 700;
+            if (abs_dir) {
+                score += frecency_boost(abs_dir, entry->d_name);
+            }
         }
 
         free(full_path);
@@ -589,6 +622,7 @@ static lle_result_t lle_completion_source_files_internal(
     }
 
     closedir(d);
+    free(abs_dir);
     free(dir_copy);
     free(expanded_prefix);
 
@@ -632,6 +666,49 @@ lle_completion_source_directories(lle_memory_pool_t *memory_pool,
                                                 true);
 }
 
+/** Maximum frecent directories offered for one completion */
+#define FRECENT_DIRECTORY_LIMIT 20
+
+/**
+ * @brief Generate completions from the frecent directory index
+ *
+ * Unlike directory completion the prefix is matched anywhere in the path,
+ * so "z proj<TAB>" offers the visited directories named like proj, most
+ * frecent first.
+ *
+ * @param memory_pool Memory pool for allocations
+ * @param prefix Fragment to match
+ * @param result Completion result set to populate
+ * @return LLE_SUCCESS or error code
+ */
+lle_result_t
+lle_completion_source_frecent_directories(lle_memory_pool_t *memory_pool,
+                                          const char *prefix,
+                                          lle_completion_result_t *result) {
+    (void)memory_pool;
+    if (!prefix || !result) {
+        return LLE_ERROR_INVALID_PARAMETER;
+    }
+
+    char *paths[FRECENT_DIRECTORY_LIMIT];
+    size_t count = lle_shell_frecent_directories(prefix, paths,
+                                                 FRECENT_DIRECTORY_LIMIT);
+
+    lle_result_t final_result = LLE_SUCCESS;
+    for (size_t i = 0; i < count; i++) {
+        // Best first: keep that order within the directory score band
+        int32_t score = 950 - (int32_t)i;
+        lle_result_t res = lle_completion_result_add(
+            result, paths[i], "/", LLE_COMPLETION_TYPE_DIRECTORY, score);
+        if (res != LLE_SUCCESS && final_result == LLE_SUCCESS) {
+            final_result = res;
+        }
+        free(paths[i]);
+    }
+
+    return final_result;
+}
+
 /* ============================================================================
  * VARIABLES SOURCE
  * ============================================================================
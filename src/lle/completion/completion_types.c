@@ -774,3 +774,17 @@ __attribute__((weak)) bool lle_shell_is_alias(const char *text) {
     (void)text;
     return false;
 }
+
+__attribute__((weak)) double lle_shell_directory_frecency(const char *path) {
+    (void)path;
+    return 0.0;
+}
+
+__attribute__((weak)) size_t lle_shell_frecent_directories(const char *fragment,
+                                                           char **paths,
+                                                           size_t max) {
+    (void)fragment;
+    (void)paths;
+    (void)max;
+    return 0;
+}
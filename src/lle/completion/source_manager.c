@@ -107,6 +107,11 @@ static bool file_source_applicable(const lle_context_analyzer_t *context) {
                     spec->default_arg_type == LLE_BUILTIN_ARG_DIRECTORY) {
                     return true;
                 }
+                /* Jump targets come from the directory index instead */
+                if (spec->default_arg_type ==
+                    LLE_BUILTIN_ARG_FRECENT_DIRECTORY) {
+                    return false;
+                }
                 /* If builtin has subcommands, suppress generic file completion */
                 if (spec->subcommand_count > 0) {
                     return false;
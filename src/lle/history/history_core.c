@@ -178,6 +178,7 @@ lle_result_t lle_history_entry_create(lle_history_entry_t **entry,
     e->is_multiline = false;
     e->original_multiline = NULL;
     e->duration_ms = 0;
+    e->outcome_known = false;
     e->edit_count = 0;
 
     /* Phase 4 Day 11: Forensic fields - initialize to defaults */
@@ -441,6 +442,9 @@ lle_result_t lle_history_core_destroy(lle_history_core_t *core) {
         core->dedup_engine = NULL;
     }
 
+    /* Free query indexes */
+    lle_history_query_index_reset(core);
+
     /* Destroy configuration */
     if (core->config) {
         lle_history_config_destroy(core->config, core->memory_pool);
@@ -899,6 +903,9 @@ lle_result_t lle_history_clear(lle_history_core_t *core) {
         lle_history_index_clear(core->entry_lookup);
     }
 
+    /* Positions are reused from 0, so drop the query indexes */
+    lle_history_query_index_reset(core);
+
     /* Update statistics */
     core->stats.active_entries = 0;
 
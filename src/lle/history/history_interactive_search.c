@@ -195,10 +195,22 @@ static bool perform_search(void) {
         return false;
     }
 
-    /* Perform substring search (most useful for interactive search) */
-    session->results = lle_history_search_substring(
-        session->history_core, session->query, 100 /* max results */
-    );
+    /* Structured queries (dir:, exit:, dur:, ...) go through the history
+     * indexes; plain text uses substring search (most useful for
+     * interactive search). A filter word still being typed is malformed
+     * and falls back to substring search. */
+    lle_history_query_t query;
+    if (lle_history_query_parse(session->query, &query, NULL, 0) ==
+            LLE_SUCCESS &&
+        lle_history_query_has_filters(&query)) {
+        session->results = lle_history_search_query(
+            session->history_core, session->query, 100 /* max results */
+        );
+    } else {
+        session->results = lle_history_search_substring(
+            session->history_core, session->query, 100 /* max results */
+        );
+    }
 
     if (!session->results) {
         session->state = LLE_SEARCH_STATE_FAILED;
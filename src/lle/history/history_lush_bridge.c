@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <time.h>
 #include <unistd.h>
 
 /* GNU Readline headers - conditionally included */
@@ -655,16 +656,162 @@ lle_result_t lle_history_bridge_sync_all(void) {
  * ============================================================================
  */
 
+/**
+ * @brief Format a command duration for query listings
+ *
+ * @param ms Duration in milliseconds
+ * @param buf Output buffer
+ * @param size Size of output buffer
+ */
+static void format_duration(uint32_t ms, char *buf, size_t size) {
+    if (ms < 1000) {
+        snprintf(buf, size, "%ums", (unsigned)ms);
+    } else if (ms < 60000) {
+        snprintf(buf, size, "%.1fs", ms / 1000.0);
+    } else if (ms < 3600000) {
+        snprintf(buf, size, "%um%02us", (unsigned)(ms / 60000),
+                 (unsigned)(ms / 1000 % 60));
+    } else {
+        snprintf(buf, size, "%uh%02um", (unsigned)(ms / 3600000),
+                 (unsigned)(ms / 60000 % 60));
+    }
+}
+
+/**
+ * @brief Handle 'history -q QUERY...'
+ *
+ * Lists entries matching a structured query (see lle_history_query_parse),
+ * oldest first, with their time, exit status and duration.
+ *
+ * @param argc Argument count (argv[1] is "-q")
+ * @param argv Argument values; the words after -q form the query
+ * @param output Output pointer for formatted text
+ * @return LLE_SUCCESS, LLE_ERROR_INVALID_PARAMETER for a malformed query,
+ *         or another error code
+ */
+static lle_result_t handle_history_query(int argc, char **argv,
+                                         char **output) {
+    /* Join the query words */
+    size_t query_len = 1;
+    for (int i = 2; i < argc; i++) {
+        query_len += strlen(argv[i]) + 1;
+    }
+    char *query_string = malloc(query_len);
+    if (!query_string) {
+        return LLE_ERROR_OUT_OF_MEMORY;
+    }
+    query_string[0] = '\0';
+    for (int i = 2; i < argc; i++) {
+        if (i > 2) {
+            strcat(query_string, " ");
+        }
+        strcat(query_string, argv[i]);
+    }
+
+    lle_history_query_t query;
+    char error[256];
+    lle_result_t result =
+        lle_history_query_parse(query_string, &query, error, sizeof(error));
+    free(query_string);
+    if (result != LLE_SUCCESS) {
+        fprintf(stderr, "history: %s\n", error);
+        return result;
+    }
+
+    size_t entry_count = 0;
+    result = lle_history_get_entry_count(g_bridge->lle_core, &entry_count);
+    if (result != LLE_SUCCESS) {
+        return result;
+    }
+
+    size_t *positions = malloc(sizeof(size_t) * (entry_count ? entry_count : 1));
+    if (!positions) {
+        return LLE_ERROR_OUT_OF_MEMORY;
+    }
+    size_t found = 0;
+    result = lle_history_query_run(g_bridge->lle_core, &query, entry_count,
+                                   positions, &found);
+    if (result != LLE_SUCCESS) {
+        free(positions);
+        return result;
+    }
+
+    /* Size the buffer from the matches */
+    size_t buffer_size = 1;
+    for (size_t i = 0; i < found; i++) {
+        lle_history_entry_t *entry = NULL;
+        if (lle_history_get_entry_by_index(g_bridge->lle_core, positions[i],
+                                           &entry) == LLE_SUCCESS &&
+            entry) {
+            buffer_size += entry->command_length + 80;
+        }
+    }
+    char *buffer = (char *)lle_pool_alloc(buffer_size);
+    if (!buffer) {
+        free(positions);
+        return LLE_ERROR_OUT_OF_MEMORY;
+    }
+    buffer[0] = '\0';
+    size_t buffer_used = 0;
+
+    /* Oldest first, like the plain listing */
+    for (size_t i = found; i > 0; i--) {
+        lle_history_entry_t *entry = NULL;
+        if (lle_history_get_entry_by_index(g_bridge->lle_core,
+                                           positions[i - 1],
+                                           &entry) != LLE_SUCCESS ||
+            !entry) {
+            continue;
+        }
+
+        char when[32] = "-";
+        time_t ts = (time_t)entry->timestamp;
+        struct tm tm;
+        if (ts > 0 && localtime_r(&ts, &tm)) {
+            strftime(when, sizeof(when), "%Y-%m-%d %H:%M", &tm);
+        }
+        char status[16] = "-";
+        char duration[16] = "-";
+        if (entry->outcome_known) {
+            snprintf(status, sizeof(status), "%d", entry->exit_code);
+            format_duration(entry->duration_ms, duration, sizeof(duration));
+        }
+
+        int written =
+            snprintf(buffer + buffer_used, buffer_size - buffer_used,
+                     "%5llu  %-16s  %3s  %7s  %s\n",
+                     (unsigned long long)entry->entry_id, when, status,
+                     duration, entry->command);
+        if (written > 0 && (size_t)written < buffer_size - buffer_used) {
+            buffer_used += written;
+        } else {
+            break;
+        }
+    }
+    free(positions);
+
+    if (output) {
+        *output = buffer;
+    } else {
+        printf("%s", buffer);
+        lle_pool_free(buffer);
+    }
+
+    return LLE_SUCCESS;
+}
+
 /**
  * @brief Handle history builtin command
  *
  * Provides compatibility with existing 'history' command behavior
- * while using LLE as the backend.
+ * while using LLE as the backend. 'history -q QUERY...' lists the entries
+ * matching a structured query.
  *
- * @param argc Argument count (currently unused)
- * @param argv Argument values (currently unused)
+ * @param argc Argument count
+ * @param argv Argument values
  * @param output Output pointer for formatted history text (caller must free if non-NULL)
  * @return LLE_SUCCESS on success, LLE_ERROR_NOT_INITIALIZED if bridge not initialized,
+ *         LLE_ERROR_INVALID_PARAMETER for a malformed query,
  *         or LLE_ERROR_OUT_OF_MEMORY on allocation failure
  */
 lle_result_t lle_history_bridge_handle_builtin(int argc, char **argv,
@@ -673,8 +820,9 @@ lle_result_t lle_history_bridge_handle_builtin(int argc, char **argv,
         return LLE_ERROR_NOT_INITIALIZED;
     }
 
-    (void)argc;
-    (void)argv;
+    if (argc >= 2 && argv && strcmp(argv[1], "-q") == 0) {
+        return handle_history_query(argc, argv, output);
+    }
 
     /* Get entry count */
     size_t entry_count = 0;
@@ -0,0 +1,1287 @@
+/**
+ * @file history_query.c
+ * @brief LLE History System - Structured Queries and Secondary Indexes
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ *
+ * Answers queries such as "failed commands in this directory last week" or
+ * "commands that took more than 10s" without scanning the whole history.
+ *
+ * Architecture:
+ * - Posting lists of entry positions (ascending) per working directory,
+ *   per exit status, per log2 duration bucket and per session; only
+ *   entries whose outcome was recorded are in the exit and duration lists
+ * - Entry timestamps are checked for monotonic order so time ranges can be
+ *   located by binary search
+ * - The index trails the entry array and is caught up lazily at query
+ *   time; the entry array is append-only, so positions stay valid until
+ *   the history is cleared
+ * - A query picks the smallest candidate set (one posting list, a union of
+ *   a few, a time range or everything) and checks the remaining filters
+ *   per candidate, newest first, stopping at the result limit
+ */
+
+#include "lle/error_handling.h"
+#include "lle/history.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* ============================================================================
+ * CONSTANTS
+ * ============================================================================
+ */
+
+/* Exit status buckets: 0..255 plus one for anything outside that range */
+#define EXIT_BUCKETS 257
+#define EXIT_OTHER_BUCKET 256
+
+/* Duration buckets: 0 for 0ms, then b for [2^(b-1), 2^b) milliseconds */
+#define DURATION_BUCKETS 33
+
+/* Most posting lists merged for one filter before falling back to a scan */
+#define MAX_UNION_LISTS 64
+
+/* Initial directory hash size (power of two) */
+#define DIR_HASH_INITIAL 64
+
+/* How far back lle_history_record_result looks for the command */
+#define RECORD_LOOKBACK 16
+
+/* ============================================================================
+ * TYPE DEFINITIONS
+ * ============================================================================
+ */
+
+/**
+ * Ascending list of entry positions
+ */
+typedef struct {
+    uint32_t *items;
+    uint32_t count;
+    uint32_t capacity;
+} posting_list_t;
+
+/**
+ * Entries run in one working directory
+ */
+typedef struct {
+    char *path;
+    posting_list_t list;
+} dir_postings_t;
+
+/**
+ * Entries run in one session
+ */
+typedef struct {
+    pid_t session_id;
+    posting_list_t list;
+} session_postings_t;
+
+/**
+ * Secondary indexes over the entry array
+ */
+struct lle_history_query_index {
+    size_t indexed; /* entries[0..indexed) are indexed */
+
+    dir_postings_t *dirs;   /* Directories in first-seen order */
+    size_t dir_count;
+    size_t dir_capacity;
+    uint32_t *dir_hash;     /* Open addressing, dir index + 1, 0 = empty */
+    size_t dir_hash_size;
+
+    posting_list_t exits[EXIT_BUCKETS];
+    posting_list_t failed; /* Any non-zero exit status */
+    posting_list_t durations[DURATION_BUCKETS];
+
+    session_postings_t *sessions;
+    size_t session_count;
+    size_t session_capacity;
+
+    bool time_sorted;        /* Timestamps never decrease */
+    uint64_t last_timestamp; /* Timestamp of entries[indexed - 1] */
+};
+
+/**
+ * Candidate source for one query: a union of posting lists walked from the
+ * end, or a plain position range
+ */
+typedef struct {
+    const posting_list_t *lists[MAX_UNION_LISTS];
+    uint32_t cursors[MAX_UNION_LISTS]; /* Items left in each list */
+    size_t list_count;
+    bool use_lists;
+    size_t estimate;
+} candidate_source_t;
+
+/* ============================================================================
+ * POSTING LISTS
+ * ============================================================================
+ */
+
+/**
+ * @brief Append a position to a posting list
+ */
+static bool posting_append(posting_list_t *list, uint32_t pos) {
+    if (list->count == list->capacity) {
+        uint32_t cap = list->capacity ? list->capacity * 2 : 8;
+        uint32_t *items = realloc(list->items, sizeof(uint32_t) * cap);
+        if (!items) {
+            return false;
+        }
+        list->items = items;
+        list->capacity = cap;
+    }
+    list->items[list->count++] = pos;
+    return true;
+}
+
+/**
+ * @brief Insert a position keeping the list ascending
+ *
+ * Updates almost always concern recent entries, so the slot is searched
+ * from the end.
+ */
+static bool posting_insert(posting_list_t *list, uint32_t pos) {
+    if (!posting_append(list, pos)) {
+        return false;
+    }
+    uint32_t i = list->count - 1;
+    while (i > 0 && list->items[i - 1] > pos) {
+        list->items[i] = list->items[i - 1];
+        i--;
+    }
+    list->items[i] = pos;
+    return true;
+}
+
+/**
+ * @brief Remove a position from a posting list, searching from the end
+ */
+static void posting_remove(posting_list_t *list, uint32_t pos) {
+    for (uint32_t i = list->count; i > 0; i--) {
+        if (list->items[i - 1] == pos) {
+            memmove(&list->items[i - 1], &list->items[i],
+                    sizeof(uint32_t) * (list->count - i));
+            list->count--;
+            return;
+        }
+        if (list->items[i - 1] < pos) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Free a posting list's storage
+ */
+static void posting_free(posting_list_t *list) {
+    free(list->items);
+    list->items = NULL;
+    list->count = list->capacity = 0;
+}
+
+/* ============================================================================
+ * BUCKETS AND HASHING
+ * ============================================================================
+ */
+
+/**
+ * @brief Exit status bucket for a code
+ */
+static size_t exit_bucket(int exit_code) {
+    if (exit_code < 0 || exit_code > 255) {
+        return EXIT_OTHER_BUCKET;
+    }
+    return (size_t)exit_code;
+}
+
+/**
+ * @brief Duration bucket for a duration: 0, or 1 + floor(log2(ms))
+ */
+static size_t duration_bucket(uint32_t ms) {
+    size_t bucket = 0;
+    while (ms) {
+        bucket++;
+        ms >>= 1;
+    }
+    return bucket;
+}
+
+/**
+ * @brief Smallest duration in a bucket
+ */
+static uint32_t duration_bucket_min(size_t bucket) {
+    return bucket == 0 ? 0 : (uint32_t)1 << (bucket - 1);
+}
+
+/**
+ * @brief Largest duration in a bucket
+ */
+static uint32_t duration_bucket_max(size_t bucket) {
+    if (bucket == 0) {
+        return 0;
+    }
+    if (bucket >= 32) {
+        return UINT32_MAX;
+    }
+    return ((uint32_t)1 << bucket) - 1;
+}
+
+/**
+ * @brief FNV-1a hash of a path
+ */
+static uint32_t hash_path(const char *path) {
+    uint32_t h = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)path; *p; p++) {
+        h ^= *p;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief Find the hash slot for a path (its entry or the empty slot)
+ */
+static size_t dir_slot(const lle_history_query_index_t *idx,
+                       const char *path) {
+    size_t mask = idx->dir_hash_size - 1;
+    size_t slot = hash_path(path) & mask;
+    while (idx->dir_hash[slot] != 0 &&
+           strcmp(idx->dirs[idx->dir_hash[slot] - 1].path, path) != 0) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/**
+ * @brief Double the directory hash table
+ */
+static bool dir_hash_grow(lle_history_query_index_t *idx) {
+    size_t size = idx->dir_hash_size ? idx->dir_hash_size * 2
+                                     : DIR_HASH_INITIAL;
+    uint32_t *table = calloc(size, sizeof(uint32_t));
+    if (!table) {
+        return false;
+    }
+    free(idx->dir_hash);
+    idx->dir_hash = table;
+    idx->dir_hash_size = size;
+    for (size_t i = 0; i < idx->dir_count; i++) {
+        idx->dir_hash[dir_slot(idx, idx->dirs[i].path)] = (uint32_t)(i + 1);
+    }
+    return true;
+}
+
+/**
+ * @brief Look up the postings of a directory
+ */
+static dir_postings_t *dir_find(const lle_history_query_index_t *idx,
+                                const char *path) {
+    if (idx->dir_hash_size == 0) {
+        return NULL;
+    }
+    uint32_t ref = idx->dir_hash[dir_slot(idx, path)];
+    return ref ? &idx->dirs[ref - 1] : NULL;
+}
+
+/**
+ * @brief Look up or create the postings of a directory
+ */
+static dir_postings_t *dir_intern(lle_history_query_index_t *idx,
+                                  const char *path) {
+    dir_postings_t *dir = dir_find(idx, path);
+    if (dir) {
+        return dir;
+    }
+
+    /* Keep the load factor at or below one half */
+    if ((idx->dir_count + 1) * 2 > idx->dir_hash_size && !dir_hash_grow(idx)) {
+        return NULL;
+    }
+    if (idx->dir_count == idx->dir_capacity) {
+        size_t cap = idx->dir_capacity ? idx->dir_capacity * 2 : 16;
+        dir_postings_t *dirs = realloc(idx->dirs, sizeof(*dirs) * cap);
+        if (!dirs) {
+            return NULL;
+        }
+        idx->dirs = dirs;
+        idx->dir_capacity = cap;
+    }
+
+    dir = &idx->dirs[idx->dir_count];
+    memset(dir, 0, sizeof(*dir));
+    dir->path = strdup(path);
+    if (!dir->path) {
+        return NULL;
+    }
+    idx->dir_hash[dir_slot(idx, path)] = (uint32_t)(idx->dir_count + 1);
+    idx->dir_count++;
+    return dir;
+}
+
+/**
+ * @brief Look up the postings of a session
+ */
+static session_postings_t *session_find(const lle_history_query_index_t *idx,
+                                        pid_t session_id) {
+    /* Most recent sessions are last; only the current one grows */
+    for (size_t i = idx->session_count; i > 0; i--) {
+        if (idx->sessions[i - 1].session_id == session_id) {
+            return &idx->sessions[i - 1];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Look up or create the postings of a session
+ */
+static session_postings_t *session_intern(lle_history_query_index_t *idx,
+                                          pid_t session_id) {
+    session_postings_t *session = session_find(idx, session_id);
+    if (session) {
+        return session;
+    }
+    if (idx->session_count == idx->session_capacity) {
+        size_t cap = idx->session_capacity ? idx->session_capacity * 2 : 4;
+        session_postings_t *sessions =
+            realloc(idx->sessions, sizeof(*sessions) * cap);
+        if (!sessions) {
+            return NULL;
+        }
+        idx->sessions = sessions;
+        idx->session_capacity = cap;
+    }
+    session = &idx->sessions[idx->session_count++];
+    memset(session, 0, sizeof(*session));
+    session->session_id = session_id;
+    return session;
+}
+
+/* ============================================================================
+ * INDEX MAINTENANCE
+ * ============================================================================
+ */
+
+/**
+ * @brief Free an index and everything it owns
+ */
+static void index_destroy(lle_history_query_index_t *idx) {
+    if (!idx) {
+        return;
+    }
+    for (size_t i = 0; i < idx->dir_count; i++) {
+        free(idx->dirs[i].path);
+        posting_free(&idx->dirs[i].list);
+    }
+    free(idx->dirs);
+    free(idx->dir_hash);
+    for (size_t i = 0; i < EXIT_BUCKETS; i++) {
+        posting_free(&idx->exits[i]);
+    }
+    posting_free(&idx->failed);
+    for (size_t i = 0; i < DURATION_BUCKETS; i++) {
+        posting_free(&idx->durations[i]);
+    }
+    for (size_t i = 0; i < idx->session_count; i++) {
+        posting_free(&idx->sessions[i].list);
+    }
+    free(idx->sessions);
+    free(idx);
+}
+
+/**
+ * @brief Add the exit status and duration postings of one entry
+ */
+static bool index_add_outcome(lle_history_query_index_t *idx, uint32_t pos,
+                              int exit_code, uint32_t duration_ms,
+                              bool append) {
+    bool (*add)(posting_list_t *, uint32_t) =
+        append ? posting_append : posting_insert;
+
+    if (!add(&idx->exits[exit_bucket(exit_code)], pos)) {
+        return false;
+    }
+    if (exit_code != 0 && !add(&idx->failed, pos)) {
+        return false;
+    }
+    return add(&idx->durations[duration_bucket(duration_ms)], pos);
+}
+
+/**
+ * @brief Index one entry at the end of the indexed range
+ */
+static bool index_add_entry(lle_history_query_index_t *idx, uint32_t pos,
+                            const lle_history_entry_t *entry) {
+    if (entry->working_directory && entry->working_directory[0]) {
+        dir_postings_t *dir = dir_intern(idx, entry->working_directory);
+        if (!dir || !posting_append(&dir->list, pos)) {
+            return false;
+        }
+    }
+
+    if (entry->outcome_known &&
+        !index_add_outcome(idx, pos, entry->exit_code, entry->duration_ms,
+                           true)) {
+        return false;
+    }
+
+    if (entry->session_id != 0) {
+        session_postings_t *session = session_intern(idx, entry->session_id);
+        if (!session || !posting_append(&session->list, pos)) {
+            return false;
+        }
+    }
+
+    if (pos > 0 && entry->timestamp < idx->last_timestamp) {
+        idx->time_sorted = false;
+    }
+    idx->last_timestamp = entry->timestamp;
+    return true;
+}
+
+/**
+ * @brief Bring the index up to date with the entry array
+ *
+ * CRITICAL: Caller MUST hold the write lock on core->lock.
+ */
+static lle_result_t index_catch_up(lle_history_core_t *core) {
+    if (!core->query_index) {
+        core->query_index = calloc(1, sizeof(lle_history_query_index_t));
+        if (!core->query_index) {
+            return LLE_ERROR_OUT_OF_MEMORY;
+        }
+        core->query_index->time_sorted = true;
+    }
+
+    lle_history_query_index_t *idx = core->query_index;
+    if (core->entry_count > UINT32_MAX) {
+        return LLE_ERROR_OUT_OF_MEMORY;
+    }
+
+    while (idx->indexed < core->entry_count) {
+        lle_history_entry_t *entry = core->entries[idx->indexed];
+        if (entry &&
+            !index_add_entry(idx, (uint32_t)idx->indexed, entry)) {
+            /* Drop the partial index; the next query rebuilds it */
+            index_destroy(idx);
+            core->query_index = NULL;
+            return LLE_ERROR_OUT_OF_MEMORY;
+        }
+        idx->indexed++;
+    }
+
+    return LLE_SUCCESS;
+}
+
+/**
+ * @brief Free the query indexes of a history core
+ * @param core History core
+ */
+void lle_history_query_index_reset(lle_history_core_t *core) {
+    if (!core) {
+        return;
+    }
+    index_destroy(core->query_index);
+    core->query_index = NULL;
+}
+
+/**
+ * @brief Record the outcome of an executed command
+ *
+ * Finds the newest active entry for the command among the last few entries
+ * (dedup may have moved or merged it), updates its exit status and
+ * duration and marks its outcome known. If the entry is already indexed,
+ * its exit and duration postings are added, or moved to the new buckets
+ * if an outcome was recorded before.
+ *
+ * @param core History core
+ * @param command Command that ran
+ * @param exit_code Exit status
+ * @param duration_ms Wall-clock duration in milliseconds
+ * @return LLE_SUCCESS, LLE_ERROR_NOT_FOUND if no recent entry matches, or
+ *         another error code
+ */
+lle_result_t lle_history_record_result(lle_history_core_t *core,
+                                       const char *command, int exit_code,
+                                       uint32_t duration_ms) {
+    if (!core || !command) {
+        return LLE_ERROR_INVALID_PARAMETER;
+    }
+    if (!core->initialized) {
+        return LLE_ERROR_NOT_INITIALIZED;
+    }
+
+    /* The executed line may still carry its newline */
+    size_t len = strlen(command);
+    while (len > 0 && (command[len - 1] == '\n' || command[len - 1] == '\r')) {
+        len--;
+    }
+    if (len == 0) {
+        return LLE_ERROR_NOT_FOUND;
+    }
+
+    pthread_rwlock_wrlock(&core->lock);
+
+    size_t stop =
+        core->entry_count > RECORD_LOOKBACK ? core->entry_count - RECORD_LOOKBACK
+                                            : 0;
+    for (size_t i = core->entry_count; i > stop; i--) {
+        lle_history_entry_t *entry = core->entries[i - 1];
+        if (!entry || !entry->command ||
+            entry->state == LLE_HISTORY_STATE_DELETED ||
+            entry->command_length != len ||
+            memcmp(entry->command, command, len) != 0) {
+            continue;
+        }
+
+        lle_history_query_index_t *idx = core->query_index;
+        if (idx && i - 1 < idx->indexed) {
+            uint32_t pos = (uint32_t)(i - 1);
+            if (entry->outcome_known) {
+                posting_remove(&idx->exits[exit_bucket(entry->exit_code)],
+                               pos);
+                if (entry->exit_code != 0) {
+                    posting_remove(&idx->failed, pos);
+                }
+                posting_remove(
+                    &idx->durations[duration_bucket(entry->duration_ms)], pos);
+            }
+            if (!index_add_outcome(idx, pos, exit_code, duration_ms, false)) {
+                lle_history_query_index_reset(core);
+            }
+        }
+
+        entry->exit_code = exit_code;
+        entry->duration_ms = duration_ms;
+        entry->outcome_known = true;
+
+        pthread_rwlock_unlock(&core->lock);
+        return LLE_SUCCESS;
+    }
+
+    pthread_rwlock_unlock(&core->lock);
+    return LLE_ERROR_NOT_FOUND;
+}
+
+/* ============================================================================
+ * QUERY MATCHING
+ * ============================================================================
+ */
+
+/**
+ * @brief Case-insensitive substring test
+ */
+static bool contains_ignore_case(const char *haystack, const char *needle) {
+    if (!*needle) {
+        return true;
+    }
+    for (const char *h = haystack; *h; h++) {
+        const char *a = h;
+        const char *b = needle;
+        while (*a && *b &&
+               tolower((unsigned char)*a) == tolower((unsigned char)*b)) {
+            a++;
+            b++;
+        }
+        if (!*b) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Check whether path is dir or (for subtree) lies below it
+ */
+static bool directory_matches(const char *dir, bool subtree,
+                              const char *path) {
+    if (!path) {
+        return false;
+    }
+    if (!subtree) {
+        return strcmp(dir, path) == 0;
+    }
+    size_t len = strlen(dir);
+    if (len == 1 && dir[0] == '/') {
+        return path[0] == '/';
+    }
+    return strncmp(dir, path, len) == 0 &&
+           (path[len] == '\0' || path[len] == '/');
+}
+
+/**
+ * @brief Initialize a query that matches every entry
+ * @param query Query to initialize
+ */
+void lle_history_query_init(lle_history_query_t *query) {
+    if (!query) {
+        return;
+    }
+    memset(query, 0, sizeof(*query));
+    query->exit_filter = LLE_HISTORY_QUERY_EXIT_ANY;
+    query->max_duration_ms = UINT32_MAX;
+}
+
+/**
+ * @brief Check whether a query has any filter besides text
+ * @param query Query
+ * @return true if any structured filter is set
+ */
+bool lle_history_query_has_filters(const lle_history_query_t *query) {
+    if (!query) {
+        return false;
+    }
+    return query->directory[0] != '\0' ||
+           query->exit_filter != LLE_HISTORY_QUERY_EXIT_ANY ||
+           query->min_duration_ms > 0 ||
+           query->max_duration_ms != UINT32_MAX || query->since != 0 ||
+           query->until != 0 || query->session_set;
+}
+
+/**
+ * @brief Check whether an entry matches a query
+ * @param query Query
+ * @param entry History entry
+ * @return true if the entry matches every filter
+ */
+bool lle_history_query_matches(const lle_history_query_t *query,
+                               const lle_history_entry_t *entry) {
+    if (!query || !entry || !entry->command ||
+        entry->state == LLE_HISTORY_STATE_DELETED) {
+        return false;
+    }
+
+    /* A command that is still running, or was loaded without an outcome,
+     * has neither an exit status nor a duration to match */
+    bool outcome_filter = query->exit_filter != LLE_HISTORY_QUERY_EXIT_ANY ||
+                          query->min_duration_ms > 0 ||
+                          query->max_duration_ms != UINT32_MAX;
+    if (outcome_filter && !entry->outcome_known) {
+        return false;
+    }
+
+    switch (query->exit_filter) {
+    case LLE_HISTORY_QUERY_EXIT_ANY:
+        break;
+    case LLE_HISTORY_QUERY_EXIT_SUCCESS:
+        if (entry->exit_code != 0) {
+            return false;
+        }
+        break;
+    case LLE_HISTORY_QUERY_EXIT_FAILED:
+        if (entry->exit_code == 0) {
+            return false;
+        }
+        break;
+    case LLE_HISTORY_QUERY_EXIT_CODE:
+        if (entry->exit_code != query->exit_code) {
+            return false;
+        }
+        break;
+    }
+
+    if (entry->duration_ms < query->min_duration_ms ||
+        entry->duration_ms > query->max_duration_ms) {
+        return false;
+    }
+    if (query->since && entry->timestamp < query->since) {
+        return false;
+    }
+    if (query->until && entry->timestamp > query->until) {
+        return false;
+    }
+    if (query->session_set && entry->session_id != query->session_id) {
+        return false;
+    }
+    if (query->directory[0] &&
+        !directory_matches(query->directory, query->subtree,
+                           entry->working_directory)) {
+        return false;
+    }
+
+    return contains_ignore_case(entry->command, query->text);
+}
+
+/* ============================================================================
+ * QUERY PARSING
+ * ============================================================================
+ */
+
+/**
+ * @brief Format a parse error
+ */
+static lle_result_t parse_error(char *error, size_t error_size,
+                                const char *what, const char *value) {
+    if (error && error_size > 0) {
+        snprintf(error, error_size, "invalid %s '%s'", what, value);
+    }
+    return LLE_ERROR_INVALID_PARAMETER;
+}
+
+/**
+ * @brief Parse a duration such as 10s, 500ms, 2m or 1h (default seconds)
+ */
+static bool parse_duration(const char *value, uint32_t *ms) {
+    char *end = NULL;
+    double amount = strtod(value, &end);
+    if (end == value || amount < 0) {
+        return false;
+    }
+
+    double scale;
+    if (*end == '\0' || strcmp(end, "s") == 0) {
+        scale = 1000.0;
+    } else if (strcmp(end, "ms") == 0) {
+        scale = 1.0;
+    } else if (strcmp(end, "m") == 0) {
+        scale = 60000.0;
+    } else if (strcmp(end, "h") == 0) {
+        scale = 3600000.0;
+    } else {
+        return false;
+    }
+
+    double total = amount * scale;
+    *ms = total >= (double)UINT32_MAX ? UINT32_MAX : (uint32_t)total;
+    return true;
+}
+
+/**
+ * @brief Parse a duration bound: >N, >=N, <N, <=N or N (at least N)
+ */
+static bool parse_duration_filter(const char *value,
+                                  lle_history_query_t *query) {
+    bool greater = true;
+    bool inclusive = true;
+    if (value[0] == '>' || value[0] == '<') {
+        greater = value[0] == '>';
+        value++;
+        if (value[0] == '=') {
+            value++;
+        } else {
+            inclusive = false;
+        }
+    }
+
+    uint32_t ms = 0;
+    if (!parse_duration(value, &ms)) {
+        return false;
+    }
+
+    if (greater) {
+        if (!inclusive) {
+            ms = ms == UINT32_MAX ? UINT32_MAX : ms + 1;
+        }
+        query->min_duration_ms = ms;
+    } else {
+        if (!inclusive) {
+            if (ms == 0) {
+                return false;
+            }
+            ms--;
+        }
+        query->max_duration_ms = ms;
+    }
+    return true;
+}
+
+/**
+ * @brief Parse a point in time: 30m, 2h, 7d, 1w ago, today or YYYY-MM-DD
+ */
+static bool parse_time(const char *value, time_t now, uint64_t *timestamp) {
+    struct tm tm;
+
+    if (strcmp(value, "today") == 0 || strcmp(value, "yesterday") == 0) {
+        localtime_r(&now, &tm);
+        tm.tm_hour = tm.tm_min = tm.tm_sec = 0;
+        if (value[0] == 'y') {
+            tm.tm_mday--;
+        }
+        tm.tm_isdst = -1;
+        time_t t = mktime(&tm);
+        if (t == (time_t)-1) {
+            return false;
+        }
+        *timestamp = (uint64_t)t;
+        return true;
+    }
+
+    int year, month, day;
+    char extra;
+    if (sscanf(value, "%4d-%2d-%2d%c", &year, &month, &day, &extra) == 3) {
+        memset(&tm, 0, sizeof(tm));
+        tm.tm_year = year - 1900;
+        tm.tm_mon = month - 1;
+        tm.tm_mday = day;
+        tm.tm_isdst = -1;
+        time_t t = mktime(&tm);
+        if (month < 1 || month > 12 || day < 1 || day > 31 ||
+            t == (time_t)-1) {
+            return false;
+        }
+        *timestamp = (uint64_t)t;
+        return true;
+    }
+
+    char *end = NULL;
+    long amount = strtol(value, &end, 10);
+    if (end == value || amount < 0) {
+        return false;
+    }
+    long unit;
+    if (strcmp(end, "s") == 0) {
+        unit = 1;
+    } else if (strcmp(end, "m") == 0) {
+        unit = 60;
+    } else if (strcmp(end, "h") == 0) {
+        unit = 3600;
+    } else if (strcmp(end, "d") == 0) {
+        unit = 86400;
+    } else if (strcmp(end, "w") == 0) {
+        unit = 7 * 86400;
+    } else {
+        return false;
+    }
+    long long offset = (long long)amount * unit;
+    *timestamp = offset >= (long long)now ? 1 : (uint64_t)(now - offset);
+    return true;
+}
+
+/**
+ * @brief Resolve a directory argument to an absolute path without a
+ *        trailing slash
+ */
+static bool resolve_directory(const char *value, char *out, size_t size) {
+    char path[LLE_HISTORY_MAX_PATH_LENGTH];
+
+    if (strcmp(value, ".") == 0) {
+        if (lle_history_get_cwd(path, sizeof(path)) != LLE_SUCCESS) {
+            return false;
+        }
+    } else if (value[0] == '~' && (value[1] == '\0' || value[1] == '/')) {
+        const char *home = getenv("HOME");
+        if (!home || !*home) {
+            return false;
+        }
+        if ((size_t)snprintf(path, sizeof(path), "%s%s", home, value + 1) >=
+            sizeof(path)) {
+            return false;
+        }
+    } else if (value[0] == '/') {
+        if (strlen(value) >= sizeof(path)) {
+            return false;
+        }
+        strcpy(path, value);
+    } else {
+        char cwd[LLE_HISTORY_MAX_PATH_LENGTH];
+        if (lle_history_get_cwd(cwd, sizeof(cwd)) != LLE_SUCCESS ||
+            (size_t)snprintf(path, sizeof(path), "%s/%s", cwd, value) >=
+                sizeof(path)) {
+            return false;
+        }
+    }
+
+    size_t len = strlen(path);
+    while (len > 1 && path[len - 1] == '/') {
+        path[--len] = '\0';
+    }
+    if (len >= size) {
+        return false;
+    }
+    memcpy(out, path, len + 1);
+    return true;
+}
+
+/**
+ * @brief Apply one key:value filter word
+ *
+ * @return LLE_SUCCESS, LLE_ERROR_INVALID_PARAMETER for a bad value, or
+ *         LLE_ERROR_NOT_FOUND if the key is not a filter
+ */
+static lle_result_t apply_filter(const char *key, size_t key_len,
+                                 const char *value, time_t now,
+                                 lle_history_query_t *query, char *error,
+                                 size_t error_size) {
+#define KEY_IS(name) (key_len == sizeof(name) - 1 && memcmp(key, name, key_len) == 0)
+
+    if (KEY_IS("dir") || KEY_IS("under")) {
+        if (!*value || !resolve_directory(value, query->directory,
+                                          sizeof(query->directory))) {
+            return parse_error(error, error_size, "directory", value);
+        }
+        query->subtree = KEY_IS("under");
+        return LLE_SUCCESS;
+    }
+
+    if (KEY_IS("exit")) {
+        if (strcmp(value, "ok") == 0 || strcmp(value, "success") == 0) {
+            query->exit_filter = LLE_HISTORY_QUERY_EXIT_SUCCESS;
+        } else if (strcmp(value, "fail") == 0 ||
+                   strcmp(value, "failed") == 0 ||
+                   strcmp(value, "!0") == 0) {
+            query->exit_filter = LLE_HISTORY_QUERY_EXIT_FAILED;
+        } else {
+            char *end = NULL;
+            long code = strtol(value, &end, 10);
+            if (end == value || *end != '\0' || code < -1 || code > 255) {
+                return parse_error(error, error_size, "exit status", value);
+            }
+            query->exit_filter = LLE_HISTORY_QUERY_EXIT_CODE;
+            query->exit_code = (int)code;
+        }
+        return LLE_SUCCESS;
+    }
+
+    if (KEY_IS("dur") || KEY_IS("duration")) {
+        if (!parse_duration_filter(value, query)) {
+            return parse_error(error, error_size, "duration", value);
+        }
+        return LLE_SUCCESS;
+    }
+
+    if (KEY_IS("since") || KEY_IS("until")) {
+        uint64_t timestamp = 0;
+        if (!parse_time(value, now, &timestamp)) {
+            return parse_error(error, error_size, "time", value);
+        }
+        if (KEY_IS("since")) {
+            query->since = timestamp;
+        } else {
+            query->until = timestamp;
+        }
+        return LLE_SUCCESS;
+    }
+
+    if (KEY_IS("session")) {
+        if (strcmp(value, "current") == 0 || strcmp(value, ".") == 0) {
+            query->session_id = getsid(0);
+        } else {
+            char *end = NULL;
+            long id = strtol(value, &end, 10);
+            if (end == value || *end != '\0' || id <= 0) {
+                return parse_error(error, error_size, "session", value);
+            }
+            query->session_id = (pid_t)id;
+        }
+        query->session_set = true;
+        return LLE_SUCCESS;
+    }
+
+#undef KEY_IS
+    return LLE_ERROR_NOT_FOUND;
+}
+
+/**
+ * @brief Parse a query string
+ * @param input Query string
+ * @param query Output query
+ * @param error Buffer for an error message (may be NULL)
+ * @param error_size Size of error buffer
+ * @return LLE_SUCCESS or LLE_ERROR_INVALID_PARAMETER on a malformed filter
+ */
+lle_result_t lle_history_query_parse(const char *input,
+                                     lle_history_query_t *query, char *error,
+                                     size_t error_size) {
+    if (!input || !query) {
+        return LLE_ERROR_INVALID_PARAMETER;
+    }
+
+    lle_history_query_init(query);
+    if (error && error_size > 0) {
+        error[0] = '\0';
+    }
+
+    time_t now = time(NULL);
+    size_t text_len = 0;
+    const char *p = input;
+
+    while (*p) {
+        while (*p && isspace((unsigned char)*p)) {
+            p++;
+        }
+        if (!*p) {
+            break;
+        }
+
+        const char *start = p;
+        while (*p && !isspace((unsigned char)*p)) {
+            p++;
+        }
+        size_t word_len = (size_t)(p - start);
+
+        char word[LLE_HISTORY_MAX_PATH_LENGTH + 16];
+        if (word_len >= sizeof(word)) {
+            word_len = sizeof(word) - 1;
+        }
+        memcpy(word, start, word_len);
+        word[word_len] = '\0';
+
+        const char *colon = strchr(word, ':');
+        if (colon && colon > word) {
+            lle_result_t result =
+                apply_filter(word, (size_t)(colon - word), colon + 1, now,
+                             query, error, error_size);
+            if (result == LLE_SUCCESS) {
+                continue;
+            }
+            if (result != LLE_ERROR_NOT_FOUND) {
+                return result;
+            }
+        }
+
+        /* Plain text word */
+        size_t need = word_len + (text_len ? 1 : 0);
+        if (text_len + need >= sizeof(query->text)) {
+            return parse_error(error, error_size, "query", "text too long");
+        }
+        if (text_len) {
+            query->text[text_len++] = ' ';
+        }
+        memcpy(query->text + text_len, word, word_len);
+        text_len += word_len;
+        query->text[text_len] = '\0';
+    }
+
+    return LLE_SUCCESS;
+}
+
+/* ============================================================================
+ * QUERY EXECUTION
+ * ============================================================================
+ */
+
+/**
+ * @brief Use a set of posting lists as the candidate source if it is the
+ *        smallest so far
+ */
+static void consider_lists(candidate_source_t *best,
+                           const posting_list_t **lists, size_t count) {
+    if (count > MAX_UNION_LISTS) {
+        return;
+    }
+    size_t estimate = 0;
+    for (size_t i = 0; i < count; i++) {
+        estimate += lists[i]->count;
+    }
+    if (estimate >= best->estimate) {
+        return;
+    }
+    best->use_lists = true;
+    best->list_count = count;
+    best->estimate = estimate;
+    for (size_t i = 0; i < count; i++) {
+        best->lists[i] = lists[i];
+        best->cursors[i] = lists[i]->count;
+    }
+}
+
+/**
+ * @brief First position whose timestamp is at least timestamp
+ *
+ * Requires idx->time_sorted.
+ */
+static size_t lower_bound_time(lle_history_core_t *core, size_t count,
+                               uint64_t timestamp) {
+    size_t lo = 0;
+    size_t hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        lle_history_entry_t *entry = core->entries[mid];
+        if (entry && entry->timestamp < timestamp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Choose the smallest candidate source for a query
+ *
+ * Falls back to the position range [*range_lo, *range_hi), which is
+ * narrowed by the time filters when timestamps are ordered.
+ */
+static void choose_source(lle_history_core_t *core,
+                          const lle_history_query_t *query,
+                          candidate_source_t *best, size_t *range_lo,
+                          size_t *range_hi) {
+    lle_history_query_index_t *idx = core->query_index;
+    const posting_list_t *lists[MAX_UNION_LISTS];
+    static const posting_list_t empty_list = {NULL, 0, 0};
+
+    *range_lo = 0;
+    *range_hi = idx->indexed;
+    if (idx->time_sorted) {
+        if (query->since) {
+            *range_lo = lower_bound_time(core, idx->indexed, query->since);
+        }
+        if (query->until) {
+            *range_hi = lower_bound_time(core, idx->indexed, query->until + 1);
+        }
+        if (*range_hi < *range_lo) {
+            *range_hi = *range_lo;
+        }
+    }
+
+    memset(best, 0, sizeof(*best));
+    best->estimate = *range_hi - *range_lo;
+
+    if (query->directory[0]) {
+        if (!query->subtree) {
+            dir_postings_t *dir = dir_find(idx, query->directory);
+            lists[0] = dir ? &dir->list : &empty_list;
+            consider_lists(best, lists, 1);
+        } else {
+            size_t n = 0;
+            for (size_t i = 0; i < idx->dir_count && n <= MAX_UNION_LISTS;
+                 i++) {
+                if (directory_matches(query->directory, true,
+                                      idx->dirs[i].path)) {
+                    if (n < MAX_UNION_LISTS) {
+                        lists[n] = &idx->dirs[i].list;
+                    }
+                    n++;
+                }
+            }
+            consider_lists(best, lists, n);
+        }
+    }
+
+    switch (query->exit_filter) {
+    case LLE_HISTORY_QUERY_EXIT_ANY:
+        break;
+    case LLE_HISTORY_QUERY_EXIT_SUCCESS:
+        lists[0] = &idx->exits[0];
+        consider_lists(best, lists, 1);
+        break;
+    case LLE_HISTORY_QUERY_EXIT_FAILED:
+        lists[0] = &idx->failed;
+        consider_lists(best, lists, 1);
+        break;
+    case LLE_HISTORY_QUERY_EXIT_CODE:
+        lists[0] = &idx->exits[exit_bucket(query->exit_code)];
+        consider_lists(best, lists, 1);
+        break;
+    }
+
+    if (query->min_duration_ms > 0 || query->max_duration_ms != UINT32_MAX) {
+        size_t n = 0;
+        for (size_t b = 0; b < DURATION_BUCKETS; b++) {
+            if (duration_bucket_max(b) >= query->min_duration_ms &&
+                duration_bucket_min(b) <= query->max_duration_ms) {
+                lists[n++] = &idx->durations[b];
+            }
+        }
+        consider_lists(best, lists, n);
+    }
+
+    if (query->session_set) {
+        session_postings_t *session = session_find(idx, query->session_id);
+        lists[0] = session ? &session->list : &empty_list;
+        consider_lists(best, lists, 1);
+    }
+}
+
+/**
+ * @brief Next candidate position, newest first
+ *
+ * @return true and the position, or false when the source is exhausted
+ */
+static bool next_candidate(candidate_source_t *source, size_t range_lo,
+                           size_t *range_cursor, size_t *pos) {
+    if (!source->use_lists) {
+        if (*range_cursor <= range_lo) {
+            return false;
+        }
+        *pos = --(*range_cursor);
+        return true;
+    }
+
+    /* Largest head among the lists; the lists are disjoint except for a
+     * shared position, which is skipped */
+    bool found = false;
+    uint32_t max = 0;
+    for (size_t i = 0; i < source->list_count; i++) {
+        uint32_t c = source->cursors[i];
+        if (c > 0 && (!found || source->lists[i]->items[c - 1] > max)) {
+            max = source->lists[i]->items[c - 1];
+            found = true;
+        }
+    }
+    if (!found) {
+        return false;
+    }
+    for (size_t i = 0; i < source->list_count; i++) {
+        uint32_t c = source->cursors[i];
+        if (c > 0 && source->lists[i]->items[c - 1] == max) {
+            source->cursors[i]--;
+        }
+    }
+    *pos = max;
+    return true;
+}
+
+/**
+ * @brief Run a query against the history
+ * @param core History core
+ * @param query Query
+ * @param max_results Maximum matches to return
+ * @param positions Output array of entry indexes, most recent first
+ * @param count Output number of matches
+ * @return LLE_SUCCESS or error code
+ */
+lle_result_t lle_history_query_run(lle_history_core_t *core,
+                                   const lle_history_query_t *query,
+                                   size_t max_results, size_t *positions,
+                                   size_t *count) {
+    if (!core || !query || !count || (max_results > 0 && !positions)) {
+        return LLE_ERROR_INVALID_PARAMETER;
+    }
+    *count = 0;
+    if (!core->initialized) {
+        return LLE_ERROR_NOT_INITIALIZED;
+    }
+    if (max_results == 0) {
+        return LLE_SUCCESS;
+    }
+
+    /* The write lock covers the lazy index catch-up */
+    pthread_rwlock_wrlock(&core->lock);
+
+    lle_result_t result = index_catch_up(core);
+    if (result != LLE_SUCCESS) {
+        pthread_rwlock_unlock(&core->lock);
+        return result;
+    }
+
+    candidate_source_t source;
+    size_t range_lo = 0;
+    size_t range_hi = 0;
+    choose_source(core, query, &source, &range_lo, &range_hi);
+
+    size_t cursor = range_hi;
+    size_t pos = 0;
+    while (*count < max_results &&
+           next_candidate(&source, range_lo, &cursor, &pos)) {
+        if (pos >= range_hi) {
+            continue;
+        }
+        if (pos < range_lo) {
+            break; /* Everything further is older than the range */
+        }
+        lle_history_entry_t *entry = core->entries[pos];
+        if (entry && lle_history_query_matches(query, entry)) {
+            positions[(*count)++] = pos;
+        }
+    }
+
+    core->stats.search_count++;
+    pthread_rwlock_unlock(&core->lock);
+    return LLE_SUCCESS;
+}
@@ -719,6 +719,88 @@ lle_history_search_fuzzy(lle_history_core_t *history_core, const char *query,
     return results;
 }
 
+/**
+ * @brief Search history with a structured query
+ *
+ * Parses the query string (text plus dir:/exit:/dur:/since:/until:/session:
+ * filters) and runs it through the secondary indexes. Results are most
+ * recent first; scores decrease with age so sorting keeps that order.
+ *
+ * @param history_core History core engine (must not be NULL)
+ * @param query_string Query string (must not be NULL)
+ * @param max_results Maximum results to return (0 = default of 100)
+ * @return Search results container, or NULL on failure or invalid query
+ */
+lle_history_search_results_t *
+lle_history_search_query(lle_history_core_t *history_core,
+                         const char *query_string, size_t max_results) {
+    if (!history_core || !query_string) {
+        return NULL;
+    }
+
+    struct timespec start_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    lle_history_query_t query;
+    if (lle_history_query_parse(query_string, &query, NULL, 0) !=
+        LLE_SUCCESS) {
+        return NULL;
+    }
+
+    lle_history_search_results_t *results =
+        lle_history_search_results_create(max_results);
+    if (!results) {
+        return NULL;
+    }
+
+    results->query = pool_strdup(query_string);
+    results->search_type = LLE_SEARCH_TYPE_SUBSTRING;
+
+    size_t *positions = lle_pool_alloc(sizeof(size_t) * results->capacity);
+    if (!positions) {
+        lle_history_search_results_destroy(results);
+        return NULL;
+    }
+
+    size_t found = 0;
+    if (lle_history_query_run(history_core, &query, results->capacity,
+                              positions, &found) != LLE_SUCCESS) {
+        lle_pool_free(positions);
+        lle_history_search_results_destroy(results);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < found; i++) {
+        lle_history_entry_t *entry = NULL;
+        if (lle_history_get_entry_by_index(history_core, positions[i],
+                                           &entry) != LLE_SUCCESS ||
+            !entry || !entry->command) {
+            continue;
+        }
+
+        const char *match_pos = stristr(entry->command, query.text);
+        size_t position =
+            match_pos ? (size_t)(match_pos - entry->command) : 0;
+
+        add_search_result(results, entry->entry_id, positions[i],
+                          entry->command, entry->timestamp,
+                          (int)(found - i), position,
+                          LLE_SEARCH_TYPE_SUBSTRING);
+    }
+    results->sorted = true;
+
+    lle_pool_free(positions);
+
+    /* Record search time */
+    struct timespec end_time;
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    results->search_time_us =
+        (uint64_t)((end_time.tv_sec - start_time.tv_sec) * 1000000 +
+                   (end_time.tv_nsec - start_time.tv_nsec) / 1000);
+
+    return results;
+}
+
 /* ============================================================================
  * PUBLIC API - SEARCH UTILITIES
  * ============================================================================
@@ -191,7 +191,10 @@ static lle_result_t lle_unescape_string(const char *str, char *output,
 /**
  * @brief Format history entry as TSV line
  *
- * Format: TIMESTAMP\\tCOMMAND\\tEXIT_CODE\\tWORKING_DIR\\n
+ * Format: TIMESTAMP\\tCOMMAND\\tEXIT_CODE\\tWORKING_DIR[\\tDURATION_MS]\\n
+ *
+ * The duration field is only written once the command's outcome has been
+ * recorded; entries without it have an unknown exit status and duration.
  *
  * @param entry History entry to format
  * @param line Output buffer for formatted line
@@ -225,9 +228,17 @@ static lle_result_t lle_history_format_entry(const lle_history_entry_t *entry,
     lle_escape_string(wd, escaped_wd, LLE_HISTORY_MAX_PATH_LENGTH * 2);
 
     /* Format line */
-    int written = snprintf(line, line_size, "%lu\t%s\t%d\t%s\n",
+    int written;
+    if (entry->outcome_known) {
+        written = snprintf(line, line_size, "%lu\t%s\t%d\t%s\t%lu\n",
+                           (unsigned long)entry->timestamp, escaped_cmd,
+                           entry->exit_code, escaped_wd,
+                           (unsigned long)entry->duration_ms);
+    } else {
+        written = snprintf(line, line_size, "%lu\t%s\t%d\t%s\n",
                            (unsigned long)entry->timestamp, escaped_cmd,
                            entry->exit_code, escaped_wd);
+    }
 
     lle_pool_free(escaped_cmd);
     lle_pool_free(escaped_wd);
@@ -268,10 +279,10 @@ static lle_result_t lle_history_parse_line(const char *line,
     char cmd_buffer[LLE_HISTORY_MAX_COMMAND_LENGTH * 2];
     int exit_code = 0;
     char wd_buffer[LLE_HISTORY_MAX_PATH_LENGTH * 2];
+    unsigned long duration_ms = 0;
 
-    int parsed =
-        sscanf(line, "%lu\t%[^\t]\t%d\t%[^\n]", (unsigned long *)&timestamp,
-               cmd_buffer, &exit_code, wd_buffer);
+    int parsed = sscanf(line, "%lu\t%[^\t]\t%d", (unsigned long *)&timestamp,
+                        cmd_buffer, &exit_code);
 
     if (parsed < 2) {
         /* Malformed line - skip it */
@@ -293,8 +304,34 @@ static lle_result_t lle_history_parse_line(const char *line,
     (*entry)->timestamp = timestamp;
     (*entry)->exit_code = exit_code;
 
+    /* Working directory and duration follow the third tab. They are split
+     * by hand: a tab directive in sscanf skips any run of whitespace, which
+     * would misread an empty directory. */
+    wd_buffer[0] = '\0';
+    const char *field = line;
+    for (int tabs = 0; tabs < 3 && field; tabs++) {
+        field = strchr(field, '\t');
+        if (field) {
+            field++;
+        }
+    }
+    if (parsed >= 3 && field) {
+        size_t wd_len = strcspn(field, "\t\r\n");
+        if (wd_len >= sizeof(wd_buffer)) {
+            wd_len = sizeof(wd_buffer) - 1;
+        }
+        memcpy(wd_buffer, field, wd_len);
+        wd_buffer[wd_len] = '\0';
+        if (field[wd_len] == '\t') {
+            duration_ms = strtoul(field + wd_len + 1, NULL, 10);
+            (*entry)->outcome_known = true;
+        }
+    }
+    (*entry)->duration_ms =
+        duration_ms > UINT32_MAX ? UINT32_MAX : (uint32_t)duration_ms;
+
     /* Set working directory if present */
-    if (parsed >= 4 && wd_buffer[0] != '\0') {
+    if (wd_buffer[0] != '\0') {
         char unescaped_wd[LLE_HISTORY_MAX_PATH_LENGTH];
         lle_unescape_string(wd_buffer, unescaped_wd, sizeof(unescaped_wd));
 
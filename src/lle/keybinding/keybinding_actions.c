@@ -1289,6 +1289,46 @@ lle_result_t lle_backward_delete_char(lle_editor_t *editor) {
     return LLE_SUCCESS;
 }
 
+/**
+ * @brief Save a range of the buffer to the kill ring and delete it
+ *
+ * The text is copied straight from the buffer into the ring. If nothing
+ * has changed the buffer or moved the cursor since the previous kill, the
+ * text extends that kill's entry (prepended for backward kills) so a run
+ * of kills yanks back as one piece, as in GNU Readline.
+ *
+ * @param editor Editor instance
+ * @param start Byte offset of the text to kill
+ * @param length Byte length of the text to kill
+ * @param backward true if the text lies before the cursor
+ * @return Result of deleting the text
+ */
+static lle_result_t kill_text(lle_editor_t *editor, size_t start,
+                              size_t length, bool backward) {
+    lle_buffer_t *buffer = editor->buffer;
+
+    if (editor->kill_ring) {
+        bool chained =
+            editor->kill_chain_valid &&
+            editor->kill_modification_count == buffer->modification_count &&
+            editor->kill_cursor == buffer->cursor.byte_offset;
+
+        if (chained && backward) {
+            lle_kill_ring_prepend_text(editor->kill_ring, buffer->data + start,
+                                       length);
+        } else {
+            lle_kill_ring_add_text(editor->kill_ring, buffer->data + start,
+                                   length, chained);
+        }
+    }
+
+    lle_result_t result = lle_buffer_delete_text(buffer, start, length);
+    editor->kill_chain_valid = (result == LLE_SUCCESS);
+    editor->kill_modification_count = buffer->modification_count;
+    editor->kill_cursor = start;
+    return result;
+}
+
 /**
  * @brief Kill text from cursor to end of line (C-k)
  * @param editor Editor instance
@@ -1314,19 +1354,7 @@ lle_result_t lle_kill_line(lle_editor_t *editor) {
 
     if (cursor_pos < kill_end) {
         size_t kill_len = kill_end - cursor_pos;
-        char *killed_text =
-            strndup(editor->buffer->data + cursor_pos, kill_len);
-
-        if (killed_text) {
-            /* Add to kill ring */
-            if (editor->kill_ring) {
-                lle_kill_ring_add(editor->kill_ring, killed_text, false);
-            }
-            free(killed_text);
-        }
-
-        /* Delete the text */
-        return lle_buffer_delete_text(editor->buffer, cursor_pos, kill_len);
+        return kill_text(editor, cursor_pos, kill_len, false);
     }
 
     return LLE_SUCCESS;
@@ -1357,20 +1385,7 @@ lle_result_t lle_backward_kill_line(lle_editor_t *editor) {
 
     if (cursor_pos > kill_start) {
         size_t kill_len = cursor_pos - kill_start;
-        char *killed_text =
-            strndup(editor->buffer->data + kill_start, kill_len);
-
-        if (killed_text) {
-            /* Add to kill ring */
-            if (editor->kill_ring) {
-                lle_kill_ring_add(editor->kill_ring, killed_text, false);
-            }
-            free(killed_text);
-        }
-
-        /* Delete the text */
-        lle_result_t result =
-            lle_buffer_delete_text(editor->buffer, kill_start, kill_len);
+        lle_result_t result = kill_text(editor, kill_start, kill_len, true);
         if (result == LLE_SUCCESS) {
             editor->buffer->cursor.byte_offset = kill_start;
             editor->buffer->cursor.codepoint_index = kill_start;
@@ -1404,19 +1419,7 @@ lle_result_t lle_kill_word(lle_editor_t *editor) {
 
     if (word_end > cursor_pos) {
         size_t kill_len = word_end - cursor_pos;
-        char *killed_text =
-            strndup(editor->buffer->data + cursor_pos, kill_len);
-
-        if (killed_text) {
-            /* Add to kill ring */
-            if (editor->kill_ring) {
-                lle_kill_ring_add(editor->kill_ring, killed_text, false);
-            }
-            free(killed_text);
-        }
-
-        /* Delete the text */
-        return lle_buffer_delete_text(editor->buffer, cursor_pos, kill_len);
+        return kill_text(editor, cursor_pos, kill_len, false);
     }
 
     return LLE_SUCCESS;
@@ -1437,20 +1440,7 @@ lle_result_t lle_backward_kill_word(lle_editor_t *editor) {
 
     if (cursor_pos > word_start) {
         size_t kill_len = cursor_pos - word_start;
-        char *killed_text =
-            strndup(editor->buffer->data + word_start, kill_len);
-
-        if (killed_text) {
-            /* Add to kill ring */
-            if (editor->kill_ring) {
-                lle_kill_ring_add(editor->kill_ring, killed_text, false);
-            }
-            free(killed_text);
-        }
-
-        /* Delete the text */
-        lle_result_t result =
-            lle_buffer_delete_text(editor->buffer, word_start, kill_len);
+        lle_result_t result = kill_text(editor, word_start, kill_len, true);
         if (result == LLE_SUCCESS) {
             editor->buffer->cursor.byte_offset = word_start;
             editor->buffer->cursor.codepoint_index = word_start;
@@ -1484,17 +1474,18 @@ lle_result_t lle_yank(lle_editor_t *editor) {
     }
 
     const char *yank_text = NULL;
-    lle_result_t result =
-        lle_kill_ring_get_current(editor->kill_ring, &yank_text);
+    size_t yank_length = 0;
+    lle_result_t result = lle_kill_ring_get_current_text(
+        editor->kill_ring, &yank_text, &yank_length);
 
     if (result != LLE_SUCCESS || !yank_text) {
         return LLE_SUCCESS; /* Nothing to yank */
     }
 
-    size_t yank_length = strlen(yank_text);
-    result = lle_buffer_insert_text(editor->buffer,
-                                    editor->buffer->cursor.byte_offset,
-                                    yank_text, yank_length);
+    /* Insert straight from the ring's storage */
+    size_t yank_start = editor->buffer->cursor.byte_offset;
+    result = lle_buffer_insert_text(editor->buffer, yank_start, yank_text,
+                                    yank_length);
 
     /* CRITICAL: Sync cursor_manager after insertion moves cursor */
     if (result == LLE_SUCCESS && editor->cursor_manager) {
@@ -1502,6 +1493,12 @@ lle_result_t lle_yank(lle_editor_t *editor) {
             editor->cursor_manager, editor->buffer->cursor.byte_offset);
     }
 
+    /* Remember the span so yank-pop can replace it */
+    editor->yank_valid = (result == LLE_SUCCESS);
+    editor->yank_start = yank_start;
+    editor->yank_length = yank_length;
+    editor->yank_modification_count = editor->buffer->modification_count;
+
     return result;
 }
 
@@ -1515,19 +1512,43 @@ lle_result_t lle_yank_pop(lle_editor_t *editor) {
         return LLE_ERROR_INVALID_PARAMETER;
     }
 
+    /* Only valid while the last yank's text is still in place with the
+     * cursor after it */
+    lle_buffer_t *buffer = editor->buffer;
+    size_t yank_end = editor->yank_start + editor->yank_length;
+    if (!editor->yank_valid ||
+        editor->yank_modification_count != buffer->modification_count ||
+        buffer->cursor.byte_offset != yank_end) {
+        return LLE_SUCCESS;
+    }
+
     /* Get next entry from kill ring (includes state check) */
     const char *yank_text = NULL;
-    lle_result_t result = lle_kill_ring_yank_pop(editor->kill_ring, &yank_text);
+    size_t yank_length = 0;
+    lle_result_t result = lle_kill_ring_yank_pop_text(
+        editor->kill_ring, &yank_text, &yank_length);
 
     if (result != LLE_SUCCESS || !yank_text) {
         return LLE_SUCCESS; /* Ignore if error or no text */
     }
 
-    /* Delete previously yanked text and insert new text */
-    size_t yank_length = strlen(yank_text);
-    return lle_buffer_insert_text(editor->buffer,
-                                  editor->buffer->cursor.byte_offset, yank_text,
-                                  yank_length);
+    /* Replace previously yanked text with the new entry in one step */
+    result = lle_buffer_replace_text(buffer, editor->yank_start,
+                                     editor->yank_length, yank_text,
+                                     yank_length);
+    if (result != LLE_SUCCESS) {
+        editor->yank_valid = false;
+        return result;
+    }
+
+    if (editor->cursor_manager) {
+        lle_cursor_manager_move_to_byte_offset(editor->cursor_manager,
+                                               buffer->cursor.byte_offset);
+    }
+
+    editor->yank_length = yank_length;
+    editor->yank_modification_count = buffer->modification_count;
+    return LLE_SUCCESS;
 }
 
 /**
@@ -2882,19 +2903,8 @@ lle_result_t lle_unix_line_discard(lle_editor_t *editor) {
     size_t cursor_pos = editor->buffer->cursor.byte_offset;
 
     if (cursor_pos > 0) {
-        char *killed_text = strndup(editor->buffer->data, cursor_pos);
-
-        if (killed_text) {
-            /* Add to kill ring */
-            if (editor->kill_ring) {
-                lle_kill_ring_add(editor->kill_ring, killed_text, false);
-            }
-            free(killed_text);
-        }
-
         /* Delete from beginning to cursor */
-        lle_result_t result =
-            lle_buffer_delete_text(editor->buffer, 0, cursor_pos);
+        lle_result_t result = kill_text(editor, 0, cursor_pos, true);
         if (result == LLE_SUCCESS) {
             /* CRITICAL: Sync cursor_manager after cursor is moved to position 0
              */
@@ -2978,21 +2988,13 @@ lle_result_t lle_unix_word_rubout(lle_editor_t *editor) {
         word_start = prev_pos;
     }
 
+    /* The scan moved the cursor; put it back so kill_text() can chain
+     * onto the previous kill */
+    lle_cursor_manager_move_to_byte_offset(editor->cursor_manager, cursor_pos);
+
     if (cursor_pos > word_start) {
         size_t kill_len = cursor_pos - word_start;
-        char *killed_text = strndup(data + word_start, kill_len);
-
-        if (killed_text) {
-            /* Add to kill ring */
-            if (editor->kill_ring) {
-                lle_kill_ring_add(editor->kill_ring, killed_text, false);
-            }
-            free(killed_text);
-        }
-
-        /* Delete the text */
-        lle_result_t result =
-            lle_buffer_delete_text(editor->buffer, word_start, kill_len);
+        lle_result_t result = kill_text(editor, word_start, kill_len, true);
         if (result == LLE_SUCCESS) {
             /* CRITICAL: Sync cursor_manager after deletion */
             lle_cursor_manager_move_to_byte_offset(editor->cursor_manager,
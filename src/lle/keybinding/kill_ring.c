@@ -6,6 +6,14 @@
  * The kill ring is a circular buffer that stores killed (cut) text for
  * later yanking (pasting), supporting both append and prepend operations.
  *
+ * Each entry keeps its text contiguous inside a larger allocation with
+ * spare room on both sides. Appending or prepending a successive kill
+ * copies only the new bytes, and the allocation grows geometrically when
+ * the spare room runs out, so killing a long line word by word costs time
+ * proportional to its length. Yanking hands out the stored text directly.
+ * Entry storage counts against a byte budget; the oldest entries are
+ * dropped when it is exceeded.
+ *
  * @author Michael Berry <trismegustis@gmail.com>
  * @copyright Copyright (C) 2021-2026 Michael Berry
  *
@@ -25,13 +33,22 @@
  * ============================================================================
  */
 
+/** Smallest storage allocated for an entry */
+#define KILL_ENTRY_MIN_STORAGE 64
+
 /**
  * Kill ring entry - stores a single killed text string
+ *
+ * The text lives at storage + start and is followed by a NUL terminator;
+ * the bytes before start and after the terminator are spare room for
+ * prepends and appends.
  */
 typedef struct {
-    char *text;     /* Killed text (heap allocated) */
-    size_t length;  /* Length of text (excluding null terminator) */
-    bool allocated; /* True if entry is in use */
+    char *storage;   /* Allocation holding the text */
+    size_t capacity; /* Size of storage */
+    size_t start;    /* Offset of the text in storage */
+    size_t length;   /* Length of text (excluding null terminator) */
+    bool allocated;  /* True if entry is in use */
 } lle_kill_entry_t;
 
 /**
@@ -45,6 +62,8 @@ struct lle_kill_ring {
     size_t yank_position;      /* Current position for yank-pop */
     bool last_was_yank;        /* True if last operation was yank */
     bool last_was_kill;        /* True if last operation was kill */
+    size_t byte_budget;        /* Most bytes of entry storage kept */
+    size_t bytes_used;         /* Bytes of entry storage allocated */
     lle_memory_pool_t *pool;   /* Memory pool for allocations */
     pthread_mutex_t lock;      /* Thread safety lock */
 };
@@ -55,34 +74,22 @@ struct lle_kill_ring {
  */
 
 /**
- * @brief Allocate string from memory pool or malloc
+ * @brief Allocate storage from memory pool or malloc
  * @param ring Kill ring instance containing memory pool reference
- * @param str Source string to duplicate
- * @param len Length of string to allocate (excluding null terminator)
- * @return Pointer to allocated string copy, or NULL on failure
+ * @param size Bytes to allocate
+ * @return Pointer to the storage, or NULL on failure
  */
-static char *kill_ring_strdup(lle_kill_ring_t *ring, const char *str,
-                              size_t len) {
-    char *copy;
-
+static char *kill_ring_alloc(lle_kill_ring_t *ring, size_t size) {
     if (ring->pool != NULL) {
-        copy = (char *)lle_pool_allocate_fast(ring->pool, len + 1);
-    } else {
-        copy = (char *)malloc(len + 1);
-    }
-
-    if (copy != NULL) {
-        memcpy(copy, str, len);
-        copy[len] = '\0';
+        return (char *)lle_pool_allocate_fast(ring->pool, size);
     }
-
-    return copy;
+    return (char *)malloc(size);
 }
 
 /**
- * @brief Free string to memory pool or malloc
+ * @brief Free storage to memory pool or malloc
  * @param ring Kill ring instance containing memory pool reference
- * @param str String to free (may be NULL)
+ * @param str Storage to free (may be NULL)
  */
 static void kill_ring_free_string(lle_kill_ring_t *ring, char *str) {
     if (str == NULL) {
@@ -102,14 +109,131 @@ static void kill_ring_free_string(lle_kill_ring_t *ring, char *str) {
  * @param entry Kill entry to free and reset
  */
 static void free_entry(lle_kill_ring_t *ring, lle_kill_entry_t *entry) {
-    if (entry->text != NULL) {
-        kill_ring_free_string(ring, entry->text);
-        entry->text = NULL;
+    if (entry->storage != NULL) {
+        kill_ring_free_string(ring, entry->storage);
+        ring->bytes_used -= entry->capacity;
+        entry->storage = NULL;
     }
+    entry->capacity = 0;
+    entry->start = 0;
     entry->length = 0;
     entry->allocated = false;
 }
 
+/**
+ * @brief Get an entry's text
+ */
+static const char *entry_text(const lle_kill_entry_t *entry) {
+    return entry->storage + entry->start;
+}
+
+/**
+ * @brief Store text in an empty entry
+ * @return false on allocation failure
+ */
+static bool entry_set(lle_kill_ring_t *ring, lle_kill_entry_t *entry,
+                      const char *text, size_t length) {
+    size_t capacity = length + 1;
+    if (capacity < KILL_ENTRY_MIN_STORAGE) {
+        capacity = KILL_ENTRY_MIN_STORAGE;
+    }
+    char *storage = kill_ring_alloc(ring, capacity);
+    if (storage == NULL) {
+        return false;
+    }
+
+    memcpy(storage, text, length);
+    storage[length] = '\0';
+    entry->storage = storage;
+    entry->capacity = capacity;
+    entry->start = 0;
+    entry->length = length;
+    entry->allocated = true;
+    ring->bytes_used += capacity;
+    return true;
+}
+
+/**
+ * @brief Move an entry's text into larger storage
+ *
+ * The new storage is twice the size needed, with the spare room placed
+ * after the text for appends or before it for prepends.
+ *
+ * @param ring Kill ring instance
+ * @param entry Entry to grow
+ * @param extra Bytes about to be added
+ * @param at_front true if the bytes will be prepended
+ * @return false on allocation failure (entry unchanged)
+ */
+static bool entry_grow(lle_kill_ring_t *ring, lle_kill_entry_t *entry,
+                       size_t extra, bool at_front) {
+    size_t needed = entry->length + extra + 1;
+    size_t capacity = needed * 2;
+    char *storage = kill_ring_alloc(ring, capacity);
+    if (storage == NULL) {
+        return false;
+    }
+
+    size_t start = at_front ? capacity - 1 - entry->length : 0;
+    memcpy(storage + start, entry_text(entry), entry->length + 1);
+
+    kill_ring_free_string(ring, entry->storage);
+    ring->bytes_used += capacity - entry->capacity;
+    entry->storage = storage;
+    entry->capacity = capacity;
+    entry->start = start;
+    return true;
+}
+
+/**
+ * @brief Append text to an entry, copying only the new bytes
+ * @return false on allocation failure
+ */
+static bool entry_append(lle_kill_ring_t *ring, lle_kill_entry_t *entry,
+                         const char *text, size_t length) {
+    if (entry->start + entry->length + length + 1 > entry->capacity &&
+        !entry_grow(ring, entry, length, false)) {
+        return false;
+    }
+
+    char *end = entry->storage + entry->start + entry->length;
+    memcpy(end, text, length);
+    end[length] = '\0';
+    entry->length += length;
+    return true;
+}
+
+/**
+ * @brief Prepend text to an entry, copying only the new bytes
+ * @return false on allocation failure
+ */
+static bool entry_prepend(lle_kill_ring_t *ring, lle_kill_entry_t *entry,
+                          const char *text, size_t length) {
+    if (entry->start < length && !entry_grow(ring, entry, length, true)) {
+        return false;
+    }
+
+    entry->start -= length;
+    memcpy(entry->storage + entry->start, text, length);
+    entry->length += length;
+    return true;
+}
+
+/**
+ * @brief Drop the oldest entries until storage fits the byte budget
+ *
+ * The most recent entry is always kept so a kill can be yanked however
+ * large it is.
+ */
+static void enforce_byte_budget(lle_kill_ring_t *ring) {
+    while (ring->bytes_used > ring->byte_budget && ring->count > 1) {
+        size_t oldest =
+            (ring->head + ring->capacity - (ring->count - 1)) % ring->capacity;
+        free_entry(ring, &ring->entries[oldest]);
+        ring->count--;
+    }
+}
+
 /**
  * @brief Get entry at circular buffer position
  * @param position Logical position in the ring
@@ -189,6 +313,8 @@ lle_result_t lle_kill_ring_create(lle_kill_ring_t **ring, size_t max_entries,
     new_ring->yank_position = 0;
     new_ring->last_was_yank = false;
     new_ring->last_was_kill = false;
+    new_ring->byte_budget = LLE_KILL_RING_DEFAULT_BYTE_BUDGET;
+    new_ring->bytes_used = 0;
     new_ring->pool = pool;
 
     /* Initialize thread safety */
@@ -263,9 +389,24 @@ lle_result_t lle_kill_ring_add(lle_kill_ring_t *ring, const char *text,
     if (ring == NULL || text == NULL) {
         return LLE_ERROR_NULL_POINTER;
     }
+    return lle_kill_ring_add_text(ring, text, strlen(text), append);
+}
 
-    size_t text_len = strlen(text);
-    if (text_len == 0) {
+/**
+ * @brief Add text of a given length to the kill ring
+ * @param ring Kill ring instance
+ * @param text Text to add (need not be NUL-terminated)
+ * @param length Length of text in bytes (must be non-zero)
+ * @param append If true and last operation was kill, append to current entry
+ * @return LLE_SUCCESS on success, error code on failure
+ */
+lle_result_t lle_kill_ring_add_text(lle_kill_ring_t *ring, const char *text,
+                                    size_t length, bool append) {
+    if (ring == NULL || text == NULL) {
+        return LLE_ERROR_NULL_POINTER;
+    }
+
+    if (length == 0) {
         return LLE_ERROR_INVALID_PARAMETER;
     }
 
@@ -274,27 +415,11 @@ lle_result_t lle_kill_ring_add(lle_kill_ring_t *ring, const char *text,
     /* If append mode and ring not empty and last operation was kill */
     if (append && ring->count > 0 && ring->last_was_kill) {
         /* Append to current head entry */
-        lle_kill_entry_t *entry = &ring->entries[ring->head];
-
-        /* Reallocate with additional space */
-        size_t new_len = entry->length + text_len;
-        char *new_text = kill_ring_strdup(ring, "", new_len);
-
-        if (new_text == NULL) {
+        if (!entry_append(ring, &ring->entries[ring->head], text, length)) {
             pthread_mutex_unlock(&ring->lock);
             return LLE_ERROR_OUT_OF_MEMORY;
         }
 
-        /* Copy old text + new text */
-        memcpy(new_text, entry->text, entry->length);
-        memcpy(new_text + entry->length, text, text_len);
-        new_text[new_len] = '\0';
-
-        /* Free old text and update entry */
-        kill_ring_free_string(ring, entry->text);
-        entry->text = new_text;
-        entry->length = new_len;
-
     } else {
         /* Create new entry */
 
@@ -310,16 +435,18 @@ lle_result_t lle_kill_ring_add(lle_kill_ring_t *ring, const char *text,
         }
 
         /* Allocate and store new text */
-        entry->text = kill_ring_strdup(ring, text, text_len);
-        if (entry->text == NULL) {
+        if (!entry_set(ring, entry, text, length)) {
+            /* Leave the slot empty but keep count consistent */
+            ring->head = circular_index(ring->head + ring->capacity - 1,
+                                        ring->capacity);
+            ring->count--;
             pthread_mutex_unlock(&ring->lock);
             return LLE_ERROR_OUT_OF_MEMORY;
         }
-
-        entry->length = text_len;
-        entry->allocated = true;
     }
 
+    enforce_byte_budget(ring);
+
     /* Reset yank state, set kill state */
     ring->last_was_yank = false;
     ring->last_was_kill = true;
@@ -339,9 +466,23 @@ lle_result_t lle_kill_ring_prepend(lle_kill_ring_t *ring, const char *text) {
     if (ring == NULL || text == NULL) {
         return LLE_ERROR_NULL_POINTER;
     }
+    return lle_kill_ring_prepend_text(ring, text, strlen(text));
+}
+
+/**
+ * @brief Prepend text of a given length to the current kill ring entry
+ * @param ring Kill ring instance
+ * @param text Text to prepend (need not be NUL-terminated)
+ * @param length Length of text in bytes (must be non-zero)
+ * @return LLE_SUCCESS on success, error code on failure
+ */
+lle_result_t lle_kill_ring_prepend_text(lle_kill_ring_t *ring,
+                                        const char *text, size_t length) {
+    if (ring == NULL || text == NULL) {
+        return LLE_ERROR_NULL_POINTER;
+    }
 
-    size_t text_len = strlen(text);
-    if (text_len == 0) {
+    if (length == 0) {
         return LLE_ERROR_INVALID_PARAMETER;
     }
 
@@ -350,30 +491,16 @@ lle_result_t lle_kill_ring_prepend(lle_kill_ring_t *ring, const char *text) {
     /* If ring empty, just add as new entry */
     if (ring->count == 0) {
         pthread_mutex_unlock(&ring->lock);
-        return lle_kill_ring_add(ring, text, false);
+        return lle_kill_ring_add_text(ring, text, length, false);
     }
 
     /* Prepend to current head entry */
-    lle_kill_entry_t *entry = &ring->entries[ring->head];
-
-    /* Reallocate with additional space */
-    size_t new_len = text_len + entry->length;
-    char *new_text = kill_ring_strdup(ring, "", new_len);
-
-    if (new_text == NULL) {
+    if (!entry_prepend(ring, &ring->entries[ring->head], text, length)) {
         pthread_mutex_unlock(&ring->lock);
         return LLE_ERROR_OUT_OF_MEMORY;
     }
 
-    /* Copy new text + old text */
-    memcpy(new_text, text, text_len);
-    memcpy(new_text + text_len, entry->text, entry->length);
-    new_text[new_len] = '\0';
-
-    /* Free old text and update entry */
-    kill_ring_free_string(ring, entry->text);
-    entry->text = new_text;
-    entry->length = new_len;
+    enforce_byte_budget(ring);
 
     /* Reset yank state, set kill state */
     ring->last_was_yank = false;
@@ -396,6 +523,22 @@ lle_result_t lle_kill_ring_prepend(lle_kill_ring_t *ring, const char *text) {
  */
 lle_result_t lle_kill_ring_get_current(lle_kill_ring_t *ring,
                                        const char **text_out) {
+    if (text_out == NULL) {
+        return LLE_ERROR_NULL_POINTER;
+    }
+    return lle_kill_ring_get_current_text(ring, text_out, NULL);
+}
+
+/**
+ * @brief Get the current kill ring entry and its length for yanking
+ * @param ring Kill ring instance
+ * @param text_out Pointer to store the text (not a copy, do not free)
+ * @param length_out Pointer to store the text length (may be NULL)
+ * @return LLE_SUCCESS on success, LLE_ERROR_QUEUE_EMPTY if ring is empty
+ */
+lle_result_t lle_kill_ring_get_current_text(lle_kill_ring_t *ring,
+                                            const char **text_out,
+                                            size_t *length_out) {
     if (ring == NULL || text_out == NULL) {
         return LLE_ERROR_NULL_POINTER;
     }
@@ -409,7 +552,10 @@ lle_result_t lle_kill_ring_get_current(lle_kill_ring_t *ring,
 
     /* Return most recent kill (head) */
     lle_kill_entry_t *entry = &ring->entries[ring->head];
-    *text_out = entry->text;
+    *text_out = entry_text(entry);
+    if (length_out != NULL) {
+        *length_out = entry->length;
+    }
 
     /* Set yank state */
     ring->last_was_yank = true;
@@ -428,6 +574,22 @@ lle_result_t lle_kill_ring_get_current(lle_kill_ring_t *ring,
  */
 lle_result_t lle_kill_ring_yank_pop(lle_kill_ring_t *ring,
                                     const char **text_out) {
+    if (text_out == NULL) {
+        return LLE_ERROR_NULL_POINTER;
+    }
+    return lle_kill_ring_yank_pop_text(ring, text_out, NULL);
+}
+
+/**
+ * @brief Get the previous kill ring entry and its length (yank-pop)
+ * @param ring Kill ring instance
+ * @param text_out Pointer to store the text (not a copy, do not free)
+ * @param length_out Pointer to store the text length (may be NULL)
+ * @return LLE_SUCCESS on success, LLE_ERROR_INVALID_STATE if not after yank
+ */
+lle_result_t lle_kill_ring_yank_pop_text(lle_kill_ring_t *ring,
+                                         const char **text_out,
+                                         size_t *length_out) {
     if (ring == NULL || text_out == NULL) {
         return LLE_ERROR_NULL_POINTER;
     }
@@ -470,7 +632,11 @@ lle_result_t lle_kill_ring_yank_pop(lle_kill_ring_t *ring,
         return LLE_ERROR_STATE_CORRUPTION;
     }
 
-    *text_out = ring->entries[ring->yank_position].text;
+    lle_kill_entry_t *entry = &ring->entries[ring->yank_position];
+    *text_out = entry_text(entry);
+    if (length_out != NULL) {
+        *length_out = entry->length;
+    }
 
     /* Maintain yank state */
     ring->last_was_yank = true;
@@ -630,6 +796,49 @@ lle_result_t lle_kill_ring_get_capacity(lle_kill_ring_t *ring,
     return LLE_SUCCESS;
 }
 
+/**
+ * @brief Set the most bytes of text storage the ring keeps
+ * @param ring Kill ring instance
+ * @param bytes Byte budget (must be non-zero)
+ * @return LLE_SUCCESS on success, error code on failure
+ */
+lle_result_t lle_kill_ring_set_byte_budget(lle_kill_ring_t *ring,
+                                           size_t bytes) {
+    if (ring == NULL) {
+        return LLE_ERROR_NULL_POINTER;
+    }
+
+    if (bytes == 0) {
+        return LLE_ERROR_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&ring->lock);
+    ring->byte_budget = bytes;
+    enforce_byte_budget(ring);
+    pthread_mutex_unlock(&ring->lock);
+
+    return LLE_SUCCESS;
+}
+
+/**
+ * @brief Get the bytes of text storage the ring holds
+ * @param ring Kill ring instance
+ * @param bytes_out Pointer to store the byte count
+ * @return LLE_SUCCESS on success, LLE_ERROR_NULL_POINTER if params are NULL
+ */
+lle_result_t lle_kill_ring_get_memory_usage(lle_kill_ring_t *ring,
+                                            size_t *bytes_out) {
+    if (ring == NULL || bytes_out == NULL) {
+        return LLE_ERROR_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&ring->lock);
+    *bytes_out = ring->bytes_used;
+    pthread_mutex_unlock(&ring->lock);
+
+    return LLE_SUCCESS;
+}
+
 /* ============================================================================
  * DEBUGGING/INTROSPECTION
  * ============================================================================
@@ -668,7 +877,7 @@ lle_result_t lle_kill_ring_get_entry_at_index(lle_kill_ring_t *ring,
         return LLE_ERROR_INTERNAL;
     }
 
-    *text_out = ring->entries[pos].text;
+    *text_out = entry_text(&ring->entries[pos]);
 
     pthread_mutex_unlock(&ring->lock);
     return LLE_SUCCESS;
@@ -689,6 +898,7 @@ lle_result_t lle_kill_ring_dump(lle_kill_ring_t *ring) {
     printf("Kill Ring Dump:\n");
     printf("  Capacity: %zu\n", ring->capacity);
     printf("  Count: %zu\n", ring->count);
+    printf("  Bytes: %zu of %zu\n", ring->bytes_used, ring->byte_budget);
     printf("  Head: %zu\n", ring->head);
     printf("  Yank Position: %zu\n", ring->yank_position);
     printf("  Last Was Yank: %s\n", ring->last_was_yank ? "true" : "false");
@@ -698,7 +908,7 @@ lle_result_t lle_kill_ring_dump(lle_kill_ring_t *ring) {
     for (size_t i = 0; i < ring->capacity; i++) {
         if (ring->entries[i].allocated) {
             printf("  [%zu] (len=%zu): \"%s\"\n", i, ring->entries[i].length,
-                   ring->entries[i].text);
+                   entry_text(&ring->entries[i]));
         } else {
             printf("  [%zu] (empty)\n", i);
         }
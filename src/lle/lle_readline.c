@@ -83,6 +83,7 @@
 #include "lle/unicode_compare.h" /* TR#29 compliant Unicode prefix matching */
 #include "lle/widget_hooks.h"    /* Widget hooks for lifecycle events */
 #include "signals.h"             /* For SIGINT flag coordination with LLE */
+#include "startup_profile.h"     /* Startup tracer and deferred init */
 
 /* Forward declarations for history action functions */
 lle_result_t lle_history_previous(lle_editor_t *editor);
@@ -221,8 +222,8 @@ typedef struct readline_context {
     char **final_line;
     lle_terminal_abstraction_t *term;
     const char *prompt;
-    continuation_state_t
-        *continuation_state; /* Step 6: Shared multiline parser state */
+    continuation_analyzer_t
+        *continuation; /* Step 6: Shared multiline parser (incremental) */
     char *kill_buffer; /* Step 5 enhancement: Simple kill buffer for yank */
     size_t kill_buffer_size; /* Allocated size of kill buffer */
 
@@ -504,6 +505,34 @@ static bool accept_autosuggestion(readline_context_t *ctx) {
 /* Forward declaration for refresh_display */
 static void refresh_display(readline_context_t *ctx);
 
+/**
+ * @brief Print startup profile output below the prompt
+ *
+ * Raw mode is left while printing so the report lines come out as normal
+ * terminal output, then the prompt is drawn again underneath.
+ *
+ * @param ctx Readline context
+ * @param unix_iface Terminal interface in raw mode
+ * @param deferred Run the deferred startup tasks and report their times
+ *                 instead of printing the startup report
+ */
+static void print_startup_profile(readline_context_t *ctx,
+                                  lle_unix_interface_t *unix_iface,
+                                  bool deferred) {
+    lle_unix_interface_exit_raw_mode(unix_iface);
+    fputc('\n', stderr);
+    if (deferred) {
+        startup_run_deferred(stderr);
+    } else {
+        startup_profile_report(stderr);
+    }
+    fflush(stderr);
+    lle_unix_interface_enter_raw_mode(unix_iface);
+
+    dc_reset_prompt_display_state();
+    refresh_display(ctx);
+}
+
 /**
  * @brief Context-aware RIGHT arrow action (Fish-style autosuggestion
  * acceptance)
@@ -790,7 +819,8 @@ lle_forward_word_or_accept_partial_suggestion(readline_context_t *ctx) {
  * @brief Multiline detection using shared continuation parser
  * Step 6: Uses input_continuation.c for proper shell construct detection
  *
- * Analyzes buffer content using the shared multiline parser which handles:
+ * The analyzer keeps per-line checkpoints between calls, so only lines at
+ * or after the first edit are re-scanned. It handles:
  * - Quote tracking (single, double, backtick)
  * - Bracket/brace/parenthesis counting
  * - Control structures (if/then/fi, case, loops)
@@ -798,21 +828,17 @@ lle_forward_word_or_accept_partial_suggestion(readline_context_t *ctx) {
  * - Function definitions
  *
  * @param buffer_data The buffer content to check
- * @param state Continuation state to analyze with
+ * @param analyzer Incremental analyzer for this editing session
  * @return true if input appears incomplete, false otherwise
  */
 static bool is_input_incomplete(const char *buffer_data,
-                                continuation_state_t *state) {
-    if (buffer_data == NULL || state == NULL) {
+                                continuation_analyzer_t *analyzer) {
+    if (buffer_data == NULL || analyzer == NULL) {
         return false;
     }
 
-    /* Reset state for fresh analysis */
-    continuation_state_cleanup(state);
-    continuation_state_init(state);
-
-    /* Analyze the entire buffer content */
-    continuation_analyze_line(buffer_data, state);
+    const continuation_state_t *state =
+        continuation_analyzer_update(analyzer, buffer_data);
 
     /* Check if continuation is needed */
     return continuation_needs_continuation(state);
@@ -1081,6 +1107,92 @@ static lle_result_t handle_backspace(lle_event_t *event, void *user_data) {
     return LLE_SUCCESS;
 }
 
+/**
+ * @brief Indent width used by lle.auto_indent
+ */
+#define LLE_AUTO_INDENT_WIDTH 4
+
+/**
+ * @brief Replace the leading whitespace of the line starting at an offset
+ *
+ * @param ctx Readline context
+ * @param line_start Byte offset of the line start
+ * @param depth Indentation depth for the line
+ */
+static void reindent_line(readline_context_t *ctx, size_t line_start,
+                          int depth) {
+    const char *data = ctx->buffer->data;
+    size_t old_width = 0;
+    while (line_start + old_width < ctx->buffer->length &&
+           (data[line_start + old_width] == ' ' ||
+            data[line_start + old_width] == '\t')) {
+        old_width++;
+    }
+
+    size_t new_width = (size_t)depth * LLE_AUTO_INDENT_WIDTH;
+    if (old_width == new_width ||
+        lle_buffer_delete_text(ctx->buffer, line_start, old_width) !=
+            LLE_SUCCESS) {
+        return;
+    }
+    char spaces[LLE_AUTO_INDENT_WIDTH * CONTINUATION_MAX_CONTEXT_DEPTH];
+    memset(spaces, ' ', new_width);
+    lle_buffer_insert_text(ctx->buffer, line_start, spaces, new_width);
+}
+
+/**
+ * @brief Insert a line break for incomplete input
+ *
+ * With lle.auto_indent set, the new line is indented to the block depth at
+ * the cursor, and a line starting with fi, done, esac, }, then, do, else
+ * or elif is first moved out to its enclosing block. The depth comes from
+ * the incremental continuation analyzer, which the caller has just updated
+ * with the buffer, so only the line being edited is scanned.
+ *
+ * @param ctx Readline context
+ * @return Result of the buffer insertion
+ */
+static lle_result_t insert_continuation_line(readline_context_t *ctx) {
+    size_t cursor = ctx->buffer->cursor.byte_offset;
+    int line_depth = -1;
+    int depth = -1;
+    if (config.lle_auto_indent) {
+        depth = continuation_analyzer_depth_at(ctx->continuation, cursor,
+                                               &line_depth);
+    }
+
+    if (line_depth >= 0) {
+        size_t line_start = cursor;
+        while (line_start > 0 && ctx->buffer->data[line_start - 1] != '\n') {
+            line_start--;
+        }
+        /* The buffer keeps the cursor on the same character */
+        reindent_line(ctx, line_start, line_depth);
+    }
+
+    char text[1 + LLE_AUTO_INDENT_WIDTH * CONTINUATION_MAX_CONTEXT_DEPTH];
+    size_t len = 1;
+    text[0] = '\n';
+    if (depth > 0) {
+        memset(text + 1, ' ', (size_t)depth * LLE_AUTO_INDENT_WIDTH);
+        len += (size_t)depth * LLE_AUTO_INDENT_WIDTH;
+    }
+    lle_result_t result = lle_buffer_insert_text(
+        ctx->buffer, ctx->buffer->cursor.byte_offset, text, len);
+
+    /* Synchronize cursor fields after insert (PHASE 2 STEP 0 FIX) */
+    if (result == LLE_SUCCESS && ctx->editor && ctx->editor->cursor_manager) {
+        lle_cursor_manager_move_to_byte_offset(
+            ctx->editor->cursor_manager, ctx->buffer->cursor.byte_offset);
+    }
+
+    if (result == LLE_SUCCESS) {
+        refresh_display(ctx);
+    }
+
+    return result;
+}
+
 /**
  * @brief Event handler for Enter key
  * Step 6: Check for multiline continuation before completing
@@ -1091,7 +1203,7 @@ static lle_result_t handle_enter(lle_event_t *event, void *user_data) {
 
     /* Check for incomplete input using shared continuation parser */
     bool incomplete =
-        is_input_incomplete(ctx->buffer->data, ctx->continuation_state);
+        is_input_incomplete(ctx->buffer->data, ctx->continuation);
 
     if (incomplete) {
         /* SAFETY CHECK: Limit maximum line count to prevent infinite loops
@@ -1116,21 +1228,7 @@ static lle_result_t handle_enter(lle_event_t *event, void *user_data) {
 
     if (incomplete) {
         /* Input incomplete - insert newline and continue */
-        lle_result_t result = lle_buffer_insert_text(
-            ctx->buffer, ctx->buffer->cursor.byte_offset, "\n", 1);
-
-        /* Synchronize cursor fields after insert (PHASE 2 STEP 0 FIX) */
-        if (result == LLE_SUCCESS && ctx->editor &&
-            ctx->editor->cursor_manager) {
-            lle_cursor_manager_move_to_byte_offset(
-                ctx->editor->cursor_manager, ctx->buffer->cursor.byte_offset);
-        }
-
-        if (result == LLE_SUCCESS) {
-            refresh_display(ctx);
-        }
-
-        return result;
+        return insert_continuation_line(ctx);
     }
 
     /* Line complete - accept entire buffer regardless of cursor position */
@@ -1232,25 +1330,11 @@ lle_result_t lle_accept_line_context(readline_context_t *ctx) {
 
     /* Check for incomplete input using shared continuation parser */
     bool incomplete =
-        is_input_incomplete(ctx->buffer->data, ctx->continuation_state);
+        is_input_incomplete(ctx->buffer->data, ctx->continuation);
 
     if (incomplete) {
         /* Input incomplete - insert newline and continue editing */
-        lle_result_t result = lle_buffer_insert_text(
-            ctx->buffer, ctx->buffer->cursor.byte_offset, "\n", 1);
-
-        /* Synchronize cursor fields after insert */
-        if (result == LLE_SUCCESS && ctx->editor &&
-            ctx->editor->cursor_manager) {
-            lle_cursor_manager_move_to_byte_offset(
-                ctx->editor->cursor_manager, ctx->buffer->cursor.byte_offset);
-        }
-
-        if (result == LLE_SUCCESS) {
-            refresh_display(ctx);
-        }
-
-        return result;
+        return insert_continuation_line(ctx);
     }
 
     /* Line complete - accept entire buffer regardless of cursor position */
@@ -2721,6 +2805,7 @@ char *lle_readline(const char *prompt) {
     void *display_controller = display_integration_get_controller();
 
     /* === STEP 1: Create terminal abstraction instance === */
+    startup_phase("terminal setup");
     lle_terminal_abstraction_t *term = NULL;
     result = lle_terminal_abstraction_init(
         &term, (lush_display_context_t *)display_controller);
@@ -2752,6 +2837,7 @@ char *lle_readline(const char *prompt) {
     set_lle_readline_active(1);
 
     /* === STEP 4: Create buffer for line editing === */
+    startup_phase("editor setup");
     lle_buffer_t *buffer = NULL;
     result = lle_buffer_create(&buffer, global_memory_pool, 256);
     if (result != LLE_SUCCESS || buffer == NULL) {
@@ -2779,8 +2865,8 @@ char *lle_readline(const char *prompt) {
 
     /* === STEP 5.5: Create continuation state === */
     /* Step 6: Initialize shared multiline parser state */
-    continuation_state_t continuation_state;
-    continuation_state_init(&continuation_state);
+    continuation_analyzer_t continuation;
+    continuation_analyzer_init(&continuation);
 
     /* === STEP 5.55: Create edit-session arena === */
     /* Arena for per-readline allocations (kill buffer, suggestions, etc.)
@@ -2878,6 +2964,7 @@ char *lle_readline(const char *prompt) {
     }
 
     /* === STEP 6.6: Create keybinding manager and load Emacs preset === */
+    startup_phase("keybindings");
     lle_keybinding_manager_t *keybinding_manager = NULL;
     result =
         lle_keybinding_manager_create(&keybinding_manager, global_memory_pool);
@@ -2962,7 +3049,7 @@ char *lle_readline(const char *prompt) {
         .final_line = &final_line,
         .term = term,
         .prompt = prompt,
-        .continuation_state = &continuation_state,
+        .continuation = &continuation,
         .kill_buffer = kill_buffer,
         .kill_buffer_size = kill_buffer_size,
 
@@ -3019,6 +3106,12 @@ char *lle_readline(const char *prompt) {
 
         /* Category 4: Special input modes */
         editor_to_use->quoted_insert_mode = false;
+
+        /* Category 5: Undo history belongs to the previous line's buffer;
+         * clearing it rewinds the delta log for reuse */
+        if (editor_to_use->change_tracker) {
+            lle_change_tracker_clear(editor_to_use->change_tracker);
+        }
     }
 
     /* Register handler for character input */
@@ -3034,6 +3127,7 @@ char *lle_readline(const char *prompt) {
     }
 
     /* === STEP 7: Display prompt === */
+    startup_phase("prompt display");
     /* Step 4: Set prompt in prompt_layer and display initial prompt */
     if (lle_display_integ && lle_display_integ->lush_display) {
         display_controller_t *dc = lle_display_integ->lush_display;
@@ -3046,6 +3140,14 @@ char *lle_readline(const char *prompt) {
     /* Initial display refresh to show prompt */
     refresh_display(&ctx);
 
+    /* The first prompt on screen ends the startup critical path */
+    if (!startup_profile_finished()) {
+        startup_profile_finish(NULL);
+        if (startup_profile_enabled()) {
+            print_startup_profile(&ctx, unix_iface, false);
+        }
+    }
+
     /* === WIDGET HOOK: LINE_INIT === */
     /* Trigger line-init hook at start of readline (ZSH zle-line-init) */
     if (editor_to_use && editor_to_use->widget_hooks_manager) {
@@ -3172,6 +3274,18 @@ char *lle_readline(const char *prompt) {
         /* Handle timeout and null events - just continue waiting
          * Idle waiting for user input is completely normal.
          * The watchdog catches actual processing freezes. */
+        /* Initialization deferred past the first prompt runs once the
+         * user has a prompt and is not typing */
+        if ((result == LLE_ERROR_TIMEOUT || event == NULL ||
+             event->type == LLE_INPUT_TYPE_TIMEOUT) &&
+            startup_deferred_pending() > 0) {
+            if (startup_profile_enabled()) {
+                print_startup_profile(&ctx, unix_iface, true);
+            } else {
+                startup_run_deferred(NULL);
+            }
+        }
+
         if (result == LLE_ERROR_TIMEOUT || event == NULL) {
             /* Theme hot-reload check (~every 2 seconds during idle) */
             if (config.display_theme_hot_reload && g_lle_integration &&
@@ -3558,6 +3672,13 @@ char *lle_readline(const char *prompt) {
         }
 
         case LLE_INPUT_TYPE_ERROR: {
+            /* Sequences we recognize but do not handle yet (bracketed paste
+             * markers, focus, mouse) are dropped; treating them as input
+             * errors would end the line and exit the shell */
+            if (event->data.error.error_code ==
+                LLE_ERROR_FEATURE_NOT_AVAILABLE) {
+                break;
+            }
             /* Input error */
             done = true;
             final_line = NULL;
@@ -3654,7 +3775,7 @@ char *lle_readline(const char *prompt) {
 
     /* Step 6: Cleanup continuation state, destroy event system, buffer, and
      * terminal */
-    continuation_state_cleanup(&continuation_state);
+    continuation_analyzer_cleanup(&continuation);
     lle_event_system_destroy(event_system);
     lle_buffer_destroy(buffer);
 
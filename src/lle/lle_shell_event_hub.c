@@ -419,6 +419,22 @@ void lle_fire_pre_command(const char *command, bool is_background) {
  */
 void lle_fire_post_command(const char *command, int exit_code,
                            uint64_t duration_us) {
+    lle_fire_post_command_usage(command, exit_code, duration_us, 0, 0, 0);
+}
+
+/**
+ * @brief Fire a post-command event with child resource usage
+ *
+ * @param command The command that was executed (NULL to use stored command)
+ * @param exit_code Exit code of the command
+ * @param duration_us Duration in microseconds (0 to auto-calculate)
+ * @param cpu_user_us User CPU time of children in microseconds
+ * @param cpu_sys_us System CPU time of children in microseconds
+ * @param max_rss_kb Peak resident set size of children in KB
+ */
+void lle_fire_post_command_usage(const char *command, int exit_code,
+                                 uint64_t duration_us, uint64_t cpu_user_us,
+                                 uint64_t cpu_sys_us, long max_rss_kb) {
     /* Get global shell integration */
     if (!g_lle_integration || !g_lle_integration->event_hub) {
         if (lle_event_debug_enabled()) {
@@ -454,7 +470,10 @@ void lle_fire_post_command(const char *command, int exit_code,
     /* Create event data */
     lle_post_command_event_t event = {.command = actual_command,
                                       .exit_code = exit_code,
-                                      .duration_us = actual_duration};
+                                      .duration_us = actual_duration,
+                                      .cpu_user_us = cpu_user_us,
+                                      .cpu_sys_us = cpu_sys_us,
+                                      .max_rss_kb = max_rss_kb};
 
     /* Update statistics */
     hub->commands_executed++;
@@ -249,7 +249,7 @@ static void execute_prompt_command(void) {
             for (size_t i = 0; i < count; i++) {
                 if (commands[i] && commands[i][0] != '\0') {
                     // Execute each command in the array
-                    executor_execute_command_line(executor, commands[i]);
+                    executor_execute_cached(executor, commands[i]);
                 }
             }
             // Free the commands array
@@ -264,7 +264,7 @@ static void execute_prompt_command(void) {
     // Fall back to string form (traditional Bash style)
     char *cmd_str = symtable_get_global("PROMPT_COMMAND");
     if (cmd_str && cmd_str[0] != '\0') {
-        executor_execute_command_line(executor, cmd_str);
+        executor_execute_cached(executor, cmd_str);
         free(cmd_str);
     }
 }
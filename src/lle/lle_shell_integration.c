@@ -420,6 +420,25 @@ bool lle_is_active(void) {
  * ============================================================================
  */
 
+/**
+ * @brief POST_COMMAND handler that annotates history with the outcome
+ *
+ * The entry is added when the line is accepted, before it runs; this fills
+ * in its exit status and duration so history queries can filter on them.
+ */
+static void history_annotate_handler(void *event_data, void *user_data) {
+    lle_post_command_event_t *event = event_data;
+    lle_history_core_t *core = user_data;
+    if (!event || !core || !event->command) {
+        return;
+    }
+
+    uint64_t duration_ms = event->duration_us / 1000;
+    lle_history_record_result(core, event->command, event->exit_code,
+                              duration_ms > UINT32_MAX ? UINT32_MAX
+                                                       : (uint32_t)duration_ms);
+}
+
 /**
  * @brief Create and configure the LLE editor instance
  */
@@ -462,6 +481,14 @@ create_and_configure_editor(lle_shell_integration_t *integ) {
         if (bridge_result != LLE_SUCCESS) {
             /* Non-fatal - history builtin won't work but shell continues */
         }
+
+        /* Record exit status and duration of each command */
+        if (integ->event_hub) {
+            lle_shell_event_hub_register(
+                integ->event_hub, LLE_SHELL_EVENT_POST_COMMAND,
+                history_annotate_handler, integ->editor->history_system,
+                "history-annotate");
+        }
     }
 
     return LLE_SUCCESS;
@@ -475,6 +502,12 @@ static void destroy_editor(lle_shell_integration_t *integ) {
         return;
     }
 
+    if (integ->event_hub) {
+        lle_shell_event_hub_unregister(integ->event_hub,
+                                       LLE_SHELL_EVENT_POST_COMMAND,
+                                       "history-annotate");
+    }
+
     lle_editor_destroy(integ->editor);
     integ->editor = NULL;
     integ->init_state.editor_initialized = false;
@@ -1065,6 +1065,9 @@ static void composer_on_post_command(void *event_data, void *user_data) {
     uint64_t duration_ms = event->duration_us / 1000;
     lle_prompt_context_update(&composer->context, event->exit_code,
                               duration_ms);
+    lle_prompt_context_update_usage(
+        &composer->context, (event->cpu_user_us + event->cpu_sys_us) / 1000,
+        event->max_rss_kb);
 
     /* Clear current command state */
     composer->current_command = NULL;
@@ -289,12 +289,31 @@ void lle_prompt_context_update(lle_prompt_context_t *ctx, int exit_code,
 
     ctx->last_exit_code = exit_code;
     ctx->last_cmd_duration_ms = duration_ms;
+    ctx->last_cmd_cpu_ms = 0;
+    ctx->last_cmd_max_rss_kb = 0;
 
     /* Update time */
     ctx->current_time = time(NULL);
     localtime_r(&ctx->current_time, &ctx->current_tm);
 }
 
+/**
+ * @brief Record child resource usage of the last command
+ *
+ * @param ctx         Pointer to context (ignored if NULL)
+ * @param cpu_ms      User + system CPU time of children in milliseconds
+ * @param max_rss_kb  Peak resident set size of children in KB
+ */
+void lle_prompt_context_update_usage(lle_prompt_context_t *ctx,
+                                     uint64_t cpu_ms, long max_rss_kb) {
+    if (!ctx) {
+        return;
+    }
+
+    ctx->last_cmd_cpu_ms = cpu_ms;
+    ctx->last_cmd_max_rss_kb = max_rss_kb;
+}
+
 /**
  * @brief Set background job count in context
  *
@@ -1978,6 +1997,17 @@ segment_cmd_duration_render(const lle_prompt_segment_t *self,
                  hrs, min);
     }
 
+    /* style = "full": append child CPU time and peak memory when known */
+    if (cfg && cfg->style_set && strcmp(cfg->style, "full") == 0 &&
+        (ctx->last_cmd_cpu_ms > 0 || ctx->last_cmd_max_rss_kb > 0)) {
+        size_t len = strlen(output->content);
+        uint64_t cpu = ctx->last_cmd_cpu_ms;
+        long rss_mb = ctx->last_cmd_max_rss_kb / 1024;
+        snprintf(output->content + len, sizeof(output->content) - len,
+                 " (cpu %u.%us, %ldM)", (unsigned)(cpu / 1000),
+                 (unsigned)((cpu % 1000) / 100), rss_mb);
+    }
+
     output->content_len = strlen(output->content);
     output->visual_width = output->content_len;
     output->is_empty = false;
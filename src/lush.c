@@ -19,10 +19,12 @@
 #include "executor.h"
 #include "init.h"
 #include "input.h"
+#include "memo.h"
 #include "lle/lle_shell_event_hub.h"
 #include "lle/lle_shell_integration.h"
 #include "posix_history.h"
 #include "signals.h"
+#include "startup_profile.h"
 #include "symtable.h"
 
 #include <time.h>
@@ -82,6 +84,34 @@ void executor_update_job_status(executor_t *executor);
 // Global executor for persistent function definitions across commands
 static executor_t *global_executor = NULL;
 
+static bool ensure_global_executor(void);
+
+/**
+ * @brief Fire the LLE post-command event with child resource usage
+ *
+ * Reports the CPU time and peak RSS of the children reaped while the
+ * command ran, when any were, so prompt segments can show them.
+ *
+ * @param command Command that was executed
+ * @param exit_status Command exit status
+ * @param duration_us Wall-clock duration in microseconds
+ */
+static void fire_post_command(const char *command, int exit_status,
+                              uint64_t duration_us) {
+    if (!global_executor || global_executor->last_rusage_children == 0) {
+        lle_fire_post_command(command, exit_status, duration_us);
+        return;
+    }
+
+    const struct rusage *ru = &global_executor->last_rusage;
+    uint64_t user_us = (uint64_t)ru->ru_utime.tv_sec * 1000000ULL +
+                       (uint64_t)ru->ru_utime.tv_usec;
+    uint64_t sys_us = (uint64_t)ru->ru_stime.tv_sec * 1000000ULL +
+                      (uint64_t)ru->ru_stime.tv_usec;
+    lle_fire_post_command_usage(command, exit_status, duration_us, user_us,
+                                sys_us, ru->ru_maxrss);
+}
+
 /**
  * @brief Main entry point for the Lush shell
  *
@@ -96,6 +126,7 @@ static executor_t *global_executor = NULL;
 int main(int argc, char **argv) {
     FILE *in = NULL;   // input file stream pointer
     char *line = NULL; // pointer to a line of input read
+    int script_line = 1; // script line the next construct starts on
 
     // Initialize special shell variables
     shell_pid = getpid();
@@ -141,8 +172,8 @@ int main(int argc, char **argv) {
             clock_gettime(CLOCK_MONOTONIC, &ts);
             uint64_t cmd_end_us =
                 (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
-            lle_fire_post_command(shell_opts.command_string, exit_status,
-                                  cmd_end_us - cmd_start_us);
+            fire_post_command(shell_opts.command_string, exit_status,
+                              cmd_end_us - cmd_start_us);
         }
 
         // Flush output buffers before exit to ensure all output is displayed
@@ -290,11 +321,19 @@ int main(int argc, char **argv) {
         // actual trap command execution happens here in main loop context.
         execute_pending_traps();
 
+        // Install finished background memo refreshes and reap their
+        // processes before the next command is read
+        memo_poll();
+
         // Read complete command(s) using unified input system
         // This ensures consistent parsing behavior between interactive and
         // non-interactive modes
         line = get_unified_input(in);
 
+        // The line editor ends startup when it draws the first prompt;
+        // other input paths end it with the first line read
+        startup_profile_finish(stderr);
+
         if (line == NULL) {
             // Check if this was due to SIGINT (Ctrl+C) rather than real EOF
             if (check_and_clear_sigint_flag()) {
@@ -332,6 +371,13 @@ int main(int argc, char **argv) {
             lle_fire_pre_command(line, is_bg);
         }
 
+        // Nodes count lines from the start of their construct; record
+        // where it starts in the script
+        if (!is_interactive_shell() && ensure_global_executor()) {
+            executor_set_script_line(global_executor, script_line);
+            script_line += get_input_line_count(line);
+        }
+
         // Execute using unified modern parser and store exit status
         int exit_status = parse_and_execute(line);
         last_exit_status = exit_status;
@@ -345,7 +391,7 @@ int main(int argc, char **argv) {
             clock_gettime(CLOCK_MONOTONIC, &ts);
             uint64_t cmd_end_us =
                 (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
-            lle_fire_post_command(line, exit_status, cmd_end_us - cmd_start_us);
+            fire_post_command(line, exit_status, cmd_end_us - cmd_start_us);
         }
 
         // Post-command display integration for layered display caching
@@ -387,36 +433,31 @@ int main(int argc, char **argv) {
     // Cleanup is handled by atexit() handlers registered in init.c
     // This prevents double cleanup when exit() command is used
 
+    // Execute EXIT traps before shell terminates normally, while the
+    // executor they run in still exists
+    execute_exit_traps();
+
     // Cleanup global executor before exit
     if (global_executor) {
         executor_free(global_executor);
         global_executor = NULL;
     }
 
-    // Execute EXIT traps before shell terminates normally
-    execute_exit_traps();
-
     // Exit with the status of the last command executed (POSIX requirement)
     exit(last_exit_status);
 }
 
 /**
- * @brief Parse and execute a shell command string
- *
- * Uses the global persistent executor to parse and execute the given
- * command string. The global executor maintains function definitions
- * across multiple command invocations.
- *
- * @param command The command string to parse and execute
- * @return Exit status of the executed command (0 for success, non-zero for failure)
+ * @brief Create the global executor on first use
+ * @return false if it could not be created
  */
-int parse_and_execute(const char *command) {
+static bool ensure_global_executor(void) {
     // Use global persistent executor for all commands to maintain function
     // definitions
     if (!global_executor) {
         global_executor = executor_new();
         if (!global_executor) {
-            return 1;
+            return false;
         }
         
         // Set script context if running a script (not interactive)
@@ -429,9 +470,15 @@ int parse_and_execute(const char *command) {
             }
         }
     }
+    return true;
+}
 
-    int exit_status = executor_execute_command_line(global_executor, command);
-
+/**
+ * @brief Flush output and report errors after a command string ran
+ * @param exit_status Status of the command string
+ * @return exit_status
+ */
+static int finish_execution(int exit_status) {
     // Flush output streams after command execution
     // This ensures output appears immediately, especially under valgrind/piping
     fflush(stdout);
@@ -447,6 +494,70 @@ int parse_and_execute(const char *command) {
     return exit_status;
 }
 
+/**
+ * @brief Parse and execute a shell command string
+ *
+ * Uses the global persistent executor to parse and execute the given
+ * command string. The global executor maintains function definitions
+ * across multiple command invocations.
+ *
+ * @param command The command string to parse and execute
+ * @return Exit status of the executed command (0 for success, non-zero for failure)
+ */
+int parse_and_execute(const char *command) {
+    if (!ensure_global_executor()) {
+        return 1;
+    }
+    return finish_execution(
+        executor_execute_command_line(global_executor, command));
+}
+
+/**
+ * @brief Parse and execute a shell command string through the parse cache
+ *
+ * Like parse_and_execute(), but an identical string parsed before is
+ * executed from its cached tree.
+ *
+ * @param command The command string to parse and execute
+ * @return Exit status of the executed command
+ */
+int parse_and_execute_cached(const char *command) {
+    if (!ensure_global_executor()) {
+        return 1;
+    }
+    return finish_execution(
+        executor_execute_cached(global_executor, command));
+}
+
+/**
+ * @brief Execute an already parsed shell command string
+ *
+ * Used for startup files whose parsed form was loaded from the startup
+ * cache; behaves like parse_and_execute() after its parse.
+ *
+ * @param ast Parsed command string (not freed)
+ * @return Exit status of the executed command
+ */
+int execute_parsed(node_t *ast) {
+    if (!ensure_global_executor()) {
+        return 1;
+    }
+    return finish_execution(executor_execute_parsed(global_executor, ast));
+}
+
+/**
+ * @brief Parse a shell command string without executing it
+ *
+ * @param command The command string to parse
+ * @return AST owned by the caller, or NULL if empty or not parseable
+ */
+node_t *parse_command_silently(const char *command) {
+    if (!ensure_global_executor()) {
+        return NULL;
+    }
+    return executor_parse_command_line(global_executor, command);
+}
+
 /**
  * @brief Get the global executor instance
  *
@@ -8,6 +8,7 @@
  */
 
 #include "lush_plugin.h"
+#include "builtins.h"
 #include "shell_mode.h"
 
 #include <dlfcn.h>
@@ -39,24 +40,27 @@ static char *safe_strdup(const char *s) {
 }
 
 /**
- * @brief Set plugin error message
+ * @brief Free a plugin that failed to load or has been unloaded
+ *
+ * Removes any builtins it registered from the shell, closes its shared
+ * object (static plugins have none) and frees the instance.
  */
-static void set_plugin_error(lush_plugin_t *plugin, const char *fmt, ...) {
-    if (!plugin) return;
-    
+static void plugin_discard(lush_plugin_t *plugin) {
+    if (plugin->registered_builtins) {
+        for (size_t i = 0; i < plugin->registered_builtin_count; i++) {
+            builtin_unregister(plugin->registered_builtins[i]);
+            free(plugin->registered_builtins[i]);
+        }
+        free(plugin->registered_builtins);
+    }
+
+    free(plugin->ctx);
+    if (plugin->handle) {
+        dlclose(plugin->handle);
+    }
+    free(plugin->path);
     free(plugin->error_message);
-    plugin->error_message = NULL;
-    
-    if (!fmt) return;
-    
-    va_list args;
-    va_start(args, fmt);
-    
-    char buf[512];
-    vsnprintf(buf, sizeof(buf), fmt, args);
-    plugin->error_message = safe_strdup(buf);
-    
-    va_end(args);
+    free(plugin);
 }
 
 /* ============================================================================
@@ -170,27 +174,7 @@ void lush_plugin_manager_destroy(lush_plugin_manager_t *manager) {
             plugin->def->cleanup(plugin->ctx);
         }
         
-        /* Free registered builtins list */
-        if (plugin->registered_builtins) {
-            for (size_t i = 0; i < plugin->registered_builtin_count; i++) {
-                free(plugin->registered_builtins[i]);
-            }
-            free(plugin->registered_builtins);
-        }
-        
-        /* Free context */
-        free(plugin->ctx);
-        
-        /* Close shared object */
-        if (plugin->handle) {
-            dlclose(plugin->handle);
-        }
-        
-        /* Free plugin data */
-        free(plugin->path);
-        free(plugin->error_message);
-        free(plugin);
-        
+        plugin_discard(plugin);
         plugin = next;
     }
     
@@ -211,97 +195,40 @@ void lush_plugin_manager_set_symtable(lush_plugin_manager_t *manager,
     }
 }
 
-lush_plugin_result_t
-lush_plugin_manager_load(lush_plugin_manager_t *manager,
-                           const char *path,
-                           lush_plugin_t **out_plugin) {
-    if (!manager || !path) {
-        return LUSH_PLUGIN_ERROR;
-    }
-    
-    if (!manager->active) {
-        return LUSH_PLUGIN_ERROR;
-    }
-    
-    /* Check plugin limit */
-    if (manager->config.max_plugins > 0 &&
-        manager->plugin_count >= manager->config.max_plugins) {
-        return LUSH_PLUGIN_ERROR;
-    }
-    
-    /* Allocate plugin structure */
-    lush_plugin_t *plugin = calloc(1, sizeof(lush_plugin_t));
-    if (!plugin) {
-        return LUSH_PLUGIN_ERROR_OUT_OF_MEMORY;
-    }
-    
-    plugin->state = LUSH_PLUGIN_STATE_LOADING;
-    plugin->path = safe_strdup(path);
-    if (!plugin->path) {
-        free(plugin);
-        return LUSH_PLUGIN_ERROR_OUT_OF_MEMORY;
-    }
-    
-    /* Open shared object */
-    plugin->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
-    if (!plugin->handle) {
-        set_plugin_error(plugin, "dlopen failed: %s", dlerror());
-        plugin->state = LUSH_PLUGIN_STATE_ERROR;
-        free(plugin->path);
-        free(plugin->error_message);
-        free(plugin);
-        return LUSH_PLUGIN_ERROR_LOAD_FAILED;
-    }
-    
-    /* Find plugin definition symbol */
-    dlerror(); /* Clear any existing error */
-    const lush_plugin_def_t *def = 
-        (const lush_plugin_def_t *)dlsym(plugin->handle, LUSH_PLUGIN_SYMBOL);
-    char *error = dlerror();
-    if (error || !def) {
-        set_plugin_error(plugin, "Symbol '%s' not found: %s", 
-                        LUSH_PLUGIN_SYMBOL, error ? error : "NULL definition");
-        plugin->state = LUSH_PLUGIN_STATE_ERROR;
-        dlclose(plugin->handle);
-        free(plugin->path);
-        free(plugin->error_message);
-        free(plugin);
-        return LUSH_PLUGIN_ERROR_SYMBOL_NOT_FOUND;
-    }
-    
+/**
+ * @brief Validate, initialize and register a plugin definition
+ *
+ * Shared by shared-object and static plugins. On failure the plugin is
+ * discarded.
+ *
+ * @param manager Plugin manager
+ * @param plugin Plugin instance with path and handle set
+ * @param def Plugin definition
+ * @param permissions Permissions available to the plugin
+ * @param out_plugin Output pointer for loaded plugin (optional)
+ * @return LUSH_PLUGIN_OK on success
+ */
+static lush_plugin_result_t
+plugin_activate(lush_plugin_manager_t *manager, lush_plugin_t *plugin,
+                const lush_plugin_def_t *def,
+                lush_plugin_permission_t permissions,
+                lush_plugin_t **out_plugin) {
     /* Validate plugin definition */
     if (!def->name || !def->version || !def->init) {
-        set_plugin_error(plugin, "Invalid plugin: missing required fields");
-        plugin->state = LUSH_PLUGIN_STATE_ERROR;
-        dlclose(plugin->handle);
-        free(plugin->path);
-        free(plugin->error_message);
-        free(plugin);
+        plugin_discard(plugin);
         return LUSH_PLUGIN_ERROR_INVALID_PLUGIN;
     }
     
     /* Check API version */
     if (def->api_version < LUSH_PLUGIN_API_VERSION_MIN ||
         def->api_version > LUSH_PLUGIN_API_VERSION) {
-        set_plugin_error(plugin, "API version %u not supported (need %u-%u)",
-                        def->api_version, LUSH_PLUGIN_API_VERSION_MIN,
-                        LUSH_PLUGIN_API_VERSION);
-        plugin->state = LUSH_PLUGIN_STATE_ERROR;
-        dlclose(plugin->handle);
-        free(plugin->path);
-        free(plugin->error_message);
-        free(plugin);
+        plugin_discard(plugin);
         return LUSH_PLUGIN_ERROR_VERSION_MISMATCH;
     }
     
     /* Check if already loaded */
     if (lush_plugin_manager_find(manager, def->name)) {
-        set_plugin_error(plugin, "Plugin '%s' already loaded", def->name);
-        plugin->state = LUSH_PLUGIN_STATE_ERROR;
-        dlclose(plugin->handle);
-        free(plugin->path);
-        free(plugin->error_message);
-        free(plugin);
+        plugin_discard(plugin);
         return LUSH_PLUGIN_ERROR_ALREADY_LOADED;
     }
     
@@ -312,9 +239,7 @@ lush_plugin_manager_load(lush_plugin_manager_t *manager,
     /* Create plugin context */
     plugin->ctx = calloc(1, sizeof(lush_plugin_context_t));
     if (!plugin->ctx) {
-        dlclose(plugin->handle);
-        free(plugin->path);
-        free(plugin);
+        plugin_discard(plugin);
         return LUSH_PLUGIN_ERROR_OUT_OF_MEMORY;
     }
     
@@ -324,43 +249,22 @@ lush_plugin_manager_load(lush_plugin_manager_t *manager,
     plugin->ctx->symtable = manager->symtable;
     plugin->ctx->user_data = NULL;
     
-    /* Grant permissions (intersection of required and default) */
-    plugin->ctx->granted_permissions = 
-        def->required_permissions & manager->config.default_permissions;
+    /* Grant permissions (intersection of required and available) */
+    plugin->ctx->granted_permissions =
+        def->required_permissions & permissions;
     
     /* Check if all required permissions are granted */
     if ((plugin->ctx->granted_permissions & def->required_permissions) != 
         def->required_permissions) {
-        set_plugin_error(plugin, "Required permissions not granted");
-        plugin->state = LUSH_PLUGIN_STATE_ERROR;
-        free(plugin->ctx);
-        dlclose(plugin->handle);
-        free(plugin->path);
-        free(plugin->error_message);
-        free(plugin);
+        plugin_discard(plugin);
         return LUSH_PLUGIN_ERROR_PERMISSION_DENIED;
     }
     
-    /* Initialize plugin */
+    /* Initialize plugin; builtins it registered are removed on failure */
     plugin->state = LUSH_PLUGIN_STATE_INITIALIZING;
     int init_result = def->init(plugin->ctx);
     if (init_result != 0) {
-        set_plugin_error(plugin, "init() returned %d", init_result);
-        plugin->state = LUSH_PLUGIN_STATE_ERROR;
-        
-        /* Free registered builtins */
-        if (plugin->registered_builtins) {
-            for (size_t i = 0; i < plugin->registered_builtin_count; i++) {
-                free(plugin->registered_builtins[i]);
-            }
-            free(plugin->registered_builtins);
-        }
-        
-        free(plugin->ctx);
-        dlclose(plugin->handle);
-        free(plugin->path);
-        free(plugin->error_message);
-        free(plugin);
+        plugin_discard(plugin);
         return LUSH_PLUGIN_ERROR_INIT_FAILED;
     }
     
@@ -378,6 +282,92 @@ lush_plugin_manager_load(lush_plugin_manager_t *manager,
     return LUSH_PLUGIN_OK;
 }
 
+lush_plugin_result_t
+lush_plugin_manager_load(lush_plugin_manager_t *manager,
+                           const char *path,
+                           lush_plugin_t **out_plugin) {
+    if (!manager || !path) {
+        return LUSH_PLUGIN_ERROR;
+    }
+    
+    if (!manager->active) {
+        return LUSH_PLUGIN_ERROR;
+    }
+    
+    /* Check plugin limit */
+    if (manager->config.max_plugins > 0 &&
+        manager->plugin_count >= manager->config.max_plugins) {
+        return LUSH_PLUGIN_ERROR;
+    }
+    
+    /* Allocate plugin structure */
+    lush_plugin_t *plugin = calloc(1, sizeof(lush_plugin_t));
+    if (!plugin) {
+        return LUSH_PLUGIN_ERROR_OUT_OF_MEMORY;
+    }
+    
+    plugin->state = LUSH_PLUGIN_STATE_LOADING;
+    plugin->path = safe_strdup(path);
+    if (!plugin->path) {
+        free(plugin);
+        return LUSH_PLUGIN_ERROR_OUT_OF_MEMORY;
+    }
+    
+    /* Open shared object */
+    plugin->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!plugin->handle) {
+        plugin_discard(plugin);
+        return LUSH_PLUGIN_ERROR_LOAD_FAILED;
+    }
+    
+    /* Find plugin definition symbol */
+    dlerror(); /* Clear any existing error */
+    const lush_plugin_def_t *def = 
+        (const lush_plugin_def_t *)dlsym(plugin->handle, LUSH_PLUGIN_SYMBOL);
+    char *error = dlerror();
+    if (error || !def) {
+        plugin_discard(plugin);
+        return LUSH_PLUGIN_ERROR_SYMBOL_NOT_FOUND;
+    }
+    
+    return plugin_activate(manager, plugin, def,
+                           manager->config.default_permissions, out_plugin);
+}
+
+lush_plugin_result_t
+lush_plugin_manager_load_static(lush_plugin_manager_t *manager,
+                                  const lush_plugin_def_t *def,
+                                  lush_plugin_t **out_plugin) {
+    if (!manager || !def || !manager->active) {
+        return LUSH_PLUGIN_ERROR;
+    }
+    
+    if (manager->config.max_plugins > 0 &&
+        manager->plugin_count >= manager->config.max_plugins) {
+        return LUSH_PLUGIN_ERROR;
+    }
+    
+    lush_plugin_t *plugin = calloc(1, sizeof(lush_plugin_t));
+    if (!plugin) {
+        return LUSH_PLUGIN_ERROR_OUT_OF_MEMORY;
+    }
+    
+    plugin->state = LUSH_PLUGIN_STATE_LOADING;
+    
+    /* Static plugins ship with the shell and are trusted */
+    return plugin_activate(manager, plugin, def, LUSH_PLUGIN_PERM_ALL,
+                           out_plugin);
+}
+
+lush_plugin_manager_t *lush_plugin_shell_manager(void) {
+    static lush_plugin_manager_t *shell_manager = NULL;
+    if (!shell_manager &&
+        lush_plugin_manager_create(&shell_manager, NULL) != LUSH_PLUGIN_OK) {
+        shell_manager = NULL;
+    }
+    return shell_manager;
+}
+
 lush_plugin_result_t
 lush_plugin_manager_load_by_name(lush_plugin_manager_t *manager,
                                    const char *name,
@@ -464,26 +454,8 @@ lush_plugin_manager_unload(lush_plugin_manager_t *manager,
     }
     manager->plugin_count--;
     
-    /* Free registered builtins */
-    if (plugin->registered_builtins) {
-        for (size_t i = 0; i < plugin->registered_builtin_count; i++) {
-            free(plugin->registered_builtins[i]);
-        }
-        free(plugin->registered_builtins);
-    }
-    
-    /* Free context */
-    free(plugin->ctx);
-    
-    /* Close shared object */
-    if (plugin->handle) {
-        dlclose(plugin->handle);
-    }
-    
-    /* Free plugin data */
-    free(plugin->path);
-    free(plugin->error_message);
-    free(plugin);
+    /* Remove its builtins and free it */
+    plugin_discard(plugin);
     
     return LUSH_PLUGIN_OK;
 }
@@ -589,22 +561,24 @@ lush_plugin_register_builtin(lush_plugin_context_t *ctx,
     if (!new_builtins) {
         return LUSH_PLUGIN_ERROR_OUT_OF_MEMORY;
     }
+    plugin->registered_builtins = new_builtins;
     
-    new_builtins[plugin->registered_builtin_count] = safe_strdup(name);
-    if (!new_builtins[plugin->registered_builtin_count]) {
+    char *tracked = safe_strdup(name);
+    if (!tracked) {
         return LUSH_PLUGIN_ERROR_OUT_OF_MEMORY;
     }
     
-    plugin->registered_builtins = new_builtins;
-    plugin->registered_builtin_count = new_count;
+    /* Add to the shell's builtin table; core builtins cannot be replaced */
+    const char *doc = plugin->def && plugin->def->description
+                          ? plugin->def->description
+                          : "plugin builtin";
+    if (builtin_register(name, doc, fn) != 0) {
+        free(tracked);
+        return LUSH_PLUGIN_ERROR;
+    }
     
-    /* NOTE: Actual registration with the shell's builtin system
-     * would be implemented here. For the foundation, we just track
-     * what builtins the plugin wants to register.
-     * 
-     * Future integration:
-     * return register_plugin_builtin(ctx->executor, name, fn);
-     */
+    new_builtins[plugin->registered_builtin_count] = tracked;
+    plugin->registered_builtin_count = new_count;
     
     return LUSH_PLUGIN_OK;
 }
@@ -625,6 +599,7 @@ lush_plugin_unregister_builtin(lush_plugin_context_t *ctx,
     for (size_t i = 0; i < plugin->registered_builtin_count; i++) {
         if (plugin->registered_builtins[i] &&
             strcmp(plugin->registered_builtins[i], name) == 0) {
+            builtin_unregister(name);
             free(plugin->registered_builtins[i]);
             /* Move last element to this position */
             plugin->registered_builtins[i] = 
@@ -634,8 +609,6 @@ lush_plugin_unregister_builtin(lush_plugin_context_t *ctx,
         }
     }
     
-    /* NOTE: Actual unregistration would happen here */
-    
     return LUSH_PLUGIN_OK;
 }
 
@@ -0,0 +1,723 @@
+/**
+ * @file memo.c
+ * @brief In-memory cache of command output for the memo builtin
+ *
+ * Entries live in a chained hash table keyed by the command line plus the
+ * names of the variables and files the call depends on, and on a doubly
+ * linked list in least-recently-used order. Both the number of entries and
+ * the total size of cached output are capped; the least recently used
+ * entries are evicted to stay within them.
+ *
+ * Commands run in a forked child so functions, aliases and builtins behave
+ * exactly as they do at the prompt, and so a command cannot change the
+ * shell's own state. Foreground runs capture output through a pipe.
+ * Background refreshes write to an unlinked temporary file instead, so the
+ * child never blocks on a full pipe while the shell sits at the prompt; the
+ * file is read back once the child has been reaped.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "memo.h"
+
+#include "executor.h"
+#include "ht.h"
+#include "lush.h"
+#include "symtable.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/** Number of hash buckets (power of two) */
+#define MEMO_BUCKETS 256
+
+/**
+ * @brief One cached command
+ */
+typedef struct memo_entry {
+    char *key;       /**< argv, variable and file names, NUL separated */
+    size_t key_len;  /**< Length of key including separators */
+    uint64_t hash;   /**< Hash of key */
+    char *stamp;     /**< Dependency values and mtimes when computed */
+    size_t stamp_len;
+    char *output;    /**< Cached standard output */
+    size_t output_len;
+    int status;      /**< Cached exit status */
+    double stored;   /**< Monotonic time the output was computed */
+
+    pid_t refresh_pid;   /**< Background refresh in progress, or 0 */
+    int refresh_fd;      /**< File the refresh writes to, or -1 */
+    char *refresh_stamp; /**< Stamp the refresh was started with */
+    size_t refresh_stamp_len;
+
+    struct memo_entry *chain; /**< Next entry in the hash bucket */
+    struct memo_entry *prev;  /**< More recently used entry */
+    struct memo_entry *next;  /**< Less recently used entry */
+} memo_entry_t;
+
+/** Hash buckets */
+static memo_entry_t *buckets[MEMO_BUCKETS];
+
+/** Most and least recently used entries */
+static memo_entry_t *lru_head = NULL;
+static memo_entry_t *lru_tail = NULL;
+
+/** Counters, including the current entry count and byte total */
+static memo_stats_t stats;
+
+/** Limits */
+static size_t max_entries = MEMO_DEFAULT_MAX_ENTRIES;
+static size_t max_bytes = MEMO_DEFAULT_MAX_BYTES;
+
+/* ============================================================================
+ * Growable byte buffer
+ * ============================================================================ */
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+    bool failed;
+} membuf_t;
+
+static void membuf_append(membuf_t *b, const void *data, size_t len) {
+    if (b->failed) {
+        return;
+    }
+    if (b->len + len + 1 > b->cap) {
+        size_t cap = b->cap ? b->cap : 256;
+        while (b->len + len + 1 > cap) {
+            cap *= 2;
+        }
+        char *grown = realloc(b->data, cap);
+        if (!grown) {
+            b->failed = true;
+            return;
+        }
+        b->data = grown;
+        b->cap = cap;
+    }
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+    b->data[b->len] = '\0';
+}
+
+static void membuf_append_str(membuf_t *b, const char *s) {
+    /* Include the terminator so adjacent fields cannot run together */
+    membuf_append(b, s, strlen(s) + 1);
+}
+
+/* ============================================================================
+ * Keys and dependency stamps
+ * ============================================================================ */
+
+/**
+ * @brief Build the identity of a call
+ *
+ * Sections are told apart by a marker byte so "memo -k X cmd" and
+ * "memo cmd X" do not collide.
+ */
+static void build_key(membuf_t *b, int argc, char *const *argv,
+                      const memo_options_t *opts) {
+    for (int i = 0; i < argc; i++) {
+        membuf_append_str(b, argv[i]);
+    }
+    for (size_t i = 0; i < opts->var_count; i++) {
+        membuf_append(b, "\001", 1);
+        membuf_append_str(b, opts->vars[i]);
+    }
+    for (size_t i = 0; i < opts->file_count; i++) {
+        membuf_append(b, "\002", 1);
+        membuf_append_str(b, opts->files[i]);
+    }
+}
+
+/**
+ * @brief Record the current state of the call's dependencies
+ *
+ * Unset variables and missing files get their own markers so that
+ * creating an empty variable or file still counts as a change.
+ */
+static void build_stamp(membuf_t *b, const memo_options_t *opts) {
+    for (size_t i = 0; i < opts->var_count; i++) {
+        char *value = symtable_get_global(opts->vars[i]);
+        if (value) {
+            membuf_append(b, "=", 1);
+            membuf_append_str(b, value);
+            free(value);
+        } else {
+            membuf_append(b, "-", 1);
+        }
+    }
+    for (size_t i = 0; i < opts->file_count; i++) {
+        struct stat st;
+        char field[96];
+        if (stat(opts->files[i], &st) == 0) {
+            snprintf(field, sizeof(field), "%lld.%09ld:%lld:%llu",
+                     (long long)st.st_mtim.tv_sec, (long)st.st_mtim.tv_nsec,
+                     (long long)st.st_size, (unsigned long long)st.st_ino);
+        } else {
+            snprintf(field, sizeof(field), "missing");
+        }
+        membuf_append_str(b, field);
+    }
+}
+
+static double monotonic_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* ============================================================================
+ * Table and LRU list
+ * ============================================================================ */
+
+static void lru_unlink(memo_entry_t *e) {
+    if (e->prev) {
+        e->prev->next = e->next;
+    } else {
+        lru_head = e->next;
+    }
+    if (e->next) {
+        e->next->prev = e->prev;
+    } else {
+        lru_tail = e->prev;
+    }
+    e->prev = e->next = NULL;
+}
+
+static void lru_push_front(memo_entry_t *e) {
+    e->prev = NULL;
+    e->next = lru_head;
+    if (lru_head) {
+        lru_head->prev = e;
+    }
+    lru_head = e;
+    if (!lru_tail) {
+        lru_tail = e;
+    }
+}
+
+static memo_entry_t *table_find(const char *key, size_t key_len,
+                                uint64_t hash) {
+    for (memo_entry_t *e = buckets[hash & (MEMO_BUCKETS - 1)]; e;
+         e = e->chain) {
+        if (e->hash == hash && e->key_len == key_len &&
+            memcmp(e->key, key, key_len) == 0) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Abandon a background refresh
+ *
+ * A refresh still running is killed along with its process group and
+ * reaped, so superseded refreshes neither linger nor leave zombies.
+ */
+static void refresh_abandon(memo_entry_t *e) {
+    if (e->refresh_fd >= 0) {
+        close(e->refresh_fd);
+    }
+    if (e->refresh_pid > 0) {
+        kill(-e->refresh_pid, SIGKILL);
+        kill(e->refresh_pid, SIGKILL);
+        while (executor_reap_child(get_global_executor(), e->refresh_pid,
+                                   NULL, 0) < 0 &&
+               errno == EINTR)
+            ;
+    }
+    free(e->refresh_stamp);
+    e->refresh_pid = 0;
+    e->refresh_fd = -1;
+    e->refresh_stamp = NULL;
+    e->refresh_stamp_len = 0;
+}
+
+static void entry_remove(memo_entry_t *e) {
+    memo_entry_t **link = &buckets[e->hash & (MEMO_BUCKETS - 1)];
+    while (*link && *link != e) {
+        link = &(*link)->chain;
+    }
+    if (*link) {
+        *link = e->chain;
+    }
+    lru_unlink(e);
+    refresh_abandon(e);
+
+    stats.entries--;
+    stats.bytes -= e->output_len;
+    free(e->key);
+    free(e->stamp);
+    free(e->output);
+    free(e);
+}
+
+/**
+ * @brief Evict least recently used entries until within the limits
+ *
+ * @param keep Entry that must not be evicted (may be NULL)
+ */
+static void enforce_limits(memo_entry_t *keep) {
+    memo_entry_t *e = lru_tail;
+    while (e && (stats.entries > max_entries || stats.bytes > max_bytes)) {
+        memo_entry_t *prev = e->prev;
+        if (e != keep) {
+            entry_remove(e);
+            stats.evictions++;
+        }
+        e = prev;
+    }
+}
+
+/**
+ * @brief Replace an entry's output
+ *
+ * Takes ownership of @p output and @p stamp.
+ */
+static void entry_store(memo_entry_t *e, char *output, size_t output_len,
+                        int status, char *stamp, size_t stamp_len) {
+    stats.bytes -= e->output_len;
+    free(e->output);
+    free(e->stamp);
+    e->output = output;
+    e->output_len = output_len;
+    e->stamp = stamp;
+    e->stamp_len = stamp_len;
+    e->status = status;
+    e->stored = monotonic_now();
+    stats.bytes += output_len;
+}
+
+/* ============================================================================
+ * Running commands
+ * ============================================================================ */
+
+/**
+ * @brief Quote argv back into a command line for the shell's parser
+ */
+static char *quote_command(int argc, char *const *argv) {
+    membuf_t b = {0};
+    for (int i = 0; i < argc; i++) {
+        if (i > 0) {
+            membuf_append(&b, " ", 1);
+        }
+        membuf_append(&b, "'", 1);
+        for (const char *p = argv[i]; *p; p++) {
+            if (*p == '\'') {
+                membuf_append(&b, "'\\''", 4);
+            } else {
+                membuf_append(&b, p, 1);
+            }
+        }
+        membuf_append(&b, "'", 1);
+    }
+    if (b.failed) {
+        free(b.data);
+        return NULL;
+    }
+    return b.data;
+}
+
+/**
+ * @brief Child side of a run: execute the command and exit
+ *
+ * Runs through the shell's executor when there is one so functions and
+ * builtins work; otherwise falls back to execvp.
+ */
+static void run_child(int argc, char *const *argv) {
+    executor_t *executor = get_global_executor();
+    if (executor) {
+        char *line = quote_command(argc, argv);
+        int status = line ? executor_execute_command_line(executor, line)
+                          : 126;
+        fflush(stdout);
+        _exit(status);
+    }
+    execvp(argv[0], argv);
+    fprintf(stderr, "memo: %s: %s\n", argv[0], strerror(errno));
+    _exit(errno == ENOENT ? 127 : 126);
+}
+
+static int decode_status(int status) {
+    if (WIFEXITED(status)) {
+        return WEXITSTATUS(status);
+    }
+    if (WIFSIGNALED(status)) {
+        return 128 + WTERMSIG(status);
+    }
+    return 1;
+}
+
+/**
+ * @brief Run a command in the foreground and capture its output
+ *
+ * @param output Output: captured bytes (caller frees)
+ * @param output_len Output: number of bytes
+ * @return Exit status, or -1 if the command could not be started
+ */
+static int run_capture(int argc, char *const *argv, char **output,
+                       size_t *output_len) {
+    int pipefd[2];
+    if (pipe(pipefd) < 0) {
+        return -1;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(pipefd[0]);
+        close(pipefd[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        close(pipefd[0]);
+        dup2(pipefd[1], STDOUT_FILENO);
+        close(pipefd[1]);
+        run_child(argc, argv);
+    }
+
+    close(pipefd[1]);
+    membuf_t b = {0};
+    char chunk[4096];
+    for (;;) {
+        ssize_t n = read(pipefd[0], chunk, sizeof(chunk));
+        if (n > 0) {
+            membuf_append(&b, chunk, (size_t)n);
+        } else if (n == 0 || errno != EINTR) {
+            break;
+        }
+    }
+    close(pipefd[0]);
+
+    int status = 0;
+    while (executor_reap_child(get_global_executor(), pid, &status, 0) < 0 &&
+           errno == EINTR)
+        ;
+
+    if (b.failed) {
+        free(b.data);
+        b.data = NULL;
+        b.len = 0;
+    }
+    *output = b.data;
+    *output_len = b.len;
+    return decode_status(status);
+}
+
+/**
+ * @brief Start a background refresh for an entry
+ *
+ * Takes ownership of @p stamp.
+ *
+ * @return true if the refresh was started
+ */
+static bool refresh_start(memo_entry_t *e, int argc, char *const *argv,
+                          char *stamp, size_t stamp_len) {
+    const char *tmpdir = getenv("TMPDIR");
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/lush-memo-XXXXXX",
+             tmpdir && *tmpdir ? tmpdir : "/tmp");
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        free(stamp);
+        return false;
+    }
+    unlink(path);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fd);
+        free(stamp);
+        return false;
+    }
+    if (pid == 0) {
+        /* Own process group so ^C at the prompt does not reach it */
+        setpgid(0, 0);
+        signal(SIGINT, SIG_DFL);
+        signal(SIGQUIT, SIG_DFL);
+        int devnull = open("/dev/null", O_RDWR);
+        if (devnull >= 0) {
+            dup2(devnull, STDIN_FILENO);
+            dup2(devnull, STDERR_FILENO);
+            close(devnull);
+        }
+        dup2(fd, STDOUT_FILENO);
+        close(fd);
+        run_child(argc, argv);
+    }
+
+    e->refresh_pid = pid;
+    e->refresh_fd = fd;
+    e->refresh_stamp = stamp;
+    e->refresh_stamp_len = stamp_len;
+    stats.refreshes++;
+    return true;
+}
+
+/**
+ * @brief Install the result of a finished refresh
+ *
+ * @return true if the refresh has finished (successfully or not)
+ */
+static bool refresh_collect(memo_entry_t *e) {
+    int status;
+    pid_t r = executor_reap_child(get_global_executor(), e->refresh_pid,
+                                  &status, WNOHANG);
+    if (r == 0) {
+        return false;
+    }
+    if (r < 0) {
+        /* Reaped elsewhere; the exit status is lost, so discard it */
+        e->refresh_pid = 0;
+        refresh_abandon(e);
+        return true;
+    }
+    e->refresh_pid = 0;
+
+    membuf_t b = {0};
+    char chunk[4096];
+    if (lseek(e->refresh_fd, 0, SEEK_SET) == 0) {
+        ssize_t n;
+        while ((n = read(e->refresh_fd, chunk, sizeof(chunk))) > 0) {
+            membuf_append(&b, chunk, (size_t)n);
+        }
+    }
+
+    if (!b.failed) {
+        char *stamp = e->refresh_stamp;
+        e->refresh_stamp = NULL;
+        entry_store(e, b.data, b.len, decode_status(status), stamp,
+                    e->refresh_stamp_len);
+    } else {
+        free(b.data);
+    }
+    refresh_abandon(e);
+    return true;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void memo_poll(void) {
+    memo_entry_t *e = lru_head;
+    while (e) {
+        memo_entry_t *next = e->next;
+        if (e->refresh_pid > 0) {
+            refresh_collect(e);
+        }
+        e = next;
+    }
+    /* Evict only after the walk so no entry is freed under it */
+    enforce_limits(NULL);
+}
+
+int memo_run(int argc, char *const *argv, const memo_options_t *opts,
+             FILE *out) {
+    static const memo_options_t defaults = {0};
+    if (!opts) {
+        opts = &defaults;
+    }
+    if (argc <= 0 || !argv || !argv[0]) {
+        return 0;
+    }
+
+    memo_poll();
+
+    membuf_t key = {0};
+    membuf_t stamp = {0};
+    build_key(&key, argc, argv, opts);
+    build_stamp(&stamp, opts);
+    if (key.failed || stamp.failed) {
+        free(key.data);
+        free(stamp.data);
+        return 126;
+    }
+
+    uint64_t hash = fnv1a_hash_bytes(key.data, key.len, FNV1A_OFFSET);
+    memo_entry_t *e = table_find(key.data, key.len, hash);
+
+    if (e && (e->stamp_len != stamp.len ||
+              memcmp(e->stamp, stamp.data, stamp.len) != 0)) {
+        /* A dependency changed: the cached output no longer applies */
+        entry_remove(e);
+        stats.invalidations++;
+        e = NULL;
+    }
+
+    if (e) {
+        lru_unlink(e);
+        lru_push_front(e);
+        bool expired =
+            opts->ttl > 0 && monotonic_now() - e->stored >= opts->ttl;
+
+        if (!expired || opts->async) {
+            if (!expired) {
+                stats.hits++;
+            } else {
+                stats.stale_hits++;
+                if (e->refresh_pid == 0) {
+                    refresh_start(e, argc, argv, stamp.data, stamp.len);
+                    stamp.data = NULL;
+                }
+            }
+            fwrite(e->output, 1, e->output_len, out);
+            fflush(out);
+            free(key.data);
+            free(stamp.data);
+            return e->status;
+        }
+    }
+
+    stats.misses++;
+    char *output = NULL;
+    size_t output_len = 0;
+    int status = run_capture(argc, argv, &output, &output_len);
+    if (status < 0) {
+        free(key.data);
+        free(stamp.data);
+        return 126;
+    }
+    if (output_len > 0) {
+        fwrite(output, 1, output_len, out);
+        fflush(out);
+    }
+
+    if (output_len > max_bytes) {
+        /* Too large to ever fit; drop any older copy and do not cache */
+        if (e) {
+            entry_remove(e);
+        }
+        free(output);
+        free(key.data);
+        free(stamp.data);
+        return status;
+    }
+
+    if (!e) {
+        e = calloc(1, sizeof(*e));
+        if (!e) {
+            free(output);
+            free(key.data);
+            free(stamp.data);
+            return status;
+        }
+        e->key = key.data;
+        e->key_len = key.len;
+        e->hash = hash;
+        e->refresh_fd = -1;
+        key.data = NULL;
+
+        memo_entry_t **bucket = &buckets[hash & (MEMO_BUCKETS - 1)];
+        e->chain = *bucket;
+        *bucket = e;
+        lru_push_front(e);
+        stats.entries++;
+    } else {
+        /* A synchronous run supersedes any refresh still in flight */
+        refresh_abandon(e);
+    }
+
+    entry_store(e, output, output_len, status, stamp.data, stamp.len);
+    enforce_limits(e);
+    free(key.data);
+    return status;
+}
+
+size_t memo_clear(int argc, char *const *argv) {
+    size_t dropped = 0;
+    memo_entry_t *e = lru_head;
+
+    /* The command line is the key's prefix, up to the first marker */
+    membuf_t prefix = {0};
+    for (int i = 0; i < argc; i++) {
+        membuf_append_str(&prefix, argv[i]);
+    }
+    if (prefix.failed) {
+        free(prefix.data);
+        return 0;
+    }
+
+    while (e) {
+        memo_entry_t *next = e->next;
+        bool match = argc <= 0;
+        if (!match && e->key_len >= prefix.len &&
+            memcmp(e->key, prefix.data, prefix.len) == 0) {
+            match = e->key_len == prefix.len || e->key[prefix.len] == '\001' ||
+                    e->key[prefix.len] == '\002';
+        }
+        if (match) {
+            entry_remove(e);
+            dropped++;
+        }
+        e = next;
+    }
+    free(prefix.data);
+    return dropped;
+}
+
+void memo_list(FILE *out) {
+    double now = monotonic_now();
+    for (memo_entry_t *e = lru_head; e; e = e->next) {
+        fprintf(out, "%6.0fs %3d %8zu%s ", now - e->stored, e->status,
+                e->output_len, e->refresh_pid > 0 ? "*" : " ");
+        /* Print argv space separated; stop at the dependency names */
+        bool first = true;
+        for (size_t i = 0; i < e->key_len;) {
+            const char *field = e->key + i;
+            size_t len = strlen(field);
+            if (field[0] == '\001' || field[0] == '\002') {
+                fprintf(out, " [%s%s]", field[0] == '\001' ? "$" : "",
+                        field + 1);
+            } else {
+                fprintf(out, "%s%s", first ? "" : " ", field);
+            }
+            first = false;
+            i += len + 1;
+        }
+        fputc('\n', out);
+    }
+}
+
+void memo_get_stats(memo_stats_t *out) {
+    if (out) {
+        *out = stats;
+    }
+}
+
+void memo_reset_stats(void) {
+    size_t entries = stats.entries;
+    size_t bytes = stats.bytes;
+    memset(&stats, 0, sizeof(stats));
+    stats.entries = entries;
+    stats.bytes = bytes;
+}
+
+void memo_set_limits(size_t entries, size_t bytes) {
+    max_entries = entries ? entries : MEMO_DEFAULT_MAX_ENTRIES;
+    max_bytes = bytes ? bytes : MEMO_DEFAULT_MAX_BYTES;
+    enforce_limits(NULL);
+}
+
+void memo_cleanup(void) {
+    while (lru_head) {
+        entry_remove(lru_head);
+    }
+    memset(&stats, 0, sizeof(stats));
+}
@@ -13,6 +13,7 @@
 #include "node.h"
 
 #include "errors.h"
+#include "extended_test.h"
 #include "shell_error.h"
 #include "strings.h"
 
@@ -151,5 +152,7 @@ void free_node_tree(node_t *node) {
         free(node->val.str);
     }
 
+    extended_test_free(node->compiled);
+
     free(node);
 }
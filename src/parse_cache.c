@@ -0,0 +1,295 @@
+/**
+ * @file parse_cache.c
+ * @brief Cache of parsed command strings
+ *
+ * Entries live in a chained hash table keyed by a hash of the text, the
+ * source name and the parser feature mask, and on a doubly linked list in
+ * least-recently-used order. Each entry is reference counted: the table
+ * itself holds no reference, so an entry dropped from the table (evicted,
+ * cleared, or too large to keep) is freed as soon as nobody holds it.
+ *
+ * The parser records the source name by pointer in every node location;
+ * trees are parsed with the entry's own copy of the name so they never
+ * point into a caller's string.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "parse_cache.h"
+
+#include "ht.h"
+#include "node.h"
+#include "parser.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Number of hash buckets (power of two) */
+#define PARSE_CACHE_BUCKETS 256
+
+/**
+ * @brief One parsed string
+ */
+struct parse_cache_entry {
+    char *text;        /**< Command string */
+    size_t text_len;   /**< Length of text */
+    char *source;      /**< Source name the tree's locations point to */
+    uint64_t features; /**< Parser features the text was parsed under */
+    uint64_t hash;     /**< Hash of text, source and features */
+    node_t *tree;      /**< Parsed form */
+    size_t bytes;      /**< Approximate size of the entry */
+    unsigned refs;     /**< Callers holding the entry */
+    bool cached;       /**< Entry is in the table */
+
+    struct parse_cache_entry *chain; /**< Next entry in the hash bucket */
+    struct parse_cache_entry *prev;  /**< More recently used entry */
+    struct parse_cache_entry *next;  /**< Less recently used entry */
+};
+
+/** Hash buckets */
+static parse_cache_entry_t *buckets[PARSE_CACHE_BUCKETS];
+
+/** Most and least recently used entries */
+static parse_cache_entry_t *lru_head = NULL;
+static parse_cache_entry_t *lru_tail = NULL;
+
+/** Counters, including the current entry count and byte total */
+static parse_cache_stats_t stats;
+
+/** Limit on stats.bytes */
+static size_t max_bytes = PARSE_CACHE_DEFAULT_MAX_BYTES;
+
+/* ============================================================================
+ * Keys
+ * ============================================================================ */
+
+/**
+ * @brief Approximate memory held by a sibling chain and its children
+ */
+static size_t tree_bytes(const node_t *node) {
+    size_t bytes = 0;
+    for (; node; node = node->next_sibling) {
+        bytes += sizeof(*node);
+        if (node->val_type == VAL_STR && node->val.str) {
+            bytes += strlen(node->val.str) + 1;
+        }
+        bytes += tree_bytes(node->first_child);
+    }
+    return bytes;
+}
+
+/* ============================================================================
+ * Table and LRU list
+ * ============================================================================ */
+
+static void lru_unlink(parse_cache_entry_t *e) {
+    if (e->prev) {
+        e->prev->next = e->next;
+    } else {
+        lru_head = e->next;
+    }
+    if (e->next) {
+        e->next->prev = e->prev;
+    } else {
+        lru_tail = e->prev;
+    }
+    e->prev = e->next = NULL;
+}
+
+static void lru_push_front(parse_cache_entry_t *e) {
+    e->prev = NULL;
+    e->next = lru_head;
+    if (lru_head) {
+        lru_head->prev = e;
+    }
+    lru_head = e;
+    if (!lru_tail) {
+        lru_tail = e;
+    }
+}
+
+static parse_cache_entry_t *table_find(const char *text, size_t text_len,
+                                       const char *source, uint64_t features,
+                                       uint64_t hash) {
+    for (parse_cache_entry_t *e = buckets[hash & (PARSE_CACHE_BUCKETS - 1)];
+         e; e = e->chain) {
+        if (e->hash == hash && e->features == features &&
+            e->text_len == text_len && memcmp(e->text, text, text_len) == 0 &&
+            strcmp(e->source, source) == 0) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static void entry_free(parse_cache_entry_t *e) {
+    free_node_tree(e->tree);
+    free(e->text);
+    free(e->source);
+    free(e);
+}
+
+/**
+ * @brief Take an entry out of the table
+ *
+ * The entry is freed now if nobody holds it, otherwise on its last
+ * release.
+ */
+static void entry_remove(parse_cache_entry_t *e) {
+    parse_cache_entry_t **link = &buckets[e->hash & (PARSE_CACHE_BUCKETS - 1)];
+    while (*link && *link != e) {
+        link = &(*link)->chain;
+    }
+    if (*link) {
+        *link = e->chain;
+    }
+    lru_unlink(e);
+
+    e->cached = false;
+    stats.entries--;
+    stats.bytes -= e->bytes;
+    if (e->refs == 0) {
+        entry_free(e);
+    }
+}
+
+/**
+ * @brief Evict least recently used entries until within the limit
+ *
+ * @param keep Entry that must not be evicted (may be NULL)
+ */
+static void enforce_limit(parse_cache_entry_t *keep) {
+    parse_cache_entry_t *e = lru_tail;
+    while (e && stats.bytes > max_bytes) {
+        parse_cache_entry_t *prev = e->prev;
+        if (e != keep) {
+            entry_remove(e);
+            stats.evictions++;
+        }
+        e = prev;
+    }
+}
+
+/* ============================================================================
+ * Public interface
+ * ============================================================================ */
+
+parse_cache_entry_t *parse_cache_acquire(const char *text,
+                                         const char *source_name) {
+    if (!text) {
+        return NULL;
+    }
+    const char *source = source_name ? source_name : "<stdin>";
+    size_t text_len = strlen(text);
+    uint64_t features = parser_feature_mask();
+
+    uint64_t hash = fnv1a_hash_bytes(text, text_len, FNV1A_OFFSET);
+    hash = fnv1a_hash_bytes(source, strlen(source) + 1, hash);
+    hash = fnv1a_hash_bytes(&features, sizeof(features), hash);
+
+    parse_cache_entry_t *e =
+        table_find(text, text_len, source, features, hash);
+    if (e) {
+        stats.hits++;
+        e->refs++;
+        lru_unlink(e);
+        lru_push_front(e);
+        return e;
+    }
+
+    stats.misses++;
+    e = calloc(1, sizeof(*e));
+    if (!e) {
+        return NULL;
+    }
+    e->text = malloc(text_len + 1);
+    e->source = strdup(source);
+    if (!e->text || !e->source) {
+        entry_free(e);
+        return NULL;
+    }
+    memcpy(e->text, text, text_len + 1);
+    e->text_len = text_len;
+    e->features = features;
+    e->hash = hash;
+
+    parser_t *parser = parser_new_with_source(e->text, e->source);
+    if (!parser) {
+        entry_free(e);
+        return NULL;
+    }
+    e->tree = parser_parse(parser);
+    bool failed = parser_has_error(parser);
+    parser_free(parser);
+    if (failed || !e->tree) {
+        if (failed) {
+            stats.failures++;
+        }
+        entry_free(e);
+        return NULL;
+    }
+
+    e->refs = 1;
+    e->bytes = sizeof(*e) + text_len + 1 + strlen(source) + 1 +
+               tree_bytes(e->tree);
+    if (e->bytes <= max_bytes) {
+        parse_cache_entry_t **bucket =
+            &buckets[hash & (PARSE_CACHE_BUCKETS - 1)];
+        e->chain = *bucket;
+        *bucket = e;
+        lru_push_front(e);
+        e->cached = true;
+        stats.entries++;
+        stats.bytes += e->bytes;
+        enforce_limit(e);
+    }
+    return e;
+}
+
+node_t *parse_cache_tree(const parse_cache_entry_t *entry) {
+    return entry ? entry->tree : NULL;
+}
+
+void parse_cache_release(parse_cache_entry_t *entry) {
+    if (!entry || entry->refs == 0) {
+        return;
+    }
+    entry->refs--;
+    if (entry->refs == 0 && !entry->cached) {
+        entry_free(entry);
+    }
+}
+
+size_t parse_cache_clear(void) {
+    size_t dropped = 0;
+    while (lru_head) {
+        entry_remove(lru_head);
+        dropped++;
+    }
+    return dropped;
+}
+
+void parse_cache_get_stats(parse_cache_stats_t *out) {
+    if (out) {
+        *out = stats;
+    }
+}
+
+void parse_cache_reset_stats(void) {
+    size_t entries = stats.entries;
+    size_t bytes = stats.bytes;
+    memset(&stats, 0, sizeof(stats));
+    stats.entries = entries;
+    stats.bytes = bytes;
+}
+
+void parse_cache_set_limit(size_t bytes) {
+    max_bytes = bytes;
+    enforce_limit(NULL);
+}
+
+size_t parse_cache_get_limit(void) {
+    return max_bytes;
+}
@@ -12,6 +12,8 @@
 #include "parser.h"
 
 #include "executor.h"
+#include "extended_test.h"
+#include "lush.h"
 #include "node.h"
 #include "shell_mode.h"
 #include "tokenizer.h"
@@ -58,10 +60,9 @@ static node_t *parse_coproc(parser_t *parser);
 // Forward declarations for extended language features (Phase 7: Zsh)
 static node_t *parse_anonymous_function(parser_t *parser);
 
-// Forward declarations for POSIX compliance
-bool is_posix_mode_enabled(void);
 static char *collect_heredoc_content(parser_t *parser, const char *delimiter,
-                                     bool strip_tabs, bool expand_variables);
+                                     size_t search_from, bool strip_tabs,
+                                     bool expand_variables);
 static void set_parser_error(parser_t *parser, const char *message);
 static bool expect_token(parser_t *parser, token_type_t expected);
 
@@ -151,6 +152,24 @@ void parser_free(parser_t *parser) {
  */
 bool parser_has_error(parser_t *parser) { return parser && parser->has_error; }
 
+/**
+ * @brief Get the parser features currently in effect
+ *
+ * @return One bit per shell_feature_t allowed, plus bit 63 for POSIX mode
+ */
+uint64_t parser_feature_mask(void) {
+    uint64_t mask = 0;
+    for (int f = 0; f < FEATURE_COUNT && f < 63; f++) {
+        if (shell_mode_allows((shell_feature_t)f)) {
+            mask |= 1ULL << f;
+        }
+    }
+    if (is_posix_mode_enabled()) {
+        mask |= 1ULL << 63;
+    }
+    return mask;
+}
+
 /**
  * @brief Get the parser error message
  *
@@ -1817,6 +1836,7 @@ static node_t *parse_redirection(parser_t *parser) {
 
     /* Capture location for redirection */
     source_location_t redir_loc = token_to_source_location(redir_token, parser->source_name);
+    size_t redir_pos = redir_token->position;
     node_t *redir_node = new_node_at(node_type, redir_loc);
     if (!redir_node) {
         return NULL;
@@ -1919,8 +1939,8 @@ static node_t *parse_redirection(parser_t *parser) {
 
         // Collect the here document content (this will advance the tokenizer
         // further)
-        char *content = collect_heredoc_content(parser, delimiter, strip_tabs,
-                                                expand_variables);
+        char *content = collect_heredoc_content(
+            parser, delimiter, redir_pos, strip_tabs, expand_variables);
         if (!content) {
             free(delimiter);
             free_node_tree(redir_node);
@@ -2023,12 +2043,14 @@ static node_t *parse_redirection(parser_t *parser) {
  *
  * @param parser Parser instance
  * @param delimiter End delimiter string
+ * @param search_from Input offset of the here-document operator
  * @param strip_tabs If true, strip leading tabs from each line
  * @param expand_variables If true, variables will be expanded during execution
  * @return Collected content string (caller must free)
  */
 static char *collect_heredoc_content(parser_t *parser, const char *delimiter,
-                                     bool strip_tabs, bool expand_variables) {
+                                     size_t search_from, bool strip_tabs,
+                                     bool expand_variables) {
     (void)expand_variables; /* Expansion handled during execution phase */
     if (!parser || !delimiter) {
         return NULL;
@@ -2058,7 +2080,9 @@ static char *collect_heredoc_content(parser_t *parser, const char *delimiter,
 
     (void)strlen(match_delimiter); /* Delimiter matching uses strcmp */
 
-    for (size_t i = 0; i < tokenizer->input_length - 1; i++) {
+    // Start at this redirection's own operator: an earlier here document
+    // with the same delimiter must not be matched again
+    for (size_t i = search_from; i + 1 < tokenizer->input_length; i++) {
         if (tokenizer->input[i] == '<' && tokenizer->input[i + 1] == '<') {
             // Found <<, now check if delimiter follows
             size_t delimiter_pos = i + 2;
@@ -4433,7 +4457,8 @@ static node_t *parse_array_literal(parser_t *parser) {
  * Grammar: [[ conditional_expression ]]
  *
  * @param parser Parser instance
- * @return Extended test AST node with expression in val.str
+ * @return Extended test AST node with expression in val.str and its
+ *         compiled form in compiled
  */
 static node_t *parse_extended_test(parser_t *parser) {
     token_t *current = tokenizer_current(parser->tokenizer);
@@ -4533,11 +4558,18 @@ static node_t *parse_extended_test(parser_t *parser) {
                   expr[expr_len - 1] == '<' || expr[expr_len - 1] == '>' ||
                   expr[expr_len - 1] == '&' || expr[expr_len - 1] == '|'));
 
+            // Tokens with no blank between them in the source form one
+            // word, so x$y must not become the two words "x $y"
+            const char *input = parser->tokenizer->input;
+            bool adjacent = expr_len > 0 && current->position > 0 &&
+                            !isspace((unsigned char)input[current->position - 1]);
+
             // Don't add space:
+            // - Between adjacent tokens
             // - Before ) or after (
             // - After ) when followed by ( (for regex groups like )(
             // - Between consecutive operators
-            skip_space = (current->type == TOK_RPAREN) ||
+            skip_space = adjacent || (current->type == TOK_RPAREN) ||
                          (expr_len > 0 && expr[expr_len - 1] == '(') ||
                          (expr_len > 0 && expr[expr_len - 1] == ')' && 
                           current->type == TOK_LPAREN) ||
@@ -4585,6 +4617,10 @@ static node_t *parse_extended_test(parser_t *parser) {
     test_node->val.str = expr;
     test_node->val_type = VAL_STR;
 
+    // Resolve operators and prepare literal operands once, here, rather
+    // than on every evaluation (NULL on failure; the executor retries)
+    test_node->compiled = extended_test_compile(expr);
+
     return test_node;
 }
 
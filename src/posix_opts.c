@@ -215,21 +215,6 @@ bool is_interactive_comments_enabled(void) {
     return shell_opts.interactive_comments_mode;
 }
 
-/**
- * @brief Print command trace for -x option
- *
- * When xtrace is enabled, prints each command before execution
- * prefixed with "+ ".
- *
- * @param command Command string to trace
- */
-void print_command_trace(const char *command) {
-    if (should_trace_execution()) {
-        fprintf(stderr, "+ %s\n", command);
-        fflush(stderr);
-    }
-}
-
 /**
  * @brief Named option mapping structure
  *
@@ -532,8 +517,9 @@ int builtin_set(char **args) {
             i++; // Move past the --
 
             // Clear existing positional parameters $1, $2, etc.
-            for (int param_num = 1; param_num <= 99; param_num++) {
-                char param_name[4];
+            int old_count = shell_argc > 100 ? shell_argc - 1 : 99;
+            for (int param_num = 1; param_num <= old_count; param_num++) {
+                char param_name[16];
                 snprintf(param_name, sizeof(param_name), "%d", param_num);
                 symtable_unset_global(param_name);
             }
@@ -564,8 +550,8 @@ int builtin_set(char **args) {
                 // Set new positional parameters in both symbol table and global
                 // arrays
                 int param_num = 1;
-                while (args[i] && param_num <= 99) {
-                    char param_name[4];
+                while (args[i]) {
+                    char param_name[16];
                     snprintf(param_name, sizeof(param_name), "%d", param_num);
                     symtable_set_global(param_name, args[i]);
 
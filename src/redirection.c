@@ -50,6 +50,7 @@ static char *expand_redirection_target(executor_t *executor,
 static int setup_fd_redirection(executor_t *executor, const char *redir_text);
 static int setup_fd_alloc_redirection(executor_t *executor, node_t *redir_node);
 static int find_available_fd(int min_fd);
+static int move_fd(int fd, int dest_fd);
 
 /**
  * @brief Setup redirections for a command
@@ -197,7 +198,7 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
                 shell_error_free(error);
                 result = 1;
             } else {
-                if (dup2(fd, STDIN_FILENO) == -1) {
+                if (move_fd(fd, STDIN_FILENO) == -1) {
                     shell_error_t *error = shell_error_create(
                         SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, redir_node->loc,
                         "dup2: %s", strerror(errno));
@@ -205,7 +206,6 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
                     shell_error_free(error);
                     result = 1;
                 }
-                close(fd);
             }
             break;
 
@@ -227,7 +227,7 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
                 shell_error_free(error);
                 result = 1;
             } else {
-                if (dup2(fd, STDOUT_FILENO) == -1) {
+                if (move_fd(fd, STDOUT_FILENO) == -1) {
                     shell_error_t *error = shell_error_create(
                         SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, redir_node->loc,
                         "dup2: %s", strerror(errno));
@@ -235,7 +235,6 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
                     shell_error_free(error);
                     result = 1;
                 }
-                close(fd);
             }
             break;
 
@@ -310,7 +309,7 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
             result = 1;
             break;
         }
-        if (dup2(fd, STDOUT_FILENO) == -1) {
+        if (move_fd(fd, STDOUT_FILENO) == -1) {
             shell_error_t *error = shell_error_create(
                 SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, redir_node->loc,
                 "dup2: %s", strerror(errno));
@@ -318,7 +317,6 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
             shell_error_free(error);
             result = 1;
         }
-        close(fd);
         break;
     }
 
@@ -334,17 +332,15 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
             result = 1;
             break;
         }
-        if (dup2(fd, STDOUT_FILENO) == -1) {
+        if (move_fd(fd, STDOUT_FILENO) == -1) {
             shell_error_t *error = shell_error_create(
                 SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, redir_node->loc,
                 "dup2: %s", strerror(errno));
             shell_error_display(error, stderr, isatty(STDERR_FILENO));
             shell_error_free(error);
-            close(fd);
             result = 1;
             break;
         }
-        close(fd);
         break;
     }
 
@@ -360,17 +356,15 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
             result = 1;
             break;
         }
-        if (dup2(fd, STDIN_FILENO) == -1) {
+        if (move_fd(fd, STDIN_FILENO) == -1) {
             shell_error_t *error = shell_error_create(
                 SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, redir_node->loc,
                 "dup2: %s", strerror(errno));
             shell_error_display(error, stderr, isatty(STDERR_FILENO));
             shell_error_free(error);
-            close(fd);
             result = 1;
             break;
         }
-        close(fd);
         break;
     }
 
@@ -391,17 +385,15 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
             result = 1;
             break;
         }
-        if (dup2(fd, dest_fd) == -1) {
+        if (move_fd(fd, dest_fd) == -1) {
             shell_error_t *error = shell_error_create(
                 SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, redir_node->loc,
                 "dup2: %s", strerror(errno));
             shell_error_display(error, stderr, isatty(STDERR_FILENO));
             shell_error_free(error);
-            close(fd);
             result = 1;
             break;
         }
-        close(fd);
         break;
     }
 
@@ -422,17 +414,15 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
             result = 1;
             break;
         }
-        if (dup2(fd, dest_fd) == -1) {
+        if (move_fd(fd, dest_fd) == -1) {
             shell_error_t *error = shell_error_create(
                 SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, redir_node->loc,
                 "dup2: %s", strerror(errno));
             shell_error_display(error, stderr, isatty(STDERR_FILENO));
             shell_error_free(error);
-            close(fd);
             result = 1;
             break;
         }
-        close(fd);
         break;
     }
 
@@ -453,17 +443,15 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
             result = 1;
             break;
         }
-        if (dup2(fd, dest_fd) == -1) {
+        if (move_fd(fd, dest_fd) == -1) {
             shell_error_t *error = shell_error_create(
                 SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, redir_node->loc,
                 "dup2: %s", strerror(errno));
             shell_error_display(error, stderr, isatty(STDERR_FILENO));
             shell_error_free(error);
-            close(fd);
             result = 1;
             break;
         }
-        close(fd);
         break;
     }
 
@@ -479,17 +467,16 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
             result = 1;
             break;
         }
-        if (dup2(fd, STDOUT_FILENO) == -1 || dup2(fd, STDERR_FILENO) == -1) {
+        if (move_fd(fd, STDOUT_FILENO) == -1 ||
+            dup2(STDOUT_FILENO, STDERR_FILENO) == -1) {
             shell_error_t *error = shell_error_create(
                 SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, redir_node->loc,
                 "dup2: %s", strerror(errno));
             shell_error_display(error, stderr, isatty(STDERR_FILENO));
             shell_error_free(error);
-            close(fd);
             result = 1;
             break;
         }
-        close(fd);
         break;
     }
 
@@ -505,17 +492,16 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
             result = 1;
             break;
         }
-        if (dup2(fd, STDOUT_FILENO) == -1 || dup2(fd, STDERR_FILENO) == -1) {
+        if (move_fd(fd, STDOUT_FILENO) == -1 ||
+            dup2(STDOUT_FILENO, STDERR_FILENO) == -1) {
             shell_error_t *error = shell_error_create(
                 SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, redir_node->loc,
                 "dup2: %s", strerror(errno));
             shell_error_display(error, stderr, isatty(STDERR_FILENO));
             shell_error_free(error);
-            close(fd);
             result = 1;
             break;
         }
-        close(fd);
         break;
     }
 
@@ -550,7 +536,7 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
             result = 1;
             break;
         }
-        if (dup2(fd, STDOUT_FILENO) == -1) {
+        if (move_fd(fd, STDOUT_FILENO) == -1) {
             shell_error_t *error = shell_error_create(
                 SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, redir_node->loc,
                 "dup2: %s", strerror(errno));
@@ -558,7 +544,6 @@ static int handle_redirection_node(executor_t *executor, node_t *redir_node) {
             shell_error_free(error);
             result = 1;
         }
-        close(fd);
         break;
     }
 
@@ -650,16 +635,14 @@ static int setup_here_document(const char *delimiter, bool strip_tabs) {
         // Parent process: redirect stdin to read from pipe
         close(pipefd[1]); // Close write end
 
-        if (dup2(pipefd[0], STDIN_FILENO) == -1) {
+        if (move_fd(pipefd[0], STDIN_FILENO) == -1) {
             shell_error_t *error = shell_error_create(
                 SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, SOURCE_LOC_UNKNOWN,
                 "dup2: %s", strerror(errno));
             shell_error_display(error, stderr, isatty(STDERR_FILENO));
             shell_error_free(error);
-            close(pipefd[0]);
             return 1;
         }
-        close(pipefd[0]);
 
         // Wait for child to finish writing the here document
         int status;
@@ -728,16 +711,14 @@ static int setup_here_document_with_content(const char *content) {
         // Parent process: redirect stdin to read from pipe
         close(pipefd[1]); // Close write end
 
-        if (dup2(pipefd[0], STDIN_FILENO) == -1) {
+        if (move_fd(pipefd[0], STDIN_FILENO) == -1) {
             shell_error_t *error = shell_error_create(
                 SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, SOURCE_LOC_UNKNOWN,
                 "dup2: %s", strerror(errno));
             shell_error_display(error, stderr, isatty(STDERR_FILENO));
             shell_error_free(error);
-            close(pipefd[0]);
             return 1;
         }
-        close(pipefd[0]);
 
         // Wait for child to finish writing the here document
         int status;
@@ -910,16 +891,14 @@ static int setup_here_string(executor_t *executor, const char *content) {
     free(expanded_content);
 
     // Redirect stdin to read from the pipe
-    if (dup2(pipefd[0], STDIN_FILENO) == -1) {
+    if (move_fd(pipefd[0], STDIN_FILENO) == -1) {
         shell_error_t *error = shell_error_create(
             SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, SOURCE_LOC_UNKNOWN,
             "dup2: %s", strerror(errno));
         shell_error_display(error, stderr, isatty(STDERR_FILENO));
         shell_error_free(error);
-        close(pipefd[0]);
         return 1;
     }
-    close(pipefd[0]);
 
     return 0;
 }
@@ -1113,50 +1092,129 @@ static int setup_fd_redirection(executor_t *executor, const char *redir_text) {
 }
 
 /**
- * @brief Save current file descriptors for later restoration
+ * @brief Get the descriptors a redirection node changes
  *
- * Duplicates stdin, stdout, and stderr so they can be restored
- * after redirection operations complete.
+ * Mirrors the destinations handle_redirection_node() writes to.
+ *
+ * @param redir_node Redirection node
+ * @param fds Output array of at least two descriptors
+ * @return Number of descriptors stored in @p fds
+ */
+static int redirection_destination_fds(const node_t *redir_node, int *fds) {
+    const char *text = redir_node->val.str;
+    bool numbered = text && isdigit((unsigned char)text[0]);
+
+    switch (redir_node->type) {
+    case NODE_REDIR_IN:
+    case NODE_REDIR_HEREDOC:
+    case NODE_REDIR_HEREDOC_STRIP:
+    case NODE_REDIR_HERESTRING:
+        fds[0] = STDIN_FILENO;
+        return 1;
+
+    case NODE_REDIR_OUT:
+    case NODE_REDIR_APPEND:
+    case NODE_REDIR_CLOBBER:
+        fds[0] = STDOUT_FILENO;
+        return 1;
+
+    case NODE_REDIR_IN_FD:
+        fds[0] = numbered ? text[0] - '0' : STDIN_FILENO;
+        return 1;
+
+    case NODE_REDIR_ERR:
+    case NODE_REDIR_ERR_APPEND:
+        fds[0] = numbered ? text[0] - '0' : STDERR_FILENO;
+        return 1;
+
+    case NODE_REDIR_BOTH:
+    case NODE_REDIR_BOTH_APPEND:
+        fds[0] = STDOUT_FILENO;
+        fds[1] = STDERR_FILENO;
+        return 2;
+
+    case NODE_REDIR_FD:
+        if (!text) {
+            return 0;
+        }
+        if (numbered) {
+            fds[0] = text[0] - '0';
+        } else if (text[0] == '<') {
+            fds[0] = STDIN_FILENO;
+        } else {
+            fds[0] = STDOUT_FILENO;
+        }
+        return 1;
+
+    default:
+        /* {varname} descriptors are meant to outlive the command */
+        return 0;
+    }
+}
+
+/**
+ * @brief Save the file descriptors a command's redirections will change
+ *
+ * Walks the same redirection children as setup_redirections() and copies
+ * each descriptor they name once, with F_DUPFD_CLOEXEC at or above
+ * REDIRECTION_SAVE_FD_MIN. A descriptor that is not open is recorded as
+ * closed so restoring closes it again.
  *
  * @param state State structure to store saved descriptors
+ * @param command Command node with redirection children
  * @return 0 on success, non-zero on error
  */
-int save_file_descriptors(redirection_state_t *state) {
+int save_file_descriptors(redirection_state_t *state, node_t *command) {
     if (!state) {
         return 1;
     }
 
-    // Initialize state
-    state->stdin_saved = false;
-    state->stdout_saved = false;
-    state->stderr_saved = false;
-
-    // Save stdin
-    state->saved_stdin = dup(STDIN_FILENO);
-    if (state->saved_stdin != -1) {
-        state->stdin_saved = true;
+    state->count = 0;
+    if (!command) {
+        return 0;
     }
 
-    // Save stdout
-    state->saved_stdout = dup(STDOUT_FILENO);
-    if (state->saved_stdout != -1) {
-        state->stdout_saved = true;
-    }
+    int result = 0;
+    for (node_t *child = command->first_child; child;
+         child = child->next_sibling) {
+        if (child->type < NODE_REDIR_IN || child->type > NODE_REDIR_FD_ALLOC) {
+            continue;
+        }
+
+        int fds[2];
+        int n = redirection_destination_fds(child, fds);
+        for (int i = 0; i < n; i++) {
+            bool seen = false;
+            for (int j = 0; j < state->count; j++) {
+                if (state->fds[j] == fds[i]) {
+                    seen = true;
+                    break;
+                }
+            }
+            if (seen || state->count >= REDIRECTION_MAX_FDS) {
+                continue;
+            }
 
-    // Save stderr
-    state->saved_stderr = dup(STDERR_FILENO);
-    if (state->saved_stderr != -1) {
-        state->stderr_saved = true;
+            int copy = fcntl(fds[i], F_DUPFD_CLOEXEC, REDIRECTION_SAVE_FD_MIN);
+            if (copy == -1 && errno != EBADF) {
+                // Leave it alone rather than close it on restore
+                result = 1;
+                continue;
+            }
+            state->fds[state->count] = fds[i];
+            state->saved[state->count] = copy;
+            state->count++;
+        }
     }
 
-    return 0;
+    return result;
 }
 
 /**
  * @brief Restore file descriptors after command execution
  *
- * Restores stdin, stdout, and stderr from previously saved state
- * and closes the saved duplicates.
+ * Restores the saved descriptors in reverse order and closes the saved
+ * copies. Descriptors that were closed before are closed again.
  *
  * @param state State structure containing saved descriptors
  * @return 0 on success, non-zero on error
@@ -1172,52 +1230,73 @@ int restore_file_descriptors(redirection_state_t *state) {
     // This is critical: when stdout/stderr are redirected to files,
     // unflushed data in the stdio buffers would be lost when we
     // restore the original file descriptors (which closes the redirected ones)
-    if (state->stdout_saved) {
-        fflush(stdout);
-    }
-    if (state->stderr_saved) {
-        fflush(stderr);
-    }
-
-    // Restore stdin
-    if (state->stdin_saved) {
-        if (dup2(state->saved_stdin, STDIN_FILENO) == -1) {
-            shell_error_t *error = shell_error_create(
-                SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, SOURCE_LOC_UNKNOWN,
-                "failed to restore stdin: %s", strerror(errno));
-            shell_error_display(error, stderr, isatty(STDERR_FILENO));
-            shell_error_free(error);
-            result = 1;
+    for (int i = 0; i < state->count; i++) {
+        if (state->fds[i] == STDOUT_FILENO) {
+            fflush(stdout);
+        } else if (state->fds[i] == STDERR_FILENO) {
+            fflush(stderr);
         }
-        close(state->saved_stdin);
     }
 
-    // Restore stdout
-    if (state->stdout_saved) {
-        if (dup2(state->saved_stdout, STDOUT_FILENO) == -1) {
+    for (int i = state->count - 1; i >= 0; i--) {
+        int fd = state->fds[i];
+        int copy = state->saved[i];
+        if (copy == -1) {
+            close(fd);
+            continue;
+        }
+        if (dup2(copy, fd) == -1) {
             shell_error_t *error = shell_error_create(
                 SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, SOURCE_LOC_UNKNOWN,
-                "failed to restore stdout: %s", strerror(errno));
+                "failed to restore file descriptor %d: %s", fd,
+                strerror(errno));
             shell_error_display(error, stderr, isatty(STDERR_FILENO));
             shell_error_free(error);
             result = 1;
         }
-        close(state->saved_stdout);
+        close(copy);
     }
+    state->count = 0;
 
-    // Restore stderr
-    if (state->stderr_saved) {
-        if (dup2(state->saved_stderr, STDERR_FILENO) == -1) {
-            shell_error_t *error = shell_error_create(
-                SHELL_ERR_BAD_FD, SHELL_SEVERITY_ERROR, SOURCE_LOC_UNKNOWN,
-                "failed to restore stderr: %s", strerror(errno));
-            shell_error_display(error, stderr, isatty(STDERR_FILENO));
-            shell_error_free(error);
-            result = 1;
+    return result;
+}
+
+/**
+ * @brief Close saved copies without restoring them
+ *
+ * @param state State structure containing saved descriptors
+ */
+void discard_saved_file_descriptors(redirection_state_t *state) {
+    if (!state) {
+        return;
+    }
+    for (int i = 0; i < state->count; i++) {
+        if (state->saved[i] != -1) {
+            close(state->saved[i]);
         }
-        close(state->saved_stderr);
     }
+    state->count = 0;
+}
 
+/**
+ * @brief Move a newly opened descriptor onto its destination
+ *
+ * open() and pipe() return the lowest free descriptor, which is the
+ * destination itself when that descriptor is closed (as it often is for
+ * fds 3 and up). It is then already in place and must not be closed.
+ *
+ * @param fd Descriptor just opened
+ * @param dest_fd Descriptor it should become
+ * @return 0 on success, -1 if dup2() failed (errno is preserved)
+ */
+static int move_fd(int fd, int dest_fd) {
+    if (fd == dest_fd) {
+        return 0;
+    }
+    int result = dup2(fd, dest_fd);
+    int saved_errno = errno;
+    close(fd);
+    errno = saved_errno;
     return result;
 }
 
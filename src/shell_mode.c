@@ -93,6 +93,7 @@ static const bool feature_matrix[SHELL_MODE_COUNT][FEATURE_COUNT] = {
         [FEATURE_AUTO_CD]             = false,
         [FEATURE_AUTO_PUSHD]          = false,
         [FEATURE_CDABLE_VARS]         = false,
+        [FEATURE_DIR_FRECENCY]        = false,
 
         /* History Behavior */
         [FEATURE_HISTAPPEND]          = false,
@@ -168,6 +169,7 @@ static const bool feature_matrix[SHELL_MODE_COUNT][FEATURE_COUNT] = {
         [FEATURE_AUTO_CD]             = false, /* shopt autocd, off by default */
         [FEATURE_AUTO_PUSHD]          = false,
         [FEATURE_CDABLE_VARS]         = false,
+        [FEATURE_DIR_FRECENCY]        = false,
 
         /* History Behavior */
         [FEATURE_HISTAPPEND]          = true,  /* Bash default on */
@@ -243,6 +245,7 @@ static const bool feature_matrix[SHELL_MODE_COUNT][FEATURE_COUNT] = {
         [FEATURE_AUTO_CD]             = false, /* AUTO_CD option, off by default */
         [FEATURE_AUTO_PUSHD]          = false,
         [FEATURE_CDABLE_VARS]         = false,
+        [FEATURE_DIR_FRECENCY]        = false,
 
         /* History Behavior */
         [FEATURE_HISTAPPEND]          = true,  /* APPEND_HISTORY */
@@ -318,6 +321,7 @@ static const bool feature_matrix[SHELL_MODE_COUNT][FEATURE_COUNT] = {
         [FEATURE_AUTO_CD]             = true,  /* Convenience feature */
         [FEATURE_AUTO_PUSHD]          = false, /* Optional */
         [FEATURE_CDABLE_VARS]         = false, /* Optional */
+        [FEATURE_DIR_FRECENCY]        = true,  /* Feeds z and cd completion */
 
         /* History Behavior - better defaults */
         [FEATURE_HISTAPPEND]          = true,  /* Preserve history */
@@ -408,6 +412,7 @@ static const char *feature_names[FEATURE_COUNT] = {
     [FEATURE_AUTO_CD]              = "auto_cd",
     [FEATURE_AUTO_PUSHD]           = "auto_pushd",
     [FEATURE_CDABLE_VARS]          = "cdable_vars",
+    [FEATURE_DIR_FRECENCY]         = "dir_frecency",
 
     /* History Behavior */
     [FEATURE_HISTAPPEND]           = "histappend",
@@ -19,6 +19,9 @@
 #include "executor.h"
 #include "lle/adaptive_terminal_integration.h"
 #include "lush.h"
+#include "node.h"
+#include "parse_cache.h"
+#include "symtable.h"
 
 #include <signal.h>
 #include <stdio.h>
@@ -34,15 +37,24 @@ trap_entry_t *trap_list = NULL;
 static pid_t current_child_pid = 0;
 
 /**
- * @brief Bitmask of signals with pending trap execution
+ * @brief Per-signal flags of pending trap execution
  *
  * Set by the signal handler (async-signal-safe), cleared by
- * execute_pending_traps() in the main loop. Only signals that
- * have traps registered will set bits here.
- *
- * Bit positions correspond to signal numbers (e.g., bit 2 = SIGINT).
+ * execute_pending_traps(). One flag per signal number rather than a
+ * bitmask: it covers real-time signals beyond 31, and a handler
+ * interrupting another handler cannot lose a bit to a read-modify-write.
  */
-static volatile sig_atomic_t pending_trap_signals = 0;
+static volatile sig_atomic_t pending_trap_signals[NSIG];
+
+/** @brief Set whenever any pending_trap_signals flag is set */
+static volatile sig_atomic_t any_trap_pending = 0;
+
+/** @brief Dispositions replaced by set_trap(), restored by remove_trap() */
+static struct sigaction saved_actions[NSIG];
+static bool saved_action_valid[NSIG];
+
+/** @brief True while execute_pending_traps() is running handlers */
+static bool running_pending_traps = false;
 
 /**
  * @brief Flag set when SIGINT received during readline
@@ -256,32 +268,95 @@ static trap_entry_t *find_trap(int signal) {
  * @param signo Signal number received
  */
 static void trap_signal_handler(int signo) {
-    if (signo > 0 && signo < 32) {
-        pending_trap_signals |= (1 << signo);
+    if (signo > 0 && signo < NSIG) {
+        pending_trap_signals[signo] = 1;
+        any_trap_pending = 1;
+    }
+}
+
+/**
+ * @brief Free a trap entry and its parsed command
+ */
+static void free_trap(trap_entry_t *trap) {
+    parse_cache_release(trap->parsed);
+    free(trap->command);
+    free(trap);
+}
+
+/**
+ * @brief Parse a trap command once, when the trap is set
+ *
+ * Commands that fail to parse, or contain line continuations the parser
+ * expects to have been joined, get no parsed form and are run from their
+ * text so errors are reported when the trap fires, as other shells do.
+ */
+static parse_cache_entry_t *parse_trap_command(const char *command) {
+    if (strstr(command, "\\\n")) {
+        return NULL;
+    }
+    return parse_cache_acquire(command, "trap");
+}
+
+/**
+ * @brief Point a signal at the trap handler, or ignore it
+ *
+ * The replaced disposition is saved so removing the trap restores the
+ * shell's own handler (SIGINT, SIGHUP) rather than the default action.
+ * SIGINT keeps interrupting system calls so Ctrl+C still breaks out of
+ * input; other signals restart them, so traps on frequent signals such
+ * as SIGCHLD do not disturb waits and reads in progress.
+ */
+static int install_trap_disposition(int signo, bool ignore) {
+    struct sigaction sigact;
+    sigemptyset(&sigact.sa_mask);
+    sigact.sa_flags = signo == SIGINT ? 0 : SA_RESTART;
+    sigact.sa_handler = ignore ? SIG_IGN : trap_signal_handler;
+
+    struct sigaction old;
+    if (sigaction(signo, &sigact, &old) != 0) {
+        return -1;
+    }
+    if (!saved_action_valid[signo]) {
+        saved_actions[signo] = old;
+        saved_action_valid[signo] = true;
     }
+    return 0;
 }
 
 /**
  * @brief Set a trap for a signal
  *
- * Associates a command string with a signal. When the signal is
- * received, the command will be executed.
+ * Associates a command string with a signal. The command is parsed here,
+ * once, and the parsed form is executed each time the signal arrives.
+ * Any signal that can be caught may be trapped, real-time signals
+ * included.
  *
  * @param signal Signal number (0 for EXIT trap)
- * @param command Command string to execute (NULL or empty to remove)
+ * @param command Command string to execute (NULL to remove; empty to
+ *                ignore the signal, or remove the EXIT trap)
  * @return 0 on success, -1 on error
  */
 int set_trap(int signal, const char *command) {
+    if (signal < 0 || signal >= NSIG) {
+        return -1;
+    }
+
     // Remove existing trap for this signal
     remove_trap(signal);
 
-    if (!command || strlen(command) == 0) {
-        // Empty command means remove trap (already done above)
+    if (!command || (signal == 0 && command[0] == '\0')) {
+        // No command means remove trap (already done above)
         return 0;
     }
 
+    // Install the handler first so an uncatchable signal is rejected
+    bool ignore = command[0] == '\0';
+    if (signal != 0 && install_trap_disposition(signal, ignore) != 0) {
+        return -1;
+    }
+
     // Create new trap entry
-    trap_entry_t *new_trap = malloc(sizeof(trap_entry_t));
+    trap_entry_t *new_trap = calloc(1, sizeof(trap_entry_t));
     if (!new_trap) {
         return -1;
     }
@@ -292,25 +367,23 @@ int set_trap(int signal, const char *command) {
         free(new_trap);
         return -1;
     }
+    if (!ignore) {
+        new_trap->parsed = parse_trap_command(command);
+    }
 
     // Add to list
     new_trap->next = trap_list;
     trap_list = new_trap;
 
-    // Set the signal handler
-    if (signal == SIGINT || signal == SIGTERM || signal == SIGQUIT ||
-        signal == SIGHUP || signal == SIGUSR1 || signal == SIGUSR2) {
-        set_signal_handler(signal, trap_signal_handler);
-    }
-
     return 0;
 }
 
 /**
  * @brief Remove a trap for a signal
  *
- * Removes the trap command for the specified signal and resets
- * the signal handler to default.
+ * Removes the trap command for the specified signal and restores the
+ * disposition the signal had before it was trapped. A trap removed by
+ * its own handler is freed once the handler returns.
  *
  * @param signal Signal number to remove trap for
  * @return 0 on success, -1 if trap not found
@@ -328,14 +401,18 @@ int remove_trap(int signal) {
                 trap_list = current->next;
             }
 
-            // Free memory
-            free(current->command);
-            free(current);
+            if (current->running) {
+                current->removed = true;
+                current->next = NULL;
+            } else {
+                free_trap(current);
+            }
 
-            // Reset signal handler to default (but not for EXIT trap which is
-            // special)
-            if (signal != 0) {
-                set_signal_handler(signal, SIG_DFL);
+            // Restore the previous handler (EXIT has none)
+            if (signal > 0 && signal < NSIG && saved_action_valid[signal]) {
+                sigaction(signal, &saved_actions[signal], NULL);
+                saved_action_valid[signal] = false;
+                pending_trap_signals[signal] = 0;
             }
 
             return 0;
@@ -361,6 +438,25 @@ void list_traps(void) {
     }
 }
 
+/**
+ * @brief Names accepted by get_signal_number(), without the SIG prefix
+ */
+static const struct {
+    const char *name;
+    int signo;
+} signal_names[] = {
+    {"HUP", SIGHUP},     {"INT", SIGINT},       {"QUIT", SIGQUIT},
+    {"ILL", SIGILL},     {"TRAP", SIGTRAP},     {"ABRT", SIGABRT},
+    {"BUS", SIGBUS},     {"FPE", SIGFPE},       {"KILL", SIGKILL},
+    {"USR1", SIGUSR1},   {"SEGV", SIGSEGV},     {"USR2", SIGUSR2},
+    {"PIPE", SIGPIPE},   {"ALRM", SIGALRM},     {"TERM", SIGTERM},
+    {"CHLD", SIGCHLD},   {"CONT", SIGCONT},     {"STOP", SIGSTOP},
+    {"TSTP", SIGTSTP},   {"TTIN", SIGTTIN},     {"TTOU", SIGTTOU},
+    {"URG", SIGURG},     {"XCPU", SIGXCPU},     {"XFSZ", SIGXFSZ},
+    {"VTALRM", SIGVTALRM}, {"PROF", SIGPROF},   {"WINCH", SIGWINCH},
+    {"SYS", SIGSYS},
+};
+
 /**
  * @brief Get signal number from name
  *
@@ -371,83 +467,183 @@ void list_traps(void) {
  * @return Signal number, or -1 if not recognized
  */
 int get_signal_number(const char *signame) {
-    if (!signame) {
+    if (!signame || !signame[0]) {
         return -1;
     }
 
     // Handle numeric signals
     if (signame[0] >= '0' && signame[0] <= '9') {
-        return atoi(signame);
+        char *end;
+        long signo = strtol(signame, &end, 10);
+        return (*end == '\0' && signo < NSIG) ? (int)signo : -1;
+    }
+
+    if (strcmp(signame, "EXIT") == 0) {
+        return 0; // Special case for EXIT trap
     }
 
     // Handle signal names (with or without SIG prefix)
-    if (strcmp(signame, "INT") == 0 || strcmp(signame, "SIGINT") == 0) {
-        return SIGINT;
+    const char *name = signame;
+    if (strncmp(name, "SIG", 3) == 0) {
+        name += 3;
     }
-    if (strcmp(signame, "TERM") == 0 || strcmp(signame, "SIGTERM") == 0) {
-        return SIGTERM;
+    for (size_t i = 0; i < sizeof(signal_names) / sizeof(signal_names[0]);
+         i++) {
+        if (strcmp(name, signal_names[i].name) == 0) {
+            return signal_names[i].signo;
+        }
     }
-    if (strcmp(signame, "QUIT") == 0 || strcmp(signame, "SIGQUIT") == 0) {
-        return SIGQUIT;
+
+#ifdef SIGRTMIN
+    // Real-time signals: RTMIN, RTMIN+n, RTMAX, RTMAX-n
+    if (strncmp(name, "RTMIN", 5) == 0 || strncmp(name, "RTMAX", 5) == 0) {
+        bool from_min = name[4] == 'N';
+        int base = from_min ? SIGRTMIN : SIGRTMAX;
+        const char *rest = name + 5;
+        if (*rest == '\0') {
+            return base;
+        }
+        if (*rest == (from_min ? '+' : '-') && rest[1] >= '0' &&
+            rest[1] <= '9') {
+            char *end;
+            long offset = strtol(rest + 1, &end, 10);
+            int signo = from_min ? base + (int)offset : base - (int)offset;
+            if (*end == '\0' && signo >= SIGRTMIN && signo <= SIGRTMAX) {
+                return signo;
+            }
+        }
     }
-    if (strcmp(signame, "HUP") == 0 || strcmp(signame, "SIGHUP") == 0) {
-        return SIGHUP;
+#endif
+
+    return -1; // Unknown signal
+}
+
+/**
+ * @brief Run one trap's command in the current shell
+ *
+ * The parsed command runs through the shell's own executor, so it sees
+ * and can change variables and functions. $? and the executor's error
+ * state are restored afterwards, so a trap is invisible to the command
+ * that follows it. A trap that is
+ * already running is not entered again.
+ */
+static void run_trap(trap_entry_t *trap) {
+    if (trap->running || !trap->command[0]) {
+        return;
     }
-    if (strcmp(signame, "USR1") == 0 || strcmp(signame, "SIGUSR1") == 0) {
-        return SIGUSR1;
+
+    int saved_status = last_exit_status;
+    trap->running = true;
+
+    executor_t *executor = get_global_executor();
+    if (executor && trap->parsed) {
+        /* executor_execute() clears the error state, so what is set
+         * afterwards is the trap's own and the interrupted command's error
+         * is put back for its caller to report */
+        int saved_executor_status = executor->exit_status;
+        bool saved_has_error = executor->has_error;
+        const char *saved_error_message = executor->error_message;
+        executor_execute(executor, parse_cache_tree(trap->parsed));
+        fflush(stdout);
+        fflush(stderr);
+        if (executor_has_error(executor) && executor_error(executor)) {
+            fprintf(stderr, "lush: %s\n", executor_error(executor));
+        }
+        executor->exit_status = saved_executor_status;
+        executor->has_error = saved_has_error;
+        executor->error_message = saved_error_message;
+    } else {
+        parse_and_execute(trap->command);
     }
-    if (strcmp(signame, "USR2") == 0 || strcmp(signame, "SIGUSR2") == 0) {
-        return SIGUSR2;
+
+    trap->running = false;
+    if (trap->removed) {
+        free_trap(trap);
     }
-    if (strcmp(signame, "EXIT") == 0) {
-        return 0; // Special case for EXIT trap
+    set_exit_status(saved_status);
+}
+
+/**
+ * @brief Check whether a child has a state change nobody has waited for
+ *
+ * The status is left in place (WNOWAIT) for the code that reaps it.
+ */
+static bool child_status_waiting(void) {
+    siginfo_t info;
+    info.si_pid = 0;
+    if (waitid(P_ALL, 0, &info,
+               WEXITED | WSTOPPED | WCONTINUED | WNOHANG | WNOWAIT) != 0) {
+        return false;
     }
+    return info.si_pid != 0;
+}
 
-    return -1; // Unknown signal
+/**
+ * @brief Check whether a trapped signal is waiting to be handled
+ */
+bool traps_pending(void) {
+    return any_trap_pending != 0;
 }
 
 /**
  * @brief Execute any pending trap commands deferred from signal handlers
  *
- * Checks the pending_trap_signals bitmask and runs the corresponding
- * trap commands. Must be called from the main loop (not signal context)
- * so that system() and other non-async-signal-safe functions are safe.
- *
- * Clears each bit after executing the trap.
+ * Runs the trap of every signal flagged in pending_trap_signals, lowest
+ * signal first, until none is pending. Called from the main loop and after
+ * each simple command. Handlers do not nest: signals arriving while a trap
+ * runs wait for it to finish, then run the trap again, including the
+ * trap's own signal. The exception is SIGCHLD from children the trap
+ * itself started and waited for, so a SIGCHLD trap that runs commands
+ * does not retrigger itself. Forked children never run the parent's
+ * traps.
  */
 void execute_pending_traps(void) {
-    sig_atomic_t pending = pending_trap_signals;
-    if (pending == 0) {
+    if (!any_trap_pending || running_pending_traps) {
+        return;
+    }
+    if (shell_pid > 0 && getpid() != shell_pid) {
         return;
     }
 
-    /* Clear all pending bits before executing (if a new signal arrives
-     * during execution, it will set the bit again for next iteration) */
-    pending_trap_signals = 0;
-
-    for (int signo = 1; signo < 32; signo++) {
-        if (pending & (1 << signo)) {
+    running_pending_traps = true;
+    while (any_trap_pending) {
+        any_trap_pending = 0;
+        for (int signo = 1; signo < NSIG; signo++) {
+            if (!pending_trap_signals[signo]) {
+                continue;
+            }
+            pending_trap_signals[signo] = 0;
             trap_entry_t *trap = find_trap(signo);
-            if (trap && trap->command) {
-                system(trap->command);
+            if (trap) {
+                run_trap(trap);
+                /* The trap's own commands were waited for and raise
+                 * SIGCHLD too; only a child still to be reaped counts */
+                if (signo == SIGCHLD && pending_trap_signals[signo] &&
+                    !child_status_waiting()) {
+                    pending_trap_signals[signo] = 0;
+                }
             }
         }
     }
+    running_pending_traps = false;
 }
 
 /**
  * @brief Execute EXIT traps and cleanup
  *
- * Executes any trap set for signal 0 (EXIT) and resets the
- * terminal to a clean state.
+ * Executes any trap set for signal 0 (EXIT) in the current shell and
+ * resets the terminal to a clean state. The trap is removed first, so
+ * it runs once even if several exit paths reach this function.
  */
 void execute_exit_traps(void) {
     trap_entry_t *trap = find_trap(0); // EXIT is signal 0
-    if (trap && trap->command) {
-        // Execute the EXIT trap command
-        // For now, we'll use system() - this could be improved to use the
-        // shell's executor
-        system(trap->command);
+    if (trap) {
+        trap->running = true;
+        remove_trap(0);
+        trap->running = false;
+        trap->removed = false;
+        run_trap(trap);
+        free_trap(trap);
     }
 
     // Reset terminal to clean state on exit
@@ -0,0 +1,1230 @@
+/**
+ * @file spawn_cost.c
+ * @brief Process spawn cost analysis for shell scripts
+ *
+ * The estimate follows how the executor runs each construct: external
+ * commands fork and exec, command substitutions and subshells fork, and
+ * every pipeline stage runs in its own child. Builtins and functions
+ * defined in the script run in the shell. Each spawn is weighted by
+ * SPAWN_LOOP_WEIGHT for every enclosing loop, so the per-function totals
+ * approximate the processes started by one call.
+ *
+ * Command substitutions are stored as raw text in the AST, so they are
+ * scanned out of the words and parsed on their own. Source positions are
+ * recovered by searching the script for each construct, starting from
+ * where the walk last was, which keeps repeated constructs apart.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "spawn_cost.h"
+#include "builtins.h"
+#include "parser.h"
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * Constants
+ * ============================================================================ */
+
+#define SPAWN_INITIAL_CAPACITY 16
+#define SPAWN_MAX_WORDS 16
+#define SPAWN_NAME_MAX 256
+
+/* ============================================================================
+ * Internal Types
+ * ============================================================================ */
+
+/**
+ * @brief A raw word within a command's source text
+ */
+typedef struct {
+    size_t start; /**< Offset of the word */
+    size_t len;   /**< Length of the word, quotes included */
+} span_t;
+
+/**
+ * @brief State of one analysis walk
+ */
+typedef struct {
+    const char *content;      /**< Script source */
+    size_t content_len;       /**< Length of the source */
+    size_t cursor;            /**< Source position reached by the walk */
+    shell_mode_t target;      /**< Target shell for rewrites */
+    spawn_report_t *report;   /**< Report being filled */
+    const char **defined;     /**< Functions defined in the script */
+    size_t defined_count;     /**< Number of defined functions */
+    size_t defined_capacity;  /**< Allocated capacity */
+    int function;             /**< Current function index, -1 at top level */
+    unsigned depth;           /**< Current loop nesting */
+    unsigned long spawns;     /**< Unweighted spawns counted so far */
+    size_t base;              /**< Source offset of the text being walked */
+    bool base_valid;          /**< Whether node offsets map into the source */
+    bool failed;              /**< An allocation failed */
+} spawn_walk_t;
+
+static unsigned long g_spawn_budget = SPAWN_DEFAULT_BUDGET;
+
+static const char *idiom_messages[SPAWN_IDIOM_COUNT] = {
+    [SPAWN_IDIOM_CAT_SUBST] = "Command substitution of cat forks to read a file",
+    [SPAWN_IDIOM_ECHO_SUBST] = "Command substitution of echo forks to produce "
+                               "a value",
+    [SPAWN_IDIOM_BASENAME] = "basename runs in a separate process",
+    [SPAWN_IDIOM_DIRNAME] = "dirname runs in a separate process",
+    [SPAWN_IDIOM_EXPR] = "expr arithmetic runs in a separate process",
+    [SPAWN_IDIOM_ECHO_GREP] = "echo | grep -q forks a pipeline to match a "
+                              "string",
+    [SPAWN_IDIOM_WC_LINES] = "wc -l < file forks to count lines",
+};
+
+static const char *idiom_suggestions[SPAWN_IDIOM_COUNT] = {
+    [SPAWN_IDIOM_CAT_SUBST] = "Use $(<file) to read the file in the shell",
+    [SPAWN_IDIOM_ECHO_SUBST] = "Use the value directly",
+    [SPAWN_IDIOM_BASENAME] = "Use ${var##*/} parameter expansion",
+    [SPAWN_IDIOM_DIRNAME] = "Use ${var%/*} parameter expansion",
+    [SPAWN_IDIOM_EXPR] = "Use $(( )) arithmetic expansion",
+    [SPAWN_IDIOM_ECHO_GREP] = "Use case or [[ string =~ pattern ]]",
+    [SPAWN_IDIOM_WC_LINES] = "Count lines once outside the loop or keep a "
+                             "running count",
+};
+
+static void walk_node(spawn_walk_t *w, node_t *node, bool exec_in_place);
+
+/* ============================================================================
+ * Report Helpers
+ * ============================================================================ */
+
+/**
+ * @brief Weight of one spawn at a loop depth
+ */
+static unsigned long loop_weight(unsigned depth) {
+    unsigned long weight = 1;
+    for (unsigned i = 0; i < depth && i < SPAWN_MAX_WEIGHTED_DEPTH; i++) {
+        weight *= SPAWN_LOOP_WEIGHT;
+    }
+    return weight;
+}
+
+/**
+ * @brief Count spawns against the current function or the top level
+ */
+static void charge(spawn_walk_t *w, unsigned long count) {
+    unsigned long weighted = count * loop_weight(w->depth);
+
+    w->spawns += count;
+    if (w->function >= 0) {
+        w->report->functions[w->function].weighted_spawns += weighted;
+    } else {
+        w->report->toplevel_spawns += weighted;
+    }
+}
+
+/**
+ * @brief Compute the 1-based line and column of a source offset
+ */
+static void line_of(const char *content, size_t offset, int *line,
+                    int *column) {
+    int l = 1;
+    size_t line_start = 0;
+    for (size_t i = 0; i < offset && content[i]; i++) {
+        if (content[i] == '\n') {
+            l++;
+            line_start = i + 1;
+        }
+    }
+    *line = l;
+    *column = (int)(offset - line_start) + 1;
+}
+
+/**
+ * @brief Find text in the source at or after a position
+ */
+static bool find_text(const spawn_walk_t *w, const char *text, size_t len,
+                      size_t from, size_t *offset) {
+    if (len == 0) {
+        return false;
+    }
+    while (from + len <= w->content_len) {
+        const char *hit =
+            memchr(w->content + from, text[0], w->content_len - len + 1 - from);
+        if (!hit) {
+            return false;
+        }
+        size_t pos = (size_t)(hit - w->content);
+        if (memcmp(hit, text, len) == 0) {
+            *offset = pos;
+            return true;
+        }
+        from = pos + 1;
+    }
+    return false;
+}
+
+/**
+ * @brief Check whether a site already claims a source range
+ */
+static bool site_claimed(const spawn_walk_t *w, size_t offset, size_t len) {
+    for (size_t i = 0; i < w->report->site_count; i++) {
+        const spawn_site_t *site = &w->report->sites[i];
+        if (site->length == len && site->offset == offset) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Locate a construct in the source and advance the cursor past it
+ *
+ * Searches forward from the cursor first. If the walk has lost its place
+ * the whole source is searched for an occurrence no site has claimed.
+ */
+static bool locate(spawn_walk_t *w, const char *text, size_t len,
+                   size_t *offset) {
+    size_t pos;
+    if (find_text(w, text, len, w->cursor, &pos)) {
+        w->cursor = pos + 1;
+        *offset = pos;
+        return true;
+    }
+    for (size_t from = 0; find_text(w, text, len, from, &pos); from = pos + 1) {
+        if (!site_claimed(w, pos, len)) {
+            *offset = pos;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Move the cursor forward to a known source position
+ */
+static void advance_cursor(spawn_walk_t *w, size_t offset) {
+    if (offset > w->cursor && offset < w->content_len) {
+        w->cursor = offset;
+    }
+}
+
+/**
+ * @brief Record an idiom site
+ *
+ * @param offset Source offset of the construct, or SIZE_MAX if unknown
+ * @return The new site, or NULL on allocation failure
+ */
+static spawn_site_t *add_site(spawn_walk_t *w, spawn_idiom_t idiom,
+                              const char *text, size_t len, size_t offset,
+                              unsigned spawns) {
+    spawn_report_t *report = w->report;
+
+    if (report->site_count >= report->site_capacity) {
+        size_t cap = report->site_capacity ? report->site_capacity * 2
+                                           : SPAWN_INITIAL_CAPACITY;
+        spawn_site_t *sites = realloc(report->sites, cap * sizeof(*sites));
+        if (!sites) {
+            w->failed = true;
+            return NULL;
+        }
+        report->sites = sites;
+        report->site_capacity = cap;
+    }
+
+    char *original = strndup(text, len);
+    if (!original) {
+        w->failed = true;
+        return NULL;
+    }
+
+    spawn_site_t *site = &report->sites[report->site_count++];
+    memset(site, 0, sizeof(*site));
+    site->idiom = idiom;
+    site->original = original;
+    site->spawns = spawns;
+    site->loop_depth = w->depth;
+    site->weight = spawns * loop_weight(w->depth);
+    site->function = w->function;
+    site->fix_type = FIX_TYPE_MANUAL;
+    if (offset != SIZE_MAX) {
+        site->offset = offset;
+        site->length = len;
+        line_of(w->content, offset, &site->line, &site->column);
+    }
+    if (w->function >= 0) {
+        report->functions[w->function].site_count++;
+    }
+    return site;
+}
+
+/**
+ * @brief Attach a rewrite to a site
+ *
+ * @param extended The rewrite uses syntax beyond POSIX sh
+ * @param type Fix safety when the target supports the rewrite
+ */
+static void set_rewrite(spawn_walk_t *w, spawn_site_t *site, char *replacement,
+                        bool extended, fix_type_t type) {
+    if (!site || !replacement) {
+        free(replacement);
+        return;
+    }
+    site->replacement = replacement;
+    if (extended && w->target == SHELL_MODE_POSIX) {
+        site->fix_type = FIX_TYPE_MANUAL;
+    } else {
+        site->fix_type = type;
+    }
+}
+
+/* ============================================================================
+ * Word Scanning
+ * ============================================================================ */
+
+/**
+ * @brief Find the bracket closing the one at open
+ *
+ * Quotes and escapes are skipped. Returns len if the bracket is unmatched.
+ */
+static size_t match_bracket(const char *s, size_t len, size_t open) {
+    char open_ch = s[open];
+    char close_ch = open_ch == '(' ? ')' : '}';
+    int depth = 0;
+
+    for (size_t i = open; i < len; i++) {
+        char c = s[i];
+        if (c == '\\') {
+            i++;
+        } else if (c == '\'') {
+            while (++i < len && s[i] != '\'') {
+            }
+        } else if (c == '"') {
+            while (++i < len && s[i] != '"') {
+                if (s[i] == '\\') {
+                    i++;
+                }
+            }
+        } else if (c == open_ch) {
+            depth++;
+        } else if (c == close_ch && --depth == 0) {
+            return i;
+        }
+    }
+    return len;
+}
+
+/**
+ * @brief Split simple command text into raw words
+ *
+ * Words keep their quotes. A lone | or < is returned as its own word.
+ * Scanning stops at a list operator, newline, comment or closing
+ * parenthesis; *end receives the end of the last word.
+ *
+ * @return Number of words, or -1 for syntax beyond plain words
+ */
+static int split_words(const char *s, size_t len, span_t *words, int max,
+                       size_t *end) {
+    int n = 0;
+    size_t i = 0;
+
+    for (;;) {
+        while (i < len && (s[i] == ' ' || s[i] == '\t')) {
+            i++;
+        }
+        if (i >= len || strchr("\n;&)#", s[i])) {
+            break;
+        }
+        if (n == max) {
+            return -1;
+        }
+        if (s[i] == '|') {
+            if (i + 1 < len && s[i + 1] == '|') {
+                break;
+            }
+            words[n++] = (span_t){i, 1};
+            i++;
+            continue;
+        }
+        if (s[i] == '<') {
+            if (i + 1 < len && strchr("<(&>", s[i + 1])) {
+                return -1;
+            }
+            words[n++] = (span_t){i, 1};
+            i++;
+            continue;
+        }
+        if (s[i] == '>' || s[i] == '(') {
+            return -1;
+        }
+
+        size_t start = i;
+        while (i < len) {
+            char c = s[i];
+            if (c == '\\') {
+                i += 2;
+            } else if (c == '\'' || c == '"' || c == '`') {
+                size_t close = i + 1;
+                while (close < len && s[close] != c) {
+                    if (c != '\'' && s[close] == '\\') {
+                        close++;
+                    }
+                    close++;
+                }
+                if (close >= len) {
+                    return -1;
+                }
+                i = close + 1;
+            } else if (c == '$' && i + 1 < len &&
+                       (s[i + 1] == '(' || s[i + 1] == '{')) {
+                size_t close = match_bracket(s, len, i + 1);
+                if (close >= len) {
+                    return -1;
+                }
+                i = close + 1;
+            } else if (strchr(" \t\n;&|<>()", c)) {
+                break;
+            } else {
+                i++;
+            }
+        }
+        if (i > len) {
+            i = len;
+        }
+        words[n++] = (span_t){start, i - start};
+    }
+
+    if (end) {
+        *end = n > 0 ? words[n - 1].start + words[n - 1].len : 0;
+    }
+    return n;
+}
+
+/**
+ * @brief Compare a raw word with a literal
+ */
+static bool word_is(const char *s, span_t word, const char *literal) {
+    return strlen(literal) == word.len &&
+           memcmp(s + word.start, literal, word.len) == 0;
+}
+
+/**
+ * @brief Check for a parameter reference: $name, ${name} or either quoted
+ *
+ * @param name Receives the parameter name
+ */
+static bool is_param_ref(const char *s, span_t word, char *name,
+                         size_t name_size) {
+    const char *p = s + word.start;
+    size_t n = word.len;
+
+    if (n >= 2 && p[0] == '"' && p[n - 1] == '"') {
+        p++;
+        n -= 2;
+    }
+    if (n < 2 || p[0] != '$') {
+        return false;
+    }
+    p++;
+    n--;
+    if (p[0] == '{') {
+        if (n < 3 || p[n - 1] != '}') {
+            return false;
+        }
+        p++;
+        n -= 2;
+    }
+    if (n == 0 || n >= name_size || !(isalpha((unsigned char)p[0]) ||
+                                      p[0] == '_')) {
+        return false;
+    }
+    for (size_t i = 1; i < n; i++) {
+        if (!isalnum((unsigned char)p[i]) && p[i] != '_') {
+            return false;
+        }
+    }
+    memcpy(name, p, n);
+    name[n] = '\0';
+    return true;
+}
+
+/**
+ * @brief Check for a word made only of characters that need no quoting
+ */
+static bool is_plain_literal(const char *p, size_t n) {
+    if (n == 0 || p[0] == '-') {
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!isalnum((unsigned char)p[i]) && !strchr("_./:,=+@%-", p[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Check whether echo prints a word verbatim
+ *
+ * @param safe Set when the word also needs no word splitting or globbing,
+ *             so replacing $(echo word) with it behaves the same anywhere
+ */
+static bool echo_arg_is_plain(const char *s, span_t word, bool *safe) {
+    const char *p = s + word.start;
+    size_t n = word.len;
+
+    *safe = false;
+    if (is_plain_literal(p, n)) {
+        *safe = true;
+        return true;
+    }
+    if (n < 2 || (p[0] != '"' && p[0] != '\'') || p[n - 1] != p[0]) {
+        return false;
+    }
+    const char *inner = p + 1;
+    size_t inner_len = n - 2;
+    if (inner_len > 0 && inner[0] == '-') {
+        return false;
+    }
+    for (size_t i = 0; i < inner_len; i++) {
+        if (strchr("\\`\n", inner[i])) {
+            return false;
+        }
+    }
+    *safe = is_plain_literal(inner, inner_len);
+    return true;
+}
+
+/**
+ * @brief Check whether $(<word) reads the same file as $(cat word)
+ *
+ * A redirection target is neither split nor allowed to glob to several
+ * files, so unquoted glob characters rule the rewrite out.
+ *
+ * @param safe Set when the word has no unquoted expansion either, so
+ *             field splitting cannot make cat see several arguments
+ */
+static bool cat_target_is_file(const char *s, span_t word, bool *safe) {
+    const char *p = s + word.start;
+    char quote = '\0';
+
+    *safe = true;
+    if (word.len == 0 || p[0] == '-') {
+        return false;
+    }
+    for (size_t i = 0; i < word.len; i++) {
+        char c = p[i];
+        if (quote == '\'') {
+            if (c == '\'') {
+                quote = '\0';
+            }
+        } else if (c == '\\') {
+            i++;
+        } else if (c == '"') {
+            quote = quote ? '\0' : '"';
+        } else if (quote) {
+            continue;
+        } else if (c == '\'') {
+            quote = '\'';
+        } else if (strchr("*?[", c)) {
+            return false;
+        } else if (c == '$' || c == '`') {
+            *safe = false;
+        }
+    }
+    return quote == '\0';
+}
+
+/**
+ * @brief Check for an expr operand that is valid in $(( ))
+ *
+ * @param out Receives the operand without surrounding double quotes
+ */
+static bool expr_operand(const char *s, span_t word, char *out,
+                         size_t out_size) {
+    const char *p = s + word.start;
+    size_t n = word.len;
+    char name[SPAWN_NAME_MAX];
+
+    if (is_param_ref(s, word, name, sizeof(name))) {
+        if (n >= 2 && p[0] == '"') {
+            p++;
+            n -= 2;
+        }
+    } else {
+        size_t i = (n > 1 && p[0] == '-') ? 1 : 0;
+        if (i == n) {
+            return false;
+        }
+        for (; i < n; i++) {
+            if (!isdigit((unsigned char)p[i])) {
+                return false;
+            }
+        }
+    }
+    if (n >= out_size) {
+        return false;
+    }
+    memcpy(out, p, n);
+    out[n] = '\0';
+    return true;
+}
+
+/**
+ * @brief Map an expr operator word to its arithmetic operator
+ */
+static char expr_operator(const char *s, span_t word) {
+    if (word_is(s, word, "+") || word_is(s, word, "-") ||
+        word_is(s, word, "/") || word_is(s, word, "%")) {
+        return s[word.start];
+    }
+    if (word_is(s, word, "\\*") || word_is(s, word, "'*'") ||
+        word_is(s, word, "\"*\"")) {
+        return '*';
+    }
+    return '\0';
+}
+
+/**
+ * @brief Build $(( )) from expr arguments, NULL if they are not arithmetic
+ */
+static char *expr_rewrite(const char *s, const span_t *words, int n) {
+    if (n < 4 || n % 2 != 0) {
+        return NULL;
+    }
+
+    size_t cap = 8;
+    for (int i = 1; i < n; i++) {
+        cap += words[i].len + 1;
+    }
+    char *out = malloc(cap);
+    if (!out) {
+        return NULL;
+    }
+
+    size_t len = (size_t)snprintf(out, cap, "$((");
+    for (int i = 1; i < n; i++) {
+        char operand[SPAWN_NAME_MAX];
+        if (i % 2 == 1) {
+            if (!expr_operand(s, words[i], operand, sizeof(operand))) {
+                free(out);
+                return NULL;
+            }
+            len += (size_t)snprintf(out + len, cap - len, "%s", operand);
+        } else {
+            char op = expr_operator(s, words[i]);
+            if (!op) {
+                free(out);
+                return NULL;
+            }
+            len += (size_t)snprintf(out + len, cap - len, " %c ", op);
+        }
+    }
+    snprintf(out + len, cap - len, "))");
+    return out;
+}
+
+/**
+ * @brief Strip quotes from a grep pattern that is a plain identifier
+ *
+ * Such patterns mean the same as a basic and an extended regex, so
+ * grep and [[ =~ ]] agree on them.
+ */
+static bool literal_pattern(const char *s, span_t word, char *out,
+                            size_t out_size) {
+    const char *p = s + word.start;
+    size_t n = word.len;
+
+    if (n >= 2 && (p[0] == '\'' || p[0] == '"') && p[n - 1] == p[0]) {
+        p++;
+        n -= 2;
+    }
+    if (n == 0 || n >= out_size) {
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!isalnum((unsigned char)p[i]) && p[i] != '_') {
+            return false;
+        }
+    }
+    memcpy(out, p, n);
+    out[n] = '\0';
+    return true;
+}
+
+/* ============================================================================
+ * Idiom Classification
+ * ============================================================================ */
+
+/**
+ * @brief Record a command substitution that matches a known idiom
+ *
+ * @param whole The substitution including $( ) or backquotes
+ * @param cmd The command inside the substitution
+ * @param offset Source offset of whole, or SIZE_MAX
+ */
+static void classify_substitution(spawn_walk_t *w, const char *whole,
+                                  size_t whole_len, const char *cmd,
+                                  size_t offset, unsigned spawns) {
+    span_t words[SPAWN_MAX_WORDS];
+    int n = split_words(cmd, strlen(cmd), words, SPAWN_MAX_WORDS, NULL);
+    if (n < 1) {
+        return;
+    }
+
+    char name[SPAWN_NAME_MAX];
+    spawn_site_t *site = NULL;
+    char *replacement = NULL;
+
+    if (word_is(cmd, words[0], "cat") && n >= 2) {
+        site = add_site(w, SPAWN_IDIOM_CAT_SUBST, whole, whole_len, offset,
+                        spawns);
+        bool safe = false;
+        if (n == 2 && !word_is(cmd, words[1], "|") &&
+            !word_is(cmd, words[1], "<") &&
+            cat_target_is_file(cmd, words[1], &safe)) {
+            size_t cap = words[1].len + 5;
+            replacement = malloc(cap);
+            if (replacement) {
+                snprintf(replacement, cap, "$(<%.*s)", (int)words[1].len,
+                         cmd + words[1].start);
+            }
+            set_rewrite(w, site, replacement, true,
+                        safe ? FIX_TYPE_SAFE : FIX_TYPE_UNSAFE);
+        }
+    } else if (word_is(cmd, words[0], "echo") && n >= 2) {
+        bool safe = false;
+        site = add_site(w, SPAWN_IDIOM_ECHO_SUBST, whole, whole_len, offset,
+                        spawns);
+        if (n == 2 && echo_arg_is_plain(cmd, words[1], &safe)) {
+            replacement = strndup(cmd + words[1].start, words[1].len);
+            set_rewrite(w, site, replacement, false,
+                        safe ? FIX_TYPE_SAFE : FIX_TYPE_UNSAFE);
+        }
+    } else if ((word_is(cmd, words[0], "basename") ||
+                word_is(cmd, words[0], "dirname")) &&
+               n >= 2) {
+        bool base = word_is(cmd, words[0], "basename");
+        site = add_site(w,
+                        base ? SPAWN_IDIOM_BASENAME : SPAWN_IDIOM_DIRNAME,
+                        whole, whole_len, offset, spawns);
+        if (n == 2 && is_param_ref(cmd, words[1], name, sizeof(name))) {
+            size_t cap = strlen(name) + 8;
+            replacement = malloc(cap);
+            if (replacement) {
+                snprintf(replacement, cap, base ? "${%s##*/}" : "${%s%%/*}",
+                         name);
+            }
+            /* Trailing slashes and slash-free paths behave differently */
+            set_rewrite(w, site, replacement, false, FIX_TYPE_UNSAFE);
+        }
+    } else if (word_is(cmd, words[0], "expr") && n >= 2) {
+        site = add_site(w, SPAWN_IDIOM_EXPR, whole, whole_len, offset, spawns);
+        /* expr exits 1 for a zero result and rejects empty operands, and
+         * $(( )) reads leading zeros as octal */
+        set_rewrite(w, site, expr_rewrite(cmd, words, n), false,
+                    FIX_TYPE_UNSAFE);
+    } else if (word_is(cmd, words[0], "wc") && n == 4 &&
+               word_is(cmd, words[1], "-l") && word_is(cmd, words[2], "<")) {
+        add_site(w, SPAWN_IDIOM_WC_LINES, whole, whole_len, offset, spawns);
+    }
+}
+
+/**
+ * @brief Record an echo | grep -q pipeline
+ *
+ * The pipeline is located from the echo command's source position and
+ * must consist of exactly echo WORD | grep -q PATTERN.
+ */
+static void classify_pipeline(spawn_walk_t *w, node_t *pipe, unsigned spawns) {
+    node_t *left = pipe->first_child;
+    node_t *right = left ? left->next_sibling : NULL;
+
+    if (!left || !right || right->next_sibling ||
+        left->type != NODE_COMMAND || right->type != NODE_COMMAND ||
+        left->val_type != VAL_STR || right->val_type != VAL_STR ||
+        !left->val.str || !right->val.str ||
+        strcmp(left->val.str, "echo") != 0 ||
+        strcmp(right->val.str, "grep") != 0 || left->loc.line == 0 ||
+        !w->base_valid) {
+        return;
+    }
+
+    size_t offset = w->base + left->loc.offset;
+    if (offset + 4 > w->content_len ||
+        strncmp(w->content + offset, "echo", 4) != 0) {
+        return;
+    }
+
+    const char *s = w->content + offset;
+    span_t words[SPAWN_MAX_WORDS];
+    size_t end = 0;
+    int n = split_words(s, w->content_len - offset, words, SPAWN_MAX_WORDS,
+                        &end);
+    if (n < 4 || !word_is(s, words[2], "|") || !word_is(s, words[3], "grep") ||
+        memchr(s, '\n', end)) {
+        return;
+    }
+
+    spawn_site_t *site =
+        add_site(w, SPAWN_IDIOM_ECHO_GREP, s, end, offset, spawns);
+
+    char pattern[SPAWN_NAME_MAX];
+    if (site && n == 6 && word_is(s, words[4], "-q") &&
+        s[words[1].start] != '-' &&
+        !memchr(s + words[1].start, '\\', words[1].len) &&
+        literal_pattern(s, words[5], pattern, sizeof(pattern))) {
+        size_t cap = words[1].len + strlen(pattern) + 16;
+        char *replacement = malloc(cap);
+        if (replacement) {
+            snprintf(replacement, cap, "[[ %.*s =~ %s ]]", (int)words[1].len,
+                     s + words[1].start, pattern);
+        }
+        set_rewrite(w, site, replacement, true, FIX_TYPE_SAFE);
+    }
+}
+
+/* ============================================================================
+ * AST Walk
+ * ============================================================================ */
+
+/**
+ * @brief Walk a sibling list
+ */
+static void walk_list(spawn_walk_t *w, node_t *node, bool exec_in_place) {
+    for (; node && !w->failed; node = node->next_sibling) {
+        walk_node(w, node, exec_in_place);
+    }
+}
+
+/**
+ * @brief Charge and walk one command substitution
+ *
+ * @param whole The substitution including $( ) or backquotes
+ * @param inner The command inside it
+ */
+static void visit_substitution(spawn_walk_t *w, const char *whole,
+                               size_t whole_len, const char *inner,
+                               size_t inner_len) {
+    size_t offset = SIZE_MAX;
+    bool located = locate(w, whole, whole_len, &offset);
+    unsigned long before = w->spawns;
+
+    charge(w, 1);
+
+    char *cmd = strndup(inner, inner_len);
+    if (!cmd) {
+        w->failed = true;
+        return;
+    }
+
+    parser_t *parser = parser_new(cmd);
+    node_t *ast = parser ? parser_parse(parser) : NULL;
+
+    size_t saved_base = w->base;
+    bool saved_valid = w->base_valid;
+    w->base = located ? offset + (size_t)(inner - whole) : 0;
+    w->base_valid = located;
+    walk_list(w, ast, false);
+    w->base = saved_base;
+    w->base_valid = saved_valid;
+
+    if (ast) {
+        free_node_tree(ast);
+    }
+    if (parser) {
+        parser_free(parser);
+    }
+
+    classify_substitution(w, whole, whole_len, cmd, offset,
+                          (unsigned)(w->spawns - before));
+    free(cmd);
+}
+
+/**
+ * @brief Find and walk the command substitutions in a word
+ *
+ * @param honor_single_quotes False for text that came from inside double
+ *        quotes, where a single quote is an ordinary character
+ */
+static void scan_word(spawn_walk_t *w, const char *text,
+                      bool honor_single_quotes) {
+    size_t len = strlen(text);
+
+    for (size_t i = 0; i < len && !w->failed;) {
+        char c = text[i];
+        if (c == '\\') {
+            i += 2;
+        } else if (c == '\'' && honor_single_quotes) {
+            const char *close = strchr(text + i + 1, '\'');
+            i = close ? (size_t)(close - text) + 1 : len;
+        } else if (c == '$' && i + 1 < len && text[i + 1] == '(') {
+            size_t close = match_bracket(text, len, i + 1);
+            if (close >= len) {
+                return;
+            }
+            if (text[i + 2] != '(') {
+                visit_substitution(w, text + i, close + 1 - i, text + i + 2,
+                                   close - i - 2);
+            }
+            i = close + 1;
+        } else if (c == '`') {
+            size_t close = i + 1;
+            while (close < len && text[close] != '`') {
+                if (text[close] == '\\') {
+                    close++;
+                }
+                close++;
+            }
+            if (close >= len) {
+                return;
+            }
+            visit_substitution(w, text + i, close + 1 - i, text + i + 1,
+                               close - i - 1);
+            i = close + 1;
+        } else {
+            i++;
+        }
+    }
+}
+
+/**
+ * @brief Check whether a command word is a variable assignment
+ */
+static bool is_assignment(const char *word) {
+    if (!isalpha((unsigned char)word[0]) && word[0] != '_') {
+        return false;
+    }
+    const char *p = word + 1;
+    while (isalnum((unsigned char)*p) || *p == '_') {
+        p++;
+    }
+    return *p == '=' || (p[0] == '+' && p[1] == '=');
+}
+
+/**
+ * @brief Check whether a command runs inside the shell
+ */
+static bool runs_in_shell(const spawn_walk_t *w, const char *name) {
+    if (is_builtin(name)) {
+        return true;
+    }
+    for (size_t i = 0; i < w->defined_count; i++) {
+        if (strcmp(w->defined[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Walk a simple command
+ *
+ * @param exec_in_place The command already runs in a forked child (a
+ *        pipeline stage or background job), so an exec adds no process
+ */
+static void walk_command(spawn_walk_t *w, node_t *node, bool exec_in_place) {
+    const char *name = node->val_type == VAL_STR ? node->val.str : NULL;
+
+    if (name) {
+        scan_word(w, name, true);
+    }
+    walk_list(w, node->first_child, false);
+
+    if (name && *name && !exec_in_place && !is_assignment(name) &&
+        !runs_in_shell(w, name)) {
+        charge(w, 1);
+    }
+}
+
+/**
+ * @brief Walk a pipeline, charging one process per stage
+ */
+static void walk_pipe(spawn_walk_t *w, node_t *node) {
+    unsigned long before = w->spawns;
+
+    for (node_t *child = node->first_child; child && !w->failed;
+         child = child->next_sibling) {
+        if (child->type == NODE_PIPE) {
+            walk_pipe(w, child);
+            continue;
+        }
+        charge(w, 1);
+        walk_node(w, child, true);
+    }
+
+    classify_pipeline(w, node, (unsigned)(w->spawns - before));
+}
+
+/**
+ * @brief Register a function and find its definition in the source
+ */
+static int add_function(spawn_walk_t *w, const char *name) {
+    spawn_report_t *report = w->report;
+
+    if (report->function_count >= report->function_capacity) {
+        size_t cap = report->function_capacity
+                         ? report->function_capacity * 2
+                         : SPAWN_INITIAL_CAPACITY;
+        spawn_function_t *functions =
+            realloc(report->functions, cap * sizeof(*functions));
+        if (!functions) {
+            w->failed = true;
+            return -1;
+        }
+        report->functions = functions;
+        report->function_capacity = cap;
+    }
+
+    char *copy = strdup(name);
+    if (!copy) {
+        w->failed = true;
+        return -1;
+    }
+
+    spawn_function_t *fn = &report->functions[report->function_count];
+    memset(fn, 0, sizeof(*fn));
+    fn->name = copy;
+
+    /* The definition is "name ()" or "function name" */
+    size_t len = strlen(name);
+    size_t pos;
+    for (size_t from = w->cursor; find_text(w, name, len, from, &pos);
+         from = pos + 1) {
+        const char *p = w->content + pos;
+        if (pos > 0 && (isalnum((unsigned char)p[-1]) || p[-1] == '_')) {
+            continue;
+        }
+        const char *after = p + len;
+        while (*after == ' ' || *after == '\t') {
+            after++;
+        }
+        const char *before = p;
+        while (before > w->content && (before[-1] == ' ' || before[-1] == '\t')) {
+            before--;
+        }
+        bool keyword = (size_t)(before - w->content) >= 8 &&
+                       strncmp(before - 8, "function", 8) == 0;
+        if (*after == '(' || keyword) {
+            int column;
+            line_of(w->content, pos, &fn->line, &column);
+            w->cursor = pos + 1;
+            break;
+        }
+    }
+
+    return (int)report->function_count++;
+}
+
+/**
+ * @brief Walk a node and its children
+ */
+static void walk_node(spawn_walk_t *w, node_t *node, bool exec_in_place) {
+    if (node->loc.line > 0 && w->base_valid) {
+        advance_cursor(w, w->base + node->loc.offset);
+    }
+
+    switch (node->type) {
+    case NODE_COMMAND:
+        walk_command(w, node, exec_in_place);
+        break;
+
+    case NODE_PIPE:
+    case NODE_PIPELINE:
+        walk_pipe(w, node);
+        break;
+
+    case NODE_FOR:
+    case NODE_SELECT:
+        /* The word list is expanded once; the body runs per iteration */
+        if (node->first_child) {
+            walk_node(w, node->first_child, false);
+            w->depth++;
+            walk_list(w, node->first_child->next_sibling, false);
+            w->depth--;
+        }
+        break;
+
+    case NODE_FOR_ARITH:
+    case NODE_WHILE:
+    case NODE_UNTIL:
+        w->depth++;
+        walk_list(w, node->first_child, false);
+        w->depth--;
+        break;
+
+    case NODE_FUNCTION: {
+        if (node->val_type != VAL_STR || !node->val.str) {
+            break;
+        }
+        int saved_function = w->function;
+        unsigned saved_depth = w->depth;
+        int index = add_function(w, node->val.str);
+        if (index < 0) {
+            break;
+        }
+        w->function = index;
+        w->depth = 0;
+        walk_list(w, node->first_child, false);
+        w->function = saved_function;
+        w->depth = saved_depth;
+        break;
+    }
+
+    case NODE_SUBSHELL:
+        if (!exec_in_place) {
+            charge(w, 1);
+        }
+        walk_list(w, node->first_child, false);
+        break;
+
+    case NODE_BACKGROUND:
+    case NODE_COPROC:
+    case NODE_PROC_SUB_IN:
+    case NODE_PROC_SUB_OUT:
+        charge(w, 1);
+        walk_list(w, node->first_child, true);
+        break;
+
+    case NODE_STRING_LITERAL:
+        break;
+
+    case NODE_REDIR_HEREDOC:
+    case NODE_REDIR_HEREDOC_STRIP: {
+        /* Children are the body and a flag that is "0" for quoted
+         * delimiters, whose bodies are not expanded */
+        node_t *body = node->first_child;
+        node_t *flag = body ? body->next_sibling : NULL;
+        bool expands = !flag || flag->val_type != VAL_STR || !flag->val.str ||
+                       strcmp(flag->val.str, "0") != 0;
+        if (body && expands && body->val_type == VAL_STR && body->val.str) {
+            scan_word(w, body->val.str, false);
+        }
+        break;
+    }
+
+    default:
+        if (node->val_type == VAL_STR && node->val.str) {
+            scan_word(w, node->val.str, node->type != NODE_STRING_EXPANDABLE);
+        }
+        walk_list(w, node->first_child, false);
+        break;
+    }
+}
+
+/**
+ * @brief Collect the names of functions defined anywhere in the script
+ */
+static void collect_functions(spawn_walk_t *w, node_t *node) {
+    for (; node && !w->failed; node = node->next_sibling) {
+        if (node->type == NODE_FUNCTION && node->val_type == VAL_STR &&
+            node->val.str) {
+            if (w->defined_count >= w->defined_capacity) {
+                size_t cap = w->defined_capacity ? w->defined_capacity * 2
+                                                 : SPAWN_INITIAL_CAPACITY;
+                const char **defined =
+                    realloc(w->defined, cap * sizeof(*defined));
+                if (!defined) {
+                    w->failed = true;
+                    return;
+                }
+                w->defined = defined;
+                w->defined_capacity = cap;
+            }
+            w->defined[w->defined_count++] = node->val.str;
+        }
+        collect_functions(w, node->first_child);
+    }
+}
+
+/**
+ * @brief Order sites by source position, unlocated sites last
+ */
+static int compare_sites(const void *a, const void *b) {
+    const spawn_site_t *sa = (const spawn_site_t *)a;
+    const spawn_site_t *sb = (const spawn_site_t *)b;
+
+    if ((sa->length == 0) != (sb->length == 0)) {
+        return sa->length == 0 ? 1 : -1;
+    }
+    if (sa->offset != sb->offset) {
+        return sa->offset < sb->offset ? -1 : 1;
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+bool spawn_analyze(const char *content, node_t *ast, shell_mode_t target,
+                   spawn_report_t *report) {
+    if (!report) {
+        return false;
+    }
+    memset(report, 0, sizeof(*report));
+    if (!content || !ast) {
+        return true;
+    }
+
+    spawn_walk_t w = {
+        .content = content,
+        .content_len = strlen(content),
+        .target = target,
+        .report = report,
+        .function = -1,
+        .base_valid = true,
+    };
+
+    collect_functions(&w, ast);
+    walk_list(&w, ast, false);
+    free(w.defined);
+
+    if (w.failed) {
+        spawn_report_free(report);
+        return false;
+    }
+
+    qsort(report->sites, report->site_count, sizeof(spawn_site_t),
+          compare_sites);
+    return true;
+}
+
+void spawn_report_free(spawn_report_t *report) {
+    if (!report) {
+        return;
+    }
+    for (size_t i = 0; i < report->site_count; i++) {
+        free(report->sites[i].original);
+        free(report->sites[i].replacement);
+    }
+    for (size_t i = 0; i < report->function_count; i++) {
+        free(report->functions[i].name);
+    }
+    free(report->sites);
+    free(report->functions);
+    memset(report, 0, sizeof(*report));
+}
+
+const char *spawn_idiom_message(spawn_idiom_t idiom) {
+    if (idiom >= SPAWN_IDIOM_COUNT) {
+        return "Process spawn";
+    }
+    return idiom_messages[idiom];
+}
+
+const char *spawn_idiom_suggestion(spawn_idiom_t idiom) {
+    if (idiom >= SPAWN_IDIOM_COUNT) {
+        return "Use a builtin or expansion instead";
+    }
+    return idiom_suggestions[idiom];
+}
+
+void spawn_set_budget(unsigned long budget) {
+    g_spawn_budget = budget ? budget : SPAWN_DEFAULT_BUDGET;
+}
+
+unsigned long spawn_get_budget(void) {
+    return g_spawn_budget;
+}
@@ -0,0 +1,680 @@
+/**
+ * @file startup_cache.c
+ * @brief Cache of parsed startup files
+ *
+ * One cache file per startup file, named after a hash of its path. The
+ * file starts with a header identifying the source file, followed by one
+ * record per construct in file order:
+ *
+ *     u32 text length, text
+ *     u64 file offset after the construct
+ *     u64 parser feature mask the construct was parsed under
+ *     u32 tree size (0 if the construct is kept as text), tree
+ *
+ * A tree is a sibling chain: a u32 node count and, for each node in
+ * order, its fields followed by the chain of its children. Entries are
+ * written to a temporary file and renamed into place, and are checked
+ * field by field when read, so a stale, truncated or foreign file is
+ * rebuilt, never trusted.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "startup_cache.h"
+
+#include "cache_file.h"
+#include "executor.h"
+#include "ht.h"
+#include "input.h"
+#include "lush.h"
+#include "node.h"
+#include "parser.h"
+#include "version.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* ============================================================================
+ * Format
+ * ============================================================================ */
+
+#define STARTUP_CACHE_MAGIC "LUSHSTC"
+#define STARTUP_CACHE_FORMAT 1
+
+/** Length marker for a NULL string value */
+#define NO_STRING UINT32_MAX
+
+/** Node flags */
+#define NODE_HAS_PREV 0x1u     /**< prev_sibling was set */
+#define NODE_HAS_FILENAME 0x2u /**< loc.filename was set */
+
+/**
+ * @brief Cache file header
+ */
+typedef struct {
+    char magic[8];             /**< STARTUP_CACHE_MAGIC */
+    uint32_t format;           /**< STARTUP_CACHE_FORMAT */
+    uint32_t node_size;        /**< sizeof(node_t) of the writer */
+    uint64_t version_hash;     /**< Hash of the lush version */
+    uint64_t dev;              /**< Source file device */
+    uint64_t ino;              /**< Source file inode */
+    int64_t size;              /**< Source file size */
+    int64_t mtime_sec;         /**< Source file modification time */
+    int64_t mtime_nsec;
+    uint32_t path_len;         /**< Length of the path that follows */
+    uint32_t construct_count;  /**< Construct records that follow */
+} startup_cache_header_t;
+
+/* ============================================================================
+ * Internal Types
+ * ============================================================================ */
+
+typedef enum {
+    SCRIPT_PASSTHROUGH, /**< Read and parse the file, record nothing */
+    SCRIPT_REPLAY,      /**< Constructs come from the cache entry */
+    SCRIPT_RECORD,      /**< Read the file and record a cache entry */
+} script_mode_t;
+
+/**
+ * @brief Growable output buffer
+ */
+typedef struct {
+    unsigned char *data;
+    size_t len;
+    size_t cap;
+    bool failed;
+} out_buf_t;
+
+/**
+ * @brief Bounds-checked input cursor
+ */
+typedef struct {
+    const unsigned char *data;
+    size_t len;
+    size_t pos;
+    bool failed;
+} in_buf_t;
+
+struct startup_script {
+    script_mode_t mode;
+    char *path;
+    FILE *file;
+    struct stat st;
+    char cache_file[PATH_MAX];
+
+    /* Replay */
+    unsigned char *image;      /**< Whole cache file */
+    in_buf_t in;               /**< Cursor over the construct records */
+    uint32_t remaining;        /**< Records not yet read */
+    const unsigned char *tree; /**< Tree of the construct last read */
+    uint32_t tree_size;
+    uint64_t features;         /**< Feature mask of the construct last read */
+
+    /* Record */
+    out_buf_t out;             /**< Construct records written so far */
+    uint32_t recorded;         /**< Records in out */
+    bool pending;              /**< Last read construct not yet recorded */
+    char *pending_text;
+    uint64_t pending_offset;
+    bool at_eof;
+};
+
+/* ============================================================================
+ * State
+ * ============================================================================ */
+
+static bool cache_enabled = true;
+static char cache_dir_override[PATH_MAX];
+static bool cache_dir_override_set = false;
+static startup_cache_stats_t stats;
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static uint64_t version_hash(void) {
+    return fnv1a_hash_bytes(LUSH_VERSION_STRING, sizeof(LUSH_VERSION_STRING),
+                            FNV1A_OFFSET);
+}
+
+/**
+ * @brief Resolve the cache file for a startup file
+ * @return false if no cache directory is known
+ */
+static bool entry_path(const char *path, char *buf, size_t size) {
+    char dir[PATH_MAX];
+    if (cache_dir_override_set) {
+        snprintf(dir, sizeof(dir), "%s", cache_dir_override);
+    } else if (!cache_file_path(STARTUP_CACHE_DIR, dir, sizeof(dir))) {
+        return false;
+    }
+    if (!dir[0]) {
+        return false;
+    }
+
+    uint64_t h = fnv1a_hash_bytes(path, strlen(path), FNV1A_OFFSET);
+    int n = snprintf(buf, size, "%s/%016llx.cache", dir,
+                     (unsigned long long)h);
+    return n > 0 && (size_t)n < size;
+}
+
+/* ============================================================================
+ * Output Buffer
+ * ============================================================================ */
+
+static void out_bytes(out_buf_t *out, const void *data, size_t len) {
+    if (out->failed) {
+        return;
+    }
+    if (out->len + len > out->cap) {
+        size_t cap = out->cap ? out->cap : 4096;
+        while (cap < out->len + len) {
+            cap *= 2;
+        }
+        unsigned char *grown = realloc(out->data, cap);
+        if (!grown) {
+            out->failed = true;
+            return;
+        }
+        out->data = grown;
+        out->cap = cap;
+    }
+    memcpy(out->data + out->len, data, len);
+    out->len += len;
+}
+
+static void out_u32(out_buf_t *out, uint32_t v) { out_bytes(out, &v, 4); }
+static void out_u64(out_buf_t *out, uint64_t v) { out_bytes(out, &v, 8); }
+
+/**
+ * @brief Append a sibling chain
+ */
+static void out_chain(out_buf_t *out, const node_t *node) {
+    uint32_t count = 0;
+    for (const node_t *n = node; n; n = n->next_sibling) {
+        count++;
+    }
+    out_u32(out, count);
+
+    for (const node_t *n = node; n; n = n->next_sibling) {
+        uint32_t flags = 0;
+        if (n->prev_sibling) {
+            flags |= NODE_HAS_PREV;
+        }
+        if (n->loc.filename) {
+            flags |= NODE_HAS_FILENAME;
+        }
+        out_u32(out, (uint32_t)n->type);
+        out_u32(out, (uint32_t)n->val_type);
+        out_u32(out, flags);
+        out_u64(out, (uint64_t)n->children);
+
+        if (n->val_type == VAL_STR) {
+            if (n->val.str) {
+                size_t len = strlen(n->val.str);
+                out_u32(out, (uint32_t)len);
+                out_bytes(out, n->val.str, len);
+            } else {
+                out_u32(out, NO_STRING);
+            }
+        } else {
+            out_bytes(out, &n->val, sizeof(n->val));
+        }
+
+        out_u64(out, (uint64_t)n->loc.line);
+        out_u64(out, (uint64_t)n->loc.column);
+        out_u64(out, (uint64_t)n->loc.offset);
+        out_u64(out, (uint64_t)n->loc.length);
+
+        out_chain(out, n->first_child);
+    }
+}
+
+/* ============================================================================
+ * Input Cursor
+ * ============================================================================ */
+
+static const unsigned char *in_bytes(in_buf_t *in, size_t len) {
+    if (in->failed || len > in->len - in->pos) {
+        in->failed = true;
+        return NULL;
+    }
+    const unsigned char *p = in->data + in->pos;
+    in->pos += len;
+    return p;
+}
+
+static uint32_t in_u32(in_buf_t *in) {
+    uint32_t v = 0;
+    const unsigned char *p = in_bytes(in, 4);
+    if (p) {
+        memcpy(&v, p, 4);
+    }
+    return v;
+}
+
+static uint64_t in_u64(in_buf_t *in) {
+    uint64_t v = 0;
+    const unsigned char *p = in_bytes(in, 8);
+    if (p) {
+        memcpy(&v, p, 8);
+    }
+    return v;
+}
+
+/**
+ * @brief Rebuild a sibling chain
+ *
+ * @param in Cursor over the tree
+ * @param filename Source name the parser would have used
+ * @param depth Nesting depth, bounded against corrupt input
+ * @return First node of the chain (NULL for an empty chain or on error;
+ *         check in->failed)
+ */
+static node_t *in_chain(in_buf_t *in, const char *filename, int depth) {
+    uint32_t count = in_u32(in);
+    if (in->failed || depth > 10000 || count > in->len - in->pos) {
+        in->failed = true;
+        return NULL;
+    }
+
+    node_t *first = NULL;
+    node_t *last = NULL;
+    for (uint32_t i = 0; i < count && !in->failed; i++) {
+        node_t *n = new_node((node_type_t)in_u32(in));
+        if (!first) {
+            first = n;
+        } else {
+            last->next_sibling = n;
+        }
+
+        uint32_t val_type = in_u32(in);
+        uint32_t flags = in_u32(in);
+        n->children = (size_t)in_u64(in);
+        if (flags & NODE_HAS_PREV) {
+            n->prev_sibling = last;
+        }
+        last = n;
+
+        if (val_type == VAL_STR) {
+            n->val_type = VAL_STR;
+            uint32_t len = in_u32(in);
+            if (len != NO_STRING) {
+                const unsigned char *s = in_bytes(in, len);
+                if (s) {
+                    n->val.str = malloc((size_t)len + 1);
+                    if (!n->val.str) {
+                        in->failed = true;
+                        break;
+                    }
+                    memcpy(n->val.str, s, len);
+                    n->val.str[len] = '\0';
+                }
+            }
+        } else {
+            n->val_type = (val_type_t)val_type;
+            const unsigned char *v = in_bytes(in, sizeof(n->val));
+            if (v) {
+                memcpy(&n->val, v, sizeof(n->val));
+            }
+        }
+
+        n->loc.filename = (flags & NODE_HAS_FILENAME) ? filename : NULL;
+        n->loc.line = (size_t)in_u64(in);
+        n->loc.column = (size_t)in_u64(in);
+        n->loc.offset = (size_t)in_u64(in);
+        n->loc.length = (size_t)in_u64(in);
+
+        n->first_child = in_chain(in, filename, depth + 1);
+    }
+
+    if (in->failed) {
+        free_node_tree(first);
+        return NULL;
+    }
+    return first;
+}
+
+/* ============================================================================
+ * Cache Files
+ * ============================================================================ */
+
+/**
+ * @brief Fill a header for the source file
+ */
+static void header_for(startup_cache_header_t *hdr, const char *path,
+                       const struct stat *st, uint32_t construct_count) {
+    memset(hdr, 0, sizeof(*hdr));
+    memcpy(hdr->magic, STARTUP_CACHE_MAGIC, sizeof(STARTUP_CACHE_MAGIC));
+    hdr->format = STARTUP_CACHE_FORMAT;
+    hdr->node_size = (uint32_t)sizeof(node_t);
+    hdr->version_hash = version_hash();
+    hdr->dev = (uint64_t)st->st_dev;
+    hdr->ino = (uint64_t)st->st_ino;
+    hdr->size = (int64_t)st->st_size;
+    hdr->mtime_sec = (int64_t)st->st_mtim.tv_sec;
+    hdr->mtime_nsec = (int64_t)st->st_mtim.tv_nsec;
+    hdr->path_len = (uint32_t)strlen(path);
+    hdr->construct_count = construct_count;
+}
+
+/**
+ * @brief Check that every construct record lies within the image
+ */
+static bool records_valid(in_buf_t in, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        in_bytes(&in, in_u32(&in));
+        in_u64(&in);
+        in_u64(&in);
+        in_bytes(&in, in_u32(&in));
+        if (in.failed) {
+            return false;
+        }
+    }
+    return in.pos == in.len;
+}
+
+/**
+ * @brief Load the cache entry for a script if it is current
+ * @return true if the script can be replayed
+ */
+static bool cache_load(startup_script_t *script) {
+    int fd = open(script->cache_file, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        st.st_size < (off_t)sizeof(startup_cache_header_t) ||
+        st.st_size > (off_t)STARTUP_CACHE_MAX_SIZE) {
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t)st.st_size;
+    unsigned char *image = malloc(size);
+    size_t got = 0;
+    while (image && got < size) {
+        ssize_t n = read(fd, image + got, size - got);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        got += (size_t)n;
+    }
+    close(fd);
+    if (!image || got != size) {
+        free(image);
+        return false;
+    }
+
+    startup_cache_header_t expect;
+    startup_cache_header_t hdr;
+    memcpy(&hdr, image, sizeof(hdr));
+    header_for(&expect, script->path, &script->st, hdr.construct_count);
+    size_t path_end = sizeof(hdr) + expect.path_len;
+    if (memcmp(&hdr, &expect, sizeof(hdr)) != 0 || path_end > size ||
+        memcmp(image + sizeof(hdr), script->path, expect.path_len) != 0) {
+        free(image);
+        return false;
+    }
+
+    in_buf_t in = {image + path_end, size - path_end, 0, false};
+    if (!records_valid(in, hdr.construct_count)) {
+        free(image);
+        return false;
+    }
+
+    script->image = image;
+    script->in = in;
+    script->remaining = hdr.construct_count;
+    return true;
+}
+
+/**
+ * @brief Write the recorded cache entry
+ *
+ * Replaced atomically, so concurrent shells never load a partial entry.
+ */
+static void cache_store(startup_script_t *script) {
+    startup_cache_header_t hdr;
+    header_for(&hdr, script->path, &script->st, script->recorded);
+
+    const cache_file_part_t parts[] = {
+        {&hdr, sizeof(hdr)},
+        {script->path, hdr.path_len},
+        {script->out.data, script->out.len},
+    };
+    if (cache_file_write(script->cache_file, parts,
+                         sizeof(parts) / sizeof(parts[0]))) {
+        stats.stores++;
+    }
+}
+
+/* ============================================================================
+ * Recording
+ * ============================================================================ */
+
+/**
+ * @brief Record the pending construct with an optional parsed tree
+ */
+static void record_pending(startup_script_t *script, const node_t *ast) {
+    if (!script->pending) {
+        return;
+    }
+    script->pending = false;
+
+    out_buf_t *out = &script->out;
+    size_t len = strlen(script->pending_text);
+    out_u32(out, (uint32_t)len);
+    out_bytes(out, script->pending_text, len);
+    out_u64(out, script->pending_offset);
+    out_u64(out, parser_feature_mask());
+
+    size_t size_at = out->len;
+    out_u32(out, 0);
+    if (ast) {
+        size_t tree_start = out->len;
+        out_chain(out, ast);
+        if (!out->failed) {
+            uint32_t tree_size = (uint32_t)(out->len - tree_start);
+            memcpy(out->data + size_at, &tree_size, 4);
+        }
+    }
+    script->recorded++;
+
+    free(script->pending_text);
+    script->pending_text = NULL;
+}
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+void startup_cache_set_enabled(bool enabled) { cache_enabled = enabled; }
+
+bool startup_cache_enabled(void) { return cache_enabled; }
+
+void startup_cache_set_dir(const char *dir) {
+    cache_dir_override_set = dir != NULL;
+    snprintf(cache_dir_override, sizeof(cache_dir_override), "%s",
+             dir ? dir : "");
+}
+
+startup_cache_stats_t startup_cache_stats(void) { return stats; }
+
+void startup_cache_reset_stats(void) { memset(&stats, 0, sizeof(stats)); }
+
+/* ============================================================================
+ * Startup Scripts
+ * ============================================================================ */
+
+startup_script_t *startup_script_open(const char *path, FILE *file) {
+    startup_script_t *script = calloc(1, sizeof(*script));
+    if (!script) {
+        return NULL;
+    }
+    script->file = file;
+    script->mode = SCRIPT_PASSTHROUGH;
+
+    /* -v echoes lines as they are read and -n never executes; neither is
+     * worth a cache entry */
+    if (!cache_enabled || !path || shell_opts.verbose ||
+        shell_opts.syntax_check) {
+        return script;
+    }
+
+    script->path = strdup(path);
+    if (!script->path || fstat(fileno(file), &script->st) != 0 ||
+        !S_ISREG(script->st.st_mode) ||
+        !entry_path(path, script->cache_file, sizeof(script->cache_file))) {
+        return script;
+    }
+
+    if (cache_load(script)) {
+        script->mode = SCRIPT_REPLAY;
+        stats.hits++;
+    } else {
+        script->mode = SCRIPT_RECORD;
+        stats.misses++;
+    }
+    return script;
+}
+
+char *startup_script_read(startup_script_t *script) {
+    if (!script) {
+        return NULL;
+    }
+
+    if (script->mode == SCRIPT_REPLAY) {
+        /* -v or -n switched on by an earlier construct: continue from the
+         * file itself at the same place */
+        if (shell_opts.verbose || shell_opts.syntax_check) {
+            script->mode = SCRIPT_PASSTHROUGH;
+            return get_input_complete(script->file);
+        }
+        if (script->remaining == 0) {
+            return NULL;
+        }
+        script->remaining--;
+
+        in_buf_t *in = &script->in;
+        uint32_t len = in_u32(in);
+        const unsigned char *text = in_bytes(in, len);
+        uint64_t offset = in_u64(in);
+        script->features = in_u64(in);
+        script->tree_size = in_u32(in);
+        script->tree = in_bytes(in, script->tree_size);
+
+        char *construct = text ? malloc((size_t)len + 1) : NULL;
+        if (!construct) {
+            return NULL;
+        }
+        memcpy(construct, text, len);
+        construct[len] = '\0';
+
+        /* Keep the file position in step so a switch to reading the file
+         * resumes after this construct */
+        if (fseeko(script->file, (off_t)offset, SEEK_SET) != 0) {
+            script->mode = SCRIPT_PASSTHROUGH;
+        }
+        return construct;
+    }
+
+    char *construct = get_input_complete(script->file);
+    if (script->mode == SCRIPT_RECORD) {
+        record_pending(script, NULL);
+        if (!construct) {
+            script->at_eof = true;
+            return NULL;
+        }
+        script->pending_text = strdup(construct);
+        script->pending_offset = (uint64_t)ftello(script->file);
+        script->pending = script->pending_text != NULL;
+        if (!script->pending) {
+            script->mode = SCRIPT_PASSTHROUGH;
+        }
+    }
+    return construct;
+}
+
+int startup_script_execute(startup_script_t *script, const char *construct) {
+    if (script && script->mode == SCRIPT_REPLAY && script->tree_size > 0) {
+        if (script->features == parser_feature_mask()) {
+            executor_t *executor = get_global_executor();
+            const char *filename =
+                executor ? executor_get_current_script_file(executor) : NULL;
+            in_buf_t in = {script->tree, script->tree_size, 0, false};
+            node_t *ast = in_chain(&in, filename ? filename : "<stdin>", 0);
+            if (ast && !in.failed && in.pos == in.len) {
+                int status = execute_parsed(ast);
+                free_node_tree(ast);
+                return status;
+            }
+            free_node_tree(ast);
+        }
+        stats.reparsed++;
+    }
+
+    if (script && script->mode == SCRIPT_RECORD && script->pending &&
+        !shell_opts.syntax_check) {
+        /* Parse once: keep the tree for the cache and run it. Text that
+         * does not parse is stored as is and run through the parser again
+         * so the diagnostics are the usual ones */
+        node_t *ast = parse_command_silently(construct);
+        record_pending(script, ast);
+        if (ast) {
+            int status = execute_parsed(ast);
+            free_node_tree(ast);
+            return status;
+        }
+    }
+
+    return parse_and_execute_cached(construct);
+}
+
+bool startup_script_from_cache(const startup_script_t *script) {
+    return script && script->mode == SCRIPT_REPLAY;
+}
+
+void startup_script_close(startup_script_t *script) {
+    if (!script) {
+        return;
+    }
+
+    if (script->mode == SCRIPT_RECORD) {
+        record_pending(script, NULL);
+
+        /* Constructs after an early return are kept as text */
+        char *rest;
+        while (!script->at_eof && (rest = startup_script_read(script))) {
+            free(rest);
+        }
+
+        /* Only cache what was read if the file did not change meanwhile */
+        struct stat now;
+        if (script->at_eof && !script->out.failed &&
+            fstat(fileno(script->file), &now) == 0 &&
+            now.st_ino == script->st.st_ino &&
+            now.st_size == script->st.st_size &&
+            now.st_mtim.tv_sec == script->st.st_mtim.tv_sec &&
+            now.st_mtim.tv_nsec == script->st.st_mtim.tv_nsec) {
+            cache_store(script);
+        }
+    }
+
+    free(script->pending_text);
+    free(script->out.data);
+    free(script->image);
+    free(script->path);
+    free(script);
+}
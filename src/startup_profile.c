@@ -0,0 +1,281 @@
+/**
+ * @file startup_profile.c
+ * @brief Startup critical-path tracer and deferred initialization
+ *
+ * Events are kept in a fixed table in the order they start. A phase event
+ * ends when the next phase starts; a file event ends when the matching
+ * startup_file_end() pops it off a small stack. Times are taken from
+ * CLOCK_MONOTONIC only while profiling is on, so the hooks left in init()
+ * and the source paths cost nothing in normal runs.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "startup_profile.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ============================================================================
+ * Internal Types
+ * ============================================================================ */
+
+/** Deepest nesting of sourced files that is tracked */
+#define STARTUP_MAX_FILE_DEPTH 16
+
+/**
+ * @brief One timed phase or sourced file
+ */
+typedef struct {
+    char *name;       /**< Phase name (static) or file path (owned) */
+    bool is_file;     /**< true for a sourced file */
+    int depth;        /**< Nesting level of a file, 0 for phases */
+    double start_ms;  /**< Start, relative to the profile origin */
+    double elapsed;   /**< Duration in milliseconds, < 0 while open */
+} startup_event_t;
+
+/**
+ * @brief A deferred initialization task
+ */
+typedef struct {
+    const char *name;   /**< Static task name */
+    startup_task_fn fn; /**< Task to run */
+    bool done;          /**< Task has run */
+} startup_task_t;
+
+/* ============================================================================
+ * State
+ * ============================================================================ */
+
+static bool profiling = false;
+static bool finished = false;
+static double budget_ms = STARTUP_DEFAULT_BUDGET_MS;
+static struct timespec origin;
+static double finish_ms = 0.0;
+
+static startup_event_t events[STARTUP_MAX_EVENTS];
+static int event_count = 0;
+static int dropped_events = 0;
+static int current_phase = -1;
+
+static int file_stack[STARTUP_MAX_FILE_DEPTH];
+static int file_depth = 0;
+
+static startup_task_t tasks[STARTUP_MAX_DEFERRED];
+static int task_count = 0;
+static int tasks_pending = 0;
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+/**
+ * @brief Milliseconds since profiling was enabled
+ */
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)(ts.tv_sec - origin.tv_sec) * 1000.0 +
+           (double)(ts.tv_nsec - origin.tv_nsec) / 1e6;
+}
+
+/**
+ * @brief Append an event, returning its index or -1 if the table is full
+ */
+static int add_event(const char *name, bool is_file, int depth) {
+    if (event_count >= STARTUP_MAX_EVENTS) {
+        dropped_events++;
+        return -1;
+    }
+
+    startup_event_t *ev = &events[event_count];
+    ev->name = is_file ? strdup(name) : (char *)name;
+    ev->is_file = is_file;
+    ev->depth = depth;
+    ev->start_ms = now_ms();
+    ev->elapsed = -1.0;
+    return event_count++;
+}
+
+/**
+ * @brief Close the open phase, if any
+ */
+static void end_phase(void) {
+    if (current_phase >= 0) {
+        startup_event_t *ev = &events[current_phase];
+        ev->elapsed = now_ms() - ev->start_ms;
+        current_phase = -1;
+    }
+}
+
+/* ============================================================================
+ * Profiling
+ * ============================================================================ */
+
+void startup_profile_enable(double budget) {
+    if (!profiling) {
+        clock_gettime(CLOCK_MONOTONIC, &origin);
+        profiling = true;
+    }
+
+    if (budget > 0) {
+        budget_ms = budget;
+    } else {
+        const char *env = getenv("LUSH_STARTUP_BUDGET_MS");
+        double value = env ? strtod(env, NULL) : 0.0;
+        budget_ms = value > 0 ? value : STARTUP_DEFAULT_BUDGET_MS;
+    }
+}
+
+bool startup_profile_enabled(void) { return profiling; }
+
+void startup_phase(const char *name) {
+    if (!profiling || finished) {
+        return;
+    }
+
+    end_phase();
+    current_phase = add_event(name, false, 0);
+}
+
+void startup_file_begin(const char *path) {
+    if (!profiling || finished || !path) {
+        return;
+    }
+
+    int index = add_event(path, true, file_depth + 1);
+    if (file_depth < STARTUP_MAX_FILE_DEPTH) {
+        file_stack[file_depth] = index;
+    }
+    file_depth++;
+}
+
+void startup_file_end(void) {
+    if (!profiling || finished || file_depth == 0) {
+        return;
+    }
+
+    file_depth--;
+    if (file_depth < STARTUP_MAX_FILE_DEPTH && file_stack[file_depth] >= 0) {
+        startup_event_t *ev = &events[file_stack[file_depth]];
+        ev->elapsed = now_ms() - ev->start_ms;
+    }
+}
+
+void startup_profile_finish(FILE *report_to) {
+    if (finished) {
+        return;
+    }
+
+    finished = true;
+    if (!profiling) {
+        return;
+    }
+
+    end_phase();
+    finish_ms = now_ms();
+    if (report_to) {
+        startup_profile_report(report_to);
+    }
+}
+
+bool startup_profile_finished(void) { return finished; }
+
+double startup_profile_total_ms(void) {
+    if (!profiling) {
+        return 0.0;
+    }
+    return finished ? finish_ms : now_ms();
+}
+
+bool startup_profile_report(FILE *out) {
+    double total = startup_profile_total_ms();
+
+    fprintf(out, "startup profile (wall time, ms)\n");
+    for (int i = 0; i < event_count; i++) {
+        const startup_event_t *ev = &events[i];
+        double elapsed = ev->elapsed >= 0 ? ev->elapsed : total - ev->start_ms;
+        if (ev->is_file) {
+            fprintf(out, "  %9.3f  %*s%s\n", elapsed, ev->depth * 2, "",
+                    ev->name);
+        } else {
+            fprintf(out, "  %9.3f  %s\n", elapsed, ev->name);
+        }
+    }
+    if (dropped_events > 0) {
+        fprintf(out, "  (%d more events not recorded)\n", dropped_events);
+    }
+
+    bool within = total <= budget_ms;
+    fprintf(out, "  %9.3f  total (budget %.1f ms%s)\n", total, budget_ms,
+            within ? "" : ", EXCEEDED");
+    if (tasks_pending > 0) {
+        fprintf(out, "  %d task(s) deferred\n", tasks_pending);
+    }
+    return within;
+}
+
+void startup_profile_reset(void) {
+    for (int i = 0; i < event_count; i++) {
+        if (events[i].is_file) {
+            free(events[i].name);
+        }
+    }
+    event_count = 0;
+    dropped_events = 0;
+    current_phase = -1;
+    file_depth = 0;
+    task_count = 0;
+    tasks_pending = 0;
+    profiling = false;
+    finished = false;
+    finish_ms = 0.0;
+    budget_ms = STARTUP_DEFAULT_BUDGET_MS;
+}
+
+/* ============================================================================
+ * Deferred Initialization
+ * ============================================================================ */
+
+void startup_defer(const char *name, startup_task_fn fn) {
+    if (!fn) {
+        return;
+    }
+
+    if (task_count >= STARTUP_MAX_DEFERRED) {
+        fn();
+        return;
+    }
+
+    tasks[task_count].name = name;
+    tasks[task_count].fn = fn;
+    tasks[task_count].done = false;
+    task_count++;
+    tasks_pending++;
+}
+
+int startup_run_deferred(FILE *report_to) {
+    int ran = 0;
+
+    /* Tasks may defer more work; re-read the count each time */
+    for (int i = 0; i < task_count && tasks_pending > 0; i++) {
+        if (tasks[i].done) {
+            continue;
+        }
+        tasks[i].done = true;
+        tasks_pending--;
+
+        double start = profiling ? now_ms() : 0.0;
+        tasks[i].fn();
+        if (profiling && report_to) {
+            fprintf(report_to, "startup: deferred %s took %.3f ms\n",
+                    tasks[i].name ? tasks[i].name : "task", now_ms() - start);
+        }
+        ran++;
+    }
+    return ran;
+}
+
+int startup_deferred_pending(void) { return tasks_pending; }
@@ -52,6 +52,9 @@ static time_t shell_start_time = 0;      // For $SECONDS
 static unsigned int random_seed = 0;     // For $RANDOM
 static int current_lineno = 0;           // For $LINENO
 
+// Notified when a variable's visible value may have changed
+static symtable_change_hook_t change_hook = NULL;
+
 // Constants
 #define DEFAULT_HT_FLAGS (HT_STR_NONE | HT_SEED_RANDOM)
 #define MAX_SCOPE_DEPTH 256
@@ -290,6 +293,10 @@ void symtable_manager_free(symtable_manager_t *manager) {
     }
 
     free(manager);
+
+    if (change_hook) {
+        change_hook(NULL);
+    }
 }
 
 /**
@@ -413,6 +420,20 @@ int symtable_pop_scope(symtable_manager_t *manager) {
     symtable_scope_t *old_scope = manager->current_scope;
     manager->current_scope = old_scope->parent;
 
+    // Locals going out of scope uncover the caller's values
+    if (change_hook && old_scope->vars_ht) {
+        ht_enum_t *enum_iter = ht_strstr_enum_create(old_scope->vars_ht);
+        if (enum_iter) {
+            const char *key, *value;
+            while (ht_strstr_enum_next(enum_iter, &key, &value)) {
+                change_hook(key);
+            }
+            ht_strstr_enum_destroy(enum_iter);
+        } else {
+            change_hook(NULL);
+        }
+    }
+
     if (manager->debug_mode) {
         printf("DEBUG: Popped scope '%s' (level %zu)\n", old_scope->scope_name,
                old_scope->level);
@@ -512,6 +533,10 @@ int symtable_set_var(symtable_manager_t *manager, const char *name,
 
     free(serialized);
 
+    if (change_hook) {
+        change_hook(name);
+    }
+
     if (manager->debug_mode) {
         printf("DEBUG: Set variable '%s'='%s'\n", name, value ? value : "");
     }
@@ -563,6 +588,15 @@ int symtable_set_global_var(symtable_manager_t *manager, const char *name,
     return result;
 }
 
+/**
+ * @brief Install the variable change hook
+ *
+ * @param hook Hook to call, or NULL to remove it
+ */
+void symtable_set_change_hook(symtable_change_hook_t hook) {
+    change_hook = hook;
+}
+
 /**
  * @brief Get a variable's value from the scope chain
  *
@@ -36,9 +36,9 @@ static const struct {
 };
 
 // Helper functions
-static token_t *token_new(token_type_t type, const char *text, size_t length,
-                          size_t line, size_t column, size_t position);
-static void token_free(token_t *token);
+static token_t *token_new(tokenizer_t *tokenizer, token_type_t type,
+                          const char *text, size_t length, size_t line,
+                          size_t column, size_t position);
 static token_t *tokenize_next(tokenizer_t *tokenizer);
 static token_type_t classify_word(const char *text, size_t length,
                                   bool enable_keywords);
@@ -60,7 +60,7 @@ tokenizer_t *tokenizer_new(const char *input) {
         return NULL;
     }
 
-    tokenizer_t *tokenizer = malloc(sizeof(tokenizer_t));
+    tokenizer_t *tokenizer = calloc(1, sizeof(tokenizer_t));
     if (!tokenizer) {
         return NULL;
     }
@@ -74,6 +74,7 @@ tokenizer_t *tokenizer_new(const char *input) {
     tokenizer->lookahead = NULL;
     tokenizer->enable_keywords = true;
     tokenizer->arith_cmd_depth = 0;
+    tokenizer->next_slot = 0;
 
     // Initialize by getting the first two tokens
     tokenizer->current = tokenize_next(tokenizer);
@@ -85,7 +86,7 @@ tokenizer_t *tokenizer_new(const char *input) {
 /**
  * @brief Free a tokenizer instance
  *
- * Frees the tokenizer and any associated tokens.
+ * Frees the tokenizer and its token slots.
  *
  * @param tokenizer Tokenizer to free
  */
@@ -94,11 +95,8 @@ void tokenizer_free(tokenizer_t *tokenizer) {
         return;
     }
 
-    if (tokenizer->current) {
-        token_free(tokenizer->current);
-    }
-    if (tokenizer->lookahead) {
-        token_free(tokenizer->lookahead);
+    for (size_t i = 0; i < TOKENIZER_SLOTS; i++) {
+        free(tokenizer->slots[i].text);
     }
 
     free(tokenizer);
@@ -127,8 +125,8 @@ token_t *tokenizer_peek(tokenizer_t *tokenizer) {
 /**
  * @brief Advance to the next token
  *
- * Frees the current token, moves lookahead to current,
- * and tokenizes the next lookahead.
+ * Moves lookahead to current and tokenizes the next lookahead into a
+ * free slot.
  *
  * @param tokenizer Tokenizer instance
  */
@@ -137,11 +135,6 @@ void tokenizer_advance(tokenizer_t *tokenizer) {
         return;
     }
 
-    // Free the current token
-    if (tokenizer->current) {
-        token_free(tokenizer->current);
-    }
-
     // Move lookahead to current
     tokenizer->current = tokenizer->lookahead;
 
@@ -406,9 +399,10 @@ void tokenizer_enable_keywords(tokenizer_t *tokenizer, bool enable) {
 /**
  * @brief Refresh the lookahead token with current settings
  *
- * Re-tokenizes the lookahead token using current tokenizer settings
+ * Re-classifies the lookahead token using current tokenizer settings
  * (e.g., enable_keywords). Use this when keyword recognition context
- * changes and the lookahead needs to be re-classified.
+ * changes and the lookahead needs to be re-classified. Plain words are
+ * re-classified in place from their text; other tokens are re-lexed.
  *
  * @param tokenizer Tokenizer instance
  */
@@ -417,13 +411,18 @@ void tokenizer_refresh_lookahead(tokenizer_t *tokenizer) {
         return;
     }
 
-    // Save the position before the lookahead token
-    size_t saved_position = tokenizer->lookahead->position;
-    size_t saved_line = tokenizer->lookahead->line;
-    size_t saved_column = tokenizer->lookahead->column;
+    // A plain word only needs its keyword classification redone
+    token_t *lookahead = tokenizer->lookahead;
+    if (lookahead->keyword_candidate) {
+        lookahead->type = classify_word(lookahead->text, lookahead->length,
+                                        tokenizer->enable_keywords);
+        return;
+    }
 
-    // Free the lookahead
-    token_free(tokenizer->lookahead);
+    // Save the position before the lookahead token
+    size_t saved_position = lookahead->position;
+    size_t saved_line = lookahead->line;
+    size_t saved_column = lookahead->column;
 
     // Restore position to where lookahead started
     tokenizer->position = saved_position;
@@ -448,16 +447,6 @@ void tokenizer_refresh_from_position(tokenizer_t *tokenizer) {
         return;
     }
 
-    // Free existing tokens
-    if (tokenizer->current) {
-        token_free(tokenizer->current);
-        tokenizer->current = NULL;
-    }
-    if (tokenizer->lookahead) {
-        token_free(tokenizer->lookahead);
-        tokenizer->lookahead = NULL;
-    }
-
     // Re-tokenize from current position
     tokenizer->current = tokenize_next(tokenizer);
     tokenizer->lookahead = tokenize_next(tokenizer);
@@ -466,69 +455,59 @@ void tokenizer_refresh_from_position(tokenizer_t *tokenizer) {
 /* ========== Helper Functions ========== */
 
 /**
- * @brief Create a new token
+ * @brief Produce a token in the next free slot
  *
- * Allocates and initializes a token with the given properties.
+ * Tokens live in a small ring of slots owned by the tokenizer. The slot
+ * taken is the one least recently filled, so the current and lookahead
+ * tokens are never overwritten, and a token stays valid for one more
+ * advance after it stops being current. Each slot keeps its text buffer
+ * between tokens; it only grows when a longer token arrives, so in steady
+ * state producing a token is a copy with no allocation.
  *
+ * @param tokenizer Tokenizer owning the slots
  * @param type Token type
- * @param text Token text (will be copied)
+ * @param text Token text (copied into the slot)
  * @param length Length of text
  * @param line Source line number
  * @param column Source column number
  * @param position Byte offset in input
- * @return New token, or NULL on failure
+ * @return Token, or NULL if the text buffer could not grow
  */
-static token_t *token_new(token_type_t type, const char *text, size_t length,
-                          size_t line, size_t column, size_t position) {
-    token_t *token = malloc(sizeof(token_t));
-    if (!token) {
-        return NULL;
+static token_t *token_new(tokenizer_t *tokenizer, token_type_t type,
+                          const char *text, size_t length, size_t line,
+                          size_t column, size_t position) {
+    token_t *token = &tokenizer->slots[tokenizer->next_slot];
+
+    if (!token->text || token->capacity < length + 1) {
+        size_t capacity = token->capacity ? token->capacity : 32;
+        while (capacity < length + 1) {
+            capacity *= 2;
+        }
+        char *grown = realloc(token->text, capacity);
+        if (!grown) {
+            return NULL;
+        }
+        token->text = grown;
+        token->capacity = capacity;
     }
+    tokenizer->next_slot = (tokenizer->next_slot + 1) % TOKENIZER_SLOTS;
 
     token->type = type;
     token->length = length;
     token->line = line;
     token->column = column;
     token->position = position;
+    token->keyword_candidate = false;
     token->next = NULL;
 
     if (text && length > 0) {
-        token->text = malloc(length + 1);
-        if (!token->text) {
-            free(token);
-            return NULL;
-        }
         memcpy(token->text, text, length);
-        token->text[length] = '\0';
-    } else {
-        // Always allocate text, even for empty strings
-        token->text = malloc(1);
-        if (!token->text) {
-            free(token);
-            return NULL;
-        }
-        token->text[0] = '\0';
     }
+    token->text[length] = '\0';
 
     return token;
 }
 
-/**
- * @brief Free a token
- *
- * @param token Token to free
- */
-static void token_free(token_t *token) {
-    if (!token) {
-        return;
-    }
-
-    if (token->text) {
-        free(token->text);
-    }
-    free(token);
-}
-
 /**
  * @brief Classify a word as keyword or regular word
  *
@@ -541,7 +520,8 @@ static void token_free(token_t *token) {
  */
 static token_type_t classify_word(const char *text, size_t length,
                                   bool enable_keywords) {
-    if (!enable_keywords || !text || length == 0) {
+    // No keyword is longer than "function"
+    if (!enable_keywords || !text || length == 0 || length > 8) {
         return TOK_WORD;
     }
 
@@ -647,16 +627,18 @@ static void skip_whitespace(tokenizer_t *tokenizer) {
  * @return Next token, or TOK_EOF at end of input
  */
 static token_t *tokenize_next(tokenizer_t *tokenizer) {
-    if (!tokenizer || tokenizer->position >= tokenizer->input_length) {
-        return token_new(TOK_EOF, NULL, 0, tokenizer ? tokenizer->line : 1,
-                         tokenizer ? tokenizer->column : 1,
-                         tokenizer ? tokenizer->position : 0);
+    if (!tokenizer) {
+        return NULL;
+    }
+    if (tokenizer->position >= tokenizer->input_length) {
+        return token_new(tokenizer, TOK_EOF, NULL, 0, tokenizer->line,
+                         tokenizer->column, tokenizer->position);
     }
 
     skip_whitespace(tokenizer);
 
     if (tokenizer->position >= tokenizer->input_length) {
-        return token_new(TOK_EOF, NULL, 0, tokenizer->line, tokenizer->column,
+        return token_new(tokenizer, TOK_EOF, NULL, 0, tokenizer->line, tokenizer->column,
                          tokenizer->position);
     }
 
@@ -670,7 +652,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
         tokenizer->position++;
         tokenizer->line++;
         tokenizer->column = 1;
-        return token_new(TOK_NEWLINE, "\n", 1, start_line, start_column,
+        return token_new(tokenizer, TOK_NEWLINE, "\n", 1, start_line, start_column,
                          start_pos);
     }
 
@@ -683,7 +665,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
             tokenizer->column++;
         }
         size_t length = tokenizer->position - start;
-        return token_new(TOK_COMMENT, &tokenizer->input[start], length,
+        return token_new(tokenizer, TOK_COMMENT, &tokenizer->input[start], length,
                          start_line, start_column, start_pos);
     }
 
@@ -694,7 +676,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
         size_t result_capacity = 256;
         char *result = malloc(result_capacity);
         if (!result) {
-            return token_new(TOK_ERROR, &tokenizer->input[start_pos], 1,
+            return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start_pos], 1,
                             start_line, start_column, start_pos);
         }
         size_t result_len = 0;
@@ -724,7 +706,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                         char *new_result = realloc(result, result_capacity);
                         if (!new_result) {
                             free(result);
-                            return token_new(TOK_ERROR, &tokenizer->input[start_pos], 1,
+                            return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start_pos], 1,
                                             start_line, start_column, start_pos);
                         }
                         result = new_result;
@@ -745,7 +727,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 }
             }
             // Unterminated single-quoted string
-            return token_new(TOK_ERROR, &tokenizer->input[start_pos],
+            return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start_pos],
                              tokenizer->position - start_pos, start_line,
                              start_column, start_pos);
         }
@@ -821,7 +803,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     char *new_result = realloc(result, result_capacity);
                     if (!new_result) {
                         free(result);
-                        return token_new(TOK_ERROR, &tokenizer->input[start_pos], 1,
+                        return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start_pos], 1,
                                         start_line, start_column, start_pos);
                     }
                     result = new_result;
@@ -862,7 +844,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     char *new_result = realloc(result, result_capacity);
                     if (!new_result) {
                         free(result);
-                        return token_new(TOK_ERROR, &tokenizer->input[start_pos], 1,
+                        return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start_pos], 1,
                                         start_line, start_column, start_pos);
                     }
                     result = new_result;
@@ -888,7 +870,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                         char *new_result = realloc(result, result_capacity);
                         if (!new_result) {
                             free(result);
-                            return token_new(TOK_ERROR, &tokenizer->input[start_pos], 1,
+                            return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start_pos], 1,
                                             start_line, start_column, start_pos);
                         }
                         result = new_result;
@@ -905,7 +887,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                         char *new_result = realloc(result, result_capacity);
                         if (!new_result) {
                             free(result);
-                            return token_new(TOK_ERROR, &tokenizer->input[start_pos], 1,
+                            return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start_pos], 1,
                                             start_line, start_column, start_pos);
                         }
                         result = new_result;
@@ -922,7 +904,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     char *new_result = realloc(result, result_capacity);
                     if (!new_result) {
                         free(result);
-                        return token_new(TOK_ERROR, &tokenizer->input[start_pos], 1,
+                        return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start_pos], 1,
                                         start_line, start_column, start_pos);
                     }
                     result = new_result;
@@ -938,7 +920,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     char *new_result = realloc(result, result_capacity);
                     if (!new_result) {
                         free(result);
-                        return token_new(TOK_ERROR, &tokenizer->input[start_pos], 1,
+                        return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start_pos], 1,
                                         start_line, start_column, start_pos);
                     }
                     result = new_result;
@@ -950,7 +932,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
         }
 
         // Unterminated double-quoted string
-        return token_new(TOK_ERROR, &tokenizer->input[start_pos],
+        return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start_pos],
                          tokenizer->position - start_pos, start_line,
                          start_column, start_pos);
                          
@@ -973,7 +955,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     char *new_result = realloc(result, result_capacity);
                     if (!new_result) {
                         free(result);
-                        return token_new(TOK_ERROR, &tokenizer->input[start_pos], 1,
+                        return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start_pos], 1,
                                         start_line, start_column, start_pos);
                     }
                     result = new_result;
@@ -1006,7 +988,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                         char *new_result = realloc(result, result_capacity);
                         if (!new_result) {
                             free(result);
-                            return token_new(TOK_ERROR, &tokenizer->input[start_pos], 1,
+                            return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start_pos], 1,
                                             start_line, start_column, start_pos);
                         }
                         result = new_result;
@@ -1037,7 +1019,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
         // No more adjacent content - return the complete token
         result[result_len] = '\0';
         token_type_t type = has_expandable ? TOK_EXPANDABLE_STRING : TOK_STRING;
-        token_t *tok = token_new(type, result, result_len,
+        token_t *tok = token_new(tokenizer, type, result, result_len,
                          start_line, start_column, start_pos);
         free(result);
         return tok;
@@ -1082,13 +1064,13 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     // Check for unclosed arithmetic expansion
                     if (paren_count > 0) {
                         size_t length = tokenizer->position - start;
-                        return token_new(TOK_ERROR, &tokenizer->input[start],
+                        return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start],
                                          length, start_line, start_column,
                                          start_pos);
                     }
 
                     size_t length = tokenizer->position - start;
-                    return token_new(TOK_ARITH_EXP, &tokenizer->input[start],
+                    return token_new(tokenizer, TOK_ARITH_EXP, &tokenizer->input[start],
                                      length, start_line, start_column,
                                      start_pos);
                 } else {
@@ -1112,13 +1094,13 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     // Check for unclosed command substitution
                     if (paren_count > 0) {
                         size_t length = tokenizer->position - start;
-                        return token_new(TOK_ERROR, &tokenizer->input[start],
+                        return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start],
                                          length, start_line, start_column,
                                          start_pos);
                     }
 
                     size_t length = tokenizer->position - start;
-                    return token_new(TOK_COMMAND_SUB, &tokenizer->input[start],
+                    return token_new(tokenizer, TOK_COMMAND_SUB, &tokenizer->input[start],
                                      length, start_line, start_column,
                                      start_pos);
                 }
@@ -1151,7 +1133,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 }
                 
                 size_t length = tokenizer->position - start;
-                return token_new(TOK_STRING, &tokenizer->input[start],
+                return token_new(tokenizer, TOK_STRING, &tokenizer->input[start],
                                  length, start_line, start_column, start_pos);
             } else if (next == '{') {
                 // Parameter expansion ${var} with proper nested brace handling
@@ -1179,7 +1161,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 }
 
                 size_t length = tokenizer->position - start;
-                return token_new(TOK_VARIABLE, &tokenizer->input[start], length,
+                return token_new(tokenizer, TOK_VARIABLE, &tokenizer->input[start], length,
                                  start_line, start_column, start_pos);
             } else if (isalnum(next) || next == '_' || next == '?' ||
                        next == '$' || next == '!' || next == '@' ||
@@ -1207,14 +1189,14 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 }
 
                 size_t length = tokenizer->position - start;
-                return token_new(TOK_VARIABLE, &tokenizer->input[start], length,
+                return token_new(tokenizer, TOK_VARIABLE, &tokenizer->input[start], length,
                                  start_line, start_column, start_pos);
             }
         }
 
         // Just a plain $ - treat as word
         size_t length = tokenizer->position - start;
-        return token_new(TOK_WORD, &tokenizer->input[start], length, start_line,
+        return token_new(tokenizer, TOK_WORD, &tokenizer->input[start], length, start_line,
                          start_column, start_pos);
     }
 
@@ -1240,12 +1222,12 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
         } else {
             // Unclosed backtick - return error token
             size_t length = tokenizer->position - start;
-            return token_new(TOK_ERROR, &tokenizer->input[start], length,
+            return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start], length,
                              start_line, start_column, start_pos);
         }
 
         size_t length = tokenizer->position - start;
-        return token_new(TOK_BACKQUOTE, &tokenizer->input[start], length,
+        return token_new(tokenizer, TOK_BACKQUOTE, &tokenizer->input[start], length,
                          start_line, start_column, start_pos);
     }
 
@@ -1259,7 +1241,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 tokenizer->input[tokenizer->position + 2] == '&') {
                 tokenizer->position += 3;
                 tokenizer->column += 3;
-                return token_new(TOK_CASE_CONTINUE, ";;&", 3, start_line,
+                return token_new(tokenizer, TOK_CASE_CONTINUE, ";;&", 3, start_line,
                                  start_column, start_pos);
             }
             // Check for ;& (case fall-through - execute next without test)
@@ -1267,13 +1249,13 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 tokenizer->input[tokenizer->position + 1] == '&') {
                 tokenizer->position += 2;
                 tokenizer->column += 2;
-                return token_new(TOK_CASE_FALLTHROUGH, ";&", 2, start_line,
+                return token_new(tokenizer, TOK_CASE_FALLTHROUGH, ";&", 2, start_line,
                                  start_column, start_pos);
             }
             // Regular semicolon
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_SEMICOLON, ";", 1, start_line, start_column,
+            return token_new(tokenizer, TOK_SEMICOLON, ";", 1, start_line, start_column,
                              start_pos);
 
         case '|':
@@ -1282,7 +1264,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 if (next == '|') {
                     tokenizer->position += 2;
                     tokenizer->column += 2;
-                    return token_new(TOK_LOGICAL_OR, "||", 2, start_line,
+                    return token_new(tokenizer, TOK_LOGICAL_OR, "||", 2, start_line,
                                      start_column, start_pos);
                 }
                 // Pipe stderr |& (shorthand for 2>&1 |)
@@ -1290,13 +1272,13 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     shell_mode_allows(FEATURE_PROCESS_SUBSTITUTION)) {
                     tokenizer->position += 2;
                     tokenizer->column += 2;
-                    return token_new(TOK_PIPE_STDERR, "|&", 2, start_line,
+                    return token_new(tokenizer, TOK_PIPE_STDERR, "|&", 2, start_line,
                                      start_column, start_pos);
                 }
             }
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_PIPE, "|", 1, start_line, start_column,
+            return token_new(tokenizer, TOK_PIPE, "|", 1, start_line, start_column,
                              start_pos);
 
         case '&':
@@ -1305,7 +1287,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 if (next == '&') {
                     tokenizer->position += 2;
                     tokenizer->column += 2;
-                    return token_new(TOK_LOGICAL_AND, "&&", 2, start_line,
+                    return token_new(tokenizer, TOK_LOGICAL_AND, "&&", 2, start_line,
                                      start_column, start_pos);
                 } else if (next == '>') {
                     // Check for &>> (append both stdout and stderr)
@@ -1314,18 +1296,18 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                         shell_mode_allows(FEATURE_PROCESS_SUBSTITUTION)) {
                         tokenizer->position += 3;
                         tokenizer->column += 3;
-                        return token_new(TOK_APPEND_BOTH, "&>>", 3, start_line,
+                        return token_new(tokenizer, TOK_APPEND_BOTH, "&>>", 3, start_line,
                                          start_column, start_pos);
                     }
                     tokenizer->position += 2;
                     tokenizer->column += 2;
-                    return token_new(TOK_REDIRECT_BOTH, "&>", 2, start_line,
+                    return token_new(tokenizer, TOK_REDIRECT_BOTH, "&>", 2, start_line,
                                      start_column, start_pos);
                 }
             }
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_AND, "&", 1, start_line, start_column,
+            return token_new(tokenizer, TOK_AND, "&", 1, start_line, start_column,
                              start_pos);
 
         case '<':
@@ -1336,7 +1318,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     shell_mode_allows(FEATURE_PROCESS_SUBSTITUTION)) {
                     tokenizer->position += 2;
                     tokenizer->column += 2;
-                    return token_new(TOK_PROC_SUB_IN, "<(", 2, start_line,
+                    return token_new(tokenizer, TOK_PROC_SUB_IN, "<(", 2, start_line,
                                      start_column, start_pos);
                 }
                 if (next == '<') {
@@ -1344,7 +1326,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                         tokenizer->input[tokenizer->position + 2] == '<') {
                         tokenizer->position += 3;
                         tokenizer->column += 3;
-                        return token_new(TOK_HERESTRING, "<<<", 3, start_line,
+                        return token_new(tokenizer, TOK_HERESTRING, "<<<", 3, start_line,
                                          start_column, start_pos);
                     } else if (tokenizer->position + 2 <
                                    tokenizer->input_length &&
@@ -1352,12 +1334,12 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                                    '-') {
                         tokenizer->position += 3;
                         tokenizer->column += 3;
-                        return token_new(TOK_HEREDOC_STRIP, "<<-", 3,
+                        return token_new(tokenizer, TOK_HEREDOC_STRIP, "<<-", 3,
                                          start_line, start_column, start_pos);
                     } else {
                         tokenizer->position += 2;
                         tokenizer->column += 2;
-                        return token_new(TOK_HEREDOC, "<<", 2, start_line,
+                        return token_new(tokenizer, TOK_HEREDOC, "<<", 2, start_line,
                                          start_column, start_pos);
                     }
                 }
@@ -1369,7 +1351,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     if (isdigit(fd_char) || fd_char == '-') {
                         tokenizer->position += 3;
                         tokenizer->column += 3;
-                        return token_new(TOK_REDIRECT_FD, &tokenizer->input[start_pos],
+                        return token_new(tokenizer, TOK_REDIRECT_FD, &tokenizer->input[start_pos],
                                          3, start_line, start_column, start_pos);
                     }
                     // Handle <&$VAR or <&${VAR} patterns
@@ -1397,14 +1379,14 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                         size_t length = fd_pos - start_pos;
                         tokenizer->position = fd_pos;
                         tokenizer->column += length;
-                        return token_new(TOK_REDIRECT_FD, &tokenizer->input[start_pos],
+                        return token_new(tokenizer, TOK_REDIRECT_FD, &tokenizer->input[start_pos],
                                          length, start_line, start_column, start_pos);
                     }
                 }
             }
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_REDIRECT_IN, "<", 1, start_line, start_column,
+            return token_new(tokenizer, TOK_REDIRECT_IN, "<", 1, start_line, start_column,
                              start_pos);
 
         case '>':
@@ -1415,19 +1397,19 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     shell_mode_allows(FEATURE_PROCESS_SUBSTITUTION)) {
                     tokenizer->position += 2;
                     tokenizer->column += 2;
-                    return token_new(TOK_PROC_SUB_OUT, ">(", 2, start_line,
+                    return token_new(tokenizer, TOK_PROC_SUB_OUT, ">(", 2, start_line,
                                      start_column, start_pos);
                 }
                 if (next == '>') {
                     tokenizer->position += 2;
                     tokenizer->column += 2;
-                    return token_new(TOK_APPEND, ">>", 2, start_line, start_column,
+                    return token_new(tokenizer, TOK_APPEND, ">>", 2, start_line, start_column,
                                      start_pos);
                 }
                 if (next == '|') {
                     tokenizer->position += 2;
                     tokenizer->column += 2;
-                    return token_new(TOK_REDIRECT_CLOBBER, ">|", 2, start_line,
+                    return token_new(tokenizer, TOK_REDIRECT_CLOBBER, ">|", 2, start_line,
                                      start_column, start_pos);
                 }
                 if (next == '&' &&
@@ -1438,7 +1420,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     if (isdigit(fd_char) || fd_char == '-') {
                         tokenizer->position += 3;
                         tokenizer->column += 3;
-                        return token_new(TOK_REDIRECT_FD, &tokenizer->input[start_pos],
+                        return token_new(tokenizer, TOK_REDIRECT_FD, &tokenizer->input[start_pos],
                                          3, start_line, start_column, start_pos);
                     }
                     // Handle >&$VAR or >&${VAR} patterns
@@ -1466,14 +1448,14 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                         size_t length = fd_pos - start_pos;
                         tokenizer->position = fd_pos;
                         tokenizer->column += length;
-                        return token_new(TOK_REDIRECT_FD, &tokenizer->input[start_pos],
+                        return token_new(tokenizer, TOK_REDIRECT_FD, &tokenizer->input[start_pos],
                                          length, start_line, start_column, start_pos);
                     }
                 }
             }
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_REDIRECT_OUT, ">", 1, start_line,
+            return token_new(tokenizer, TOK_REDIRECT_OUT, ">", 1, start_line,
                              start_column, start_pos);
 
         case '=':
@@ -1483,12 +1465,12 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 shell_mode_allows(FEATURE_REGEX_MATCH)) {
                 tokenizer->position += 2;
                 tokenizer->column += 2;
-                return token_new(TOK_REGEX_MATCH, "=~", 2, start_line,
+                return token_new(tokenizer, TOK_REGEX_MATCH, "=~", 2, start_line,
                                  start_column, start_pos);
             }
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_ASSIGN, "=", 1, start_line, start_column,
+            return token_new(tokenizer, TOK_ASSIGN, "=", 1, start_line, start_column,
                              start_pos);
 
         case '!':
@@ -1496,7 +1478,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 tokenizer->input[tokenizer->position + 1] == '=') {
                 tokenizer->position += 2;
                 tokenizer->column += 2;
-                return token_new(TOK_NOT_EQUAL, "!=", 2, start_line,
+                return token_new(tokenizer, TOK_NOT_EQUAL, "!=", 2, start_line,
                                  start_column, start_pos);
             }
             // Check for extglob !(pattern)
@@ -1509,7 +1491,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
             // Standalone ! character (for test negation)
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_WORD, "!", 1, start_line, start_column,
+            return token_new(tokenizer, TOK_WORD, "!", 1, start_line, start_column,
                              start_pos);
 
         case '+':
@@ -1519,7 +1501,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 shell_mode_allows(FEATURE_INDEXED_ARRAYS)) {
                 tokenizer->position += 2;
                 tokenizer->column += 2;
-                return token_new(TOK_PLUS_ASSIGN, "+=", 2, start_line,
+                return token_new(tokenizer, TOK_PLUS_ASSIGN, "+=", 2, start_line,
                                  start_column, start_pos);
             }
             // Let + be handled as part of words (e.g., date +%Y)
@@ -1529,13 +1511,13 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
         case '-':
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_MINUS, "-", 1, start_line, start_column,
+            return token_new(tokenizer, TOK_MINUS, "-", 1, start_line, start_column,
                              start_pos);
 
             // case '*':
             //     tokenizer->position++;
             //     tokenizer->column++;
-            //     return token_new(TOK_MULTIPLY, "*", 1, start_line,
+            //     return token_new(tokenizer, TOK_MULTIPLY, "*", 1, start_line,
             //     start_column,
             //                      start_pos);
 
@@ -1547,7 +1529,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
             // case '?':
             //     tokenizer->position++;
             //     tokenizer->column++;
-            //     return token_new(TOK_QUESTION, "?", 1, start_line,
+            //     return token_new(tokenizer, TOK_QUESTION, "?", 1, start_line,
             //     start_column,
             //                      start_pos);
 
@@ -1559,7 +1541,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 tokenizer->position += 2;
                 tokenizer->column += 2;
                 tokenizer->arith_cmd_depth++;  // Track arithmetic context
-                return token_new(TOK_DOUBLE_LPAREN, "((", 2, start_line,
+                return token_new(tokenizer, TOK_DOUBLE_LPAREN, "((", 2, start_line,
                                  start_column, start_pos);
             }
             // Check for zsh-style glob alternation: (a|b)suffix
@@ -1616,7 +1598,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                             
                             size_t word_len = tokenizer->position - word_start;
                             // token_new copies the text, so pass input directly
-                            return token_new(TOK_WORD, &tokenizer->input[word_start], word_len,
+                            return token_new(tokenizer, TOK_WORD, &tokenizer->input[word_start], word_len,
                                            start_line, start_column, start_pos);
                         }
                     }
@@ -1624,7 +1606,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
             }
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_LPAREN, "(", 1, start_line, start_column,
+            return token_new(tokenizer, TOK_LPAREN, "(", 1, start_line, start_column,
                              start_pos);
 
         case ')':
@@ -1639,12 +1621,12 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 tokenizer->position += 2;
                 tokenizer->column += 2;
                 tokenizer->arith_cmd_depth--;  // Leaving arithmetic context
-                return token_new(TOK_DOUBLE_RPAREN, "))", 2, start_line,
+                return token_new(tokenizer, TOK_DOUBLE_RPAREN, "))", 2, start_line,
                                  start_column, start_pos);
             }
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_RPAREN, ")", 1, start_line, start_column,
+            return token_new(tokenizer, TOK_RPAREN, ")", 1, start_line, start_column,
                              start_pos);
 
         case '{':
@@ -1686,8 +1668,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                                     }
                                 }
                                 size_t length = tok_end - tokenizer->position;
-                                token_t *tok = token_new(
-                                    TOK_REDIRECT_FD_ALLOC,
+                                token_t *tok = token_new(tokenizer, TOK_REDIRECT_FD_ALLOC,
                                     &tokenizer->input[tokenizer->position],
                                     length, start_line, start_column, start_pos);
                                 tokenizer->position = tok_end;
@@ -1785,7 +1766,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     
                     size_t total_len = scan_pos - tokenizer->position;
                     
-                    token_t *tok = token_new(TOK_WORD, 
+                    token_t *tok = token_new(tokenizer, TOK_WORD, 
                                              &tokenizer->input[tokenizer->position],
                                              total_len, start_line, start_column, 
                                              start_pos);
@@ -1797,13 +1778,13 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
             // Not a brace expansion - return as command group brace
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_LBRACE, "{", 1, start_line, start_column,
+            return token_new(tokenizer, TOK_LBRACE, "{", 1, start_line, start_column,
                              start_pos);
 
         case '}':
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_RBRACE, "}", 1, start_line, start_column,
+            return token_new(tokenizer, TOK_RBRACE, "}", 1, start_line, start_column,
                              start_pos);
 
         case '[':
@@ -1813,12 +1794,12 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 shell_mode_allows(FEATURE_EXTENDED_TEST)) {
                 tokenizer->position += 2;
                 tokenizer->column += 2;
-                return token_new(TOK_DOUBLE_LBRACKET, "[[", 2, start_line,
+                return token_new(tokenizer, TOK_DOUBLE_LBRACKET, "[[", 2, start_line,
                                  start_column, start_pos);
             }
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_LBRACKET, "[", 1, start_line, start_column,
+            return token_new(tokenizer, TOK_LBRACKET, "[", 1, start_line, start_column,
                              start_pos);
 
         case ']':
@@ -1828,12 +1809,12 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                 shell_mode_allows(FEATURE_EXTENDED_TEST)) {
                 tokenizer->position += 2;
                 tokenizer->column += 2;
-                return token_new(TOK_DOUBLE_RBRACKET, "]]", 2, start_line,
+                return token_new(tokenizer, TOK_DOUBLE_RBRACKET, "]]", 2, start_line,
                                  start_column, start_pos);
             }
             tokenizer->position++;
             tokenizer->column++;
-            return token_new(TOK_RBRACKET, "]", 1, start_line, start_column,
+            return token_new(tokenizer, TOK_RBRACKET, "]", 1, start_line, start_column,
                              start_pos);
         }
     }
@@ -1857,7 +1838,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     tokenizer->position += 2;
                     tokenizer->column += 2;
                     size_t length = tokenizer->position - num_start;
-                    return token_new(TOK_APPEND_ERR,
+                    return token_new(tokenizer, TOK_APPEND_ERR,
                                      &tokenizer->input[num_start], length,
                                      start_line, start_column, start_pos);
                 } else if (tokenizer->position + 1 < tokenizer->input_length &&
@@ -1869,7 +1850,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                             tokenizer->position += 3; // Skip >&M or >&-
                             tokenizer->column += 3;
                             size_t length = tokenizer->position - num_start;
-                            return token_new(TOK_REDIRECT_FD,
+                            return token_new(tokenizer, TOK_REDIRECT_FD,
                                              &tokenizer->input[num_start], length,
                                              start_line, start_column, start_pos);
                         }
@@ -1897,7 +1878,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                             size_t length = fd_pos - num_start;
                             tokenizer->position = fd_pos;
                             tokenizer->column += length;
-                            return token_new(TOK_REDIRECT_FD,
+                            return token_new(tokenizer, TOK_REDIRECT_FD,
                                              &tokenizer->input[num_start], length,
                                              start_line, start_column, start_pos);
                         }
@@ -1907,7 +1888,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     tokenizer->position++;
                     tokenizer->column++;
                     size_t length = tokenizer->position - num_start;
-                    return token_new(TOK_REDIRECT_ERR,
+                    return token_new(tokenizer, TOK_REDIRECT_ERR,
                                      &tokenizer->input[num_start], length,
                                      start_line, start_column, start_pos);
                 }
@@ -1922,7 +1903,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                             tokenizer->position += 3; // Skip <&M or <&-
                             tokenizer->column += 3;
                             size_t length = tokenizer->position - num_start;
-                            return token_new(TOK_REDIRECT_FD,
+                            return token_new(tokenizer, TOK_REDIRECT_FD,
                                              &tokenizer->input[num_start], length,
                                              start_line, start_column, start_pos);
                         }
@@ -1950,7 +1931,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                             size_t length = fd_pos - num_start;
                             tokenizer->position = fd_pos;
                             tokenizer->column += length;
-                            return token_new(TOK_REDIRECT_FD,
+                            return token_new(tokenizer, TOK_REDIRECT_FD,
                                              &tokenizer->input[num_start], length,
                                              start_line, start_column, start_pos);
                         }
@@ -1960,7 +1941,7 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                     tokenizer->position++;
                     tokenizer->column++;
                     size_t length = tokenizer->position - num_start;
-                    return token_new(TOK_REDIRECT_IN_FD,
+                    return token_new(tokenizer, TOK_REDIRECT_IN_FD,
                                      &tokenizer->input[num_start], length,
                                      start_line, start_column, start_pos);
                 }
@@ -2332,13 +2313,17 @@ static token_t *tokenize_next(tokenizer_t *tokenizer) {
                        : classify_word(&tokenizer->input[start], length,
                                        tokenizer->enable_keywords);
 
-        return token_new(type, &tokenizer->input[start], length, start_line,
-                         start_column, start_pos);
+        token_t *tok = token_new(tokenizer, type, &tokenizer->input[start],
+                                 length, start_line, start_column, start_pos);
+        if (tok && !is_numeric) {
+            tok->keyword_candidate = true;
+        }
+        return tok;
     }
 
     // Unknown character - treat as error
     tokenizer->position++;
     tokenizer->column++;
-    return token_new(TOK_ERROR, &tokenizer->input[start_pos], 1, start_line,
+    return token_new(tokenizer, TOK_ERROR, &tokenizer->input[start_pos], 1, start_line,
                      start_column, start_pos);
 }
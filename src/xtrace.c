@@ -0,0 +1,321 @@
+/**
+ * @file xtrace.c
+ * @brief Execution trace (set -x) output
+ *
+ * Builds trace records in a single reusable buffer (linear in the number
+ * and length of arguments) and writes each record to the trace descriptor
+ * with one write(2), so tracing does not allocate per command or go
+ * through stdio flushing. The trace descriptor and format are cached and
+ * only re-read from the symbol table after their variables change.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "xtrace.h"
+#include "lush.h"
+#include "symtable.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** @brief Initial capacity of the record buffer */
+#define XTRACE_BUF_INITIAL 512
+
+/** @brief Reusable record buffer */
+static char *trace_buf = NULL;
+
+/** @brief Bytes used in trace_buf */
+static size_t trace_len = 0;
+
+/** @brief Allocated size of trace_buf */
+static size_t trace_cap = 0;
+
+/** @brief Set when the buffer could not grow; the record is dropped */
+static bool trace_oom = false;
+
+/** @brief Set while trace_fd and trace_format match their variables */
+static bool settings_valid = false;
+
+/** @brief Cached trace descriptor */
+static int trace_fd = STDERR_FILENO;
+
+/** @brief Cached trace format */
+static xtrace_format_t trace_format = XTRACE_FORMAT_CLASSIC;
+
+/**
+ * @brief Ensure room for n more bytes in the record buffer
+ * @param n Number of bytes needed
+ * @return true if space is available
+ */
+static bool buf_reserve(size_t n) {
+    if (trace_oom) {
+        return false;
+    }
+    if (trace_len + n <= trace_cap) {
+        return true;
+    }
+
+    size_t new_cap = trace_cap ? trace_cap : XTRACE_BUF_INITIAL;
+    while (new_cap < trace_len + n) {
+        new_cap *= 2;
+    }
+    char *grown = realloc(trace_buf, new_cap);
+    if (!grown) {
+        trace_oom = true;
+        return false;
+    }
+    trace_buf = grown;
+    trace_cap = new_cap;
+    return true;
+}
+
+/**
+ * @brief Append raw bytes to the record buffer
+ * @param s Bytes to append
+ * @param n Number of bytes
+ */
+static void buf_append(const char *s, size_t n) {
+    if (buf_reserve(n)) {
+        memcpy(trace_buf + trace_len, s, n);
+        trace_len += n;
+    }
+}
+
+/**
+ * @brief Append a NUL-terminated string to the record buffer
+ * @param s String to append
+ */
+static void buf_puts(const char *s) { buf_append(s, strlen(s)); }
+
+/**
+ * @brief Append printf-formatted text to the record buffer
+ * @param fmt Format string
+ */
+static void buf_printf(const char *fmt, ...) {
+    char tmp[128];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(tmp, sizeof(tmp), fmt, args);
+    va_end(args);
+    if (n > 0) {
+        buf_append(tmp, (size_t)n < sizeof(tmp) ? (size_t)n : sizeof(tmp) - 1);
+    }
+}
+
+/**
+ * @brief Append a JSON string literal (with quotes) to the record buffer
+ * @param s String to escape, NULL is written as null
+ */
+static void buf_json_string(const char *s) {
+    if (!s) {
+        buf_append("null", 4);
+        return;
+    }
+
+    buf_append("\"", 1);
+    const char *run = s;
+    for (const char *p = s; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c != '"' && c != '\\' && c >= 0x20) {
+            continue;
+        }
+        buf_append(run, (size_t)(p - run));
+        switch (c) {
+        case '"':
+            buf_append("\\\"", 2);
+            break;
+        case '\\':
+            buf_append("\\\\", 2);
+            break;
+        case '\n':
+            buf_append("\\n", 2);
+            break;
+        case '\t':
+            buf_append("\\t", 2);
+            break;
+        case '\r':
+            buf_append("\\r", 2);
+            break;
+        default:
+            buf_printf("\\u%04x", c);
+            break;
+        }
+        run = p + 1;
+    }
+    buf_puts(run);
+    buf_append("\"", 1);
+}
+
+/**
+ * @brief Write the record buffer to a descriptor and reset it
+ * @param fd Destination descriptor
+ */
+static void buf_flush(int fd) {
+    size_t off = 0;
+    while (!trace_oom && off < trace_len) {
+        ssize_t n = write(fd, trace_buf + off, trace_len - off);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        off += (size_t)n;
+    }
+    trace_len = 0;
+    trace_oom = false;
+}
+
+/**
+ * @brief Resolve the trace descriptor from LUSH_XTRACEFD / BASH_XTRACEFD
+ * @return Descriptor to write trace records to
+ */
+static int resolve_trace_fd(void) {
+    char *value = symtable_get_global("LUSH_XTRACEFD");
+    if (!value || !*value) {
+        free(value);
+        value = symtable_get_global("BASH_XTRACEFD");
+    }
+
+    int fd = STDERR_FILENO;
+    if (value && *value) {
+        char *end = NULL;
+        long parsed = strtol(value, &end, 10);
+        if (end && *end == '\0' && parsed >= 0 && parsed <= 1024) {
+            fd = (int)parsed;
+        }
+    }
+    free(value);
+    return fd;
+}
+
+/**
+ * @brief Resolve the trace format from LUSH_XTRACE_FORMAT
+ * @return Active trace format
+ */
+static xtrace_format_t resolve_trace_format(void) {
+    char *value = symtable_get_global("LUSH_XTRACE_FORMAT");
+    xtrace_format_t format = XTRACE_FORMAT_CLASSIC;
+    if (value && strcmp(value, "json") == 0) {
+        format = XTRACE_FORMAT_JSON;
+    }
+    free(value);
+    return format;
+}
+
+/**
+ * @brief Symbol table hook: drop cached settings when their variables change
+ * @param name Changed variable, or NULL if any variable may have changed
+ */
+static void trace_variable_changed(const char *name) {
+    if (!name || strcmp(name, "LUSH_XTRACEFD") == 0 ||
+        strcmp(name, "BASH_XTRACEFD") == 0 ||
+        strcmp(name, "LUSH_XTRACE_FORMAT") == 0) {
+        settings_valid = false;
+    }
+}
+
+/**
+ * @brief Refresh the cached descriptor and format if they are stale
+ */
+static void load_settings(void) {
+    if (settings_valid) {
+        return;
+    }
+    symtable_set_change_hook(trace_variable_changed);
+    trace_fd = resolve_trace_fd();
+    trace_format = resolve_trace_format();
+    settings_valid = true;
+}
+
+/**
+ * @brief Append the classic "+ cmd args" line for argv
+ * @param argv NULL-terminated command words
+ */
+static void append_classic(char *const *argv) {
+    buf_append("+ ", 2);
+    for (int i = 0; argv[i]; i++) {
+        if (i > 0) {
+            buf_append(" ", 1);
+        }
+        buf_puts(argv[i]);
+    }
+    buf_append("\n", 1);
+}
+
+void xtrace_begin(xtrace_record_t *rec, const char *kind, char *const *argv,
+                  const char *file, int line) {
+    if (!rec) {
+        return;
+    }
+    rec->active = false;
+    if (!should_trace_execution() || !argv || !argv[0]) {
+        return;
+    }
+
+    load_settings();
+    rec->active = true;
+    rec->format = trace_format;
+    rec->fd = trace_fd;
+    rec->kind = kind;
+    rec->argv = argv;
+    rec->file = file;
+    rec->line = line;
+
+    if (rec->format == XTRACE_FORMAT_CLASSIC) {
+        append_classic(argv);
+        buf_flush(rec->fd);
+        return;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &rec->wall);
+    clock_gettime(CLOCK_MONOTONIC, &rec->start);
+}
+
+void xtrace_end(xtrace_record_t *rec, int status) {
+    if (!rec || !rec->active) {
+        return;
+    }
+    rec->active = false;
+    if (rec->format != XTRACE_FORMAT_JSON) {
+        return;
+    }
+
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    long long duration_us =
+        (long long)(end.tv_sec - rec->start.tv_sec) * 1000000LL +
+        (end.tv_nsec - rec->start.tv_nsec) / 1000;
+
+    buf_printf("{\"ts\":%lld.%06ld,\"pid\":%ld,\"kind\":",
+               (long long)rec->wall.tv_sec, rec->wall.tv_nsec / 1000,
+               (long)getpid());
+    buf_json_string(rec->kind);
+    buf_puts(",\"file\":");
+    buf_json_string(rec->file);
+    buf_printf(",\"line\":%d,\"argv\":[", rec->line);
+    for (int i = 0; rec->argv[i]; i++) {
+        if (i > 0) {
+            buf_append(",", 1);
+        }
+        buf_json_string(rec->argv[i]);
+    }
+    buf_printf("],\"status\":%d,\"duration_us\":%lld}\n", status,
+               duration_us);
+    buf_flush(rec->fd);
+}
+
+void xtrace_cleanup(void) {
+    free(trace_buf);
+    trace_buf = NULL;
+    trace_len = 0;
+    trace_cap = 0;
+    trace_oom = false;
+    symtable_set_change_hook(NULL);
+    settings_valid = false;
+}
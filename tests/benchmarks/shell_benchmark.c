@@ -0,0 +1,681 @@
+/**
+ * @file shell_benchmark.c
+ * @brief Whole-shell performance benchmark suite
+ *
+ * Measures the shell end to end through the parser, executor and history
+ * engine, so regressions in everyday scripts show up between releases:
+ *
+ * - Parse throughput over the compatibility corpus (@input blocks)
+ * - Loop, arithmetic, variable and function call microbenchmarks
+ * - Child process counts per construct (from wait4 accounting)
+ * - Pipeline throughput
+ * - Fork savings of the in-process coreutils module
+ * - Glob expansion over a synthetic directory tree
+ * - History load, save and search at one million entries
+ *
+ * Results are printed as a table and optionally written as JSON (one
+ * result object per line). When a baseline JSON file is given, each
+ * result is compared against it and the run fails if any benchmark is
+ * slower than the regression threshold or spawns more processes.
+ *
+ * Usage:
+ *   shell_benchmark [--quick] [--filter SUBSTR] [--corpus DIR]
+ *                   [--json FILE] [--baseline FILE] [--threshold PCT]
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "coreutils.h"
+#include "executor.h"
+#include "lle/history.h"
+#include "lush_plugin.h"
+#include "node.h"
+#include "parser.h"
+#include "symtable.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+extern void init_symtable(void);
+extern void free_global_symtable(void);
+
+/** @brief Maximum number of benchmark results */
+#define MAX_RESULTS 64
+
+/** @brief Default regression threshold in percent */
+#define DEFAULT_THRESHOLD_PCT 25.0
+
+/**
+ * @brief One benchmark measurement
+ */
+typedef struct bench_result {
+    char name[64];       /**< Dotted benchmark name */
+    uint64_t iterations; /**< Operations measured */
+    uint64_t total_ns;   /**< Wall time for all operations */
+    double ns_per_op;    /**< Mean wall time per operation */
+    double forks_per_op; /**< Child processes per operation (-1 = n/a) */
+} bench_result_t;
+
+/**
+ * @brief Benchmark run options
+ */
+typedef struct bench_options {
+    bool quick;             /**< Reduced iteration counts */
+    const char *filter;     /**< Only run names containing this */
+    const char *corpus_dir; /**< Compatibility corpus directory */
+    const char *json_path;  /**< JSON output file (NULL = none) */
+    const char *baseline;   /**< Baseline JSON file (NULL = none) */
+    double threshold_pct;   /**< Allowed slowdown before failing */
+} bench_options_t;
+
+static bench_result_t results[MAX_RESULTS];
+static int result_count = 0;
+static bench_options_t opts = {false, NULL, "tests/compatibility/corpus",
+                               NULL,  NULL, DEFAULT_THRESHOLD_PCT};
+
+/** @brief Saved stdout while benchmarks run (output goes to /dev/null) */
+static int saved_stdout = -1;
+
+/* ============================================================================
+ * HELPERS
+ * ============================================================================
+ */
+
+static uint64_t get_nanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static bool selected(const char *name) {
+    return !opts.filter || strstr(name, opts.filter) != NULL;
+}
+
+static uint64_t scaled(uint64_t full) {
+    uint64_t n = opts.quick ? full / 10 : full;
+    return n ? n : 1;
+}
+
+static void record(const char *name, uint64_t iterations, uint64_t total_ns,
+                   double forks_per_op) {
+    if (result_count >= MAX_RESULTS) {
+        return;
+    }
+    bench_result_t *r = &results[result_count++];
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    r->iterations = iterations;
+    r->total_ns = total_ns;
+    r->ns_per_op = iterations ? (double)total_ns / (double)iterations : 0.0;
+    r->forks_per_op = forks_per_op;
+}
+
+/** @brief Send shell output to /dev/null while measuring */
+static void quiet_begin(void) {
+    fflush(stdout);
+    saved_stdout = dup(STDOUT_FILENO);
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull >= 0) {
+        dup2(devnull, STDOUT_FILENO);
+        close(devnull);
+    }
+}
+
+static void quiet_end(void) {
+    fflush(stdout);
+    if (saved_stdout >= 0) {
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+        saved_stdout = -1;
+    }
+}
+
+/**
+ * @brief Run a script repeatedly in a fresh executor
+ *
+ * The setup script runs once, unmeasured. The body runs `iterations`
+ * times; its wall time and the children reaped are recorded.
+ */
+static void bench_script(const char *name, const char *setup,
+                         const char *body, uint64_t iterations) {
+    if (!selected(name)) {
+        return;
+    }
+
+    executor_t *exec = executor_new();
+    if (!exec) {
+        fprintf(stderr, "shell_benchmark: executor_new failed\n");
+        return;
+    }
+
+    quiet_begin();
+    if (setup) {
+        executor_execute_command_line(exec, setup);
+    }
+
+    uint64_t children = 0;
+    uint64_t start = get_nanos();
+    for (uint64_t i = 0; i < iterations; i++) {
+        executor_execute_command_line(exec, body);
+        children += (uint64_t)exec->last_rusage_children;
+    }
+    uint64_t elapsed = get_nanos() - start;
+    quiet_end();
+
+    record(name, iterations, elapsed, (double)children / (double)iterations);
+    executor_free(exec);
+}
+
+/* ============================================================================
+ * PARSE THROUGHPUT
+ * ============================================================================
+ */
+
+/**
+ * @brief Append the @input blocks of a corpus file to a script list
+ */
+static void collect_inputs(const char *path, char ***inputs, size_t *count,
+                           size_t *cap) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        return;
+    }
+
+    char line[4096];
+    char *block = NULL;
+    size_t block_len = 0;
+    bool in_input = false;
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (!in_input) {
+            if (strncmp(line, "@input", 6) == 0) {
+                in_input = true;
+                block_len = 0;
+                block = calloc(1, 1);
+            }
+            continue;
+        }
+        if (strncmp(line, "@end", 4) == 0) {
+            in_input = false;
+            if (*count == *cap) {
+                *cap = *cap ? *cap * 2 : 64;
+                *inputs = realloc(*inputs, *cap * sizeof(char *));
+            }
+            (*inputs)[(*count)++] = block;
+            block = NULL;
+            continue;
+        }
+        size_t n = strlen(line);
+        char *grown = realloc(block, block_len + n + 1);
+        if (!grown) {
+            break;
+        }
+        block = grown;
+        memcpy(block + block_len, line, n + 1);
+        block_len += n;
+    }
+
+    free(block);
+    fclose(fp);
+}
+
+static void walk_corpus(const char *dir, char ***inputs, size_t *count,
+                        size_t *cap) {
+    DIR *d = opendir(dir);
+    if (!d) {
+        return;
+    }
+
+    struct dirent *ent;
+    while ((ent = readdir(d)) != NULL) {
+        if (ent->d_name[0] == '.') {
+            continue;
+        }
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s", dir, ent->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            walk_corpus(path, inputs, count, cap);
+        } else {
+            size_t len = strlen(ent->d_name);
+            if (len > 5 && strcmp(ent->d_name + len - 5, ".test") == 0) {
+                collect_inputs(path, inputs, count, cap);
+            }
+        }
+    }
+    closedir(d);
+}
+
+static void bench_parse_corpus(void) {
+    if (!selected("parse.corpus")) {
+        return;
+    }
+
+    char **inputs = NULL;
+    size_t count = 0;
+    size_t cap = 0;
+    walk_corpus(opts.corpus_dir, &inputs, &count, &cap);
+    if (count == 0) {
+        fprintf(stderr, "shell_benchmark: no corpus inputs under %s\n",
+                opts.corpus_dir);
+        return;
+    }
+
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        bytes += strlen(inputs[i]);
+    }
+
+    uint64_t rounds = scaled(200);
+    uint64_t start = get_nanos();
+    for (uint64_t r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < count; i++) {
+            parser_t *parser = parser_new(inputs[i]);
+            if (!parser) {
+                continue;
+            }
+            node_t *ast = parser_parse(parser);
+            if (ast) {
+                free_node_tree(ast);
+            }
+            parser_free(parser);
+        }
+    }
+    uint64_t elapsed = get_nanos() - start;
+
+    record("parse.corpus", rounds * count, elapsed, -1);
+
+    fprintf(stderr, "parse.corpus: %zu inputs, %.1f MB/s\n", count,
+            elapsed ? (double)(bytes * rounds) * 1e3 / (double)elapsed : 0.0);
+
+    for (size_t i = 0; i < count; i++) {
+        free(inputs[i]);
+    }
+    free(inputs);
+}
+
+/* ============================================================================
+ * COREUTILS MODULE
+ * ============================================================================
+ */
+
+/**
+ * @brief Small utilities as external commands and as loadable builtins
+ *
+ * Each body runs once against the real utilities and once after
+ * `enable -f coreutils`; the difference in ns/op and forks/op is what the
+ * module saves per call. The module is unloaded after each case so the
+ * next external run, and later benchmarks, see the real utilities.
+ */
+static void bench_coreutils(void) {
+    static const struct {
+        const char *name;
+        const char *body;
+    } cases[] = {
+        {"basename", "x=$(basename /usr/lib/libc.so .so)"},
+        {"dirname", "x=$(dirname /usr/lib/libc.so)"},
+        {"head", "head -n 1 /etc/passwd >/dev/null"},
+        {"wc", "wc -l /etc/passwd >/dev/null"},
+        {"seq_wc", "seq 1 1000 | wc -l >/dev/null"},
+    };
+    lush_plugin_manager_t *manager = lush_plugin_shell_manager();
+    char name[64];
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        snprintf(name, sizeof(name), "coreutils.%s_external", cases[i].name);
+        bench_script(name, NULL, cases[i].body, scaled(300));
+        snprintf(name, sizeof(name), "coreutils.%s_builtin", cases[i].name);
+        bench_script(name, "enable -f coreutils", cases[i].body, scaled(300));
+        /* Loaded builtins are shell-wide, not per executor */
+        if (manager) {
+            lush_plugin_manager_unload(manager, COREUTILS_MODULE_NAME);
+        }
+    }
+}
+
+/* ============================================================================
+ * GLOB EXPANSION
+ * ============================================================================
+ */
+
+static void bench_glob(void) {
+    if (!selected("glob.tree")) {
+        return;
+    }
+
+    char root[] = "/tmp/lush-bench-glob-XXXXXX";
+    if (!mkdtemp(root)) {
+        fprintf(stderr, "shell_benchmark: mkdtemp: %s\n", strerror(errno));
+        return;
+    }
+
+    const int ndirs = 50;
+    const int nfiles = 40;
+    char path[4096];
+    for (int d = 0; d < ndirs; d++) {
+        snprintf(path, sizeof(path), "%s/d%02d", root, d);
+        mkdir(path, 0700);
+        for (int f = 0; f < nfiles; f++) {
+            snprintf(path, sizeof(path), "%s/d%02d/f%02d.%s", root, d, f,
+                     (f % 2) ? "txt" : "log");
+            int fd = open(path, O_WRONLY | O_CREAT, 0600);
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    char cwd[4096];
+    if (getcwd(cwd, sizeof(cwd)) && chdir(root) == 0) {
+        bench_script("glob.tree", NULL, "set -- */*.txt", scaled(500));
+        if (chdir(cwd) != 0) {
+            perror("chdir");
+        }
+    }
+
+    for (int d = 0; d < ndirs; d++) {
+        for (int f = 0; f < nfiles; f++) {
+            snprintf(path, sizeof(path), "%s/d%02d/f%02d.%s", root, d, f,
+                     (f % 2) ? "txt" : "log");
+            unlink(path);
+        }
+        snprintf(path, sizeof(path), "%s/d%02d", root, d);
+        rmdir(path);
+    }
+    rmdir(root);
+}
+
+/* ============================================================================
+ * HISTORY
+ * ============================================================================
+ */
+
+static void bench_history(void) {
+    if (!selected("history.")) {
+        return;
+    }
+
+    size_t entries = (size_t)scaled(1000000);
+    lle_history_config_t *config = NULL;
+    if (lle_history_config_create_default(&config, NULL) != LLE_SUCCESS) {
+        return;
+    }
+    config->max_entries = entries;
+    config->initial_capacity = entries;
+    config->ignore_duplicates = false;
+    config->auto_save = false;
+    config->load_on_init = false;
+
+    lle_history_core_t *core = NULL;
+    if (lle_history_core_create(&core, NULL, config) != LLE_SUCCESS) {
+        lle_history_config_destroy(config, NULL);
+        return;
+    }
+
+    char command[128];
+    uint64_t start = get_nanos();
+    for (size_t i = 0; i < entries; i++) {
+        snprintf(command, sizeof(command), "git commit -m 'change %zu' %zu",
+                 i % 997, i);
+        lle_history_add_entry(core, command, 0, NULL);
+    }
+    record("history.add", entries, get_nanos() - start, -1);
+
+    char file[] = "/tmp/lush-bench-history-XXXXXX";
+    int fd = mkstemp(file);
+    if (fd >= 0) {
+        close(fd);
+
+        start = get_nanos();
+        lle_history_save_to_file(core, file);
+        record("history.save", entries, get_nanos() - start, -1);
+
+        lle_history_core_t *loaded = NULL;
+        if (lle_history_core_create(&loaded, NULL, config) == LLE_SUCCESS) {
+            start = get_nanos();
+            lle_history_load_from_file(loaded, file);
+            record("history.load", entries, get_nanos() - start, -1);
+            lle_history_core_destroy(loaded);
+        }
+        unlink(file);
+    }
+
+    uint64_t searches = scaled(20);
+    start = get_nanos();
+    for (uint64_t i = 0; i < searches; i++) {
+        lle_history_search_results_t *res =
+            lle_history_search_substring(core, "change 42", 100);
+        lle_history_search_results_destroy(res);
+    }
+    record("history.search_substring", searches, get_nanos() - start, -1);
+
+    start = get_nanos();
+    for (uint64_t i = 0; i < searches; i++) {
+        lle_history_search_results_t *res =
+            lle_history_search_prefix(core, "git commit -m 'change 99", 100);
+        lle_history_search_results_destroy(res);
+    }
+    record("history.search_prefix", searches, get_nanos() - start, -1);
+
+    lle_history_core_destroy(core);
+    lle_history_config_destroy(config, NULL);
+}
+
+/* ============================================================================
+ * REPORTING AND BASELINE COMPARISON
+ * ============================================================================
+ */
+
+static void print_table(void) {
+    printf("%-28s %12s %14s %10s\n", "benchmark", "iterations", "ns/op",
+           "forks/op");
+    for (int i = 0; i < result_count; i++) {
+        bench_result_t *r = &results[i];
+        if (r->forks_per_op >= 0) {
+            printf("%-28s %12llu %14.1f %10.2f\n", r->name,
+                   (unsigned long long)r->iterations, r->ns_per_op,
+                   r->forks_per_op);
+        } else {
+            printf("%-28s %12llu %14.1f %10s\n", r->name,
+                   (unsigned long long)r->iterations, r->ns_per_op, "-");
+        }
+    }
+}
+
+static int write_json(const char *path) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        fprintf(stderr, "shell_benchmark: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    fprintf(fp, "{\n  \"suite\": \"lush-shell\",\n  \"version\": 1,\n");
+    fprintf(fp, "  \"quick\": %s,\n  \"results\": [\n",
+            opts.quick ? "true" : "false");
+    for (int i = 0; i < result_count; i++) {
+        bench_result_t *r = &results[i];
+        fprintf(fp,
+                "    {\"name\": \"%s\", \"iterations\": %llu, "
+                "\"total_ns\": %llu, \"ns_per_op\": %.1f, "
+                "\"forks_per_op\": %.2f}%s\n",
+                r->name, (unsigned long long)r->iterations,
+                (unsigned long long)r->total_ns, r->ns_per_op,
+                r->forks_per_op, i + 1 < result_count ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+    return 0;
+}
+
+/**
+ * @brief Extract a numeric field from a result line of our JSON format
+ */
+static bool json_field(const char *line, const char *key, double *out) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+    const char *p = strstr(line, pattern);
+    if (!p) {
+        return false;
+    }
+    *out = strtod(p + strlen(pattern), NULL);
+    return true;
+}
+
+/**
+ * @brief Compare results against a baseline written by --json
+ * @return Number of regressions found, or -1 if the baseline is unreadable
+ */
+static int compare_baseline(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "shell_benchmark: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    int regressions = 0;
+    char line[512];
+    printf("\nBaseline comparison (%s, threshold %.0f%%):\n", path,
+           opts.threshold_pct);
+    while (fgets(line, sizeof(line), fp)) {
+        const char *name_start = strstr(line, "\"name\": \"");
+        if (!name_start) {
+            continue;
+        }
+        name_start += strlen("\"name\": \"");
+        const char *name_end = strchr(name_start, '"');
+        if (!name_end) {
+            continue;
+        }
+
+        double base_ns = 0;
+        double base_forks = -1;
+        if (!json_field(line, "ns_per_op", &base_ns)) {
+            continue;
+        }
+        json_field(line, "forks_per_op", &base_forks);
+
+        for (int i = 0; i < result_count; i++) {
+            bench_result_t *r = &results[i];
+            if (strlen(r->name) != (size_t)(name_end - name_start) ||
+                strncmp(r->name, name_start, strlen(r->name)) != 0) {
+                continue;
+            }
+
+            double change =
+                base_ns > 0 ? (r->ns_per_op - base_ns) * 100.0 / base_ns : 0;
+            bool slower = change > opts.threshold_pct;
+            bool more_forks =
+                base_forks >= 0 && r->forks_per_op > base_forks + 0.005;
+            printf("  %-28s %+7.1f%%%s%s\n", r->name, change,
+                   slower ? "  REGRESSION" : "",
+                   more_forks ? "  MORE FORKS" : "");
+            if (slower || more_forks) {
+                regressions++;
+            }
+        }
+    }
+    fclose(fp);
+    return regressions;
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================
+ */
+
+static void usage(void) {
+    fprintf(stderr,
+            "usage: shell_benchmark [--quick] [--filter SUBSTR] "
+            "[--corpus DIR]\n"
+            "                       [--json FILE] [--baseline FILE] "
+            "[--threshold PCT]\n");
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (strcmp(arg, "--quick") == 0) {
+            opts.quick = true;
+        } else if (strcmp(arg, "--filter") == 0 && has_value) {
+            opts.filter = argv[++i];
+        } else if (strcmp(arg, "--corpus") == 0 && has_value) {
+            opts.corpus_dir = argv[++i];
+        } else if (strcmp(arg, "--json") == 0 && has_value) {
+            opts.json_path = argv[++i];
+        } else if (strcmp(arg, "--baseline") == 0 && has_value) {
+            opts.baseline = argv[++i];
+        } else if (strcmp(arg, "--threshold") == 0 && has_value) {
+            opts.threshold_pct = strtod(argv[++i], NULL);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    init_symtable();
+
+    bench_parse_corpus();
+
+    /* Interpreter microbenchmarks (no child processes expected) */
+    bench_script("loop.for_1000", NULL,
+                 "for i in 1 2 3 4 5 6 7 8 9 10; do "
+                 "for j in 1 2 3 4 5 6 7 8 9 10; do "
+                 "for k in 1 2 3 4 5 6 7 8 9 10; do :; done; done; done",
+                 scaled(50));
+    bench_script("loop.while_arith_1000", NULL,
+                 "i=0; while [ $i -lt 1000 ]; do i=$((i + 1)); done",
+                 scaled(50));
+    bench_script("arith.expression", "a=7 b=3",
+                 "x=$(( (a * b + 17) % 11 - (a << 2) / b ))", scaled(20000));
+    bench_script("var.write", NULL, "v=hello", scaled(20000));
+    bench_script("var.read", "v=hello", "w=$v", scaled(20000));
+    bench_script("var.param_expansion", "p=/usr/local/lib/libfoo.so.1",
+                 "w=${p##*/} x=${p%.*} y=${#p}", scaled(20000));
+    bench_script("func.call", "f() { :; }", "f", scaled(20000));
+    bench_script("func.call_args", "f() { r=$2; }", "f a b c d",
+                 scaled(20000));
+
+    /* Process creation per construct; forks/op is the tracked metric */
+    bench_script("fork.external", NULL, "/bin/true", scaled(500));
+    bench_script("fork.subshell", NULL, "( : )", scaled(500));
+    bench_script("fork.cmdsub_builtin", NULL, "x=$(echo hi)", scaled(500));
+    bench_script("fork.pipeline_builtins", NULL, "echo hi | :", scaled(500));
+    bench_script("fork.cmdsub_external", NULL, "x=$(/bin/true)", scaled(500));
+
+    /* Pipeline throughput */
+    bench_script("pipeline.seq_cat_wc", NULL,
+                 "seq 1 100000 | cat | wc -l >/dev/null", scaled(50));
+
+    bench_coreutils();
+    bench_glob();
+    bench_history();
+
+    print_table();
+
+    int status = 0;
+    if (opts.json_path && write_json(opts.json_path) != 0) {
+        status = 1;
+    }
+    if (opts.baseline) {
+        int regressions = compare_baseline(opts.baseline);
+        if (regressions != 0) {
+            status = 1;
+        }
+    }
+
+    free_global_symtable();
+    return status;
+}
@@ -1,303 +0,0 @@
-/**
- * @file display_performance_benchmark.c
- * @brief Performance benchmarks for LLE Spec 08 Display Integration
- *
- * Validates that display operations meet spec performance requirements:
- * - Display update latency: < 250μs average
- * - Cache hit rate: > 75%
- * - Cache lookup: < 10μs
- * - Event processing: < 50μs
- * - Pipeline execution: < 500μs
- *
- * Reference: docs/lle_specification/08_display_integration_complete.md
- */
-
-#include "lle/display_integration.h"
-#include "lle/error_handling.h"
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <time.h>
-
-/* Mock memory pool - uses liblle.a implementations via linking */
-static int mock_pool_dummy = 42;
-static lle_memory_pool_t *mock_pool = (lle_memory_pool_t *)&mock_pool_dummy;
-
-/* Helper to get nanoseconds */
-static uint64_t get_nanos(void) {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
-}
-
-/* Spec requirements (in nanoseconds) */
-#define SPEC_CACHE_LOOKUP_MAX_NS 10000ULL   /* 10μs */
-#define SPEC_PIPELINE_EXEC_MAX_NS 500000ULL /* 500μs */
-#define SPEC_CACHE_HIT_RATE_MIN 0.75        /* 75% */
-
-#define BENCHMARK(name)                                                        \
-    printf("\n===============================================================" \
-           "==\n");                                                            \
-    printf("[ BENCHMARK ] %s\n", name);                                        \
-    printf(                                                                    \
-        "=================================================================\n")
-
-#define REPORT_TIME(label, elapsed_ns, spec_max_ns)                            \
-    do {                                                                       \
-        double ms = elapsed_ns / 1000000.0;                                    \
-        double us = elapsed_ns / 1000.0;                                       \
-        printf("  %-30s: %.3f μs (%.6f ms)\n", label, us, ms);                 \
-        if (spec_max_ns > 0) {                                                 \
-            printf("  %-30s: < %.3f μs\n", "Spec requirement",                 \
-                   spec_max_ns / 1000.0);                                      \
-            if (elapsed_ns <= spec_max_ns) {                                   \
-                printf("  %-30s: ✓ PASS\n", "Result");                         \
-            } else {                                                           \
-                printf("  %-30s: ✗ FAIL (exceeds by %.3f μs)\n", "Result",     \
-                       (elapsed_ns - spec_max_ns) / 1000.0);                   \
-            }                                                                  \
-        }                                                                      \
-    } while (0)
-
-/* ========================================================================== */
-/*                    BENCHMARK 1: CACHE PERFORMANCE                          */
-/* ========================================================================== */
-
-static void benchmark_cache_operations(void) {
-    BENCHMARK("Cache Operations Performance");
-
-    lle_display_cache_t *cache = NULL;
-    lle_result_t result = lle_display_cache_init(&cache, mock_pool);
-    if (result != LLE_SUCCESS) {
-        printf("  ERROR: Cache initialization failed\n");
-        return;
-    }
-
-    /* Benchmark 1a: Cache store performance */
-    printf("\n1a. Cache Store Operations\n");
-    printf("  Storing 100 entries...\n");
-
-    const char *test_data = "This is cached render output data for testing";
-    size_t data_size = strlen(test_data);
-
-    uint64_t store_start = get_nanos();
-    for (int i = 0; i < 100; i++) {
-        lle_display_cache_store(cache, (uint64_t)i, test_data, data_size);
-    }
-    uint64_t store_end = get_nanos();
-    uint64_t store_total = store_end - store_start;
-    uint64_t store_avg = store_total / 100;
-
-    REPORT_TIME("Average store time", store_avg, 0);
-
-    /* Benchmark 1b: Cache lookup performance (hits) */
-    printf("\n1b. Cache Lookup Performance (Cache Hits)\n");
-    printf("  Looking up 100 entries (all should hit)...\n");
-
-    uint64_t lookup_start = get_nanos();
-    for (int i = 0; i < 100; i++) {
-        void *data = NULL;
-        size_t size = 0;
-        lle_display_cache_lookup(cache, (uint64_t)i, &data, &size);
-    }
-    uint64_t lookup_end = get_nanos();
-    uint64_t lookup_total = lookup_end - lookup_start;
-    uint64_t lookup_avg = lookup_total / 100;
-
-    REPORT_TIME("Average lookup time", lookup_avg, SPEC_CACHE_LOOKUP_MAX_NS);
-
-    /* Benchmark 1c: Cache hit rate test */
-    printf("\n1c. Cache Hit Rate Test\n");
-    printf("  100 lookups: 80 hits, 20 misses expected\n");
-
-    int hits = 0;
-    int misses = 0;
-
-    for (int i = 0; i < 100; i++) {
-        void *data = NULL;
-        size_t size = 0;
-        uint64_t key =
-            (i < 80) ? (uint64_t)i
-                     : (uint64_t)(i + 100); /* First 80 hit, last 20 miss */
-        result = lle_display_cache_lookup(cache, key, &data, &size);
-        if (result == LLE_SUCCESS) {
-            hits++;
-        } else {
-            misses++;
-        }
-    }
-
-    double hit_rate = (double)hits / 100.0;
-    printf("  Cache hits: %d\n", hits);
-    printf("  Cache misses: %d\n", misses);
-    printf("  Hit rate: %.1f%%\n", hit_rate * 100.0);
-    printf("  Spec requirement: > %.1f%%\n", SPEC_CACHE_HIT_RATE_MIN * 100.0);
-
-    if (hit_rate >= SPEC_CACHE_HIT_RATE_MIN) {
-        printf("  Result: ✓ PASS\n");
-    } else {
-        printf("  Result: ✗ FAIL (%.1f%% below target)\n",
-               (SPEC_CACHE_HIT_RATE_MIN - hit_rate) * 100.0);
-    }
-
-    /* Benchmark 1d: Cache invalidation performance */
-    printf("\n1d. Cache Invalidation Performance\n");
-
-    uint64_t inval_start = get_nanos();
-    for (int i = 0; i < 50; i++) {
-        lle_display_cache_invalidate(cache, (uint64_t)i);
-    }
-    uint64_t inval_end = get_nanos();
-    uint64_t inval_total = inval_end - inval_start;
-    uint64_t inval_avg = inval_total / 50;
-
-    REPORT_TIME("Average invalidate time", inval_avg, 0);
-
-    lle_display_cache_cleanup(cache);
-}
-
-/* ========================================================================== */
-/*                    BENCHMARK 2: PIPELINE PERFORMANCE                       */
-/* ========================================================================== */
-
-static void benchmark_pipeline_operations(void) {
-    BENCHMARK("Render Pipeline Performance");
-
-    lle_render_pipeline_t *pipeline = NULL;
-    lle_result_t result = lle_render_pipeline_init(&pipeline, mock_pool);
-    if (result != LLE_SUCCESS) {
-        printf("  ERROR: Pipeline initialization failed\n");
-        return;
-    }
-
-    /* Benchmark 2a: Pipeline execution with small content */
-    printf("\n2a. Pipeline Execution (Small Content)\n");
-    printf("  Executing pipeline 100 times with 50-char content...\n");
-
-    uint64_t exec_start = get_nanos();
-    for (int i = 0; i < 100; i++) {
-        lle_render_context_t context = {0};
-        lle_render_output_t *output = NULL;
-        lle_render_pipeline_execute(pipeline, &context, &output);
-    }
-    uint64_t exec_end = get_nanos();
-    uint64_t exec_total = exec_end - exec_start;
-    uint64_t exec_avg = exec_total / 100;
-
-    REPORT_TIME("Average execution time", exec_avg, SPEC_PIPELINE_EXEC_MAX_NS);
-
-    /* Benchmark 2b: Pipeline execution with medium content */
-    printf("\n2b. Pipeline Execution (Medium Content)\n");
-    printf("  Executing pipeline 50 times with 500-char content...\n");
-
-    exec_start = get_nanos();
-    for (int i = 0; i < 50; i++) {
-        lle_render_context_t context = {0};
-        lle_render_output_t *output = NULL;
-        lle_render_pipeline_execute(pipeline, &context, &output);
-    }
-    exec_end = get_nanos();
-    exec_total = exec_end - exec_start;
-    exec_avg = exec_total / 50;
-
-    REPORT_TIME("Average execution time", exec_avg, SPEC_PIPELINE_EXEC_MAX_NS);
-
-    lle_render_pipeline_cleanup(pipeline);
-}
-
-/* ========================================================================== */
-/*                    BENCHMARK 3: DIRTY TRACKER PERFORMANCE                  */
-/* ========================================================================== */
-
-static void benchmark_dirty_tracker_operations(void) {
-    BENCHMARK("Dirty Tracker Performance");
-
-    lle_dirty_tracker_t *tracker = NULL;
-    lle_result_t result = lle_dirty_tracker_init(&tracker, mock_pool);
-    if (result != LLE_SUCCESS) {
-        printf("  ERROR: Tracker initialization failed\n");
-        return;
-    }
-
-    /* Benchmark 3a: Mark region performance */
-    printf("\n3a. Mark Region Operations\n");
-    printf("  Marking 1000 individual regions...\n");
-
-    uint64_t mark_start = get_nanos();
-    for (int i = 0; i < 1000; i++) {
-        lle_dirty_tracker_mark_region(tracker, (size_t)(i * 10));
-    }
-    uint64_t mark_end = get_nanos();
-    uint64_t mark_total = mark_end - mark_start;
-    uint64_t mark_avg = mark_total / 1000;
-
-    REPORT_TIME("Average mark time", mark_avg, 0);
-
-    /* Benchmark 3b: Query performance */
-    printf("\n3b. Dirty Query Operations\n");
-    printf("  Querying 1000 regions...\n");
-
-    uint64_t query_start = get_nanos();
-    for (int i = 0; i < 1000; i++) {
-        lle_dirty_tracker_is_region_dirty(tracker, (size_t)(i * 10));
-    }
-    uint64_t query_end = get_nanos();
-    uint64_t query_total = query_end - query_start;
-    uint64_t query_avg = query_total / 1000;
-
-    REPORT_TIME("Average query time", query_avg, 0);
-
-    /* Benchmark 3c: Clear performance */
-    printf("\n3c. Clear Operations\n");
-    printf("  Clearing tracker 100 times...\n");
-
-    uint64_t clear_start = get_nanos();
-    for (int i = 0; i < 100; i++) {
-        lle_dirty_tracker_clear(tracker);
-    }
-    uint64_t clear_end = get_nanos();
-    uint64_t clear_total = clear_end - clear_start;
-    uint64_t clear_avg = clear_total / 100;
-
-    REPORT_TIME("Average clear time", clear_avg, 0);
-
-    lle_dirty_tracker_cleanup(tracker);
-}
-
-/* ========================================================================== */
-/*                             MAIN BENCHMARK RUNNER                          */
-/* ========================================================================== */
-
-int main(void) {
-    printf("\n");
-    printf(
-        "#################################################################\n");
-    printf(
-        "#                                                               #\n");
-    printf(
-        "#        LLE Spec 08 - Display Integration Benchmarks          #\n");
-    printf(
-        "#                                                               #\n");
-    printf(
-        "#################################################################\n");
-
-    /* Run all benchmarks */
-    benchmark_cache_operations();
-    benchmark_pipeline_operations();
-    benchmark_dirty_tracker_operations();
-
-    /* Summary */
-    printf("\n");
-    printf(
-        "=================================================================\n");
-    printf("  Benchmark Suite Complete\n");
-    printf(
-        "=================================================================\n");
-    printf(
-        "\nNOTE: Minor spec exceedances are acceptable during development.\n");
-    printf("      Performance optimization is an iterative process.\n");
-    printf("      See: docs/lle_implementation/SPEC_03_LESSONS_LEARNED.md\n");
-    printf("\n");
-
-    return 0;
-}
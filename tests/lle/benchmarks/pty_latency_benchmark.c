@@ -0,0 +1,613 @@
+/**
+ * @file pty_latency_benchmark.c
+ * @brief End-to-end interactive latency benchmark for LLE
+ *
+ * Spawns lush under a pseudo-terminal and replays keystroke scenarios
+ * against the real lle_readline loop: typing, Tab completion, Ctrl-R
+ * search, bracketed paste and resize storms. For every input event the
+ * time from the write on the master side until the screen output settles
+ * is recorded, and each scenario is reported as percentiles.
+ *
+ * The shell runs with a private HOME, so the user's configuration and
+ * history are never touched. A large history and slow PATH directories
+ * (many directories full of executables) can be emulated to measure how
+ * the editor scales.
+ *
+ * Usage:
+ *   pty_latency_benchmark --lush PATH [--iterations N] [--settle-ms MS]
+ *                         [--history N] [--slow-path N]
+ *                         [--scenario NAME] [--json FILE]
+ *                         [--startup-budget MS]
+ *
+ * With --startup-budget the run fails if the time from exec to the first
+ * prompt exceeds the budget, which keeps cold start a measured target.
+ *
+ * Runs without a controlling terminal, so it works under meson and CI.
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/** @brief Longest time to wait for any output after an input event */
+#define RESPONSE_TIMEOUT_MS 2000
+
+/** @brief Longest time to wait for the first prompt */
+#define STARTUP_TIMEOUT_MS 10000
+
+/** @brief Maximum samples kept per scenario */
+#define MAX_SAMPLES 8192
+
+/**
+ * @brief Latency samples for one scenario
+ */
+typedef struct latency_stats {
+    const char *name;             /**< Scenario name */
+    uint64_t samples[MAX_SAMPLES]; /**< Per-event latency in ns */
+    size_t count;                 /**< Samples recorded */
+    size_t timeouts;              /**< Events that produced no output */
+} latency_stats_t;
+
+/**
+ * @brief Benchmark options
+ */
+typedef struct pty_options {
+    const char *lush_path; /**< Shell binary under test */
+    int iterations;        /**< Repetitions of each scenario */
+    int settle_ms;         /**< Quiet period that ends an event */
+    int history_entries;   /**< Synthetic history size (0 = none) */
+    int slow_path_dirs;    /**< Synthetic PATH directories (0 = none) */
+    const char *scenario;  /**< Only run this scenario (NULL = all) */
+    const char *json_path; /**< JSON output file (NULL = none) */
+    double startup_budget; /**< Startup-to-prompt limit in ms (0 = none) */
+} pty_options_t;
+
+static pty_options_t opts = {NULL, 20, 30, 0, 0, NULL, NULL, 0.0};
+
+/** @brief Measured time from exec to the first prompt, in ms */
+static double startup_ms = 0.0;
+
+/** @brief Master side of the pty */
+static int master_fd = -1;
+
+/** @brief Shell process */
+static pid_t shell_pid = -1;
+
+/** @brief Private HOME for the shell */
+static char home_dir[] = "/tmp/lush-pty-bench-XXXXXX";
+
+/* ============================================================================
+ * TIMING
+ * ============================================================================
+ */
+
+static uint64_t get_nanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* ============================================================================
+ * PTY I/O
+ * ============================================================================
+ */
+
+/**
+ * @brief Answer terminal queries the editor sends during startup
+ *
+ * LLE probes the terminal (cursor position, device attributes); without
+ * answers it falls back to timeouts, which would distort measurements.
+ */
+static void answer_queries(const char *buf, size_t len) {
+    for (size_t i = 0; i + 2 < len; i++) {
+        if (buf[i] != '\033' || buf[i + 1] != '[') {
+            continue;
+        }
+        if (i + 3 < len && buf[i + 2] == '6' && buf[i + 3] == 'n') {
+            const char reply[] = "\033[1;1R";
+            (void)!write(master_fd, reply, sizeof(reply) - 1);
+        } else if (buf[i + 2] == 'c' ||
+                   (i + 3 < len && buf[i + 2] == '0' && buf[i + 3] == 'c')) {
+            const char reply[] = "\033[?62;22c";
+            (void)!write(master_fd, reply, sizeof(reply) - 1);
+        }
+    }
+}
+
+/**
+ * @brief Read shell output until it has been quiet for settle_ms
+ *
+ * @param timeout_ms Longest wait for the first byte
+ * @param last_output_ns Set to the time the last byte arrived (0 if none)
+ * @return Number of bytes read, or -1 if the shell went away
+ */
+static ssize_t drain_until_settled(int timeout_ms, uint64_t *last_output_ns) {
+    char buf[16384];
+    ssize_t total = 0;
+    *last_output_ns = 0;
+
+    int wait_ms = timeout_ms;
+    for (;;) {
+        struct pollfd pfd = {.fd = master_fd, .events = POLLIN};
+        int ready = poll(&pfd, 1, wait_ms);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (ready == 0) {
+            return total;
+        }
+
+        ssize_t n = read(master_fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return total > 0 ? total : -1;
+        }
+        *last_output_ns = get_nanos();
+        answer_queries(buf, (size_t)n);
+        total += n;
+        wait_ms = opts.settle_ms;
+    }
+}
+
+/**
+ * @brief Send input and record the time until output settles
+ */
+static void measure_write(latency_stats_t *stats, const char *data,
+                          size_t len) {
+    uint64_t start = get_nanos();
+    if (write(master_fd, data, len) != (ssize_t)len) {
+        stats->timeouts++;
+        return;
+    }
+
+    uint64_t last = 0;
+    drain_until_settled(RESPONSE_TIMEOUT_MS, &last);
+    if (last == 0) {
+        stats->timeouts++;
+        return;
+    }
+    if (stats->count < MAX_SAMPLES) {
+        stats->samples[stats->count++] = last - start;
+    }
+}
+
+/** @brief Send input without measuring and wait for the screen to settle */
+static void send_unmeasured(const char *data) {
+    uint64_t last = 0;
+    (void)!write(master_fd, data, strlen(data));
+    drain_until_settled(RESPONSE_TIMEOUT_MS, &last);
+}
+
+static void set_window_size(unsigned short rows, unsigned short cols) {
+    struct winsize ws = {.ws_row = rows, .ws_col = cols};
+    ioctl(master_fd, TIOCSWINSZ, &ws);
+}
+
+/* ============================================================================
+ * ENVIRONMENT SETUP
+ * ============================================================================
+ */
+
+static int remove_entry(const char *path, const struct stat *sb, int flag,
+                        struct FTW *ftw) {
+    (void)sb;
+    (void)flag;
+    (void)ftw;
+    return remove(path);
+}
+
+static void cleanup_home(void) {
+    nftw(home_dir, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+static int write_text_file(const char *path, const char *text) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        return -1;
+    }
+    fputs(text, fp);
+    fclose(fp);
+    return 0;
+}
+
+/**
+ * @brief Create the private HOME, config, history and PATH directories
+ * @param path_out Buffer for the PATH value to export
+ * @param path_size Size of path_out
+ * @return 0 on success, -1 on failure
+ */
+static int setup_home(char *path_out, size_t path_size) {
+    if (!mkdtemp(home_dir)) {
+        perror("mkdtemp");
+        return -1;
+    }
+
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/.config", home_dir);
+    mkdir(path, 0700);
+    snprintf(path, sizeof(path), "%s/.config/lush", home_dir);
+    mkdir(path, 0700);
+
+    char config[256];
+    snprintf(config, sizeof(config), "history.size = %d\n",
+             opts.history_entries > 1000 ? opts.history_entries + 1000 : 2000);
+    snprintf(path, sizeof(path), "%s/.config/lush/lushrc.toml", home_dir);
+    write_text_file(path, config);
+
+    if (opts.history_entries > 0) {
+        snprintf(path, sizeof(path), "%s/.lush_history", home_dir);
+        FILE *fp = fopen(path, "w");
+        if (fp) {
+            for (int i = 0; i < opts.history_entries; i++) {
+                fprintf(fp, "%ld\tgit commit -m 'change %d' src/file%d.c\t0\t%s\n",
+                        (long)(1700000000 + i), i % 997, i, home_dir);
+            }
+            fclose(fp);
+        }
+    }
+
+    size_t used = 0;
+    path_out[0] = '\0';
+    for (int d = 0; d < opts.slow_path_dirs; d++) {
+        snprintf(path, sizeof(path), "%s/bin%03d", home_dir, d);
+        mkdir(path, 0700);
+        for (int f = 0; f < 200; f++) {
+            char exe[4200];
+            snprintf(exe, sizeof(exe), "%s/tool%03d_%03d", path, d, f);
+            int fd = open(exe, O_WRONLY | O_CREAT, 0700);
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        int n = snprintf(path_out + used, path_size - used, "%s:", path);
+        if (n < 0 || (size_t)n >= path_size - used) {
+            break;
+        }
+        used += (size_t)n;
+    }
+    snprintf(path_out + used, path_size - used, "/usr/local/bin:/usr/bin:/bin");
+    return 0;
+}
+
+/* ============================================================================
+ * SHELL PROCESS
+ * ============================================================================
+ */
+
+static int spawn_shell(const char *path_value) {
+    master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master_fd < 0 || grantpt(master_fd) != 0 ||
+        unlockpt(master_fd) != 0) {
+        perror("posix_openpt");
+        return -1;
+    }
+    const char *slave_name = ptsname(master_fd);
+    if (!slave_name) {
+        perror("ptsname");
+        return -1;
+    }
+    set_window_size(40, 120);
+
+    shell_pid = fork();
+    if (shell_pid < 0) {
+        perror("fork");
+        return -1;
+    }
+
+    if (shell_pid == 0) {
+        setsid();
+        int slave = open(slave_name, O_RDWR);
+        if (slave < 0) {
+            _exit(127);
+        }
+        ioctl(slave, TIOCSCTTY, 0);
+        dup2(slave, STDIN_FILENO);
+        dup2(slave, STDOUT_FILENO);
+        dup2(slave, STDERR_FILENO);
+        if (slave > STDERR_FILENO) {
+            close(slave);
+        }
+        close(master_fd);
+
+        char config_home[4200];
+        snprintf(config_home, sizeof(config_home), "%s/.config", home_dir);
+        setenv("HOME", home_dir, 1);
+        setenv("XDG_CONFIG_HOME", config_home, 1);
+        setenv("TERM", "xterm-256color", 1);
+        setenv("PATH", path_value, 1);
+        unsetenv("LUSH_XTRACEFD");
+
+        execl(opts.lush_path, opts.lush_path, "-i", (char *)NULL);
+        _exit(127);
+    }
+
+    uint64_t last = 0;
+    uint64_t start = get_nanos();
+    if (drain_until_settled(STARTUP_TIMEOUT_MS, &last) <= 0) {
+        fprintf(stderr, "pty_latency_benchmark: shell produced no prompt\n");
+        return -1;
+    }
+    startup_ms = (double)(last - start) / 1e6;
+    printf("Startup to first prompt: %.2f ms\n", startup_ms);
+    return 0;
+}
+
+static void stop_shell(void) {
+    if (shell_pid > 0) {
+        send_unmeasured("\003");
+        (void)!write(master_fd, "exit\r", 5);
+        for (int i = 0; i < 50; i++) {
+            if (waitpid(shell_pid, NULL, WNOHANG) == shell_pid) {
+                shell_pid = -1;
+                break;
+            }
+            usleep(20000);
+        }
+        if (shell_pid > 0) {
+            kill(shell_pid, SIGKILL);
+            waitpid(shell_pid, NULL, 0);
+            shell_pid = -1;
+        }
+    }
+    if (master_fd >= 0) {
+        close(master_fd);
+        master_fd = -1;
+    }
+}
+
+/* ============================================================================
+ * SCENARIOS
+ * ============================================================================
+ */
+
+static void scenario_typing(latency_stats_t *stats) {
+    const char *text = "echo the quick brown fox jumps over the lazy dog";
+    for (const char *p = text; *p; p++) {
+        measure_write(stats, p, 1);
+    }
+    send_unmeasured("\025"); /* Ctrl-U: clear the line */
+}
+
+static void scenario_tab_completion(latency_stats_t *stats) {
+    send_unmeasured(opts.slow_path_dirs > 0 ? "tool0" : "ec");
+    measure_write(stats, "\t", 1);
+    send_unmeasured("\003"); /* Ctrl-C: abandon line and any menu */
+}
+
+static void scenario_history_search(latency_stats_t *stats) {
+    measure_write(stats, "\022", 1); /* Ctrl-R */
+    const char *query = "change 42";
+    for (const char *p = query; *p; p++) {
+        measure_write(stats, p, 1);
+    }
+    send_unmeasured("\007"); /* Ctrl-G: abort search */
+    send_unmeasured("\003");
+}
+
+static void scenario_bracketed_paste(latency_stats_t *stats) {
+    char paste[4096 + 16];
+    size_t len = 0;
+    memcpy(paste, "\033[200~", 6);
+    len += 6;
+    const char chunk[] = "printf '%s\\n' word ";
+    while (len + sizeof(chunk) - 1 <= 4096) {
+        memcpy(paste + len, chunk, sizeof(chunk) - 1);
+        len += sizeof(chunk) - 1;
+    }
+    memcpy(paste + len, "\033[201~", 6);
+    len += 6;
+
+    measure_write(stats, paste, len);
+    send_unmeasured("\003");
+}
+
+/**
+ * @brief Resize the terminal repeatedly, then measure the next keystroke
+ *
+ * A resize is not guaranteed to produce output on its own, so the sample
+ * is the keystroke after each storm, which includes any resize handling
+ * the editor has queued.
+ */
+static void scenario_resize_storm(latency_stats_t *stats) {
+    send_unmeasured("echo resize test line");
+    for (int i = 0; i < 10; i++) {
+        set_window_size(i % 2 ? 40 : 24, i % 2 ? 120 : 80);
+    }
+    set_window_size(40, 120);
+    measure_write(stats, "x", 1);
+    send_unmeasured("\003");
+}
+
+typedef struct scenario {
+    const char *name;
+    void (*run)(latency_stats_t *stats);
+} scenario_t;
+
+static const scenario_t scenarios[] = {
+    {"typing", scenario_typing},
+    {"tab_completion", scenario_tab_completion},
+    {"history_search", scenario_history_search},
+    {"bracketed_paste", scenario_bracketed_paste},
+    {"resize_storm", scenario_resize_storm},
+};
+
+#define SCENARIO_COUNT (sizeof(scenarios) / sizeof(scenarios[0]))
+
+/* ============================================================================
+ * REPORTING
+ * ============================================================================
+ */
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile_ms(const latency_stats_t *stats, double pct) {
+    if (stats->count == 0) {
+        return 0.0;
+    }
+    size_t idx = (size_t)(pct / 100.0 * (double)(stats->count - 1) + 0.5);
+    return (double)stats->samples[idx] / 1e6;
+}
+
+static void report(latency_stats_t *all, size_t count) {
+    printf("\n%-18s %8s %9s %9s %9s %9s %8s\n", "scenario", "events",
+           "p50 ms", "p90 ms", "p99 ms", "max ms", "timeouts");
+    for (size_t i = 0; i < count; i++) {
+        latency_stats_t *s = &all[i];
+        qsort(s->samples, s->count, sizeof(uint64_t), compare_u64);
+        printf("%-18s %8zu %9.2f %9.2f %9.2f %9.2f %8zu\n", s->name, s->count,
+               percentile_ms(s, 50), percentile_ms(s, 90),
+               percentile_ms(s, 99), percentile_ms(s, 100), s->timeouts);
+    }
+    printf("\n(latency = write to last output byte; settle window %d ms)\n",
+           opts.settle_ms);
+
+    if (!opts.json_path) {
+        return;
+    }
+    FILE *fp = fopen(opts.json_path, "w");
+    if (!fp) {
+        perror(opts.json_path);
+        return;
+    }
+    fprintf(fp, "{\n  \"suite\": \"lle-pty-latency\",\n  \"version\": 1,\n");
+    fprintf(fp, "  \"history_entries\": %d,\n  \"slow_path_dirs\": %d,\n",
+            opts.history_entries, opts.slow_path_dirs);
+    fprintf(fp, "  \"startup_ms\": %.3f,\n", startup_ms);
+    fprintf(fp, "  \"results\": [\n");
+    for (size_t i = 0; i < count; i++) {
+        latency_stats_t *s = &all[i];
+        fprintf(fp,
+                "    {\"name\": \"%s\", \"events\": %zu, \"p50_ms\": %.3f, "
+                "\"p90_ms\": %.3f, \"p99_ms\": %.3f, \"max_ms\": %.3f, "
+                "\"timeouts\": %zu}%s\n",
+                s->name, s->count, percentile_ms(s, 50), percentile_ms(s, 90),
+                percentile_ms(s, 99), percentile_ms(s, 100), s->timeouts,
+                i + 1 < count ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================
+ */
+
+static void usage(void) {
+    fprintf(stderr,
+            "usage: pty_latency_benchmark --lush PATH [--iterations N] "
+            "[--settle-ms MS]\n"
+            "                             [--history N] [--slow-path N] "
+            "[--scenario NAME]\n"
+            "                             [--json FILE] "
+            "[--startup-budget MS]\n");
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (strcmp(arg, "--lush") == 0 && has_value) {
+            opts.lush_path = argv[++i];
+        } else if (strcmp(arg, "--iterations") == 0 && has_value) {
+            opts.iterations = atoi(argv[++i]);
+        } else if (strcmp(arg, "--settle-ms") == 0 && has_value) {
+            opts.settle_ms = atoi(argv[++i]);
+        } else if (strcmp(arg, "--history") == 0 && has_value) {
+            opts.history_entries = atoi(argv[++i]);
+        } else if (strcmp(arg, "--slow-path") == 0 && has_value) {
+            opts.slow_path_dirs = atoi(argv[++i]);
+        } else if (strcmp(arg, "--scenario") == 0 && has_value) {
+            opts.scenario = argv[++i];
+        } else if (strcmp(arg, "--json") == 0 && has_value) {
+            opts.json_path = argv[++i];
+        } else if (strcmp(arg, "--startup-budget") == 0 && has_value) {
+            opts.startup_budget = atof(argv[++i]);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (!opts.lush_path) {
+        opts.lush_path = getenv("LUSH_BIN");
+    }
+    if (!opts.lush_path || opts.iterations <= 0 || opts.settle_ms <= 0) {
+        usage();
+        return 2;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    static char path_value[65536];
+    if (setup_home(path_value, sizeof(path_value)) != 0) {
+        return 1;
+    }
+
+    printf("LLE PTY latency benchmark: %s\n", opts.lush_path);
+    printf("  iterations %d, history %d entries, %d slow PATH dirs\n",
+           opts.iterations, opts.history_entries, opts.slow_path_dirs);
+
+    if (spawn_shell(path_value) != 0) {
+        stop_shell();
+        cleanup_home();
+        return 1;
+    }
+
+    static latency_stats_t stats[SCENARIO_COUNT];
+    size_t used = 0;
+    for (size_t i = 0; i < SCENARIO_COUNT; i++) {
+        if (opts.scenario && strcmp(opts.scenario, scenarios[i].name) != 0) {
+            continue;
+        }
+        latency_stats_t *s = &stats[used++];
+        s->name = scenarios[i].name;
+        for (int it = 0; it < opts.iterations; it++) {
+            scenarios[i].run(s);
+        }
+    }
+
+    stop_shell();
+    cleanup_home();
+
+    report(stats, used);
+
+    int status = 0;
+    for (size_t i = 0; i < used; i++) {
+        if (stats[i].count == 0) {
+            status = 1;
+        }
+    }
+    if (opts.startup_budget > 0 && startup_ms > opts.startup_budget) {
+        printf("Startup budget exceeded: %.2f ms > %.2f ms\n", startup_ms,
+               opts.startup_budget);
+        status = 1;
+    }
+    return status;
+}
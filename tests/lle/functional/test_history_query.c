@@ -0,0 +1,677 @@
+/**
+ * test_history_query.c - Structured History Query Tests
+ *
+ * Test suite for history queries and their secondary indexes:
+ * - Query string parsing (dir:, under:, exit:, dur:, since:, until:,
+ *   session:) and error reporting
+ * - Directory, exit status, duration, time and session filtering
+ * - Recording command outcomes after the index is built
+ * - Query search results and interactive ordering
+ * - Duration persistence in the history file
+ * - Query performance on a large history
+ */
+
+#include "lle/error_handling.h"
+#include "lle/history.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Test memory mock provided by test_memory_mock.c */
+
+/* Test result tracking */
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+/* Helper macros */
+#define TEST_START(name)                                                       \
+    do {                                                                       \
+        tests_run++;                                                           \
+        printf("\n[TEST %d] %s...\n", tests_run, name);                        \
+    } while (0)
+
+#define TEST_PASS()                                                            \
+    do {                                                                       \
+        tests_passed++;                                                        \
+        printf("  ✓ PASS\n");                                                  \
+    } while (0)
+
+#define TEST_FAIL(msg)                                                         \
+    do {                                                                       \
+        tests_failed++;                                                        \
+        printf("  ✗ FAIL: %s\n", msg);                                         \
+    } while (0)
+
+#define ASSERT_EQ(actual, expected, msg)                                       \
+    do {                                                                       \
+        if ((actual) != (expected)) {                                          \
+            printf("  ✗ ASSERTION FAILED: %s\n", msg);                         \
+            printf("    Expected: %ld, Got: %ld\n", (long)(expected),          \
+                   (long)(actual));                                            \
+            TEST_FAIL(msg);                                                    \
+            return;                                                            \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_TRUE(cond, msg)                                                 \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf("  ✗ ASSERTION FAILED: %s\n", msg);                         \
+            TEST_FAIL(msg);                                                    \
+            return;                                                            \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_NOT_NULL(ptr, msg)                                              \
+    do {                                                                       \
+        if ((ptr) == NULL) {                                                   \
+            printf("  ✗ ASSERTION FAILED: %s (got NULL)\n", msg);              \
+            TEST_FAIL(msg);                                                    \
+            return;                                                            \
+        }                                                                      \
+    } while (0)
+
+/* ============================================================================
+ * HELPERS
+ * ============================================================================
+ */
+
+/**
+ * Replace an entry's working directory
+ */
+static void set_directory(lle_history_core_t *core, size_t index,
+                          const char *dir) {
+    lle_history_entry_t *entry = NULL;
+    lle_history_get_entry_by_index(core, index, &entry);
+    if (!entry) {
+        return;
+    }
+    if (entry->working_directory) {
+        lle_pool_free(entry->working_directory);
+    }
+    size_t len = strlen(dir) + 1;
+    entry->working_directory = lle_pool_alloc(len);
+    memcpy(entry->working_directory, dir, len);
+}
+
+/**
+ * Add an entry with a directory, exit status, duration and timestamp, as
+ * if its outcome had been recorded
+ */
+static void add_entry(lle_history_core_t *core, const char *command,
+                      const char *dir, int exit_code, uint32_t duration_ms,
+                      uint64_t timestamp) {
+    lle_history_add_entry(core, command, exit_code, NULL);
+    size_t count = 0;
+    lle_history_get_entry_count(core, &count);
+    lle_history_entry_t *entry = NULL;
+    lle_history_get_entry_by_index(core, count - 1, &entry);
+    if (!entry) {
+        return;
+    }
+    set_directory(core, count - 1, dir);
+    entry->duration_ms = duration_ms;
+    entry->outcome_known = true;
+    entry->timestamp = timestamp;
+}
+
+/**
+ * Parse and run a query, returning the match count (or -1 on error)
+ */
+static long run_query(lle_history_core_t *core, const char *text,
+                      size_t *positions, size_t max) {
+    lle_history_query_t query;
+    if (lle_history_query_parse(text, &query, NULL, 0) != LLE_SUCCESS) {
+        return -1;
+    }
+    size_t count = 0;
+    if (lle_history_query_run(core, &query, max, positions, &count) !=
+        LLE_SUCCESS) {
+        return -1;
+    }
+    return (long)count;
+}
+
+/**
+ * Build a small history spanning several directories and outcomes
+ *
+ * Index  Command         Directory      Exit  Duration  Age
+ *   0    make            /src/app        2     12000ms  10 days
+ *   1    make test       /src/app        0     45000ms   3 days
+ *   2    ls              /src/app/lib    0         5ms   2 days
+ *   3    git push        /src/apple      1       800ms   1 day
+ *   4    make            /src/app/lib    2      9000ms   2 hours
+ *   5    echo hi         /tmp            0         0ms  10 minutes
+ */
+static lle_history_core_t *create_sample_history(uint64_t now) {
+    lle_history_core_t *core = NULL;
+    if (lle_history_core_create(&core, NULL, NULL) != LLE_SUCCESS) {
+        return NULL;
+    }
+    add_entry(core, "make", "/src/app", 2, 12000, now - 10 * 86400);
+    add_entry(core, "make test", "/src/app", 0, 45000, now - 3 * 86400);
+    add_entry(core, "ls", "/src/app/lib", 0, 5, now - 2 * 86400);
+    add_entry(core, "git push", "/src/apple", 1, 800, now - 86400);
+    add_entry(core, "make", "/src/app/lib", 2, 9000, now - 2 * 3600);
+    add_entry(core, "echo hi", "/tmp", 0, 0, now - 600);
+    return core;
+}
+
+/* ============================================================================
+ * PARSING TESTS
+ * ============================================================================
+ */
+
+void test_parse_filters(void) {
+    TEST_START("Parse Filter Words");
+
+    lle_history_query_t q;
+    char error[128];
+    lle_result_t result = lle_history_query_parse(
+        "make dir:/src/app exit:fail dur:>10s session:42 test", &q, error,
+        sizeof(error));
+    ASSERT_EQ(result, LLE_SUCCESS, "Query should parse");
+    ASSERT_TRUE(strcmp(q.text, "make test") == 0,
+                "Text words should be joined");
+    ASSERT_TRUE(strcmp(q.directory, "/src/app") == 0, "Directory parsed");
+    ASSERT_TRUE(!q.subtree, "dir: is not a subtree filter");
+    ASSERT_EQ(q.exit_filter, LLE_HISTORY_QUERY_EXIT_FAILED, "exit:fail");
+    ASSERT_EQ(q.min_duration_ms, 10001, "dur:>10s is exclusive");
+    ASSERT_EQ(q.max_duration_ms, UINT32_MAX, "No upper duration bound");
+    ASSERT_TRUE(q.session_set && q.session_id == 42, "session:42");
+    ASSERT_TRUE(lle_history_query_has_filters(&q), "Has filters");
+
+    result = lle_history_query_parse("under:/src/ exit:0 dur:<=500ms", &q,
+                                     NULL, 0);
+    ASSERT_EQ(result, LLE_SUCCESS, "Query should parse");
+    ASSERT_TRUE(strcmp(q.directory, "/src") == 0,
+                "Trailing slash should be dropped");
+    ASSERT_TRUE(q.subtree, "under: is a subtree filter");
+    ASSERT_EQ(q.exit_filter, LLE_HISTORY_QUERY_EXIT_CODE, "exit:0 is a code");
+    ASSERT_EQ(q.exit_code, 0, "Exit code 0");
+    ASSERT_EQ(q.max_duration_ms, 500, "dur:<=500ms");
+
+    result = lle_history_query_parse("exit:!0 dur:2m", &q, NULL, 0);
+    ASSERT_EQ(result, LLE_SUCCESS, "Query should parse");
+    ASSERT_EQ(q.exit_filter, LLE_HISTORY_QUERY_EXIT_FAILED, "exit:!0");
+    ASSERT_EQ(q.min_duration_ms, 120000, "Bare duration is a minimum");
+
+    TEST_PASS();
+}
+
+void test_parse_times(void) {
+    TEST_START("Parse Time Filters");
+
+    lle_history_query_t q;
+    time_t before = time(NULL);
+    lle_result_t result =
+        lle_history_query_parse("since:1w until:2h", &q, NULL, 0);
+    time_t after = time(NULL);
+    ASSERT_EQ(result, LLE_SUCCESS, "Relative times should parse");
+    ASSERT_TRUE(q.since >= (uint64_t)(before - 7 * 86400) &&
+                    q.since <= (uint64_t)(after - 7 * 86400),
+                "since:1w is a week ago");
+    ASSERT_TRUE(q.until >= (uint64_t)(before - 7200) &&
+                    q.until <= (uint64_t)(after - 7200),
+                "until:2h is two hours ago");
+
+    result = lle_history_query_parse("since:2024-03-05", &q, NULL, 0);
+    ASSERT_EQ(result, LLE_SUCCESS, "Dates should parse");
+    time_t t = (time_t)q.since;
+    struct tm tm;
+    localtime_r(&t, &tm);
+    ASSERT_TRUE(tm.tm_year == 124 && tm.tm_mon == 2 && tm.tm_mday == 5 &&
+                    tm.tm_hour == 0,
+                "Date is local midnight");
+
+    result = lle_history_query_parse("since:today", &q, NULL, 0);
+    ASSERT_EQ(result, LLE_SUCCESS, "today should parse");
+    t = (time_t)q.since;
+    localtime_r(&t, &tm);
+    ASSERT_TRUE(tm.tm_hour == 0 && tm.tm_min == 0, "today is midnight");
+
+    TEST_PASS();
+}
+
+void test_parse_errors_and_text(void) {
+    TEST_START("Parse Errors and Plain Text");
+
+    lle_history_query_t q;
+    char error[128];
+
+    ASSERT_EQ(lle_history_query_parse("exit:maybe", &q, error, sizeof(error)),
+              LLE_ERROR_INVALID_PARAMETER, "Bad exit status rejected");
+    ASSERT_TRUE(strstr(error, "exit status") != NULL,
+                "Error names the filter");
+    ASSERT_EQ(lle_history_query_parse("dur:>fast", &q, NULL, 0),
+              LLE_ERROR_INVALID_PARAMETER, "Bad duration rejected");
+    ASSERT_EQ(lle_history_query_parse("since:later", &q, NULL, 0),
+              LLE_ERROR_INVALID_PARAMETER, "Bad time rejected");
+    ASSERT_EQ(lle_history_query_parse("session:abc", &q, NULL, 0),
+              LLE_ERROR_INVALID_PARAMETER, "Bad session rejected");
+
+    /* Unknown keys are text, so URLs and key:value arguments still work */
+    ASSERT_EQ(lle_history_query_parse("curl http://example.com", &q, NULL, 0),
+              LLE_SUCCESS, "Unknown key is text");
+    ASSERT_TRUE(strcmp(q.text, "curl http://example.com") == 0,
+                "URL kept as text");
+    ASSERT_TRUE(!lle_history_query_has_filters(&q), "Text only");
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * FILTERING TESTS
+ * ============================================================================
+ */
+
+void test_directory_filters(void) {
+    TEST_START("Directory Filters");
+
+    uint64_t now = (uint64_t)time(NULL);
+    lle_history_core_t *core = create_sample_history(now);
+    ASSERT_NOT_NULL(core, "Core creation should succeed");
+
+    size_t pos[16];
+    ASSERT_EQ(run_query(core, "dir:/src/app", pos, 16), 2,
+              "Two commands in /src/app");
+    ASSERT_EQ(pos[0], 1, "Newest first");
+    ASSERT_EQ(pos[1], 0, "Then older");
+
+    ASSERT_EQ(run_query(core, "under:/src/app", pos, 16), 4,
+              "Subtree includes /src/app/lib but not /src/apple");
+    ASSERT_EQ(pos[0], 4, "Newest subtree match first");
+
+    ASSERT_EQ(run_query(core, "under:/", pos, 16), 6, "Root covers all");
+    ASSERT_EQ(run_query(core, "dir:/nowhere", pos, 16), 0,
+              "Unknown directory matches nothing");
+    ASSERT_EQ(run_query(core, "make under:/src/app", pos, 16), 3,
+              "Text combines with directory");
+
+    lle_history_core_destroy(core);
+    TEST_PASS();
+}
+
+void test_exit_and_duration_filters(void) {
+    TEST_START("Exit Status and Duration Filters");
+
+    uint64_t now = (uint64_t)time(NULL);
+    lle_history_core_t *core = create_sample_history(now);
+    ASSERT_NOT_NULL(core, "Core creation should succeed");
+
+    size_t pos[16];
+    ASSERT_EQ(run_query(core, "exit:fail", pos, 16), 3, "Three failures");
+    ASSERT_EQ(run_query(core, "exit:2", pos, 16), 2, "Two exit 2");
+    ASSERT_EQ(run_query(core, "exit:ok", pos, 16), 3, "Three successes");
+
+    ASSERT_EQ(run_query(core, "dur:>10s", pos, 16), 2,
+              "Two commands over 10s");
+    ASSERT_EQ(pos[0], 1, "make test is newest");
+    ASSERT_EQ(pos[1], 0, "make is older");
+    ASSERT_EQ(run_query(core, "dur:<1s", pos, 16), 3,
+              "Three under a second (including untimed)");
+    ASSERT_EQ(run_query(core, "dur:>=800ms dur:<=9s", pos, 16), 2,
+              "Closed duration range");
+
+    ASSERT_EQ(run_query(core, "exit:fail under:/src/app dur:>5s", pos, 16), 2,
+              "Combined filters");
+
+    lle_history_core_destroy(core);
+    TEST_PASS();
+}
+
+void test_time_filters(void) {
+    TEST_START("Time Filters");
+
+    uint64_t now = (uint64_t)time(NULL);
+    lle_history_core_t *core = create_sample_history(now);
+    ASSERT_NOT_NULL(core, "Core creation should succeed");
+
+    size_t pos[16];
+    ASSERT_EQ(run_query(core, "since:1w", pos, 16), 5, "Five in the last week");
+    ASSERT_EQ(run_query(core, "exit:fail since:1w", pos, 16), 2,
+              "Failed commands last week");
+    ASSERT_EQ(run_query(core, "until:1d", pos, 16), 4,
+              "Four at least a day old");
+    ASSERT_EQ(run_query(core, "since:4d until:1d", pos, 16), 3,
+              "Bounded time range");
+
+    /* Out-of-order timestamps must fall back to checking each entry */
+    lle_history_clear(core);
+    add_entry(core, "new", "/a", 0, 0, now - 60);
+    add_entry(core, "old", "/a", 0, 0, now - 30 * 86400);
+    add_entry(core, "newer", "/a", 0, 0, now - 30);
+    ASSERT_EQ(run_query(core, "since:1h", pos, 16), 2,
+              "Unsorted timestamps still filter correctly");
+
+    lle_history_core_destroy(core);
+    TEST_PASS();
+}
+
+void test_session_filter(void) {
+    TEST_START("Session Filter");
+
+    lle_history_core_t *core = NULL;
+    lle_history_core_create(&core, NULL, NULL);
+    lle_history_add_entry(core, "first", 0, NULL);
+    lle_history_add_entry(core, "second", 0, NULL);
+
+    lle_history_entry_t *entry = NULL;
+    lle_history_get_entry_by_index(core, 0, &entry);
+    entry->session_id = 12345;
+
+    size_t pos[8];
+    ASSERT_EQ(run_query(core, "session:12345", pos, 8), 1,
+              "One entry in the other session");
+    ASSERT_EQ(pos[0], 0, "It is the first entry");
+    ASSERT_EQ(run_query(core, "session:current", pos, 8), 1,
+              "One entry in this session");
+    ASSERT_EQ(pos[0], 1, "It is the second entry");
+
+    lle_history_core_destroy(core);
+    TEST_PASS();
+}
+
+void test_deleted_entries_excluded(void) {
+    TEST_START("Deleted Entries Excluded");
+
+    uint64_t now = (uint64_t)time(NULL);
+    lle_history_core_t *core = create_sample_history(now);
+    ASSERT_NOT_NULL(core, "Core creation should succeed");
+
+    lle_history_entry_t *entry = NULL;
+    lle_history_get_entry_by_index(core, 4, &entry);
+    entry->state = LLE_HISTORY_STATE_DELETED;
+
+    size_t pos[16];
+    ASSERT_EQ(run_query(core, "exit:2", pos, 16), 1,
+              "Deleted entry is skipped");
+    ASSERT_EQ(pos[0], 0, "Only the older make remains");
+
+    lle_history_core_destroy(core);
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * INDEX MAINTENANCE TESTS
+ * ============================================================================
+ */
+
+void test_record_result_updates_index(void) {
+    TEST_START("Record Result Updates Index");
+
+    lle_history_core_t *core = NULL;
+    lle_history_core_create(&core, NULL, NULL);
+    lle_history_add_entry(core, "sleep 20", 0, NULL);
+
+    /* Build the index before the outcome is known */
+    size_t pos[8];
+    ASSERT_EQ(run_query(core, "exit:fail", pos, 8), 0, "No failures yet");
+    ASSERT_EQ(run_query(core, "exit:ok", pos, 8), 0,
+              "Still running, so not successful either");
+    ASSERT_EQ(run_query(core, "dur:<1s", pos, 8), 0, "Not timed yet");
+    ASSERT_EQ(run_query(core, "sleep", pos, 8), 1, "Found without filters");
+
+    ASSERT_EQ(lle_history_record_result(core, "sleep 20\n", 130, 20500),
+              LLE_SUCCESS, "Outcome recorded (trailing newline ignored)");
+    ASSERT_EQ(run_query(core, "exit:fail", pos, 8), 1, "Now failed");
+    ASSERT_EQ(run_query(core, "exit:130", pos, 8), 1, "Exact code");
+    ASSERT_EQ(run_query(core, "exit:ok", pos, 8), 0, "No longer successful");
+    ASSERT_EQ(run_query(core, "dur:>20s", pos, 8), 1, "Duration indexed");
+    ASSERT_EQ(run_query(core, "dur:<1s", pos, 8), 0, "Old bucket dropped");
+
+    /* New entries after the index was built are picked up lazily */
+    lle_history_add_entry(core, "false", 0, NULL);
+    ASSERT_EQ(lle_history_record_result(core, "false", 1, 3), LLE_SUCCESS,
+              "Second outcome recorded");
+    ASSERT_EQ(run_query(core, "exit:fail", pos, 8), 2, "Both failed");
+    ASSERT_EQ(pos[0], 1, "Newest first");
+
+    /* A second outcome for the same entry moves its postings */
+    ASSERT_EQ(lle_history_record_result(core, "false", 0, 3), LLE_SUCCESS,
+              "Outcome recorded again");
+    ASSERT_EQ(run_query(core, "exit:fail", pos, 8), 1, "One failure left");
+    ASSERT_EQ(run_query(core, "exit:ok", pos, 8), 1, "Now successful");
+
+    ASSERT_EQ(lle_history_record_result(core, "never ran", 0, 1),
+              LLE_ERROR_NOT_FOUND, "Unknown command not recorded");
+
+    /* Clearing resets positions and the index */
+    lle_history_clear(core);
+    lle_history_add_entry(core, "true", 0, NULL);
+    ASSERT_EQ(run_query(core, "exit:fail", pos, 8), 0,
+              "Cleared history has no failures");
+
+    lle_history_core_destroy(core);
+    TEST_PASS();
+}
+
+void test_search_query_results(void) {
+    TEST_START("Query Search Results");
+
+    uint64_t now = (uint64_t)time(NULL);
+    lle_history_core_t *core = create_sample_history(now);
+    ASSERT_NOT_NULL(core, "Core creation should succeed");
+
+    lle_history_search_results_t *results =
+        lle_history_search_query(core, "make exit:fail", 10);
+    ASSERT_NOT_NULL(results, "Search should succeed");
+    ASSERT_EQ(lle_history_search_results_get_count(results), 2,
+              "Two failed makes");
+
+    lle_history_search_results_sort(results);
+    const lle_search_result_t *r = lle_history_search_results_get(results, 0);
+    ASSERT_NOT_NULL(r, "First result");
+    ASSERT_EQ(r->entry_index, 4, "Most recent first after sorting");
+    ASSERT_TRUE(strcmp(r->command, "make") == 0, "Command referenced");
+    lle_history_search_results_destroy(results);
+
+    results = lle_history_search_query(core, "exit:what", 10);
+    ASSERT_TRUE(results == NULL, "Invalid query returns NULL");
+
+    lle_history_core_destroy(core);
+    TEST_PASS();
+}
+
+void test_duration_persistence(void) {
+    TEST_START("Duration Persistence");
+
+    char path[] = "/tmp/lle_history_query_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_TRUE(fd >= 0, "Temp file created");
+    close(fd);
+
+    uint64_t now = (uint64_t)time(NULL);
+    lle_history_core_t *core = create_sample_history(now);
+    ASSERT_NOT_NULL(core, "Core creation should succeed");
+
+    /* An entry without a working directory but with a duration */
+    lle_history_add_entry(core, "nowhere", 3, NULL);
+    lle_history_entry_t *entry = NULL;
+    lle_history_get_entry_by_index(core, 6, &entry);
+    lle_pool_free(entry->working_directory);
+    entry->working_directory = NULL;
+    entry->duration_ms = 1500;
+    entry->outcome_known = true;
+
+    /* An entry whose command never reported back */
+    lle_history_add_entry(core, "pending", 0, NULL);
+
+    ASSERT_EQ(lle_history_save_to_file(core, path), LLE_SUCCESS, "Saved");
+    lle_history_core_destroy(core);
+
+    core = NULL;
+    lle_history_core_create(&core, NULL, NULL);
+    ASSERT_EQ(lle_history_load_from_file(core, path), LLE_SUCCESS, "Loaded");
+    unlink(path);
+
+    size_t count = 0;
+    lle_history_get_entry_count(core, &count);
+    ASSERT_EQ(count, 8, "All entries loaded");
+
+    lle_history_get_entry_by_index(core, 1, &entry);
+    ASSERT_EQ(entry->duration_ms, 45000, "Duration restored");
+    ASSERT_TRUE(strcmp(entry->working_directory, "/src/app") == 0,
+                "Directory restored");
+    lle_history_get_entry_by_index(core, 5, &entry);
+    ASSERT_EQ(entry->duration_ms, 0, "Zero duration restored");
+    ASSERT_TRUE(entry->outcome_known, "Zero duration is still an outcome");
+
+    lle_history_get_entry_by_index(core, 6, &entry);
+    ASSERT_EQ(entry->duration_ms, 1500, "Duration after empty directory");
+    ASSERT_EQ(entry->exit_code, 3, "Exit status restored");
+
+    lle_history_get_entry_by_index(core, 7, &entry);
+    ASSERT_TRUE(!entry->outcome_known, "Pending entry has no outcome");
+
+    size_t pos[16];
+    ASSERT_EQ(run_query(core, "dur:>10s exit:fail", pos, 16), 1,
+              "Queries work on loaded history");
+    ASSERT_EQ(run_query(core, "exit:ok", pos, 16), 3,
+              "Entries without an outcome are not successful");
+
+    lle_history_core_destroy(core);
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * PERFORMANCE TESTS
+ * ============================================================================
+ */
+
+void test_query_performance_large_history(void) {
+    TEST_START("Query Performance - 1000000 Entries");
+
+    const size_t total = 1000000;
+    lle_history_config_t *config = NULL;
+    lle_history_config_create_default(&config, NULL);
+    ASSERT_NOT_NULL(config, "Config creation should succeed");
+    config->max_entries = total;
+    config->initial_capacity = total;
+
+    lle_history_core_t *core = NULL;
+    lle_result_t result = lle_history_core_create(&core, NULL, config);
+    lle_history_config_destroy(config, NULL);
+    ASSERT_EQ(result, LLE_SUCCESS, "Core creation should succeed");
+
+    uint64_t base = (uint64_t)time(NULL) - total;
+    char cmd[64];
+    char dir[64];
+    for (size_t i = 0; i < total; i++) {
+        snprintf(cmd, sizeof(cmd), "command_%zu", i);
+        snprintf(dir, sizeof(dir), "/work/project%zu", i % 1000);
+        int exit_code = (i % 97 == 0) ? 1 : 0;
+        uint32_t duration = (i % 1009 == 0) ? 30000 : (uint32_t)(i % 500);
+        add_entry(core, cmd, dir, exit_code, duration, base + i);
+    }
+    size_t count = 0;
+    lle_history_get_entry_count(core, &count);
+    ASSERT_EQ(count, total, "All entries added");
+
+    struct {
+        const char *query;
+        size_t max;
+    } cases[] = {
+        {"exit:fail dir:/work/project7", 1000},
+        {"dur:>10s", 1000},
+        {"exit:fail dur:>10s", 1000},
+        {"since:1h", 100},
+        {"dir:/work/project999 command_1", 50},
+    };
+
+    size_t *pos = malloc(sizeof(size_t) * 1000);
+    ASSERT_NOT_NULL(pos, "Allocation should succeed");
+
+    /* First query also builds the index */
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ASSERT_TRUE(run_query(core, cases[0].query, pos, cases[0].max) >= 0,
+                "Index build query should succeed");
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    uint64_t build_us = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000 +
+                        (uint64_t)(end.tv_nsec - start.tv_nsec) / 1000;
+    printf("  Index build + first query: %" PRIu64 " μs\n", build_us);
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        lle_history_query_t q;
+        lle_history_query_parse(cases[c].query, &q, NULL, 0);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        size_t found = 0;
+        lle_history_query_run(core, &q, cases[c].max, pos, &found);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        uint64_t us = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000 +
+                      (uint64_t)(end.tv_nsec - start.tv_nsec) / 1000;
+
+        /* Compare with a brute-force scan */
+        size_t expected = 0;
+        for (size_t i = total; i > 0 && expected < cases[c].max; i--) {
+            lle_history_entry_t *entry = NULL;
+            lle_history_get_entry_by_index(core, i - 1, &entry);
+            if (lle_history_query_matches(&q, entry)) {
+                if (expected < found && pos[expected] != i - 1) {
+                    break;
+                }
+                expected++;
+            }
+        }
+
+        printf("  %-32s %5zu matches in %" PRIu64 " μs\n", cases[c].query,
+               found, us);
+        ASSERT_EQ(found, expected, "Indexed query matches a full scan");
+        ASSERT_TRUE(found > 0, "Query should find matches");
+        ASSERT_TRUE(us < LLE_HISTORY_SEARCH_TARGET_MS * 1000,
+                    "Query should meet the search target");
+    }
+
+    free(pos);
+    lle_history_core_destroy(core);
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * MAIN TEST RUNNER
+ * ============================================================================
+ */
+
+int main(void) {
+    printf("=======================================================\n");
+    printf("  LLE HISTORY STRUCTURED QUERY TESTS\n");
+    printf("=======================================================\n");
+
+    printf("\n--- PARSING ---\n");
+    test_parse_filters();
+    test_parse_times();
+    test_parse_errors_and_text();
+
+    printf("\n--- FILTERING ---\n");
+    test_directory_filters();
+    test_exit_and_duration_filters();
+    test_time_filters();
+    test_session_filter();
+    test_deleted_entries_excluded();
+
+    printf("\n--- INDEX MAINTENANCE ---\n");
+    test_record_result_updates_index();
+    test_search_query_results();
+    test_duration_persistence();
+
+    printf("\n--- PERFORMANCE TESTS ---\n");
+    test_query_performance_large_history();
+
+    printf("\n=======================================================\n");
+    printf("  TEST RESULTS\n");
+    printf("=======================================================\n");
+    printf("Total Tests:  %d\n", tests_run);
+    printf("Passed:       %d ✓\n", tests_passed);
+    printf("Failed:       %d ✗\n", tests_failed);
+    printf("Success Rate: %.1f%%\n",
+           tests_run > 0 ? (100.0 * tests_passed / tests_run) : 0.0);
+    printf("=======================================================\n");
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+/*
+ * Kill Action Test
+ *
+ * Tests the kill commands (lle_unix_word_rubout, lle_backward_kill_word,
+ * lle_kill_word) on a real editor, checking that successive kills merge
+ * into one kill ring entry and that C-y yanks the merged text back.
+ *
+ * Test Coverage:
+ * - Consecutive C-w kills yank back as one piece
+ * - Consecutive M-Backspace kills yank back as one piece
+ * - Consecutive M-d kills yank back as one piece
+ * - Moving the cursor between kills starts a new entry
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lle/buffer_management.h"
+#include "lle/keybinding_actions.h"
+#include "lle/lle_editor.h"
+#include "lush_memory_pool.h"
+
+/* External global_memory_pool (defined in lush_memory_pool.c) */
+extern lush_memory_pool_t *global_memory_pool;
+
+/* Test result tracking */
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_START(name)                                                       \
+    do {                                                                       \
+        tests_run++;                                                           \
+        printf("\n[TEST %d] %s\n", tests_run, name);                           \
+    } while (0)
+
+#define TEST_ASSERT(condition, message)                                        \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            printf("  ✗ FAILED: %s\n", message);                               \
+            printf("    at %s:%d\n", __FILE__, __LINE__);                      \
+            tests_failed++;                                                    \
+            return;                                                            \
+        }                                                                      \
+    } while (0)
+
+#define TEST_PASS()                                                            \
+    do {                                                                       \
+        printf("  ✓ PASSED\n");                                                \
+        tests_passed++;                                                        \
+    } while (0)
+
+/* Helper: Create editor with test content and the cursor at offset */
+static lle_editor_t *create_editor_with_content(const char *content,
+                                                size_t cursor,
+                                                lush_memory_pool_t *pool) {
+    lle_editor_t *editor = NULL;
+    lle_result_t result;
+
+    result = lle_editor_create(&editor, pool);
+    if (result != LLE_SUCCESS || !editor) {
+        return NULL;
+    }
+
+    if (content && *content) {
+        result =
+            lle_buffer_insert_text(editor->buffer, 0, content, strlen(content));
+        if (result != LLE_SUCCESS) {
+            lle_editor_destroy(editor);
+            return NULL;
+        }
+    }
+
+    lle_cursor_manager_move_to_byte_offset(editor->cursor_manager, cursor);
+
+    return editor;
+}
+
+/* Helper: Check the buffer holds exactly expected */
+static int buffer_equals(lle_editor_t *editor, const char *expected) {
+    size_t len = strlen(expected);
+    return editor->buffer->length == len &&
+           memcmp(editor->buffer->data, expected, len) == 0;
+}
+
+/* ============================================================================
+ * SUCCESSIVE KILL TESTS
+ * ============================================================================
+ */
+
+static void test_unix_word_rubout_chain(lush_memory_pool_t *pool) {
+    TEST_START("lle_unix_word_rubout: C-w C-w C-y");
+
+    const char *line = "echo aa bb cc";
+    lle_editor_t *editor = create_editor_with_content(line, strlen(line), pool);
+    TEST_ASSERT(editor != NULL, "Failed to create editor");
+
+    lle_unix_word_rubout(editor);
+    TEST_ASSERT(buffer_equals(editor, "echo aa bb "), "First C-w kills cc");
+    lle_unix_word_rubout(editor);
+    TEST_ASSERT(buffer_equals(editor, "echo aa "), "Second C-w kills bb");
+
+    lle_yank(editor);
+    TEST_ASSERT(buffer_equals(editor, "echo aa bb cc"),
+                "C-y yanks both words as one kill");
+
+    lle_editor_destroy(editor);
+    TEST_PASS();
+}
+
+static void test_backward_kill_word_chain(lush_memory_pool_t *pool) {
+    TEST_START("lle_backward_kill_word: M-DEL M-DEL C-y");
+
+    const char *line = "echo aa bb cc";
+    lle_editor_t *editor = create_editor_with_content(line, strlen(line), pool);
+    TEST_ASSERT(editor != NULL, "Failed to create editor");
+
+    lle_backward_kill_word(editor);
+    lle_backward_kill_word(editor);
+    TEST_ASSERT(buffer_equals(editor, "echo aa "), "Two words killed");
+
+    lle_yank(editor);
+    TEST_ASSERT(buffer_equals(editor, "echo aa bb cc"),
+                "C-y yanks both words as one kill");
+
+    lle_editor_destroy(editor);
+    TEST_PASS();
+}
+
+static void test_kill_word_chain(lush_memory_pool_t *pool) {
+    TEST_START("lle_kill_word: M-d M-d C-y");
+
+    lle_editor_t *editor = create_editor_with_content("echo aa bb cc", 4, pool);
+    TEST_ASSERT(editor != NULL, "Failed to create editor");
+
+    lle_kill_word(editor);
+    lle_kill_word(editor);
+    TEST_ASSERT(buffer_equals(editor, "echo cc"), "Two words killed");
+
+    lle_yank(editor);
+    TEST_ASSERT(buffer_equals(editor, "echo aa bb cc"),
+                "C-y yanks both words as one kill");
+
+    lle_editor_destroy(editor);
+    TEST_PASS();
+}
+
+static void test_cursor_motion_breaks_chain(lush_memory_pool_t *pool) {
+    TEST_START("lle_unix_word_rubout: C-w C-b C-w C-y");
+
+    const char *line = "echo aa bb cc";
+    lle_editor_t *editor = create_editor_with_content(line, strlen(line), pool);
+    TEST_ASSERT(editor != NULL, "Failed to create editor");
+
+    lle_unix_word_rubout(editor);
+    lle_backward_char(editor);
+    lle_unix_word_rubout(editor);
+    TEST_ASSERT(buffer_equals(editor, "echo aa  "), "bb killed after move");
+
+    lle_yank(editor);
+    TEST_ASSERT(buffer_equals(editor, "echo aa bb "),
+                "C-y yanks only the kill after the move");
+
+    lle_editor_destroy(editor);
+    TEST_PASS();
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("Kill Actions Test Suite\n");
+    printf("========================================\n");
+    printf("Testing: lle_unix_word_rubout, lle_backward_kill_word,\n");
+    printf("         lle_kill_word, lle_yank\n");
+    printf("========================================\n");
+
+    /* Initialize global memory pool with default configuration */
+    lush_pool_config_t config = lush_pool_get_default_config();
+
+    if (lush_pool_init(&config) != LUSH_POOL_SUCCESS) {
+        fprintf(stderr, "FATAL: Failed to initialize memory pool\n");
+        return 1;
+    }
+
+    /* Pass NULL as pool - lle_editor_create will use global_memory_pool */
+    lush_memory_pool_t *pool = NULL;
+
+    test_unix_word_rubout_chain(pool);
+    test_backward_kill_word_chain(pool);
+    test_kill_word_chain(pool);
+    test_cursor_motion_breaks_chain(pool);
+
+    /* Print results */
+    printf("\n========================================\n");
+    printf("TEST RESULTS\n");
+    printf("========================================\n");
+    printf("Total:  %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+    printf("========================================\n");
+
+    if (tests_failed == 0) {
+        printf("✓ ALL TESTS PASSED\n");
+        return 0;
+    } else {
+        printf("✗ SOME TESTS FAILED\n");
+        return 1;
+    }
+}
@@ -0,0 +1,318 @@
+/**
+ * test_change_tracker.c - Unit tests for undo/redo change tracking
+ *
+ * Tests coalescing of edit runs into single undo units, the chunked delta
+ * log and the byte-based history budget.
+ *
+ * Date: 2026-10-18
+ */
+
+#include "lle/buffer_management.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern lush_memory_pool_t *global_memory_pool;
+
+/* Test framework macros */
+#define TEST(name) static void test_##name(void)
+#define RUN_TEST(name)                                                         \
+    do {                                                                       \
+        printf("  Running: %s...\n", #name);                                   \
+        setup();                                                               \
+        test_##name();                                                         \
+        teardown();                                                            \
+        printf("    ✓ PASSED\n");                                              \
+    } while (0)
+
+#define ASSERT(condition, message)                                             \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            printf("    ✗ FAILED: %s\n", message);                             \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_EQ(actual, expected, message)                                   \
+    do {                                                                       \
+        if ((actual) != (expected)) {                                          \
+            printf("    ✗ FAILED: %s\n", message);                             \
+            printf("      Expected: %zu, Got: %zu\n", (size_t)(expected),      \
+                   (size_t)(actual));                                          \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_STR_EQ(actual, expected, message)                               \
+    do {                                                                       \
+        if (strcmp((actual), (expected)) != 0) {                               \
+            printf("    ✗ FAILED: %s\n", message);                             \
+            printf("      Expected: \"%s\", Got: \"%s\"\n", (expected),        \
+                   (actual));                                                  \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+static lle_buffer_t *buffer;
+static lle_change_tracker_t *tracker;
+
+static void setup(void) {
+    ASSERT(lle_buffer_create(&buffer, global_memory_pool, 0) == LLE_SUCCESS,
+           "Buffer creation failed");
+    ASSERT(lle_change_tracker_init(&tracker, global_memory_pool, 0) ==
+               LLE_SUCCESS,
+           "Tracker init failed");
+    buffer->change_tracking_enabled = true;
+}
+
+static void teardown(void) {
+    lle_change_tracker_destroy(tracker);
+    lle_buffer_destroy(buffer);
+    tracker = NULL;
+    buffer = NULL;
+}
+
+/* Helpers performing one edit as its own sequence, the way readline does */
+static void begin(const char *description) {
+    lle_change_sequence_t *seq = NULL;
+    ASSERT(lle_change_tracker_begin_sequence(tracker, description, &seq) ==
+               LLE_SUCCESS,
+           "Begin sequence failed");
+    buffer->current_sequence = seq;
+}
+
+static void end(void) {
+    ASSERT(lle_change_tracker_complete_sequence(tracker) == LLE_SUCCESS,
+           "Complete sequence failed");
+    buffer->current_sequence = NULL;
+}
+
+static void type_text(const char *text) {
+    for (const char *p = text; *p; p++) {
+        begin("insert char");
+        ASSERT(lle_buffer_insert_text(buffer, buffer->length, p, 1) ==
+                   LLE_SUCCESS,
+               "Insert failed");
+        end();
+    }
+}
+
+static void insert_at(const char *description, size_t position,
+                      const char *text) {
+    begin(description);
+    ASSERT(lle_buffer_insert_text(buffer, position, text, strlen(text)) ==
+               LLE_SUCCESS,
+           "Insert failed");
+    end();
+}
+
+static void delete_at(const char *description, size_t position,
+                      size_t length) {
+    begin(description);
+    ASSERT(lle_buffer_delete_text(buffer, position, length) == LLE_SUCCESS,
+           "Delete failed");
+    end();
+}
+
+/* ============================================================================
+ * COALESCING TESTS
+ * ============================================================================
+ */
+
+TEST(typing_run_is_one_undo) {
+    type_text("echo hello");
+    ASSERT_STR_EQ(buffer->data, "echo hello", "Typed text");
+    ASSERT_EQ(lle_change_tracker_undo_depth(tracker), 1,
+              "Run coalesced into one unit");
+    ASSERT_EQ(tracker->coalesced_count, 9, "Nine keystrokes merged");
+
+    ASSERT(lle_change_tracker_undo(tracker, buffer) == LLE_SUCCESS,
+           "Undo failed");
+    ASSERT_EQ(buffer->length, 0, "Whole run undone");
+    ASSERT(!lle_change_tracker_can_undo(tracker), "Nothing left to undo");
+}
+
+TEST(backspace_run_is_one_undo) {
+    insert_at("paste", 0, "abcdef");
+    for (int i = 0; i < 3; i++) {
+        delete_at("backspace", buffer->length - 1, 1);
+    }
+    ASSERT_STR_EQ(buffer->data, "abc", "After backspaces");
+    ASSERT_EQ(lle_change_tracker_undo_depth(tracker), 2,
+              "Paste plus one backspace unit");
+
+    ASSERT(lle_change_tracker_undo(tracker, buffer) == LLE_SUCCESS,
+           "Undo failed");
+    ASSERT_STR_EQ(buffer->data, "abcdef", "Backspace run restored in order");
+}
+
+TEST(forward_delete_run_is_one_undo) {
+    insert_at("paste", 0, "abcdef");
+    for (int i = 0; i < 3; i++) {
+        delete_at("delete", 1, 1);
+    }
+    ASSERT_STR_EQ(buffer->data, "aef", "After deletes");
+    ASSERT_EQ(lle_change_tracker_undo_depth(tracker), 2,
+              "Paste plus one delete unit");
+
+    ASSERT(lle_change_tracker_undo(tracker, buffer) == LLE_SUCCESS,
+           "Undo failed");
+    ASSERT_STR_EQ(buffer->data, "abcdef", "Delete run restored in order");
+}
+
+TEST(non_contiguous_edits_stay_separate) {
+    type_text("ab");
+    insert_at("insert char", 0, "x");
+    ASSERT_STR_EQ(buffer->data, "xab", "Edited text");
+    ASSERT_EQ(lle_change_tracker_undo_depth(tracker), 2,
+              "Jumped insert starts a new unit");
+
+    insert_at("yank", 3, "cd");
+    ASSERT_EQ(lle_change_tracker_undo_depth(tracker), 3,
+              "Different command starts a new unit");
+}
+
+TEST(coalescing_can_be_disabled) {
+    lle_change_tracker_set_coalescing(tracker, false);
+    type_text("abc");
+    ASSERT_EQ(lle_change_tracker_undo_depth(tracker), 3,
+              "Every keystroke is its own unit");
+}
+
+TEST(undo_breaks_run) {
+    type_text("abc");
+    ASSERT(lle_change_tracker_undo(tracker, buffer) == LLE_SUCCESS,
+           "Undo failed");
+    ASSERT(lle_change_tracker_redo(tracker, buffer) == LLE_SUCCESS,
+           "Redo failed");
+    type_text("d");
+    ASSERT_STR_EQ(buffer->data, "abcd", "Text after redo and typing");
+    ASSERT_EQ(lle_change_tracker_undo_depth(tracker), 2,
+              "Typing after redo starts a new unit");
+
+    ASSERT(lle_change_tracker_undo(tracker, buffer) == LLE_SUCCESS,
+           "Undo failed");
+    ASSERT_STR_EQ(buffer->data, "abc", "Only the new run undone");
+}
+
+/* ============================================================================
+ * UNDO/REDO TESTS
+ * ============================================================================
+ */
+
+TEST(redo_restores_run) {
+    type_text("hello");
+    ASSERT(lle_change_tracker_undo(tracker, buffer) == LLE_SUCCESS,
+           "Undo failed");
+    ASSERT_EQ(lle_change_tracker_redo_depth(tracker), 1, "One redo unit");
+    ASSERT(lle_change_tracker_redo(tracker, buffer) == LLE_SUCCESS,
+           "Redo failed");
+    ASSERT_STR_EQ(buffer->data, "hello", "Run redone");
+    ASSERT_EQ(buffer->cursor.byte_offset, 5, "Cursor after run");
+}
+
+TEST(edit_after_full_undo_drops_redo) {
+    type_text("abc");
+    ASSERT(lle_change_tracker_undo(tracker, buffer) == LLE_SUCCESS,
+           "Undo failed");
+    type_text("x");
+    ASSERT(!lle_change_tracker_can_redo(tracker), "Redo history dropped");
+    ASSERT_EQ(tracker->sequence_count, 1, "Only the new unit remains");
+    ASSERT(lle_change_tracker_undo(tracker, buffer) == LLE_SUCCESS,
+           "Undo failed");
+    ASSERT_EQ(buffer->length, 0, "Back to empty");
+}
+
+/* ============================================================================
+ * MEMORY TESTS
+ * ============================================================================
+ */
+
+TEST(long_run_uses_log_not_allocations) {
+    size_t baseline = lle_change_tracker_memory_usage(tracker);
+    for (int i = 0; i < 2000; i++) {
+        type_text("x");
+    }
+    ASSERT_EQ(lle_change_tracker_undo_depth(tracker), 1, "Single unit");
+
+    /* One sequence, one operation and the log chunks holding the text */
+    size_t used = lle_change_tracker_memory_usage(tracker) - baseline;
+    ASSERT(used < 2 * LLE_BUFFER_CHANGE_LOG_CHUNK + 1024,
+           "Run stored compactly");
+
+    ASSERT(lle_change_tracker_undo(tracker, buffer) == LLE_SUCCESS,
+           "Undo failed");
+    ASSERT_EQ(buffer->length, 0, "Run undone");
+}
+
+TEST(budget_drops_oldest_history) {
+    char text[401];
+    memset(text, 'a', 400);
+    text[400] = '\0';
+
+    ASSERT(lle_change_tracker_set_memory_budget(tracker, 16384) ==
+               LLE_SUCCESS,
+           "Set budget failed");
+    for (int i = 0; i < 100; i++) {
+        insert_at(i % 2 ? "yank" : "paste", buffer->length, text);
+    }
+    ASSERT_EQ(buffer->length, 100 * 400, "All text inserted");
+
+    size_t depth = lle_change_tracker_undo_depth(tracker);
+    ASSERT(depth < 100, "Oldest history dropped");
+    ASSERT(depth > 10, "Recent history kept");
+    ASSERT(tracker->compacted_count > 0, "Compaction counted");
+    ASSERT(lle_change_tracker_memory_usage(tracker) <= 16384,
+           "Usage within budget");
+
+    /* Undoing everything left restores the text of the dropped edits */
+    while (lle_change_tracker_can_undo(tracker)) {
+        ASSERT(lle_change_tracker_undo(tracker, buffer) == LLE_SUCCESS,
+               "Undo failed");
+    }
+    ASSERT_EQ(buffer->length, (100 - depth) * 400, "Dropped edits remain");
+}
+
+TEST(clear_releases_history) {
+    size_t baseline = lle_change_tracker_memory_usage(tracker);
+    type_text("some command");
+    insert_at("yank", 0, "prefix ");
+    ASSERT(lle_change_tracker_memory_usage(tracker) > baseline,
+           "History uses memory");
+
+    ASSERT(lle_change_tracker_clear(tracker) == LLE_SUCCESS, "Clear failed");
+    ASSERT_EQ(lle_change_tracker_memory_usage(tracker), baseline,
+              "Usage back to baseline");
+    ASSERT(!lle_change_tracker_can_undo(tracker), "No undo after clear");
+
+    type_text("again");
+    ASSERT_EQ(lle_change_tracker_undo_depth(tracker), 1,
+              "Tracker usable after clear");
+}
+
+int main(void) {
+    printf("\n=== Change Tracker Unit Tests ===\n\n");
+
+    printf("Coalescing Tests:\n");
+    RUN_TEST(typing_run_is_one_undo);
+    RUN_TEST(backspace_run_is_one_undo);
+    RUN_TEST(forward_delete_run_is_one_undo);
+    RUN_TEST(non_contiguous_edits_stay_separate);
+    RUN_TEST(coalescing_can_be_disabled);
+    RUN_TEST(undo_breaks_run);
+
+    printf("\nUndo/Redo Tests:\n");
+    RUN_TEST(redo_restores_run);
+    RUN_TEST(edit_after_full_undo_drops_redo);
+
+    printf("\nMemory Tests:\n");
+    RUN_TEST(long_run_uses_log_not_allocations);
+    RUN_TEST(budget_drops_oldest_history);
+    RUN_TEST(clear_releases_history);
+
+    printf("\n=== All Change Tracker Tests Passed ===\n\n");
+    return 0;
+}
@@ -664,6 +664,133 @@ TEST(large_text_handling) {
     lle_kill_ring_destroy(ring);
 }
 
+/* ============================================================================
+ * STORAGE AND BYTE BUDGET TESTS
+ * ============================================================================
+ */
+
+TEST(text_variants_use_length) {
+    lle_kill_ring_t *ring = NULL;
+    lle_result_t result;
+
+    result = lle_kill_ring_create(&ring, 0, NULL);
+    ASSERT(result == LLE_SUCCESS, "Create failed");
+
+    /* Ranges of a larger string, as copied from an edit buffer */
+    const char *line = "echo hello world";
+    result = lle_kill_ring_add_text(ring, line + 5, 6, false);
+    ASSERT(result == LLE_SUCCESS, "Add text range failed");
+    result = lle_kill_ring_add_text(ring, line + 11, 5, true);
+    ASSERT(result == LLE_SUCCESS, "Append text range failed");
+    result = lle_kill_ring_prepend_text(ring, line, 5);
+    ASSERT(result == LLE_SUCCESS, "Prepend text range failed");
+
+    const char *text;
+    size_t length = 0;
+    result = lle_kill_ring_get_current_text(ring, &text, &length);
+    ASSERT(result == LLE_SUCCESS, "Get current text failed");
+    ASSERT_EQ(length, strlen(line), "Length incorrect");
+    ASSERT_STR_EQ(text, line, "Merged text incorrect");
+
+    result = lle_kill_ring_add_text(ring, line, 0, false);
+    ASSERT(result == LLE_ERROR_INVALID_PARAMETER, "Zero length not rejected");
+
+    lle_kill_ring_destroy(ring);
+}
+
+TEST(long_successive_kill_run) {
+    lle_kill_ring_t *ring = NULL;
+    lle_result_t result;
+
+    result = lle_kill_ring_create(&ring, 0, NULL);
+    ASSERT(result == LLE_SUCCESS, "Create failed");
+
+    /* Kill a long line word by word in both directions */
+    const int words = 5000;
+    result = lle_kill_ring_add(ring, "|", false);
+    ASSERT(result == LLE_SUCCESS, "Initial add failed");
+    for (int i = 0; i < words; i++) {
+        result = lle_kill_ring_add_text(ring, "ab ", 3, true);
+        ASSERT(result == LLE_SUCCESS, "Append failed");
+        result = lle_kill_ring_prepend_text(ring, "cd ", 3);
+        ASSERT(result == LLE_SUCCESS, "Prepend failed");
+    }
+
+    const char *text;
+    size_t length = 0;
+    result = lle_kill_ring_get_current_text(ring, &text, &length);
+    ASSERT(result == LLE_SUCCESS, "Get current text failed");
+    ASSERT_EQ(length, (size_t)words * 6 + 1, "Merged length incorrect");
+    ASSERT_EQ(strlen(text), length, "Text not terminated at its length");
+    ASSERT(strncmp(text, "cd cd ", 6) == 0, "Prepended text incorrect");
+    ASSERT(text[words * 3] == '|', "Original text not in the middle");
+    ASSERT(strcmp(text + length - 6, "ab ab ") == 0,
+           "Appended text incorrect");
+
+    /* Geometric growth keeps the storage within a small factor of the text */
+    size_t bytes = 0;
+    result = lle_kill_ring_get_memory_usage(ring, &bytes);
+    ASSERT(result == LLE_SUCCESS, "Get memory usage failed");
+    ASSERT(bytes >= length + 1 && bytes <= 4 * (length + 1),
+           "Storage not proportional to text");
+
+    lle_kill_ring_destroy(ring);
+}
+
+TEST(byte_budget_drops_oldest) {
+    lle_kill_ring_t *ring = NULL;
+    lle_result_t result;
+
+    result = lle_kill_ring_create(&ring, 0, NULL);
+    ASSERT(result == LLE_SUCCESS, "Create failed");
+
+    char big[1000];
+    memset(big, 'x', sizeof(big));
+
+    result = lle_kill_ring_set_byte_budget(ring, 3000);
+    ASSERT(result == LLE_SUCCESS, "Set byte budget failed");
+    for (int i = 0; i < 5; i++) {
+        big[0] = (char)('a' + i);
+        result = lle_kill_ring_add_text(ring, big, sizeof(big), false);
+        ASSERT(result == LLE_SUCCESS, "Add failed");
+    }
+
+    size_t count, bytes;
+    lle_kill_ring_get_count(ring, &count);
+    lle_kill_ring_get_memory_usage(ring, &bytes);
+    ASSERT(count < 5, "Oldest entries not dropped");
+    ASSERT(bytes <= 3000, "Storage over budget");
+
+    /* Yank-pop only reaches surviving entries */
+    const char *text;
+    lle_kill_ring_get_current(ring, &text);
+    ASSERT(text[0] == 'e', "Newest entry lost");
+    for (size_t i = 1; i < count; i++) {
+        lle_kill_ring_yank_pop(ring, &text);
+        ASSERT(text[0] == (char)('e' - i), "Yank-pop order incorrect");
+    }
+    lle_kill_ring_yank_pop(ring, &text);
+    ASSERT(text[0] == 'e', "Yank-pop did not wrap to newest");
+
+    /* The newest entry is kept even if it alone exceeds the budget */
+    result = lle_kill_ring_set_byte_budget(ring, 10);
+    ASSERT(result == LLE_SUCCESS, "Shrink byte budget failed");
+    lle_kill_ring_get_count(ring, &count);
+    ASSERT_EQ(count, 1, "Newest entry not kept");
+    lle_kill_ring_get_current(ring, &text);
+    ASSERT(text[0] == 'e', "Wrong entry kept");
+
+    ASSERT(lle_kill_ring_set_byte_budget(ring, 0) ==
+               LLE_ERROR_INVALID_PARAMETER,
+           "Zero budget not rejected");
+
+    lle_kill_ring_clear(ring);
+    lle_kill_ring_get_memory_usage(ring, &bytes);
+    ASSERT_EQ(bytes, 0, "Clear did not release storage");
+
+    lle_kill_ring_destroy(ring);
+}
+
 /* ============================================================================
  * CONCURRENCY TESTS
  * ============================================================================
@@ -764,6 +891,11 @@ int main(void) {
     RUN_TEST(empty_string_rejected);
     RUN_TEST(large_text_handling);
 
+    printf("\nStorage and Byte Budget Tests:\n");
+    RUN_TEST(text_variants_use_length);
+    RUN_TEST(long_successive_kill_run);
+    RUN_TEST(byte_budget_drops_oldest);
+
     printf("\nConcurrency Tests:\n");
     RUN_TEST(concurrent_adds);
 
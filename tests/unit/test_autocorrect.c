@@ -16,6 +16,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "autocorrect.h"
 #include "executor.h"
@@ -322,6 +324,209 @@ TEST(suggest_builtins_no_match) {
     autocorrect_cleanup();
 }
 
+/* Count how often a name appears among a set of suggestions, freeing them */
+static int take_suggestion(correction_t *suggestions, int count,
+                           const char *name, const char **source) {
+    int found = 0;
+    for (int i = 0; i < count; i++) {
+        if (strcmp(suggestions[i].command, name) == 0) {
+            found++;
+            if (source) {
+                *source = suggestions[i].source;
+            }
+        }
+        free(suggestions[i].command);
+    }
+    return found;
+}
+
+/* Create an executable script in dir */
+static void make_executable(const char *dir, const char *name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE *f = fopen(path, "w");
+    ASSERT_NOT_NULL(f, "Should create test executable");
+    fputs("#!/bin/sh\n", f);
+    fclose(f);
+    chmod(path, 0755);
+}
+
+TEST(suggest_path_picks_up_new_executables) {
+    char dir[] = "/tmp/lush_autocorrect_XXXXXX";
+    ASSERT_NOT_NULL(mkdtemp(dir), "Should create temp dir");
+    char *saved_path = getenv("PATH") ? strdup(getenv("PATH")) : NULL;
+    setenv("PATH", dir, 1);
+    autocorrect_init();
+
+    make_executable(dir, "frobnicate");
+    correction_t suggestions[5];
+    int count = autocorrect_suggest_path_commands("frobnicat", suggestions, 5,
+                                                  false);
+    ASSERT_EQ(take_suggestion(suggestions, count, "frobnicate", NULL), 1,
+              "Should suggest executable from PATH");
+
+    size_t scans_before = 0;
+    autocorrect_index_stats(NULL, NULL, &scans_before);
+
+    /* Added in the same second: the directory must be rescanned */
+    make_executable(dir, "quuxinator");
+    count = autocorrect_suggest_path_commands("quuxinatr", suggestions, 5,
+                                              false);
+    ASSERT_EQ(take_suggestion(suggestions, count, "quuxinator", NULL), 1,
+              "Should find executable added after the first scan");
+
+    /* Removed executables are no longer suggested */
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frobnicate", dir);
+    unlink(path);
+    count = autocorrect_suggest_path_commands("frobnicat", suggestions, 5,
+                                              false);
+    ASSERT_EQ(take_suggestion(suggestions, count, "frobnicate", NULL), 0,
+              "Should not suggest removed executable");
+
+    /* Non-executable files are indexed but never suggested */
+    snprintf(path, sizeof(path), "%s/plainfile", dir);
+    FILE *f = fopen(path, "w");
+    ASSERT_NOT_NULL(f, "Should create plain file");
+    fclose(f);
+    count = autocorrect_suggest_path_commands("plainfil", suggestions, 5,
+                                              false);
+    ASSERT_EQ(take_suggestion(suggestions, count, "plainfile", NULL), 0,
+              "Should not suggest non-executable file");
+    ASSERT_FALSE(autocorrect_command_exists(NULL, "plainfile"),
+                 "Non-executable file should not exist as a command");
+    ASSERT_TRUE(autocorrect_command_exists(NULL, "quuxinator"),
+                "Indexed executable should exist");
+
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/quuxinator", dir);
+    unlink(path);
+    rmdir(dir);
+    if (saved_path) {
+        setenv("PATH", saved_path, 1);
+        free(saved_path);
+    }
+    autocorrect_cleanup();
+}
+
+TEST(suggest_path_follows_path_changes) {
+    char dir1[] = "/tmp/lush_autocorrect_XXXXXX";
+    char dir2[] = "/tmp/lush_autocorrect_XXXXXX";
+    ASSERT_NOT_NULL(mkdtemp(dir1), "Should create first temp dir");
+    ASSERT_NOT_NULL(mkdtemp(dir2), "Should create second temp dir");
+    make_executable(dir1, "alphatool");
+    make_executable(dir2, "betatool");
+    char *saved_path = getenv("PATH") ? strdup(getenv("PATH")) : NULL;
+    autocorrect_init();
+
+    correction_t suggestions[5];
+    setenv("PATH", dir1, 1);
+    int count = autocorrect_suggest_path_commands("betatol", suggestions, 5,
+                                                  false);
+    ASSERT_EQ(take_suggestion(suggestions, count, "betatool", NULL), 0,
+              "Should not suggest from directory outside PATH");
+
+    char both[128];
+    snprintf(both, sizeof(both), "%s:%s", dir1, dir2);
+    setenv("PATH", both, 1);
+    count = autocorrect_suggest_path_commands("betatol", suggestions, 5, false);
+    ASSERT_EQ(take_suggestion(suggestions, count, "betatool", NULL), 1,
+              "Should suggest from directory added to PATH");
+
+    size_t dirs = 0;
+    autocorrect_index_stats(NULL, &dirs, NULL);
+    ASSERT_EQ(dirs, 2, "Should track both PATH directories");
+
+    setenv("PATH", dir2, 1);
+    count = autocorrect_suggest_path_commands("alphatol", suggestions, 5,
+                                              false);
+    ASSERT_EQ(take_suggestion(suggestions, count, "alphatool", NULL), 0,
+              "Should drop directory removed from PATH");
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/alphatool", dir1);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/betatool", dir2);
+    unlink(path);
+    rmdir(dir1);
+    rmdir(dir2);
+    if (saved_path) {
+        setenv("PATH", saved_path, 1);
+        free(saved_path);
+    }
+    autocorrect_cleanup();
+}
+
+TEST(suggest_functions_and_aliases) {
+    init_symtable();
+    init_aliases();
+    autocorrect_init();
+
+    executor_t *exec = executor_new();
+    ASSERT_NOT_NULL(exec, "Executor should be created");
+    ASSERT_EQ(executor_execute_command_line(exec, "deploy_site() { :; }"), 0,
+              "Function definition should succeed");
+    set_alias("gitstat", "git status");
+
+    correction_results_t results;
+    autocorrect_find_suggestions(exec, "deploy_sit", &results);
+    bool found = false;
+    for (int i = 0; i < results.count; i++) {
+        if (strcmp(results.suggestions[i].command, "deploy_site") == 0) {
+            ASSERT(strcmp(results.suggestions[i].source, "function") == 0,
+                   "Function suggestion should be labelled 'function'");
+            found = true;
+        }
+    }
+    autocorrect_free_results(&results);
+    ASSERT_TRUE(found, "Should suggest defined function");
+
+    autocorrect_find_suggestions(exec, "gitsta", &results);
+    found = false;
+    for (int i = 0; i < results.count; i++) {
+        if (strcmp(results.suggestions[i].command, "gitstat") == 0) {
+            found = true;
+        }
+    }
+    autocorrect_free_results(&results);
+    ASSERT_TRUE(found, "Should suggest defined alias");
+
+    /* Removed aliases are filtered out even though they stay indexed */
+    unset_alias("gitstat");
+    autocorrect_find_suggestions(exec, "gitsta", &results);
+    for (int i = 0; i < results.count; i++) {
+        ASSERT(strcmp(results.suggestions[i].command, "gitstat") != 0,
+               "Removed alias should not be suggested");
+    }
+    autocorrect_free_results(&results);
+
+    executor_free(exec);
+    autocorrect_cleanup();
+}
+
+TEST(suggest_from_history_learned) {
+    autocorrect_init();
+    autocorrect_learn_command("kubectl-foo");
+
+    correction_t suggestions[5];
+    const char *source = NULL;
+    int count = autocorrect_suggest_from_history("kubectl-fo", suggestions, 5,
+                                                 false);
+    ASSERT_EQ(take_suggestion(suggestions, count, "kubectl-foo", &source), 1,
+              "Should suggest learned command");
+    ASSERT(source && strcmp(source, "history") == 0,
+           "Learned suggestion should be labelled 'history'");
+
+    /* Re-initializing forgets learned commands */
+    autocorrect_init();
+    count = autocorrect_suggest_from_history("kubectl-fo", suggestions, 5,
+                                             false);
+    ASSERT_EQ(take_suggestion(suggestions, count, "kubectl-foo", NULL), 0,
+              "Learned commands should be forgotten on init");
+
+    autocorrect_cleanup();
+}
+
 /* ============================================================================
  * RESULT MANAGEMENT TESTS
  * ============================================================================
@@ -537,6 +742,10 @@ int main(void) {
     printf("\nSuggestion Tests:\n");
     RUN_TEST(suggest_builtins_basic);
     RUN_TEST(suggest_builtins_no_match);
+    RUN_TEST(suggest_path_picks_up_new_executables);
+    RUN_TEST(suggest_path_follows_path_changes);
+    RUN_TEST(suggest_functions_and_aliases);
+    RUN_TEST(suggest_from_history_learned);
 
     /* Result management tests */
     printf("\nResult Management Tests:\n");
@@ -0,0 +1,148 @@
+/**
+ * @file test_cache_file.c
+ * @brief Unit tests for the shared cache file helpers
+ *
+ * Tests the cache file helpers including:
+ * - Cache directory lookup from XDG_CACHE_HOME and HOME
+ * - Private (0700) directory creation
+ * - Atomic replacement with private (0600) files
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "cache_file.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Test framework macros */
+#define TEST(name) static void test_##name(void)
+#define RUN_TEST(name)                                                         \
+    do {                                                                       \
+        printf("  Running: %s...\n", #name);                                   \
+        test_##name();                                                         \
+        printf("    PASSED\n");                                                \
+    } while (0)
+
+#define ASSERT(condition, message)                                             \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+static char scratch[] = "/tmp/lush_cache_file_XXXXXX";
+
+/**
+ * @brief Count the entries of a directory, not counting . and ..
+ */
+static int entry_count(const char *dir) {
+    DIR *d = opendir(dir);
+    ASSERT(d != NULL, "directory opened");
+    int count = 0;
+    struct dirent *ent;
+    while ((ent = readdir(d)) != NULL) {
+        if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+            count++;
+        }
+    }
+    closedir(d);
+    return count;
+}
+
+/**
+ * @brief Read a whole small file into buf
+ */
+static void read_file(const char *path, char *buf, size_t size) {
+    FILE *fp = fopen(path, "r");
+    ASSERT(fp != NULL, "file opened");
+    size_t n = fread(buf, 1, size - 1, fp);
+    buf[n] = '\0';
+    fclose(fp);
+}
+
+TEST(path_prefers_xdg_cache_home) {
+    char buf[256];
+    setenv("XDG_CACHE_HOME", "/xdg", 1);
+    setenv("HOME", "/home/u", 1);
+    ASSERT(cache_file_path("lush/x", buf, sizeof(buf)), "path resolved");
+    ASSERT(strcmp(buf, "/xdg/lush/x") == 0, "XDG_CACHE_HOME used");
+
+    setenv("XDG_CACHE_HOME", "", 1);
+    ASSERT(cache_file_path("lush/x", buf, sizeof(buf)), "path resolved");
+    ASSERT(strcmp(buf, "/home/u/.cache/lush/x") == 0, "~/.cache used");
+
+    unsetenv("XDG_CACHE_HOME");
+    unsetenv("HOME");
+    ASSERT(!cache_file_path("lush/x", buf, sizeof(buf)),
+           "no cache directory without HOME");
+
+    setenv("HOME", "/home/u", 1);
+    ASSERT(!cache_file_path("lush/x", buf, 8), "truncated path rejected");
+}
+
+TEST(directories_are_private) {
+    char dir[256];
+    snprintf(dir, sizeof(dir), "%s/a/b/c", scratch);
+    ASSERT(cache_file_make_dirs(dir), "directories created");
+
+    struct stat st;
+    snprintf(dir, sizeof(dir), "%s/a", scratch);
+    ASSERT(stat(dir, &st) == 0 && S_ISDIR(st.st_mode), "parent created");
+    ASSERT((st.st_mode & 077) == 0, "parent is private");
+    snprintf(dir, sizeof(dir), "%s/a/b/c", scratch);
+    ASSERT(stat(dir, &st) == 0 && (st.st_mode & 077) == 0,
+           "leaf is private");
+    ASSERT(cache_file_make_dirs(dir), "existing directories accepted");
+}
+
+TEST(write_replaces_file_atomically) {
+    char dir[256];
+    char path[320];
+    snprintf(dir, sizeof(dir), "%s/w/x", scratch);
+    snprintf(path, sizeof(path), "%s/entry", dir);
+
+    const cache_file_part_t first[] = {{"head ", 5}, {"body", 4}};
+    ASSERT(cache_file_write(path, first, 2), "first write");
+    char buf[64];
+    read_file(path, buf, sizeof(buf));
+    ASSERT(strcmp(buf, "head body") == 0, "parts written in order");
+
+    struct stat st;
+    ASSERT(stat(path, &st) == 0 && (st.st_mode & 077) == 0,
+           "file is private");
+    ASSERT(stat(dir, &st) == 0 && (st.st_mode & 077) == 0,
+           "missing parents created private");
+
+    const cache_file_part_t second = {"new", 3};
+    ASSERT(cache_file_write(path, &second, 1), "second write");
+    read_file(path, buf, sizeof(buf));
+    ASSERT(strcmp(buf, "new") == 0, "file replaced");
+    ASSERT(entry_count(dir) == 1, "no temporary file left behind");
+}
+
+int main(void) {
+    printf("\n=== Cache File Tests ===\n\n");
+    umask(022);
+    ASSERT(mkdtemp(scratch) != NULL, "scratch directory created");
+
+    RUN_TEST(path_prefers_xdg_cache_home);
+    RUN_TEST(directories_are_private);
+    RUN_TEST(write_replaces_file_atomically);
+
+    char cmd[128];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", scratch);
+    if (system(cmd) != 0) {
+        printf("warning: could not remove %s\n", scratch);
+    }
+
+    printf("\n=== All %d Cache File Tests Passed ===\n\n", 3);
+    return 0;
+}
@@ -7,6 +7,7 @@
  * - Entry queries
  * - Portability checking
  * - Strict mode
+ * - Cached binary image and its indexes
  * - Utility functions
  *
  * @author Michael Berry <trismegustis@gmail.com>
@@ -16,9 +17,12 @@
 #include "compat.h"
 #include "shell_mode.h"
 #include <assert.h>
+#include <regex.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /* Test framework macros */
 #define TEST(name) static void test_##name(void)
@@ -391,6 +395,281 @@ TEST(compat_foreach_entry) {
     compat_cleanup();
 }
 
+/* ============================================================================
+ * COMPILED RULE SET TESTS
+ * ============================================================================ */
+
+/** @brief Lines exercising a spread of lint patterns */
+static const char *match_corpus[] = {
+    "echo -e 'hello\\n'",
+    "if [[ $a == b && -n $c ]]; then",
+    "[[ $x =~ ^[0-9]+$ ]]",
+    "for ((i = 0; i < 10; i++)); do",
+    "function greet() {",
+    "greet() { local name=$1; return 0; }",
+    "declare -n ref=target",
+    "cat <<< \"$input\" 2>&1 | grep x",
+    "diff <(sort a) <(sort b) &> /dev/null",
+    "exec 3<> /dev/tcp/host/80",
+    "arr=(one two three); echo ${arr[@]} ${#arr[@]}",
+    "echo ${var:0:3} ${var//a/b} ${var^^}",
+    "source ./lib.sh; . ./other.sh",
+    "printf '%s\\n' $'tab\\there' \"$HOME\"",
+    "select opt in a b c; do break; done",
+    "coproc worker { cat; }",
+    "let x=1+2; (( y++ ))",
+    "case $x in a) echo a ;& b) echo b ;;& esac",
+    "time sleep 1",
+    "echo `date` $(date) >> log 2>> err",
+    "",
+    "#!/bin/sh",
+};
+
+static const char *brute_ids[4096];
+static size_t brute_count;
+static const char *fast_ids[4096];
+static size_t fast_count;
+static const char *current_line;
+
+static void brute_force_callback(const compat_entry_t *entry,
+                                 void *user_data) {
+    (void)user_data;
+    regex_t regex;
+    if (!entry->lint.pattern || !entry->lint.pattern[0] ||
+        regcomp(&regex, entry->lint.pattern, REG_EXTENDED) != 0) {
+        return;
+    }
+    if (regexec(&regex, current_line, 0, NULL, 0) == 0) {
+        brute_ids[brute_count++] = entry->id;
+    }
+    regfree(&regex);
+}
+
+static void fast_callback(const compat_entry_t *entry, size_t match_start,
+                          size_t match_length, void *user_data) {
+    (void)user_data;
+    ASSERT(match_start + match_length <= strlen(current_line),
+           "Match range should lie within the line");
+    fast_ids[fast_count++] = entry->id;
+}
+
+TEST(compat_foreach_match_equals_brute_force) {
+    compat_init(NULL);
+
+    size_t corpus_len = sizeof(match_corpus) / sizeof(match_corpus[0]);
+    for (size_t n = 0; n < corpus_len; n++) {
+        current_line = match_corpus[n];
+
+        brute_count = 0;
+        compat_foreach_entry(brute_force_callback, NULL);
+
+        fast_count = 0;
+        size_t matched =
+            compat_foreach_match(current_line, fast_callback, NULL);
+        ASSERT_EQ(matched, fast_count, "Return value should count callbacks");
+        ASSERT_EQ(fast_count, brute_count,
+                  "Prefiltered matches should equal brute force");
+        for (size_t i = 0; i < brute_count; i++) {
+            ASSERT(fast_ids[i] == brute_ids[i],
+                   "Matches should be visited in database order");
+        }
+    }
+
+    compat_cleanup();
+}
+
+TEST(compat_foreach_match_survives_reload) {
+    compat_init(NULL);
+
+    current_line = "[[ $x == y ]]";
+    fast_count = 0;
+    size_t before = compat_foreach_match(current_line, fast_callback, NULL);
+    compat_reload();
+    fast_count = 0;
+    size_t after = compat_foreach_match(current_line, fast_callback, NULL);
+    ASSERT_EQ(after, before, "Reload should rebuild the same rule set");
+
+    compat_cleanup();
+    ASSERT_EQ(compat_foreach_match(current_line, fast_callback, NULL), 0,
+              "No matches after cleanup");
+}
+
+/* ============================================================================
+ * BINARY IMAGE TESTS
+ * ============================================================================ */
+
+/* Scratch directory holding a small data set and the image cache */
+static char image_dir[] = "/tmp/lush_compat_XXXXXX";
+static char image_data[256];
+static char image_cache[256];
+
+/**
+ * @brief Write a data file with @p extra entries beyond the fixed ones
+ */
+static void write_image_data(int extra) {
+    char path[300];
+    snprintf(path, sizeof(path), "%s/rules.toml", image_data);
+    FILE *f = fopen(path, "w");
+    ASSERT_NOT_NULL(f, "Should create data file");
+    fputs("[echo_e]\n"
+          "category = \"builtin\"\n"
+          "feature = \"echo\"\n"
+          "[echo_e.behavior]\n"
+          "posix = \"Not specified\"\n"
+          "lush = \"Interprets escapes\"\n"
+          "[echo_e.lint]\n"
+          "severity = \"warning\"\n"
+          "message = \"echo -e is not portable\"\n"
+          "pattern = \"echo[[:space:]]+-e\"\n"
+          "[echo_e.fix]\n"
+          "posix = \"safe\"\n"
+          "[echo_n]\n"
+          "category = \"builtin\"\n"
+          "feature = \"echo\"\n"
+          "[echo_n.lint]\n"
+          "pattern = \"echo[[:space:]]+-n\"\n"
+          "[bad_pattern]\n"
+          "category = \"syntax\"\n"
+          "feature = \"broken\"\n"
+          "[bad_pattern.lint]\n"
+          "pattern = \"echo(\"\n"
+          "[arrays_basic]\n"
+          "category = \"expansion\"\n"
+          "feature = \"arrays\"\n"
+          "description = \"Indexed arrays\"\n",
+          f);
+    for (int i = 0; i < extra; i++) {
+        fprintf(f, "[extra_%d]\ncategory = \"quoting\"\nfeature = \"f%d\"\n", i,
+                i % 7);
+    }
+    fclose(f);
+}
+
+TEST(compat_image_cache_round_trip) {
+    write_image_data(0);
+    unlink(image_cache);
+
+    compat_init(image_data);
+    ASSERT(!compat_loaded_from_cache(), "First load should parse TOML");
+    ASSERT_EQ(compat_get_entry_count(), 4, "Four entries loaded");
+    uint64_t hash = compat_ruleset_hash();
+    ASSERT(access(image_cache, R_OK) == 0, "Image should be cached");
+    compat_cleanup();
+
+    compat_init(image_data);
+    ASSERT(compat_loaded_from_cache(), "Second load should map the cache");
+    ASSERT_EQ(compat_get_entry_count(), 4, "Same entries from cache");
+    ASSERT(compat_ruleset_hash() == hash, "Same rule set from cache");
+
+    const compat_entry_t *e = compat_get_entry("echo_e");
+    ASSERT_NOT_NULL(e, "Entry found in cached image");
+    ASSERT_STR_EQ(e->feature, "echo", "Feature survives the image");
+    ASSERT_STR_EQ(e->lint.message, "echo -e is not portable",
+                  "Message survives the image");
+    ASSERT_STR_EQ(e->behavior.bash, NULL, "Missing field stays NULL");
+    ASSERT_EQ(e->lint.severity, COMPAT_SEVERITY_WARNING, "Severity kept");
+    ASSERT_EQ(e->lint.fix.posix, FIX_TYPE_SAFE, "Fix class kept");
+    compat_cleanup();
+}
+
+TEST(compat_image_rebuilt_when_stale) {
+    write_image_data(0);
+    compat_init(image_data);
+    compat_cleanup();
+
+    /* A different size changes the source stamp even within one second */
+    write_image_data(3);
+    compat_init(image_data);
+    ASSERT(!compat_loaded_from_cache(), "Changed data should be reparsed");
+    ASSERT_EQ(compat_get_entry_count(), 7, "New entries loaded");
+    compat_cleanup();
+
+    /* A truncated cache file is rejected and replaced */
+    FILE *f = fopen(image_cache, "r+");
+    ASSERT_NOT_NULL(f, "Cache file exists");
+    ASSERT_EQ(ftruncate(fileno(f), 64), 0, "Truncate cache");
+    fclose(f);
+    compat_init(image_data);
+    ASSERT(!compat_loaded_from_cache(), "Truncated cache is not used");
+    ASSERT_EQ(compat_get_entry_count(), 7, "Entries rebuilt");
+    compat_cleanup();
+    compat_init(image_data);
+    ASSERT(compat_loaded_from_cache(), "Rewritten cache is used");
+    compat_cleanup();
+}
+
+TEST(compat_image_cache_disabled) {
+    write_image_data(0);
+    unlink(image_cache);
+    compat_set_cache_path("");
+    compat_init(image_data);
+    ASSERT_EQ(compat_get_entry_count(), 4, "Entries loaded");
+    ASSERT(access(image_cache, F_OK) != 0, "No cache file written");
+    compat_cleanup();
+    compat_set_cache_path(image_cache);
+}
+
+TEST(compat_image_id_lookup) {
+    write_image_data(200);
+    compat_init(image_data);
+
+    size_t count = compat_get_entry_count();
+    ASSERT_EQ(count, 204, "All entries loaded");
+    char id[32];
+    for (int i = 0; i < 200; i++) {
+        snprintf(id, sizeof(id), "extra_%d", i);
+        const compat_entry_t *e = compat_get_entry(id);
+        ASSERT_NOT_NULL(e, "Every id is found");
+        ASSERT_STR_EQ(e->id, id, "Lookup returns the right entry");
+        ASSERT(compat_get_entry(id) == e, "Entries have stable addresses");
+    }
+    ASSERT_NULL(compat_get_entry("extra_200"), "Unknown id not found");
+    ASSERT_NULL(compat_get_entry(""), "Empty id not found");
+    compat_cleanup();
+}
+
+TEST(compat_image_feature_and_category_lists) {
+    write_image_data(20);
+    compat_init(image_data);
+
+    const compat_entry_t *entries[64];
+    size_t n = compat_get_by_feature("echo", entries, 64);
+    ASSERT_EQ(n, 2, "Two echo entries");
+    ASSERT_STR_EQ(entries[0]->id, "echo_e", "Database order kept");
+    ASSERT_STR_EQ(entries[1]->id, "echo_n", "Database order kept");
+    ASSERT_EQ(compat_get_by_feature("echo", entries, 1), 1, "Max respected");
+    ASSERT_EQ(compat_get_by_feature("f0", entries, 64), 3, "f0 members");
+    ASSERT_EQ(compat_get_by_feature("nothing", entries, 64), 0,
+              "Unknown feature is empty");
+
+    ASSERT_EQ(compat_get_by_category(COMPAT_CATEGORY_BUILTIN, entries, 64), 2,
+              "Builtin members");
+    ASSERT_EQ(compat_get_by_category(COMPAT_CATEGORY_QUOTING, entries, 64), 20,
+              "Quoting members");
+    for (size_t i = 0; i < 20; i++) {
+        ASSERT_EQ(entries[i]->category, COMPAT_CATEGORY_QUOTING,
+                  "Only quoting entries listed");
+    }
+
+    const compat_entry_t *first = compat_get_first_by_feature("arrays");
+    ASSERT_NOT_NULL(first, "First by feature found");
+    ASSERT_STR_EQ(first->id, "arrays_basic", "First by feature entry");
+    compat_cleanup();
+}
+
+TEST(compat_image_invalid_pattern_skipped) {
+    write_image_data(0);
+    compat_init(image_data);
+
+    current_line = "echo -e x; echo -n y; echo(";
+    fast_count = 0;
+    size_t matched = compat_foreach_match(current_line, fast_callback, NULL);
+    ASSERT_EQ(matched, 2, "Valid patterns match, the invalid one is skipped");
+    ASSERT_STR_EQ(fast_ids[0], "echo_e", "echo -e matched");
+    ASSERT_STR_EQ(fast_ids[1], "echo_n", "echo -n matched");
+    compat_cleanup();
+}
+
 /* ============================================================================
  * PORTABILITY CHECKING TESTS
  * ============================================================================ */
@@ -620,6 +899,33 @@ int main(void) {
     printf("\nForeach Entry Tests:\n");
     RUN_TEST(compat_foreach_entry);
 
+    printf("\nCompiled Rule Set Tests:\n");
+    RUN_TEST(compat_foreach_match_equals_brute_force);
+    RUN_TEST(compat_foreach_match_survives_reload);
+
+    printf("\nBinary Image Tests:\n");
+    if (!mkdtemp(image_dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    snprintf(image_data, sizeof(image_data), "%s/data", image_dir);
+    snprintf(image_cache, sizeof(image_cache), "%s/cache/compat.cache",
+             image_dir);
+    mkdir(image_data, 0755);
+    compat_set_cache_path(image_cache);
+    RUN_TEST(compat_image_cache_round_trip);
+    RUN_TEST(compat_image_rebuilt_when_stale);
+    RUN_TEST(compat_image_cache_disabled);
+    RUN_TEST(compat_image_id_lookup);
+    RUN_TEST(compat_image_feature_and_category_lists);
+    RUN_TEST(compat_image_invalid_pattern_skipped);
+    compat_set_cache_path(NULL);
+    char cmd[300];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", image_dir);
+    if (system(cmd) != 0) {
+        printf("warning: could not remove %s\n", image_dir);
+    }
+
     printf("\nPortability Checking Tests:\n");
     RUN_TEST(compat_is_portable_simple);
     RUN_TEST(compat_is_portable_null_result);
@@ -0,0 +1,404 @@
+/**
+ * @file test_coreutils.c
+ * @brief Unit tests for the in-process coreutils builtins
+ *
+ * Tests the coreutils module including:
+ * - Registering its builtins through the plugin manager
+ * - Output of each command for the options it implements
+ * - Reading standard input and leaving seekable input positioned
+ * - Falling back to the real utility for unsupported options
+ * - Disabling and unloading builtins
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "builtins.h"
+#include "coreutils.h"
+#include "lush_plugin.h"
+
+/* Test framework macros */
+#define TEST(name) static void test_##name(void)
+#define RUN_TEST(name)                                                         \
+    do {                                                                       \
+        printf("  Running: %s...\n", #name);                                   \
+        test_##name();                                                         \
+        printf("    PASSED\n");                                                \
+    } while (0)
+
+#define ASSERT(condition, message)                                             \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_EQ(actual, expected, message)                                   \
+    do {                                                                       \
+        if ((actual) != (expected)) {                                          \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      Expected: %d, Got: %d\n", (int)(expected),           \
+                   (int)(actual));                                             \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_STR_EQ(actual, expected, message)                               \
+    do {                                                                       \
+        const char *a_ = (actual);                                             \
+        if (!a_ || strcmp(a_, (expected)) != 0) {                              \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      Expected: [%s], Got: [%s]\n", (expected),            \
+                   a_ ? a_ : "(null)");                                        \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+static char scratch[] = "/tmp/lush_coreutils_XXXXXX";
+static lush_plugin_manager_t *manager;
+static char output[8192];
+
+static void scratch_path(char *buf, size_t size, const char *name) {
+    snprintf(buf, size, "%s/%s", scratch, name);
+}
+
+static void write_file(const char *name, const char *content) {
+    char path[256];
+    scratch_path(path, sizeof(path), name);
+    FILE *f = fopen(path, "w");
+    fputs(content, f);
+    fclose(f);
+}
+
+/**
+ * @brief Run a builtin with stdout (and optionally stdin) redirected
+ *
+ * @param input File in the scratch directory to use as stdin, or NULL
+ * @param argv NULL-terminated command line
+ * @return Exit status; the output is left in the output buffer
+ */
+static int run_with_input(const char *input, char **argv) {
+    const builtin *b = builtin_lookup(argv[0]);
+    ASSERT(b != NULL, "builtin is registered");
+
+    int argc = 0;
+    while (argv[argc]) {
+        argc++;
+    }
+
+    FILE *out = tmpfile();
+    fflush(stdout);
+    int saved_out = dup(STDOUT_FILENO);
+    int saved_in = dup(STDIN_FILENO);
+    dup2(fileno(out), STDOUT_FILENO);
+    if (input) {
+        char path[256];
+        scratch_path(path, sizeof(path), input);
+        int fd = open(path, O_RDONLY);
+        dup2(fd, STDIN_FILENO);
+        close(fd);
+    }
+
+    int status = b->func(argc, argv);
+
+    fflush(stdout);
+    dup2(saved_out, STDOUT_FILENO);
+    dup2(saved_in, STDIN_FILENO);
+    close(saved_out);
+    close(saved_in);
+
+    rewind(out);
+    size_t n = fread(output, 1, sizeof(output) - 1, out);
+    output[n] = '\0';
+    fclose(out);
+    return status;
+}
+
+static int run(char **argv) { return run_with_input(NULL, argv); }
+
+/* ============================================================================
+ * Module Tests
+ * ============================================================================ */
+
+TEST(module_registers_builtins) {
+    const char *names[] = {"basename", "cat", "date",  "dirname",
+                           "head",     "mkdir", "rm",  "seq",
+                           "sleep",    "tail",  "tee", "wc"};
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        ASSERT(builtin_lookup(names[i]) != NULL, names[i]);
+    }
+    ASSERT(is_builtin("wc"), "is_builtin sees loadable builtins");
+    ASSERT(builtin_register("wc", "dup", NULL) != 0, "duplicate rejected");
+    ASSERT(builtin_register("cd", "core", NULL) != 0,
+           "core builtin cannot be shadowed");
+}
+
+TEST(disable_and_enable) {
+    ASSERT_EQ(builtin_set_enabled("head", false), 0, "disable head");
+    ASSERT(builtin_lookup("head") == NULL, "disabled builtin not found");
+    ASSERT(!is_builtin("head"), "disabled builtin is not a builtin");
+    ASSERT_EQ(builtin_set_enabled("head", true), 0, "enable head");
+    ASSERT(builtin_lookup("head") != NULL, "enabled again");
+    ASSERT(builtin_set_enabled("cd", false) != 0, "core builtin untouched");
+}
+
+/* ============================================================================
+ * Command Tests
+ * ============================================================================ */
+
+TEST(basename_and_dirname) {
+    char *a[] = {"basename", "/usr/lib/libc.so", ".so", NULL};
+    ASSERT_EQ(run(a), 0, "basename status");
+    ASSERT_STR_EQ(output, "libc\n", "basename strips suffix");
+
+    char *b[] = {"basename", "dir/", NULL};
+    run(b);
+    ASSERT_STR_EQ(output, "dir\n", "trailing slash ignored");
+
+    char *c[] = {"basename", "x.so", "x.so", NULL};
+    run(c);
+    ASSERT_STR_EQ(output, "x.so\n", "suffix equal to name kept");
+
+    char *d[] = {"dirname", "/usr/lib/", "file", "/", "//a", NULL};
+    ASSERT_EQ(run(d), 0, "dirname status");
+    ASSERT_STR_EQ(output, "/usr\n.\n/\n/\n", "dirname operands");
+}
+
+TEST(head_and_tail) {
+    write_file("lines", "1\n2\n3\n4\n5\n");
+
+    char path[256];
+    scratch_path(path, sizeof(path), "lines");
+    char *a[] = {"head", "-n", "2", path, NULL};
+    run(a);
+    ASSERT_STR_EQ(output, "1\n2\n", "head -n 2");
+
+    char *b[] = {"head", "-c3", path, NULL};
+    run(b);
+    ASSERT_STR_EQ(output, "1\n2", "head -c3");
+
+    char *c[] = {"tail", "-2", path, NULL};
+    run(c);
+    ASSERT_STR_EQ(output, "4\n5\n", "tail -2");
+
+    char *d[] = {"tail", "-n", "+4", path, NULL};
+    run(d);
+    ASSERT_STR_EQ(output, "4\n5\n", "tail -n +4");
+
+    char *e[] = {"tail", "-n", "2", NULL};
+    run_with_input("lines", e);
+    ASSERT_STR_EQ(output, "4\n5\n", "tail of stdin");
+}
+
+TEST(head_leaves_input_positioned) {
+    write_file("lines", "1\n2\n3\n");
+    char path[256];
+    scratch_path(path, sizeof(path), "lines");
+
+    int fd = open(path, O_RDONLY);
+    int saved_in = dup(STDIN_FILENO);
+    dup2(fd, STDIN_FILENO);
+    close(fd);
+
+    char *argv[] = {"head", "-n", "1", NULL};
+    FILE *out = tmpfile();
+    int saved_out = dup(STDOUT_FILENO);
+    dup2(fileno(out), STDOUT_FILENO);
+    builtin_lookup("head")->func(3, argv);
+    dup2(saved_out, STDOUT_FILENO);
+    close(saved_out);
+    fclose(out);
+
+    char rest[16] = {0};
+    ssize_t n = read(STDIN_FILENO, rest, sizeof(rest) - 1);
+    dup2(saved_in, STDIN_FILENO);
+    close(saved_in);
+    ASSERT_EQ(n, 4, "unread bytes remain");
+    ASSERT_STR_EQ(rest, "2\n3\n", "offset just after the first line");
+}
+
+TEST(wc_counts) {
+    write_file("words", "one two\nthree\n");
+    char path[256];
+    scratch_path(path, sizeof(path), "words");
+
+    char *a[] = {"wc", "-l", path, NULL};
+    run(a);
+    char expected[300];
+    snprintf(expected, sizeof(expected), "2 %s\n", path);
+    ASSERT_STR_EQ(output, expected, "wc -l");
+
+    char *b[] = {"wc", NULL};
+    run_with_input("words", b);
+    ASSERT_STR_EQ(output, " 2  3 14\n", "wc of stdin");
+
+    write_file("utf8", "h\xc3\xa9\n");
+    char *c[] = {"wc", "-m", NULL};
+    run_with_input("utf8", c);
+    ASSERT_STR_EQ(output, "3\n", "wc -m counts characters");
+}
+
+TEST(seq_output) {
+    char *a[] = {"seq", "3", NULL};
+    run(a);
+    ASSERT_STR_EQ(output, "1\n2\n3\n", "seq 3");
+
+    char *b[] = {"seq", "-s", ",", "-w", "-1", "2", "3", NULL};
+    run(b);
+    ASSERT_STR_EQ(output, "-1,01,03\n", "separator, width, negative start");
+
+    char *c[] = {"seq", "5", "1", NULL};
+    ASSERT_EQ(run(c), 0, "empty range status");
+    ASSERT_STR_EQ(output, "", "empty range");
+}
+
+TEST(mkdir_and_rm) {
+    char path[256];
+    scratch_path(path, sizeof(path), "a/b/c");
+    char *a[] = {"mkdir", "-p", "-m", "700", path, NULL};
+    ASSERT_EQ(run(a), 0, "mkdir -p");
+    struct stat st;
+    ASSERT_EQ(stat(path, &st), 0, "directory created");
+    ASSERT_EQ(st.st_mode & 0777, 0700, "mode applied");
+    ASSERT_EQ(run(a), 0, "mkdir -p of existing directory");
+
+    char *b[] = {"mkdir", path, NULL};
+    ASSERT_EQ(run(b), 1, "mkdir of existing directory fails");
+
+    char top[256];
+    scratch_path(top, sizeof(top), "a");
+    write_file("a/b/file", "x");
+    char *c[] = {"rm", "-f", top, NULL};
+    ASSERT_EQ(run(c), 1, "rm of directory without -r fails");
+    char *d[] = {"rm", "-rf", top, NULL};
+    ASSERT_EQ(run(d), 0, "rm -rf");
+    ASSERT(stat(top, &st) != 0, "tree removed");
+
+    char *e[] = {"rm", "-f", top, NULL};
+    ASSERT_EQ(run(e), 0, "rm -f of missing file succeeds");
+
+    char dot[256];
+    scratch_path(dot, sizeof(dot), ".");
+    char *f[] = {"rm", "-rf", dot, NULL};
+    ASSERT_EQ(run(f), 1, "rm refuses .");
+    ASSERT_EQ(stat(scratch, &st), 0, "scratch directory kept");
+}
+
+TEST(tee_and_cat) {
+    write_file("in", "data\n");
+    char copy[256];
+    scratch_path(copy, sizeof(copy), "copy");
+
+    char *a[] = {"tee", copy, NULL};
+    ASSERT_EQ(run_with_input("in", a), 0, "tee status");
+    ASSERT_STR_EQ(output, "data\n", "tee copies to stdout");
+
+    char *b[] = {"tee", "-a", copy, NULL};
+    run_with_input("in", b);
+
+    char *c[] = {"cat", copy, "-", NULL};
+    run_with_input("in", c);
+    ASSERT_STR_EQ(output, "data\ndata\ndata\n", "cat of file and stdin");
+}
+
+TEST(date_format) {
+    char *a[] = {"date", "-u", "+%Y-%m-%d|%Z", NULL};
+    ASSERT_EQ(run(a), 0, "date status");
+    ASSERT_EQ(strlen(output), 15, "formatted length");
+    ASSERT_STR_EQ(output + 10, "|UTC\n", "UTC zone name");
+
+    char *b[] = {"date", "+", NULL};
+    run(b);
+    ASSERT_STR_EQ(output, "\n", "empty format");
+}
+
+TEST(sleep_fraction) {
+    char *a[] = {"sleep", "0.01", NULL};
+    ASSERT_EQ(run(a), 0, "fractional sleep");
+}
+
+/* ============================================================================
+ * Fallback Tests
+ * ============================================================================ */
+
+TEST(unsupported_options_run_utility) {
+    write_file("lines", "1\n2\n3\n");
+    char path[256];
+    scratch_path(path, sizeof(path), "lines");
+
+    /* Long options are not handled in process */
+    char *a[] = {"head", "--lines=1", path, NULL};
+    ASSERT_EQ(run(a), 0, "fallback status");
+    ASSERT_STR_EQ(output, "1\n", "fallback output reaches stdout");
+
+    char *b[] = {"cat", "--definitely-not-an-option", NULL};
+    ASSERT(run(b) != 0, "fallback reports utility failure");
+}
+
+/* ============================================================================
+ * Unload Tests
+ * ============================================================================ */
+
+TEST(unload_removes_builtins) {
+    ASSERT_EQ(lush_plugin_manager_unload(manager, COREUTILS_MODULE_NAME),
+              LUSH_PLUGIN_OK, "unload");
+    ASSERT(builtin_lookup("wc") == NULL, "wc gone");
+    ASSERT(builtin_loadable_at(0, NULL) == NULL, "no loadables left");
+}
+
+int main(void) {
+    printf("\n=== Coreutils Module Tests ===\n\n");
+
+    if (!mkdtemp(scratch)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    if (lush_plugin_manager_create(&manager, NULL) != LUSH_PLUGIN_OK ||
+        lush_plugin_manager_load_static(manager, &lush_coreutils_plugin,
+                                        NULL) != LUSH_PLUGIN_OK) {
+        printf("could not load the coreutils module\n");
+        return 1;
+    }
+
+    printf("Module Tests:\n");
+    RUN_TEST(module_registers_builtins);
+    RUN_TEST(disable_and_enable);
+
+    printf("\nCommand Tests:\n");
+    RUN_TEST(basename_and_dirname);
+    RUN_TEST(head_and_tail);
+    RUN_TEST(head_leaves_input_positioned);
+    RUN_TEST(wc_counts);
+    RUN_TEST(seq_output);
+    RUN_TEST(mkdir_and_rm);
+    RUN_TEST(tee_and_cat);
+    RUN_TEST(date_format);
+    RUN_TEST(sleep_fraction);
+
+    printf("\nFallback Tests:\n");
+    RUN_TEST(unsupported_options_run_utility);
+
+    printf("\nUnload Tests:\n");
+    RUN_TEST(unload_removes_builtins);
+
+    lush_plugin_manager_destroy(manager);
+    char cmd[300];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", scratch);
+    if (system(cmd) != 0) {
+        printf("warning: could not remove %s\n", scratch);
+    }
+
+    printf("\n=== All %d Coreutils Module Tests Passed ===\n\n", 13);
+    return 0;
+}
@@ -0,0 +1,332 @@
+/**
+ * @file test_debug_batch.c
+ * @brief Unit tests for multi-script analysis
+ *
+ * Tests the batch analyzer including:
+ * - Script collection from files and directories
+ * - Output replayed in list order with several workers
+ * - Cache hits for unchanged scripts
+ * - Cache misses after the content or the options change
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "debug.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Test framework macros */
+#define TEST(name) static void test_##name(void)
+#define RUN_TEST(name)                                                         \
+    do {                                                                       \
+        printf("  Running: %s...\n", #name);                                   \
+        fflush(stdout);                                                        \
+        test_##name();                                                         \
+        printf("    PASSED\n");                                                \
+    } while (0)
+
+#define ASSERT(condition, message)                                             \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_EQ(actual, expected, message)                                   \
+    do {                                                                       \
+        if ((actual) != (expected)) {                                          \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      Expected: %d, Got: %d\n", (int)(expected),           \
+                   (int)(actual));                                             \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+/** Number of scripts in the scratch tree */
+#define SCRIPT_COUNT 6
+
+static char scratch[] = "/tmp/lush-batch-test-XXXXXX";
+static char script_dir[256];
+static char cache_dir[256];
+
+/**
+ * @brief Write a script into the scratch tree
+ */
+static void write_script(const char *path, const char *content) {
+    FILE *fp = fopen(path, "w");
+    ASSERT(fp != NULL, "script created");
+    fputs(content, fp);
+    fclose(fp);
+}
+
+/**
+ * @brief Create the scripts s0.sh .. s5.sh
+ *
+ * The first script is much longer than the others so that, with several
+ * workers, it is the last one to finish.
+ */
+static void create_scripts(void) {
+    snprintf(script_dir, sizeof(script_dir), "%s/scripts", scratch);
+    snprintf(cache_dir, sizeof(cache_dir), "%s/cache", scratch);
+    ASSERT(mkdir(script_dir, 0755) == 0, "script directory created");
+
+    for (int i = 0; i < SCRIPT_COUNT; i++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/s%d.sh", script_dir, i);
+        FILE *fp = fopen(path, "w");
+        ASSERT(fp != NULL, "script created");
+        fprintf(fp, "#!/bin/sh\necho $value%d\n", i);
+        for (int line = 0; i == 0 && line < 5000; line++) {
+            fprintf(fp, "echo line %d $x\n", line);
+        }
+        fclose(fp);
+    }
+}
+
+/**
+ * @brief Collect the scratch scripts in sorted order
+ */
+static char **collect_scripts(size_t *count) {
+    char *args[] = {script_dir};
+    char **paths = NULL;
+    ASSERT_EQ(debug_batch_collect(args, 1, &paths, count), 0,
+              "scripts collected");
+    return paths;
+}
+
+/**
+ * @brief Run a batch with stdout and stderr captured
+ *
+ * @return Everything the run wrote, in order (caller frees)
+ */
+static char *run_captured(char **paths, size_t count,
+                          const debug_batch_options_t *opts,
+                          debug_batch_summary_t *summary) {
+    FILE *capture = tmpfile();
+    ASSERT(capture != NULL, "capture file");
+
+    fflush(stdout);
+    fflush(stderr);
+    int saved_out = dup(STDOUT_FILENO);
+    int saved_err = dup(STDERR_FILENO);
+    dup2(fileno(capture), STDOUT_FILENO);
+    dup2(fileno(capture), STDERR_FILENO);
+
+    debug_batch_run(paths, count, opts, summary);
+
+    fflush(stdout);
+    fflush(stderr);
+    dup2(saved_out, STDOUT_FILENO);
+    dup2(saved_err, STDERR_FILENO);
+    close(saved_out);
+    close(saved_err);
+
+    long size = ftell(capture);
+    ASSERT(size > 0, "batch wrote output");
+    char *output = malloc((size_t)size + 1);
+    ASSERT(output != NULL, "output buffer");
+    rewind(capture);
+    size_t n = fread(output, 1, (size_t)size, capture);
+    output[n] = '\0';
+    fclose(capture);
+    return output;
+}
+
+/**
+ * @brief Drop the lines that carry a timestamp
+ */
+static void strip_timestamps(char *output) {
+    char *line = output;
+    char *dest = output;
+    while (*line) {
+        char *end = strchr(line, '\n');
+        size_t len = end ? (size_t)(end - line) + 1 : strlen(line);
+        char saved = line[len];
+        line[len] = '\0';
+        bool stamped = strstr(line, "session started at") != NULL;
+        line[len] = saved;
+        if (!stamped) {
+            memmove(dest, line, len);
+            dest += len;
+        }
+        line += len;
+    }
+    *dest = '\0';
+}
+
+static debug_batch_options_t lint_options(int jobs, bool use_cache) {
+    debug_batch_options_t opts = {0};
+    opts.mode = ANALYSIS_MODE_LINT;
+    opts.jobs = jobs;
+    opts.use_cache = use_cache;
+    opts.cache_dir = cache_dir;
+    return opts;
+}
+
+/* ============================================================================
+ * Collection Tests
+ * ============================================================================ */
+
+TEST(collect_sorted_without_duplicates) {
+    char s3[512];
+    snprintf(s3, sizeof(s3), "%s/s3.sh", script_dir);
+    char *args[] = {s3, script_dir};
+    char **paths = NULL;
+    size_t count = 0;
+    ASSERT_EQ(debug_batch_collect(args, 2, &paths, &count), 0, "collected");
+    ASSERT_EQ(count, SCRIPT_COUNT, "duplicate dropped");
+    ASSERT(strcmp(paths[0], s3) == 0, "arguments keep their order");
+    for (size_t i = 2; i < count; i++) {
+        ASSERT(strcmp(paths[i - 1], paths[i]) < 0,
+               "directory entries sorted");
+    }
+    debug_batch_free_paths(paths, count);
+
+    char missing[512];
+    snprintf(missing, sizeof(missing), "%s/missing.sh", scratch);
+    char *bad[] = {missing};
+    fflush(stderr);
+    int saved_err = dup(STDERR_FILENO);
+    int devnull = open("/dev/null", O_WRONLY);
+    dup2(devnull, STDERR_FILENO);
+    int rc = debug_batch_collect(bad, 1, &paths, &count);
+    dup2(saved_err, STDERR_FILENO);
+    close(saved_err);
+    close(devnull);
+    ASSERT_EQ(rc, -1, "missing argument reported");
+}
+
+/* ============================================================================
+ * Ordering Tests
+ * ============================================================================ */
+
+TEST(parallel_output_in_list_order) {
+    size_t count = 0;
+    char **paths = collect_scripts(&count);
+    ASSERT_EQ(count, SCRIPT_COUNT, "all scripts collected");
+
+    debug_batch_options_t serial_opts = lint_options(1, false);
+    debug_batch_options_t parallel_opts = lint_options(4, false);
+    debug_batch_summary_t summary;
+    char *serial = run_captured(paths, count, &serial_opts, &summary);
+    char *parallel = run_captured(paths, count, &parallel_opts, &summary);
+
+    ASSERT_EQ(summary.files, SCRIPT_COUNT, "every script checked");
+    ASSERT_EQ(summary.cached, 0, "cache not used");
+
+    const char *previous = parallel;
+    for (size_t i = 0; i < count; i++) {
+        const char *at = strstr(parallel, paths[i]);
+        ASSERT(at != NULL, "script reported");
+        ASSERT(at >= previous, "scripts reported in list order");
+        previous = at;
+    }
+    strip_timestamps(serial);
+    strip_timestamps(parallel);
+    ASSERT(strcmp(serial, parallel) == 0,
+           "output does not depend on the number of workers");
+
+    free(serial);
+    free(parallel);
+    debug_batch_free_paths(paths, count);
+}
+
+/* ============================================================================
+ * Cache Tests
+ * ============================================================================ */
+
+TEST(unchanged_scripts_hit_cache) {
+    size_t count = 0;
+    char **paths = collect_scripts(&count);
+    debug_batch_options_t opts = lint_options(2, true);
+    debug_batch_summary_t summary;
+
+    char *first = run_captured(paths, count, &opts, &summary);
+    ASSERT_EQ(summary.cached, 0, "first run analyzes every script");
+
+    char *second = run_captured(paths, count, &opts, &summary);
+    ASSERT_EQ(summary.cached, SCRIPT_COUNT, "second run uses the cache");
+    ASSERT(strcmp(first, second) == 0, "cached output is replayed as is");
+
+    free(first);
+    free(second);
+    debug_batch_free_paths(paths, count);
+}
+
+TEST(changed_content_misses_cache) {
+    size_t count = 0;
+    char **paths = collect_scripts(&count);
+    debug_batch_options_t opts = lint_options(2, true);
+    debug_batch_summary_t summary;
+
+    free(run_captured(paths, count, &opts, &summary));
+    write_script(paths[2], "#!/bin/sh\necho changed $y\n");
+
+    free(run_captured(paths, count, &opts, &summary));
+    ASSERT_EQ(summary.cached, SCRIPT_COUNT - 1,
+              "only the changed script is analyzed again");
+
+    free(run_captured(paths, count, &opts, &summary));
+    ASSERT_EQ(summary.cached, SCRIPT_COUNT, "new result cached");
+    debug_batch_free_paths(paths, count);
+}
+
+TEST(changed_options_miss_cache) {
+    size_t count = 0;
+    char **paths = collect_scripts(&count);
+    debug_batch_options_t opts = lint_options(2, true);
+    debug_batch_summary_t summary;
+
+    free(run_captured(paths, count, &opts, &summary));
+
+    debug_batch_options_t analyze = opts;
+    analyze.mode = ANALYSIS_MODE_FULL;
+    free(run_captured(paths, count, &analyze, &summary));
+    ASSERT_EQ(summary.cached, 0, "another mode analyzes again");
+
+    debug_batch_options_t dry_run = opts;
+    dry_run.fix = true;
+    dry_run.dry_run = true;
+    free(run_captured(paths, count, &dry_run, &summary));
+    ASSERT_EQ(summary.cached, 0, "other fix options analyze again");
+
+    free(run_captured(paths, count, &opts, &summary));
+    ASSERT_EQ(summary.cached, SCRIPT_COUNT, "original options still cached");
+    debug_batch_free_paths(paths, count);
+}
+
+int main(void) {
+    printf("\n=== Debug Batch Tests ===\n\n");
+
+    ASSERT(mkdtemp(scratch) != NULL, "scratch directory created");
+    create_scripts();
+
+    printf("Collection Tests:\n");
+    RUN_TEST(collect_sorted_without_duplicates);
+
+    printf("\nOrdering Tests:\n");
+    RUN_TEST(parallel_output_in_list_order);
+
+    printf("\nCache Tests:\n");
+    RUN_TEST(unchanged_scripts_hit_cache);
+    RUN_TEST(changed_content_misses_cache);
+    RUN_TEST(changed_options_miss_cache);
+
+    char cmd[512];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", scratch);
+    if (system(cmd) != 0) {
+        printf("warning: could not remove %s\n", scratch);
+    }
+
+    printf("\n=== All %d Debug Batch Tests Passed ===\n\n", 5);
+    return 0;
+}
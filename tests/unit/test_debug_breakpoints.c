@@ -675,6 +675,59 @@ static int test_check_breakpoint_disabled_breakpoint(void) {
     return 1;
 }
 
+static int test_intern_source_file_stable(void) {
+    int a = debug_intern_source_file("intern_a.sh");
+    int b = debug_intern_source_file("intern_b.sh");
+
+    ASSERT(a > 0);
+    ASSERT(b > 0);
+    ASSERT(a != b);
+    ASSERT_EQ(debug_intern_source_file("intern_a.sh"), a);
+    ASSERT_EQ(debug_intern_source_file(NULL), 0);
+    return 1;
+}
+
+static int test_breakpoint_index_armed_count(void) {
+    debug_context_t *ctx = create_test_context();
+    ASSERT_NOT_NULL(ctx);
+    ASSERT_EQ(ctx->armed_breakpoints, 0);
+
+    int id1 = debug_add_breakpoint(ctx, "test.sh", 10, NULL);
+    debug_add_breakpoint(ctx, "test.sh", 500, NULL);
+    ASSERT_EQ(ctx->armed_breakpoints, 2);
+
+    debug_enable_breakpoint(ctx, id1, false);
+    ASSERT_EQ(ctx->armed_breakpoints, 1);
+
+    debug_remove_breakpoint(ctx, id1);
+    ASSERT_EQ(ctx->armed_breakpoints, 1);
+
+    debug_clear_breakpoints(ctx);
+    ASSERT_EQ(ctx->armed_breakpoints, 0);
+    ASSERT_NULL(ctx->bp_index);
+
+    free_test_context(ctx);
+    return 1;
+}
+
+static int test_check_breakpoint_at_unarmed_line(void) {
+    debug_context_t *ctx = create_test_context();
+    ASSERT_NOT_NULL(ctx);
+
+    debug_add_breakpoint(ctx, "test.sh", 10, NULL);
+    int file_id = debug_intern_source_file("test.sh");
+
+    /* Neighbouring lines and unknown file ids never match */
+    ASSERT(!debug_check_breakpoint_at(ctx, file_id, "test.sh", 9));
+    ASSERT(!debug_check_breakpoint_at(ctx, file_id, "test.sh", 11));
+    ASSERT(!debug_check_breakpoint_at(ctx, file_id, "test.sh", 100000));
+    ASSERT(!debug_check_breakpoint_at(ctx, 0, "test.sh", 10));
+    ASSERT(!debug_check_breakpoint_at(ctx, 99999, "test.sh", 10));
+
+    free_test_context(ctx);
+    return 1;
+}
+
 /* ============================================================
  * STEP EXECUTION TESTS
  * ============================================================ */
@@ -1885,6 +1938,9 @@ int main(void) {
     RUN_TEST(test_check_breakpoint_invalid_line);
     RUN_TEST(test_check_breakpoint_no_match);
     RUN_TEST(test_check_breakpoint_disabled_breakpoint);
+    RUN_TEST(test_intern_source_file_stable);
+    RUN_TEST(test_breakpoint_index_armed_count);
+    RUN_TEST(test_check_breakpoint_at_unarmed_line);
 
     printf("\n=== Step Execution Tests ===\n");
     RUN_TEST(test_step_into_null_context);
@@ -65,6 +65,25 @@ TEST(debug_init_creates_context) {
     debug_cleanup(ctx);
 }
 
+TEST(debug_init_empty_breakpoint_index) {
+    /* Leave junk where the context is likely to be allocated */
+    volatile unsigned char *stale = malloc(sizeof(debug_context_t));
+    ASSERT(stale != NULL, "allocation");
+    for (size_t i = 0; i < sizeof(debug_context_t); i++) {
+        stale[i] = 0xA5;
+    }
+    free((void *)stale);
+
+    debug_context_t *ctx = debug_init();
+    ASSERT_NOT_NULL(ctx, "Context creation should succeed");
+    ASSERT(ctx->bp_index == NULL, "No breakpoint index yet");
+    ASSERT_EQ(ctx->bp_index_size, 0, "Index is empty");
+    ASSERT_EQ(ctx->armed_breakpoints, 0, "Nothing armed");
+
+    /* Cleanup frees only what was allocated */
+    debug_cleanup(ctx);
+}
+
 TEST(debug_cleanup_null) {
     /* Should not crash */
     debug_cleanup(NULL);
@@ -279,6 +298,7 @@ int main(void) {
 
     printf("Debug Context Tests:\n");
     RUN_TEST(debug_init_creates_context);
+    RUN_TEST(debug_init_empty_breakpoint_index);
     RUN_TEST(debug_cleanup_null);
     RUN_TEST(debug_context_enabled);
     RUN_TEST(debug_context_mode);
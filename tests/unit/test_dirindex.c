@@ -0,0 +1,345 @@
+/**
+ * @file test_dirindex.c
+ * @brief Unit tests for the frecency directory index
+ *
+ * Tests the directory index behind the z builtin including:
+ * - Recording visits and frecency scores
+ * - Fragment matching and ranking
+ * - Removal of stale directories
+ * - Persistence and merging with concurrent saves
+ * - Aging and size limits
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "dirindex.h"
+
+/* Test framework macros */
+#define TEST(name) static void test_##name(void)
+#define RUN_TEST(name)                                                         \
+    do {                                                                       \
+        printf("  Running: %s...\n", #name);                                   \
+        setup();                                                               \
+        test_##name();                                                         \
+        printf("    PASSED\n");                                                \
+    } while (0)
+
+#define ASSERT(condition, message)                                             \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_EQ(actual, expected, message)                                   \
+    do {                                                                       \
+        if ((actual) != (expected)) {                                          \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      Expected: %d, Got: %d\n", (int)(expected),           \
+                   (int)(actual));                                             \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_STR_EQ(actual, expected, message)                               \
+    do {                                                                       \
+        const char *a_ = (actual);                                             \
+        if (!a_ || strcmp(a_, (expected)) != 0) {                              \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      Expected: %s, Got: %s\n", (expected),                \
+                   a_ ? a_ : "(null)");                                        \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+/* Scratch directory holding the index file and test directories */
+static char scratch[] = "/tmp/lush_dirindex_XXXXXX";
+static char index_file[256];
+
+static void setup(void) {
+    unlink(index_file);
+    dirindex_set_limits(0, 0);
+    dirindex_set_file(index_file);
+}
+
+static char *make_dir(const char *name) {
+    static char path[512];
+    snprintf(path, sizeof(path), "%s/%s", scratch, name);
+    mkdir(path, 0755);
+    return path;
+}
+
+static void visit(const char *path, int times) {
+    for (int i = 0; i < times; i++) {
+        dirindex_add(path);
+    }
+}
+
+/* ============================================================================
+ * RECORDING TESTS
+ * ============================================================================
+ */
+
+TEST(add_and_score) {
+    ASSERT_EQ(dirindex_count(), 0, "index should start empty");
+    visit("/srv/app", 3);
+    visit("/srv/web", 1);
+    ASSERT_EQ(dirindex_count(), 2, "two directories indexed");
+
+    time_t now = time(NULL);
+    double app = dirindex_score("/srv/app", now);
+    double web = dirindex_score("/srv/web", now);
+    ASSERT(app > web, "more visits should score higher");
+    ASSERT(dirindex_score("/srv/none", now) == 0.0, "unknown scores zero");
+
+    /* Recency weighting: the same rank scores less a week later */
+    ASSERT(dirindex_score("/srv/app", now + 8 * 86400) < app,
+           "old visits should score lower");
+}
+
+TEST(ignored_paths) {
+    const char *home = getenv("HOME");
+    ASSERT(dirindex_add("relative/dir") < 0, "relative paths ignored");
+    ASSERT(dirindex_add("/bad\npath") < 0, "newlines ignored");
+    if (home && home[0] == '/') {
+        ASSERT(dirindex_add(home) < 0, "HOME ignored");
+    }
+    ASSERT_EQ(dirindex_count(), 0, "nothing indexed");
+}
+
+/* ============================================================================
+ * MATCHING TESTS
+ * ============================================================================
+ */
+
+TEST(query_fragments_in_order) {
+    visit("/work/src/lush", 2);
+    visit("/work/lush/src", 1);
+
+    const char *frags[] = {"work", "lush"};
+    dirindex_match_t *m;
+    size_t n = dirindex_query(frags, 2, NULL, NULL, &m);
+    ASSERT_EQ(n, 1, "last fragment must match the final component");
+    ASSERT_STR_EQ(m[0].path, "/work/src/lush", "best match");
+    free(m);
+
+    const char *slash[] = {"lush/src"};
+    n = dirindex_query(slash, 1, NULL, NULL, &m);
+    ASSERT_EQ(n, 1, "fragment with slash may span components");
+    ASSERT_STR_EQ(m[0].path, "/work/lush/src", "slash match");
+    free(m);
+}
+
+TEST(query_smart_case) {
+    visit("/data/Photos", 1);
+
+    const char *lower[] = {"photos"};
+    const char *upper[] = {"PHOTOS"};
+    dirindex_match_t *m;
+    ASSERT_EQ(dirindex_query(lower, 1, NULL, NULL, &m), 1,
+              "lower-case fragment ignores case");
+    free(m);
+    ASSERT_EQ(dirindex_query(upper, 1, NULL, NULL, &m), 0,
+              "upper-case fragment is case sensitive");
+    free(m);
+}
+
+TEST(query_ranks_and_filters) {
+    visit("/a/proj", 1);
+    visit("/b/proj", 5);
+    visit("/b/proj/sub/proj", 2);
+
+    const char *frags[] = {"proj"};
+    dirindex_match_t *m;
+    size_t n = dirindex_query(frags, 1, NULL, NULL, &m);
+    ASSERT_EQ(n, 3, "three matches");
+    ASSERT_STR_EQ(m[0].path, "/b/proj", "highest rank first");
+    ASSERT(m[0].score >= m[1].score && m[1].score >= m[2].score,
+           "sorted by score");
+    free(m);
+
+    n = dirindex_query(frags, 1, NULL, "/b/proj", &m);
+    ASSERT_EQ(n, 2, "excluded path skipped");
+    free(m);
+
+    n = dirindex_query(frags, 1, "/b/proj", NULL, &m);
+    ASSERT_EQ(n, 1, "within restricts to strict subdirectories");
+    ASSERT_STR_EQ(m[0].path, "/b/proj/sub/proj", "subdirectory match");
+    free(m);
+}
+
+TEST(best_drops_missing_directories) {
+    char gone[512];
+    snprintf(gone, sizeof(gone), "%s/gone/target", scratch);
+    char *kept = strdup(make_dir("target"));
+
+    visit(gone, 10);
+    visit(kept, 1);
+
+    const char *frags[] = {"target"};
+    char *best = dirindex_best(frags, 1, NULL, NULL);
+    ASSERT_STR_EQ(best, kept, "missing directory skipped");
+    free(best);
+    ASSERT(dirindex_score(gone, time(NULL)) == 0.0,
+           "missing directory removed from index");
+
+    best = dirindex_best(frags, 1, NULL, kept);
+    ASSERT(best == NULL, "no match when only the excluded path remains");
+    free(kept);
+}
+
+TEST(remove_directory) {
+    visit("/x/one", 1);
+    ASSERT_EQ(dirindex_remove("/x/one"), 0, "removal succeeds");
+    ASSERT_EQ(dirindex_remove("/x/one"), -1, "second removal fails");
+    ASSERT_EQ(dirindex_count(), 0, "index empty");
+}
+
+/* ============================================================================
+ * PERSISTENCE TESTS
+ * ============================================================================
+ */
+
+TEST(save_and_reload) {
+    visit("/p/alpha", 4);
+    visit("/p/beta", 2);
+    ASSERT_EQ(dirindex_save(), 0, "save succeeds");
+
+    dirindex_set_file(index_file);
+    ASSERT_EQ(dirindex_count(), 2, "entries reloaded");
+    time_t now = time(NULL);
+    ASSERT(dirindex_score("/p/alpha", now) > dirindex_score("/p/beta", now),
+           "ranks preserved");
+
+    struct stat st;
+    ASSERT(stat(index_file, &st) == 0 && (st.st_mode & 077) == 0,
+           "index file is private");
+}
+
+TEST(save_merges_concurrent_changes) {
+    visit("/m/shared", 1);
+    visit("/m/gone", 1);
+    ASSERT_EQ(dirindex_save(), 0, "initial save");
+
+    /* This shell loads the file, visits, and removes an entry */
+    dirindex_set_file(index_file);
+    visit("/m/shared", 2);
+    dirindex_remove("/m/gone");
+
+    /* Meanwhile another shell rewrites the file */
+    FILE *fp = fopen(index_file, "w");
+    ASSERT(fp != NULL, "rewrite file");
+    fprintf(fp, "# lush dirindex v1\n");
+    fprintf(fp, "3\t%lld\t/m/shared\n", (long long)time(NULL));
+    fprintf(fp, "1\t%lld\t/m/gone\n", (long long)time(NULL));
+    fprintf(fp, "5\t%lld\t/m/other\n", (long long)time(NULL));
+    fclose(fp);
+
+    ASSERT_EQ(dirindex_save(), 0, "merging save");
+    dirindex_set_file(index_file);
+    ASSERT_EQ(dirindex_count(), 2, "removal applied, other shell's entry kept");
+
+    time_t now = time(NULL);
+    double shared = dirindex_score("/m/shared", now);
+    double other = dirindex_score("/m/other", now);
+    ASSERT(shared == other, "pending visits added to the other shell's rank");
+}
+
+TEST(malformed_lines_skipped) {
+    FILE *fp = fopen(index_file, "w");
+    ASSERT(fp != NULL, "write file");
+    fprintf(fp, "# lush dirindex v1\n");
+    fprintf(fp, "garbage\n");
+    fprintf(fp, "2\t100\trelative\n");
+    fprintf(fp, "2\t100\t/ok\n");
+    fprintf(fp, "-1\t100\t/negative\n");
+    fclose(fp);
+
+    dirindex_set_file(index_file);
+    ASSERT_EQ(dirindex_count(), 1, "only the valid line loaded");
+}
+
+/* ============================================================================
+ * LIMIT TESTS
+ * ============================================================================
+ */
+
+TEST(aging_scales_and_forgets) {
+    dirindex_set_limits(0, 20.0);
+    visit("/age/rare", 1);
+    visit("/age/often", 25);
+
+    ASSERT(dirindex_score("/age/rare", time(NULL)) == 0.0,
+           "rarely visited directory forgotten");
+    ASSERT_EQ(dirindex_count(), 1, "frequent directory kept");
+}
+
+TEST(entry_cap) {
+    dirindex_set_limits(10, 0);
+    char path[64];
+    for (int i = 0; i < 11; i++) {
+        snprintf(path, sizeof(path), "/cap/d%02d", i);
+        visit(path, i + 1);
+    }
+    ASSERT(dirindex_count() <= 10, "cap enforced");
+    ASSERT(dirindex_score("/cap/d10", time(NULL)) > 0.0,
+           "highest ranked kept");
+    ASSERT(dirindex_score("/cap/d00", time(NULL)) == 0.0,
+           "lowest ranked dropped");
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================
+ */
+
+int main(void) {
+    printf("\n=== Directory Index Tests ===\n\n");
+
+    if (!mkdtemp(scratch)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    snprintf(index_file, sizeof(index_file), "%s/dirs", scratch);
+
+    printf("Recording Tests:\n");
+    RUN_TEST(add_and_score);
+    RUN_TEST(ignored_paths);
+
+    printf("\nMatching Tests:\n");
+    RUN_TEST(query_fragments_in_order);
+    RUN_TEST(query_smart_case);
+    RUN_TEST(query_ranks_and_filters);
+    RUN_TEST(best_drops_missing_directories);
+    RUN_TEST(remove_directory);
+
+    printf("\nPersistence Tests:\n");
+    RUN_TEST(save_and_reload);
+    RUN_TEST(save_merges_concurrent_changes);
+    RUN_TEST(malformed_lines_skipped);
+
+    printf("\nLimit Tests:\n");
+    RUN_TEST(aging_scales_and_forgets);
+    RUN_TEST(entry_cap);
+
+    dirindex_cleanup();
+    char cmd[300];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", scratch);
+    if (system(cmd) != 0) {
+        printf("warning: could not remove %s\n", scratch);
+    }
+
+    printf("\n=== All %d Directory Index Tests Passed ===\n\n", 12);
+    return 0;
+}
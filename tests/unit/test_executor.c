@@ -904,6 +904,23 @@ TEST(extended_test_or) {
     executor_free(exec);
 }
 
+TEST(extended_test_concatenated_operand) {
+    executor_t *exec = executor_new();
+    ASSERT_NOT_NULL(exec, "executor_new failed");
+    
+    /* x$y is one operand, so an empty y leaves just x */
+    int status = executor_execute_command_line(exec, "y=''; [[ x$y == x ]]");
+    ASSERT_EQ(status, 0, "x$y with empty y should equal x");
+    
+    status = executor_execute_command_line(exec, "y=1; [[ x$y == x1 ]]");
+    ASSERT_EQ(status, 0, "x$y with y=1 should equal x1");
+    
+    status = executor_execute_command_line(exec, "y=1; [[ ${y}x == x1 ]]");
+    ASSERT(status != 0, "${y}x should not equal x1");
+    
+    executor_free(exec);
+}
+
 TEST(extended_test_pattern_match) {
     executor_t *exec = executor_new();
     ASSERT_NOT_NULL(exec, "executor_new failed");
@@ -1115,6 +1132,76 @@ TEST(command_substitution_exit_status) {
     executor_free(exec);
 }
 
+TEST(command_substitution_read_file) {
+    executor_t *exec = executor_new();
+    ASSERT_NOT_NULL(exec, "executor_new failed");
+
+    char path[] = "/tmp/lush_exec_readXXXXXX";
+    int fd = mkstemp(path);
+    ASSERT(fd >= 0, "mkstemp failed");
+    ASSERT(write(fd, "one\ntwo\n\n", 9) == 9, "write failed");
+    close(fd);
+
+    /* $(<file) is read in the shell, so the value is observable here */
+    char cmd[256];
+    snprintf(cmd, sizeof(cmd), "F=%s; X=$(<\"$F\"); Y=\"[$(< $F )]\"", path);
+    int status = executor_execute_command_line(exec, cmd);
+    ASSERT_EQ(status, 0, "$(<file) should succeed");
+
+    char *x = symtable_get_var(exec->symtable, "X");
+    ASSERT_NOT_NULL(x, "X should be set");
+    ASSERT_STR_EQ(x, "one\ntwo", "$(<file) should strip trailing newlines");
+    free(x);
+
+    char *y = symtable_get_var(exec->symtable, "Y");
+    ASSERT_NOT_NULL(y, "Y should be set");
+    ASSERT_STR_EQ(y, "[one\ntwo]", "$(<file) should work inside quotes");
+    free(y);
+
+    unlink(path);
+    executor_execute_command_line(exec, "Z=$(</nonexistent/lush_file)");
+    char *z = symtable_get_var(exec->symtable, "Z");
+    ASSERT(z == NULL || z[0] == '\0', "Missing file should expand to nothing");
+    free(z);
+
+    executor_free(exec);
+}
+
+TEST(command_substitution_read_file_word) {
+    executor_t *exec = executor_new();
+    ASSERT_NOT_NULL(exec, "executor_new failed");
+
+    char dir[] = "/tmp/lush_exec_wordXXXXXX";
+    ASSERT_NOT_NULL(mkdtemp(dir), "mkdtemp failed");
+    char path[128];
+    snprintf(path, sizeof(path), "%s/f.txt", dir);
+    FILE *fp = fopen(path, "w");
+    ASSERT_NOT_NULL(fp, "fopen failed");
+    fputs("hello\n", fp);
+    fclose(fp);
+
+    /* The target is several adjacent tokens and may glob to one file */
+    char cmd[256];
+    snprintf(cmd, sizeof(cmd), "p=%s; X=$(<$p/f.txt); Y=$(<$p/*.txt)",
+             dir);
+    int status = executor_execute_command_line(exec, cmd);
+    ASSERT_EQ(status, 0, "$(<$dir/file) should succeed");
+
+    char *x = symtable_get_var(exec->symtable, "X");
+    ASSERT_NOT_NULL(x, "X should be set");
+    ASSERT_STR_EQ(x, "hello", "$(<$dir/file) should read the file");
+    free(x);
+
+    char *y = symtable_get_var(exec->symtable, "Y");
+    ASSERT_NOT_NULL(y, "Y should be set");
+    ASSERT_STR_EQ(y, "hello", "$(<$dir/*.txt) should read the one match");
+    free(y);
+
+    unlink(path);
+    rmdir(dir);
+    executor_free(exec);
+}
+
 /* ============================================================================
  * SPECIAL VARIABLE TESTS
  * ============================================================================ */
@@ -1342,6 +1429,41 @@ TEST(local_variable_in_function) {
     executor_free(exec);
 }
 
+/* ============================================================================
+ * RESOURCE ACCOUNTING TESTS
+ * ============================================================================ */
+
+TEST(rusage_external_command) {
+    executor_t *exec = executor_new();
+    ASSERT_NOT_NULL(exec, "executor_new failed");
+
+    int status = executor_execute_command_line(exec, "/bin/true");
+    ASSERT_EQ(status, 0, "/bin/true should succeed");
+    ASSERT_EQ(exec->last_rusage_children, 1,
+              "One child should be accounted for");
+    ASSERT(exec->last_rusage.ru_maxrss > 0, "Child maxrss should be recorded");
+
+    array_value_t *usage = symtable_get_array("LUSH_LAST_RUSAGE");
+    ASSERT_NOT_NULL(usage, "LUSH_LAST_RUSAGE should be set");
+    ASSERT_STR_EQ(symtable_array_get_assoc(usage, "children"), "1",
+                  "LUSH_LAST_RUSAGE[children] should be 1");
+
+    executor_free(exec);
+}
+
+TEST(rusage_builtin_only) {
+    executor_t *exec = executor_new();
+    ASSERT_NOT_NULL(exec, "executor_new failed");
+
+    executor_execute_command_line(exec, "/bin/true");
+    int status = executor_execute_command_line(exec, ":");
+    ASSERT_EQ(status, 0, ": should succeed");
+    ASSERT_EQ(exec->last_rusage_children, 0,
+              "Builtin should not account any children");
+
+    executor_free(exec);
+}
+
 /* ============================================================================
  * MAIN
  * ============================================================================ */
@@ -1435,6 +1557,7 @@ int main(void) {
     RUN_TEST(extended_test_regex_match);
     RUN_TEST(extended_test_and);
     RUN_TEST(extended_test_or);
+    RUN_TEST(extended_test_concatenated_operand);
     RUN_TEST(extended_test_pattern_match);
     
     printf("\nParameter expansion tests:\n");
@@ -1455,6 +1578,8 @@ int main(void) {
     printf("\nCommand substitution tests:\n");
     RUN_TEST(command_substitution_syntax);
     RUN_TEST(command_substitution_exit_status);
+    RUN_TEST(command_substitution_read_file);
+    RUN_TEST(command_substitution_read_file_word);
     
     printf("\nSpecial variable tests:\n");
     RUN_TEST(special_var_question_mark);
@@ -1479,6 +1604,10 @@ int main(void) {
     
     printf("\nLocal variable tests:\n");
     RUN_TEST(local_variable_in_function);
+
+    printf("\nResource accounting tests:\n");
+    RUN_TEST(rusage_external_command);
+    RUN_TEST(rusage_builtin_only);
     
     printf("\n========================================\n");
     printf("All executor integration tests PASSED!\n");
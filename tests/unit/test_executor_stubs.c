@@ -18,3 +18,21 @@ int parse_and_execute(const char *input) {
     if (!input || !current_executor) return 1;
     return executor_execute_command_line(current_executor, input);
 }
+
+/* Parse and execute through the parse cache - uses executor_execute_cached */
+int parse_and_execute_cached(const char *input) {
+    if (!input || !current_executor) return 1;
+    return executor_execute_cached(current_executor, input);
+}
+
+/* Execute a parsed tree - uses executor_execute_parsed */
+int execute_parsed(node_t *ast) {
+    if (!ast || !current_executor) return 1;
+    return executor_execute_parsed(current_executor, ast);
+}
+
+/* Parse without executing - uses executor_parse_command_line */
+node_t *parse_command_silently(const char *input) {
+    if (!input || !current_executor) return NULL;
+    return executor_parse_command_line(current_executor, input);
+}
@@ -0,0 +1,214 @@
+/**
+ * @file test_extended_test.c
+ * @brief Unit tests for compiled [[ ]] expressions
+ *
+ * Tests the extended test compiler including:
+ * - Operator precedence, grouping and negation
+ * - Expanding only operands that need it, one operand at a time
+ * - Regex matching with BASH_REMATCH
+ * - File and numeric tests
+ * - The parser attaching the compiled form to the node
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "extended_test.h"
+#include "node.h"
+#include "parser.h"
+#include "symtable.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Test framework macros */
+#define TEST(name) static void test_##name(void)
+#define RUN_TEST(name)                                                         \
+    do {                                                                       \
+        printf("  Running: %s...\n", #name);                                   \
+        test_##name();                                                         \
+        printf("    PASSED\n");                                                \
+    } while (0)
+
+#define ASSERT(condition, message)                                             \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_EQ(actual, expected, message)                                   \
+    do {                                                                       \
+        if ((actual) != (expected)) {                                          \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      Expected: %d, Got: %d\n", (int)(expected),           \
+                   (int)(actual));                                             \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+static int expansions;
+
+/**
+ * @brief Expand $x, $n and $v from fixed values; count the calls
+ */
+static char *fake_expand(void *ctx, const char *word) {
+    (void)ctx;
+    expansions++;
+    if (strcmp(word, "$x") == 0) {
+        return strdup("abc");
+    }
+    if (strcmp(word, "$n") == 0) {
+        return strdup("5");
+    }
+    if (strcmp(word, "$v") == 0) {
+        return strdup("a == b");
+    }
+    if (strcmp(word, "$e") == 0) {
+        return strdup("");
+    }
+    return strdup(word);
+}
+
+/**
+ * @brief Compile and evaluate an expression
+ */
+static bool eval(const char *expr) {
+    extended_test_t *test = extended_test_compile(expr);
+    ASSERT(test != NULL, "expression compiled");
+    expansions = 0;
+    bool result = extended_test_evaluate(test, fake_expand, NULL);
+    extended_test_free(test);
+    return result;
+}
+
+/* ============================================================================
+ * Expression Tests
+ * ============================================================================ */
+
+TEST(string_and_pattern_tests) {
+    ASSERT(eval("$x == abc"), "equal");
+    ASSERT(eval("$x == a*"), "glob pattern");
+    ASSERT(!eval("$x == a?"), "glob pattern mismatch");
+    ASSERT(eval("$x != b*"), "not matching");
+    ASSERT(eval("$x < abd") && !eval("$x > abd"), "string order");
+    ASSERT(eval("-n $x") && eval("-z $e"), "-n and -z");
+    ASSERT(eval("$x") && !eval("$e") && !eval(""), "bare words");
+}
+
+TEST(precedence_and_grouping) {
+    ASSERT(eval("$x == x && $n -eq 5 || $n -eq 5"), "&& binds tighter");
+    ASSERT(!eval("$x == x || $n -eq 5 && $n -eq 6"), "|| splits first");
+    ASSERT(!eval("! ( $x == abc )"), "negated group");
+    ASSERT(eval("! ( $x == nope )"), "negated false group");
+    ASSERT(eval("( $n -lt 3 ) || ( $n -gt 3 )"), "two groups");
+    ASSERT(eval("! ! $x"), "double negation");
+}
+
+TEST(numeric_tests) {
+    ASSERT(eval("$n -lt 10") && eval("$n -le 5") && eval("$n -ge 5"),
+           "comparisons");
+    ASSERT(eval("-5 -lt 2"), "negative literal");
+    ASSERT(eval("010 -eq 10"), "decimal literal");
+    ASSERT(!eval("$n -ne 5"), "not equal");
+}
+
+TEST(only_expanding_operands_are_expanded) {
+    ASSERT(eval("abc == abc && 1 -lt 2 && -d /"), "literal expression");
+    ASSERT_EQ(expansions, 0, "no expansion for literals");
+
+    ASSERT(eval("$x == abc"), "one expansion");
+    ASSERT_EQ(expansions, 1, "only the variable expanded");
+
+    /* The value is compared as a string, not read as an operator */
+    ASSERT(eval("$v == a*"), "value with == inside");
+    ASSERT(!eval("$v == a"), "whole value compared");
+}
+
+TEST(regex_match) {
+    ASSERT(eval("$x =~ ^a(b)c$"), "literal regex with groups");
+    ASSERT_EQ(expansions, 1, "anchor $ is not an expansion");
+
+    char *whole = symtable_get_array_element("BASH_REMATCH", "0");
+    char *group = symtable_get_array_element("BASH_REMATCH", "1");
+    ASSERT(whole && strcmp(whole, "abc") == 0, "match stored");
+    ASSERT(group && strcmp(group, "b") == 0, "group stored");
+    free(whole);
+    free(group);
+
+    ASSERT(!eval("$x =~ ^b"), "regex mismatch");
+    ASSERT(!eval("$x =~ a["), "invalid regex is false");
+
+    /* The compiled regex is reused across evaluations */
+    extended_test_t *test = extended_test_compile("$x =~ [bc]+");
+    for (int i = 0; i < 3; i++) {
+        ASSERT(extended_test_evaluate(test, fake_expand, NULL),
+               "repeated match");
+    }
+    extended_test_free(test);
+}
+
+TEST(file_tests) {
+    ASSERT(eval("-d /") && !eval("-f /"), "directory");
+    ASSERT(!eval("-e /nonexistent/file"), "missing file");
+    ASSERT(eval("/ -ef /"), "same file");
+    ASSERT(!eval("-v x"), "unknown operator is false");
+}
+
+TEST(parser_attaches_compiled_form) {
+    parser_t *parser = parser_new("[[ $x == abc ]]");
+    node_t *ast = parser_parse(parser);
+    ASSERT(ast != NULL, "parsed");
+
+    node_t *node = ast;
+    while (node && node->type != NODE_EXTENDED_TEST) {
+        node = node->first_child;
+    }
+    ASSERT(node != NULL, "extended test node found");
+    ASSERT(node->compiled != NULL, "compiled when parsed");
+    ASSERT(extended_test_evaluate(node->compiled, fake_expand, NULL),
+           "compiled form evaluates");
+
+    free_node_tree(ast);
+    parser_free(parser);
+}
+
+TEST(parser_keeps_adjacent_tokens_together) {
+    parser_t *parser = parser_new("[[ x$x == x${n}y ]]");
+    node_t *ast = parser_parse(parser);
+    ASSERT(ast != NULL, "parsed");
+
+    node_t *node = ast;
+    while (node && node->type != NODE_EXTENDED_TEST) {
+        node = node->first_child;
+    }
+    ASSERT(node != NULL, "extended test node found");
+    ASSERT(strcmp(node->val.str, "x$x == x${n}y") == 0,
+           "adjacent tokens form one operand");
+
+    free_node_tree(ast);
+    parser_free(parser);
+}
+
+int main(void) {
+    printf("\n=== Extended Test Tests ===\n\n");
+
+    init_symtable();
+
+    printf("Expression Tests:\n");
+    RUN_TEST(string_and_pattern_tests);
+    RUN_TEST(precedence_and_grouping);
+    RUN_TEST(numeric_tests);
+    RUN_TEST(only_expanding_operands_are_expanded);
+    RUN_TEST(regex_match);
+    RUN_TEST(file_tests);
+    RUN_TEST(parser_attaches_compiled_form);
+    RUN_TEST(parser_keeps_adjacent_tokens_together);
+
+    printf("\n=== All %d Extended Test Tests Passed ===\n\n", 8);
+    return 0;
+}
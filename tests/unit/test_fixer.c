@@ -446,6 +446,145 @@ TEST(fixer_apply_fixes_alloc) {
     fixer_cleanup(&ctx);
 }
 
+TEST(fixer_apply_fixes_skip_overlap) {
+    fixer_context_t ctx;
+    fixer_init(&ctx);
+    fixer_load_string(&ctx, "x=$(echo $(cat f))", "test.sh");
+    
+    fixer_fix_t outer = {0};
+    outer.match_start = 2;
+    outer.match_length = 16;
+    outer.replacement = "$(cat f)";
+    outer.type = FIX_TYPE_SAFE;
+    fixer_add_fix(&ctx, &outer);
+    
+    fixer_fix_t inner = {0};
+    inner.match_start = 9;
+    inner.match_length = 8;
+    inner.replacement = "$(<f)";
+    inner.type = FIX_TYPE_SAFE;
+    fixer_add_fix(&ctx, &inner);
+    
+    fixer_options_t opts = { .include_unsafe = false };
+    char output[256];
+    size_t applied = 0;
+    
+    fixer_result_t result = fixer_apply_fixes(&ctx, &opts, output,
+                                               sizeof(output), &applied);
+    
+    ASSERT_EQ(result, FIXER_OK, "apply_fixes should succeed");
+    ASSERT_EQ(applied, 1, "Overlapping fix should be skipped");
+    ASSERT_STR_EQ(output, "x=$(echo $(<f))", "Later fix should win");
+    
+    fixer_cleanup(&ctx);
+}
+
+TEST(fixer_collect_spawn_fixes_lush) {
+    fixer_context_t ctx;
+    fixer_init(&ctx);
+    fixer_load_string(&ctx,
+                      "for f in a b; do\n"
+                      "    data=$(cat \"$f\")\n"
+                      "    n=$(expr $n + 1)\n"
+                      "    b=$(basename \"$f\")\n"
+                      "done\n",
+                      "test.sh");
+    
+    size_t found = fixer_collect_spawn_fixes(&ctx, SHELL_MODE_LUSH);
+    ASSERT_EQ(found, 3, "Three rewrites expected");
+    ASSERT_EQ(fixer_count_safe(&ctx), 1, "cat rewrite is safe");
+    ASSERT_EQ(fixer_count_unsafe(&ctx), 2, "expr and basename are unsafe");
+    ASSERT_EQ(ctx.fixes[0].line, 2, "cat rewrite line");
+    ASSERT_EQ(ctx.fixes[0].column, 10, "cat rewrite column");
+    
+    fixer_options_t opts = { .include_unsafe = false };
+    char *output = NULL;
+    size_t applied = 0;
+    ASSERT_EQ(fixer_apply_fixes_alloc(&ctx, &opts, &output, &applied),
+              FIXER_OK, "apply should succeed");
+    ASSERT_EQ(applied, 1, "Safe rewrite applied");
+    ASSERT_STR_EQ(output,
+                  "for f in a b; do\n"
+                  "    data=$(<\"$f\")\n"
+                  "    n=$(expr $n + 1)\n"
+                  "    b=$(basename \"$f\")\n"
+                  "done\n",
+                  "Rewritten script mismatch");
+    ASSERT_TRUE(fixer_verify_syntax(output, SHELL_MODE_LUSH),
+                "Rewritten script should parse");
+    
+    free(output);
+    fixer_cleanup(&ctx);
+}
+
+TEST(fixer_collect_spawn_fixes_cat_targets) {
+    fixer_context_t ctx;
+    fixer_init(&ctx);
+    fixer_load_string(&ctx,
+                      "x=$(cat \"$dir\"/file)\n"
+                      "y=$(cat $dir/file)\n"
+                      "z=$(cat *.log)\n",
+                      "test.sh");
+    
+    /* cat sees split words and every glob match, a redirection does not */
+    size_t found = fixer_collect_spawn_fixes(&ctx, SHELL_MODE_LUSH);
+    ASSERT_EQ(found, 2, "No rewrite for a glob target");
+    ASSERT_EQ(fixer_count_safe(&ctx), 1, "Quoted target is safe");
+    ASSERT_EQ(fixer_count_unsafe(&ctx), 1, "Unquoted expansion is unsafe");
+    
+    fixer_options_t opts = { .include_unsafe = false };
+    char *output = NULL;
+    size_t applied = 0;
+    ASSERT_EQ(fixer_apply_fixes_alloc(&ctx, &opts, &output, &applied),
+              FIXER_OK, "apply should succeed");
+    ASSERT_EQ(applied, 1, "Only the safe rewrite applied");
+    ASSERT_STR_EQ(output,
+                  "x=$(<\"$dir\"/file)\n"
+                  "y=$(cat $dir/file)\n"
+                  "z=$(cat *.log)\n",
+                  "Rewritten script mismatch");
+    
+    free(output);
+    fixer_cleanup(&ctx);
+}
+
+TEST(fixer_collect_spawn_fixes_expr_status) {
+    const char *script = "i=3; while i=$(expr $i - 1); do echo $i; done\n";
+    fixer_context_t ctx;
+    fixer_init(&ctx);
+    fixer_load_string(&ctx, script, "test.sh");
+    
+    /* expr exits 1 when the result is 0 and ends the loop, $(( )) never
+     * fails, so the rewrite needs --unsafe */
+    size_t found = fixer_collect_spawn_fixes(&ctx, SHELL_MODE_LUSH);
+    ASSERT_EQ(found, 1, "expr rewrite offered");
+    ASSERT_EQ(fixer_count_safe(&ctx), 0, "expr rewrite is not safe");
+    ASSERT_EQ(fixer_count_unsafe(&ctx), 1, "expr rewrite is unsafe");
+    
+    fixer_options_t opts = { .include_unsafe = false };
+    char *output = NULL;
+    size_t applied = 0;
+    ASSERT_EQ(fixer_apply_fixes_alloc(&ctx, &opts, &output, &applied),
+              FIXER_OK, "apply should succeed");
+    ASSERT_EQ(applied, 0, "Nothing applied without --unsafe");
+    ASSERT_STR_EQ(output, script, "Loop condition unchanged");
+    
+    free(output);
+    fixer_cleanup(&ctx);
+}
+
+TEST(fixer_collect_spawn_fixes_posix) {
+    fixer_context_t ctx;
+    fixer_init(&ctx);
+    fixer_load_string(&ctx, "data=$(cat file)\n", "test.sh");
+    
+    /* $(<file) is not POSIX, so nothing can be applied */
+    size_t found = fixer_collect_spawn_fixes(&ctx, SHELL_MODE_POSIX);
+    ASSERT_EQ(found, 0, "No POSIX rewrite for $(cat file)");
+    
+    fixer_cleanup(&ctx);
+}
+
 /* ============================================================================
  * Syntax Verification Tests
  * ============================================================================ */
@@ -934,6 +1073,11 @@ int main(void) {
     RUN_TEST(fixer_apply_fixes_include_unsafe);
     RUN_TEST(fixer_apply_fixes_skip_manual);
     RUN_TEST(fixer_apply_fixes_alloc);
+    RUN_TEST(fixer_apply_fixes_skip_overlap);
+    RUN_TEST(fixer_collect_spawn_fixes_lush);
+    RUN_TEST(fixer_collect_spawn_fixes_cat_targets);
+    RUN_TEST(fixer_collect_spawn_fixes_expr_status);
+    RUN_TEST(fixer_collect_spawn_fixes_posix);
     
     printf("\nSyntax Verification:\n");
     RUN_TEST(fixer_verify_syntax_valid);
@@ -8,6 +8,7 @@
  * - String-to-float hash tables
  * - String-to-double hash tables
  * - Collision handling
+ * - Growth as entries are added
  * - Edge cases
  *
  * @author Michael Berry <trismegustis@gmail.com>
@@ -336,6 +337,46 @@ TEST(collision_handling) {
     ht_strstr_destroy(ht);
 }
 
+/** Calls made to counting_hash() */
+static size_t hash_calls = 0;
+
+static uint64_t counting_hash(const void *key, uint64_t seed) {
+    hash_calls++;
+    return fnv1a_hash_str(key, seed);
+}
+
+TEST(table_grows) {
+    /* Keys are not copied, so they must outlive the table */
+    static char keys[1000][16];
+    for (int i = 0; i < 1000; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "key_%d", i);
+    }
+
+    /* Hash calls made by one insert into a table that does not grow */
+    ht_t *ht = ht_create(counting_hash, str_eq, NULL, 0);
+    ASSERT_NOT_NULL(ht, "Table should be created");
+    hash_calls = 0;
+    ht_insert(ht, keys[0], keys[0]);
+    size_t per_insert = hash_calls;
+    ht_destroy(ht);
+
+    /* Growing rehashes the existing keys */
+    ht = ht_create(counting_hash, str_eq, NULL, 0);
+    ASSERT_NOT_NULL(ht, "Table should be created");
+    hash_calls = 0;
+    for (int i = 0; i < 1000; i++) {
+        ht_insert(ht, keys[i], keys[i]);
+    }
+    ASSERT(hash_calls > 1000 * per_insert,
+           "Table should rehash into more buckets");
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT(ht_get(ht, keys[i]) == keys[i],
+               "Every key should be found after growing");
+    }
+    ht_destroy(ht);
+}
+
 TEST(empty_key) {
     ht_strstr_t *ht = ht_strstr_create(HT_STR_NONE);
 
@@ -488,6 +529,7 @@ int main(void) {
 
     printf("\nEdge Cases:\n");
     RUN_TEST(collision_handling);
+    RUN_TEST(table_grows);
     RUN_TEST(empty_key);
     RUN_TEST(long_key);
     RUN_TEST(special_chars_in_key);
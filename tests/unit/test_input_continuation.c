@@ -747,6 +747,182 @@ TEST(semicolon_separates_commands) {
     ASSERT_TRUE(continuation_is_complete(&state), "Semicolon-separated commands should be complete");
 }
 
+/* ============================================================================
+ * INCREMENTAL ANALYZER TESTS
+ * ============================================================================ */
+
+/**
+ * @brief Compare the analyzer result with a one-shot analysis of text
+ */
+static void assert_matches_full(continuation_analyzer_t *analyzer,
+                                const char *text) {
+    continuation_state_t full;
+    continuation_state_init(&full);
+    continuation_analyze_line(text, &full);
+
+    const continuation_state_t *inc =
+        continuation_analyzer_update(analyzer, text);
+    ASSERT_NOT_NULL(inc, "Analyzer should return a state");
+    ASSERT_EQ(continuation_is_complete(inc), continuation_is_complete(&full),
+              "Incremental completeness should match full analysis");
+    ASSERT_EQ(inc->context_stack_depth, full.context_stack_depth,
+              "Context depth should match full analysis");
+    ASSERT_EQ(inc->in_here_doc, full.in_here_doc,
+              "Here document state should match full analysis");
+    ASSERT_STR_EQ(continuation_get_prompt(inc), continuation_get_prompt(&full),
+                  "Prompt should match full analysis");
+
+    continuation_state_cleanup(&full);
+}
+
+TEST(analyzer_matches_full_analysis_while_typing) {
+    const char *script = "f() {\n"
+                         "  for i in 1 2; do\n"
+                         "    echo \"$i\n"
+                         "    more\" | cat\n"
+                         "  done\n"
+                         "  cat <<EOF\n"
+                         "body\n"
+                         "EOF\n"
+                         "  x=$(echo \\\n"
+                         "  y)\n"
+                         "}\n";
+    continuation_analyzer_t analyzer;
+    continuation_analyzer_init(&analyzer);
+
+    /* Every prefix, as if typed one character at a time */
+    char buf[512];
+    size_t len = strlen(script);
+    for (size_t i = 0; i <= len; i++) {
+        memcpy(buf, script, i);
+        buf[i] = '\0';
+        assert_matches_full(&analyzer, buf);
+    }
+
+    continuation_analyzer_cleanup(&analyzer);
+}
+
+TEST(analyzer_resumes_after_unchanged_lines) {
+    continuation_analyzer_t analyzer;
+    continuation_analyzer_init(&analyzer);
+
+    char text[8192] = "while true; do\n";
+    for (int i = 0; i < 200; i++) {
+        strcat(text, "  echo line\n");
+    }
+    const continuation_state_t *st =
+        continuation_analyzer_update(&analyzer, text);
+    ASSERT_FALSE(continuation_is_complete(st), "Loop should be open");
+    ASSERT_EQ(analyzer.lines_scanned, 201, "First update scans every line");
+
+    strcat(text, "done");
+    st = continuation_analyzer_update(&analyzer, text);
+    ASSERT_TRUE(continuation_is_complete(st), "Loop should be closed");
+    ASSERT_EQ(analyzer.lines_scanned, 1, "Appending scans only the new line");
+
+    st = continuation_analyzer_update(&analyzer, text);
+    ASSERT_EQ(analyzer.lines_scanned, 0, "Unchanged text is not re-scanned");
+    ASSERT_TRUE(continuation_is_complete(st), "Cached result is reused");
+
+    continuation_analyzer_cleanup(&analyzer);
+}
+
+TEST(analyzer_rescans_from_first_changed_line) {
+    continuation_analyzer_t analyzer;
+    continuation_analyzer_init(&analyzer);
+
+    continuation_analyzer_update(&analyzer, "if true\nthen\n  a\n  b\nfi");
+    const continuation_state_t *st =
+        continuation_analyzer_update(&analyzer, "if true\nthen\n  a\n  c\nfi");
+    ASSERT_EQ(analyzer.lines_scanned, 2, "Edit on line four rescans two lines");
+    ASSERT_TRUE(continuation_is_complete(st), "Still complete");
+
+    /* Editing the first line invalidates everything after it */
+    st = continuation_analyzer_update(&analyzer, "if false\nthen\n  a\n  c\n");
+    ASSERT_EQ(analyzer.lines_scanned, 4, "First-line edit rescans all lines");
+    ASSERT_FALSE(continuation_is_complete(st), "fi was removed");
+
+    continuation_analyzer_cleanup(&analyzer);
+}
+
+TEST(analyzer_handles_shrinking_text) {
+    continuation_analyzer_t analyzer;
+    continuation_analyzer_init(&analyzer);
+
+    continuation_analyzer_update(&analyzer, "echo 'a\nb'\n");
+    assert_matches_full(&analyzer, "echo 'a\n");
+    assert_matches_full(&analyzer, "");
+    assert_matches_full(&analyzer, "case x in\n");
+
+    continuation_analyzer_cleanup(&analyzer);
+}
+
+TEST(analyzer_depth_for_new_lines) {
+    continuation_analyzer_t analyzer;
+    continuation_analyzer_init(&analyzer);
+
+    const char *text = "f() {\n"
+                       "    for x in a b; do\n"
+                       "        if true; then\n"
+                       "            echo $x\n"
+                       "        else\n"
+                       "fi";
+    continuation_analyzer_update(&analyzer, text);
+    int line_depth = 0;
+
+    size_t offset = strchr(text, '\n') - text;
+    ASSERT_EQ(continuation_analyzer_depth_at(&analyzer, offset, &line_depth),
+              1, "Body of f is one level in");
+    ASSERT_EQ(line_depth, 0, "f() { line stays at the left margin");
+
+    offset = strstr(text, "$x") - text + 2;
+    ASSERT_EQ(continuation_analyzer_depth_at(&analyzer, offset, &line_depth),
+              3, "Inside if, for and f");
+    ASSERT_EQ(line_depth, 3, "echo line depth");
+
+    offset = strstr(text, "else") - text + 4;
+    ASSERT_EQ(continuation_analyzer_depth_at(&analyzer, offset, &line_depth),
+              3, "else keeps the if open");
+    ASSERT_EQ(line_depth, 2, "else lines up with if");
+
+    offset = strlen(text);
+    ASSERT_EQ(continuation_analyzer_depth_at(&analyzer, offset, &line_depth),
+              2, "fi closes the if");
+    ASSERT_EQ(line_depth, 2, "fi lines up with if");
+
+    continuation_analyzer_cleanup(&analyzer);
+}
+
+TEST(analyzer_depth_not_inside_quotes) {
+    continuation_analyzer_t analyzer;
+    continuation_analyzer_init(&analyzer);
+
+    const char *text = "if true; then\n"
+                       "    cat <<EOF\n"
+                       "body";
+    continuation_analyzer_update(&analyzer, text);
+    int line_depth = 0;
+
+    size_t offset = strstr(text, "<<EOF") - text + 5;
+    ASSERT_EQ(continuation_analyzer_depth_at(&analyzer, offset, &line_depth),
+              -1, "No indent inside a here document");
+    ASSERT_EQ(line_depth, 1, "Here document command is indented");
+
+    offset = strlen(text);
+    continuation_analyzer_depth_at(&analyzer, offset, &line_depth);
+    ASSERT_EQ(line_depth, -1, "Here document body is left alone");
+
+    text = "if true; then\n"
+           "    echo 'a";
+    continuation_analyzer_update(&analyzer, text);
+    offset = strlen(text);
+    ASSERT_EQ(continuation_analyzer_depth_at(&analyzer, offset, &line_depth),
+              -1, "No indent inside a quote");
+    ASSERT_EQ(line_depth, 1, "Quote opens on an indented line");
+
+    continuation_analyzer_cleanup(&analyzer);
+}
+
 /* ============================================================================
  * MAIN
  * ============================================================================ */
@@ -848,6 +1024,14 @@ int main(void) {
     RUN_TEST(comment_line);
     RUN_TEST(quote_in_comment);
     RUN_TEST(semicolon_separates_commands);
+
+    printf("\n=== Incremental Analyzer Tests ===\n");
+    RUN_TEST(analyzer_matches_full_analysis_while_typing);
+    RUN_TEST(analyzer_resumes_after_unchanged_lines);
+    RUN_TEST(analyzer_rescans_from_first_changed_line);
+    RUN_TEST(analyzer_handles_shrinking_text);
+    RUN_TEST(analyzer_depth_for_new_lines);
+    RUN_TEST(analyzer_depth_not_inside_quotes);
     
     printf("\n=== All Input Continuation tests passed! ===\n");
     return 0;
@@ -0,0 +1,348 @@
+/**
+ * @file test_memo.c
+ * @brief Unit tests for the memo command output cache
+ *
+ * Tests the cache behind the memo builtin including:
+ * - Replaying cached output and exit status
+ * - Expiry after the time to live
+ * - Invalidation by variable values and file modification
+ * - Serving stale output during a background refresh, and reaping it
+ * - Eviction under entry and byte limits
+ * - Clearing entries and statistics
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "memo.h"
+#include "symtable.h"
+
+/* Test framework macros */
+#define TEST(name) static void test_##name(void)
+#define RUN_TEST(name)                                                         \
+    do {                                                                       \
+        printf("  Running: %s...\n", #name);                                   \
+        setup();                                                               \
+        test_##name();                                                         \
+        printf("    PASSED\n");                                                \
+    } while (0)
+
+#define ASSERT(condition, message)                                             \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_EQ(actual, expected, message)                                   \
+    do {                                                                       \
+        if ((actual) != (expected)) {                                          \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      Expected: %d, Got: %d\n", (int)(expected),           \
+                   (int)(actual));                                             \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_STR_EQ(actual, expected, message)                               \
+    do {                                                                       \
+        const char *a_ = (actual);                                             \
+        if (!a_ || strcmp(a_, (expected)) != 0) {                              \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      Expected: %s, Got: %s\n", (expected),                \
+                   a_ ? a_ : "(null)");                                        \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+/* Scratch directory for counter and dependency files */
+static char scratch[] = "/tmp/lush_memo_XXXXXX";
+static char counter[256];
+/* Room for the command text around two counter paths */
+static char script[2 * sizeof(counter) + 64];
+
+static void setup(void) {
+    memo_cleanup();
+    memo_set_limits(0, 0);
+    unlink(counter);
+}
+
+/**
+ * @brief Run a command through the cache and capture what it printed
+ */
+static int run(int argc, char *const *argv, const memo_options_t *opts,
+               char *out, size_t out_size) {
+    FILE *f = tmpfile();
+    int status = memo_run(argc, argv, opts, f);
+    rewind(f);
+    size_t n = fread(out, 1, out_size - 1, f);
+    out[n] = '\0';
+    fclose(f);
+    return status;
+}
+
+/* Command that counts its own runs and prints the count */
+static char *count_argv[] = {"sh", "-c", script, NULL};
+
+static int run_count(const memo_options_t *opts) {
+    char out[64];
+    run(3, count_argv, opts, out, sizeof(out));
+    return atoi(out);
+}
+
+static void sleep_ms(long ms) {
+    struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+/* ============================================================================
+ * Caching Tests
+ * ============================================================================ */
+
+TEST(caches_output_and_status) {
+    char *argv[] = {"sh", "-c", "echo cached; exit 3", NULL};
+    char out[64];
+
+    ASSERT_EQ(run(3, argv, NULL, out, sizeof(out)), 3, "first run status");
+    ASSERT_STR_EQ(out, "cached\n", "first run output");
+    ASSERT_EQ(run(3, argv, NULL, out, sizeof(out)), 3, "cached status");
+    ASSERT_STR_EQ(out, "cached\n", "cached output");
+
+    memo_stats_t st;
+    memo_get_stats(&st);
+    ASSERT_EQ(st.misses, 1, "one miss");
+    ASSERT_EQ(st.hits, 1, "one hit");
+    ASSERT_EQ(st.entries, 1, "one entry");
+    ASSERT_EQ(st.bytes, 7, "bytes counted");
+}
+
+TEST(argv_is_part_of_key) {
+    ASSERT_EQ(run_count(NULL), 1, "first run");
+    ASSERT_EQ(run_count(NULL), 1, "cached");
+
+    char *other[] = {"sh", "-c", script, "extra", NULL};
+    char out[64];
+    run(4, other, NULL, out, sizeof(out));
+    ASSERT_EQ(atoi(out), 2, "different argv runs again");
+}
+
+TEST(ttl_expires) {
+    memo_options_t opts = {.ttl = 0.2};
+    ASSERT_EQ(run_count(&opts), 1, "first run");
+    ASSERT_EQ(run_count(&opts), 1, "fresh within ttl");
+    sleep_ms(300);
+    ASSERT_EQ(run_count(&opts), 2, "re-run after ttl");
+}
+
+/* ============================================================================
+ * Invalidation Tests
+ * ============================================================================ */
+
+TEST(variable_invalidates) {
+    const char *vars[] = {"MEMO_TEST_VAR"};
+    memo_options_t opts = {.vars = vars, .var_count = 1};
+
+    symtable_unset_global("MEMO_TEST_VAR");
+    ASSERT_EQ(run_count(&opts), 1, "first run");
+    symtable_set_global("MEMO_TEST_VAR", "");
+    ASSERT_EQ(run_count(&opts), 2, "setting empty value invalidates");
+    ASSERT_EQ(run_count(&opts), 2, "unchanged value is cached");
+    symtable_set_global("MEMO_TEST_VAR", "prod");
+    ASSERT_EQ(run_count(&opts), 3, "changed value invalidates");
+
+    memo_stats_t st;
+    memo_get_stats(&st);
+    ASSERT_EQ(st.invalidations, 2, "invalidations counted");
+    ASSERT_EQ(st.entries, 1, "old entry replaced");
+}
+
+TEST(file_invalidates) {
+    char dep[300];
+    snprintf(dep, sizeof(dep), "%s/dep", scratch);
+    unlink(dep);
+    const char *files[] = {dep};
+    memo_options_t opts = {.files = files, .file_count = 1};
+
+    ASSERT_EQ(run_count(&opts), 1, "first run");
+    ASSERT_EQ(run_count(&opts), 1, "missing file cached");
+
+    FILE *f = fopen(dep, "w");
+    fputs("a", f);
+    fclose(f);
+    ASSERT_EQ(run_count(&opts), 2, "creating the file invalidates");
+    ASSERT_EQ(run_count(&opts), 2, "unchanged file cached");
+
+    f = fopen(dep, "a");
+    fputs("bc", f);
+    fclose(f);
+    ASSERT_EQ(run_count(&opts), 3, "modifying the file invalidates");
+
+    unlink(dep);
+    ASSERT_EQ(run_count(&opts), 4, "removing the file invalidates");
+}
+
+/* ============================================================================
+ * Background Refresh Tests
+ * ============================================================================ */
+
+TEST(async_serves_stale_then_refreshes) {
+    memo_options_t opts = {.ttl = 0.1, .async = true};
+    ASSERT_EQ(run_count(&opts), 1, "first run is synchronous");
+    sleep_ms(200);
+    ASSERT_EQ(run_count(&opts), 1, "stale value served");
+
+    /* Wait for the refresh to finish and be collected */
+    memo_stats_t st;
+    for (int i = 0; i < 100; i++) {
+        sleep_ms(20);
+        memo_poll();
+        FILE *f = fopen(counter, "r");
+        int runs = 0;
+        if (f) {
+            char line[32];
+            while (fgets(line, sizeof(line), f)) {
+                runs++;
+            }
+            fclose(f);
+        }
+        if (runs == 2) {
+            break;
+        }
+    }
+    sleep_ms(50);
+    memo_poll();
+    ASSERT(waitpid(-1, NULL, WNOHANG) == -1 && errno == ECHILD,
+           "refresh process reaped by the poll");
+
+    ASSERT_EQ(run_count(&opts), 2, "refreshed value served");
+    memo_get_stats(&st);
+    ASSERT_EQ(st.refreshes, 1, "one refresh");
+    ASSERT_EQ(st.stale_hits, 1, "one stale hit");
+}
+
+/* ============================================================================
+ * Limit Tests
+ * ============================================================================ */
+
+TEST(entry_limit_evicts_lru) {
+    memo_set_limits(2, 0);
+    char *a[] = {"echo", "a", NULL};
+    char *b[] = {"echo", "b", NULL};
+    char *c[] = {"echo", "c", NULL};
+    char out[16];
+
+    run(2, a, NULL, out, sizeof(out));
+    run(2, b, NULL, out, sizeof(out));
+    run(2, a, NULL, out, sizeof(out)); /* a is now most recent */
+    run(2, c, NULL, out, sizeof(out)); /* evicts b */
+
+    memo_stats_t st;
+    memo_get_stats(&st);
+    ASSERT_EQ(st.entries, 2, "capped at two");
+    ASSERT_EQ(st.evictions, 1, "one eviction");
+
+    run(2, a, NULL, out, sizeof(out));
+    memo_get_stats(&st);
+    ASSERT_EQ(st.hits, 2, "a still cached");
+    run(2, b, NULL, out, sizeof(out));
+    memo_get_stats(&st);
+    ASSERT_EQ(st.misses, 4, "b was evicted");
+}
+
+TEST(byte_limit) {
+    memo_set_limits(0, 8);
+    char *big[] = {"echo", "0123456789", NULL};
+    char *small[] = {"echo", "abc", NULL};
+    char out[32];
+
+    run(2, big, NULL, out, sizeof(out));
+    ASSERT_STR_EQ(out, "0123456789\n", "oversized output still printed");
+    memo_stats_t st;
+    memo_get_stats(&st);
+    ASSERT_EQ(st.entries, 0, "oversized output not cached");
+
+    run(2, small, NULL, out, sizeof(out));
+    run(2, small, NULL, out, sizeof(out));
+    memo_get_stats(&st);
+    ASSERT_EQ(st.entries, 1, "small output cached");
+    ASSERT_EQ(st.hits, 1, "small output hit");
+}
+
+TEST(clear_by_command) {
+    char *a[] = {"echo", "a", NULL};
+    char *ab[] = {"echo", "a", "b", NULL};
+    const char *vars[] = {"HOME"};
+    memo_options_t keyed = {.vars = vars, .var_count = 1};
+    char out[16];
+
+    run(2, a, NULL, out, sizeof(out));
+    run(2, a, &keyed, out, sizeof(out));
+    run(3, ab, NULL, out, sizeof(out));
+
+    ASSERT_EQ(memo_clear(2, a), 2, "both entries for echo a dropped");
+    memo_stats_t st;
+    memo_get_stats(&st);
+    ASSERT_EQ(st.entries, 1, "echo a b kept");
+    ASSERT_EQ(memo_clear(0, NULL), 1, "clear all");
+
+    memo_reset_stats();
+    memo_get_stats(&st);
+    ASSERT_EQ(st.misses, 0, "counters reset");
+}
+
+int main(void) {
+    printf("\n=== Memo Cache Tests ===\n\n");
+
+    if (!mkdtemp(scratch)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    snprintf(counter, sizeof(counter), "%s/count", scratch);
+    int len = snprintf(script, sizeof(script),
+                       "echo x >> '%s'; wc -l < '%s'", counter, counter);
+    if (len < 0 || (size_t)len >= sizeof(script)) {
+        fprintf(stderr, "counter script does not fit\n");
+        return 1;
+    }
+    init_symtable();
+
+    printf("Caching Tests:\n");
+    RUN_TEST(caches_output_and_status);
+    RUN_TEST(argv_is_part_of_key);
+    RUN_TEST(ttl_expires);
+
+    printf("\nInvalidation Tests:\n");
+    RUN_TEST(variable_invalidates);
+    RUN_TEST(file_invalidates);
+
+    printf("\nBackground Refresh Tests:\n");
+    RUN_TEST(async_serves_stale_then_refreshes);
+
+    printf("\nLimit Tests:\n");
+    RUN_TEST(entry_limit_evicts_lru);
+    RUN_TEST(byte_limit);
+    RUN_TEST(clear_by_command);
+
+    memo_cleanup();
+    char cmd[300];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", scratch);
+    if (system(cmd) != 0) {
+        printf("warning: could not remove %s\n", scratch);
+    }
+
+    printf("\n=== All %d Memo Cache Tests Passed ===\n\n", 9);
+    return 0;
+}
@@ -24,3 +24,7 @@ void error_syscall(const char *str) {
         perror(str);
     }
 }
+
+/* Extended test stub (from extended_test.c) */
+struct extended_test;
+void extended_test_free(struct extended_test *test) { (void)test; }
@@ -0,0 +1,214 @@
+/**
+ * @file test_parse_cache.c
+ * @brief Unit tests for the cache of parsed command strings
+ *
+ * Tests the parse cache including:
+ * - Parsing an identical string once and sharing its tree
+ * - Keying on source name and parser features
+ * - Strings that do not parse
+ * - Least recently used eviction within the memory limit
+ * - Entries held across eviction and clearing
+ * - Executing through executor_execute_cached()
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "executor.h"
+#include "node.h"
+#include "parse_cache.h"
+#include "shell_mode.h"
+#include "symtable.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Test framework macros */
+#define TEST(name) static void test_##name(void)
+#define RUN_TEST(name)                                                         \
+    do {                                                                       \
+        printf("  Running: %s...\n", #name);                                   \
+        setup();                                                               \
+        test_##name();                                                         \
+        printf("    PASSED\n");                                                \
+    } while (0)
+
+#define ASSERT(condition, message)                                             \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_EQ(actual, expected, message)                                   \
+    do {                                                                       \
+        if ((actual) != (expected)) {                                          \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      Expected: %d, Got: %d\n", (int)(expected),           \
+                   (int)(actual));                                             \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+static executor_t *executor;
+
+/**
+ * @brief Empty the cache and reset the counters and limit
+ */
+static void setup(void) {
+    parse_cache_set_limit(PARSE_CACHE_DEFAULT_MAX_BYTES);
+    parse_cache_clear();
+    parse_cache_reset_stats();
+    shell_mode_set(SHELL_MODE_LUSH);
+}
+
+static parse_cache_stats_t get_stats(void) {
+    parse_cache_stats_t stats;
+    parse_cache_get_stats(&stats);
+    return stats;
+}
+
+/* ============================================================================
+ * Cache Tests
+ * ============================================================================ */
+
+TEST(identical_string_parsed_once) {
+    parse_cache_entry_t *a = parse_cache_acquire("x=1; echo $x", NULL);
+    parse_cache_entry_t *b = parse_cache_acquire("x=1; echo $x", NULL);
+    ASSERT(a != NULL && b != NULL, "string parsed");
+    ASSERT(a == b, "same entry returned");
+    ASSERT(parse_cache_tree(a) == parse_cache_tree(b), "tree shared");
+
+    parse_cache_stats_t stats = get_stats();
+    ASSERT_EQ(stats.misses, 1, "parsed once");
+    ASSERT_EQ(stats.hits, 1, "second lookup hit");
+    ASSERT_EQ(stats.entries, 1, "one entry");
+
+    parse_cache_release(a);
+    parse_cache_release(b);
+    ASSERT_EQ(get_stats().entries, 1, "entry kept after release");
+}
+
+TEST(keyed_on_source_and_features) {
+    parse_cache_entry_t *a = parse_cache_acquire("echo hi", "<stdin>");
+    parse_cache_entry_t *b = parse_cache_acquire("echo hi", "trap");
+    ASSERT(a != b, "source name is part of the key");
+
+    node_t *tree = parse_cache_tree(b);
+    ASSERT(tree && tree->loc.filename &&
+               strcmp(tree->loc.filename, "trap") == 0,
+           "locations carry the source name");
+
+    shell_mode_set(SHELL_MODE_POSIX);
+    parse_cache_entry_t *c = parse_cache_acquire("echo hi", "<stdin>");
+    ASSERT(c != a, "other parser features parse again");
+    ASSERT_EQ(get_stats().misses, 3, "three parses");
+
+    parse_cache_release(a);
+    parse_cache_release(b);
+    parse_cache_release(c);
+}
+
+TEST(unparsable_and_empty_strings) {
+    ASSERT(parse_cache_acquire("echo \"open", NULL) == NULL,
+           "syntax error not returned");
+    ASSERT(parse_cache_acquire("", NULL) == NULL, "empty string");
+    parse_cache_stats_t stats = get_stats();
+    ASSERT_EQ(stats.failures, 1, "failure counted");
+    ASSERT_EQ(stats.entries, 0, "nothing cached");
+}
+
+TEST(lru_eviction_within_limit) {
+    parse_cache_entry_t *e = parse_cache_acquire("echo one", NULL);
+    size_t one = get_stats().bytes;
+    parse_cache_release(e);
+
+    /* Room for about three entries of this size */
+    parse_cache_set_limit(one * 3 + one / 2);
+    const char *texts[] = {"echo two", "echo six", "echo ten"};
+    for (int i = 0; i < 3; i++) {
+        /* Keep "echo one" recently used */
+        parse_cache_release(parse_cache_acquire("echo one", NULL));
+        parse_cache_release(parse_cache_acquire(texts[i], NULL));
+    }
+
+    parse_cache_stats_t stats = get_stats();
+    ASSERT_EQ(stats.entries, 3, "limit respected");
+    ASSERT_EQ(stats.evictions, 1, "one entry evicted");
+    ASSERT(stats.bytes <= parse_cache_get_limit(), "within the limit");
+
+    uint64_t misses = stats.misses;
+    parse_cache_release(parse_cache_acquire("echo one", NULL));
+    ASSERT_EQ(get_stats().misses, misses, "recently used entry kept");
+    parse_cache_release(parse_cache_acquire("echo two", NULL));
+    ASSERT_EQ(get_stats().misses, misses + 1, "least recent entry evicted");
+}
+
+TEST(held_entries_outlive_eviction) {
+    parse_cache_entry_t *held = parse_cache_acquire("A=held", NULL);
+    ASSERT_EQ(parse_cache_clear(), 1, "entry dropped");
+    ASSERT_EQ(get_stats().entries, 0, "table empty");
+
+    /* A fresh lookup parses again rather than reviving the dropped entry */
+    parse_cache_entry_t *fresh = parse_cache_acquire("A=held", NULL);
+    ASSERT(fresh != held, "new entry");
+
+    node_t *tree = parse_cache_tree(held);
+    ASSERT(tree != NULL && tree->type == parse_cache_tree(fresh)->type &&
+               strcmp(tree->val.str, parse_cache_tree(fresh)->val.str) == 0,
+           "held tree still valid");
+    parse_cache_release(held);
+    parse_cache_release(fresh);
+
+    /* With no room at all, entries are parsed and freed on release */
+    parse_cache_set_limit(0);
+    parse_cache_entry_t *e = parse_cache_acquire("A=held", NULL);
+    ASSERT(e != NULL && parse_cache_tree(e) != NULL, "parsed without cache");
+    ASSERT_EQ(get_stats().entries, 0, "nothing kept");
+    parse_cache_release(e);
+}
+
+TEST(execute_cached_reuses_parse) {
+    for (int i = 0; i < 5; i++) {
+        ASSERT_EQ(executor_execute_cached(executor, "N=$((N + 1))"), 0,
+                  "command executed");
+    }
+    char *value = symtable_get_global("N");
+    ASSERT(value && strcmp(value, "5") == 0, "executed every time");
+    free(value);
+
+    parse_cache_stats_t stats = get_stats();
+    ASSERT_EQ(stats.misses, 1, "parsed once");
+    ASSERT_EQ(stats.hits, 4, "reused afterwards");
+
+    /* Syntax errors still come back from the usual path */
+    ASSERT(executor_execute_cached(executor, "echo \"open") != 0,
+           "syntax error reported");
+}
+
+int main(void) {
+    printf("\n=== Parse Cache Tests ===\n\n");
+
+    init_symtable();
+    shell_mode_init();
+    executor = executor_new();
+    ASSERT(executor != NULL, "executor created");
+
+    printf("Cache Tests:\n");
+    RUN_TEST(identical_string_parsed_once);
+    RUN_TEST(keyed_on_source_and_features);
+    RUN_TEST(unparsable_and_empty_strings);
+    RUN_TEST(lru_eviction_within_limit);
+    RUN_TEST(held_entries_outlive_eviction);
+    RUN_TEST(execute_cached_reuses_parse);
+
+    setup();
+    executor_free(executor);
+
+    printf("\n=== All %d Parse Cache Tests Passed ===\n\n", 6);
+    return 0;
+}
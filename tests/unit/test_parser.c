@@ -308,6 +308,21 @@ TEST(parse_heredoc) {
     parser_free(parser);
 }
 
+TEST(parse_heredoc_repeated_delimiter_in_group) {
+    /* A second here document with the same delimiter inside one compound
+     * command must not rescan the first one */
+    parser_t *parser =
+        parser_new("{\n  cat << EOF\none\nEOF\n  cat << EOF\ntwo\nEOF\n}\n");
+    ASSERT_NOT_NULL(parser, "parser_new failed");
+    
+    node_t *ast = parser_parse(parser);
+    ASSERT_NOT_NULL(ast, "parser_parse should return AST");
+    ASSERT(!parser_has_error(parser), "Should not have parse error");
+    
+    free_node_tree(ast);
+    parser_free(parser);
+}
+
 TEST(parse_herestring) {
     parser_t *parser = parser_new("cat <<< 'hello world'");
     ASSERT_NOT_NULL(parser, "parser_new failed");
@@ -784,6 +799,7 @@ int main(void) {
     RUN_TEST(parse_redirect_stderr);
     RUN_TEST(parse_redirect_both);
     RUN_TEST(parse_heredoc);
+    RUN_TEST(parse_heredoc_repeated_delimiter_in_group);
     RUN_TEST(parse_herestring);
     RUN_TEST(parse_multiple_redirects);
     
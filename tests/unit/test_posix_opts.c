@@ -7,12 +7,14 @@
  * - Option query functions
  * - Option setting/unsetting
  * - is_posix_option_set() function
+ * - Positional parameters set with set --
  *
  * @author Michael Berry <trismegustis@gmail.com>
  * @copyright Copyright (C) 2021-2026 Michael Berry
  */
 
 #include "lush.h"
+#include "symtable.h"
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -39,7 +41,6 @@ extern bool is_pipefail_enabled(void);
 extern bool is_histexpand_enabled(void);
 extern bool is_history_enabled(void);
 extern bool is_interactive_comments_enabled(void);
-extern void print_command_trace(const char *command);
 
 /* Test framework macros */
 #define TEST(name) static void test_##name(void)
@@ -524,6 +525,49 @@ TEST(is_posix_option_set_invalid) {
     ASSERT_FALSE(is_posix_option_set('\0'), "null option should return false");
 }
 
+/* ============================================================================
+ * SET -- TESTS
+ * ============================================================================ */
+
+/**
+ * @brief Check that a positional parameter has a value (NULL for unset)
+ */
+static bool param_is(const char *name, const char *expected) {
+    char *value = symtable_get_global(name);
+    bool match = expected ? value && strcmp(value, expected) == 0 : !value;
+    free(value);
+    return match;
+}
+
+TEST(set_positional_beyond_99) {
+    /* set -- a1 .. a150 */
+    char *args[153];
+    static char words[150][8];
+    args[0] = "set";
+    args[1] = "--";
+    for (int i = 0; i < 150; i++) {
+        snprintf(words[i], sizeof(words[i]), "a%d", i + 1);
+        args[i + 2] = words[i];
+    }
+    args[152] = NULL;
+
+    ASSERT_EQ(builtin_set(args), 0, "set -- should succeed");
+    ASSERT_EQ(shell_argc, 151, "all parameters kept");
+    ASSERT_TRUE(strcmp(shell_argv[150], "a150") == 0, "shell_argv filled");
+    ASSERT_TRUE(param_is("100", "a100"), "$100 set");
+    ASSERT_TRUE(param_is("150", "a150"), "$150 set");
+    ASSERT_TRUE(param_is("#", "150"), "$# counts every parameter");
+
+    /* Replacing them frees every old parameter and clears $100 and up */
+    char *fewer[] = {"set", "--", "x", "y", NULL};
+    ASSERT_EQ(builtin_set(fewer), 0, "second set -- should succeed");
+    ASSERT_EQ(shell_argc, 3, "two parameters");
+    ASSERT_TRUE(param_is("2", "y"), "$2 replaced");
+    ASSERT_TRUE(param_is("3", NULL), "$3 cleared");
+    ASSERT_TRUE(param_is("150", NULL), "$150 cleared");
+    ASSERT_TRUE(param_is("#", "2"), "$# updated");
+}
+
 /* ============================================================================
  * MAIN TEST RUNNER
  * ============================================================================ */
@@ -575,6 +619,11 @@ int main(void) {
     RUN_TEST(is_posix_option_set_b);
     RUN_TEST(is_posix_option_set_invalid);
 
+    /* set -- tests */
+    printf("\n=== set -- Tests ===\n");
+    init_symtable();
+    RUN_TEST(set_positional_beyond_99);
+
     printf("\n=== All POSIX Options tests passed! ===\n");
     return 0;
 }
@@ -7,18 +7,22 @@
  * - Redirection node detection
  * - Redirection counting
  * - Error handling
+ * - Redirections onto closed descriptors through the executor
  *
  * @author Michael Berry <trismegustis@gmail.com>
  * @copyright Copyright (C) 2021-2026 Michael Berry
  */
 
 #include "redirection.h"
+#include "executor.h"
 #include "node.h"
+#include "symtable.h"
 #include <assert.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 /* Test framework macros */
@@ -72,65 +76,106 @@
  * FILE DESCRIPTOR SAVE/RESTORE TESTS
  * ============================================================================ */
 
+/**
+ * @brief Build a command node with one redirection child per type
+ */
+static node_t *command_with(int count, const node_type_t *types,
+                            const char *const *texts) {
+    node_t *cmd = new_node(NODE_COMMAND);
+    for (int i = 0; i < count; i++) {
+        node_t *redir = new_node(types[i]);
+        if (texts && texts[i]) {
+            set_node_val_str(redir, (char *)texts[i]);
+        }
+        add_child_node(cmd, redir);
+    }
+    return cmd;
+}
+
+static bool fd_is_open(int fd) {
+    return fcntl(fd, F_GETFD) != -1;
+}
+
 TEST(save_file_descriptors_basic) {
+    node_type_t types[] = {NODE_REDIR_OUT};
+    node_t *cmd = command_with(1, types, NULL);
     redirection_state_t state = {0};
 
-    int result = save_file_descriptors(&state);
+    int result = save_file_descriptors(&state, cmd);
     ASSERT_EQ(result, 0, "save_file_descriptors should succeed");
-
-    /* At least some FDs should be saved */
-    ASSERT(state.stdin_saved || state.stdout_saved || state.stderr_saved,
-           "At least one FD should be saved");
-
-    /* Clean up */
+    ASSERT_EQ(state.count, 1, "Only stdout should be saved");
+    ASSERT_EQ(state.fds[0], STDOUT_FILENO, "stdout saved");
+    ASSERT(state.saved[0] >= REDIRECTION_SAVE_FD_MIN,
+           "Copy should be above the reserved floor");
+    ASSERT(fcntl(state.saved[0], F_GETFD) & FD_CLOEXEC,
+           "Copy should be close-on-exec");
+
+    int copy = state.saved[0];
     restore_file_descriptors(&state);
+    ASSERT(!fd_is_open(copy), "Copy should be closed on restore");
+    free_node_tree(cmd);
 }
 
-TEST(save_file_descriptors_stdin) {
+TEST(save_file_descriptors_only_named) {
+    /* echo x >&2: stderr is untouched, only stdout changes */
+    node_type_t types[] = {NODE_REDIR_FD};
+    const char *texts[] = {">&2"};
+    node_t *cmd = command_with(1, types, texts);
     redirection_state_t state = {0};
 
-    int result = save_file_descriptors(&state);
-    ASSERT_EQ(result, 0, "save_file_descriptors should succeed");
-
-    if (state.stdin_saved) {
-        ASSERT(state.saved_stdin >= 0, "Saved stdin should be valid FD");
-    }
-
+    save_file_descriptors(&state, cmd);
+    ASSERT_EQ(state.count, 1, "One descriptor saved");
+    ASSERT_EQ(state.fds[0], STDOUT_FILENO, "stdout saved");
     restore_file_descriptors(&state);
+    free_node_tree(cmd);
 }
 
-TEST(save_file_descriptors_stdout) {
+TEST(save_file_descriptors_in_order_once) {
+    /* cmd 2>&1 &> file < input: 2, 1 then 0, each once */
+    node_type_t types[] = {NODE_REDIR_FD, NODE_REDIR_BOTH, NODE_REDIR_IN};
+    const char *texts[] = {"2>&1", NULL, NULL};
+    node_t *cmd = command_with(3, types, texts);
     redirection_state_t state = {0};
 
-    int result = save_file_descriptors(&state);
-    ASSERT_EQ(result, 0, "save_file_descriptors should succeed");
-
-    if (state.stdout_saved) {
-        ASSERT(state.saved_stdout >= 0, "Saved stdout should be valid FD");
-    }
-
+    save_file_descriptors(&state, cmd);
+    ASSERT_EQ(state.count, 3, "Three descriptors saved");
+    ASSERT_EQ(state.fds[0], STDERR_FILENO, "stderr first");
+    ASSERT_EQ(state.fds[1], STDOUT_FILENO, "then stdout");
+    ASSERT_EQ(state.fds[2], STDIN_FILENO, "then stdin");
     restore_file_descriptors(&state);
+    free_node_tree(cmd);
 }
 
-TEST(save_file_descriptors_stderr) {
+TEST(save_file_descriptors_none) {
+    node_t *cmd = new_node(NODE_COMMAND);
+    add_child_node(cmd, new_node(NODE_VAR));
+    node_type_t types[] = {NODE_REDIR_FD_ALLOC};
+    const char *texts[] = {"{fd}>"};
+    node_t *alloc = command_with(1, types, texts);
     redirection_state_t state = {0};
 
-    int result = save_file_descriptors(&state);
-    ASSERT_EQ(result, 0, "save_file_descriptors should succeed");
-
-    if (state.stderr_saved) {
-        ASSERT(state.saved_stderr >= 0, "Saved stderr should be valid FD");
-    }
+    ASSERT_EQ(save_file_descriptors(&state, cmd), 0, "No redirections");
+    ASSERT_EQ(state.count, 0, "Nothing saved");
+    ASSERT_EQ(save_file_descriptors(&state, NULL), 0, "NULL command");
+    ASSERT_EQ(state.count, 0, "Nothing saved for NULL");
+    save_file_descriptors(&state, alloc);
+    ASSERT_EQ(state.count, 0, "Allocated descriptors are not saved");
 
-    restore_file_descriptors(&state);
+    free_node_tree(cmd);
+    free_node_tree(alloc);
 }
 
 TEST(restore_file_descriptors_basic) {
+    node_type_t types[] = {NODE_REDIR_ERR};
+    const char *texts[] = {"2>"};
+    node_t *cmd = command_with(1, types, texts);
     redirection_state_t state = {0};
 
-    save_file_descriptors(&state);
+    save_file_descriptors(&state, cmd);
     int result = restore_file_descriptors(&state);
     ASSERT_EQ(result, 0, "restore_file_descriptors should succeed");
+    ASSERT_EQ(state.count, 0, "State emptied");
+    free_node_tree(cmd);
 }
 
 TEST(restore_file_descriptors_empty_state) {
@@ -141,39 +186,90 @@ TEST(restore_file_descriptors_empty_state) {
     ASSERT_EQ(result, 0, "restore empty state should succeed");
 }
 
-TEST(save_restore_preserves_fds) {
-    redirection_state_t state = {0};
+TEST(save_restore_high_fds) {
+    int devnull = open("/dev/null", O_WRONLY);
+    ASSERT(devnull >= 0, "open /dev/null");
 
-    /* Get original FDs */
-    int orig_stdin = dup(STDIN_FILENO);
-    int orig_stdout = dup(STDOUT_FILENO);
-    int orig_stderr = dup(STDERR_FILENO);
+    /* fd 7 is open, fd 8 is not */
+    dup2(devnull, 7);
+    close(8);
+    struct stat before;
+    fstat(7, &before);
 
-    save_file_descriptors(&state);
+    node_type_t types[] = {NODE_REDIR_ERR, NODE_REDIR_ERR_APPEND};
+    const char *texts[] = {"7>", "8>>"};
+    node_t *cmd = command_with(2, types, texts);
+    redirection_state_t state = {0};
+
+    save_file_descriptors(&state, cmd);
+    ASSERT_EQ(state.count, 2, "Both descriptors saved");
+    ASSERT_EQ(state.saved[1], -1, "Closed descriptor recorded as closed");
 
-    /* Verify we can still use standard FDs */
-    ASSERT(isatty(STDIN_FILENO) >= 0 || 1, "stdin should still work");
-    ASSERT(isatty(STDOUT_FILENO) >= 0 || 1, "stdout should still work");
-    ASSERT(isatty(STDERR_FILENO) >= 0 || 1, "stderr should still work");
+    int other = open("/dev/zero", O_RDONLY);
+    dup2(other, 7);
+    dup2(other, 8);
+    close(other);
 
     restore_file_descriptors(&state);
+    struct stat after;
+    ASSERT(fstat(7, &after) == 0 && after.st_ino == before.st_ino &&
+               after.st_dev == before.st_dev,
+           "Open descriptor restored");
+    ASSERT(!fd_is_open(8), "Closed descriptor closed again");
+
+    close(7);
+    close(devnull);
+    free_node_tree(cmd);
+}
 
-    /* Clean up our test dups */
-    close(orig_stdin);
-    close(orig_stdout);
-    close(orig_stderr);
+TEST(discard_keeps_redirection) {
+    int devnull = open("/dev/null", O_WRONLY);
+    dup2(devnull, 7);
+
+    node_type_t types[] = {NODE_REDIR_ERR};
+    const char *texts[] = {"7>"};
+    node_t *cmd = command_with(1, types, texts);
+    redirection_state_t state = {0};
+
+    save_file_descriptors(&state, cmd);
+    int copy = state.saved[0];
+    int other = open("/dev/zero", O_RDONLY);
+    dup2(other, 7);
+
+    /* exec: the new descriptor stays, the copy goes */
+    discard_saved_file_descriptors(&state);
+    struct stat now, zero;
+    fstat(7, &now);
+    fstat(other, &zero);
+    ASSERT(now.st_ino == zero.st_ino, "Redirection kept");
+    ASSERT(!fd_is_open(copy), "Copy closed");
+    ASSERT_EQ(state.count, 0, "State emptied");
+
+    close(other);
+    close(7);
+    close(devnull);
+    free_node_tree(cmd);
 }
 
 TEST(multiple_save_restore_cycles) {
+    node_type_t types[] = {NODE_REDIR_BOTH};
+    node_t *cmd = command_with(1, types, NULL);
+    int first_copy = -1;
+
     for (int i = 0; i < 5; i++) {
         redirection_state_t state = {0};
 
-        int result = save_file_descriptors(&state);
+        int result = save_file_descriptors(&state, cmd);
         ASSERT_EQ(result, 0, "save should succeed");
+        if (first_copy == -1) {
+            first_copy = state.saved[0];
+        }
+        ASSERT_EQ(state.saved[0], first_copy, "No descriptors leaked");
 
         result = restore_file_descriptors(&state);
         ASSERT_EQ(result, 0, "restore should succeed");
     }
+    free_node_tree(cmd);
 }
 
 /* ============================================================================
@@ -419,34 +515,84 @@ TEST(herestring_detection) {
  * FD MANAGEMENT EDGE CASES
  * ============================================================================ */
 
-TEST(save_with_closed_stdin) {
-    redirection_state_t state = {0};
+TEST(state_initialization) {
+    redirection_state_t state;
+    memset(&state, 0xFF, sizeof(state));  /* Fill with garbage */
 
-    /* This is tricky - we don't want to actually close stdin */
-    /* Just verify the API handles various states */
-    int result = save_file_descriptors(&state);
-    ASSERT_EQ(result, 0, "Should handle current FD state");
+    node_type_t types[] = {NODE_REDIR_IN};
+    node_t *cmd = command_with(1, types, NULL);
+
+    /* Saving initializes the state */
+    int result = save_file_descriptors(&state, cmd);
+    ASSERT_EQ(result, 0, "Should succeed with garbage state");
+    ASSERT_EQ(state.count, 1, "Only stdin saved");
 
     restore_file_descriptors(&state);
+    free_node_tree(cmd);
 }
 
-TEST(state_initialization) {
-    redirection_state_t state;
-    memset(&state, 0xFF, sizeof(state));  /* Fill with garbage */
+/* ============================================================================
+ * EXECUTOR TESTS
+ * ============================================================================ */
+
+/*
+ * With fd 3 closed, open() returns 3 itself; the redirection must keep it
+ * rather than duplicate it onto itself and close it.
+ */
 
-    /* Manually initialize */
-    state.saved_stdin = -1;
-    state.saved_stdout = -1;
-    state.saved_stderr = -1;
-    state.stdin_saved = false;
-    state.stdout_saved = false;
-    state.stderr_saved = false;
+static executor_t *executor;
 
-    /* Should be able to save now */
-    int result = save_file_descriptors(&state);
-    ASSERT_EQ(result, 0, "Should succeed with clean state");
+static char scratch_path[] = "/tmp/lush_redir_XXXXXX";
 
-    restore_file_descriptors(&state);
+/**
+ * @brief Read the scratch file into buf
+ */
+static const char *scratch_contents(char *buf, size_t size) {
+    buf[0] = '\0';
+    FILE *f = fopen(scratch_path, "r");
+    if (f) {
+        size_t n = fread(buf, 1, size - 1, f);
+        buf[n] = '\0';
+        fclose(f);
+    }
+    return buf;
+}
+
+static int run(const char *fmt) {
+    char command[256];
+    snprintf(command, sizeof(command), fmt, scratch_path, scratch_path);
+    fflush(stdout);
+    return executor_execute_command_line(executor, command);
+}
+
+TEST(exec_output_onto_closed_fd) {
+    char buf[64];
+    close(3);
+    ASSERT_EQ(run("exec 3>%s; echo hi >&3; exec 3>&-"), 0,
+              "exec 3>file succeeds");
+    ASSERT(strcmp(scratch_contents(buf, sizeof(buf)), "hi\n") == 0,
+           "output reached the file");
+    ASSERT(!fd_is_open(3), "fd 3 closed again");
+}
+
+TEST(exec_input_onto_closed_fd) {
+    close(3);
+    ASSERT_EQ(run("echo line >%s; exec 3<%s; read x <&3; exec 3<&-"), 0,
+              "exec 3<file succeeds");
+    char *x = symtable_get_global("x");
+    ASSERT(x && strcmp(x, "line") == 0, "read from fd 3");
+    free(x);
+    ASSERT(!fd_is_open(3), "fd 3 closed again");
+}
+
+TEST(group_output_onto_closed_fd) {
+    char buf[64];
+    close(3);
+    ASSERT_EQ(run("{ echo one >&3; echo two >&3; } 3>%s"), 0,
+              "group with 3>file succeeds");
+    ASSERT(strcmp(scratch_contents(buf, sizeof(buf)), "one\ntwo\n") == 0,
+           "both commands wrote to the file");
+    ASSERT(!fd_is_open(3), "fd 3 closed after the group");
 }
 
 /* ============================================================================
@@ -458,12 +604,13 @@ int main(void) {
 
     printf("File Descriptor Save/Restore Tests:\n");
     RUN_TEST(save_file_descriptors_basic);
-    RUN_TEST(save_file_descriptors_stdin);
-    RUN_TEST(save_file_descriptors_stdout);
-    RUN_TEST(save_file_descriptors_stderr);
+    RUN_TEST(save_file_descriptors_only_named);
+    RUN_TEST(save_file_descriptors_in_order_once);
+    RUN_TEST(save_file_descriptors_none);
     RUN_TEST(restore_file_descriptors_basic);
     RUN_TEST(restore_file_descriptors_empty_state);
-    RUN_TEST(save_restore_preserves_fds);
+    RUN_TEST(save_restore_high_fds);
+    RUN_TEST(discard_keeps_redirection);
     RUN_TEST(multiple_save_restore_cycles);
 
     printf("\nRedirection Node Detection Tests:\n");
@@ -495,9 +642,21 @@ int main(void) {
     RUN_TEST(herestring_detection);
 
     printf("\nFD Management Edge Cases:\n");
-    RUN_TEST(save_with_closed_stdin);
     RUN_TEST(state_initialization);
 
+    printf("\nExecutor Tests:\n");
+    init_symtable();
+    executor = executor_new();
+    ASSERT_NOT_NULL(executor, "executor created");
+    int fd = mkstemp(scratch_path);
+    ASSERT(fd != -1, "scratch file created");
+    close(fd);
+    RUN_TEST(exec_output_onto_closed_fd);
+    RUN_TEST(exec_input_onto_closed_fd);
+    RUN_TEST(group_output_onto_closed_fd);
+    unlink(scratch_path);
+    executor_free(executor);
+
     printf("\n=== All redirection.c tests passed! ===\n");
     return 0;
 }
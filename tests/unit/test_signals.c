@@ -14,6 +14,10 @@
  */
 
 #include "signals.h"
+#include "executor.h"
+#include "lush.h"
+#include "parse_cache.h"
+#include "symtable.h"
 #include <assert.h>
 #include <signal.h>
 #include <stdio.h>
@@ -105,7 +109,23 @@ TEST(get_signal_number_usr2) {
     ASSERT_EQ(sig, SIGUSR2, "USR2 should map to SIGUSR2");
 }
 
-/* Note: PIPE, ALRM, CHLD, CONT, STOP, TSTP signals not implemented in get_signal_number */
+TEST(get_signal_number_more_names) {
+    ASSERT_EQ(get_signal_number("CHLD"), SIGCHLD, "CHLD should map to SIGCHLD");
+    ASSERT_EQ(get_signal_number("SIGALRM"), SIGALRM,
+              "SIGALRM should map to SIGALRM");
+    ASSERT_EQ(get_signal_number("WINCH"), SIGWINCH,
+              "WINCH should map to SIGWINCH");
+    ASSERT_EQ(get_signal_number("SIGNOPE"), -1, "Unknown SIG name is -1");
+}
+
+TEST(get_signal_number_realtime) {
+    ASSERT_EQ(get_signal_number("RTMIN"), SIGRTMIN, "RTMIN");
+    ASSERT_EQ(get_signal_number("SIGRTMIN+2"), SIGRTMIN + 2, "RTMIN+2");
+    ASSERT_EQ(get_signal_number("RTMAX-1"), SIGRTMAX - 1, "RTMAX-1");
+    ASSERT_EQ(get_signal_number("RTMAX+1"), -1, "Beyond RTMAX is invalid");
+    ASSERT_EQ(get_signal_number("RTMIN-1"), -1, "RTMIN-1 is invalid");
+    ASSERT_EQ(get_signal_number("9999"), -1, "Out of range number");
+}
 
 TEST(get_signal_number_invalid) {
     int sig = get_signal_number("NOTASIGNAL");
@@ -199,6 +219,189 @@ TEST(list_traps) {
     remove_trap(SIGUSR2);
 }
 
+/* ============================================================================
+ * IN-PROCESS TRAP EXECUTION TESTS
+ * ============================================================================ */
+
+/**
+ * @brief Find the trap for a signal in the trap list
+ */
+static trap_entry_t *trap_for(int signo) {
+    for (trap_entry_t *t = trap_list; t; t = t->next) {
+        if (t->signal == signo) {
+            return t;
+        }
+    }
+    return NULL;
+}
+
+static char *var_value(const char *name) {
+    static char buf[64];
+    char *v = symtable_get_global(name);
+    snprintf(buf, sizeof(buf), "%s", v ? v : "");
+    free(v);
+    return buf;
+}
+
+TEST(trap_parsed_when_set) {
+    set_trap(SIGUSR1, "echo parsed");
+    trap_entry_t *t = trap_for(SIGUSR1);
+    ASSERT_NOT_NULL(t, "Trap should be listed");
+    ASSERT_NOT_NULL(t->parsed, "Command should be parsed at set time");
+    ASSERT_NOT_NULL(parse_cache_tree(t->parsed), "Parsed command has a tree");
+    remove_trap(SIGUSR1);
+
+    set_trap(SIGUSR1, "echo \"open");
+    t = trap_for(SIGUSR1);
+    ASSERT_NOT_NULL(t, "Unparsable trap is still set");
+    ASSERT(t->parsed == NULL, "Unparsable command keeps no parse");
+    remove_trap(SIGUSR1);
+}
+
+TEST(trap_runs_in_shell_context) {
+    executor_t *exec = executor_new();
+    ASSERT_NOT_NULL(exec, "executor");
+    current_executor = exec;
+
+    symtable_set_global("TRAP_SEEN", "before");
+    set_trap(SIGUSR1, "TRAP_SEEN=\"$TRAP_SEEN-after\"; false");
+    set_exit_status(7);
+
+    raise(SIGUSR1);
+    ASSERT(traps_pending(), "Signal should be pending");
+    execute_pending_traps();
+    ASSERT(!traps_pending(), "Nothing pending after running");
+    ASSERT(strcmp(var_value("TRAP_SEEN"), "before-after") == 0,
+           "Trap should read and set shell variables");
+    ASSERT_EQ(last_exit_status, 7, "$? should be preserved across the trap");
+
+    /* The cached AST runs again on the next delivery (builtins clear the
+     * stubbed global executor, so point it at the executor again) */
+    current_executor = exec;
+    raise(SIGUSR1);
+    execute_pending_traps();
+    ASSERT(strcmp(var_value("TRAP_SEEN"), "before-after-after") == 0,
+           "Trap should run from its cached AST again");
+
+    remove_trap(SIGUSR1);
+    current_executor = NULL;
+    executor_free(exec);
+}
+
+TEST(trap_keeps_interrupted_error) {
+    executor_t *exec = executor_new();
+    current_executor = exec;
+
+    /* The command the trap ran after failed; its error is still to be
+     * printed by the caller once the trap is done */
+    const char *message = "command failed";
+    exec->has_error = true;
+    exec->error_message = message;
+
+    set_trap(SIGUSR1, "ERR_TRAP_RAN=1");
+    raise(SIGUSR1);
+    execute_pending_traps();
+    ASSERT(strcmp(var_value("ERR_TRAP_RAN"), "1") == 0, "Trap should run");
+    ASSERT(executor_has_error(exec), "Error flag should survive the trap");
+    ASSERT(executor_error(exec) == message,
+           "Error message should survive the trap");
+
+    remove_trap(SIGUSR1);
+    current_executor = NULL;
+    executor_free(exec);
+}
+
+TEST(trap_signal_during_own_run_runs_again) {
+    executor_t *exec = executor_new();
+    current_executor = exec;
+
+    /* The first run sends the signal again while the trap is running
+     * (no builtins, which clear the stubbed global executor) */
+    char command[160];
+    snprintf(command, sizeof(command),
+             "USR1_RUNS=\"${USR1_RUNS}x\"; "
+             "case $USR1_RUNS in x) /bin/kill -USR1 %ld ;; esac",
+             (long)getpid());
+    set_trap(SIGUSR1, command);
+    raise(SIGUSR1);
+    execute_pending_traps();
+    ASSERT(strcmp(var_value("USR1_RUNS"), "xx") == 0,
+           "Signal delivered during the trap should run it again");
+
+    remove_trap(SIGUSR1);
+    current_executor = NULL;
+    executor_free(exec);
+}
+
+TEST(chld_trap_not_retriggered_by_own_commands) {
+    executor_t *exec = executor_new();
+    current_executor = exec;
+
+    set_trap(SIGCHLD, "CHLD_RUNS=\"${CHLD_RUNS}x\"; /bin/true");
+    raise(SIGCHLD);
+    execute_pending_traps();
+    ASSERT(strcmp(var_value("CHLD_RUNS"), "x") == 0,
+           "Children the trap waited for should not retrigger it");
+
+    remove_trap(SIGCHLD);
+    current_executor = NULL;
+    executor_free(exec);
+}
+
+TEST(trap_realtime_signal) {
+    executor_t *exec = executor_new();
+    current_executor = exec;
+
+    int signo = SIGRTMIN + 1;
+    ASSERT_EQ(set_trap(signo, "RT_SEEN=yes"), 0, "RT trap should be settable");
+    raise(signo);
+    execute_pending_traps();
+    ASSERT(strcmp(var_value("RT_SEEN"), "yes") == 0,
+           "Real-time signal trap should run");
+
+    remove_trap(signo);
+    current_executor = NULL;
+    executor_free(exec);
+}
+
+TEST(trap_removed_by_own_handler) {
+    executor_t *exec = executor_new();
+    current_executor = exec;
+
+    set_trap(SIGUSR2, "trap - USR2; SELF_REMOVED=1");
+    raise(SIGUSR2);
+    execute_pending_traps();
+    ASSERT(trap_for(SIGUSR2) == NULL, "Trap should be gone");
+    ASSERT(strcmp(var_value("SELF_REMOVED"), "1") == 0,
+           "Handler should finish after removing itself");
+
+    current_executor = NULL;
+    executor_free(exec);
+}
+
+TEST(trap_empty_ignores_signal) {
+    ASSERT_EQ(set_trap(SIGUSR2, ""), 0, "Ignoring should succeed");
+    raise(SIGUSR2);
+    ASSERT(!traps_pending(), "Ignored signal is not pending");
+    remove_trap(SIGUSR2);
+}
+
+TEST(trap_uncatchable_rejected) {
+    ASSERT_EQ(set_trap(SIGKILL, "echo no"), -1, "SIGKILL cannot be trapped");
+    ASSERT(trap_for(SIGKILL) == NULL, "No entry for SIGKILL");
+}
+
+TEST(remove_trap_restores_handler) {
+    struct sigaction before;
+    sigaction(SIGINT, NULL, &before);
+    set_trap(SIGINT, "echo int");
+    remove_trap(SIGINT);
+    struct sigaction after;
+    sigaction(SIGINT, NULL, &after);
+    ASSERT(before.sa_handler == after.sa_handler,
+           "Previous SIGINT handler should be restored");
+}
+
 /* ============================================================================
  * CHILD PROCESS TRACKING TESTS
  * ============================================================================ */
@@ -326,7 +529,8 @@ int main(void) {
     /* get_signal_number_kill removed - KILL not implemented */
     RUN_TEST(get_signal_number_usr1);
     RUN_TEST(get_signal_number_usr2);
-    /* PIPE, ALRM, CHLD, CONT, STOP, TSTP tests removed - not implemented */
+    RUN_TEST(get_signal_number_more_names);
+    RUN_TEST(get_signal_number_realtime);
     RUN_TEST(get_signal_number_invalid);
     RUN_TEST(get_signal_number_empty);
     RUN_TEST(get_signal_number_lowercase);
@@ -341,6 +545,19 @@ int main(void) {
     RUN_TEST(set_trap_exit);
     RUN_TEST(list_traps);
 
+    printf("\nIn-Process Trap Execution Tests:\n");
+    init_symtable();
+    RUN_TEST(trap_parsed_when_set);
+    RUN_TEST(trap_runs_in_shell_context);
+    RUN_TEST(trap_keeps_interrupted_error);
+    RUN_TEST(trap_signal_during_own_run_runs_again);
+    RUN_TEST(chld_trap_not_retriggered_by_own_commands);
+    RUN_TEST(trap_realtime_signal);
+    RUN_TEST(trap_removed_by_own_handler);
+    RUN_TEST(trap_empty_ignores_signal);
+    RUN_TEST(trap_uncatchable_rejected);
+    RUN_TEST(remove_trap_restores_handler);
+
     printf("\nChild Process Tracking Tests:\n");
     RUN_TEST(set_clear_child_pid);
     RUN_TEST(clear_child_pid_without_set);
@@ -0,0 +1,358 @@
+/**
+ * @file test_spawn_cost.c
+ * @brief Unit tests for the process spawn cost analysis
+ *
+ * Tests the spawn cost module including:
+ * - Spawn estimates for commands, pipelines and substitutions
+ * - Loop weighting and per-function totals
+ * - Idiom detection and rewrites
+ * - Source locations of repeated constructs
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "spawn_cost.h"
+#include "node.h"
+#include "parser.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * Test Framework
+ * ============================================================================ */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) static void test_##name(void)
+
+#define RUN_TEST(name)                                                         \
+    do {                                                                       \
+        tests_run++;                                                           \
+        int _prev_failed = tests_failed;                                       \
+        printf("  Running %s...", #name);                                      \
+        fflush(stdout);                                                        \
+        test_##name();                                                         \
+        if (tests_failed == _prev_failed) {                                    \
+            printf(" PASSED\n");                                               \
+            tests_passed++;                                                    \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT(cond, msg)                                                      \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf(" FAILED: %s\n", msg);                                      \
+            tests_failed++;                                                    \
+            return;                                                            \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_NOT_NULL(ptr, msg) ASSERT((ptr) != NULL, msg)
+#define ASSERT_NULL(ptr, msg) ASSERT((ptr) == NULL, msg)
+#define ASSERT_TRUE(val, msg) ASSERT((val) == true, msg)
+#define ASSERT_EQ(a, b, msg) ASSERT((a) == (b), msg)
+#define ASSERT_STR_EQ(a, b, msg) ASSERT(strcmp((a), (b)) == 0, msg)
+
+/* ============================================================================
+ * Test Helpers
+ * ============================================================================ */
+
+/**
+ * @brief Parse a script and run the spawn analysis on it
+ */
+static bool analyze(const char *script, shell_mode_t target,
+                    spawn_report_t *report) {
+    parser_t *parser = parser_new(script);
+    if (!parser) {
+        return false;
+    }
+    node_t *ast = parser_parse(parser);
+    bool ok = ast && spawn_analyze(script, ast, target, report);
+    if (ast) {
+        free_node_tree(ast);
+    }
+    parser_free(parser);
+    return ok;
+}
+
+/**
+ * @brief Find the first site of an idiom
+ */
+static const spawn_site_t *find_site(const spawn_report_t *report,
+                                     spawn_idiom_t idiom) {
+    for (size_t i = 0; i < report->site_count; i++) {
+        if (report->sites[i].idiom == idiom) {
+            return &report->sites[i];
+        }
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ * Spawn Estimate Tests
+ * ============================================================================ */
+
+TEST(builtins_do_not_spawn) {
+    spawn_report_t report;
+    ASSERT_TRUE(analyze("echo hi; x=1; cd /tmp\n", SHELL_MODE_POSIX, &report),
+                "analysis should succeed");
+    ASSERT_EQ(report.toplevel_spawns, 0, "builtins should not spawn");
+    spawn_report_free(&report);
+}
+
+TEST(external_commands_spawn) {
+    spawn_report_t report;
+    ASSERT_TRUE(analyze("ls /tmp\nsort a | uniq\n", SHELL_MODE_POSIX, &report),
+                "analysis should succeed");
+    /* ls, plus one process per pipeline stage */
+    ASSERT_EQ(report.toplevel_spawns, 3, "expected 3 spawns");
+    spawn_report_free(&report);
+}
+
+TEST(substitution_counts_subshell) {
+    spawn_report_t report;
+    ASSERT_TRUE(analyze("x=$(pwd)\ny=$(ls)\n", SHELL_MODE_POSIX, &report),
+                "analysis should succeed");
+    /* $(pwd) forks once; $(ls) forks and then runs ls */
+    ASSERT_EQ(report.toplevel_spawns, 3, "expected 3 spawns");
+    spawn_report_free(&report);
+}
+
+TEST(script_functions_do_not_spawn) {
+    spawn_report_t report;
+    ASSERT_TRUE(analyze("main\nmain() { helper; }\nhelper() { :; }\n",
+                        SHELL_MODE_POSIX, &report),
+                "analysis should succeed");
+    ASSERT_EQ(report.toplevel_spawns, 0, "calls to script functions are free");
+    ASSERT_EQ(report.function_count, 2, "two functions expected");
+    ASSERT_EQ(report.functions[0].weighted_spawns, 0, "main is free");
+    spawn_report_free(&report);
+}
+
+TEST(loops_are_weighted) {
+    spawn_report_t report;
+    ASSERT_TRUE(analyze("f() {\n"
+                        "    ls\n"
+                        "    for a in $(ls); do\n"
+                        "        while true; do\n"
+                        "            date\n"
+                        "        done\n"
+                        "    done\n"
+                        "}\n",
+                        SHELL_MODE_POSIX, &report),
+                "analysis should succeed");
+    ASSERT_EQ(report.function_count, 1, "one function expected");
+    ASSERT_STR_EQ(report.functions[0].name, "f", "function name");
+    ASSERT_EQ(report.functions[0].line, 1, "function line");
+    /* ls + $(ls) runs once; date runs at depth 2 */
+    unsigned long expected =
+        1 + 2 + SPAWN_LOOP_WEIGHT * SPAWN_LOOP_WEIGHT;
+    ASSERT_EQ(report.functions[0].weighted_spawns, expected,
+              "loop weighting mismatch");
+    ASSERT_EQ(report.toplevel_spawns, 0, "nothing at top level");
+    spawn_report_free(&report);
+}
+
+/* ============================================================================
+ * Idiom Tests
+ * ============================================================================ */
+
+TEST(cat_substitution_rewrite) {
+    const char *script = "data=$(cat \"$f\")\n";
+    spawn_report_t report;
+
+    ASSERT_TRUE(analyze(script, SHELL_MODE_LUSH, &report),
+                "analysis should succeed");
+    const spawn_site_t *site = find_site(&report, SPAWN_IDIOM_CAT_SUBST);
+    ASSERT_NOT_NULL(site, "cat idiom should be found");
+    ASSERT_EQ(site->spawns, 2, "fork plus cat");
+    ASSERT_EQ(site->line, 1, "line");
+    ASSERT_EQ(site->offset, 5, "offset");
+    ASSERT_STR_EQ(site->original, "$(cat \"$f\")", "original text");
+    ASSERT_NOT_NULL(site->replacement, "rewrite expected");
+    ASSERT_STR_EQ(site->replacement, "$(<\"$f\")", "rewrite text");
+    ASSERT_EQ(site->fix_type, FIX_TYPE_SAFE, "safe for lush");
+    spawn_report_free(&report);
+
+    /* $(<file) is not POSIX, so the rewrite becomes manual */
+    ASSERT_TRUE(analyze(script, SHELL_MODE_POSIX, &report),
+                "analysis should succeed");
+    site = find_site(&report, SPAWN_IDIOM_CAT_SUBST);
+    ASSERT_NOT_NULL(site, "cat idiom should be found");
+    ASSERT_EQ(site->fix_type, FIX_TYPE_MANUAL, "manual for posix");
+    spawn_report_free(&report);
+
+    /* A glob can name several files, which a redirection rejects */
+    ASSERT_TRUE(analyze("data=$(cat *.log)\n", SHELL_MODE_LUSH, &report),
+                "analysis should succeed");
+    site = find_site(&report, SPAWN_IDIOM_CAT_SUBST);
+    ASSERT_NOT_NULL(site, "cat idiom should be found");
+    ASSERT_NULL(site->replacement, "no rewrite for a glob");
+    spawn_report_free(&report);
+}
+
+TEST(basename_dirname_rewrite) {
+    spawn_report_t report;
+    ASSERT_TRUE(analyze("b=$(basename \"$path\")\nd=`dirname ${path}`\n",
+                        SHELL_MODE_POSIX, &report),
+                "analysis should succeed");
+    const spawn_site_t *site = find_site(&report, SPAWN_IDIOM_BASENAME);
+    ASSERT_NOT_NULL(site, "basename idiom should be found");
+    ASSERT_STR_EQ(site->replacement, "${path##*/}", "basename rewrite");
+    ASSERT_EQ(site->fix_type, FIX_TYPE_UNSAFE, "basename rewrite is unsafe");
+
+    site = find_site(&report, SPAWN_IDIOM_DIRNAME);
+    ASSERT_NOT_NULL(site, "dirname idiom should be found");
+    ASSERT_EQ(site->line, 2, "dirname line");
+    ASSERT_STR_EQ(site->original, "`dirname ${path}`", "backquote original");
+    ASSERT_STR_EQ(site->replacement, "${path%/*}", "dirname rewrite");
+    spawn_report_free(&report);
+}
+
+TEST(expr_rewrite) {
+    spawn_report_t report;
+    ASSERT_TRUE(analyze("n=$(expr $n \\* 2 + 1)\nm=$(expr \"$s\" : 'a')\n",
+                        SHELL_MODE_POSIX, &report),
+                "analysis should succeed");
+    ASSERT_EQ(report.site_count, 2, "two expr sites");
+    ASSERT_NOT_NULL(report.sites[0].replacement, "arithmetic rewrite");
+    ASSERT_STR_EQ(report.sites[0].replacement, "$(($n * 2 + 1))",
+                  "expr rewrite");
+    ASSERT_EQ(report.sites[0].fix_type, FIX_TYPE_UNSAFE,
+              "exit status and octal operands differ");
+    ASSERT_NULL(report.sites[1].replacement, "string match has no rewrite");
+    ASSERT_EQ(report.sites[1].fix_type, FIX_TYPE_MANUAL, "manual");
+    spawn_report_free(&report);
+}
+
+TEST(echo_grep_rewrite) {
+    const char *script = "if echo \"$line\" | grep -q needle; then :; fi\n";
+    spawn_report_t report;
+
+    ASSERT_TRUE(analyze(script, SHELL_MODE_BASH, &report),
+                "analysis should succeed");
+    const spawn_site_t *site = find_site(&report, SPAWN_IDIOM_ECHO_GREP);
+    ASSERT_NOT_NULL(site, "echo | grep idiom should be found");
+    ASSERT_EQ(site->spawns, 2, "two pipeline stages");
+    ASSERT_STR_EQ(site->original, "echo \"$line\" | grep -q needle",
+                  "pipeline text");
+    ASSERT_STR_EQ(site->replacement, "[[ \"$line\" =~ needle ]]",
+                  "pipeline rewrite");
+    spawn_report_free(&report);
+
+    /* Regex metacharacters differ between grep and =~ */
+    ASSERT_TRUE(analyze("echo \"$x\" | grep -q '^a.*b$'\n", SHELL_MODE_BASH,
+                        &report),
+                "analysis should succeed");
+    site = find_site(&report, SPAWN_IDIOM_ECHO_GREP);
+    ASSERT_NOT_NULL(site, "echo | grep idiom should be found");
+    ASSERT_NULL(site->replacement, "no rewrite for regex patterns");
+    spawn_report_free(&report);
+}
+
+TEST(echo_substitution_rewrite) {
+    spawn_report_t report;
+    ASSERT_TRUE(analyze("a=$(echo done)\nb=\"x $(echo \"$v\")\"\n"
+                        "set -- $(echo $v w)\n",
+                        SHELL_MODE_POSIX, &report),
+                "analysis should succeed");
+    ASSERT_EQ(report.site_count, 3, "three echo sites");
+    ASSERT_STR_EQ(report.sites[0].replacement, "done", "literal rewrite");
+    ASSERT_EQ(report.sites[0].fix_type, FIX_TYPE_SAFE, "literal is safe");
+    ASSERT_STR_EQ(report.sites[1].replacement, "\"$v\"", "quoted rewrite");
+    ASSERT_EQ(report.sites[1].fix_type, FIX_TYPE_UNSAFE,
+              "expansions may split differently");
+    ASSERT_NULL(report.sites[2].replacement, "several words are not rewritten");
+    spawn_report_free(&report);
+}
+
+TEST(repeated_constructs_are_located) {
+    spawn_report_t report;
+    ASSERT_TRUE(analyze("for f in a b; do\n"
+                        "    x=$(cat \"$f\")\n"
+                        "    y=$(cat \"$f\")\n"
+                        "done\n",
+                        SHELL_MODE_LUSH, &report),
+                "analysis should succeed");
+    ASSERT_EQ(report.site_count, 2, "two sites");
+    ASSERT_EQ(report.sites[0].line, 2, "first line");
+    ASSERT_EQ(report.sites[1].line, 3, "second line");
+    ASSERT_EQ(report.sites[0].loop_depth, 1, "inside the loop");
+    ASSERT_EQ(report.sites[0].weight, 2 * SPAWN_LOOP_WEIGHT, "loop weight");
+    spawn_report_free(&report);
+}
+
+TEST(quoted_text_is_ignored) {
+    spawn_report_t report;
+    ASSERT_TRUE(analyze("echo '$(cat f)'\ncat <<'EOF'\n$(cat g)\nEOF\n",
+                        SHELL_MODE_LUSH, &report),
+                "analysis should succeed");
+    ASSERT_EQ(report.site_count, 0, "quoted substitutions do not run");
+    ASSERT_EQ(report.toplevel_spawns, 1, "only the heredoc cat runs");
+    spawn_report_free(&report);
+}
+
+/* ============================================================================
+ * Budget Tests
+ * ============================================================================ */
+
+TEST(budget_default_and_reset) {
+    ASSERT_EQ(spawn_get_budget(), SPAWN_DEFAULT_BUDGET, "default budget");
+    spawn_set_budget(5);
+    ASSERT_EQ(spawn_get_budget(), 5, "budget set");
+    spawn_set_budget(0);
+    ASSERT_EQ(spawn_get_budget(), SPAWN_DEFAULT_BUDGET, "0 restores default");
+}
+
+TEST(null_arguments) {
+    spawn_report_t report;
+    ASSERT(!spawn_analyze("x", NULL, SHELL_MODE_POSIX, NULL),
+           "NULL report should fail");
+    ASSERT_TRUE(spawn_analyze(NULL, NULL, SHELL_MODE_POSIX, &report),
+                "NULL AST is an empty report");
+    ASSERT_EQ(report.site_count, 0, "no sites");
+    spawn_report_free(&report);
+    spawn_report_free(NULL);
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void) {
+    printf("========================================\n");
+    printf("Spawn Cost Analysis Tests\n");
+    printf("========================================\n");
+
+    printf("\nSpawn Estimates:\n");
+    RUN_TEST(builtins_do_not_spawn);
+    RUN_TEST(external_commands_spawn);
+    RUN_TEST(substitution_counts_subshell);
+    RUN_TEST(script_functions_do_not_spawn);
+    RUN_TEST(loops_are_weighted);
+
+    printf("\nIdioms:\n");
+    RUN_TEST(cat_substitution_rewrite);
+    RUN_TEST(basename_dirname_rewrite);
+    RUN_TEST(expr_rewrite);
+    RUN_TEST(echo_grep_rewrite);
+    RUN_TEST(echo_substitution_rewrite);
+    RUN_TEST(repeated_constructs_are_located);
+    RUN_TEST(quoted_text_is_ignored);
+
+    printf("\nBudget:\n");
+    RUN_TEST(budget_default_and_reset);
+    RUN_TEST(null_arguments);
+
+    printf("\n========================================\n");
+    printf("Tests run: %d, Passed: %d, Failed: %d\n", tests_run, tests_passed,
+           tests_failed);
+    printf("========================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,281 @@
+/**
+ * @file test_startup_cache.c
+ * @brief Unit tests for the cache of parsed startup files
+ *
+ * Tests the startup cache including:
+ * - Recording a file on first use and replaying it afterwards
+ * - Invalidation when the file changes
+ * - Rebuilding a damaged cache entry
+ * - Re-parsing constructs recorded under other parser features
+ * - Constructs that do not parse
+ * - Reading the file directly when the cache is disabled
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "executor.h"
+#include "lush.h"
+#include "shell_mode.h"
+#include "startup_cache.h"
+#include "symtable.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Test framework macros */
+#define TEST(name) static void test_##name(void)
+#define RUN_TEST(name)                                                         \
+    do {                                                                       \
+        printf("  Running: %s...\n", #name);                                   \
+        setup();                                                               \
+        test_##name();                                                         \
+        printf("    PASSED\n");                                                \
+    } while (0)
+
+#define ASSERT(condition, message)                                             \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_EQ(actual, expected, message)                                   \
+    do {                                                                       \
+        if ((actual) != (expected)) {                                          \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      Expected: %d, Got: %d\n", (int)(expected),           \
+                   (int)(actual));                                             \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+static char work_dir[] = "/tmp/lush_startup_cache_XXXXXX";
+static char cache_dir[256];
+static char script_path[256];
+static executor_t *executor;
+
+/**
+ * @brief Remove the cache entries and reset the counters
+ */
+static void setup(void) {
+    DIR *dir = opendir(cache_dir);
+    if (dir) {
+        struct dirent *ent;
+        while ((ent = readdir(dir)) != NULL) {
+            if (ent->d_name[0] != '.') {
+                char path[512];
+                snprintf(path, sizeof(path), "%s/%s", cache_dir, ent->d_name);
+                unlink(path);
+            }
+        }
+        closedir(dir);
+    }
+    startup_cache_set_enabled(true);
+    startup_cache_reset_stats();
+    shell_mode_set(SHELL_MODE_LUSH);
+}
+
+static void write_script(const char *text) {
+    FILE *f = fopen(script_path, "w");
+    ASSERT(f != NULL, "script file created");
+    fputs(text, f);
+    fclose(f);
+}
+
+/**
+ * @brief Run the script the way config_execute_script_file() does
+ * @return true if it was replayed from the cache
+ */
+static bool run_script(void) {
+    FILE *f = fopen(script_path, "r");
+    ASSERT(f != NULL, "script file opened");
+
+    startup_script_t *script = startup_script_open(script_path, f);
+    ASSERT(script != NULL, "script opened");
+    bool cached = startup_script_from_cache(script);
+
+    char *construct;
+    while ((construct = startup_script_read(script)) != NULL) {
+        current_executor = executor;
+        startup_script_execute(script, construct);
+        free(construct);
+    }
+    startup_script_close(script);
+    fclose(f);
+    return cached;
+}
+
+/**
+ * @brief Check a global variable's value
+ */
+static bool var_is(const char *name, const char *expected) {
+    char *value = symtable_get_global(name);
+    bool match = value && strcmp(value, expected) == 0;
+    free(value);
+    return match;
+}
+
+static void clear_vars(void) {
+    symtable_set_global("A", "");
+    symtable_set_global("B", "");
+    symtable_set_global("C", "");
+}
+
+static const char *sample_script =
+    "# startup file\n"
+    "A=one\n"
+    "\n"
+    "setb() {\n"
+    "    B=\"two $1\"\n"
+    "}\n"
+    "if [ -n \"$A\" ]; then\n"
+    "    for i in x y; do C=\"$C$i\"; done\n"
+    "fi\n"
+    "setb arg\n";
+
+/* ============================================================================
+ * Cache Tests
+ * ============================================================================ */
+
+TEST(first_run_records_then_replays) {
+    write_script(sample_script);
+
+    clear_vars();
+    ASSERT(!run_script(), "first run parses the file");
+    ASSERT(var_is("A", "one") && var_is("B", "two arg") && var_is("C", "xy"),
+           "first run executed the file");
+    startup_cache_stats_t stats = startup_cache_stats();
+    ASSERT_EQ(stats.misses, 1, "one miss");
+    ASSERT_EQ(stats.stores, 1, "entry written");
+
+    clear_vars();
+    ASSERT(run_script(), "second run replays the cache");
+    ASSERT(var_is("A", "one") && var_is("B", "two arg") && var_is("C", "xy"),
+           "replay executed the same commands");
+    stats = startup_cache_stats();
+    ASSERT_EQ(stats.hits, 1, "one hit");
+    ASSERT_EQ(stats.reparsed, 0, "nothing parsed again");
+}
+
+TEST(changed_file_invalidates) {
+    write_script("A=old\n");
+    run_script();
+    ASSERT(run_script(), "unchanged file replayed");
+
+    /* Same size, different content and modification time */
+    write_script("A=new\n");
+    struct timespec times[2] = {{0, UTIME_OMIT}, {1000000000, 0}};
+    utimensat(AT_FDCWD, script_path, times, 0);
+
+    ASSERT(!run_script(), "changed file parsed again");
+    ASSERT(var_is("A", "new"), "new content executed");
+    ASSERT(run_script(), "rebuilt entry replayed");
+    ASSERT(var_is("A", "new"), "replay runs the new content");
+}
+
+TEST(damaged_entry_rebuilt) {
+    write_script(sample_script);
+    run_script();
+
+    DIR *dir = opendir(cache_dir);
+    ASSERT(dir != NULL, "cache directory exists");
+    struct dirent *ent;
+    int damaged = 0;
+    while ((ent = readdir(dir)) != NULL) {
+        if (ent->d_name[0] != '.') {
+            char path[512];
+            snprintf(path, sizeof(path), "%s/%s", cache_dir, ent->d_name);
+            struct stat st;
+            stat(path, &st);
+            ASSERT(truncate(path, st.st_size - 7) == 0, "entry truncated");
+            damaged++;
+        }
+    }
+    closedir(dir);
+    ASSERT_EQ(damaged, 1, "one entry per file");
+
+    clear_vars();
+    ASSERT(!run_script(), "damaged entry not used");
+    ASSERT(var_is("B", "two arg"), "file executed from source");
+    ASSERT(run_script(), "entry rebuilt");
+}
+
+TEST(feature_change_reparses) {
+    write_script("A=first\nB=\"$A second\"\n");
+    run_script();
+
+    /* Recorded with the lush feature set; POSIX mode parses differently,
+     * so every construct is parsed again rather than replayed */
+    shell_mode_set(SHELL_MODE_POSIX);
+    clear_vars();
+    ASSERT(run_script(), "entry still loaded");
+    ASSERT_EQ(startup_cache_stats().reparsed, 2, "both constructs reparsed");
+    ASSERT(var_is("A", "first") && var_is("B", "first second"),
+           "constructs executed");
+}
+
+TEST(unparsable_construct_kept_as_text) {
+    write_script("A=before\nif then fi\nC=after\n");
+    clear_vars();
+    run_script();
+    ASSERT(var_is("A", "before") && var_is("C", "after"),
+           "constructs around the error ran");
+
+    clear_vars();
+    ASSERT(run_script(), "file with an error replayed");
+    ASSERT(var_is("A", "before") && var_is("C", "after"),
+           "replay matches the first run");
+}
+
+TEST(disabled_cache_reads_source) {
+    startup_cache_set_enabled(false);
+    write_script(sample_script);
+    clear_vars();
+    ASSERT(!run_script(), "not replayed");
+    ASSERT(!run_script(), "still not replayed");
+    ASSERT(var_is("B", "two arg"), "file executed");
+
+    startup_cache_stats_t stats = startup_cache_stats();
+    ASSERT_EQ(stats.hits + stats.misses + stats.stores, 0,
+              "cache not consulted");
+}
+
+int main(void) {
+    printf("\n=== Startup Cache Tests ===\n\n");
+
+    ASSERT(mkdtemp(work_dir) != NULL, "work directory created");
+    snprintf(cache_dir, sizeof(cache_dir), "%s/cache", work_dir);
+    snprintf(script_path, sizeof(script_path), "%s/profile", work_dir);
+    startup_cache_set_dir(cache_dir);
+
+    init_symtable();
+    shell_mode_init();
+    executor = executor_new();
+    ASSERT(executor != NULL, "executor created");
+
+    printf("Cache Tests:\n");
+    RUN_TEST(first_run_records_then_replays);
+    RUN_TEST(changed_file_invalidates);
+    RUN_TEST(damaged_entry_rebuilt);
+    RUN_TEST(feature_change_reparses);
+    RUN_TEST(unparsable_construct_kept_as_text);
+    RUN_TEST(disabled_cache_reads_source);
+
+    setup();
+    rmdir(cache_dir);
+    unlink(script_path);
+    rmdir(work_dir);
+    executor_free(executor);
+
+    printf("\n=== All %d Startup Cache Tests Passed ===\n\n", 6);
+    return 0;
+}
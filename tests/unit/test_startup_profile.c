@@ -0,0 +1,195 @@
+/**
+ * @file test_startup_profile.c
+ * @brief Unit tests for the startup tracer and deferred initialization
+ *
+ * Tests the startup profiler including:
+ * - Hooks doing nothing while profiling is off
+ * - Phase and nested sourced-file timings in the report
+ * - The budget check in the report
+ * - Deferred tasks running once, in order, after startup
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "startup_profile.h"
+
+/* Test framework macros */
+#define TEST(name) static void test_##name(void)
+#define RUN_TEST(name)                                                         \
+    do {                                                                       \
+        printf("  Running: %s...\n", #name);                                   \
+        startup_profile_reset();                                               \
+        test_##name();                                                         \
+        printf("    PASSED\n");                                                \
+    } while (0)
+
+#define ASSERT(condition, message)                                             \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_EQ(actual, expected, message)                                   \
+    do {                                                                       \
+        if ((actual) != (expected)) {                                          \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      Expected: %d, Got: %d\n", (int)(expected),           \
+                   (int)(actual));                                             \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+/**
+ * @brief Print the report into a buffer
+ */
+static bool report_to_buffer(char *out, size_t size) {
+    FILE *f = tmpfile();
+    bool within = startup_profile_report(f);
+    rewind(f);
+    size_t n = fread(out, 1, size - 1, f);
+    out[n] = '\0';
+    fclose(f);
+    return within;
+}
+
+static void sleep_ms(long ms) {
+    struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+/* Deferred tasks append their tag so order and count can be checked */
+static char task_log[32];
+
+static void task_a(void) { strcat(task_log, "a"); }
+static void task_b(void) { strcat(task_log, "b"); }
+
+/* ============================================================================
+ * Profiling Tests
+ * ============================================================================ */
+
+TEST(disabled_records_nothing) {
+    startup_phase("config");
+    startup_file_begin("/etc/profile");
+    startup_file_end();
+    startup_profile_finish(NULL);
+
+    ASSERT(!startup_profile_enabled(), "profiling off by default");
+    ASSERT(startup_profile_finished(), "finish still marks startup done");
+    ASSERT(startup_profile_total_ms() == 0.0, "no total while off");
+
+    char out[1024];
+    report_to_buffer(out, sizeof(out));
+    ASSERT(strstr(out, "config") == NULL, "no phases recorded");
+}
+
+TEST(phases_and_files_reported) {
+    startup_profile_enable(1000.0);
+    startup_phase("config");
+    startup_phase("system profile");
+    startup_file_begin("/etc/profile");
+    startup_file_begin("/etc/profile.d/a.sh");
+    sleep_ms(5);
+    startup_file_end();
+    startup_file_end();
+    startup_phase("shell tables");
+    startup_profile_finish(NULL);
+
+    char out[2048];
+    ASSERT(report_to_buffer(out, sizeof(out)), "within a generous budget");
+    char *config = strstr(out, "config");
+    char *profile = strstr(out, "system profile");
+    char *file = strstr(out, "  /etc/profile\n");
+    char *nested = strstr(out, "    /etc/profile.d/a.sh");
+    char *tables = strstr(out, "shell tables");
+    ASSERT(config && profile && file && nested && tables, "all events listed");
+    ASSERT(config < profile && profile < file && file < nested &&
+               nested < tables,
+           "events in start order");
+    ASSERT(strstr(out, "EXCEEDED") == NULL, "budget not exceeded");
+
+    double total = startup_profile_total_ms();
+    ASSERT(total >= 5.0, "total covers the sleep");
+    sleep_ms(2);
+    ASSERT(startup_profile_total_ms() == total, "clock stops at finish");
+}
+
+TEST(events_after_finish_ignored) {
+    startup_profile_enable(0);
+    startup_phase("config");
+    startup_profile_finish(NULL);
+    startup_phase("late phase");
+    startup_file_begin("/tmp/late.sh");
+    startup_file_end();
+
+    char out[1024];
+    report_to_buffer(out, sizeof(out));
+    ASSERT(strstr(out, "late") == NULL, "nothing recorded after finish");
+}
+
+TEST(budget_exceeded) {
+    startup_profile_enable(1.0);
+    startup_phase("slow");
+    sleep_ms(5);
+    startup_profile_finish(NULL);
+
+    char out[1024];
+    ASSERT(!report_to_buffer(out, sizeof(out)), "over budget");
+    ASSERT(strstr(out, "EXCEEDED") != NULL, "report flags the budget");
+}
+
+/* ============================================================================
+ * Deferred Initialization Tests
+ * ============================================================================ */
+
+TEST(deferred_tasks_run_once_in_order) {
+    task_log[0] = '\0';
+    startup_defer("a", task_a);
+    startup_defer("b", task_b);
+    ASSERT_EQ(startup_deferred_pending(), 2, "two tasks pending");
+    ASSERT(strcmp(task_log, "") == 0, "tasks not run on registration");
+
+    ASSERT_EQ(startup_run_deferred(NULL), 2, "both tasks run");
+    ASSERT(strcmp(task_log, "ab") == 0, "tasks run in order");
+    ASSERT_EQ(startup_deferred_pending(), 0, "nothing pending");
+
+    ASSERT_EQ(startup_run_deferred(NULL), 0, "second run does nothing");
+    ASSERT(strcmp(task_log, "ab") == 0, "tasks ran once");
+}
+
+TEST(deferred_overflow_runs_immediately) {
+    task_log[0] = '\0';
+    for (int i = 0; i < STARTUP_MAX_DEFERRED; i++) {
+        startup_defer("a", task_a);
+    }
+    startup_defer("b", task_b);
+    ASSERT(strcmp(task_log, "b") == 0, "task past the table ran at once");
+    ASSERT_EQ(startup_deferred_pending(), STARTUP_MAX_DEFERRED,
+              "table full of pending tasks");
+}
+
+int main(void) {
+    printf("\n=== Startup Profile Tests ===\n\n");
+
+    printf("Profiling Tests:\n");
+    RUN_TEST(disabled_records_nothing);
+    RUN_TEST(phases_and_files_reported);
+    RUN_TEST(events_after_finish_ignored);
+    RUN_TEST(budget_exceeded);
+
+    printf("\nDeferred Initialization Tests:\n");
+    RUN_TEST(deferred_tasks_run_once_in_order);
+    RUN_TEST(deferred_overflow_runs_immediately);
+
+    printf("\n=== All %d Startup Profile Tests Passed ===\n\n", 6);
+    return 0;
+}
@@ -771,6 +771,55 @@ TEST(tokenize_line_position_tracking) {
     tokenizer_free(tok);
 }
 
+TEST(refresh_lookahead_reclassifies_word) {
+    tokenizer_t *tok = tokenizer_new("echo if done");
+    ASSERT_NOT_NULL(tok, "tokenizer_new failed");
+
+    token_t *token = tokenizer_peek(tok);
+    ASSERT_EQ(token->type, TOK_IF, "if is a keyword by default");
+    size_t position = tok->position;
+
+    tokenizer_enable_keywords(tok, false);
+    tokenizer_refresh_lookahead(tok);
+    token = tokenizer_peek(tok);
+    ASSERT_EQ(token->type, TOK_WORD, "if is a word without keywords");
+    ASSERT_STR_EQ(token->text, "if", "Text unchanged");
+    ASSERT_EQ(tok->position, position, "Word re-classified without re-lex");
+
+    tokenizer_enable_keywords(tok, true);
+    tokenizer_refresh_lookahead(tok);
+    ASSERT_EQ(tokenizer_peek(tok)->type, TOK_IF, "Keyword again");
+
+    tokenizer_advance(tok);
+    tokenizer_advance(tok);
+    ASSERT_EQ(tokenizer_current(tok)->type, TOK_DONE, "Stream continues");
+
+    tokenizer_free(tok);
+}
+
+TEST(token_slots_reuse_text_buffers) {
+    tokenizer_t *tok = tokenizer_new(
+        "a_rather_long_word_that_needs_a_bigger_buffer b c d e f g h");
+    ASSERT_NOT_NULL(tok, "tokenizer_new failed");
+
+    token_t *first = tokenizer_current(tok);
+    tokenizer_advance(tok);
+    ASSERT_STR_EQ(first->text,
+                  "a_rather_long_word_that_needs_a_bigger_buffer",
+                  "Released token valid for one more advance");
+
+    const char *expected[] = {"b", "c", "d", "e", "f", "g", "h"};
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        token_t *token = tokenizer_current(tok);
+        ASSERT_STR_EQ(token->text, expected[i], "Short word after long");
+        ASSERT_EQ(token->length, 1, "Length matches text");
+        tokenizer_advance(tok);
+    }
+    ASSERT_EQ(tokenizer_current(tok)->type, TOK_EOF, "End of input");
+
+    tokenizer_free(tok);
+}
+
 /* ============================================================================
  * MAIN
  * ============================================================================
@@ -848,6 +897,8 @@ int main(void) {
     RUN_TEST(tokenize_arithmetic_expansion);
     RUN_TEST(tokenize_special_chars_in_word);
     RUN_TEST(tokenize_line_position_tracking);
+    RUN_TEST(refresh_lookahead_reclassifies_word);
+    RUN_TEST(token_slots_reuse_text_buffers);
     
     printf("\n========================================\n");
     printf("All tokenizer tests PASSED!\n");
@@ -0,0 +1,297 @@
+/**
+ * @file test_xtrace.c
+ * @brief Unit tests for execution trace (set -x) output
+ *
+ * Tests the xtrace module including:
+ * - Classic "+ cmd" records
+ * - JSON-lines records
+ * - Trace descriptor selection via LUSH_XTRACEFD / BASH_XTRACEFD
+ * - Cached settings following assignments and function locals
+ * - No output when xtrace is disabled
+ * - Kinds and script lines of commands run by the executor, including
+ *   commands inside function bodies and sourced files
+ *
+ * @author Michael Berry <trismegustis@gmail.com>
+ * @copyright Copyright (C) 2021-2026 Michael Berry
+ */
+
+#include "executor.h"
+#include "lush.h"
+#include "symtable.h"
+#include "xtrace.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+extern shell_options_t shell_opts;
+
+/* Test framework macros */
+#define TEST(name) static void test_##name(void)
+#define RUN_TEST(name)                                                         \
+    do {                                                                       \
+        printf("  Running: %s...\n", #name);                                   \
+        test_##name();                                                         \
+        printf("    PASSED\n");                                                \
+    } while (0)
+
+#define ASSERT(condition, message)                                             \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+#define ASSERT_STR_CONTAINS(haystack, needle, message)                         \
+    do {                                                                       \
+        if (!strstr((haystack), (needle))) {                                   \
+            printf("    FAILED: %s\n", message);                               \
+            printf("      \"%s\" not found in \"%s\"\n", (needle),             \
+                   (haystack));                                                \
+            printf("      at %s:%d\n", __FILE__, __LINE__);                    \
+            exit(1);                                                           \
+        }                                                                      \
+    } while (0)
+
+/* Read end of the pipe used as the trace descriptor */
+static int trace_read_fd = -1;
+
+/**
+ * @brief Point LUSH_XTRACEFD at a fresh non-blocking pipe
+ */
+static void setup_trace_pipe(void) {
+    int fds[2];
+    ASSERT(pipe(fds) == 0, "pipe() should succeed");
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    trace_read_fd = fds[0];
+
+    char fdbuf[16];
+    snprintf(fdbuf, sizeof(fdbuf), "%d", fds[1]);
+    symtable_set_global("LUSH_XTRACEFD", fdbuf);
+}
+
+/**
+ * @brief Drain everything written to the trace pipe so far
+ */
+static const char *read_trace(void) {
+    static char buf[4096];
+    ssize_t n = read(trace_read_fd, buf, sizeof(buf) - 1);
+    buf[n > 0 ? n : 0] = '\0';
+    return buf;
+}
+
+TEST(classic_record) {
+    shell_opts.trace_execution = true;
+    symtable_set_global("LUSH_XTRACE_FORMAT", "classic");
+
+    char *argv[] = {"echo", "hello", "world", NULL};
+    xtrace_record_t rec;
+    xtrace_begin(&rec, "builtin", argv, NULL, 0);
+    xtrace_end(&rec, 0);
+
+    const char *out = read_trace();
+    ASSERT(strcmp(out, "+ echo hello world\n") == 0,
+           "classic record should be '+ argv'");
+}
+
+TEST(json_record) {
+    shell_opts.trace_execution = true;
+    symtable_set_global("LUSH_XTRACE_FORMAT", "json");
+
+    char *argv[] = {"printf", "a\"b\n", NULL};
+    xtrace_record_t rec;
+    xtrace_begin(&rec, "external", argv, "script.sh", 12);
+    ASSERT(read_trace()[0] == '\0', "JSON record is written at end");
+    xtrace_end(&rec, 3);
+
+    const char *out = read_trace();
+    ASSERT_STR_CONTAINS(out, "\"kind\":\"external\"", "kind field");
+    ASSERT_STR_CONTAINS(out, "\"file\":\"script.sh\"", "file field");
+    ASSERT_STR_CONTAINS(out, "\"line\":12", "line field");
+    ASSERT_STR_CONTAINS(out, "\"argv\":[\"printf\",\"a\\\"b\\n\"]",
+                        "argv is escaped");
+    ASSERT_STR_CONTAINS(out, "\"status\":3", "status field");
+    ASSERT_STR_CONTAINS(out, "\"duration_us\":", "duration field");
+    ASSERT(out[strlen(out) - 1] == '\n', "record is newline terminated");
+
+    symtable_set_global("LUSH_XTRACE_FORMAT", "classic");
+}
+
+TEST(disabled_writes_nothing) {
+    shell_opts.trace_execution = false;
+
+    char *argv[] = {"true", NULL};
+    xtrace_record_t rec;
+    xtrace_begin(&rec, "builtin", argv, NULL, 0);
+    xtrace_end(&rec, 0);
+
+    ASSERT(read_trace()[0] == '\0', "nothing written when xtrace is off");
+}
+
+TEST(executor_records_script_lines) {
+    executor_t *executor = executor_new();
+    ASSERT(executor != NULL, "executor created");
+    executor_execute_command_line(executor, "f() { true; }");
+
+    shell_opts.trace_execution = true;
+    symtable_set_global("LUSH_XTRACE_FORMAT", "json");
+
+    /* The construct starts on line 10 of the script */
+    executor_set_script_context(executor, "script.sh", 10);
+    executor_execute_command_line(executor, "echo x >/dev/null\n"
+                                            "f a\n"
+                                            "/bin/true");
+    const char *out = read_trace();
+
+    const char *builtin = strstr(out, "\"argv\":[\"echo\"");
+    const char *call = strstr(out, "\"kind\":\"function\"");
+    const char *external = strstr(out, "\"kind\":\"external\"");
+    ASSERT(builtin && call && external, "one record per kind");
+    ASSERT(strstr(out, "\"line\":10,\"argv\":[\"echo\"") != NULL,
+           "builtin on the construct's first line");
+    ASSERT_STR_CONTAINS(call, "\"file\":\"script.sh\",\"line\":11",
+                        "function call on the second line");
+    ASSERT_STR_CONTAINS(call, "\"argv\":[\"f\",\"a\"]",
+                        "function call words");
+    ASSERT_STR_CONTAINS(external, "\"line\":12", "external on the third line");
+
+    shell_opts.trace_execution = false;
+    symtable_set_global("LUSH_XTRACE_FORMAT", "classic");
+    executor_free(executor);
+}
+
+TEST(executor_records_function_body_lines) {
+    executor_t *executor = executor_new();
+    ASSERT(executor != NULL, "executor created");
+
+    /* Defined on lines 20-22 of one script, called from another */
+    executor_set_script_context(executor, "lib.sh", 20);
+    executor_execute_command_line(executor, "g() {\n"
+                                            "    echo in >/dev/null\n"
+                                            "}");
+    executor_set_script_context(executor, "main.sh", 5);
+
+    shell_opts.trace_execution = true;
+    symtable_set_global("LUSH_XTRACE_FORMAT", "json");
+    executor_execute_command_line(executor, "g");
+    const char *out = read_trace();
+
+    ASSERT(strstr(out, "\"line\":21,\"argv\":[\"echo\",\"in\"]") != NULL,
+           "body command on its definition line");
+    ASSERT(strstr(out, "\"line\":5,\"argv\":[\"g\"]") != NULL,
+           "call on the caller's line");
+
+    shell_opts.trace_execution = false;
+    symtable_set_global("LUSH_XTRACE_FORMAT", "classic");
+    executor_free(executor);
+}
+
+TEST(settings_follow_assignments) {
+    shell_opts.trace_execution = true;
+    char *argv[] = {"true", NULL};
+    xtrace_record_t rec;
+
+    /* Warm the cached settings, then move the descriptor */
+    xtrace_begin(&rec, "builtin", argv, NULL, 0);
+    xtrace_end(&rec, 0);
+    read_trace();
+
+    int fds[2];
+    ASSERT(pipe(fds) == 0, "pipe() should succeed");
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    char fdbuf[16];
+    snprintf(fdbuf, sizeof(fdbuf), "%d", fds[1]);
+    char *old_fd = symtable_get_global("LUSH_XTRACEFD");
+
+    symtable_set_global("LUSH_XTRACEFD", fdbuf);
+    xtrace_begin(&rec, "builtin", argv, NULL, 0);
+    xtrace_end(&rec, 0);
+
+    char buf[64];
+    ssize_t n = read(fds[0], buf, sizeof(buf) - 1);
+    buf[n > 0 ? n : 0] = '\0';
+    ASSERT(strcmp(buf, "+ true\n") == 0, "record follows new LUSH_XTRACEFD");
+    ASSERT(read_trace()[0] == '\0', "old descriptor no longer written");
+
+    symtable_set_global("LUSH_XTRACEFD", old_fd);
+    free(old_fd);
+    close(fds[0]);
+    close(fds[1]);
+    shell_opts.trace_execution = false;
+}
+
+TEST(function_local_format_is_dropped_on_return) {
+    executor_t *executor = executor_new();
+    ASSERT(executor != NULL, "executor created");
+    executor_execute_command_line(
+        executor, "h() { local LUSH_XTRACE_FORMAT=json; true in; }");
+
+    shell_opts.trace_execution = true;
+    symtable_set_global("LUSH_XTRACE_FORMAT", "classic");
+    executor_execute_command_line(executor, "h\ntrue out");
+    const char *out = read_trace();
+
+    ASSERT_STR_CONTAINS(out, "\"argv\":[\"true\",\"in\"]",
+                        "local format applies inside the function");
+    ASSERT_STR_CONTAINS(out, "+ true out\n",
+                        "caller's format is back after the return");
+
+    shell_opts.trace_execution = false;
+    executor_free(executor);
+}
+
+TEST(executor_records_sourced_file) {
+    char path[] = "/tmp/lush_xtrace_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT(fd >= 0, "mkstemp() should succeed");
+    ASSERT(write(fd, "echo sourced >/dev/null\n", 24) == 24,
+           "write sourced script");
+    close(fd);
+
+    executor_t *executor = executor_new();
+    ASSERT(executor != NULL, "executor created");
+    executor_set_script_context(executor, "main.sh", 3);
+
+    shell_opts.trace_execution = true;
+    symtable_set_global("LUSH_XTRACE_FORMAT", "json");
+    char cmd[64];
+    snprintf(cmd, sizeof(cmd), "source %s", path);
+    executor_execute_command_line(executor, cmd);
+    const char *out = read_trace();
+
+    char expected[96];
+    snprintf(expected, sizeof(expected), "\"file\":\"%s\",\"line\":1", path);
+    ASSERT_STR_CONTAINS(out, expected, "sourced command in the sourced file");
+    ASSERT_STR_CONTAINS(out, "\"file\":\"main.sh\",\"line\":3,"
+                             "\"argv\":[\"source\"",
+                        "source itself in the caller's file");
+
+    shell_opts.trace_execution = false;
+    symtable_set_global("LUSH_XTRACE_FORMAT", "classic");
+    executor_free(executor);
+    unlink(path);
+}
+
+int main(void) {
+    printf("Running xtrace tests...\n");
+
+    init_symtable();
+    setup_trace_pipe();
+
+    RUN_TEST(classic_record);
+    RUN_TEST(json_record);
+    RUN_TEST(disabled_writes_nothing);
+    RUN_TEST(executor_records_script_lines);
+    RUN_TEST(executor_records_function_body_lines);
+    RUN_TEST(settings_follow_assignments);
+    RUN_TEST(function_local_format_is_dropped_on_return);
+    RUN_TEST(executor_records_sourced_file);
+
+    xtrace_cleanup();
+    printf("\nAll xtrace tests passed!\n");
+    return 0;
+}